@@ -0,0 +1,169 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2024, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Bounded lock-free queue for inter-thread communication.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsPlatform.h"
+
+namespace ts {
+    //!
+    //! Bounded lock-free queue for inter-thread communication.
+    //! @ingroup thread
+    //!
+    //! Any number of threads can concurrently push and pop elements. The queue never
+    //! blocks: push() fails when the queue is full and pop() fails when the queue is
+    //! empty. It is up to the application to wait and retry when necessary. Use
+    //! ts::MessageQueue when the threads shall block on the queue.
+    //!
+    //! The queue is a ring of cells, each cell having a sequence number which tells
+    //! if the cell is free or contains an element for a given lap of the ring. There
+    //! is no memory allocation after construction.
+    //!
+    //! @tparam T The type of the elements. It must be default-constructible and move-assignable.
+    //!
+    template <typename T>
+    class LockFreeQueue
+    {
+        TS_NOCOPY(LockFreeQueue);
+    public:
+        //!
+        //! Constructor.
+        //! @param [in] capacity Maximum number of elements in the queue.
+        //! It is rounded up to the next power of two, with a minimum of 2.
+        //!
+        explicit LockFreeQueue(size_t capacity);
+
+        //!
+        //! Get the maximum number of elements in the queue.
+        //! @return The maximum number of elements in the queue.
+        //!
+        size_t capacity() const { return _mask + 1; }
+
+        //!
+        //! Insert an element at the end of the queue.
+        //! @param [in,out] value The element to insert. It is moved into the queue on success
+        //! and left unmodified when the queue is full.
+        //! @return True on success, false if the queue is full.
+        //!
+        bool push(T& value);
+
+        //!
+        //! Extract the first element of the queue.
+        //! @param [out] value The extracted element.
+        //! @return True on success, false if the queue is empty.
+        //!
+        bool pop(T& value);
+
+        //!
+        //! Check if the queue is empty.
+        //! When other threads use the queue, the result is only a hint.
+        //! @return True if the queue is empty.
+        //!
+        bool empty() const;
+
+    private:
+        struct Cell
+        {
+            std::atomic<size_t> sequence {0};
+            T value {};
+        };
+
+        size_t                  _mask;          // Capacity - 1, capacity being a power of 2.
+        std::unique_ptr<Cell[]> _cells {};      // Ring of cells.
+        alignas(64) std::atomic<size_t> _push_pos {0};
+        alignas(64) std::atomic<size_t> _pop_pos {0};
+    };
+}
+
+
+//----------------------------------------------------------------------------
+// Template definitions.
+//----------------------------------------------------------------------------
+
+template <typename T>
+ts::LockFreeQueue<T>::LockFreeQueue(size_t capacity) :
+    _mask(1)
+{
+    while (_mask + 1 < capacity) {
+        _mask = (_mask << 1) | 1;
+    }
+    _cells.reset(new Cell[_mask + 1]);
+    for (size_t i = 0; i <= _mask; ++i) {
+        _cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+template <typename T>
+bool ts::LockFreeQueue<T>::push(T& value)
+{
+    // A free cell for position 'pos' has sequence 'pos'.
+    size_t pos = _push_pos.load(std::memory_order_relaxed);
+    Cell* cell = nullptr;
+    for (;;) {
+        cell = &_cells[pos & _mask];
+        const size_t seq = cell->sequence.load(std::memory_order_acquire);
+        const intptr_t diff = intptr_t(seq) - intptr_t(pos);
+        if (diff == 0) {
+            if (_push_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        }
+        else if (diff < 0) {
+            // The cell still contains the element from the previous lap.
+            return false;
+        }
+        else {
+            // Another thread pushed in the meantime.
+            pos = _push_pos.load(std::memory_order_relaxed);
+        }
+    }
+    cell->value = std::move(value);
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+template <typename T>
+bool ts::LockFreeQueue<T>::pop(T& value)
+{
+    // A filled cell for position 'pos' has sequence 'pos + 1'.
+    size_t pos = _pop_pos.load(std::memory_order_relaxed);
+    Cell* cell = nullptr;
+    for (;;) {
+        cell = &_cells[pos & _mask];
+        const size_t seq = cell->sequence.load(std::memory_order_acquire);
+        const intptr_t diff = intptr_t(seq) - intptr_t(pos + 1);
+        if (diff == 0) {
+            if (_pop_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        }
+        else if (diff < 0) {
+            // The cell is not yet filled.
+            return false;
+        }
+        else {
+            // Another thread popped in the meantime.
+            pos = _pop_pos.load(std::memory_order_relaxed);
+        }
+    }
+    value = std::move(cell->value);
+    // The cell becomes free for the next lap.
+    cell->sequence.store(pos + _mask + 1, std::memory_order_release);
+    return true;
+}
+
+template <typename T>
+bool ts::LockFreeQueue<T>::empty() const
+{
+    const size_t pos = _pop_pos.load(std::memory_order_relaxed);
+    return intptr_t(_cells[pos & _mask].sequence.load(std::memory_order_acquire)) - intptr_t(pos + 1) < 0;
+}
@@ -0,0 +1,116 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2024, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+
+#include "tsLogHistogram.h"
+#include "tsIntegerUtils.h"
+
+
+//----------------------------------------------------------------------------
+// Reset the histogram.
+//----------------------------------------------------------------------------
+
+void ts::LogHistogram::reset()
+{
+    _count = 0;
+    _sum = 0;
+    _min = 0;
+    _max = 0;
+    for (auto& b : _buckets) {
+        b = 0;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Bucket computations.
+//----------------------------------------------------------------------------
+
+size_t ts::LogHistogram::BucketIndex(uint64_t value)
+{
+    if (value < SUB_BUCKETS) {
+        return size_t(value);
+    }
+    else {
+        // Position of the most significant bit, at least SUB_BITS.
+        const size_t msb = BitSize(value) - 1;
+        const size_t shift = msb - SUB_BITS;
+        return SUB_BUCKETS + shift * SUB_BUCKETS + size_t(value >> shift) - SUB_BUCKETS;
+    }
+}
+
+uint64_t ts::LogHistogram::BucketHighest(size_t index)
+{
+    if (index < SUB_BUCKETS) {
+        return index;
+    }
+    else {
+        const size_t shift = (index - SUB_BUCKETS) / SUB_BUCKETS;
+        const uint64_t low = uint64_t(SUB_BUCKETS + (index - SUB_BUCKETS) % SUB_BUCKETS) << shift;
+        return low + ((uint64_t(1) << shift) - 1);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Record a value. Only one thread records values, atomic read-modify-write
+// operations are not needed, only atomic stores for concurrent readers.
+//----------------------------------------------------------------------------
+
+void ts::LogHistogram::add(uint64_t value)
+{
+    const uint64_t count = _count.load(std::memory_order_relaxed);
+    if (count == 0 || value < _min.load(std::memory_order_relaxed)) {
+        _min.store(value, std::memory_order_relaxed);
+    }
+    if (value > _max.load(std::memory_order_relaxed)) {
+        _max.store(value, std::memory_order_relaxed);
+    }
+    auto& bucket(_buckets[BucketIndex(value)]);
+    bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    _sum.store(_sum.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    _count.store(count + 1, std::memory_order_relaxed);
+}
+
+
+//----------------------------------------------------------------------------
+// Get the mean of all recorded values.
+//----------------------------------------------------------------------------
+
+double ts::LogHistogram::mean() const
+{
+    const uint64_t count = _count.load(std::memory_order_relaxed);
+    return count == 0 ? 0.0 : double(_sum.load(std::memory_order_relaxed)) / double(count);
+}
+
+
+//----------------------------------------------------------------------------
+// Get the value at a given percentile.
+//----------------------------------------------------------------------------
+
+uint64_t ts::LogHistogram::percentile(double percent) const
+{
+    // Use the sum of buckets, not _count, in case of concurrent update.
+    uint64_t total = 0;
+    for (const auto& b : _buckets) {
+        total += b.load(std::memory_order_relaxed);
+    }
+    if (total == 0) {
+        return 0;
+    }
+
+    // Rank of the requested value, from 1 to total.
+    const uint64_t rank = std::max<uint64_t>(1, uint64_t(std::ceil(double(total) * std::clamp(percent, 0.0, 100.0) / 100.0)));
+    uint64_t cumulated = 0;
+    for (size_t i = 0; i < _buckets.size(); ++i) {
+        cumulated += _buckets[i].load(std::memory_order_relaxed);
+        if (cumulated >= rank) {
+            return std::min(BucketHighest(i), maximum());
+        }
+    }
+    return maximum();
+}
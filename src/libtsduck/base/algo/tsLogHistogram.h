@@ -0,0 +1,109 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2024, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Histogram of integer values with logarithmic buckets.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsPlatform.h"
+
+namespace ts {
+    //!
+    //! Histogram of integer values with logarithmic buckets.
+    //! @ingroup cpp
+    //!
+    //! The range of 64-bit values is split in powers of 2. Each power of 2 is divided
+    //! in SUB_BUCKETS linear buckets. The relative error on percentiles is consequently
+    //! bounded by 1/SUB_BUCKETS, regardless of the magnitude of the values. Values lower
+    //! than SUB_BUCKETS are recorded exactly. This is the principle of "HDR histograms",
+    //! typically used to record latencies, where the tail of the distribution matters.
+    //!
+    //! Recording a value is done in constant time, without memory allocation.
+    //! One single thread may record values while other threads concurrently read the
+    //! histogram. The readers get a consistent enough view of the histogram for
+    //! monitoring purposes, but not an exact snapshot.
+    //!
+    class TSDUCKDLL LogHistogram
+    {
+    public:
+        //!
+        //! Number of linear buckets per power of 2.
+        //!
+        static constexpr size_t SUB_BUCKETS = 16;
+
+        //!
+        //! Default constructor.
+        //!
+        LogHistogram() = default;
+
+        //!
+        //! Reset the histogram.
+        //! Must be called from the recording thread or when no thread records values.
+        //!
+        void reset();
+
+        //!
+        //! Record a value.
+        //! @param [in] value The value to record.
+        //!
+        void add(uint64_t value);
+
+        //!
+        //! Get the number of recorded values.
+        //! @return The number of recorded values.
+        //!
+        uint64_t count() const { return _count.load(std::memory_order_relaxed); }
+
+        //!
+        //! Get the minimum recorded value.
+        //! @return The minimum recorded value or zero if the histogram is empty.
+        //!
+        uint64_t minimum() const { return count() == 0 ? 0 : _min.load(std::memory_order_relaxed); }
+
+        //!
+        //! Get the maximum recorded value.
+        //! @return The maximum recorded value or zero if the histogram is empty.
+        //!
+        uint64_t maximum() const { return _max.load(std::memory_order_relaxed); }
+
+        //!
+        //! Get the mean of all recorded values.
+        //! @return The mean of all recorded values or zero if the histogram is empty.
+        //!
+        double mean() const;
+
+        //!
+        //! Get the value at a given percentile.
+        //! @param [in] percent The percentile, from 0.0 to 100.0.
+        //! @return The highest value in the bucket which contains the requested percentile,
+        //! bounded by the maximum recorded value. Return zero if the histogram is empty.
+        //!
+        uint64_t percentile(double percent) const;
+
+    private:
+        // Number of bits which are used to index linear buckets, log2(SUB_BUCKETS).
+        static constexpr size_t SUB_BITS = 4;
+        static_assert(size_t(1) << SUB_BITS == SUB_BUCKETS);
+
+        // Values below SUB_BUCKETS are stored in their own bucket.
+        // Then SUB_BUCKETS buckets for each power of 2 from SUB_BITS to 63.
+        static constexpr size_t BUCKET_COUNT = SUB_BUCKETS + (64 - SUB_BITS) * SUB_BUCKETS;
+
+        std::atomic<uint64_t> _count {0};
+        std::atomic<uint64_t> _sum {0};
+        std::atomic<uint64_t> _min {0};
+        std::atomic<uint64_t> _max {0};
+        std::array<std::atomic<uint64_t>, BUCKET_COUNT> _buckets {};
+
+        // Get the bucket index of a value and the highest value in a bucket.
+        static size_t BucketIndex(uint64_t value);
+        static uint64_t BucketHighest(size_t index);
+    };
+}
@@ -0,0 +1,158 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2024, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Pool of recycled objects which are accessed through shared pointers.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsPlatform.h"
+
+namespace ts {
+    //!
+    //! Pool of recycled objects which are accessed through shared pointers.
+    //! @ingroup cpp
+    //!
+    //! The pool keeps a reference on each object it allocates. An object is considered
+    //! as released, and can be recycled, when the pool holds the only reference to it,
+    //! meaning that all other users have dropped their shared pointers. Recycling an
+    //! object avoids the allocation of the object and its control block. When the object
+    //! itself owns some memory, a std::vector for instance, this memory is also reused
+    //! if the object is reinitialized using operations which preserve its capacity.
+    //!
+    //! Objects are never reset by the pool: a recycled object has the state which was left
+    //! by its last user. It is the responsibility of the caller to reinitialize it.
+    //!
+    //! The pool is bounded. When all pooled objects are in use, new objects are allocated
+    //! outside the pool and are simply deleted when released. Because users may keep
+    //! objects for a long time, the pool does not grow beyond its maximum size.
+    //!
+    //! The pool itself is not thread-safe and must be used by one thread only. However,
+    //! the allocated objects can be passed to other threads, which release them at any time.
+    //!
+    //! @tparam T The type of the pooled objects. It must be default-constructible.
+    //!
+    template <class T>
+    class SharedPool
+    {
+        TS_NOCOPY(SharedPool);
+    public:
+        //!
+        //! Shared pointer to pooled objects.
+        //!
+        using ObjectPtr = std::shared_ptr<T>;
+
+        //!
+        //! Default maximum number of objects in the pool.
+        //!
+        static constexpr size_t DEFAULT_MAX_SIZE = 16;
+
+        //!
+        //! Constructor.
+        //! @param [in] max_size Maximum number of objects in the pool. When zero, objects are never recycled.
+        //!
+        explicit SharedPool(size_t max_size = DEFAULT_MAX_SIZE) : _max_size(max_size) {}
+
+        //!
+        //! Get an object from the pool.
+        //! @return A shared pointer to a recycled object if one is available or to a new object.
+        //!
+        ObjectPtr allocate();
+
+        //!
+        //! Set the maximum number of objects in the pool.
+        //! @param [in] max_size Maximum number of objects in the pool. When zero, objects are never recycled.
+        //!
+        void setMaxSize(size_t max_size);
+
+        //!
+        //! Get the maximum number of objects in the pool.
+        //! @return The maximum number of objects in the pool.
+        //!
+        size_t maxSize() const { return _max_size; }
+
+        //!
+        //! Get the current number of objects in the pool, in use or not.
+        //! @return The current number of objects in the pool.
+        //!
+        size_t size() const { return _objects.size(); }
+
+        //!
+        //! Release all references from the pool.
+        //! Objects which are still used elsewhere remain valid.
+        //!
+        void clear();
+
+        //!
+        //! Get the number of objects which were allocated by allocate().
+        //! @return The number of new objects which were allocated.
+        //!
+        uint64_t allocatedCount() const { return _allocated; }
+
+        //!
+        //! Get the number of objects which were recycled by allocate().
+        //! @return The number of objects which were recycled.
+        //!
+        uint64_t recycledCount() const { return _recycled; }
+
+    private:
+        size_t                 _max_size;
+        size_t                 _next = 0;       // Next index to check for a released object.
+        uint64_t               _allocated = 0;  // Number of allocated objects.
+        uint64_t               _recycled = 0;   // Number of recycled objects.
+        std::vector<ObjectPtr> _objects {};     // All objects in the pool.
+    };
+}
+
+
+//----------------------------------------------------------------------------
+// Template definitions.
+//----------------------------------------------------------------------------
+
+template <class T>
+typename ts::SharedPool<T>::ObjectPtr ts::SharedPool<T>::allocate()
+{
+    // Look for a released object, starting after the last recycled one.
+    for (size_t i = 0; i < _objects.size(); ++i) {
+        const size_t index = (_next + i) % _objects.size();
+        if (_objects[index].use_count() == 1) {
+            // The last user may have released the object in another thread.
+            // Make sure that all its modifications are visible here.
+            std::atomic_thread_fence(std::memory_order_acquire);
+            _next = (index + 1) % _objects.size();
+            _recycled++;
+            return _objects[index];
+        }
+    }
+
+    // No released object, allocate a new one and keep it in the pool if there is room.
+    ObjectPtr obj(std::make_shared<T>());
+    _allocated++;
+    if (_objects.size() < _max_size) {
+        _objects.push_back(obj);
+    }
+    return obj;
+}
+
+template <class T>
+void ts::SharedPool<T>::setMaxSize(size_t max_size)
+{
+    _max_size = max_size;
+    if (_objects.size() > _max_size) {
+        _objects.resize(_max_size);
+        _next = 0;
+    }
+}
+
+template <class T>
+void ts::SharedPool<T>::clear()
+{
+    _objects.clear();
+    _next = 0;
+}
@@ -8,9 +8,27 @@
 
 #include "tsNamesFile.h"
 #include "tsFileUtils.h"
+#include "tsEnvironment.h"
 #include "tsCerrReport.h"
-#include "tsFatal.h"
 #include "tsSingleton.h"
+#include "tsMemory.h"
+#include "tsUID.h"
+
+// Binary image of compiled names files, all integers in big endian.
+// - Header: magic number ("TSNAMES1"), format version, image size, then number and offset
+//   of source file records, section records, entry records, string pool.
+// - Source file: path (string), size (64 bits), modification time (64 bits).
+// - Section: name (string), inherit (string), bits, index of first entry, number of entries.
+// - Entry: first value (64 bits), last value (64 bits), name (string).
+// A string is a 32-bit offset in the UTF-8 string pool and a 32-bit length.
+namespace {
+    constexpr uint64_t IMAGE_MAGIC = 0x54534E414D455331;
+    constexpr uint32_t IMAGE_VERSION = 1;
+    constexpr size_t   IMAGE_HEADER_SIZE = 48;
+    constexpr size_t   IMAGE_SOURCE_SIZE = 24;
+    constexpr size_t   IMAGE_SECTION_SIZE = 28;
+    constexpr size_t   IMAGE_ENTRY_SIZE = 24;
+}
 
 
 //----------------------------------------------------------------------------
@@ -89,7 +107,7 @@ const ts::NamesFile* AllInstances::getFile(const ts::UString& fileName, bool mer
         return it->second;
     }
     else {
-        return _files[fileName] = new ts::NamesFile(fileName, mergeExtensions);
+        return _files[fileName] = new ts::NamesFile(fileName, mergeExtensions, true);
     }
 }
 
@@ -207,17 +225,21 @@ void ts::NamesFile::UnregisterExtensionFile(const UString& filename)
 // Constructor (load the configuration file).
 //----------------------------------------------------------------------------
 
-ts::NamesFile::NamesFile(const UString& fileName, bool mergeExtensions) :
+ts::NamesFile::NamesFile(const UString& fileName, bool mergeExtensions, bool useCache) :
     _log(CERR),
     _configFile(SearchConfigurationFile(fileName))
 {
+    // List of source text files.
+    std::list<SourceFile> sources;
+
     // Locate the configuration file.
     if (_configFile.empty()) {
         // Cannot load configuration, names will not be available.
         _log.error(u"configuration file '%s' not found", fileName);
     }
     else {
-        loadFile(_configFile);
+        sources.emplace_back();
+        sources.back().path = _configFile;
     }
 
     // Merge extensions if required.
@@ -231,18 +253,94 @@ ts::NamesFile::NamesFile(const UString& fileName, bool mergeExtensions) :
                 _log.error(u"extension file '%s' not found", name);
             }
             else {
-                loadFile(path);
+                sources.emplace_back();
+                sources.back().path = path;
+            }
+        }
+    }
+
+    // Get the identity of the source files, used to validate the cache file.
+    for (auto& src : sources) {
+        std::error_code err1, err2;
+        src.size = uint64_t(fs::file_size(src.path, err1));
+        src.time = int64_t(fs::last_write_time(src.path, err2).time_since_epoch().count());
+    }
+
+    // Try to use a compiled cache file.
+    fs::path cacheFile;
+    if (useCache && !sources.empty()) {
+        const fs::path dir(CacheDirectory());
+        if (!dir.empty()) {
+            cacheFile = dir;
+            cacheFile /= BaseName(fileName) + u".cache";
+            if (openCache(cacheFile, sources)) {
+                return;
+            }
+        }
+    }
+
+    // Parse the text files and compile them.
+    ConfigSectionMap sections;
+    for (const auto& src : sources) {
+        loadFile(sections, src.path);
+    }
+    compile(sections, sources);
+
+    // Never cache erroneous files, errors shall be reported each time.
+    if (!cacheFile.empty() && _configErrors == 0) {
+        saveCache(cacheFile);
+    }
+}
+
+ts::NamesFile::~NamesFile()
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Get the directory of the compiled cache files.
+//----------------------------------------------------------------------------
+
+fs::path ts::NamesFile::CacheDirectory()
+{
+    fs::path dir;
+    if (GetEnvironment(u"TSDUCK_NO_NAMES_CACHE").empty()) {
+        const UString root(GetEnvironment(u"TSDUCK_CACHE_DIR"));
+        if (!root.empty()) {
+            dir = root;
+        }
+        else {
+#if defined(TS_WINDOWS)
+            const UString local(GetEnvironment(u"LOCALAPPDATA"));
+            if (!local.empty()) {
+                dir = local;
+                dir /= u"tsduck";
+                dir /= u"cache";
+            }
+#else
+            const UString xdg(GetEnvironment(u"XDG_CACHE_HOME"));
+            const UString home(GetEnvironment(u"HOME"));
+            if (!xdg.empty()) {
+                dir = xdg;
+                dir /= u"tsduck";
             }
+            else if (!home.empty()) {
+                dir = home;
+                dir /= u".cache";
+                dir /= u"tsduck";
+            }
+#endif
         }
     }
+    return dir;
 }
 
 
 //----------------------------------------------------------------------------
-// Load a configuration file and merge its content into this instance.
+// Load a configuration file and merge its content into a map of sections.
 //----------------------------------------------------------------------------
 
-void ts::NamesFile::loadFile(const UString& fileName)
+void ts::NamesFile::loadFile(ConfigSectionMap& sections, const UString& fileName)
 {
     _log.debug(u"loading names file %s", fileName);
 
@@ -273,16 +371,7 @@ void ts::NamesFile::loadFile(const UString& fileName)
             line.convertToLower();
 
             // Get or create associated section.
-            auto it = _sections.find(line);
-            if (it != _sections.end()) {
-                section = it->second;
-            }
-            else {
-                // Create new section.
-                section = new ConfigSection;
-                CheckNonNull(section);
-                _sections.insert(std::make_pair(line, section));
-            }
+            section = &sections[line];
         }
         else if (!decodeDefinition(line, section)) {
             // Invalid line.
@@ -348,7 +437,7 @@ bool ts::NamesFile::decodeDefinition(const UString& line, ConfigSection* section
     // Add the definition.
     if (valid) {
         if (section->freeRange(first, last)) {
-            section->addEntry(first, last, value);
+            section->entries.emplace(first, ConfigEntry(last, value));
         }
         else {
             _log.error(u"%s: range 0x%X-0x%X overlaps with an existing range", _configFile, first, last);
@@ -359,34 +448,6 @@ bool ts::NamesFile::decodeDefinition(const UString& line, ConfigSection* section
 }
 
 
-//----------------------------------------------------------------------------
-// Destructor: free all resources.
-//----------------------------------------------------------------------------
-
-ts::NamesFile::~NamesFile()
-{
-    // Deallocate all configuration sections.
-    for (const auto& it : _sections) {
-        delete it.second;
-    }
-    _sections.clear();
-}
-
-
-//----------------------------------------------------------------------------
-// Configuration section.
-//----------------------------------------------------------------------------
-
-ts::NamesFile::ConfigSection::~ConfigSection()
-{
-    // Deallocate all configuration entries.
-    for (const auto& it : entries) {
-        delete it.second;
-    }
-    entries.clear();
-}
-
-
 //----------------------------------------------------------------------------
 // Check if a range is free, ie no value is defined in the range.
 //----------------------------------------------------------------------------
@@ -402,7 +463,7 @@ bool ts::NamesFile::ConfigSection::freeRange(Value first, Value last) const
         return false;
     }
 
-    if (it != entries.begin() && (--it)->second->last >= first) {
+    if (it != entries.begin() && (--it)->second.last >= first) {
         // The previous range ends inside [first..last].
         assert(it->first < first);
         return false;
@@ -414,42 +475,198 @@ bool ts::NamesFile::ConfigSection::freeRange(Value first, Value last) const
 
 
 //----------------------------------------------------------------------------
-// Add a new configuration entry.
+// Compile the sections into a binary image.
+//----------------------------------------------------------------------------
+
+void ts::NamesFile::compile(const ConfigSectionMap& sections, const std::list<SourceFile>& sources)
+{
+    // The directory is sorted by UTF-8 section names, which is the order of the binary search.
+    std::vector<std::pair<std::string, const ConfigSection*>> sorted;
+    sorted.reserve(sections.size());
+    for (const auto& it : sections) {
+        sorted.emplace_back(it.first.toUTF8(), &it.second);
+    }
+    std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    // Build the string pool and the various arrays separately.
+    ByteBlock strings;
+    const auto add_string = [&strings](ByteBlock& bb, const std::string& str) {
+        bb.appendUInt32(uint32_t(strings.size()));
+        bb.appendUInt32(uint32_t(str.size()));
+        strings.append(str.data(), str.size());
+    };
+
+    ByteBlock src_data;
+    for (const auto& src : sources) {
+        add_string(src_data, src.path.toUTF8());
+        src_data.appendUInt64(src.size);
+        src_data.appendInt64(src.time);
+    }
+
+    ByteBlock dir_data;
+    ByteBlock entry_data;
+    size_t entry_count = 0;
+    for (const auto& sec : sorted) {
+        add_string(dir_data, sec.first);
+        add_string(dir_data, sec.second->inherit.toUTF8());
+        dir_data.appendUInt32(uint32_t(sec.second->bits));
+        dir_data.appendUInt32(uint32_t(entry_count));
+        dir_data.appendUInt32(uint32_t(sec.second->entries.size()));
+        for (const auto& ent : sec.second->entries) {
+            entry_data.appendUInt64(ent.first);
+            entry_data.appendUInt64(ent.second.last);
+            add_string(entry_data, ent.second.name.toUTF8());
+        }
+        entry_count += sec.second->entries.size();
+    }
+
+    // Build the complete image.
+    const size_t src_offset = IMAGE_HEADER_SIZE;
+    const size_t dir_offset = src_offset + src_data.size();
+    const size_t entry_offset = dir_offset + dir_data.size();
+    const size_t strings_offset = entry_offset + entry_data.size();
+    const size_t image_size = strings_offset + strings.size();
+
+    _compiled.clear();
+    _compiled.reserve(image_size);
+    _compiled.appendUInt64(IMAGE_MAGIC);
+    _compiled.appendUInt32(IMAGE_VERSION);
+    _compiled.appendUInt32(uint32_t(image_size));
+    _compiled.appendUInt32(uint32_t(sources.size()));
+    _compiled.appendUInt32(uint32_t(src_offset));
+    _compiled.appendUInt32(uint32_t(sorted.size()));
+    _compiled.appendUInt32(uint32_t(dir_offset));
+    _compiled.appendUInt32(uint32_t(entry_count));
+    _compiled.appendUInt32(uint32_t(entry_offset));
+    _compiled.appendUInt32(uint32_t(strings_offset));
+    _compiled.appendUInt32(uint32_t(strings.size()));
+    assert(_compiled.size() == IMAGE_HEADER_SIZE);
+    _compiled.append(src_data);
+    _compiled.append(dir_data);
+    _compiled.append(entry_data);
+    _compiled.append(strings);
+
+    setImage();
+}
+
+
+//----------------------------------------------------------------------------
+// Check the validity of the binary image header and locate its parts.
 //----------------------------------------------------------------------------
 
-void ts::NamesFile::ConfigSection::addEntry(Value first, Value last, const UString& name)
+bool ts::NamesFile::setImage()
 {
-    ConfigEntry* entry = new ConfigEntry(last, name);
-    CheckNonNull(entry);
-    entries.insert(std::make_pair(first, entry));
+    _image = _cache.isOpen() ? _cache.data() : _compiled.data();
+    _imageSize = _cache.isOpen() ? _cache.size() : _compiled.size();
+
+    // Check that an area of the image is valid.
+    const auto valid_area = [this](size_t offset, size_t count, size_t record_size) {
+        return offset <= _imageSize && count <= (_imageSize - offset) / record_size;
+    };
+
+    bool valid = _image != nullptr &&
+        _imageSize >= IMAGE_HEADER_SIZE &&
+        GetUInt64(_image) == IMAGE_MAGIC &&
+        GetUInt32(_image + 8) == IMAGE_VERSION &&
+        GetUInt32(_image + 12) == _imageSize;
+
+    if (valid) {
+        _sectionCount = GetUInt32(_image + 24);
+        _entryCount = GetUInt32(_image + 32);
+        _stringsSize = GetUInt32(_image + 44);
+        valid = valid_area(GetUInt32(_image + 20), GetUInt32(_image + 16), IMAGE_SOURCE_SIZE) &&
+                valid_area(GetUInt32(_image + 28), _sectionCount, IMAGE_SECTION_SIZE) &&
+                valid_area(GetUInt32(_image + 36), _entryCount, IMAGE_ENTRY_SIZE) &&
+                valid_area(GetUInt32(_image + 40), _stringsSize, 1);
+    }
+
+    if (valid) {
+        _directory = _image + GetUInt32(_image + 28);
+        _entries = _image + GetUInt32(_image + 36);
+        _strings = _image + GetUInt32(_image + 40);
+    }
+    else {
+        _image = _directory = _entries = _strings = nullptr;
+        _imageSize = _sectionCount = _entryCount = _stringsSize = 0;
+    }
+    return valid;
 }
 
 
 //----------------------------------------------------------------------------
-// Get a name from a value, empty if not found.
+// Get a string from the string pool of the binary image.
 //----------------------------------------------------------------------------
 
-ts::UString ts::NamesFile::ConfigSection::getName(Value val) const
+ts::UString ts::NamesFile::imageString(const uint8_t* ref) const
 {
-    // Eliminate trivial cases which would cause issues with code below.
-    if (entries.empty()) {
+    const size_t offset = GetUInt32(ref);
+    const size_t length = GetUInt32(ref + 4);
+    if (offset > _stringsSize || length > _stringsSize - offset) {
         return UString();
     }
+    else {
+        return UString::FromUTF8(reinterpret_cast<const char*>(_strings + offset), length);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Open a cache file.
+//----------------------------------------------------------------------------
+
+bool ts::NamesFile::openCache(const fs::path& cacheFile, const std::list<SourceFile>& sources)
+{
+    if (!fs::exists(cacheFile) || !_cache.open(cacheFile, NULLREP)) {
+        return false;
+    }
 
-    // The key in the 'entries' map is the _first_ value of a range.
-    // Get an iterator pointing to the first element that is "not less" than 'val'.
-    auto it = entries.lower_bound(val);
+    // The cache file must be built from the same source files, in the same order.
+    bool valid = setImage() && GetUInt32(_image + 16) == sources.size();
+    const uint8_t* rec = _image + (valid ? GetUInt32(_image + 20) : 0);
+    for (auto it = sources.begin(); valid && it != sources.end(); ++it) {
+        valid = imageString(rec) == it->path && GetUInt64(rec + 8) == it->size && int64_t(GetUInt64(rec + 16)) == it->time;
+        rec += IMAGE_SOURCE_SIZE;
+    }
 
-    if (it == entries.end() || (it != entries.begin() && it->first != val)) {
-        // There is no entry with a value range starting at 'val'.
-        // Maybe 'val' is in the range of the previous entry.
-        --it;
+    if (valid) {
+        _log.debug(u"using names cache file %s", cacheFile);
     }
+    else {
+        _log.debug(u"names cache file %s is outdated", cacheFile);
+        _cache.close();
+        setImage();
+    }
+    return valid;
+}
+
+
+//----------------------------------------------------------------------------
+// Save the compiled image in a cache file.
+//----------------------------------------------------------------------------
 
-    assert(it != entries.end());
-    assert(it->second != nullptr);
+void ts::NamesFile::saveCache(const fs::path& cacheFile)
+{
+    // Create the cache directory if necessary.
+    std::error_code err;
+    fs::create_directories(cacheFile.parent_path(), err);
 
-    return val >= it->first && val <= it->second->last ? it->second->name : UString();
+    // Other processes may concurrently use or rebuild the cache file.
+    // The cache file is never modified in place, a new file replaces it.
+    fs::path temp(cacheFile);
+    temp += UString::Format(u".%X.tmp", UID::Instance().newUID());
+    if (!_compiled.saveToFile(temp)) {
+        _log.debug(u"cannot create names cache file %s", temp);
+    }
+    else {
+        fs::rename(temp, cacheFile, err);
+        if (err) {
+            _log.debug(u"cannot create names cache file %s: %s", cacheFile, err.message());
+            fs::remove(temp, err);
+        }
+        else {
+            _log.debug(u"created names cache file %s", cacheFile);
+        }
+    }
 }
 
 
@@ -548,11 +765,50 @@ ts::UString ts::NamesFile::Formatted(Value value, const UString& name, NamesFlag
 
 
 //----------------------------------------------------------------------------
-// Get the section and name from a value, empty if not found.
+// Find a section in the binary image.
+//----------------------------------------------------------------------------
+
+const uint8_t* ts::NamesFile::findSection(const UString& sectionName) const
+{
+    // Binary search in the directory, sorted by UTF-8 section names.
+    const std::string name(sectionName.toUTF8());
+    size_t low = 0;
+    size_t high = _sectionCount;
+    while (low < high) {
+        const size_t mid = low + (high - low) / 2;
+        const uint8_t* sec = _directory + mid * IMAGE_SECTION_SIZE;
+        const size_t offset = GetUInt32(sec);
+        const size_t length = GetUInt32(sec + 4);
+        if (offset > _stringsSize || length > _stringsSize - offset) {
+            return nullptr; // corrupted image
+        }
+        const int cmp = name.compare(0, name.size(), reinterpret_cast<const char*>(_strings + offset), length);
+        if (cmp == 0) {
+            // Check the range of entries of the section.
+            const size_t first = GetUInt32(sec + 20);
+            const size_t count = GetUInt32(sec + 24);
+            return first <= _entryCount && count <= _entryCount - first ? sec : nullptr;
+        }
+        else if (cmp < 0) {
+            high = mid;
+        }
+        else {
+            low = mid + 1;
+        }
+    }
+    return nullptr;
+}
+
+
+//----------------------------------------------------------------------------
+// Get the section and name from a value.
 //----------------------------------------------------------------------------
 
-void ts::NamesFile::getName(const UString& sectionName, Value value, ConfigSection*& section, UString& name) const
+bool ts::NamesFile::getName(const UString& sectionName, Value value, size_t& bits, UString& name) const
 {
+    bits = 0;
+    name.clear();
+
     // Normalized section name.
     UString sname(NormalizedSectionName(sectionName));
 
@@ -562,25 +818,44 @@ void ts::NamesFile::getName(const UString& sectionName, Value value, ConfigSecti
     // Loop on inherited sections, until a name is found.
     for (;;) {
         // Get the section.
-        const auto it = _sections.find(sname);
-        if (it == _sections.end()) {
+        const uint8_t* section = findSection(sname);
+        if (section == nullptr) {
             // Section not found, no name.
-            section = nullptr;
-            name.clear();
-            return;
+            return false;
+        }
+        bits = GetUInt32(section + 16);
+
+        // The entries of the section are sorted by first value of their range.
+        // Count the entries with a range starting at or before 'value'.
+        const uint8_t* const entries = _entries + GetUInt32(section + 20) * IMAGE_ENTRY_SIZE;
+        size_t low = 0;
+        size_t high = GetUInt32(section + 24);
+        while (low < high) {
+            const size_t mid = low + (high - low) / 2;
+            if (GetUInt64(entries + mid * IMAGE_ENTRY_SIZE) <= value) {
+                low = mid + 1;
+            }
+            else {
+                high = mid;
+            }
         }
 
-        // Get the name of the value in the section.
-        section = it->second;
-        name = section->getName(value);
+        // Maybe 'value' is in the range of the last of these entries.
+        if (low > 0) {
+            const uint8_t* const entry = entries + (low - 1) * IMAGE_ENTRY_SIZE;
+            if (value <= GetUInt64(entry + 8)) {
+                name = imageString(entry + 16);
+            }
+        }
 
         // Return when name found or no "superclass" or too many levels of inheritance.
-        if (!name.empty() || section->inherit.empty() || levels-- <= 0) {
-            return;
+        const UString inherit(name.empty() ? imageString(section + 8) : UString());
+        if (inherit.empty() || levels-- <= 0) {
+            return true;
         }
 
         // Loop on "superclass".
-        sname = NormalizedSectionName(section->inherit);
+        sname = NormalizedSectionName(inherit);
     }
 }
 
@@ -591,9 +866,9 @@ void ts::NamesFile::getName(const UString& sectionName, Value value, ConfigSecti
 
 bool ts::NamesFile::nameExists(const UString& sectionName, Value value) const
 {
-    ConfigSection* section = nullptr;
+    size_t bits = 0;
     UString name;
-    getName(sectionName, value, section, name);
+    getName(sectionName, value, bits, name);
     return !name.empty();
 }
 
@@ -604,16 +879,15 @@ bool ts::NamesFile::nameExists(const UString& sectionName, Value value) const
 
 ts::UString ts::NamesFile::nameFromSection(const UString& sectionName, Value value, NamesFlags flags, size_t bits, Value alternateValue) const
 {
-    ConfigSection* section = nullptr;
+    size_t sectionBits = 0;
     UString name;
-    getName(sectionName, value, section, name);
 
-    if (section == nullptr) {
+    if (!getName(sectionName, value, sectionBits, name)) {
         // Non-existent section, no name.
         return Formatted(value, UString(), flags, bits, alternateValue);
     }
     else {
-        return Formatted(value, name, flags, bits != 0 ? bits : section->bits, alternateValue);
+        return Formatted(value, name, flags, bits != 0 ? bits : sectionBits, alternateValue);
     }
 }
 
@@ -624,17 +898,16 @@ ts::UString ts::NamesFile::nameFromSection(const UString& sectionName, Value val
 
 ts::UString ts::NamesFile::nameFromSectionWithFallback(const UString& sectionName, Value value1, Value value2, NamesFlags flags, size_t bits, Value alternateValue) const
 {
-    ConfigSection* section = nullptr;
+    size_t sectionBits = 0;
     UString name;
-    getName(sectionName, value1, section, name);
 
-    if (section == nullptr) {
+    if (!getName(sectionName, value1, sectionBits, name)) {
         // Non-existent section, no name.
         return Formatted(value1, UString(), flags, bits, alternateValue);
     }
     else if (!name.empty()) {
         // value1 has a name
-        return Formatted(value1, name, flags, bits != 0 ? bits : section->bits, alternateValue);
+        return Formatted(value1, name, flags, bits != 0 ? bits : sectionBits, alternateValue);
     }
     else {
         // value1 has no name, use value2, restart from the beginning in case of inheritance.
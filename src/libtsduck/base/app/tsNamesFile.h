@@ -16,6 +16,7 @@
 #include "tsEnumUtils.h"
 #include "tsReport.h"
 #include "tsVersionInfo.h"
+#include "tsMemoryMappedFile.h"
 
 namespace ts {
     //!
@@ -45,6 +46,21 @@ namespace ts {
     //! In an instance of NamesFile, all names are loaded from one configuration file.
     //! @ingroup app
     //!
+    //! The text files are compiled into a binary image: a directory of sections, sorted by name,
+    //! and one sorted array of value ranges per section. Names are searched using a binary search
+    //! in this image. Nothing is allocated per section or per entry.
+    //!
+    //! With the common instances, see Instance(), the compiled image is saved in a cache file
+    //! in the user's cache directory. The next executions map this cache file in memory instead
+    //! of parsing the text files again. Only the memory pages of the sections which are actually
+    //! used are loaded by the system. The cache file is automatically rebuilt when one of the
+    //! source text files is modified or when the list of extension files changes.
+    //!
+    //! The cache directory is @c $TSDUCK_CACHE_DIR if defined. Otherwise, it is
+    //! @c $XDG_CACHE_HOME/tsduck or @c $HOME/.cache/tsduck on UNIX systems and
+    //! @c \%LOCALAPPDATA%\tsduck\cache on Windows. The cache is disabled when the
+    //! environment variable @c TSDUCK_NO_NAMES_CACHE is defined and not empty.
+    //!
     class TSDUCKDLL NamesFile
     {
         TS_NOBUILD_NOCOPY(NamesFile);
@@ -55,10 +71,11 @@ namespace ts {
         //! @param [in] fileName Configuration file name. Typically without directory name.
         //! Without directory, the file is automatically searched in the TSDuck configuration directory.
         //! @param [in] mergeExtensions If true, merge the content of names files from TSDuck extensions.
+        //! @param [in] useCache If true, use a compiled cache file in the user's cache directory.
         //! @see Instance(const UString&, bool);
         //! @see Instance(Predefined, bool);
         //!
-        NamesFile(const UString& fileName, bool mergeExtensions = false);
+        NamesFile(const UString& fileName, bool mergeExtensions = false, bool useCache = false);
 
         //!
         //! Virtual destructor.
@@ -128,6 +145,18 @@ namespace ts {
         //!
         size_t errorCount() const { return _configErrors; }
 
+        //!
+        //! Check if the names were loaded from a compiled cache file.
+        //! @return True if the names were loaded from a compiled cache file, false if they were parsed from the text files.
+        //!
+        bool isCached() const { return _cache.isOpen(); }
+
+        //!
+        //! Get the directory of the compiled cache files of names files.
+        //! @return The directory of the cache files or an empty path if the cache is disabled.
+        //!
+        static fs::path CacheDirectory();
+
         //!
         //! Check if a name exists in a specified section.
         //! @param [in] sectionName Name of section to search. Not case-sensitive.
@@ -198,7 +227,7 @@ namespace ts {
         static void UnregisterExtensionFile(const UString& filename);
 
     private:
-        // Description of a configuration entry.
+        // Description of a configuration entry, while parsing the text files.
         // The first value of the range is the key in a map.
         class ConfigEntry
         {
@@ -210,33 +239,32 @@ namespace ts {
         };
 
         // Map of configuration entries, indexed by first value of the range.
-        using ConfigEntryMap = std::map<Value, ConfigEntry*>;
+        using ConfigEntryMap = std::map<Value, ConfigEntry>;
 
-        // Description of a configuration section.
+        // Description of a configuration section, while parsing the text files.
         // The name of the section is the key in a map.
         class ConfigSection
         {
-            TS_NOCOPY(ConfigSection);
         public:
             size_t          bits = 0;     // Number of significant bits in values of the type.
-            ConfigEntryMap  entries {};   // All entries, indexed by names.
+            ConfigEntryMap  entries {};   // All entries, indexed by first value.
             UString         inherit {};   // Redirect to this section if value not found.
 
-            ConfigSection() = default;
-            ~ConfigSection();
-
             // Check if a range is free, ie no value is defined in the range.
             bool freeRange(Value first, Value last) const;
-
-            // Add a new entry.
-            void addEntry(Value first, Value last, const UString& name);
-
-            // Get a name from a value, empty if not found.
-            UString getName(Value val) const;
         };
 
         // Map of configuration sections, indexed by name.
-        using ConfigSectionMap = std::map<UString, ConfigSection*>;
+        using ConfigSectionMap = std::map<UString, ConfigSection>;
+
+        // Identification of a source text file, used to validate a cache file.
+        class SourceFile
+        {
+        public:
+            UString  path {};    // Full path of the text file.
+            uint64_t size = 0;   // File size in bytes.
+            int64_t  time = 0;   // Last modification time, in file system units.
+        };
 
         // Decode a line as "first[-last] = name". Return true on success, false on error.
         bool decodeDefinition(const UString& line, ConfigSection* section);
@@ -247,20 +275,47 @@ namespace ts {
         // Compute the display mask
         static Value DisplayMask(size_t bits);
 
-        // Load a configuration file and merge its content into this instance.
-        void loadFile(const UString& fileName);
+        // Load a configuration file and merge its content into a map of sections.
+        void loadFile(ConfigSectionMap& sections, const UString& fileName);
+
+        // Compile the sections into the binary image _compiled.
+        void compile(const ConfigSectionMap& sections, const std::list<SourceFile>& sources);
+
+        // Open a cache file. Return true if the cache file is valid for these source files.
+        bool openCache(const fs::path& cacheFile, const std::list<SourceFile>& sources);
+
+        // Save the compiled image in a cache file.
+        void saveCache(const fs::path& cacheFile);
+
+        // Check the validity of the binary image header. Use a mapped cache file if open, _compiled otherwise.
+        bool setImage();
+
+        // Get a string from the string pool of the binary image.
+        UString imageString(const uint8_t* ref) const;
+
+        // Find a section in the binary image. Return a pointer to the directory record or null if not found.
+        const uint8_t* findSection(const UString& sectionName) const;
 
-        // Get the section and name from a value, empty if not found. Section can be null.
-        void getName(const UString& sectionName, Value value, ConfigSection*& section, UString& name) const;
+        // Get the section and name from a value. Return false if the section does not exist.
+        bool getName(const UString& sectionName, Value value, size_t& bits, UString& name) const;
 
         // Normalized section name.
         static UString NormalizedSectionName(const UString& sectionName) { return sectionName.toTrimmed().toLower(); }
 
         // Names private fields.
-        Report&          _log;               // Error logger.
-        const UString    _configFile;        // Configuration file path.
-        size_t           _configErrors = 0;  // Number of errors in configuration file.
-        ConfigSectionMap _sections {};       // Configuration sections.
+        Report&          _log;                  // Error logger.
+        const UString    _configFile;           // Configuration file path.
+        size_t           _configErrors = 0;     // Number of errors in configuration file.
+        MemoryMappedFile _cache {};             // Cache file, when valid.
+        ByteBlock        _compiled {};          // Compiled image, when not loaded from the cache.
+        const uint8_t*   _image = nullptr;      // Address of the binary image (in _cache or _compiled).
+        size_t           _imageSize = 0;        // Size of the binary image.
+        const uint8_t*   _directory = nullptr;  // Directory of sections, sorted by name.
+        size_t           _sectionCount = 0;     // Number of sections in the directory.
+        const uint8_t*   _entries = nullptr;    // Array of all entries, sorted by section and value.
+        size_t           _entryCount = 0;       // Number of entries.
+        const uint8_t*   _strings = nullptr;    // String pool (UTF-8).
+        size_t           _stringsSize = 0;      // Size of the string pool.
     };
 
     //!
@@ -341,7 +341,9 @@ ts::UString ts::VersionInfo::GetVersion(Format format, const UString& applicatio
         }
         case Format::ACCELERATION: {
             // Support for accelerated instructions.
-            return UString::Format(u"CRC32: %s", UString::YesNo(SysInfo::Instance().crcInstructions()));
+            return UString::Format(u"CRC32: %s, SIMD: %s",
+                                   UString::YesNo(SysInfo::Instance().crcInstructions()),
+                                   UString::YesNo(SysInfo::Instance().simdInstructions()));
         }
         case Format::ALL: {
             return GetVersion(Format::LONG, applicationName) + LINE_FEED +
@@ -27,7 +27,24 @@ bool ts::json::Number::isNumber() const
 
 void ts::json::Number::print(TextFormatter& output) const
 {
-    output << toString();
+    if (isInteger()) {
+        // Integer values are directly formatted in ASCII, the most frequent case.
+        char buf[24];
+        char* const end = buf + sizeof(buf);
+        char* cur = end;
+        uint64_t value = _integer < 0 ? uint64_t(0) - uint64_t(_integer) : uint64_t(_integer);
+        do {
+            *--cur = char('0' + value % 10);
+            value /= 10;
+        } while (value != 0);
+        if (_integer < 0) {
+            *--cur = '-';
+        }
+        output.write(cur, end - cur);
+    }
+    else {
+        output << UString::Float(_float);
+    }
 }
 
 bool ts::json::Number::toBoolean(bool defaultValue) const
@@ -133,7 +133,9 @@ void ts::json::Object::print(TextFormatter& output) const
         if (!first) {
             output << ",";
         }
-        output << ts::endl << ts::margin << '"' << it.first.toJSON() << "\": ";
+        output << ts::endl << ts::margin;
+        String::PrintLiteral(output, it.first);
+        output << ": ";
         it.second->print(output);
         first = false;
     }
@@ -8,6 +8,7 @@
 
 #include "tsjsonRunningDocument.h"
 #include "tsjsonValue.h"
+#include "tsjsonString.h"
 
 
 //----------------------------------------------------------------------------
@@ -75,7 +76,9 @@ bool ts::json::RunningDocument::open(const ValuePtr& root, const fs::path& fileN
                     if (count++ > 0) {
                         _text << ",";
                     }
-                    _text << ts::endl << ts::margin << '"' << it.toJSON() << "\": ";
+                    _text << ts::endl << ts::margin;
+                    String::PrintLiteral(_text, it);
+                    _text << ": ";
                     subval->print(_text);
                 }
             }
@@ -83,7 +86,9 @@ bool ts::json::RunningDocument::open(const ValuePtr& root, const fs::path& fileN
             if (count > 0) {
                 _text << ",";
             }
-            _text << ts::endl << ts::margin << '"' << last_name.toJSON() << "\": ";
+            _text << ts::endl << ts::margin;
+            String::PrintLiteral(_text, last_name);
+            _text << ": ";
         }
         // Print the start of the array.
         const ValuePtr& value(path.back());
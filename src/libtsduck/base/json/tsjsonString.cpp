@@ -26,7 +26,66 @@ bool ts::json::String::isString() const
 
 void ts::json::String::print(TextFormatter& output) const
 {
-    output << '"' << _value.toJSON() << '"';
+    PrintLiteral(output, _value);
+}
+
+
+//----------------------------------------------------------------------------
+// Print a string as a JSON string literal.
+//----------------------------------------------------------------------------
+
+void ts::json::String::PrintLiteral(TextFormatter& output, const UString& str)
+{
+    // All characters are formatted in ASCII (same rules as UString::convertToJSON()).
+    // Format in a local buffer, written by chunks, without allocation.
+    constexpr size_t buf_size = 256;
+    constexpr size_t max_seq = 6; // longest escape sequence: \uXXXX
+    static const char hex[] = "0123456789ABCDEF";
+    char buf[buf_size];
+    size_t len = 0;
+
+    buf[len++] = '"';
+    for (const UChar c : str) {
+        if (len > buf_size - max_seq) {
+            output.write(buf, std::streamsize(len));
+            len = 0;
+        }
+        char quoted = 0;
+        switch (c) {
+            case QUOTATION_MARK: quoted = '"'; break;
+            case REVERSE_SOLIDUS: quoted = '\\'; break;
+            case BACKSPACE: quoted = 'b'; break;
+            case FORM_FEED: quoted = 'f'; break;
+            case LINE_FEED: quoted = 'n'; break;
+            case CARRIAGE_RETURN: quoted = 'r'; break;
+            case HORIZONTAL_TABULATION: quoted = 't'; break;
+            default: break;
+        }
+        if (quoted != 0) {
+            // Single character backslash sequence
+            buf[len++] = '\\';
+            buf[len++] = quoted;
+        }
+        else if (c >= 0x0020 && c <= 0x007E) {
+            // Unmodified character
+            buf[len++] = char(c);
+        }
+        else {
+            // Other Unicode character, use hex code.
+            buf[len++] = '\\';
+            buf[len++] = 'u';
+            buf[len++] = hex[(c >> 12) & 0x0F];
+            buf[len++] = hex[(c >> 8) & 0x0F];
+            buf[len++] = hex[(c >> 4) & 0x0F];
+            buf[len++] = hex[c & 0x0F];
+        }
+    }
+    if (len >= buf_size) {
+        output.write(buf, std::streamsize(len));
+        len = 0;
+    }
+    buf[len++] = '"';
+    output.write(buf, std::streamsize(len));
 }
 
 int64_t ts::json::String::toInteger(int64_t defaultValue) const
@@ -40,6 +40,15 @@ namespace ts {
             virtual size_t size() const override;
             virtual void clear() override;
 
+            //!
+            //! Print a string as a JSON string literal, with quotes and escape sequences.
+            //! The string is directly formatted in UTF-8, without intermediate string.
+            //! The output is the same as <code>'"' + str.toJSON() + '"'</code>.
+            //! @param [in,out] output The text formatter to print to.
+            //! @param [in] str The string to print.
+            //!
+            static void PrintLiteral(TextFormatter& output, const UString& str);
+
         private:
             UString _value {};
         };
@@ -29,13 +29,14 @@ ts::PcapFile::~PcapFile()
 
 bool ts::PcapFile::open(const fs::path& filename, Report& report)
 {
-    if (_in != nullptr) {
+    if (isOpen()) {
         report.error(u"already open");
         return false;
     }
 
     // Reset counters.
     _error = false;
+    _eof = false;
     _file_size = 0;
     _packet_count = 0;
     _ipv4_packet_count = 0;
@@ -43,6 +44,10 @@ bool ts::PcapFile::open(const fs::path& filename, Report& report)
     _ipv4_packets_size = 0;
     _first_timestamp = cn::microseconds(-1);
     _last_timestamp = cn::microseconds(-1);
+    _max_timestamp = cn::microseconds(-1);
+    _section_count = 0;
+    _indexing = false;
+    _index.clear();
 
     // Open the file.
     if (filename.empty() || filename == u"-") {
@@ -54,12 +59,16 @@ bool ts::PcapFile::open(const fs::path& filename, Report& report)
         _name = u"standard input";
     }
     else {
-        _file.open(filename, std::ios::in | std::ios::binary);
-        if (!_file) {
-            report.error(u"error opening %s", filename);
-            return false;
+        // Map the file in memory when requested and possible. Otherwise, read it as a
+        // stream (large capture files are never entirely loaded in memory).
+        if (!_use_mmap || !_map.open(filename, NULLREP, false)) {
+            _file.open(filename, std::ios::in | std::ios::binary);
+            if (!_file) {
+                report.error(u"error opening %s", filename);
+                return false;
+            }
+            _in = &_file;
         }
-        _in = &_file;
         _name = filename;
     }
 
@@ -70,7 +79,73 @@ bool ts::PcapFile::open(const fs::path& filename, Report& report)
         return false;
     }
 
-    report.debug(u"opened %s, %s format version %d.%d, %s endian", _name, _ng ? u"pcap-ng" : u"pcap", _major, _minor, _be ? u"big" : u"little");
+    report.debug(u"opened %s, %s format version %d.%d, %s endian%s", _name, _ng ? u"pcap-ng" : u"pcap", _major, _minor, _be ? u"big" : u"little", _map.isOpen() ? u", mapped in memory" : u"");
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Use an index for the capture file.
+//----------------------------------------------------------------------------
+
+bool ts::PcapFile::useIndex(Report& report)
+{
+    if (!isOpen() || _in == &std::cin) {
+        report.warning(u"cannot index %s", _name);
+        return false;
+    }
+    if (_packet_count > 0) {
+        report.error(u"cannot index %s, packets were already read", _name);
+        return false;
+    }
+
+    // Load the index file. If there is none, build the index while reading the file.
+    if (_index.load(_name, report)) {
+        _indexing = false;
+        report.verbose(u"using index of %s, %'d packets", _name, _index.packet_count);
+        return true;
+    }
+    else {
+        _index.clear();
+        _indexing = true;
+        return false;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Seek the capture file to a checkpoint of its index.
+//----------------------------------------------------------------------------
+
+bool ts::PcapFile::seek(const PcapIndex::Checkpoint& checkpoint, Report& report)
+{
+    if (!isOpen() || _in == &std::cin || !_index.complete) {
+        report.error(u"cannot seek in %s, no index", _name);
+        return false;
+    }
+    if (_map.isOpen() && checkpoint.offset > _map.size()) {
+        // After the mapped content of a growing file.
+        _file_size = _map.size();
+        if (!unmapFile(report)) {
+            return false;
+        }
+    }
+    if (!_map.isOpen()) {
+        _file.clear();
+        if (!_file.seekg(std::streamoff(checkpoint.offset))) {
+            report.error(u"error seeking to offset %'d in %s", checkpoint.offset, _name);
+            return false;
+        }
+    }
+
+    // The checkpoints are all in the first section, with the interfaces of the first packet.
+    _file_size = checkpoint.offset;
+    _packet_count = checkpoint.packet_count;
+    _first_timestamp = _index.first_timestamp;
+    _max_timestamp = checkpoint.max_timestamp;
+    _if = _index.interfaces;
+    _error = _eof = false;
+    report.debug(u"seek %s to offset %'d, after %'d packets", _name, _file_size, _packet_count);
     return true;
 }
 
@@ -84,6 +159,7 @@ void ts::PcapFile::close()
     if (_file.is_open()) {
         _file.close();
     }
+    _map.close();
     _in = nullptr;
 }
 
@@ -94,12 +170,26 @@ void ts::PcapFile::close()
 
 bool ts::PcapFile::readall(uint8_t* data, size_t size, Report& report)
 {
+    // Memory-mapped file: direct copy, no system call. After the end of the mapped content,
+    // the file may have grown since it was mapped: continue reading it as a stream.
+    if (_map.isOpen()) {
+        if (size <= _map.size() - _file_size) {
+            MemCopy(data, _map.data() + _file_size, size);
+            _file_size += size;
+            return true;
+        }
+        if (!unmapFile(report)) {
+            return error();
+        }
+    }
+
     // Repeatedly read until all requested bytes are read.
     while (size > 0) {
         // Read at most "size" bytes.
         if (!_in->read(reinterpret_cast<char*>(data), size)) {
             // Read error, don't display error on end-of-file.
-            if (!_in->eof()) {
+            _eof = _in->eof();
+            if (!_eof) {
                 report.error(u"error reading %s", _name);
             }
             return error();
@@ -120,6 +210,24 @@ bool ts::PcapFile::readall(uint8_t* data, size_t size, Report& report)
 }
 
 
+//----------------------------------------------------------------------------
+// Stop mapping the file and continue reading it as a stream.
+//----------------------------------------------------------------------------
+
+bool ts::PcapFile::unmapFile(Report& report)
+{
+    _map.close();
+    _file.open(fs::path(_name), std::ios::in | std::ios::binary);
+    if (!_file || !_file.seekg(std::streamoff(_file_size))) {
+        report.error(u"error reading %s", _name);
+        _file.close();
+        return false;
+    }
+    _in = &_file;
+    return true;
+}
+
+
 //----------------------------------------------------------------------------
 // Read a file header, starting from a magic which was read as big endian.
 //----------------------------------------------------------------------------
@@ -140,6 +248,7 @@ bool ts::PcapFile::readHeader(uint32_t magic, Report& report)
             _be = magic == PCAP_MAGIC_BE || magic == PCAPNS_MAGIC_BE;
             _major = get16(header);
             _minor = get16(header + 2);
+            _section_count = 1;
             _if.resize(1); // only one interface in pcap files
             _if[0].link_type = get16(header + 18);
             _if[0].time_units = magic == PCAP_MAGIC_BE || magic == PCAP_MAGIC_LE ? std::micro::den : std::nano::den;
@@ -158,6 +267,7 @@ bool ts::PcapFile::readHeader(uint32_t magic, Report& report)
             }
             _major = get16(header.data() + 4);
             _minor = get16(header.data() + 6);
+            _section_count++;
             _if.clear(); // will read interface descriptions in dedicated blocks.
             break;
         }
@@ -284,23 +394,69 @@ bool ts::PcapFile::readNgBlockBody(uint32_t block_type, ByteBlock& body, Report&
 }
 
 
+//----------------------------------------------------------------------------
+// Record a checkpoint in the index being built, before a packet block.
+//----------------------------------------------------------------------------
+
+void ts::PcapFile::addCheckpoint(uint64_t offset)
+{
+    if (_indexing) {
+        // Interfaces which are valid for all checkpoints.
+        if (_packet_count == 0) {
+            _index.interfaces = _if;
+        }
+        // A checkpoint can be used to restart reading only if the file structure is the same as
+        // at the first packet: no new section header, no new interface description.
+        if (_packet_count % PcapIndex::DEFAULT_CHECKPOINT_INTERVAL == 0 && _section_count == 1 && _if.size() == _index.interfaces.size()) {
+            PcapIndex::Checkpoint cp;
+            cp.offset = offset;
+            cp.packet_count = _packet_count;
+            cp.max_timestamp = _max_timestamp;
+            _index.checkpoints.push_back(cp);
+        }
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Read the next IPv4 packet (headers included).
 //----------------------------------------------------------------------------
 
 bool ts::PcapFile::readIPv4(IPv4Packet& packet, cn::microseconds& timestamp, Report& report)
+{
+    const bool ok = readNextIPv4(packet, timestamp, report);
+    if (_indexing) {
+        if (ok) {
+            _index.ipv4_stats.addPacket(packet, timestamp);
+            _index.flows[PcapIndex::FlowId(packet.sourceSocketAddress(), packet.destinationSocketAddress(), packet.protocol())].addPacket(packet, timestamp);
+        }
+        else if (_eof) {
+            // The complete file was read, save the index.
+            _indexing = false;
+            _index.complete = true;
+            _index.first_timestamp = _first_timestamp;
+            _index.packet_count = _packet_count;
+            if (!_index.save(_name, report)) {
+                report.warning(u"cannot save index of %s", _name);
+            }
+        }
+    }
+    return ok;
+}
+
+bool ts::PcapFile::readNextIPv4(IPv4Packet& packet, cn::microseconds& timestamp, Report& report)
 {
     // Clear output values.
     packet.clear();
     timestamp = cn::microseconds(-1);
 
     // Check that the file is open.
-    if (_in == nullptr) {
+    if (!isOpen()) {
         report.error(u"no pcap file open");
         return false;
     }
     if (_error) {
-        if (!_in->eof()) {
+        if (!_eof) {
             report.debug(u"pcap file already in error state");
         }
         return false;
@@ -318,6 +474,7 @@ bool ts::PcapFile::readIPv4(IPv4Packet& packet, cn::microseconds& timestamp, Rep
         timestamp = cn::microseconds(-1);
 
         // We are at the beginning of a data block.
+        const uint64_t block_offset = _file_size;
         if (_ng) {
             // Pcap-ng file, read block type value.
             uint8_t type_field[4];
@@ -344,6 +501,7 @@ bool ts::PcapFile::readIPv4(IPv4Packet& packet, cn::microseconds& timestamp, Rep
                 continue; // loop to next packet block
             }
             else if ((type == PCAPNG_ENHANCED_PACKET || type == PCAPNG_OBSOLETE_PACKET) && buffer.size() >= 20) {
+                addCheckpoint(block_offset);
                 _packet_count++;
                 cap_start = 20;
                 cap_size = std::min<size_t>(get32(buffer.data() + 12), buffer.size() - 20);
@@ -372,6 +530,7 @@ bool ts::PcapFile::readIPv4(IPv4Packet& packet, cn::microseconds& timestamp, Rep
                 }
             }
             else if (type == PCAPNG_SIMPLE_PACKET && buffer.size() >= 4) {
+                addCheckpoint(block_offset);
                 _packet_count++;
                 cap_start = 4;
                 orig_size = get32(buffer.data());
@@ -384,11 +543,12 @@ bool ts::PcapFile::readIPv4(IPv4Packet& packet, cn::microseconds& timestamp, Rep
         }
         else {
             // Pcap file, beginning of a packet block. Read the 16-byte header.
-            _packet_count++;
             uint8_t header[16];
             if (!readall(header, sizeof(header), report)) {
                 return error();
             }
+            addCheckpoint(block_offset);
+            _packet_count++;
             const uint32_t tstamp = get32(header);
             const uint32_t sub_tstamp = get32(header + 4);
             cap_size = get32(header + 8);
@@ -424,6 +584,7 @@ bool ts::PcapFile::readIPv4(IPv4Packet& packet, cn::microseconds& timestamp, Rep
                 _first_timestamp = timestamp;
             }
             _last_timestamp = timestamp;
+            _max_timestamp = std::max(_max_timestamp, timestamp);
         }
 
         report.log(2, u"pcap data block: %d bytes, captured packet at offset %d, %d bytes (original: %d bytes), link type: %d",
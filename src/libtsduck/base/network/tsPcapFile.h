@@ -17,6 +17,8 @@
 #include "tsTime.h"
 #include "tsIPv4Packet.h"
 #include "tsPcap.h"
+#include "tsPcapIndex.h"
+#include "tsMemoryMappedFile.h"
 
 namespace ts {
     //!
@@ -27,6 +29,10 @@ namespace ts {
     //! This class reads a pcap or pcapng file and extracts IPv4 frames.
     //! All metadata and all other types of frames are ignored.
     //!
+    //! When possible, a named file is mapped in memory instead of being read through
+    //! a stream. Additionally, an index of the file can be built while reading the file
+    //! and reused later to seek directly to a given packet or timestamp (see useIndex()).
+    //!
     //! @see https://tools.ietf.org/pdf/draft-gharris-opsawg-pcap-02.pdf (PCAP)
     //! @see https://datatracker.ietf.org/doc/draft-gharris-opsawg-pcap/ (PCAP tracker)
     //! @see https://tools.ietf.org/pdf/draft-tuexen-opsawg-pcapng-04.pdf (PCAP-ng)
@@ -54,11 +60,22 @@ namespace ts {
         //!
         virtual bool open(const fs::path& filename, Report& report);
 
+        //!
+        //! Use memory mapping to read the file.
+        //! This method shall be called before opening the file. A named capture file is then
+        //! mapped in memory instead of being read as a stream. After the end of the mapped content,
+        //! the file is read as a stream: data which were appended to a growing capture file after
+        //! opening it are read as usual. The file must not be truncated while it is mapped, see
+        //! MemoryMappedFile. By default, capture files are read as streams.
+        //! @param [in] on True to use memory mapping when possible.
+        //!
+        void setMemoryMapping(bool on) { _use_mmap = on; }
+
         //!
         //! Check if the file is open.
         //! @return True if the file is open, false otherwise.
         //!
-        bool isOpen() const { return _in != nullptr; }
+        bool isOpen() const { return _in != nullptr || _map.isOpen(); }
 
         //!
         //! Get the file name.
@@ -150,6 +167,40 @@ namespace ts {
             return timestamp < cn::microseconds::zero() ? Time::Epoch : Time::UnixEpoch + timestamp;
         }
 
+        //!
+        //! Use an index for the capture file.
+        //!
+        //! Must be called after open() and before reading the first packet. When a valid index
+        //! file exists for the capture file, it is loaded. Otherwise, the index is built while
+        //! reading the capture file and saved in an index file when the end of file is reached.
+        //! The index of a capture file is stored in a file with the same name and an additional
+        //! ".tsidx" extension. The standard input cannot be indexed.
+        //!
+        //! @param [in,out] report Where to report errors.
+        //! @return True if a complete index was loaded, false if the index will be built
+        //! while reading the file or cannot be used.
+        //! @see ts::PcapIndex
+        //!
+        bool useIndex(Report& report);
+
+        //!
+        //! Get the index of the capture file.
+        //! @return A constant reference to the index. The index is complete only after being
+        //! loaded by useIndex() or after reading the capture file up to the end of file.
+        //!
+        const PcapIndex& index() const { return _index; }
+
+        //!
+        //! Seek the capture file to a checkpoint of its index.
+        //! After seeking, the packet count and the first timestamp are restored from the
+        //! index. Other statistics, such as the number of IPv4 packets, only apply to the
+        //! packets which are actually read.
+        //! @param [in] checkpoint A checkpoint from the complete index of the file.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //!
+        bool seek(const PcapIndex::Checkpoint& checkpoint, Report& report);
+
         //!
         //! Close the file.
         //! Do not reset counters, file names, etc. The last values before close() are still accessible.
@@ -159,19 +210,14 @@ namespace ts {
     private:
         // Descriptioon of one capture interface.
         // Pcap files have only one interface, pcap-ng files may have more.
-        class InterfaceDesc
-        {
-        public:
-            InterfaceDesc() = default;
-            uint16_t         link_type {LINKTYPE_UNKNOWN};
-            size_t           fcs_size = 0;     // Number of Frame Cyclic Sequences bytes after each packet.
-            std::intmax_t    time_units = 0;   // Time units per second.
-            cn::microseconds time_offset {0};  // Offset to add to all time stamps.
-        };
+        using InterfaceDesc = PcapIndex::Interface;
 
         bool             _error = false;          // Error was set, may be logical error, not a file error.
-        std::istream*    _in = nullptr;           // Point to actual input stream.
-        std::ifstream    _file {};                // Input file (when it is a named file).
+        bool             _eof = false;            // End of file was reached.
+        bool             _use_mmap = false;       // Map named files in memory when possible.
+        std::istream*    _in = nullptr;           // Point to actual input stream, null when the file is mapped.
+        std::ifstream    _file {};                // Input file (when it is a named file which is not mapped).
+        MemoryMappedFile _map {};                 // Input file (when it is a named file which is mapped).
         UString          _name {};                // Saved file name for messages.
         bool             _be = false;             // The file use a big-endian representation.
         bool             _ng = false;             // Pcapng format (not pcap).
@@ -185,6 +231,10 @@ namespace ts {
         cn::microseconds _first_timestamp {-1};   // Timestamp of first packet in file.
         cn::microseconds _last_timestamp {-1};    // Timestamp of last packet in file.
         std::vector<InterfaceDesc> _if {};        // Capture interfaces by index, only one in pcap files.
+        size_t           _section_count = 0;      // Number of sections (always 1 in pcap files).
+        cn::microseconds _max_timestamp {-1};     // Highest packet timestamp so far.
+        bool             _indexing = false;       // The index is being built while reading the file.
+        PcapIndex        _index {};               // Index of the file.
 
         // Report an error (if fmt is not empty), set error indicator, return false.
         bool error()
@@ -202,6 +252,9 @@ namespace ts {
         // Read exactly "size" bytes. Return false if not enough bytes before eof.
         bool readall(uint8_t* data, size_t size, Report& report);
 
+        // Stop mapping the file and continue reading it as a stream at the current position.
+        bool unmapFile(Report& report);
+
         // Read a file / section header, starting from a magic number which was read as big endian.
         bool readHeader(uint32_t magic, Report& report);
 
@@ -213,6 +266,12 @@ namespace ts {
         // Return only the block body.
         bool readNgBlockBody(uint32_t block_type, ByteBlock& body, Report& report);
 
+        // Read the next IPv4 packet, without index update.
+        bool readNextIPv4(IPv4Packet& packet, cn::microseconds& timestamp, Report& report);
+
+        // Record a checkpoint in the index being built, before reading a packet block at the given offset.
+        void addCheckpoint(uint64_t offset);
+
         // Read 32 or 16 bits using the endianness.
         uint16_t get16(const void* addr) const { return _be ? GetUInt16BE(addr) : GetUInt16LE(addr); }
         uint32_t get32(const void* addr) const { return _be ? GetUInt32BE(addr) : GetUInt32LE(addr); }
@@ -32,6 +32,13 @@ void ts::PcapFilter::defineArgs(Args& args)
     args.help(u"first-date", u"date-time",
          u"Filter packets starting at the specified date. Use format YYYY/MM/DD:hh:mm:ss.mmm.");
 
+    args.option(u"index");
+    args.help(u"index",
+         u"Use an index of the capture file to directly seek to the first filtered packet. "
+         u"The index is stored in a file with the same name as the capture file and an additional \".tsidx\" extension. "
+         u"If there is no up-to-date index for the capture file, it is built while reading the capture file "
+         u"and saved when the end of file is reached. The next command on the same capture file uses the index.");
+
     args.option(u"last-packet", 0, Args::POSITIVE);
     args.help(u"last-packet",
          u"Filter packets up to the specified number. "
@@ -46,6 +53,13 @@ void ts::PcapFilter::defineArgs(Args& args)
     args.option(u"last-date", 0, Args::STRING);
     args.help(u"last-date", u"date-time",
          u"Filter packets up to the specified date. Use format YYYY/MM/DD:hh:mm:ss.mmm.");
+
+    args.option(u"memory-map");
+    args.help(u"memory-map",
+         u"Map the capture file in memory instead of reading it as a stream. "
+         u"This may reduce the system overhead on very large files. "
+         u"The capture file shall not be truncated while it is read. "
+         u"This option is ignored on Windows and with the standard input.");
 }
 
 
@@ -86,6 +100,8 @@ bool ts::PcapFilter::loadArgs(DuckContext& duck, Args& args)
     args.getChronoValue(_opt_last_time_offset, u"last-timestamp", cn::microseconds::max());
     _opt_first_time = getDate(args, u"first-date", cn::microseconds::zero());
     _opt_last_time = getDate(args, u"last-date", cn::microseconds::max());
+    _opt_index = args.present(u"index");
+    setMemoryMapping(args.present(u"memory-map"));
     return true;
 }
 
@@ -154,6 +170,13 @@ bool ts::PcapFilter::addressFilterIsSet() const
            (!use_port || _destination.hasPort());
 }
 
+bool ts::PcapFilter::rangeFilterIsSet() const
+{
+    return _first_packet > 1 || _last_packet < std::numeric_limits<size_t>::max() ||
+           _first_time_offset > cn::microseconds::zero() || _last_time_offset < cn::microseconds::max() ||
+           _first_time > cn::microseconds::zero() || _last_time < cn::microseconds::max();
+}
+
 const ts::IPv4SocketAddress& ts::PcapFilter::otherFilter(const IPv4SocketAddress& addr) const
 {
     if (addr.match(_source)) {
@@ -189,17 +212,43 @@ bool ts::PcapFilter::open(const fs::path& filename, Report& report)
         _last_time_offset = _opt_last_time_offset;
         _first_time = _opt_first_time;
         _last_time = _opt_last_time;
+        _seek_pending = _opt_index && useIndex(report);
     }
     return ok;
 }
 
 
+//----------------------------------------------------------------------------
+// Use the index to skip the packets before the first filtered one.
+//----------------------------------------------------------------------------
+
+void ts::PcapFilter::seekFirst(Report& report)
+{
+    // Packets before a checkpoint can be skipped when they fail at least one of the "first" filters.
+    const uint64_t first_packet = _first_packet > 1 ? _first_packet : 0;
+    cn::microseconds first_time = _first_time > cn::microseconds::zero() ? _first_time : cn::microseconds::min();
+    if (_first_time_offset > cn::microseconds::zero() && index().first_timestamp >= cn::microseconds::zero()) {
+        first_time = std::max(first_time, index().first_timestamp + _first_time_offset);
+    }
+    const PcapIndex::Checkpoint* cp = index().findCheckpoint(first_packet, first_time);
+    if (cp != nullptr && cp->packet_count > 0) {
+        seek(*cp, report);
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Read an IPv4 packet, inherited method.
 //----------------------------------------------------------------------------
 
 bool ts::PcapFilter::readIPv4(IPv4Packet& packet, cn::microseconds& timestamp, Report& report)
 {
+    // On first read, directly seek to the first filtered packet when possible.
+    if (_seek_pending) {
+        _seek_pending = false;
+        seekFirst(report);
+    }
+
     // Read packets until one which matches all filters.
     for (;;) {
         // Invoke superclass to read next packet.
@@ -24,6 +24,8 @@ namespace ts {
     //!
     //! This class also sets filtering options from the command line:
     //! @c -\-first-packet, @c -\-first-timestamp, @c -\-first-date, @c -\-last-packet, @c -\-last-timestamp, @c -\-last-date.
+    //! With option @c -\-index, the index of the capture file is used to directly seek to
+    //! the first filtered packet.
     //!
     //! @ingroup net
     //!
@@ -181,6 +183,12 @@ namespace ts {
         //!
         bool addressFilterIsSet() const;
 
+        //!
+        //! Check if a range of packet numbers or timestamps is filtered.
+        //! @return True if any of the first or last packet, timestamp or date filters is set.
+        //!
+        bool rangeFilterIsSet() const;
+
         //!
         //! Get the "other" filter (source or destination) based on the other one.
         //! @param [in] addr A socket address, typically matching the source or destination filter.
@@ -201,6 +209,14 @@ namespace ts {
         //!
         void setReportAddressesFilterSeverity(int level) { _display_addresses_severity = level; }
 
+        //!
+        //! Use the index of the capture file to directly seek to the first filtered packet.
+        //! This is the same as option @c -\-index. Must be called before open().
+        //! @param [in] on If true, use the index of the capture file.
+        //! @see PcapFile::useIndex()
+        //!
+        void setUseIndex(bool on) { _opt_index = on; }
+
         //!
         //! Add command line option definitions in an Args.
         //! @param [in,out] args Command line arguments to update.
@@ -239,8 +255,13 @@ namespace ts {
         cn::microseconds  _opt_last_time_offset = cn::microseconds::max();
         cn::microseconds  _opt_first_time = cn::microseconds::zero();
         cn::microseconds  _opt_last_time = cn::microseconds::max();
+        bool              _opt_index = false;
+        bool              _seek_pending = false;
 
         // Get a date option and return it as micro-seconds since Unix epoch.
         cn::microseconds getDate(Args& args, const ts::UChar* arg_name, cn::microseconds def_value);
+
+        // Use the index to skip the packets before the first filtered one.
+        void seekFirst(Report& report);
     };
 }
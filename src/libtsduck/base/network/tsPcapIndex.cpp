@@ -0,0 +1,274 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2024, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+
+#include "tsPcapIndex.h"
+#include "tsByteBlock.h"
+#include "tsBuffer.h"
+
+// Index file format: magic number ("TSPCAPIX") and format version.
+namespace {
+    constexpr uint64_t INDEX_MAGIC = 0x5453504341504958;
+    constexpr uint32_t INDEX_VERSION = 1;
+}
+
+
+//----------------------------------------------------------------------------
+// Flow identification.
+//----------------------------------------------------------------------------
+
+ts::PcapIndex::FlowId::FlowId(const IPv4SocketAddress& src, const IPv4SocketAddress& dst, uint8_t proto) :
+    source(src),
+    destination(dst),
+    protocol(proto)
+{
+}
+
+bool ts::PcapIndex::FlowId::operator<(const FlowId& other) const
+{
+    if (source != other.source) {
+        return source < other.source;
+    }
+    else if (destination != other.destination) {
+        return destination < other.destination;
+    }
+    else {
+        return protocol < other.protocol;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Add statistics from one packet.
+//----------------------------------------------------------------------------
+
+void ts::PcapIndex::FlowStats::addPacket(const IPv4Packet& ip, cn::microseconds timestamp)
+{
+    packet_count++;
+    total_ip_size += ip.size();
+    total_data_size += ip.protocolDataSize();
+    if (timestamp >= cn::microseconds::zero()) {
+        if (first_timestamp < cn::microseconds::zero()) {
+            first_timestamp = timestamp;
+        }
+        last_timestamp = timestamp;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Clear the content of the index.
+//----------------------------------------------------------------------------
+
+void ts::PcapIndex::clear()
+{
+    complete = false;
+    capture_size = 0;
+    capture_time = 0;
+    first_timestamp = cn::microseconds(-1);
+    packet_count = 0;
+    interfaces.clear();
+    checkpoints.clear();
+    flows.clear();
+    ipv4_stats = FlowStats();
+}
+
+
+//----------------------------------------------------------------------------
+// Get the name of the index file for a capture file.
+//----------------------------------------------------------------------------
+
+fs::path ts::PcapIndex::IndexFileName(const fs::path& capture_file)
+{
+    fs::path name(capture_file);
+    name += u".tsidx";
+    return name;
+}
+
+
+//----------------------------------------------------------------------------
+// Get the size and modification time of a capture file.
+//----------------------------------------------------------------------------
+
+bool ts::PcapIndex::GetCaptureIdentity(const fs::path& capture_file, uint64_t& size, int64_t& time, Report& report)
+{
+    std::error_code err1, err2;
+    size = uint64_t(fs::file_size(capture_file, err1));
+    time = int64_t(fs::last_write_time(capture_file, err2).time_since_epoch().count());
+    if (err1 || err2) {
+        report.error(u"cannot get characteristics of %s: %s", capture_file, (err1 ? err1 : err2).message());
+        return false;
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Find the last checkpoint before a given packet or timestamp.
+//----------------------------------------------------------------------------
+
+const ts::PcapIndex::Checkpoint* ts::PcapIndex::findCheckpoint(uint64_t packet_number, cn::microseconds timestamp) const
+{
+    // Checkpoints are in increasing order of packet count and max timestamp.
+    const Checkpoint* found = nullptr;
+    for (const auto& cp : checkpoints) {
+        if (cp.packet_count >= packet_number && cp.max_timestamp >= timestamp) {
+            break;
+        }
+        found = &cp;
+    }
+    return found;
+}
+
+
+//----------------------------------------------------------------------------
+// Save the index file of a capture file.
+//----------------------------------------------------------------------------
+
+bool ts::PcapIndex::save(const fs::path& capture_file, Report& report)
+{
+    if (!complete) {
+        report.error(u"incomplete index for %s, not saved", capture_file);
+        return false;
+    }
+    if (!GetCaptureIdentity(capture_file, capture_size, capture_time, report)) {
+        return false;
+    }
+
+    const auto put_stats = [](ByteBlock& bb, const FlowStats& st) {
+        bb.appendUInt64(st.packet_count);
+        bb.appendUInt64(st.total_ip_size);
+        bb.appendUInt64(st.total_data_size);
+        bb.appendInt64(st.first_timestamp.count());
+        bb.appendInt64(st.last_timestamp.count());
+    };
+
+    ByteBlock data;
+    data.appendUInt64(INDEX_MAGIC);
+    data.appendUInt32(INDEX_VERSION);
+    data.appendUInt64(capture_size);
+    data.appendInt64(capture_time);
+    data.appendInt64(first_timestamp.count());
+    data.appendUInt64(packet_count);
+
+    data.appendUInt32(uint32_t(interfaces.size()));
+    for (const auto& itf : interfaces) {
+        data.appendUInt16(itf.link_type);
+        data.appendUInt32(uint32_t(itf.fcs_size));
+        data.appendInt64(int64_t(itf.time_units));
+        data.appendInt64(itf.time_offset.count());
+    }
+
+    data.appendUInt32(uint32_t(checkpoints.size()));
+    for (const auto& cp : checkpoints) {
+        data.appendUInt64(cp.offset);
+        data.appendUInt64(cp.packet_count);
+        data.appendInt64(cp.max_timestamp.count());
+    }
+
+    data.appendUInt32(uint32_t(flows.size()));
+    for (const auto& it : flows) {
+        data.appendUInt32(it.first.source.address());
+        data.appendUInt16(it.first.source.port());
+        data.appendUInt32(it.first.destination.address());
+        data.appendUInt16(it.first.destination.port());
+        data.appendUInt8(it.first.protocol);
+        put_stats(data, it.second);
+    }
+    put_stats(data, ipv4_stats);
+
+    const fs::path name(IndexFileName(capture_file));
+    report.debug(u"saving index file %s, %d checkpoints, %d flows", name, checkpoints.size(), flows.size());
+    return data.saveToFile(name, &report);
+}
+
+
+//----------------------------------------------------------------------------
+// Load the index file of a capture file.
+//----------------------------------------------------------------------------
+
+bool ts::PcapIndex::load(const fs::path& capture_file, Report& report)
+{
+    clear();
+
+    // Load the index file, if there is one.
+    const fs::path name(IndexFileName(capture_file));
+    ByteBlock data;
+    if (!fs::exists(name) || !data.loadFromFile(name, std::numeric_limits<size_t>::max(), &report)) {
+        report.debug(u"no index file for %s", capture_file);
+        return false;
+    }
+
+    // Check that the index describes the current state of the capture file.
+    uint64_t size = 0;
+    int64_t time = 0;
+    if (!GetCaptureIdentity(capture_file, size, time, report)) {
+        return false;
+    }
+    const uint8_t* const base = data.data();
+    Buffer buf(base, data.size());
+    if (buf.getUInt64() != INDEX_MAGIC || buf.getUInt32() != INDEX_VERSION) {
+        report.debug(u"invalid index file %s", name);
+        return false;
+    }
+    capture_size = buf.getUInt64();
+    capture_time = buf.getInt64();
+    if (capture_size != size || capture_time != time) {
+        report.debug(u"index file %s is outdated", name);
+        clear();
+        return false;
+    }
+
+    const auto get_stats = [](Buffer& bb, FlowStats& st) {
+        st.packet_count = bb.getUInt64();
+        st.total_ip_size = bb.getUInt64();
+        st.total_data_size = bb.getUInt64();
+        st.first_timestamp = cn::microseconds(bb.getInt64());
+        st.last_timestamp = cn::microseconds(bb.getInt64());
+    };
+
+    first_timestamp = cn::microseconds(buf.getInt64());
+    packet_count = buf.getUInt64();
+
+    for (size_t count = buf.getUInt32(); count > 0 && !buf.readError(); --count) {
+        Interface itf;
+        itf.link_type = buf.getUInt16();
+        itf.fcs_size = buf.getUInt32();
+        itf.time_units = std::intmax_t(buf.getInt64());
+        itf.time_offset = cn::microseconds(buf.getInt64());
+        interfaces.push_back(itf);
+    }
+
+    for (size_t count = buf.getUInt32(); count > 0 && !buf.readError(); --count) {
+        Checkpoint cp;
+        cp.offset = buf.getUInt64();
+        cp.packet_count = buf.getUInt64();
+        cp.max_timestamp = cn::microseconds(buf.getInt64());
+        checkpoints.push_back(cp);
+    }
+
+    for (size_t count = buf.getUInt32(); count > 0 && !buf.readError(); --count) {
+        FlowId id;
+        id.source.setAddress(buf.getUInt32());
+        id.source.setPort(buf.getUInt16());
+        id.destination.setAddress(buf.getUInt32());
+        id.destination.setPort(buf.getUInt16());
+        id.protocol = buf.getUInt8();
+        get_stats(buf, flows[id]);
+    }
+    get_stats(buf, ipv4_stats);
+
+    if (buf.readError() || !buf.endOfRead()) {
+        report.debug(u"invalid index file %s", name);
+        clear();
+        return false;
+    }
+
+    report.debug(u"loaded index file %s, %d checkpoints, %d flows", name, checkpoints.size(), flows.size());
+    complete = true;
+    return true;
+}
@@ -0,0 +1,179 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2024, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Index of a pcap or pcapng file.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsReport.h"
+#include "tsIPv4Packet.h"
+#include "tsIPv4SocketAddress.h"
+#include "tsPcap.h"
+
+namespace ts {
+    //!
+    //! Index of a pcap or pcapng capture file.
+    //! @ingroup net
+    //!
+    //! The index is built by ts::PcapFile while reading a capture file from the beginning
+    //! to the end. It is saved in a small binary file next to the capture file. When the
+    //! capture file is read again later, the index is used to directly seek to a packet
+    //! or a timestamp and to get statistics on the data flows without reading the file.
+    //!
+    //! The index contains "checkpoints" at regular intervals of packets. A checkpoint is
+    //! a position in the file where the reader can restart, with the number of packets
+    //! and the highest timestamp before that position.
+    //!
+    //! The index file is valid only for the capture file from which it was built. The size
+    //! and the modification time of the capture file are stored in the index and checked
+    //! when the index is loaded.
+    //!
+    class TSDUCKDLL PcapIndex
+    {
+    public:
+        //!
+        //! Default constructor.
+        //!
+        PcapIndex() = default;
+
+        //!
+        //! Default number of captured packets between two checkpoints.
+        //!
+        static constexpr uint64_t DEFAULT_CHECKPOINT_INTERVAL = 4096;
+
+        //!
+        //! Description of one capture interface.
+        //! Pcap files have only one interface, pcap-ng files may have more.
+        //!
+        class TSDUCKDLL Interface
+        {
+        public:
+            Interface() = default;                      //!< Default constructor.
+            uint16_t         link_type {LINKTYPE_UNKNOWN};  //!< Link type, one of LINKTYPE_* values.
+            size_t           fcs_size = 0;              //!< Number of Frame Cyclic Sequences bytes after each packet.
+            std::intmax_t    time_units = 0;            //!< Time units per second.
+            cn::microseconds time_offset {0};           //!< Offset to add to all time stamps.
+        };
+
+        //!
+        //! A checkpoint is a position in the file where reading can restart.
+        //!
+        class TSDUCKDLL Checkpoint
+        {
+        public:
+            Checkpoint() = default;                     //!< Default constructor.
+            uint64_t         offset = 0;                //!< Byte offset in the file, at the beginning of a packet block.
+            uint64_t         packet_count = 0;          //!< Number of captured packets before that position.
+            cn::microseconds max_timestamp {-1};        //!< Highest packet timestamp before that position, -1 if none.
+        };
+
+        //!
+        //! Identification of a data flow: all packets from one source to one destination using one protocol.
+        //!
+        class TSDUCKDLL FlowId
+        {
+        public:
+            IPv4SocketAddress source {};                //!< Source socket address.
+            IPv4SocketAddress destination {};           //!< Destination socket address.
+            uint8_t           protocol = 0xFF;          //!< IP protocol.
+
+            //!
+            //! Constructor.
+            //! @param [in] src Source socket address.
+            //! @param [in] dst Destination socket address.
+            //! @param [in] proto IP protocol.
+            //!
+            FlowId(const IPv4SocketAddress& src = IPv4SocketAddress(), const IPv4SocketAddress& dst = IPv4SocketAddress(), uint8_t proto = 0xFF);
+
+            //!
+            //! Comparison operator, for use in containers.
+            //! @param [in] other Another instance to compare.
+            //! @return True if this instance is logically less than @a other.
+            //!
+            bool operator<(const FlowId& other) const;
+        };
+
+        //!
+        //! Statistics on a set of IPv4 packets.
+        //!
+        class TSDUCKDLL FlowStats
+        {
+        public:
+            FlowStats() = default;                      //!< Default constructor.
+            uint64_t         packet_count = 0;          //!< Number of IPv4 packets.
+            uint64_t         total_ip_size = 0;         //!< Total size in bytes of IPv4 packets, headers included.
+            uint64_t         total_data_size = 0;       //!< Total data size in bytes (TCP or UDP payload).
+            cn::microseconds first_timestamp {-1};      //!< Timestamp of the first packet, -1 if none found.
+            cn::microseconds last_timestamp {-1};       //!< Timestamp of the last packet, -1 if none found.
+
+            //!
+            //! Add statistics from one packet.
+            //! @param [in] ip The IPv4 packet.
+            //! @param [in] timestamp Capture timestamp of the packet in microseconds, -1 if none.
+            //!
+            void addPacket(const IPv4Packet& ip, cn::microseconds timestamp);
+        };
+
+        bool                         complete = false;           //!< The index describes the complete capture file.
+        uint64_t                     capture_size = 0;           //!< Size in bytes of the indexed capture file.
+        int64_t                      capture_time = 0;           //!< Modification time of the indexed capture file (system-specific unit).
+        cn::microseconds             first_timestamp {-1};       //!< Timestamp of the first packet in the file.
+        uint64_t                     packet_count = 0;           //!< Total number of captured packets.
+        std::vector<Interface>       interfaces {};              //!< Capture interfaces at the first packet.
+        std::vector<Checkpoint>      checkpoints {};             //!< Checkpoints, in increasing order of offset.
+        std::map<FlowId, FlowStats>  flows {};                   //!< Statistics per data flow.
+        FlowStats                    ipv4_stats {};              //!< Statistics on all IPv4 packets.
+
+        //!
+        //! Clear the content of the index.
+        //!
+        void clear();
+
+        //!
+        //! Get the name of the index file for a capture file.
+        //! @param [in] capture_file Name of the capture file.
+        //! @return Name of the corresponding index file.
+        //!
+        static fs::path IndexFileName(const fs::path& capture_file);
+
+        //!
+        //! Load the index file of a capture file.
+        //! @param [in] capture_file Name of the capture file.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false when there is no valid index for this capture file.
+        //! A missing or outdated index is not considered as an error and is reported in debug mode only.
+        //!
+        bool load(const fs::path& capture_file, Report& report);
+
+        //!
+        //! Save the index file of a capture file.
+        //! The index must be complete.
+        //! @param [in] capture_file Name of the capture file.
+        //! @param [in,out] report Where to report errors.
+        //! @return True on success, false on error.
+        //!
+        bool save(const fs::path& capture_file, Report& report);
+
+        //!
+        //! Find the last checkpoint before a given packet or timestamp.
+        //! All packets before the returned checkpoint have either a lower number than
+        //! @a packet_number or a lower timestamp than @a timestamp.
+        //! @param [in] packet_number Number of the target packet, starting at 1, as in Wireshark.
+        //! Use zero to ignore packet numbers.
+        //! @param [in] timestamp Target timestamp. Use cn::microseconds::min() to ignore timestamps.
+        //! @return Address of the checkpoint or null pointer if there is none.
+        //!
+        const Checkpoint* findCheckpoint(uint64_t packet_number, cn::microseconds timestamp) const;
+
+    private:
+        // Get the size and modification time of a capture file.
+        static bool GetCaptureIdentity(const fs::path& capture_file, uint64_t& size, int64_t& time, Report& report);
+    };
+}
@@ -427,6 +427,75 @@ bool ts::UDPSocket::send(const void* data, size_t size, const IPv4SocketAddress&
 }
 
 
+//----------------------------------------------------------------------------
+// Send several messages to a destination address and port.
+//----------------------------------------------------------------------------
+
+bool ts::UDPSocket::send(const void* const data[], const size_t sizes[], size_t count, Report& report)
+{
+    return send(data, sizes, count, _default_destination, report);
+}
+
+bool ts::UDPSocket::send(const void* const data[], const size_t sizes[], size_t count, const IPv4SocketAddress& dest, Report& report)
+{
+#if defined(TS_LINUX)
+
+    ::sockaddr addr;
+    dest.copy(addr);
+
+    while (count > 0) {
+
+        // Build a vector of message headers for sendmmsg().
+        const size_t batch = std::min(count, MAX_BATCH_MESSAGES);
+        ::iovec vec[MAX_BATCH_MESSAGES];
+        ::mmsghdr hdr[MAX_BATCH_MESSAGES];
+        TS_ZERO(hdr);
+        for (size_t i = 0; i < batch; ++i) {
+            vec[i].iov_base = const_cast<void*>(data[i]);
+            vec[i].iov_len = sizes[i];
+            hdr[i].msg_hdr.msg_name = &addr;
+            hdr[i].msg_hdr.msg_namelen = sizeof(addr);
+            hdr[i].msg_hdr.msg_iov = &vec[i];
+            hdr[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        // Send the messages. The number of actually sent messages can be less than requested.
+        int sent = ::sendmmsg(getSocket(), hdr, (unsigned int)(batch), 0);
+        if (sent < 0) {
+            if (LastSysErrorCode() == EINTR) {
+                continue;
+            }
+            report.error(u"error sending UDP message: %s", SysErrorCodeMessage());
+            return false;
+        }
+        else if (sent == 0) {
+            // No progress, should not happen. Send one message the usual way to get
+            // either some progress or an error, instead of looping forever.
+            if (!send(data[0], sizes[0], dest, report)) {
+                return false;
+            }
+            sent = 1;
+        }
+        data += sent;
+        sizes += sent;
+        count -= size_t(sent);
+    }
+    return true;
+
+#else
+
+    // No multi-message system call, send messages one by one.
+    for (size_t i = 0; i < count; ++i) {
+        if (!send(data[i], sizes[i], dest, report)) {
+            return false;
+        }
+    }
+    return true;
+
+#endif
+}
+
+
 //----------------------------------------------------------------------------
 // Receive a message.
 //----------------------------------------------------------------------------
@@ -483,6 +552,175 @@ bool ts::UDPSocket::receive(void* data,
 }
 
 
+//----------------------------------------------------------------------------
+// Receive one or more messages.
+//----------------------------------------------------------------------------
+
+bool ts::UDPSocket::receive(ReceivedMessage messages[], size_t max_count, size_t& ret_count, const AbortInterface* abort, Report& report)
+{
+    ret_count = 0;
+    if (max_count == 0) {
+        return true;
+    }
+
+#if defined(TS_LINUX)
+
+    // Loop on unsollicited interrupts
+    for (;;) {
+
+        // Wait for at least one message.
+        const int err = receiveMany(messages, max_count, ret_count, report);
+
+        if (abort != nullptr && abort->aborting()) {
+            // Aborting, no error message.
+            return false;
+        }
+        else if (err == 0) {
+            // Sometimes, we get "successful" empty message coming from nowhere. Ignore them.
+            size_t count = 0;
+            for (size_t i = 0; i < ret_count; ++i) {
+                if (messages[i].size > 0 || messages[i].sender.hasAddress()) {
+                    if (count < i) {
+                        std::swap(messages[count], messages[i]);
+                    }
+                    count++;
+                }
+            }
+            ret_count = count;
+            if (ret_count > 0) {
+                return true;
+            }
+        }
+        else if (err == EINTR) {
+            // Got a signal, not a user interrupt, will ignore it
+            report.debug(u"signal, not user interrupt");
+        }
+        else {
+            // Abort on non-interrupt errors.
+            if (isOpen()) {
+                // Report the error only if the error does not result from a close in another thread.
+                report.error(u"error receiving from UDP socket: %s", SysErrorCodeMessage(err));
+            }
+            return false;
+        }
+    }
+
+#else
+
+    // No multi-message system call, receive one message only.
+    // Explicitly call the UDPSocket version to avoid filtering twice in subclasses.
+    ReceivedMessage& msg(messages[0]);
+    if (UDPSocket::receive(msg.data, msg.max_size, msg.size, msg.sender, msg.destination, abort, report, &msg.timestamp)) {
+        ret_count = 1;
+        return true;
+    }
+    return false;
+
+#endif
+}
+
+
+//----------------------------------------------------------------------------
+// Perform one multi-message receive operation (Linux only).
+//----------------------------------------------------------------------------
+
+#if defined(TS_LINUX)
+int ts::UDPSocket::receiveMany(ReceivedMessage messages[], size_t max_count, size_t& ret_count, Report& report)
+{
+    // Size of ancillary data for each message. Large enough for IP_PKTINFO and SO_TIMESTAMPNS.
+    constexpr size_t ANCIL_SIZE = 256;
+
+    // Build message headers for recvmmsg().
+    const size_t batch = std::min(max_count, MAX_BATCH_MESSAGES);
+    ::sockaddr sender_sock[MAX_BATCH_MESSAGES];
+    ::iovec vec[MAX_BATCH_MESSAGES];
+    ::mmsghdr hdr[MAX_BATCH_MESSAGES];
+    // The control buffers must be aligned for the CMSG_xxx macros.
+    alignas(::cmsghdr) uint8_t ancil_data[MAX_BATCH_MESSAGES][ANCIL_SIZE];
+    TS_ZERO(sender_sock);
+    TS_ZERO(hdr);
+    for (size_t i = 0; i < batch; ++i) {
+        vec[i].iov_base = messages[i].data;
+        vec[i].iov_len = messages[i].max_size;
+        hdr[i].msg_hdr.msg_name = &sender_sock[i];
+        hdr[i].msg_hdr.msg_namelen = sizeof(sender_sock[i]);
+        hdr[i].msg_hdr.msg_iov = &vec[i];
+        hdr[i].msg_hdr.msg_iovlen = 1;
+        hdr[i].msg_hdr.msg_control = ancil_data[i];
+        hdr[i].msg_hdr.msg_controllen = ANCIL_SIZE;
+    }
+
+    // Wait for at least one message, then get all available ones without waiting.
+    const int count = ::recvmmsg(getSocket(), hdr, (unsigned int)(batch), MSG_WAITFORONE, nullptr);
+    if (count < 0) {
+        ret_count = 0;
+        return LastSysErrorCode();
+    }
+
+    // Analyze the received messages.
+    ret_count = size_t(count);
+    for (size_t i = 0; i < ret_count; ++i) {
+        ReceivedMessage& msg(messages[i]);
+        msg.size = size_t(hdr[i].msg_len);
+        msg.sender = IPv4SocketAddress(sender_sock[i]);
+        msg.destination.clear();
+        msg.timestamp = cn::microseconds(-1);
+        getAncillaryData(hdr[i].msg_hdr, msg.destination, &msg.timestamp);
+    }
+    return 0; // success
+}
+#endif
+
+
+//----------------------------------------------------------------------------
+// Analyze the ancillary data of a received message (UNIX only).
+//----------------------------------------------------------------------------
+
+#if defined(TS_UNIX)
+void ts::UDPSocket::getAncillaryData(::msghdr& hdr, IPv4SocketAddress& destination, cn::microseconds* timestamp)
+{
+    TS_PUSH_WARNING()
+    TS_GCC_NOWARNING(zero-as-null-pointer-constant) // invalid definition of CMSG_NXTHDR in musl libc (Alpine Linux)
+#if defined(TS_OPENBSD)
+    TS_LLVM_NOWARNING(cast-align) // invalid definition of CMSG_NXTHDR on OpenBSD
+#endif
+
+    // Browse returned ancillary data.
+    for (::cmsghdr* cmsg = CMSG_FIRSTHDR(&hdr); cmsg != nullptr; cmsg = CMSG_NXTHDR(&hdr, cmsg)) {
+
+        // Look for destination IP address.
+        // IP_PKTINFO is used on all Unix, except FreeBSD.
+#if defined(IP_PKTINFO)
+        if (cmsg->cmsg_level == IPPROTO_IP && cmsg->cmsg_type == IP_PKTINFO && cmsg->cmsg_len >= sizeof(::in_pktinfo)) {
+            const ::in_pktinfo* info = reinterpret_cast<const ::in_pktinfo*>(CMSG_DATA(cmsg));
+            destination = IPv4SocketAddress(info->ipi_addr, _local_address.port());
+        }
+#elif defined(IP_RECVDSTADDR)
+        if (cmsg->cmsg_level == IPPROTO_IP && cmsg->cmsg_type == IP_RECVDSTADDR && cmsg->cmsg_len >= sizeof(::in_addr)) {
+            const ::in_addr* info = reinterpret_cast<const ::in_addr*>(CMSG_DATA(cmsg));
+            destination = IPv4SocketAddress(*info, _local_address.port());
+        }
+#endif
+
+        // On Linux, look for receive timestamp.
+#if defined(TS_LINUX)
+        if (timestamp != nullptr && cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SO_TIMESTAMPNS && cmsg->cmsg_len >= sizeof(::timespec)) {
+            // System time stamp in nanosecond.
+            const ::timespec* ts = reinterpret_cast<const ::timespec*>(CMSG_DATA(cmsg));
+            const cn::nanoseconds::rep nano = cn::nanoseconds::rep(ts->tv_sec) * 1'000'000'000 + cn::nanoseconds::rep(ts->tv_nsec);
+            // System time stamp is valid when not zero, convert it to micro-seconds.
+            if (nano != 0) {
+                *timestamp = cn::duration_cast<cn::microseconds>(cn::nanoseconds(nano));
+            }
+        }
+#endif
+    }
+
+    TS_POP_WARNING()
+}
+#endif
+
+
 //----------------------------------------------------------------------------
 // Perform one receive operation. Hide the system mud.
 //----------------------------------------------------------------------------
@@ -598,44 +836,8 @@ int ts::UDPSocket::receiveOne(void* data,
         return LastSysErrorCode();
     }
 
-    TS_PUSH_WARNING()
-    TS_GCC_NOWARNING(zero-as-null-pointer-constant) // invalid definition of CMSG_NXTHDR in musl libc (Alpine Linux)
-#if defined(TS_OPENBSD)
-    TS_LLVM_NOWARNING(cast-align) // invalid definition of CMSG_NXTHDR on OpenBSD
-#endif
-
     // Browse returned ancillary data.
-    for (::cmsghdr* cmsg = CMSG_FIRSTHDR(&hdr); cmsg != nullptr; cmsg = CMSG_NXTHDR(&hdr, cmsg)) {
-
-        // Look for destination IP address.
-        // IP_PKTINFO is used on all Unix, except FreeBSD.
-#if defined(IP_PKTINFO)
-        if (cmsg->cmsg_level == IPPROTO_IP && cmsg->cmsg_type == IP_PKTINFO && cmsg->cmsg_len >= sizeof(::in_pktinfo)) {
-            const ::in_pktinfo* info = reinterpret_cast<const ::in_pktinfo*>(CMSG_DATA(cmsg));
-            destination = IPv4SocketAddress(info->ipi_addr, _local_address.port());
-        }
-#elif defined(IP_RECVDSTADDR)
-        if (cmsg->cmsg_level == IPPROTO_IP && cmsg->cmsg_type == IP_RECVDSTADDR && cmsg->cmsg_len >= sizeof(::in_addr)) {
-            const ::in_addr* info = reinterpret_cast<const ::in_addr*>(CMSG_DATA(cmsg));
-            destination = IPv4SocketAddress(*info, _local_address.port());
-        }
-#endif
-
-        // On Linux, look for receive timestamp.
-#if defined(TS_LINUX)
-        if (timestamp != nullptr && cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SO_TIMESTAMPNS && cmsg->cmsg_len >= sizeof(::timespec)) {
-            // System time stamp in nanosecond.
-            const ::timespec* ts = reinterpret_cast<const ::timespec*>(CMSG_DATA(cmsg));
-            const cn::nanoseconds::rep nano = cn::nanoseconds::rep(ts->tv_sec) * 1'000'000'000 + cn::nanoseconds::rep(ts->tv_nsec);
-            // System time stamp is valid when not zero, convert it to micro-seconds.
-            if (nano != 0) {
-                *timestamp = cn::duration_cast<cn::microseconds>(cn::nanoseconds(nano));
-            }
-        }
-#endif
-    }
-
-    TS_POP_WARNING()
+    getAncillaryData(hdr, destination, timestamp);
 
 #endif // Windows vs. UNIX
 
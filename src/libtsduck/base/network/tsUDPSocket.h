@@ -328,6 +328,78 @@ namespace ts {
                              Report& report = CERR,
                              cn::microseconds* timestamp = nullptr);
 
+        //!
+        //! Maximum number of messages which are sent or received in one system call.
+        //! On Linux, this is the maximum number of messages in one call to sendmmsg() or recvmmsg().
+        //! Sending or receiving more messages is still possible, using several system calls.
+        //!
+        static constexpr size_t MAX_BATCH_MESSAGES = 64;
+
+        //!
+        //! Description of a message to receive in a multi-message receive operation.
+        //!
+        struct TSDUCKDLL ReceivedMessage
+        {
+            void*             data = nullptr;                     //!< [in] Address of the buffer for the received message.
+            size_t            max_size = 0;                       //!< [in] Size in bytes of the reception buffer.
+            size_t            size = 0;                           //!< [out] Size in bytes of the received message.
+            IPv4SocketAddress sender {};                          //!< [out] Socket address of the sender.
+            IPv4SocketAddress destination {};                     //!< [out] Socket address of the packet destination.
+            cn::microseconds  timestamp = cn::microseconds(-1);   //!< [out] Receive timestamp in micro-seconds, negative if not available.
+        };
+
+        //!
+        //! Send several messages to a destination address and port.
+        //!
+        //! On Linux, the messages are sent using as few system calls as possible.
+        //! On other systems, the messages are sent one by one.
+        //!
+        //! @param [in] data Array of @a count addresses of the messages to send.
+        //! @param [in] sizes Array of @a count sizes in bytes of the messages to send.
+        //! @param [in] count Number of messages to send.
+        //! @param [in] destination Socket address of the destination.
+        //! Both address and port are mandatory in the socket address, they cannot
+        //! be set to IPv4Address::AnyAddress or IPv4SocketAddress::AnyPort.
+        //! @param [in,out] report Where to report error.
+        //! @return True on success, false on error.
+        //!
+        virtual bool send(const void* const data[], const size_t sizes[], size_t count, const IPv4SocketAddress& destination, Report& report = CERR);
+
+        //!
+        //! Send several messages to the default destination address and port.
+        //!
+        //! @param [in] data Array of @a count addresses of the messages to send.
+        //! @param [in] sizes Array of @a count sizes in bytes of the messages to send.
+        //! @param [in] count Number of messages to send.
+        //! @param [in,out] report Where to report error.
+        //! @return True on success, false on error.
+        //!
+        virtual bool send(const void* const data[], const size_t sizes[], size_t count, Report& report = CERR);
+
+        //!
+        //! Receive one or more messages.
+        //!
+        //! This method waits for at least one message. Then, all messages which are already
+        //! available are returned, up to @a max_count. On Linux, all messages are received
+        //! using one single system call. On other systems, one message only is returned.
+        //!
+        //! @param [in,out] messages Array of @a max_count message descriptions. The fields @a data
+        //! and @a max_size shall be set by the caller. The other fields are updated in the first
+        //! @a ret_count entries. Entries are possibly reordered when some messages are dropped.
+        //! @param [in] max_count Maximum number of messages to receive.
+        //! @param [out] ret_count Number of received messages.
+        //! @param [in] abort If non-zero, invoked when I/O is interrupted
+        //! (in case of user-interrupt, return, otherwise retry).
+        //! @param [in,out] report Where to report error.
+        //! @return True on success, false on error.
+        //! @see setReceiveTimestamps()
+        //!
+        virtual bool receive(ReceivedMessage messages[],
+                             size_t max_count,
+                             size_t& ret_count,
+                             const AbortInterface* abort = nullptr,
+                             Report& report = CERR);
+
         // Implementation of Socket interface.
         virtual bool open(Report& report = CERR) override;
         virtual bool close(Report& report = CERR) override;
@@ -393,6 +465,16 @@ namespace ts {
         // Perform one receive operation. Hide the system mud. Return a system socket error code.
         int receiveOne(void* data, size_t max_size, size_t& ret_size, IPv4SocketAddress& sender, IPv4SocketAddress& destination, Report& report, cn::microseconds* timestamp);
 
+#if defined(TS_LINUX)
+        // Perform one multi-message receive operation. Return a system socket error code.
+        int receiveMany(ReceivedMessage messages[], size_t max_count, size_t& ret_count, Report& report);
+#endif
+
+#if defined(TS_UNIX)
+        // Analyze the ancillary data of a received message.
+        void getAncillaryData(::msghdr& hdr, IPv4SocketAddress& destination, cn::microseconds* timestamp);
+#endif
+
         // Furiously idiotic Windows feature, see comment in receiveOne()
 #if defined(TS_WINDOWS)
         static volatile ::LPFN_WSARECVMSG _wsaRevcMsg;
@@ -34,6 +34,9 @@ namespace ts {
     //! is used (system configuration on Windows, http_proxy environment on
     //! Unix systems).
     //!
+    //! Successive transfers using the same instance reuse the network connections
+    //! to the same server when possible (HTTP keep-alive).
+    //!
     class TSDUCKDLL WebRequest
     {
         TS_NOBUILD_NOCOPY(WebRequest);
@@ -19,7 +19,8 @@ ts::AsyncReport::AsyncReport(int max_severity, const AsyncReportArgs& args) :
     Thread(ThreadAttributes().setPriority(ThreadAttributes::GetMinimumPriority())),
     _log_queue(args.log_msg_count),
     _time_stamp(args.timed_log),
-    _synchronous(args.sync_log)
+    _synchronous(args.sync_log),
+    _drop_oldest(args.drop_oldest)
 {
     // Start the logging thread
     start();
@@ -43,9 +44,9 @@ ts::AsyncReport::~AsyncReport()
 void ts::AsyncReport::terminate()
 {
     if (!_terminated) {
-        // Insert an "end of report" message in the queue.
-        // This message will tell the logging thread to terminate.
-        _log_queue.forceEnqueue(new LogMessage {true, 0, UString()});
+        // Tell the logging thread to terminate after processing all queued messages.
+        _terminate = true;
+        wakeUp();
 
         // Wait for termination of the logging thread
         waitForTermination();
@@ -54,6 +55,23 @@ void ts::AsyncReport::terminate()
 }
 
 
+//----------------------------------------------------------------------------
+// Wake up the logging thread if it is waiting for messages.
+//----------------------------------------------------------------------------
+
+void ts::AsyncReport::wakeUp()
+{
+    // The new message was pushed before the fence. Either the logging thread
+    // sees it or we see that the logging thread is waiting (or both).
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (_logger_waiting.load(std::memory_order_relaxed)) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _logger_waiting = false;
+        _wake_logger.notify_one();
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Message logging method.
 //----------------------------------------------------------------------------
@@ -69,17 +87,40 @@ void ts::AsyncReport::writeLog(int severity, const UString &msg)
     ::OutputDebugStringW(msgNewLine.wc_str());
 #endif
 
-    if (!_terminated) {
-        LogMessage* p = new LogMessage {false, severity, msg};
+    if (_terminated || _terminate) {
+        return;
+    }
+
+    LogMessage lmsg {severity, msg};
+    if (!_log_queue.push(lmsg)) {
+        // The queue is full.
         if (_synchronous) {
-            // Synchronous mode, wait infinitely until the message is queued.
-            _log_queue.enqueue(p);
+            // Synchronous mode, wait until the message is queued.
+            _blocked_senders++;
+            while (!_log_queue.push(lmsg)) {
+                wakeUp();
+                std::unique_lock<std::mutex> lock(_mutex);
+                // Use a timeout to avoid a complex synchronization with the logging thread.
+                _space_available.wait_for(lock, cn::milliseconds(10));
+            }
+            _blocked_senders--;
+        }
+        else if (_drop_oldest) {
+            // Make room for the new message.
+            LogMessage old;
+            do {
+                if (_log_queue.pop(old)) {
+                    _dropped++;
+                }
+            } while (!_log_queue.push(lmsg));
         }
         else {
-            // Enqueue the message immediately (timeout = 0), drop message on overflow.
-            _log_queue.enqueue(p, cn::milliseconds::zero());
+            // Drop the new message.
+            _dropped++;
+            return;
         }
     }
+    wakeUp();
 }
 
 
@@ -89,31 +130,61 @@ void ts::AsyncReport::writeLog(int severity, const UString &msg)
 
 void ts::AsyncReport::main()
 {
-    LogMessagePtr msg;
+    LogMessage msg;
 
     // Notify subclasses (if any) of thread start.
     asyncThreadStarted();
 
     for (;;) {
-        // Dequeue next message (infinite wait).
-        _log_queue.dequeue(msg);
+        // Process all queued messages, within the limit of the queue size to regularly flush the output.
+        size_t count = 0;
+        while (count < _log_queue.capacity() && _log_queue.pop(msg)) {
+            count++;
+
+            // Notify subclass of message (or log it on standard error).
+            asyncThreadLog(msg.severity, msg.message);
+
+            // Abort application on fatal error
+            if (msg.severity == Severity::Fatal) {
+                flushBatch();
+                std::exit(EXIT_FAILURE);
+            }
+        }
 
-        // Exit when received a termination message.
-        if (msg->terminate) {
+        // Report dropped messages, if any.
+        const uint64_t dropped = _dropped;
+        if (dropped > _dropped_reported && maxSeverity() >= Severity::Warning) {
+            asyncThreadLog(Severity::Warning, UString::Format(u"%'d log messages dropped", dropped - _dropped_reported));
+        }
+        _dropped_reported = dropped;
+        flushBatch();
+
+        if (count > 0) {
+            // Let the blocked senders retry, check for new messages.
+            if (_blocked_senders > 0) {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _space_available.notify_all();
+            }
+        }
+        else if (_terminate) {
+            // No more message and termination requested.
             break;
         }
-
-        // Notify subclass of message (or log it on standard error).
-        asyncThreadLog(msg->severity, msg->message);
-
-        // Abort application on fatal error
-        if (msg->severity == Severity::Fatal) {
-            std::exit(EXIT_FAILURE);
+        else {
+            // Wait for new messages. See the symmetrical logic in wakeUp().
+            std::unique_lock<std::mutex> lock(_mutex);
+            _logger_waiting = true;
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (_log_queue.empty() && !_terminate) {
+                _wake_logger.wait(lock, [this]() { return !_logger_waiting; });
+            }
+            _logger_waiting = false;
         }
     }
 
     if (maxSeverity() >= Severity::Debug) {
         asyncThreadLog(Severity::Debug, u"Report logging thread terminated");
+        flushBatch();
     }
 
     // Notify subclasses (if any) of thread completion.
@@ -132,15 +203,36 @@ void ts::AsyncReport::asyncThreadStarted()
 
 void ts::AsyncReport::asyncThreadLog(int severity, const UString& message)
 {
-    // The default implementation logs on stderr.
-    std::cerr << "* ";
+    // The default implementation logs on stderr. Messages are accumulated in a
+    // batch which is written by the logging thread after each set of messages.
+    _batch.append("* ");
     if (_time_stamp) {
-        std::cerr << ts::Time::CurrentLocalTime().format(ts::Time::DATETIME) << " - ";
+        Time::CurrentLocalTime().format(Time::DATETIME).toUTF8(_line);
+        _batch.append(_line);
+        _batch.append(" - ");
     }
-    std::cerr << Severity::Header(severity) << message << std::endl;
+    Severity::Header(severity).toUTF8(_line);
+    _batch.append(_line);
+    message.toUTF8(_line);
+    _batch.append(_line);
+    _batch.append("\n");
 }
 
 void ts::AsyncReport::asyncThreadCompleted()
 {
     // The default implementation does nothing.
 }
+
+
+//----------------------------------------------------------------------------
+// Write the batch of messages from the default asyncThreadLog().
+//----------------------------------------------------------------------------
+
+void ts::AsyncReport::flushBatch()
+{
+    if (!_batch.empty()) {
+        std::cerr.write(_batch.data(), std::streamsize(_batch.size()));
+        std::cerr.flush();
+        _batch.clear();
+    }
+}
@@ -14,7 +14,7 @@
 #pragma once
 #include "tsReport.h"
 #include "tsAsyncReportArgs.h"
-#include "tsMessageQueue.h"
+#include "tsLockFreeQueue.h"
 #include "tsThread.h"
 
 namespace ts {
@@ -27,11 +27,16 @@ namespace ts {
     //! to the caller without waiting. The messages are logged later in one single
     //! low-priority thread.
     //!
-    //! In case of a huge amount of errors, there is no avalanche effect. If a caller
-    //! cannot immediately enqueue a message or if the internal queue of messages is
-    //! full, the message is dropped. In other words, reporting messages is guaranteed
-    //! to never block, slow down or crash the application. Messages are dropped when
-    //! necessary to avoid that kind of problem.
+    //! In case of a huge amount of errors, there is no avalanche effect. If the internal
+    //! queue of messages is full, the message is dropped. In other words, reporting messages
+    //! is guaranteed to never block, slow down or crash the application. Messages are dropped
+    //! when necessary to avoid that kind of problem. By default, the new messages are dropped.
+    //! Alternatively, the oldest messages in the queue can be dropped instead. In synchronous
+    //! mode, the caller waits for free space in the queue and no message is dropped.
+    //!
+    //! The internal queue is lock-free: the application threads which log messages never
+    //! wait for each other or for the logging thread (except in synchronous mode with a
+    //! full queue). The logging thread processes all queued messages at once.
     //!
     //! Messages are displayed on the standard error device by default.
     //!
@@ -78,6 +83,25 @@ namespace ts {
         //!
         bool getSynchronous() const { return _synchronous; }
 
+        //!
+        //! Activate or deactivate the dropping of the oldest messages when the queue is full.
+        //! @param [in] on If true, when the queue is full, the oldest messages in the queue are dropped.
+        //! If false, the new messages are dropped. Not used in synchronous mode.
+        //!
+        void setDropOldest(bool on) { _drop_oldest = on; }
+
+        //!
+        //! Check if the oldest messages are dropped when the queue is full.
+        //! @return True if the oldest messages are dropped when the queue is full.
+        //!
+        bool getDropOldest() const { return _drop_oldest; }
+
+        //!
+        //! Get the number of dropped messages since the creation of the report.
+        //! @return The number of dropped messages.
+        //!
+        uint64_t droppedMessages() const { return _dropped; }
+
         //!
         //! Synchronously terminate the report thread.
         //! Automatically performed in destructor.
@@ -93,7 +117,8 @@ namespace ts {
 
         //!
         //! This method is called in the context of the asynchronous logging thread to log a message.
-        //! The default implementation prints the message on the standard error.
+        //! The default implementation prints the message on the standard error. The messages
+        //! which are processed together by the logging thread are written at once.
         //! @param [in] severity Severity level of the message.
         //! @param [in] message The message line to log.
         //!
@@ -112,20 +137,34 @@ namespace ts {
         // This hook is invoked in the context of the logging thread.
         virtual void main() override;
 
+        // Wake up the logging thread if it is waiting for messages.
+        void wakeUp();
+
+        // Write the batch of messages from the default asyncThreadLog().
+        void flushBatch();
+
         // The application threads send that type of message to the logging thread
         struct LogMessage
         {
-            bool    terminate;
-            int     severity;
-            UString message;
+            int     severity = 0;
+            UString message {};
         };
-        using LogMessageQueue = MessageQueue<LogMessage>;
-        using LogMessagePtr = LogMessageQueue::MessagePtr;
 
         // Private members:
-        LogMessageQueue _log_queue {};
-        volatile bool   _time_stamp = false;
-        volatile bool   _synchronous = false;
-        volatile bool   _terminated = false;
+        LockFreeQueue<LogMessage> _log_queue;
+        std::mutex                _mutex {};              // Protect the wait on conditions, not the queue.
+        std::condition_variable   _wake_logger {};        // Signaled when the logging thread shall wake up.
+        std::condition_variable   _space_available {};    // Signaled when messages were removed from the queue.
+        std::atomic_bool          _logger_waiting {false};
+        std::atomic_bool          _terminate {false};
+        std::atomic_size_t        _blocked_senders {0};   // Number of blocked threads in synchronous mode.
+        std::atomic<uint64_t>     _dropped {0};
+        uint64_t                  _dropped_reported = 0;  // Used in logging thread only.
+        std::string               _batch {};              // Used in logging thread only.
+        std::string               _line {};               // Used in logging thread only.
+        volatile bool             _time_stamp = false;
+        volatile bool             _synchronous = false;
+        volatile bool             _drop_oldest = false;
+        volatile bool             _terminated = false;
     };
 }
@@ -26,6 +26,13 @@ void ts::AsyncReportArgs::defineArgs(Args& args)
               u"this value if you think that too many messages are dropped. The default "
               u"is " + UString::Decimal(MAX_LOG_MESSAGES) + u" messages.");
 
+    args.option(u"log-drop-oldest");
+    args.help(u"log-drop-oldest",
+              u"When the buffer of log messages is full, drop the oldest buffered messages "
+              u"instead of the new ones. This way, the most recent messages are displayed. "
+              u"In all cases, the number of dropped messages is reported. This option is "
+              u"ignored with --synchronous-log.");
+
     args.option(u"synchronous-log", 's');
     args.help(u"synchronous-log",
               u"Each logged message is guaranteed to be displayed, synchronously, without "
@@ -50,5 +57,6 @@ bool ts::AsyncReportArgs::loadArgs(DuckContext& duck, Args& args)
     args.getIntValue(log_msg_count, u"log-message-count", MAX_LOG_MESSAGES);
     sync_log = args.present(u"synchronous-log");
     timed_log = args.present(u"timed-log");
+    drop_oldest = args.present(u"log-drop-oldest");
     return true;
 }
@@ -29,6 +29,7 @@ namespace ts {
         // Public fields
         bool   sync_log = false;                  //!< Synchronous log.
         bool   timed_log = false;                 //!< Add time stamps in log messages.
+        bool   drop_oldest = false;               //!< Drop the oldest messages instead of the new ones when the queue is full.
         size_t log_msg_count = MAX_LOG_MESSAGES;  //!< Maximum buffered log messages.
 
         //!
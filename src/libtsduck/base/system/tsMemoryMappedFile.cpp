@@ -0,0 +1,133 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2024, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+
+#include "tsMemoryMappedFile.h"
+#include "tsSysUtils.h"
+
+#if !defined(TS_WINDOWS)
+    #include "tsBeforeStandardHeaders.h"
+    #include <sys/types.h>
+    #include <sys/stat.h>
+    #include <sys/mman.h>
+    #include <unistd.h>
+    #include "tsAfterStandardHeaders.h"
+#endif
+
+
+//----------------------------------------------------------------------------
+// Move constructor and destructor.
+//----------------------------------------------------------------------------
+
+ts::MemoryMappedFile::MemoryMappedFile(MemoryMappedFile&& other) noexcept :
+    _is_open(other._is_open),
+    _map_base(other._map_base),
+    _map_size(other._map_size),
+    _buffer(std::move(other._buffer))
+{
+    other._is_open = false;
+    other._map_base = nullptr;
+    other._map_size = 0;
+}
+
+ts::MemoryMappedFile::~MemoryMappedFile()
+{
+    close();
+}
+
+
+//----------------------------------------------------------------------------
+// Open a file and map its content in memory.
+//----------------------------------------------------------------------------
+
+bool ts::MemoryMappedFile::open(const fs::path& file_name, Report& report, bool read_if_not_mapped)
+{
+    close();
+
+#if !defined(TS_WINDOWS)
+    const int fd = ::open(file_name.c_str(), O_RDONLY);
+    if (fd < 0) {
+        report.error(u"error opening %s: %s", file_name, SysErrorCodeMessage());
+        return false;
+    }
+
+    // Only regular non-empty files can be mapped. A file which is larger than the address space
+    // (32-bit systems) is not mapped either. These files are read in the internal buffer.
+    struct stat st;
+    if (::fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0 && uint64_t(st.st_size) <= uint64_t(std::numeric_limits<size_t>::max())) {
+        void* addr = ::mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr == MAP_FAILED) {
+            report.debug(u"cannot map %s in memory, reading it: %s", file_name, SysErrorCodeMessage());
+        }
+        else {
+            // The file is typically read sequentially. Transparent huge pages, when supported
+            // for file mappings, reduce TLB misses on large files. Failures are ignored.
+            ::madvise(addr, size_t(st.st_size), MADV_SEQUENTIAL);
+#if defined(MADV_HUGEPAGE)
+            ::madvise(addr, size_t(st.st_size), MADV_HUGEPAGE);
+#endif
+            _map_base = reinterpret_cast<uint8_t*>(addr);
+            _map_size = size_t(st.st_size);
+            report.debug(u"mapped %s in memory, %'d bytes", file_name, _map_size);
+        }
+    }
+
+    // The mapping remains valid after closing the file descriptor.
+    ::close(fd);
+#endif
+
+    _is_open = isMapped() || (read_if_not_mapped && readFile(file_name, report));
+    return _is_open;
+}
+
+
+//----------------------------------------------------------------------------
+// Read the complete file in the internal buffer.
+//----------------------------------------------------------------------------
+
+bool ts::MemoryMappedFile::readFile(const fs::path& file_name, Report& report)
+{
+    std::ifstream strm(file_name, std::ios::in | std::ios::binary);
+    if (!strm) {
+        report.error(u"error opening %s", file_name);
+        return false;
+    }
+
+    _buffer.clear();
+    while (strm) {
+        constexpr size_t chunk_size = 64 * 1024;
+        const size_t size = _buffer.size();
+        _buffer.resize(size + chunk_size);
+        strm.read(reinterpret_cast<char*>(_buffer.data() + size), std::streamsize(chunk_size));
+        _buffer.resize(size + size_t(std::max<std::streamsize>(0, strm.gcount())));
+    }
+    if (strm.bad()) {
+        report.error(u"error reading %s", file_name);
+        _buffer.clear();
+        return false;
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Close the file and unmap its content.
+//----------------------------------------------------------------------------
+
+void ts::MemoryMappedFile::close()
+{
+#if !defined(TS_WINDOWS)
+    if (_map_base != nullptr) {
+        ::munmap(_map_base, _map_size);
+    }
+#endif
+    _map_base = nullptr;
+    _map_size = 0;
+    _buffer.clear();
+    _buffer.shrink_to_fit();
+    _is_open = false;
+}
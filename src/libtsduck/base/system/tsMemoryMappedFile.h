@@ -0,0 +1,113 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2024, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Read-only content of a file, mapped in memory.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsByteBlock.h"
+#include "tsNullReport.h"
+
+namespace ts {
+    //!
+    //! Read-only content of a file, mapped in memory.
+    //! @ingroup system
+    //!
+    //! On UNIX systems, the file is mapped in the virtual memory of the process and its pages
+    //! are loaded on demand by the system. This is well suited to large files which are read
+    //! sequentially: the file content does not use any allocated memory in the process.
+    //!
+    //! On Windows, or when the file cannot be mapped (special files for instance), the content
+    //! of the file is read in an internal buffer. In both cases, the application accesses the
+    //! complete content of the file at a contiguous address.
+    //!
+    //! Only the content of the file at the time of open() is mapped. Data which are later appended
+    //! to the file are not visible in the mapping: an application which reads a growing file shall
+    //! continue with I/O operations after the mapped content. The file must not be truncated while
+    //! it is mapped: on UNIX systems, accessing mapped pages beyond the new end of file raises a
+    //! SIGBUS signal. This is why mapping files which may be modified by other processes shall
+    //! be an explicit choice of the user.
+    //!
+    class TSDUCKDLL MemoryMappedFile
+    {
+    public:
+        //!
+        //! Default constructor.
+        //!
+        MemoryMappedFile() = default;
+
+        //!
+        //! Move constructor.
+        //! @param [in,out] other Another instance to move. It is closed on return.
+        //!
+        MemoryMappedFile(MemoryMappedFile&& other) noexcept;
+
+        //!
+        //! Destructor.
+        //!
+        ~MemoryMappedFile();
+
+        //!
+        //! Open a file and map its content in memory.
+        //! A previously open file is closed first.
+        //! @param [in] file_name Name of the file to open.
+        //! @param [in,out] report Where to report errors.
+        //! @param [in] read_if_not_mapped When the file cannot be mapped, read its complete content
+        //! in an internal buffer. When false, open() fails on files which cannot be mapped, without
+        //! error message. This is useful with potentially huge files which should never be loaded
+        //! in memory and which the application can read sequentially instead.
+        //! @return True on success, false on error.
+        //!
+        bool open(const fs::path& file_name, Report& report = NULLREP, bool read_if_not_mapped = true);
+
+        //!
+        //! Close the file and unmap its content.
+        //! The previously returned addresses are no longer valid.
+        //!
+        void close();
+
+        //!
+        //! Check if a file is open.
+        //! @return True if a file is open.
+        //!
+        bool isOpen() const { return _is_open; }
+
+        //!
+        //! Check if the file is actually mapped in memory.
+        //! @return True if the file is mapped in memory, false if it was read in an internal buffer.
+        //!
+        bool isMapped() const { return _map_base != nullptr; }
+
+        //!
+        //! Get the address of the file content.
+        //! @return The address of the file content or a null pointer if the file is not open or empty.
+        //!
+        const uint8_t* data() const { return _map_base != nullptr ? _map_base : (_buffer.empty() ? nullptr : _buffer.data()); }
+
+        //!
+        //! Get the size of the file content.
+        //! @return The size in bytes of the file content.
+        //!
+        size_t size() const { return _map_base != nullptr ? _map_size : _buffer.size(); }
+
+    private:
+        MemoryMappedFile(const MemoryMappedFile&) = delete;
+        MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+        MemoryMappedFile& operator=(MemoryMappedFile&&) = delete;
+
+        bool      _is_open = false;      // A file is open.
+        uint8_t*  _map_base = nullptr;   // Base address of the file mapping.
+        size_t    _map_size = 0;         // Size of the file mapping.
+        ByteBlock _buffer {};            // File content, when the file is not mapped.
+
+        // Read the complete file in the internal buffer.
+        bool readFile(const fs::path& file_name, Report& report);
+    };
+}
@@ -0,0 +1,191 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2024, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+
+#include "tsResidentMemory.h"
+#include "tsIntegerUtils.h"
+#include "tsSysInfo.h"
+
+#if defined(TS_LINUX)
+    #include <sys/syscall.h>
+    // Memory policy definitions from <numaif.h>, which is part of libnuma and not always installed.
+    #if !defined(MPOL_BIND)
+        #define MPOL_BIND 2
+    #endif
+    #if !defined(MPOL_MF_MOVE)
+        #define MPOL_MF_MOVE (1 << 1)
+    #endif
+#endif
+
+
+//----------------------------------------------------------------------------
+// Constructor and destructor.
+//----------------------------------------------------------------------------
+
+ts::ResidentMemory::ResidentMemory(size_t size, bool lock, bool huge_pages, int numa_node)
+{
+    const size_t page_size = SysInfo::Instance().memoryPageSize();
+    _size = round_up(size, page_size);
+
+    // With huge pages or NUMA binding, the memory area is directly mapped from the system.
+    // Otherwise, or when not possible, allocate enough space in the heap to include memory
+    // pages around the requested size. Be sure to use size_t (unsigned) instead of ptrdiff_t
+    // (signed) to perform arithmetics on pointers because we use modulo operations.
+    if ((!huge_pages && numa_node < 0) || !mapMemory(_size, huge_pages)) {
+        assert(sizeof(size_t) == sizeof(char_ptr));
+        _allocated_base = new char[_size + page_size];
+        _base = char_ptr(round_up(size_t(_allocated_base), page_size));
+        assert(_base + _size <= _allocated_base + _size + page_size);
+    }
+    assert(size_t(_base) % page_size == 0);
+
+    // Bind to the NUMA node before locking, which allocates the physical memory.
+    if (numa_node >= 0) {
+        bindNUMANode(numa_node);
+    }
+    if (lock) {
+        lockMemory();
+    }
+}
+
+ts::ResidentMemory::~ResidentMemory()
+{
+    // Unlock from physical memory
+    if (_is_locked) {
+#if defined(TS_WINDOWS)
+        ::VirtualUnlock(_base, _size);
+#else
+        ::munlock(_base, _size);
+#endif
+    }
+
+    // Free memory
+#if defined(TS_LINUX)
+    if (_mapped_base != nullptr) {
+        ::munmap(_mapped_base, _mapped_size);
+    }
+#endif
+    if (_allocated_base != nullptr) {
+        delete[] _allocated_base;
+    }
+
+    _allocated_base = _mapped_base = _base = nullptr;
+    _mapped_size = _size = 0;
+    _is_locked = _huge_pages = _numa_bound = false;
+}
+
+
+//----------------------------------------------------------------------------
+// Allocate the memory area using mmap().
+//----------------------------------------------------------------------------
+
+bool ts::ResidentMemory::mapMemory(size_t size, bool huge_pages)
+{
+#if defined(TS_LINUX)
+
+    const int prot = PROT_READ | PROT_WRITE;
+    const int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+    void* addr = MAP_FAILED;
+
+    if (!huge_pages) {
+        // Simple page-aligned anonymous mapping.
+        _mapped_size = size;
+        addr = ::mmap(nullptr, _mapped_size, prot, flags, -1, 0);
+        _base = char_ptr(addr);
+    }
+    else {
+        // First, try explicit huge pages. The mapped size must be a multiple of the huge page size.
+        _mapped_size = round_up(size, HUGE_PAGE_SIZE);
+        addr = ::mmap(nullptr, _mapped_size, prot, flags | MAP_HUGETLB, -1, 0);
+        _huge_pages = addr != MAP_FAILED;
+        _base = char_ptr(addr);
+
+        // No reserved huge pages, request transparent huge pages on a huge page boundary.
+        if (addr == MAP_FAILED) {
+            _mapped_size = round_up(size, HUGE_PAGE_SIZE) + HUGE_PAGE_SIZE;
+            addr = ::mmap(nullptr, _mapped_size, prot, flags, -1, 0);
+            if (addr != MAP_FAILED) {
+                _base = char_ptr(round_up(size_t(addr), HUGE_PAGE_SIZE));
+                ::madvise(_base, round_up(size, HUGE_PAGE_SIZE), MADV_HUGEPAGE);
+            }
+        }
+    }
+
+    if (addr == MAP_FAILED) {
+        _mapped_size = 0;
+        _base = nullptr;
+        return false;
+    }
+    _mapped_base = char_ptr(addr);
+    return true;
+
+#else
+    return false;
+#endif
+}
+
+
+//----------------------------------------------------------------------------
+// Bind the memory area to a NUMA node.
+//----------------------------------------------------------------------------
+
+void ts::ResidentMemory::bindNUMANode(int numa_node)
+{
+#if defined(TS_LINUX)
+    // Use the mbind() system call directly, without dependency on libnuma.
+    // Pages which were already allocated are moved to the node.
+    constexpr size_t bits = 8 * sizeof(unsigned long);
+    std::vector<unsigned long> mask(size_t(numa_node) / bits + 1, 0);
+    mask[size_t(numa_node) / bits] |= 1UL << (size_t(numa_node) % bits);
+    _numa_bound = _size == 0 || ::syscall(SYS_mbind, _base, _size, MPOL_BIND, mask.data(), mask.size() * bits + 1, MPOL_MF_MOVE) == 0;
+#endif
+}
+
+
+//----------------------------------------------------------------------------
+// Lock the memory area in physical memory.
+//----------------------------------------------------------------------------
+
+void ts::ResidentMemory::lockMemory()
+{
+#if defined(TS_WINDOWS)
+
+    // Windows implementation.
+
+    // Get the current working set of the process.
+    // If working set too low, try to extend working set.
+    ::SIZE_T wsmin = 0;
+    ::SIZE_T wsmax = 0;
+    if (::GetProcessWorkingSetSize(::GetCurrentProcess(), &wsmin, &wsmax) == 0) {
+        _error_code.assign(::GetLastError(), std::system_category());
+    }
+    else if (size_t(wsmin) < 2 * _size) {
+        wsmin = ::SIZE_T(2 * _size);
+        wsmax = std::max(wsmax, ::SIZE_T(4 * _size));
+        if (::SetProcessWorkingSetSize(::GetCurrentProcess(), wsmin, wsmax) == 0) {
+            _error_code.assign(::GetLastError(), std::system_category());
+        }
+    }
+
+    // Lock in virtual memory.
+    _is_locked = ::VirtualLock(_base, _size) != 0;
+    if (!_is_locked && _error_code.default_error_condition().value() == 0) {
+        // Keep this error only when no previous error.
+        _error_code.assign(::GetLastError(), std::system_category());
+    }
+
+#else
+
+    // UNIX implementation
+
+    _is_locked = ::mlock(_base, _size) == 0;
+    if (!_is_locked) {
+        _error_code.assign(errno, std::system_category());
+    }
+
+#endif
+}
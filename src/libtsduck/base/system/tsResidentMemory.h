@@ -0,0 +1,116 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2024, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Memory area which is locked in physical memory.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsPlatform.h"
+
+namespace ts {
+    //!
+    //! Memory area which is locked in physical memory.
+    //! This is the untyped memory management of ts::ResidentBuffer.
+    //! @ingroup system
+    //!
+    //! The memory area is aligned on a page boundary. Its size is a multiple of the page size.
+    //! Failing to lock the memory area is not a fatal error, see ts::ResidentBuffer.
+    //!
+    //! On Linux, two optional allocation modes are available for large buffers:
+    //! - Huge pages: the memory area is allocated using huge pages (2 MB on Intel), reducing TLB
+    //!   misses. Explicit huge pages must be reserved by the system administrator (see the file
+    //!   /proc/sys/vm/nr_hugepages). When no huge page is available, transparent huge pages are
+    //!   requested for the memory area.
+    //! - NUMA binding: the physical memory is allocated on a given NUMA node. The threads which use
+    //!   the memory area should run on the CPU's of the same node (see ts::ThreadAttributes::setAffinity()).
+    //!
+    //! On other systems, these options are ignored.
+    //!
+    class TSDUCKDLL ResidentMemory
+    {
+        TS_NOBUILD_NOCOPY(ResidentMemory);
+    public:
+        //!
+        //! Constructor.
+        //! Abort application if memory allocation fails.
+        //! @param [in] size Requested size in bytes.
+        //! @param [in] lock If true, lock the memory area in physical memory.
+        //! @param [in] huge_pages If true, try to use huge pages.
+        //! @param [in] numa_node If not negative, allocate the physical memory on this NUMA node.
+        //!
+        ResidentMemory(size_t size, bool lock = true, bool huge_pages = false, int numa_node = -1);
+
+        //!
+        //! Destructor.
+        //!
+        ~ResidentMemory();
+
+        //!
+        //! Get the base address of the memory area.
+        //! @return The base address of the memory area, aligned on a page boundary.
+        //!
+        void* address() const { return _base; }
+
+        //!
+        //! Get the size of the memory area.
+        //! @return The size of the memory area in bytes, a multiple of the page size.
+        //!
+        size_t size() const { return _size; }
+
+        //!
+        //! Check if the memory area is actually locked.
+        //! @return True if the memory area is actually locked, false if locking failed or was not requested.
+        //!
+        bool isLocked() const { return _is_locked; }
+
+        //!
+        //! Get error code when not locked
+        //! @return A constant reference to the system error code when locking failed.
+        //!
+        const std::error_code& lockErrorCode() const { return _error_code; }
+
+        //!
+        //! Check if the memory area is allocated using explicit huge pages.
+        //! @return True if the memory area is allocated using explicit huge pages.
+        //!
+        bool isHugePages() const { return _huge_pages; }
+
+        //!
+        //! Check if the physical memory is bound to a NUMA node.
+        //! @return True if the physical memory is bound to the requested NUMA node.
+        //!
+        bool isNUMABound() const { return _numa_bound; }
+
+        //!
+        //! Size of huge pages.
+        //!
+        static constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+    private:
+        char*  _allocated_base = nullptr;  // First allocated address when allocated on the heap.
+        char*  _mapped_base = nullptr;     // First allocated address when allocated using mmap().
+        size_t _mapped_size = 0;           // Mapped size (mmap).
+        char*  _base = nullptr;            // Base address of the memory area (page boundary).
+        size_t _size = 0;                  // Size of the memory area (multiple of page size).
+        bool   _is_locked = false;         // False if mlock failed.
+        bool   _huge_pages = false;        // Allocated using explicit huge pages.
+        bool   _numa_bound = false;        // Bound to a NUMA node.
+        std::error_code _error_code {};    // Lock error code
+
+        // Allocate the memory area using mmap(). Return false if not possible.
+        bool mapMemory(size_t size, bool huge_pages);
+
+        // Bind the memory area to a NUMA node.
+        void bindNUMANode(int numa_node);
+
+        // Lock the memory area in physical memory.
+        void lockMemory();
+    };
+}
@@ -304,5 +304,46 @@ ts::SysInfo::SysInfo() :
                 _crcInstructions = tsCRC32IsAccelerated && SysCtrlBool("hw.optional.armv8_crc32");
             #endif
         }
+        if (GetEnvironment(u"TS_NO_SIMD_INSTRUCTIONS").empty()) {
+            #if defined(TS_NO_SIMD_INSTRUCTIONS)
+                // Disabled at compile time.
+            #elif defined(TS_X86_64) && (defined(TS_GCC) || defined(TS_LLVM))
+                _simdInstructions = __builtin_cpu_supports("avx2");
+            #elif defined(TS_ARM64)
+                // Advanced SIMD is a mandatory feature of Armv8-A.
+                _simdInstructions = true;
+            #endif
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Get the list of CPU's in a NUMA node.
+//----------------------------------------------------------------------------
+
+bool ts::SysInfo::getNUMANodeCPUs(std::set<size_t>& cpus, size_t numa_node) const
+{
+    cpus.clear();
+#if defined(TS_LINUX)
+    // The file contains a list of CPU ranges such as "0-7,16-23".
+    UStringList lines;
+    if (!UString::Load(lines, UString::Format(u"/sys/devices/system/node/node%d/cpulist", numa_node)) || lines.empty()) {
+        return false;
     }
+    UStringVector ranges;
+    lines.front().split(ranges, u',', true, true);
+    for (const auto& range : ranges) {
+        size_t first = 0, last = 0;
+        if (range.scan(u"%d-%d", &first, &last)) {
+            for (size_t cpu = first; cpu <= last; ++cpu) {
+                cpus.insert(cpu);
+            }
+        }
+        else if (range.scan(u"%d", &first)) {
+            cpus.insert(first);
+        }
+    }
+#endif
+    return !cpus.empty();
 }
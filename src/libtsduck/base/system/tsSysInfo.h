@@ -147,6 +147,12 @@ namespace ts {
         //!
         bool crcInstructions() const { return _crcInstructions; }
         //!
+        //! Check if the CPU supports the SIMD instructions which are used to accelerate packet processing.
+        //! These are AVX2 on Intel x86_64 and Advanced SIMD (Neon) on Arm64.
+        //! @return True if the CPU supports the SIMD instructions.
+        //!
+        bool simdInstructions() const { return _simdInstructions; }
+        //!
         //! Get the operating system version.
         //! @return The operating system version.
         //!
@@ -177,6 +183,14 @@ namespace ts {
         //! @return The system memory page size in bytes.
         //!
         size_t memoryPageSize() const { return _memoryPageSize; }
+        //!
+        //! Get the list of CPU's in a NUMA node.
+        //! This information is available on Linux only.
+        //! @param [out] cpus Set of CPU indexes in the NUMA node.
+        //! @param [in] numa_node NUMA node index.
+        //! @return True on success, false if the NUMA node does not exist or the information is not available.
+        //!
+        bool getNUMANodeCPUs(std::set<size_t>& cpus, size_t numa_node) const;
 
     private:
         bool    _isLinux = false;
@@ -203,6 +217,7 @@ namespace ts {
         bool    _isMIPS32 = false;
         bool    _isMIPS64 = false;
         bool    _crcInstructions = false;
+        bool    _simdInstructions = false;
         int     _systemMajorVersion {-1};
         UString _systemVersion {};
         UString _systemName {};
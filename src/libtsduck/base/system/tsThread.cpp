@@ -181,20 +181,45 @@ bool ts::Thread::start()
     // Create the thread in suspended state.
     _handle = ::CreateThread(nullptr, _attributes._stackSize, Thread::ThreadProc, this, CREATE_SUSPENDED, &_thread_id);
     if (_handle == nullptr) {
+        _handle = INVALID_HANDLE_VALUE;
+        _thread_id = 0;
         return false;
     }
 
-    // Set the thread priority
-    ::BOOL status = ::SetThreadPriority(_handle, ThreadAttributes::Win32Priority(_attributes._priority));
-    if (status == 0) {
+    // In case of error, the suspended thread has not executed anything yet and can be safely terminated.
+    // Just closing the handle would leave a suspended thread forever. The thread is not marked as started.
+    const auto cancel = [this]() {
+        ::TerminateThread(_handle, 0);
+        ::WaitForSingleObject(_handle, INFINITE);
         ::CloseHandle(_handle);
+        _handle = INVALID_HANDLE_VALUE;
+        _thread_id = 0;
         return false;
+    };
+
+    // Set the thread priority. There is no real-time scheduling policy, use the highest priority instead.
+    const int priority = _attributes._schedulingPolicy == ThreadAttributes::SchedulingPolicy::DEFAULT ?
+        ThreadAttributes::Win32Priority(_attributes._priority) : THREAD_PRIORITY_TIME_CRITICAL;
+    if (::SetThreadPriority(_handle, priority) == 0) {
+        return cancel();
+    }
+
+    // Set the CPU affinity.
+    if (!_attributes._affinity.empty()) {
+        ::DWORD_PTR mask = 0;
+        for (size_t cpu : _attributes._affinity) {
+            if (cpu < 8 * sizeof(mask)) {
+                mask |= ::DWORD_PTR(1) << cpu;
+            }
+        }
+        if (::SetThreadAffinityMask(_handle, mask) == 0) {
+            return cancel();
+        }
     }
 
     // Release the thread
     if (::ResumeThread(_handle) == ::DWORD(-1)) {
-        ::CloseHandle(_handle);
-        return false;
+        return cancel();
     }
 
 #else
@@ -217,8 +242,14 @@ bool ts::Thread::start()
         }
     }
 
-    // Set scheduling policy identical as current process.
-    if (::pthread_attr_setschedpolicy(&attr, ThreadAttributes::PthreadSchedulingPolicy()) != 0) {
+    // Set scheduling policy identical as current process or the requested real-time policy.
+    int policy = ThreadAttributes::PthreadSchedulingPolicy();
+    int priority = _attributes._priority;
+    if (_attributes._schedulingPolicy != ThreadAttributes::SchedulingPolicy::DEFAULT) {
+        policy = _attributes._schedulingPolicy == ThreadAttributes::SchedulingPolicy::FIFO ? SCHED_FIFO : SCHED_RR;
+        priority = std::max(::sched_get_priority_min(policy), std::min(::sched_get_priority_max(policy), _attributes._realTimePriority));
+    }
+    if (::pthread_attr_setschedpolicy(&attr, policy) != 0) {
         ::pthread_attr_destroy(&attr);
         return false;
     }
@@ -226,7 +257,7 @@ bool ts::Thread::start()
     // Set scheduling priority.
     ::sched_param sparam;
     TS_ZERO(sparam);
-    sparam.sched_priority = _attributes._priority;
+    sparam.sched_priority = priority;
     if (::pthread_attr_setschedparam(&attr, &sparam) != 0) {
         ::pthread_attr_destroy(&attr);
         return false;
@@ -241,6 +272,23 @@ bool ts::Thread::start()
     }
 #endif
 
+    // Set the CPU affinity.
+#if defined(TS_LINUX)
+    if (!_attributes._affinity.empty()) {
+        ::cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        for (size_t cpu : _attributes._affinity) {
+            if (cpu < CPU_SETSIZE) {
+                CPU_SET(cpu, &cpus);
+            }
+        }
+        if (::pthread_attr_setaffinity_np(&attr, sizeof(cpus), &cpus) != 0) {
+            ::pthread_attr_destroy(&attr);
+            return false;
+        }
+    }
+#endif
+
     // Create the thread
     if (::pthread_create(&_pthread, &attr, Thread::ThreadProc, this) != 0) {
         ::pthread_attr_destroy(&attr);
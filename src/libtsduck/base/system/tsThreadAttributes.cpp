@@ -21,6 +21,64 @@ int ts::ThreadAttributes::_highPriority = 0;
 int ts::ThreadAttributes::_maximumPriority = 0;
 
 
+//----------------------------------------------------------------------------
+// Set the CPU affinity or the scheduling policy of the thread from a string.
+//----------------------------------------------------------------------------
+
+bool ts::ThreadAttributes::decodeAffinity(const UString& cpus)
+{
+    // Same upper limit as CPU indexes in command line options, avoid huge ranges.
+    constexpr size_t max_cpu = 4095;
+
+    UStringVector ranges;
+    cpus.split(ranges, u',', true, true);
+
+    std::set<size_t> affinity;
+    for (const auto& range : ranges) {
+        size_t first = 0, last = 0;
+        if (range.toInteger(first) && first <= max_cpu) {
+            affinity.insert(first);
+        }
+        else if (range.scan(u"%d-%d", &first, &last) && first <= last && last <= max_cpu) {
+            for (size_t cpu = first; cpu <= last; ++cpu) {
+                affinity.insert(cpu);
+            }
+        }
+        else {
+            return false;
+        }
+    }
+    if (affinity.empty()) {
+        return false;
+    }
+    _affinity = affinity;
+    return true;
+}
+
+bool ts::ThreadAttributes::decodeSchedulingPolicy(const UString& policy)
+{
+    const size_t colon = policy.find(u':');
+    const UString name(policy.substr(0, colon));
+    int priority = 1;
+    if (colon != NPOS && (!policy.substr(colon + 1).toInteger(priority) || priority < 1)) {
+        return false;
+    }
+    else if (name.similar(u"fifo")) {
+        setSchedulingPolicy(SchedulingPolicy::FIFO, priority);
+    }
+    else if (name.similar(u"rr")) {
+        setSchedulingPolicy(SchedulingPolicy::ROUND_ROBIN, priority);
+    }
+    else if (name.similar(u"other") && colon == NPOS) {
+        setSchedulingPolicy(SchedulingPolicy::DEFAULT);
+    }
+    else {
+        return false;
+    }
+    return true;
+}
+
+
 //----------------------------------------------------------------------------
 // This static method initializes the operating system priority range.
 //----------------------------------------------------------------------------
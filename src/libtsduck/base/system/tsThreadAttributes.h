@@ -215,6 +215,104 @@ namespace ts {
             return _priority;
         }
 
+        //!
+        //! Set the CPU affinity of the thread.
+        //!
+        //! The thread runs only on the specified CPU's. This is typically used to run
+        //! a thread on the CPU's of the NUMA node which holds its memory buffers, or to
+        //! isolate time-critical threads on dedicated CPU's.
+        //!
+        //! CPU affinity is supported on Linux and Windows (CPU indexes 0 to 63 only).
+        //! It is ignored on other operating systems.
+        //!
+        //! @param [in] cpus Set of CPU indexes. An empty set, the default, means no constraint.
+        //! @return A reference to this object.
+        //!
+        ThreadAttributes& setAffinity(const std::set<size_t>& cpus)
+        {
+            _affinity = cpus;
+            return *this;
+        }
+
+        //!
+        //! Get the CPU affinity of the thread.
+        //!
+        //! @return The set of CPU indexes on which the thread runs. An empty set means no constraint.
+        //! @see setAffinity()
+        //!
+        const std::set<size_t>& getAffinity() const
+        {
+            return _affinity;
+        }
+
+        //!
+        //! Set the CPU affinity of the thread from a string.
+        //! @param [in] cpus Comma-separated list of CPU indexes or ranges of CPU indexes, for instance "2-5,8".
+        //! @return True on success, false if the string is invalid. In case of error, the affinity is unchanged.
+        //! @see setAffinity()
+        //!
+        bool decodeAffinity(const UString& cpus);
+
+        //!
+        //! Scheduling policy of a thread.
+        //!
+        enum class SchedulingPolicy {
+            DEFAULT,      //!< Same scheduling policy as the current process, using the thread priority.
+            FIFO,         //!< Real-time first-in first-out policy (SCHED_FIFO on UNIX systems).
+            ROUND_ROBIN,  //!< Real-time round-robin policy (SCHED_RR on UNIX systems).
+        };
+
+        //!
+        //! Set the scheduling policy of the thread.
+        //!
+        //! Real-time policies require specific privileges. On Linux, the capability CAP_SYS_NICE is
+        //! required. Without these privileges, the thread cannot be started. On Windows, the real-time
+        //! policies are not available, the thread is run with the time-critical priority instead.
+        //!
+        //! @param [in] policy The scheduling policy.
+        //! @param [in] rt_priority Real-time priority of the thread, with FIFO and ROUND_ROBIN policies.
+        //! On Linux, the range of real-time priorities is 1 to 99. The thread priority which is set by
+        //! setPriority() applies with the DEFAULT policy only.
+        //! @return A reference to this object.
+        //!
+        ThreadAttributes& setSchedulingPolicy(SchedulingPolicy policy, int rt_priority = 1)
+        {
+            _schedulingPolicy = policy;
+            _realTimePriority = rt_priority;
+            return *this;
+        }
+
+        //!
+        //! Get the scheduling policy of the thread.
+        //!
+        //! @return The scheduling policy of the thread.
+        //! @see setSchedulingPolicy()
+        //!
+        SchedulingPolicy getSchedulingPolicy() const
+        {
+            return _schedulingPolicy;
+        }
+
+        //!
+        //! Get the real-time priority of the thread.
+        //!
+        //! @return The real-time priority of the thread, with FIFO and ROUND_ROBIN policies.
+        //! @see setSchedulingPolicy()
+        //!
+        int getRealTimePriority() const
+        {
+            return _realTimePriority;
+        }
+
+        //!
+        //! Set the scheduling policy of the thread from a string.
+        //! @param [in] policy A string in the format "policy[:priority]". The policy is one of "fifo",
+        //! "rr" (round-robin) or "other" (default policy). The default real-time priority is 1.
+        //! @return True on success, false if the string is invalid. In case of error, the policy is unchanged.
+        //! @see setSchedulingPolicy()
+        //!
+        bool decodeSchedulingPolicy(const UString& policy);
+
         //!
         //! Get the minimum priority for a thread in this context of the operating system.
         //! @return The minimum priority for a thread.
@@ -274,6 +372,9 @@ namespace ts {
         bool    _exitOnException = false;
         int     _priority = 0;
         UString _name {};
+        std::set<size_t> _affinity {};
+        SchedulingPolicy _schedulingPolicy = SchedulingPolicy::DEFAULT;
+        int     _realTimePriority = 1;
 
         //
         // These fields describe the operating system priority range.
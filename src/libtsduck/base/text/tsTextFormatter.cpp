@@ -114,10 +114,11 @@ bool ts::TextFormatter::isOpen() const
 // Close the current output.
 //----------------------------------------------------------------------------
 
-void ts::TextFormatter::close()
+bool ts::TextFormatter::close()
 {
     // Flush buffered characters.
     flush();
+    bool success = !_out->fail();
 
     // Close resources.
     if (_out == &_outString) {
@@ -125,7 +126,9 @@ void ts::TextFormatter::close()
         _outString.str(std::string());
     }
     if (_outFile.is_open()) {
+        // Closing the file flushes its buffer, write errors may be detected here only.
         _outFile.close();
+        success = success && !_outFile.fail();
     }
 
     // Set output to a closed file. Thus, _out is never null, it is safe to
@@ -136,6 +139,7 @@ void ts::TextFormatter::close()
     _column = 0;
     _afterSpace = false;
     _curMargin = _margin;
+    return success;
 }
 
 
@@ -165,26 +169,34 @@ ts::TextFormatter& ts::TextFormatter::setMarginSize(size_t margin)
 
 bool ts::TextFormatter::writeStreamBuffer(const void* addr, size_t size)
 {
-    const char* const last = static_cast<const char*>(addr) + size;
-    for (const char* p = static_cast<const char*>(addr); p < last; ++p) {
-        if (*p == '\t') {
+    const char* p = static_cast<const char*>(addr);
+    const char* const last = p + size;
+    while (p < last) {
+        // Write sequences of ordinary characters at once.
+        const char* next = p;
+        while (next < last && *next != '\t' && *next != '\r' && *next != '\n') {
+            ++next;
+        }
+        if (next > p) {
+            _out->write(p, next - p);
+            _column += next - p;
+            _afterSpace = _afterSpace || std::any_of(p, next, [](char c) { return c != ' '; });
+            p = next;
+        }
+        else if (*p == '\t') {
             // Tabulations are expanded as spaces.
             // Without formatting, a tabulation is just one space.
             do {
                 *_out << ' ';
             } while (++_column % _tabSize != 0 && _formatting);
+            ++p;
         }
-        else if (*p == '\r' || *p == '\n') {
+        else {
             // CR and LF indifferently move back to begining of current/next line.
-            *_out << *p;
+            *_out << *p++;
             _column = 0;
             _afterSpace = false;
         }
-        else {
-            *_out << *p;
-            ++_column;
-            _afterSpace = _afterSpace || *p != ' ';
-        }
     }
     return !_out->fail();
 }
@@ -219,7 +231,14 @@ ts::TextFormatter& ts::TextFormatter::endl()
     // Different types of end-of-line.
     switch (_eolMode) {
         case EndOfLineMode::NATIVE:
-            *_out << std::endl;
+            // Do not flush internal strings and files we created at each line, this is too slow.
+            // External streams are flushed because their output may be expected on the fly.
+            if (_out == &_outString || _out == &_outFile) {
+                *_out << '\n';
+            }
+            else {
+                *_out << std::endl;
+            }
             _column = 0;
             _afterSpace = false;
             break;
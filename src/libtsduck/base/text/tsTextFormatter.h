@@ -158,8 +158,9 @@ namespace ts {
         //! - The external stream is no longer referenced.
         //! - The external file is closed.
         //! - The internal string buffer is emptied.
+        //! @return True on success, false if an output error occurred since the output was opened.
         //!
-        void close();
+        bool close();
 
         //!
         //! Insert all necessary new-lines and spaces to move to the current margin.
@@ -32,10 +32,10 @@ ts::TextParser::TextParser(const UString& text, Report& report) :
     loadDocument(text);
 }
 
-ts::TextParser::Position::Position(const UStringList& textLines) :
+ts::TextParser::Position::Position(const UStringList& textLines, size_t first_line) :
     _lines(&textLines),
     _curLine(textLines.begin()),
-    _curLineNumber(1),
+    _curLineNumber(first_line),
     _curIndex(0)
 {
 }
@@ -52,6 +52,7 @@ ts::TextParser::~TextParser()
 void ts::TextParser::clear()
 {
     _lines.clear();
+    _first_line = 1;
     _pos = Position(_lines);
 }
 
@@ -63,13 +64,15 @@ void ts::TextParser::clear()
 void ts::TextParser::loadDocument(const UStringList& lines)
 {
     _lines.clear();
+    _first_line = 1;
     _pos = Position(lines);
 }
 
-void ts::TextParser::loadDocument(const UString& text)
+void ts::TextParser::loadDocument(const UString& text, size_t first_line)
 {
     text.toSubstituted(u"\r", UString()).split(_lines, u'\n', false);
-    _pos = Position(_lines);
+    _first_line = first_line;
+    _pos = Position(_lines, _first_line);
 }
 
 bool ts::TextParser::loadFile(const fs::path& fileName)
@@ -81,6 +84,7 @@ bool ts::TextParser::loadFile(const fs::path& fileName)
     }
 
     // Initialize the parser on the internal lines buffer, including on file error (empty).
+    _first_line = 1;
     _pos = Position(_lines);
     return ok;
 }
@@ -94,6 +98,7 @@ bool ts::TextParser::loadStream(std::istream& strm)
     }
 
     // Initialize the parser on the internal lines buffer, including on file error (empty).
+    _first_line = 1;
     _pos = Position(_lines);
     return ok;
 }
@@ -153,7 +158,7 @@ bool ts::TextParser::eol() const
 
 void ts::TextParser::rewind()
 {
-    _pos = Position(_lines);
+    _pos = Position(_lines, _first_line);
 }
 
 
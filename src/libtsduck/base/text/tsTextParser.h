@@ -66,8 +66,10 @@ namespace ts {
         //!
         //! Load the document to parse.
         //! @param [in] text Document text to parse with embedded new-line characters.
+        //! @param [in] first_line Line number of the first line of @a text. This is useful
+        //! when the text is an extract of a larger document, to report the right line numbers.
         //!
-        void loadDocument(const UString& text);
+        void loadDocument(const UString& text, size_t first_line = 1);
 
         //!
         //! Load the document to parse from a text file.
@@ -122,7 +124,7 @@ namespace ts {
         private:
             // Constructors.
             Position() = delete;
-            Position(const UStringList&);
+            Position(const UStringList&, size_t first_line = 1);
 
             // Everything is private to the application.
             // Only TextParser can use it.
@@ -260,6 +262,7 @@ namespace ts {
     private:
         Report&     _report;
         UStringList _lines;
+        size_t      _first_line = 1;
         Position    _pos;
     };
 }
@@ -19,6 +19,19 @@
 #include "tsSingleton.h"
 #include "tsEnumeration.h"
 
+// Select the SIMD implementation of the ASCII fast path in UTF-8 conversions.
+// SSE2 is part of the base x86_64 instruction set and Advanced SIMD is always
+// available on Arm64, no runtime check is required.
+#if defined(TS_NO_SIMD_INSTRUCTIONS)
+    // Disabled at compile time.
+#elif defined(TS_X86_64) && (defined(TS_GCC) || defined(TS_LLVM) || defined(TS_MSC))
+    #define TS_SIMD_SSE2 1
+    #include <emmintrin.h>
+#elif defined(TS_ARM64) && defined(TS_LITTLE_ENDIAN) && defined(__ARM_NEON)
+    #define TS_SIMD_NEON 1
+    #include <arm_neon.h>
+#endif
+
 // The UTF-8 Byte Order Mark
 const char* const ts::UString::UTF8_BOM = "\xEF\xBB\xBF";
 
@@ -78,6 +91,68 @@ const ::WCHAR* ts::UString::wc_str() const
 #endif
 
 
+//----------------------------------------------------------------------------
+// Convert blocks of ASCII characters, 16 characters at a time.
+// Stop before the first block containing a non-ASCII character.
+// Return the number of converted characters, a multiple of 16.
+//----------------------------------------------------------------------------
+
+namespace {
+    inline size_t ConvertASCIIBlocks([[maybe_unused]] const ts::UChar* in, [[maybe_unused]] char* out, [[maybe_unused]] size_t count)
+    {
+        size_t done = 0;
+#if defined(TS_SIMD_SSE2)
+        const __m128i mask = _mm_set1_epi16(int16_t(0xFF80));
+        const __m128i zero = _mm_setzero_si128();
+        for (; done + 16 <= count; done += 16) {
+            const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + done));
+            const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + done + 8));
+            if (_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(_mm_or_si128(a, b), mask), zero)) != 0xFFFF) {
+                break;
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + done), _mm_packus_epi16(a, b));
+        }
+#elif defined(TS_SIMD_NEON)
+        for (; done + 16 <= count; done += 16) {
+            const uint16x8_t a = vld1q_u16(reinterpret_cast<const uint16_t*>(in + done));
+            const uint16x8_t b = vld1q_u16(reinterpret_cast<const uint16_t*>(in + done + 8));
+            if (vmaxvq_u16(vorrq_u16(a, b)) >= 0x80) {
+                break;
+            }
+            vst1q_u8(reinterpret_cast<uint8_t*>(out + done), vcombine_u8(vmovn_u16(a), vmovn_u16(b)));
+        }
+#endif
+        return done;
+    }
+
+    inline size_t ConvertASCIIBlocks([[maybe_unused]] const char* in, [[maybe_unused]] ts::UChar* out, [[maybe_unused]] size_t count)
+    {
+        size_t done = 0;
+#if defined(TS_SIMD_SSE2)
+        const __m128i zero = _mm_setzero_si128();
+        for (; done + 16 <= count; done += 16) {
+            const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + done));
+            if (_mm_movemask_epi8(a) != 0) {
+                break;
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + done), _mm_unpacklo_epi8(a, zero));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + done + 8), _mm_unpackhi_epi8(a, zero));
+        }
+#elif defined(TS_SIMD_NEON)
+        for (; done + 16 <= count; done += 16) {
+            const uint8x16_t a = vld1q_u8(reinterpret_cast<const uint8_t*>(in + done));
+            if (vmaxvq_u8(a) >= 0x80) {
+                break;
+            }
+            vst1q_u16(reinterpret_cast<uint16_t*>(out + done), vmovl_u8(vget_low_u8(a)));
+            vst1q_u16(reinterpret_cast<uint16_t*>(out + done + 8), vmovl_high_u8(a));
+        }
+#endif
+        return done;
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // General routine to convert from UTF-16 to UTF-8.
 //----------------------------------------------------------------------------
@@ -89,6 +164,16 @@ void ts::UString::ConvertUTF16ToUTF8(const UChar*& inStart, const UChar* inEnd,
 
     while (inStart < inEnd && outStart < outEnd) {
 
+        // Fast path for long sequences of ASCII characters, the most common case.
+        if (*inStart < 0x0080) {
+            const size_t count = ConvertASCIIBlocks(inStart, outStart, std::min<size_t>(inEnd - inStart, outEnd - outStart));
+            inStart += count;
+            outStart += count;
+            if (inStart >= inEnd || outStart >= outEnd) {
+                break;
+            }
+        }
+
         // Get current code point as 16-bit value.
         code = *inStart++;
 
@@ -170,23 +255,12 @@ void ts::UString::ConvertUTF16ToUTF8(const UChar*& inStart, const UChar* inEnd,
 
 std::ostream& operator<<(std::ostream& strm, const ts::UChar c)
 {
-    // See comments in ConvertUTF16ToUTF8().
-    if ((c & 0xF800) == 0xD800) {
-        // Part of a surrogate pair, cannot be displayed alone.
-        return strm;
-    }
-    else if (c < 0x0080) {
-        // ASCII compatible value, one byte encoding.
-        return strm << char(c);
-    }
-    else if (c < 0x0800) {
-        // 2 bytes encoding.
-        return strm << char(0x80 | (c & 0x3F)) << char(0xC0 | (c & 0x1F));
-    }
-    else {
-        // 3 bytes encoding.
-        return strm << char(0x80 | (c & 0x3F)) << char(0x80 | (c & 0x3F)) << char(0xE0 | (c & 0x0F));
-    }
+    // A part of a surrogate pair cannot be displayed alone and produces nothing.
+    char buffer[3];
+    const ts::UChar* in = &c;
+    char* out = buffer;
+    ts::UString::ConvertUTF16ToUTF8(in, in + 1, out, buffer + sizeof(buffer));
+    return strm.write(buffer, out - buffer);
 }
 
 
@@ -200,6 +274,16 @@ void ts::UString::ConvertUTF8ToUTF16(const char*& inStart, const char* inEnd, UC
 
     while (inStart < inEnd && outStart < outEnd) {
 
+        // Fast path for long sequences of ASCII characters, the most common case.
+        if ((*inStart & 0x80) == 0) {
+            const size_t count = ConvertASCIIBlocks(inStart, outStart, std::min<size_t>(inEnd - inStart, outEnd - outStart));
+            inStart += count;
+            outStart += count;
+            if (inStart >= inEnd || outStart >= outEnd) {
+                break;
+            }
+        }
+
         // Get current code point at 8-bit value.
         code = *inStart++ & 0xFF;
 
@@ -345,6 +429,30 @@ ts::UString& ts::UString::assignFromUTF8(const char* utf8, size_type count)
 }
 
 
+//----------------------------------------------------------------------------
+// Append an UTF-8 string to this object.
+//----------------------------------------------------------------------------
+
+ts::UString& ts::UString::appendUTF8(const char* utf8)
+{
+    return appendUTF8(utf8, utf8 == nullptr ? 0 : std::strlen(utf8));
+}
+
+ts::UString& ts::UString::appendUTF8(const char* utf8, size_type count)
+{
+    if (utf8 != nullptr && count > 0) {
+        // Same principle as assignFromUTF8(), directly at the end of this object.
+        const size_type previous = size();
+        resize(previous + count);
+        const char* inStart = utf8;
+        UChar* outStart = data() + previous;
+        ConvertUTF8ToUTF16(inStart, inStart + count, outStart, outStart + count);
+        resize(outStart - data());
+    }
+    return *this;
+}
+
+
 //----------------------------------------------------------------------------
 // Convert this UTF-16 string into UTF-8.
 //----------------------------------------------------------------------------
@@ -373,18 +481,33 @@ std::string ts::UString::toUTF8() const
 // Output operator for ts::UString on standard text streams with UTF-8 conv.
 //----------------------------------------------------------------------------
 
+namespace {
+    // Write an UTF-16 string on a text stream, without heap allocation.
+    std::ostream& WriteUTF8(std::ostream& strm, const ts::UChar* in, const ts::UChar* end)
+    {
+        if (strm.width() != 0) {
+            // Need the complete string to apply the field width and padding.
+            return strm << ts::UString(in, end - in).toUTF8();
+        }
+        // Convert and write the string by chunks.
+        char buffer[1024];
+        while (in < end && strm) {
+            char* out = buffer;
+            ts::UString::ConvertUTF16ToUTF8(in, end, out, buffer + sizeof(buffer));
+            strm.write(buffer, out - buffer);
+        }
+        return strm;
+    }
+}
+
 std::ostream& operator<<(std::ostream& strm, const ts::UString& str)
 {
-    std::string utf8;
-    str.toUTF8(utf8);
-    return strm << utf8;
+    return WriteUTF8(strm, str.data(), str.data() + str.size());
 }
 
 std::ostream& operator<<(std::ostream& strm, const ts::UChar* str)
 {
-    std::string utf8;
-    ts::UString(str).toUTF8(utf8);
-    return strm << utf8;
+    return str == nullptr ? strm : WriteUTF8(strm, str, str + std::char_traits<ts::UChar>::length(str));
 }
 
 
@@ -2054,6 +2177,24 @@ ts::UString::ArgMixInContext::ArgMixInContext(UString& result, const UChar* fmt,
     }
 }
 
+// Append a plain decimal integer, without intermediate string.
+namespace {
+    void AppendDecimal(ts::UString& result, uint64_t value, bool negative)
+    {
+        ts::UChar buffer[24];
+        ts::UChar* const end = buffer + sizeof(buffer) / sizeof(buffer[0]);
+        ts::UChar* start = end;
+        do {
+            *--start = ts::UChar(u'0' + value % 10);
+            value /= 10;
+        } while (value != 0);
+        if (negative) {
+            *--start = u'-';
+        }
+        result.append(start, end - start);
+    }
+}
+
 // Anciliary function to process one '%' sequence.
 void ts::UString::ArgMixInContext::processArg()
 {
@@ -2174,7 +2315,19 @@ void ts::UString::ArgMixInContext::processArg()
     }
 
     // Now, the command is valid, process it.
-    if (argit->isAnyString() || ((argit->isBool() || argit->isChrono()) && cmd == u's') || ((argit->isInteger() || argit->isAbstractNumber()) && cmd == u'n')) {
+    if (argit->isAnyString() && minWidth == 0 && maxWidth == std::numeric_limits<size_t>::max()) {
+        // Most common case, a string without field width, directly appended to the result.
+        if (cmd != u's' && debugActive()) {
+            debug(u"type mismatch, got a string", cmd);
+        }
+        if (argit->isAnyString8()) {
+            _result.appendUTF8(argit->toCharPtr());
+        }
+        else {
+            _result.append(argit->toUCharPtr());
+        }
+    }
+    else if (argit->isAnyString() || ((argit->isBool() || argit->isChrono()) && cmd == u's') || ((argit->isInteger() || argit->isAbstractNumber()) && cmd == u'n')) {
         // String arguments are always treated as %s, regardless of the % command.
         // Also if a bool is specified as %s, print true or false.
         if (argit->isAnyString() && cmd != u's' && debugActive()) {
@@ -2290,6 +2443,16 @@ void ts::UString::ArgMixInContext::processArg()
             // Format AbstractNumber without decimals.
             _result.append(argit->toAbstractNumber().toString(minWidth, !leftJustified, separatorChar, forceSign, 0, true, FULL_STOP, pad));
         }
+        else if (minWidth == 0 && !useSeparator && !forceSign) {
+            // Most common case, a plain decimal integer.
+            if (argit->isSigned()) {
+                const int64_t value = argit->toInt64();
+                AppendDecimal(_result, value < 0 ? 0 - uint64_t(value) : uint64_t(value), value < 0);
+            }
+            else {
+                AppendDecimal(_result, argit->toUInt64(), false);
+            }
+        }
         else if (argit->size() > 4) {
             // Stored as 64-bit integer.
             if (argit->isSigned()) {
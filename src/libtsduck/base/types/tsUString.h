@@ -448,6 +448,32 @@ namespace ts {
         //!
         UString& assignFromUTF8(const char* utf8, size_type count);
 
+        //!
+        //! Append an UTF-8 string to this object.
+        //! The UTF-8 string is directly converted at the end of this object, without intermediate string.
+        //! @param [in] utf8 A string in UTF-8 representation.
+        //! @return A reference to this object.
+        //!
+        UString& appendUTF8(const std::string& utf8)
+        {
+            return appendUTF8(utf8.data(), utf8.size());
+        }
+
+        //!
+        //! Append an UTF-8 string to this object.
+        //! @param [in] utf8 Address of a nul-terminated string in UTF-8 representation. Can be null.
+        //! @return A reference to this object.
+        //!
+        UString& appendUTF8(const char* utf8);
+
+        //!
+        //! Append an UTF-8 string to this object.
+        //! @param [in] utf8 Address of a string in UTF-8 representation. Can be null.
+        //! @param [in] count Size in bytes of the UTF-8 string (not necessarily a number of characters).
+        //! @return A reference to this object.
+        //!
+        UString& appendUTF8(const char* utf8, size_type count);
+
         //!
         //! Convert this UTF-16 string into UTF-8.
         //! @return The equivalent UTF-8 string.
@@ -2428,10 +2454,10 @@ namespace ts {
         bool operator!=(const char* other) const { return !operator==(other); }
 #endif
 
-        UString& append(const std::string& str) { return append(FromUTF8(str)); }
+        UString& append(const std::string& str) { return appendUTF8(str); }
         UString& append(const std::string& str, size_type pos, size_type count = NPOS) { return append(FromUTF8(str.substr(pos, count))); }
-        UString& append(const char* s, size_type count) { return append(FromUTF8(s, count)); }
-        UString& append(const char* s) { return append(FromUTF8(s)); }
+        UString& append(const char* s, size_type count) { return appendUTF8(s, count); }
+        UString& append(const char* s) { return appendUTF8(s); }
 
         UString& operator+=(const std::string& s) { return append(s); }
         UString& operator+=(const char* s) { return append(s); }
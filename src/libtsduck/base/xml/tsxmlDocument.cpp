@@ -222,7 +222,10 @@ bool ts::xml::Document::save(const fs::path& fileName, size_t indent)
     }
 
     print(out);
-    out.close();
+    if (!out.close()) {
+        report().error(u"error writing %s", fileName);
+        return false;
+    }
     return true;
 }
 
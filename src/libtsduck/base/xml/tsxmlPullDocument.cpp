@@ -0,0 +1,338 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2024, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+
+#include "tsxmlPullDocument.h"
+#include "tsxmlElement.h"
+
+
+//----------------------------------------------------------------------------
+// Constructors and destructors.
+//----------------------------------------------------------------------------
+
+ts::xml::PullDocument::PullDocument(Report& report) :
+    Document(report)
+{
+}
+
+ts::xml::PullDocument::~PullDocument()
+{
+    close();
+}
+
+
+//----------------------------------------------------------------------------
+// Close the document.
+//----------------------------------------------------------------------------
+
+void ts::xml::PullDocument::close()
+{
+    _file.close();
+    _buffer.clear();
+    _buffer.shrink_to_fit();
+    _text = std::string_view();
+    _pos = 0;
+    _line = 1;
+    _valid = false;
+    _at_end = false;
+    Document::clear();
+}
+
+
+//----------------------------------------------------------------------------
+// Open an XML document.
+//----------------------------------------------------------------------------
+
+ts::xml::Element* ts::xml::PullDocument::open(const UString& fileName)
+{
+    // Specific case of inline XML content and standard input.
+    if (IsInlineXML(fileName)) {
+        close();
+        _buffer = fileName.toUTF8();
+        _text = _buffer;
+        return openText();
+    }
+    else if (fileName.empty() || fileName == u"-") {
+        return open(std::cin);
+    }
+
+    // Map the input file in memory.
+    close();
+    report().debug(u"loading XML file %s", fileName);
+    if (!_file.open(fileName, report())) {
+        return nullptr;
+    }
+    _text = std::string_view(reinterpret_cast<const char*>(_file.data()), _file.size());
+    return openText();
+}
+
+ts::xml::Element* ts::xml::PullDocument::open(std::istream& strm)
+{
+    close();
+    _buffer.assign(std::istreambuf_iterator<char>(strm), std::istreambuf_iterator<char>());
+    if (strm.bad()) {
+        report().error(u"error reading input document");
+        return nullptr;
+    }
+    _text = _buffer;
+    return openText();
+}
+
+
+//----------------------------------------------------------------------------
+// Parse the beginning of the document, up to the start of the root element.
+//----------------------------------------------------------------------------
+
+ts::xml::Element* ts::xml::PullDocument::openText()
+{
+    _valid = true;
+
+    // Skip the optional UTF-8 byte order mark.
+    const size_t bom_size = match(0, "\xEF\xBB\xBF") ? 3 : 0;
+    _pos = bom_size;
+
+    // Skip declarations, comments and DTD before the root element.
+    size_t start = _text.find('<', _pos);
+    while (start != NPOS && (match(start, "<?") || match(start, "<!"))) {
+        size_t depth = 0;
+        const size_t end = endOfMarkup(start, depth);
+        start = end == NPOS ? NPOS : _text.find('<', end);
+    }
+    if (start == NPOS || match(start, "</")) {
+        return invalid(u"invalid XML document, no root element found");
+    }
+
+    // Locate the end of the start tag of the root element.
+    const size_t tag_end = endOfTag(start + 1);
+    if (tag_end == NPOS) {
+        moveTo(start);
+        return invalid(UString::Format(u"line %d: unterminated tag, invalid XML document", _line));
+    }
+    _at_end = _text[tag_end - 2] == '/';
+
+    // Parse the beginning of the document as a complete document with an empty root element.
+    UString text(UString::FromUTF8(_text.data() + bom_size, tag_end - bom_size));
+    if (!_at_end) {
+        const size_t name_start = start + 1;
+        const size_t name_end = std::min(tag_end - 1, _text.find_first_of(" \t\r\n/>", name_start));
+        text.append(u"</");
+        text.append(UString::FromUTF8(_text.data() + name_start, name_end - name_start));
+        text.append(u">");
+    }
+    if (!Document::parse(text)) {
+        _valid = false;
+        return nullptr;
+    }
+
+    // Now positioned after the start tag of the root element.
+    moveTo(tag_end);
+    if (_at_end && !checkTrailer()) {
+        return nullptr;
+    }
+    return rootElement();
+}
+
+
+//----------------------------------------------------------------------------
+// Parse the next child element of the root element.
+//----------------------------------------------------------------------------
+
+ts::xml::Element* ts::xml::PullDocument::next()
+{
+    Element* root = rootElement();
+    if (root == nullptr) {
+        return nullptr;
+    }
+
+    // Delete all previous children of the root.
+    Node* child = nullptr;
+    while ((child = root->firstChild()) != nullptr) {
+        // Deallocating the node forces the removal from the document through the destructor.
+        delete child;
+    }
+    if (!_valid || _at_end) {
+        return nullptr;
+    }
+
+    // Look for the next child element, skipping text, comments, etc.
+    for (;;) {
+        const size_t start = _text.find('<', _pos);
+        if (start == NPOS) {
+            moveTo(_text.size());
+            return invalid(UString::Format(u"line %d: unexpected end of document, expected </%s>", _line, root->name()));
+        }
+        moveTo(start);
+
+        if (match(start, "</")) {
+            // End of the root element.
+            const size_t end = endOfTag(start + 2);
+            const size_t name_start = _text.find_first_not_of(" \t\r\n", start + 2);
+            const size_t name_end = end == NPOS ? NPOS : std::max(name_start, std::min(end - 1, _text.find_first_of(" \t\r\n>", name_start)));
+            if (end == NPOS || !UString::FromUTF8(_text.data() + name_start, name_end - name_start).similar(root->name())) {
+                return invalid(UString::Format(u"line %d: parsing error, expected </%s> to match <%s> at line %d", _line, root->name(), root->name(), root->lineNumber()));
+            }
+            moveTo(end);
+            _at_end = true;
+            checkTrailer();
+            return nullptr;
+        }
+        else if (match(start, "<?") || match(start, "<!")) {
+            // Comment, processing instruction, text as CDATA: not an element, skip it.
+            size_t depth = 0;
+            const size_t end = endOfMarkup(start, depth);
+            if (end == NPOS) {
+                return invalid(UString::Format(u"line %d: unterminated markup, invalid XML document", _line));
+            }
+            moveTo(end);
+        }
+        else {
+            // Start of a child element, locate the end of the element.
+            size_t depth = 0;
+            size_t end = start;
+            do {
+                end = endOfMarkup(end, depth);
+                if (end != NPOS && depth > 0) {
+                    end = _text.find('<', end);
+                }
+            } while (end != NPOS && depth > 0);
+            if (end == NPOS) {
+                return invalid(UString::Format(u"line %d: unterminated element, invalid XML document", _line));
+            }
+
+            // Parse the element, with the right line numbers, as a child of the document.
+            TextParser parser(report());
+            parser.loadDocument(UString::FromUTF8(_text.data() + start, end - start), _line);
+            moveTo(end);
+            Node* const last = lastChild();
+            const bool ok = parseChildren(parser);
+            Element* const elem = lastChild() == last ? nullptr : dynamic_cast<Element*>(lastChild());
+            if (!ok || elem == nullptr) {
+                _valid = false;
+                return nullptr;
+            }
+
+            // Move the new element under the root.
+            elem->reparent(root);
+            return elem;
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Skip spaces and comments after the root element.
+//----------------------------------------------------------------------------
+
+bool ts::xml::PullDocument::checkTrailer()
+{
+    for (;;) {
+        const size_t pos = _text.find_first_not_of(" \t\r\n", _pos);
+        if (pos == NPOS) {
+            moveTo(_text.size());
+            return true;
+        }
+        moveTo(pos);
+        const size_t end = match(pos, "<!--") ? after(pos + 4, "-->") : NPOS;
+        if (end == NPOS) {
+            invalid(UString::Format(u"line %d: trailing character sequence, invalid XML document", _line));
+            return false;
+        }
+        moveTo(end);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Scanning the UTF-8 text.
+//----------------------------------------------------------------------------
+
+void ts::xml::PullDocument::moveTo(size_t pos)
+{
+    pos = std::min(pos, _text.size());
+    if (pos > _pos) {
+        _line += std::count(_text.begin() + _pos, _text.begin() + pos, '\n');
+    }
+    _pos = pos;
+}
+
+bool ts::xml::PullDocument::match(size_t pos, const std::string_view& str) const
+{
+    return pos <= _text.size() && _text.substr(pos, str.size()) == str;
+}
+
+size_t ts::xml::PullDocument::after(size_t pos, const std::string_view& str) const
+{
+    const size_t found = pos > _text.size() ? NPOS : _text.find(str, pos);
+    return found == NPOS ? NPOS : found + str.size();
+}
+
+size_t ts::xml::PullDocument::endOfTag(size_t pos) const
+{
+    // Attribute values may contain '>' characters.
+    while ((pos = _text.find_first_of("\"'>", pos)) != NPOS) {
+        if (_text[pos] == '>') {
+            return pos + 1;
+        }
+        // Skip quoted attribute value.
+        pos = _text.find(_text[pos], pos + 1);
+        if (pos == NPOS) {
+            break;
+        }
+        pos++;
+    }
+    return NPOS;
+}
+
+size_t ts::xml::PullDocument::endOfMarkup(size_t pos, size_t& depth) const
+{
+    if (match(pos, "<!--")) {
+        return after(pos + 4, "-->");
+    }
+    else if (match(pos, "<![CDATA[")) {
+        return after(pos + 9, "]]>");
+    }
+    else if (match(pos, "<?")) {
+        return after(pos + 2, "?>");
+    }
+    else if (match(pos, "<!")) {
+        // DTD, possibly with an internal subset between brackets.
+        size_t end = _text.find_first_of("[>", pos + 2);
+        if (end != NPOS && _text[end] == '[') {
+            end = _text.find(']', end);
+            end = end == NPOS ? NPOS : _text.find('>', end);
+        }
+        return end == NPOS ? NPOS : end + 1;
+    }
+    else if (match(pos, "</")) {
+        // End tag.
+        const size_t end = endOfTag(pos + 2);
+        if (end != NPOS && depth > 0) {
+            depth--;
+        }
+        return end;
+    }
+    else {
+        // Start tag, possibly without content.
+        const size_t end = endOfTag(pos + 1);
+        if (end != NPOS && _text[end - 2] != '/') {
+            depth++;
+        }
+        return end;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Report an error and invalidate the document.
+//----------------------------------------------------------------------------
+
+ts::xml::Element* ts::xml::PullDocument::invalid(const UString& message)
+{
+    report().error(message);
+    _valid = false;
+    return nullptr;
+}
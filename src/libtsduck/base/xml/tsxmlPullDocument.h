@@ -0,0 +1,133 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2024, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Representation of an XML document which is parsed element by element.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsxmlDocument.h"
+#include "tsMemoryMappedFile.h"
+
+namespace ts {
+    namespace xml {
+        //!
+        //! Representation of an XML document which is parsed element by element.
+        //! @ingroup xml
+        //!
+        //! This is the input counterpart of ts::xml::RunningDocument. The idea is to process
+        //! an arbitrary large XML document, typically a list of tables in a section file,
+        //! without loading the complete document in memory. The document is parsed one
+        //! child of the root element at a time, in "pull" mode. When the application gets
+        //! the next child, the previous ones are deleted.
+        //!
+        //! The input file is mapped in memory (when supported by the operating system) and
+        //! is scanned in its UTF-8 representation. Only the current child element is converted
+        //! in the internal representation of XML nodes. Therefore, the memory usage depends on
+        //! the size of the largest child element, not on the size of the document.
+        //!
+        //! The document contains the initial declarations, the root element with its attributes
+        //! and the current child element of the root. Any processing which applies to a document
+        //! (validation using a ts::xml::ModelDocument for instance) can be applied to the document
+        //! after each call to next().
+        //!
+        class TSDUCKDLL PullDocument: public Document
+        {
+            TS_NOCOPY(PullDocument);
+        public:
+            //!
+            //! Constructor.
+            //! @param [in,out] report Where to report errors.
+            //!
+            explicit PullDocument(Report& report = NULLREP);
+
+            //!
+            //! Destructor.
+            //!
+            virtual ~PullDocument() override;
+
+            //!
+            //! Open an XML document and parse it up to the start of the root element.
+            //! @param [in] fileName Name of the XML file to load. If the file name starts with "<?xml",
+            //! this is considered as "inline XML content". If the file name is empty or "-", the standard
+            //! input is used.
+            //! @return The root element of the document, without children, or null on error.
+            //!
+            Element* open(const UString& fileName);
+
+            //!
+            //! Open an XML document from an input stream and parse it up to the start of the root element.
+            //! @param [in,out] strm A standard text stream in input mode. The complete stream is read.
+            //! @return The root element of the document, without children, or null on error.
+            //!
+            Element* open(std::istream& strm);
+
+            //!
+            //! Parse the next child element of the root element.
+            //! The previous child elements of the root are deleted.
+            //! @return The next child element of the root, or null at end of document or on error.
+            //! @see isValid()
+            //!
+            Element* next();
+
+            //!
+            //! Check if the document is valid so far.
+            //! @return False if an error was found in the document, true otherwise.
+            //! When next() returns null, the document was entirely parsed when this method returns true.
+            //!
+            bool isValid() const { return _valid; }
+
+            //!
+            //! Check if the input file is mapped in memory.
+            //! @return True if the input file is mapped in memory.
+            //!
+            bool isMemoryMapped() const { return _file.isMapped(); }
+
+            //!
+            //! Close the document.
+            //! The input file, if any, is closed and the document is cleared.
+            //!
+            void close();
+
+        private:
+            MemoryMappedFile _file {};       // Input file, when mapped.
+            std::string      _buffer {};     // Input text, when not from a file.
+            std::string_view _text {};       // Complete UTF-8 input text.
+            size_t           _pos = 0;       // Current position in _text.
+            size_t           _line = 1;      // Line number at _pos.
+            bool             _valid = false; // No error so far.
+            bool             _at_end = false;// End of root element was found.
+
+            // Parse the beginning of the document, after loading the text.
+            Element* openText();
+
+            // Move _pos to a given position, updating the line number.
+            void moveTo(size_t pos);
+
+            // Check if the text at a given position starts with a string.
+            bool match(size_t pos, const std::string_view& str) const;
+
+            // Find the position after a string, starting at a given position. Return NPOS if not found.
+            size_t after(size_t pos, const std::string_view& str) const;
+
+            // Find the end of a start or end tag, starting inside the tag, skipping quoted values. Return NPOS if not found.
+            size_t endOfTag(size_t pos) const;
+
+            // Find the end of markup (comment, CDATA, processing instruction, DTD, tag) at a given position.
+            // Update the depth of elements. Return NPOS if not found.
+            size_t endOfMarkup(size_t pos, size_t& depth) const;
+
+            // Skip spaces, comments and processing instructions after the root element. Return false on other content.
+            bool checkTrailer();
+
+            // Report an error and invalidate the document.
+            Element* invalid(const UString& message);
+        };
+    }
+}
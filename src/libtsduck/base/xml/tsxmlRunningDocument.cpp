@@ -89,7 +89,7 @@ void ts::xml::RunningDocument::flush()
 // Close the running document.
 //----------------------------------------------------------------------------
 
-void ts::xml::RunningDocument::close()
+bool ts::xml::RunningDocument::close()
 {
     // Close the document structure if currently open.
     if (_open_root) {
@@ -98,8 +98,9 @@ void ts::xml::RunningDocument::close()
     }
 
     // Close the associated text formatter.
-    _text.close();
+    const bool success = _text.close();
 
     // Clear the document itself using the superclass.
     Document::clear();
+    return success;
 }
@@ -67,8 +67,9 @@ namespace ts {
             //! Close the running document.
             //! If the XML structure is still open, it is closed.
             //! The output file, if any, is closed.
+            //! @return True on success, false if an output error occurred.
             //!
-            void close();
+            bool close();
 
         private:
             TextFormatter _text;      // The text formatter.
@@ -0,0 +1,94 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2024, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//
+// Implementation of the DVB-CSA2 bitsliced stream cipher using accelerated
+// instructions, when available. This module is compiled with special options
+// to use optional instructions for the target architecture. It may fail when
+// these instructions are not implemented in the current CPU. Consequently,
+// this module shall not be called when these instructions are not implemented.
+//
+//----------------------------------------------------------------------------
+
+#include "tsDVBCSA2.h"
+#include "tsCryptoAcceleration.h"
+
+// Check if AVX2 instructions can be used (the module is compiled with -mavx2 on x86_64).
+#if defined(__AVX2__) && !defined(TS_NO_SIMD_INSTRUCTIONS)
+    #define TS_SIMD_AVX2 1
+    #include <immintrin.h>
+    #include "tsDVBCSA2Bitslice.h"
+#endif
+
+// "Hidden" exported bool to inform the DVBCSA2 class that we have compiled accelerated instructions.
+extern const bool tsDVBCSA2IsAccelerated =
+#if defined(TS_SIMD_AVX2)
+    true;
+#else
+    false;
+#endif
+
+// Don't complain about assert(false) when acceleration is not implemented.
+TS_LLVM_NOWARNING(missing-noreturn)
+
+
+//----------------------------------------------------------------------------
+// 256-bit word, one lane per bit.
+//----------------------------------------------------------------------------
+
+#if defined(TS_SIMD_AVX2)
+namespace {
+    struct AccelWord
+    {
+        static constexpr size_t LANES = 256;
+        __m256i v {_mm256_setzero_si256()};
+        AccelWord() = default;
+        AccelWord(__m256i x) : v(x) {}
+        static AccelWord Ones() { return _mm256_set1_epi32(-1); }
+        static AccelWord Load(const uint64_t* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+        void store(uint64_t* p) const { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+        AccelWord operator~() const { return _mm256_xor_si256(v, _mm256_set1_epi32(-1)); }
+        AccelWord operator&(const AccelWord& x) const { return _mm256_and_si256(v, x.v); }
+        AccelWord operator|(const AccelWord& x) const { return _mm256_or_si256(v, x.v); }
+        AccelWord operator^(const AccelWord& x) const { return _mm256_xor_si256(v, x.v); }
+        AccelWord& operator^=(const AccelWord& x) { v = _mm256_xor_si256(v, x.v); return *this; }
+    };
+}
+
+static_assert(ts::DVBCSA2::MAX_BATCH_SIZE >= AccelWord::LANES);
+#endif
+
+
+//----------------------------------------------------------------------------
+// Number of data blocks which are processed in parallel.
+//----------------------------------------------------------------------------
+
+size_t ts::DVBCSA2::AccelBatchSize()
+{
+#if defined(TS_SIMD_AVX2)
+    return AccelWord::LANES;
+#else
+    // Shall not be called.
+    assert(false);
+    return 0;
+#endif
+}
+
+
+//----------------------------------------------------------------------------
+// Apply the bitsliced stream cipher on at most AccelBatchSize() data blocks.
+//----------------------------------------------------------------------------
+
+void ts::DVBCSA2::streamCipherBatchAccel(uint8_t* const lanes[], const size_t sizes[], size_t count) const
+{
+#if defined(TS_SIMD_AVX2)
+    BitslicedStreamCipherBatch<AccelWord>(_key, lanes, sizes, count);
+#else
+    // Shall not be called.
+    assert(false);
+#endif
+}
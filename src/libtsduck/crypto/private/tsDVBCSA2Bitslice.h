@@ -0,0 +1,457 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2024, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Bitsliced implementation of the DVB-CSA2 stream cipher.
+//!
+//!  The stream cipher is applied in parallel on several data blocks with the
+//!  same key. Each bit of the state of the stream cipher becomes a word, each
+//!  bit of the word being the state bit for one data block (one "lane").
+//!
+//!  The code is a template on the word type and is included in the modules
+//!  which implement the various word sizes. Everything is in an anonymous
+//!  namespace: each module, possibly compiled with specific instruction sets,
+//!  keeps its own private instances.
+//!
+//!  A WORD class shall provide:
+//!  - static constexpr size_t LANES: number of bits in a word, multiple of 64.
+//!  - default constructor to zero, copy, operators ~ & | ^ ^=.
+//!  - static WORD Ones(): all bits set.
+//!  - static WORD Load(const uint64_t*): load from LANES/64 integers, lane n is bit n%64 of integer n/64.
+//!  - void store(uint64_t*) const: reverse operation.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsPlatform.h"
+
+namespace {
+
+    // Bitsliced versions of the S-boxes of the stream cipher.
+    // The boolean expressions were generated from the tables sbox1 to sbox7.
+
+    // S-box 1: x4..x0 are the bits of the index in sbox1, y1 and y0 are the bits of the result.
+    template <class WORD>
+    inline void BitslicedSbox1(WORD x4, WORD x3, WORD x2, WORD x1, WORD x0, WORD& y1, WORD& y0)
+    {
+        const WORD t1 = (~x0 & ~x1);
+        const WORD t2 = (~x0 | ~x1);
+        const WORD t3 = (t1 ^ ((t1 ^ t2) & x2));
+        const WORD t4 = (x1 & x0);
+        const WORD t5 = (t2 ^ x2);
+        const WORD t6 = (t3 ^ ((t3 ^ t5) & x3));
+        const WORD t7 = (x0 ^ x1);
+        const WORD t8 = (t7 ^ ((t7 ^ ~x1) & x2));
+        const WORD t9 = (x0 | ~x1);
+        const WORD t11 = (t9 ^ x2);
+        const WORD t12 = (t8 ^ ((t8 ^ t11) & x3));
+        const WORD t13 = (t6 ^ ((t6 ^ t12) & x4));
+        const WORD t14 = (x1 ^ ((x1 ^ t7) & x2));
+        const WORD t15 = (t1 ^ ((t1 ^ t9) & x2));
+        const WORD t16 = (t14 ^ ((t14 ^ t15) & x3));
+        const WORD t17 = (t7 ^ ((t7 ^ x1) & x2));
+        const WORD t18 = (t4 ^ x2);
+        const WORD t19 = (t17 ^ ((t17 ^ t18) & x3));
+        const WORD t20 = (t16 ^ ((t16 ^ t19) & x4));
+        y1 = t13;
+        y0 = t20;
+    }
+
+    // S-box 2: x4..x0 are the bits of the index in sbox2, y1 and y0 are the bits of the result.
+    template <class WORD>
+    inline void BitslicedSbox2(WORD x4, WORD x3, WORD x2, WORD x1, WORD x0, WORD& y1, WORD& y0)
+    {
+        const WORD t1 = (~x0 ^ x1);
+        const WORD t2 = (~x0 | ~x1);
+        const WORD t3 = (t1 ^ ((t1 ^ t2) & x2));
+        const WORD t4 = (x0 ^ x1);
+        const WORD t5 = (x1 & x0);
+        const WORD t7 = (t3 ^ x3);
+        const WORD t8 = (x0 | ~x1);
+        const WORD t9 = (t1 ^ ((t1 ^ t8) & x2));
+        const WORD t10 = (t5 ^ ((t5 ^ ~x0) & x2));
+        const WORD t11 = (t9 ^ ((t9 ^ t10) & x3));
+        const WORD t12 = (t7 ^ ((t7 ^ t11) & x4));
+        const WORD t13 = (~x1 ^ ((~x1 ^ t4) & x2));
+        const WORD t15 = (t8 ^ x2);
+        const WORD t16 = (t13 ^ ((t13 ^ t15) & x3));
+        const WORD t17 = (~x0 & ~x1);
+        const WORD t18 = (t8 ^ ((t8 ^ t17) & x2));
+        const WORD t21 = (t18 ^ x3);
+        const WORD t22 = (t16 ^ ((t16 ^ t21) & x4));
+        y1 = t12;
+        y0 = t22;
+    }
+
+    // S-box 3: x4..x0 are the bits of the index in sbox3, y1 and y0 are the bits of the result.
+    template <class WORD>
+    inline void BitslicedSbox3(WORD x4, WORD x3, WORD x2, WORD x1, WORD x0, WORD& y1, WORD& y0)
+    {
+        const WORD t1 = (~x0 ^ x1);
+        const WORD t2 = (~x0 | ~x1);
+        const WORD t3 = (t1 ^ ((t1 ^ t2) & x2));
+        const WORD t4 = (x1 & x0);
+        const WORD t5 = (t4 ^ ((t4 ^ ~x0) & x2));
+        const WORD t6 = (t3 ^ ((t3 ^ t5) & x3));
+        const WORD t7 = (x0 & ~x1);
+        const WORD t9 = (t7 ^ x2);
+        const WORD t11 = (t1 ^ x2);
+        const WORD t12 = (t9 ^ ((t9 ^ t11) & x3));
+        const WORD t13 = (t6 ^ ((t6 ^ t12) & x4));
+        const WORD t14 = (x1 & ~x0);
+        const WORD t15 = (x0 | x1);
+        const WORD t16 = (t14 ^ ((t14 ^ t15) & x2));
+        const WORD t20 = (t16 ^ x3);
+        const WORD t22 = (t20 ^ x4);
+        y1 = t13;
+        y0 = t22;
+    }
+
+    // S-box 4: x4..x0 are the bits of the index in sbox4, y1 and y0 are the bits of the result.
+    template <class WORD>
+    inline void BitslicedSbox4(WORD x4, WORD x3, WORD x2, WORD x1, WORD x0, WORD& y1, WORD& y0)
+    {
+        const WORD t1 = (~x0 | x1);
+        const WORD t2 = (t1 ^ ((t1 ^ x0) & x2));
+        const WORD t3 = (x0 & ~x1);
+        const WORD t4 = (~x0 ^ x1);
+        const WORD t5 = (t3 ^ ((t3 ^ t4) & x2));
+        const WORD t6 = (t2 ^ ((t2 ^ t5) & x3));
+        const WORD t7 = (x1 & ~x0);
+        const WORD t8 = (x0 | ~x1);
+        const WORD t9 = (t7 ^ x2);
+        const WORD t10 = (x0 ^ x1);
+        const WORD t11 = (t9 ^ ((t9 ^ t10) & x3));
+        const WORD t12 = (t6 ^ ((t6 ^ t11) & x4));
+        const WORD t13 = (t8 ^ x2);
+        const WORD t14 = (t13 ^ ((t13 ^ t4) & x3));
+        const WORD t15 = (t14 ^ ((t14 ^ t6) & x4));
+        y1 = t12;
+        y0 = t15;
+    }
+
+    // S-box 5: x4..x0 are the bits of the index in sbox5, y1 and y0 are the bits of the result.
+    template <class WORD>
+    inline void BitslicedSbox5(WORD x4, WORD x3, WORD x2, WORD x1, WORD x0, WORD& y1, WORD& y0)
+    {
+        const WORD t1 = (~x0 & ~x1);
+        const WORD t2 = (t1 | x2);
+        const WORD t3 = (x1 & ~x0);
+        const WORD t4 = (x1 ^ ((x1 ^ t3) & x2));
+        const WORD t5 = (t2 ^ ((t2 ^ t4) & x3));
+        const WORD t6 = (~x0 | ~x1);
+        const WORD t7 = (x0 & ~x1);
+        const WORD t8 = (t6 ^ ((t6 ^ t7) & x2));
+        const WORD t9 = (~x0 ^ x1);
+        const WORD t10 = (x1 ^ ((x1 ^ t9) & x2));
+        const WORD t11 = (t8 ^ ((t8 ^ t10) & x3));
+        const WORD t12 = (t5 ^ ((t5 ^ t11) & x4));
+        const WORD t13 = (x1 & x0);
+        const WORD t14 = (t13 ^ ((t13 ^ ~x0) & x2));
+        const WORD t15 = (x0 | x1);
+        const WORD t16 = (t15 ^ ((t15 ^ t9) & x2));
+        const WORD t17 = (t14 ^ ((t14 ^ t16) & x3));
+        const WORD t18 = (t7 ^ ((t7 ^ t15) & x2));
+        const WORD t19 = (~x0 ^ ((~x0 ^ ~x1) & x2));
+        const WORD t20 = (t18 ^ ((t18 ^ t19) & x3));
+        const WORD t21 = (t17 ^ ((t17 ^ t20) & x4));
+        y1 = t12;
+        y0 = t21;
+    }
+
+    // S-box 6: x4..x0 are the bits of the index in sbox6, y1 and y0 are the bits of the result.
+    template <class WORD>
+    inline void BitslicedSbox6(WORD x4, WORD x3, WORD x2, WORD x1, WORD x0, WORD& y1, WORD& y0)
+    {
+        const WORD t1 = (x0 ^ x1);
+        const WORD t2 = (x1 ^ ((x1 ^ t1) & x2));
+        const WORD t3 = (x1 & ~x0);
+        const WORD t4 = (x0 | ~x1);
+        const WORD t5 = (t3 ^ x2);
+        const WORD t6 = (t2 ^ ((t2 ^ t5) & x3));
+        const WORD t7 = (~x0 & ~x1);
+        const WORD t8 = (t4 ^ ((t4 ^ t7) & x2));
+        const WORD t9 = (~x0 ^ x1);
+        const WORD t10 = (t9 ^ x2);
+        const WORD t11 = (t8 ^ ((t8 ^ t10) & x3));
+        const WORD t12 = (t6 ^ ((t6 ^ t11) & x4));
+        const WORD t13 = (x0 ^ ((x0 ^ t7) & x2));
+        const WORD t14 = (x0 | x1);
+        const WORD t15 = (t1 ^ ((t1 ^ t14) & x2));
+        const WORD t16 = (t13 ^ ((t13 ^ t15) & x3));
+        const WORD t17 = (x0 & ~x1);
+        const WORD t19 = (t17 ^ x2);
+        const WORD t20 = (t19 ^ ((t19 ^ t1) & x3));
+        const WORD t21 = (t16 ^ ((t16 ^ t20) & x4));
+        y1 = t12;
+        y0 = t21;
+    }
+
+    // S-box 7: x4..x0 are the bits of the index in sbox7, y1 and y0 are the bits of the result.
+    template <class WORD>
+    inline void BitslicedSbox7(WORD x4, WORD x3, WORD x2, WORD x1, WORD x0, WORD& y1, WORD& y0)
+    {
+        const WORD t1 = (x0 | x1);
+        const WORD t3 = (t1 ^ x2);
+        const WORD t4 = (~x0 ^ x1);
+        const WORD t5 = (x0 ^ x1);
+        const WORD t6 = (t4 ^ x2);
+        const WORD t7 = (t3 ^ ((t3 ^ t6) & x3));
+        const WORD t8 = (x1 & x0);
+        const WORD t9 = (x1 ^ ((x1 ^ t8) & x2));
+        const WORD t10 = (x0 | ~x1);
+        const WORD t11 = (~x1 ^ ((~x1 ^ t10) & x2));
+        const WORD t12 = (t9 ^ ((t9 ^ t11) & x3));
+        const WORD t13 = (t7 ^ ((t7 ^ t12) & x4));
+        const WORD t14 = (x0 & ~x1);
+        const WORD t15 = (t14 ^ ((t14 ^ t4) & x2));
+        const WORD t16 = (~x0 | x1);
+        const WORD t17 = (t16 ^ ((t16 ^ t4) & x2));
+        const WORD t18 = (t15 ^ ((t15 ^ t17) & x3));
+        const WORD t19 = (t16 ^ ((t16 ^ t5) & x2));
+        const WORD t20 = (t5 ^ ((t5 ^ t14) & x2));
+        const WORD t21 = (t19 ^ ((t19 ^ t20) & x3));
+        const WORD t22 = (t18 ^ ((t18 ^ t21) & x4));
+        y1 = t13;
+        y0 = t22;
+    }
+
+    // Transpose an 8x8 bit matrix. Row i is byte i of x, bit j of that byte is column j.
+    inline uint64_t Transpose8x8(uint64_t x)
+    {
+        uint64_t t = (x ^ (x >> 7)) & 0x00AA00AA00AA00AA;
+        x = x ^ t ^ (t << 7);
+        t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCC;
+        x = x ^ t ^ (t << 14);
+        t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0;
+        return x ^ t ^ (t << 28);
+    }
+
+    // Load 8 bytes, starting at 'offset' in each lane, into 64 bit planes.
+    // Bit b of byte i of a lane is the bit of that lane in planes[8*i+b].
+    // Missing lanes, after 'count', are zero.
+    template <class WORD>
+    void LoadPlanes(WORD planes[64], uint8_t* const lanes[], size_t count, size_t offset)
+    {
+        // Lane n is bit n%64 of bits[..][n/64].
+        uint64_t bits[64][WORD::LANES / 64] {};
+        for (size_t group = 0; group < count; group += 8) {
+            const size_t gcount = count - group < 8 ? count - group : 8;
+            for (size_t i = 0; i < 8; ++i) {
+                // Build a 8x8 bit matrix, row j is byte i of lane group+j.
+                uint64_t x = 0;
+                for (size_t j = 0; j < gcount; ++j) {
+                    x |= uint64_t(lanes[group + j][offset + i]) << (8 * j);
+                }
+                // After transposition, row b contains bit b of byte i of the 8 lanes.
+                x = Transpose8x8(x);
+                for (size_t b = 0; b < 8; ++b) {
+                    bits[8 * i + b][group / 64] |= ((x >> (8 * b)) & 0xFF) << (group % 64);
+                }
+            }
+        }
+        for (size_t i = 0; i < 64; ++i) {
+            planes[i] = WORD::Load(bits[i]);
+        }
+    }
+
+    // Exclusive-or 64 bit planes into 8 bytes, starting at 'offset' in each lane.
+    // Bytes after the size of a lane are not modified.
+    template <class WORD>
+    void XorPlanes(const WORD planes[64], uint8_t* const lanes[], const size_t sizes[], size_t count, size_t offset)
+    {
+        uint64_t bits[64][WORD::LANES / 64];
+        for (size_t i = 0; i < 64; ++i) {
+            planes[i].store(bits[i]);
+        }
+        for (size_t group = 0; group < count; group += 8) {
+            const size_t gcount = count - group < 8 ? count - group : 8;
+            for (size_t i = 0; i < 8; ++i) {
+                uint64_t x = 0;
+                for (size_t b = 0; b < 8; ++b) {
+                    x |= ((bits[8 * i + b][group / 64] >> (group % 64)) & 0xFF) << (8 * b);
+                }
+                x = Transpose8x8(x);
+                for (size_t j = 0; j < gcount; ++j) {
+                    if (offset + i < sizes[group + j]) {
+                        lanes[group + j][offset + i] ^= uint8_t(x >> (8 * j));
+                    }
+                }
+            }
+        }
+    }
+
+    // Bitsliced stream cipher. Same registers as DVBStreamCipher, all lanes use the same key.
+    // A nibble register is an array of 4 words, index 0 being the least significant bit.
+    template <class WORD>
+    class BitslicedStreamCipher
+    {
+    public:
+        BitslicedStreamCipher(const uint8_t* key);
+
+        // Process 8 bytes per lane. During initialization, sb contains the 64 bit planes of the
+        // 8 input bytes and cb is ignored. Otherwise, sb is null and cb receives the 64 bit planes
+        // of the 8 output bytes.
+        void cipher(const WORD* sb, WORD* cb);
+
+    private:
+        WORD A[11][4] {};
+        WORD B[11][4] {};
+        WORD X[4] {};
+        WORD Y[4] {};
+        WORD Z[4] {};
+        WORD D[4] {};
+        WORD E[4] {};
+        WORD F[4] {};
+        WORD p {};
+        WORD q {};
+        WORD r {};
+
+        // One iteration, producing 2 bits of output per lane.
+        // During initialization, in_a and in_b are the nibbles to inject in registers A and B.
+        void step(const WORD* in_a, const WORD* in_b, WORD& out_hi, WORD& out_lo);
+    };
+
+    template <class WORD>
+    BitslicedStreamCipher<WORD>::BitslicedStreamCipher(const uint8_t* key)
+    {
+        // Same initial state as DVBStreamCipher::init(), broadcast to all lanes.
+        for (size_t i = 0; i < 4; ++i) {
+            for (size_t k = 0; k < 4; ++k) {
+                A[2*i+1][k] = ((key[i] >> (4 + k)) & 1) ? WORD::Ones() : WORD();
+                A[2*i+2][k] = ((key[i] >> k) & 1) ? WORD::Ones() : WORD();
+                B[2*i+1][k] = ((key[i+4] >> (4 + k)) & 1) ? WORD::Ones() : WORD();
+                B[2*i+2][k] = ((key[i+4] >> k) & 1) ? WORD::Ones() : WORD();
+            }
+        }
+    }
+
+    template <class WORD>
+    void BitslicedStreamCipher<WORD>::step(const WORD* in_a, const WORD* in_b, WORD& out_hi, WORD& out_lo)
+    {
+        // S-boxes, see DVBStreamCipher::cipher() for the selection of input bits.
+        WORD s1h, s1l, s2h, s2l, s3h, s3l, s4h, s4l, s5h, s5l, s6h, s6l, s7h, s7l;
+        BitslicedSbox1(A[4][0], A[1][2], A[6][1], A[7][3], A[9][0], s1h, s1l);
+        BitslicedSbox2(A[2][1], A[3][2], A[6][3], A[7][0], A[9][1], s2h, s2l);
+        BitslicedSbox3(A[1][3], A[2][0], A[5][1], A[5][3], A[6][2], s3h, s3l);
+        BitslicedSbox4(A[3][3], A[1][1], A[2][3], A[4][2], A[8][0], s4h, s4l);
+        BitslicedSbox5(A[5][2], A[4][3], A[6][0], A[8][1], A[9][2], s5h, s5l);
+        BitslicedSbox6(A[3][1], A[4][1], A[5][0], A[7][2], A[9][3], s6h, s6l);
+        BitslicedSbox7(A[2][2], A[3][0], A[7][1], A[8][2], A[8][3], s7h, s7l);
+
+        // Extra nibble for T3.
+        const WORD extra_B[4] = {
+            B[9][2] ^ B[6][3] ^ B[3][1] ^ B[8][0],
+            B[5][3] ^ B[8][2] ^ B[4][0] ^ B[5][1],
+            B[6][0] ^ B[8][1] ^ B[3][3] ^ B[4][2],
+            B[3][0] ^ B[6][1] ^ B[7][2] ^ B[9][3]
+        };
+
+        WORD next_A1[4];
+        WORD next_B1[4];
+        WORD next_D[4];
+        WORD next_F[4];
+        WORD carry = r;
+        for (size_t k = 0; k < 4; ++k) {
+            // T1 and T2.
+            next_A1[k] = A[10][k] ^ X[k];
+            next_B1[k] = B[7][k] ^ B[10][k] ^ Y[k];
+            if (in_a != nullptr) {
+                next_A1[k] ^= D[k] ^ in_a[k];
+                next_B1[k] ^= in_b[k];
+            }
+            // T3.
+            next_D[k] = E[k] ^ Z[k] ^ extra_B[k];
+            // T4: F = Z + E + r when q is set, F = E otherwise.
+            const WORD sum = Z[k] ^ E[k] ^ carry;
+            carry = (Z[k] & E[k]) | (carry & (Z[k] ^ E[k]));
+            next_F[k] = E[k] ^ ((E[k] ^ sum) & q);
+        }
+
+        // When p is set, rotate next_B1 left.
+        const WORD rotated_B1[4] = {next_B1[3], next_B1[0], next_B1[1], next_B1[2]};
+        for (size_t k = 0; k < 4; ++k) {
+            next_B1[k] ^= (next_B1[k] ^ rotated_B1[k]) & p;
+        }
+
+        // Update registers.
+        r ^= (r ^ carry) & q;
+        for (size_t k = 0; k < 4; ++k) {
+            D[k] = next_D[k];
+            E[k] = F[k];
+            F[k] = next_F[k];
+        }
+        for (size_t i = 10; i > 1; --i) {
+            for (size_t k = 0; k < 4; ++k) {
+                A[i][k] = A[i-1][k];
+                B[i][k] = B[i-1][k];
+            }
+        }
+        for (size_t k = 0; k < 4; ++k) {
+            A[1][k] = next_A1[k];
+            B[1][k] = next_B1[k];
+        }
+        X[0] = s1h; X[1] = s2h; X[2] = s3l; X[3] = s4l;
+        Y[0] = s3h; Y[1] = s4h; Y[2] = s5l; Y[3] = s6l;
+        Z[0] = s5h; Z[1] = s6h; Z[2] = s1l; Z[3] = s2l;
+        p = s7h;
+        q = s7l;
+
+        // 2 output bits are a function of the 4 bits of D.
+        out_hi = D[2] ^ D[3];
+        out_lo = D[0] ^ D[1];
+    }
+
+    template <class WORD>
+    void BitslicedStreamCipher<WORD>::cipher(const WORD* sb, WORD* cb)
+    {
+        WORD hi {};
+        WORD lo {};
+        for (size_t i = 0; i < 8; i++) {
+            if (sb != nullptr) {
+                // Initialization: most significant nibble, then least significant nibble of each input byte.
+                const WORD* in1 = sb + 8 * i + 4;
+                const WORD* in2 = sb + 8 * i;
+                step(in1, in2, hi, lo);
+                step(in2, in1, hi, lo);
+                step(in1, in2, hi, lo);
+                step(in2, in1, hi, lo);
+            }
+            else {
+                // Generation: 4 steps per output byte, most significant bits first.
+                for (size_t j = 0; j < 4; j++) {
+                    step(nullptr, nullptr, cb[8 * i + 7 - 2 * j], cb[8 * i + 6 - 2 * j]);
+                }
+            }
+        }
+    }
+
+    // Apply the stream cipher on up to WORD::LANES data blocks of 8 bytes or more, in place.
+    // The first 8 bytes of each lane initialize the stream cipher and are not modified.
+    template <class WORD>
+    void BitslicedStreamCipherBatch(const uint8_t* key, uint8_t* const lanes[], const size_t sizes[], size_t count)
+    {
+        assert(count <= WORD::LANES);
+
+        // Number of 8-byte stream cipher outputs after initialization (all blocks but the first one, plus residue).
+        size_t max_size = 0;
+        for (size_t i = 0; i < count; ++i) {
+            max_size = sizes[i] > max_size ? sizes[i] : max_size;
+        }
+        const size_t stream_count = max_size < 8 ? 0 : (max_size - 1) / 8;
+
+        BitslicedStreamCipher<WORD> stream(key);
+        WORD planes[64];
+        LoadPlanes(planes, lanes, count, 0);
+        stream.cipher(planes, nullptr);
+        for (size_t i = 1; i <= stream_count; ++i) {
+            stream.cipher(nullptr, planes);
+            XorPlanes(planes, lanes, sizes, count, 8 * i);
+        }
+    }
+}
@@ -428,6 +428,22 @@ namespace ts {
     protected:
         ByteBlock work {}; //!< Temporary working buffer.
 
+        //!
+        //! Check if one encryption is allowed and count it.
+        //! This is automatically done by encrypt(). A subclass which provides other
+        //! encryption methods shall call it once per encrypted message.
+        //! @return True if encryption is allowed, false otherwise.
+        //!
+        bool allowEncrypt();
+
+        //!
+        //! Check if one decryption is allowed and count it.
+        //! This is automatically done by decrypt(). A subclass which provides other
+        //! decryption methods shall call it once per decrypted message.
+        //! @return True if decryption is allowed, false otherwise.
+        //!
+        bool allowDecrypt();
+
     private:
         bool      _can_process_in_place = false;      // The subclass can encrypt and decrypt in place (identical in/out buffers).
         bool      _key_set = false;                   // Current key successfully set.
@@ -440,10 +456,6 @@ namespace ts {
         ByteBlock _current_iv {};                     // Current initialization vector.
         BlockCipherAlertInterface* _alert = nullptr;  // Alert handler.
 
-        // Check if encryption or decryption is allowed. Increment counters when allowed.
-        bool allowEncrypt();
-        bool allowDecrypt();
-
         // System-specific cryptographic library.
 #if defined(TS_WINDOWS)
         ::BCRYPT_ALG_HANDLE _algo = nullptr;
@@ -10,6 +10,20 @@
 //----------------------------------------------------------------------------
 
 #include "tsDVBCSA2.h"
+#include "tsDVBCSA2Bitslice.h"
+#include "tsCryptoAcceleration.h"
+#include "tsSysInfo.h"
+
+// Select the word type of the bitsliced stream cipher.
+#if defined(TS_NO_SIMD_INSTRUCTIONS)
+    // Disabled at compile time.
+#elif defined(TS_X86_64) && (defined(TS_GCC) || defined(TS_LLVM) || defined(TS_MSC))
+    #define TS_SIMD_SSE2 1
+    #include <emmintrin.h>
+#elif defined(TS_ARM64) && defined(TS_LITTLE_ENDIAN) && defined(__ARM_NEON)
+    #define TS_SIMD_NEON 1
+    #include <arm_neon.h>
+#endif
 
 // Operations on 64-bit areas.
 
@@ -566,6 +580,211 @@ void ts::DVBCSA2::DVBBlockCipher::encipher(const uint8_t *bd, uint8_t *ib)
 }
 
 
+//----------------------------------------------------------------------------
+// Bitsliced stream cipher, see tsDVBCSA2Bitslice.h.
+// SSE2 is part of the base x86_64 instruction set and Advanced SIMD is always
+// available on Arm64, these 128-bit words need no runtime check. The 256-bit
+// AVX2 words are implemented in tsDVBCSA2.accel.cpp and checked at runtime.
+//----------------------------------------------------------------------------
+
+namespace {
+
+#if defined(TS_SIMD_SSE2)
+
+    struct BaseWord
+    {
+        static constexpr size_t LANES = 128;
+        __m128i v {_mm_setzero_si128()};
+        BaseWord() = default;
+        BaseWord(__m128i x) : v(x) {}
+        static BaseWord Ones() { return _mm_set1_epi32(-1); }
+        static BaseWord Load(const uint64_t* p) { return _mm_set_epi64x(int64_t(p[1]), int64_t(p[0])); }
+        void store(uint64_t* p) const { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v); }
+        BaseWord operator~() const { return _mm_xor_si128(v, _mm_set1_epi32(-1)); }
+        BaseWord operator&(const BaseWord& x) const { return _mm_and_si128(v, x.v); }
+        BaseWord operator|(const BaseWord& x) const { return _mm_or_si128(v, x.v); }
+        BaseWord operator^(const BaseWord& x) const { return _mm_xor_si128(v, x.v); }
+        BaseWord& operator^=(const BaseWord& x) { v = _mm_xor_si128(v, x.v); return *this; }
+    };
+
+#elif defined(TS_SIMD_NEON)
+
+    struct BaseWord
+    {
+        static constexpr size_t LANES = 128;
+        uint64x2_t v {vdupq_n_u64(0)};
+        BaseWord() = default;
+        BaseWord(uint64x2_t x) : v(x) {}
+        static BaseWord Ones() { return vdupq_n_u64(~uint64_t(0)); }
+        static BaseWord Load(const uint64_t* p) { return vld1q_u64(p); }
+        void store(uint64_t* p) const { vst1q_u64(p, v); }
+        BaseWord operator~() const { return vreinterpretq_u64_u8(vmvnq_u8(vreinterpretq_u8_u64(v))); }
+        BaseWord operator&(const BaseWord& x) const { return vandq_u64(v, x.v); }
+        BaseWord operator|(const BaseWord& x) const { return vorrq_u64(v, x.v); }
+        BaseWord operator^(const BaseWord& x) const { return veorq_u64(v, x.v); }
+        BaseWord& operator^=(const BaseWord& x) { v = veorq_u64(v, x.v); return *this; }
+    };
+
+#else
+
+    // Portable implementation, one lane per bit of a 64-bit integer.
+    struct BaseWord
+    {
+        static constexpr size_t LANES = 64;
+        uint64_t v = 0;
+        BaseWord() = default;
+        BaseWord(uint64_t x) : v(x) {}
+        static BaseWord Ones() { return ~uint64_t(0); }
+        static BaseWord Load(const uint64_t* p) { return *p; }
+        void store(uint64_t* p) const { *p = v; }
+        BaseWord operator~() const { return ~v; }
+        BaseWord operator&(const BaseWord& x) const { return v & x.v; }
+        BaseWord operator|(const BaseWord& x) const { return v | x.v; }
+        BaseWord operator^(const BaseWord& x) const { return v ^ x.v; }
+        BaseWord& operator^=(const BaseWord& x) { v ^= x.v; return *this; }
+    };
+
+#endif
+
+    // Check once if the accelerated implementation is supported.
+    volatile bool _accel_checked = false;
+    volatile bool _accel_supported = false;
+
+    bool AccelSupported()
+    {
+        if (!_accel_checked) {
+            _accel_supported = tsDVBCSA2IsAccelerated && ts::SysInfo::Instance().simdInstructions();
+            _accel_checked = true;
+        }
+        return _accel_supported;
+    }
+}
+
+static_assert(ts::DVBCSA2::MAX_BATCH_SIZE >= BaseWord::LANES);
+
+
+//----------------------------------------------------------------------------
+// Number of data blocks which are processed in parallel in a batch.
+//----------------------------------------------------------------------------
+
+size_t ts::DVBCSA2::BatchSize()
+{
+    return AccelSupported() ? AccelBatchSize() : BaseWord::LANES;
+}
+
+
+//----------------------------------------------------------------------------
+// Byte-sliced block cipher.
+// The block cipher is applied in parallel on 8 data blocks with the same key.
+// Each byte of the cipher state becomes a 64-bit word, each byte of the word
+// being the state byte for one data block (one "lane"). All operations except
+// the S-box are performed on all lanes at once, the S-box is a lookup per byte.
+//----------------------------------------------------------------------------
+
+namespace {
+
+    // A byte value in all 8 lanes of a word.
+    constexpr uint64_t AllBytes(uint64_t b) { return b * 0x0101010101010101; }
+
+    // Apply block_sbox on the 8 bytes of a word.
+    inline uint64_t SlicedSbox(uint64_t x)
+    {
+        return uint64_t(block_sbox[x & 0xFF]) |
+               (uint64_t(block_sbox[(x >> 8) & 0xFF]) << 8) |
+               (uint64_t(block_sbox[(x >> 16) & 0xFF]) << 16) |
+               (uint64_t(block_sbox[(x >> 24) & 0xFF]) << 24) |
+               (uint64_t(block_sbox[(x >> 32) & 0xFF]) << 32) |
+               (uint64_t(block_sbox[(x >> 40) & 0xFF]) << 40) |
+               (uint64_t(block_sbox[(x >> 48) & 0xFF]) << 48) |
+               (uint64_t(block_sbox[(x >> 56) & 0xFF]) << 56);
+    }
+
+    // Apply block_perm on the 8 bytes of a word. The table is a permutation of the bits of a byte:
+    // 0->1, 1->7, 2->5, 3->4, 4->2, 5->6, 6->0, 7->3.
+    inline uint64_t SlicedPerm(uint64_t x)
+    {
+        return ((x & AllBytes(0x29)) << 1) |
+               ((x & AllBytes(0x02)) << 6) |
+               ((x & AllBytes(0x04)) << 3) |
+               ((x & AllBytes(0x10)) >> 2) |
+               ((x & AllBytes(0x40)) >> 6) |
+               ((x & AllBytes(0x80)) >> 4);
+    }
+
+    // Load 8 bytes, starting at 'offset' in up to 8 lanes, into 8 words. Word i contains byte i of all lanes.
+    // Lanes where 'active' is false are loaded as zero. When 'chain' is true, xor with the next 8 bytes.
+    void LoadSlicedBlock(uint64_t R[8], uint8_t* const lanes[], const size_t offsets[], const bool active[], size_t count, bool chain)
+    {
+        for (size_t i = 0; i < 8; ++i) {
+            R[i] = 0;
+        }
+        for (size_t j = 0; j < count; ++j) {
+            if (active[j]) {
+                const uint8_t* const d = lanes[j] + offsets[j];
+                for (size_t i = 0; i < 8; ++i) {
+                    R[i] |= uint64_t(chain ? uint8_t(d[i] ^ d[i + 8]) : d[i]) << (8 * j);
+                }
+            }
+        }
+    }
+
+    // Store 8 words into 8 bytes, starting at 'offset' in up to 8 lanes. Inactive lanes are not modified.
+    // When 'chain' is true, xor with the next 8 bytes.
+    void StoreSlicedBlock(const uint64_t R[8], uint8_t* const lanes[], const size_t offsets[], const bool active[], const bool chain[], size_t count)
+    {
+        for (size_t j = 0; j < count; ++j) {
+            if (active[j]) {
+                uint8_t* const d = lanes[j] + offsets[j];
+                for (size_t i = 0; i < 8; ++i) {
+                    d[i] = uint8_t(uint8_t(R[i] >> (8 * j)) ^ (chain[j] ? d[i + 8] : 0));
+                }
+            }
+        }
+    }
+}
+
+void ts::DVBCSA2::DVBBlockCipher::decipherSliced(uint64_t R[8]) const
+{
+    // Same as decipher() with R[0..7] instead of R[1..8], on all lanes.
+    uint64_t r1 = R[0], r2 = R[1], r3 = R[2], r4 = R[3], r5 = R[4], r6 = R[5], r7 = R[6], r8 = R[7];
+    for (int i = 56; i > 0; i--) {
+        const uint64_t sbox_out = SlicedSbox(AllBytes(uint64_t(_kk[i])) ^ r7);
+        const uint64_t perm_out = SlicedPerm(sbox_out);
+        const uint64_t x = r8 ^ sbox_out;
+        const uint64_t next_r8 = r7;
+        r7 = r6 ^ perm_out;
+        r6 = r5;
+        r5 = r4 ^ x;
+        r4 = r3 ^ x;
+        r3 = r2 ^ x;
+        r2 = r1;
+        r1 = x;
+        r8 = next_r8;
+    }
+    R[0] = r1; R[1] = r2; R[2] = r3; R[3] = r4; R[4] = r5; R[5] = r6; R[6] = r7; R[7] = r8;
+}
+
+void ts::DVBCSA2::DVBBlockCipher::encipherSliced(uint64_t R[8]) const
+{
+    // Same as encipher() with R[0..7] instead of R[1..8], on all lanes.
+    uint64_t r1 = R[0], r2 = R[1], r3 = R[2], r4 = R[3], r5 = R[4], r6 = R[5], r7 = R[6], r8 = R[7];
+    for (int i = 1; i <= 56; i++) {
+        const uint64_t sbox_out = SlicedSbox(AllBytes(uint64_t(_kk[i])) ^ r8);
+        const uint64_t perm_out = SlicedPerm(sbox_out);
+        const uint64_t next_r1 = r2;
+        r2 = r3 ^ r1;
+        r3 = r4 ^ r1;
+        r4 = r5 ^ r1;
+        r5 = r6;
+        r6 = r7 ^ perm_out;
+        r7 = r8;
+        r8 = r1 ^ sbox_out;
+        r1 = next_r1;
+    }
+    R[0] = r1; R[1] = r2; R[2] = r3; R[3] = r4; R[4] = r5; R[5] = r6; R[6] = r7; R[7] = r8;
+}
+
+
 //----------------------------------------------------------------------------
 // Set the control word for subsequent encrypt/decrypt operations
 //----------------------------------------------------------------------------
@@ -737,3 +956,140 @@ bool ts::DVBCSA2::decryptImpl(const void* input, size_t input_length, void* outp
 
     return true;
 }
+
+
+//----------------------------------------------------------------------------
+// Encrypt or decrypt a batch of data blocks.
+//----------------------------------------------------------------------------
+
+bool ts::DVBCSA2::encryptBatch(uint8_t* const data[], const size_t sizes[], size_t count)
+{
+    return processBatches(data, sizes, count, true);
+}
+
+bool ts::DVBCSA2::decryptBatch(uint8_t* const data[], const size_t sizes[], size_t count)
+{
+    return processBatches(data, sizes, count, false);
+}
+
+bool ts::DVBCSA2::processBatches(uint8_t* const data[], const size_t sizes[], size_t count, bool encrypt)
+{
+    // Validate all data blocks before modifying any of them.
+    if (!_init) {
+        return false;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        if (data[i] == nullptr || sizes[i] / 8 > MAX_NBLOCKS) {
+            return false;
+        }
+    }
+    for (size_t i = 0; i < count; ++i) {
+        if (!(encrypt ? allowEncrypt() : allowDecrypt())) {
+            return false;
+        }
+    }
+
+    const size_t batch_size = BatchSize();
+    for (size_t first = 0; first < count; first += batch_size) {
+        processBatch(data + first, sizes + first, std::min(batch_size, count - first), encrypt);
+    }
+    return true;
+}
+
+void ts::DVBCSA2::processBatch(uint8_t* const data[], const size_t sizes[], size_t count, bool encrypt)
+{
+    assert(count <= MAX_BATCH_SIZE);
+
+    // Keep data blocks of 8 bytes or more, smaller ones are left unscrambled.
+    uint8_t* lanes[MAX_BATCH_SIZE];
+    size_t lane_sizes[MAX_BATCH_SIZE];
+    size_t lane_count = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (sizes[i] >= 8) {
+            lanes[lane_count] = data[i];
+            lane_sizes[lane_count] = sizes[i];
+            lane_count++;
+        }
+    }
+    if (lane_count == 0) {
+        return;
+    }
+
+    if (encrypt) {
+        // Perform the block cipher in reverse CBC mode, on groups of 8 lanes.
+        // The chaining value is the next encrypted block, already in place.
+        // Lanes are aligned on their last block, step t processes block nblocks-1-t.
+        for (size_t group = 0; group < lane_count; group += 8) {
+            const size_t gcount = std::min<size_t>(8, lane_count - group);
+            size_t max_blocks = 0;
+            for (size_t j = 0; j < gcount; ++j) {
+                max_blocks = std::max(max_blocks, lane_sizes[group + j] / 8);
+            }
+            for (size_t t = 0; t < max_blocks; ++t) {
+                size_t offsets[8];
+                bool active[8];
+                const bool chain[8] {};
+                for (size_t j = 0; j < gcount; ++j) {
+                    const size_t nblocks = lane_sizes[group + j] / 8;
+                    active[j] = t < nblocks;
+                    offsets[j] = active[j] ? 8 * (nblocks - 1 - t) : 0;
+                }
+                uint64_t R[8];
+                LoadSlicedBlock(R, lanes + group, offsets, active, gcount, t > 0);
+                _block.encipherSliced(R);
+                StoreSlicedBlock(R, lanes + group, offsets, active, chain, gcount);
+            }
+        }
+
+        // The first block of each lane is scrambled using the block cipher only.
+        // Its scrambled value is used to initialize the stream cipher. Then perform
+        // the stream cipher on all lanes in parallel, starting from the second block.
+        streamCipherBatch(lanes, lane_sizes, lane_count);
+    }
+    else {
+        // Initialize the stream cipher with the first 8 bytes of each lane. Then remove
+        // the stream cipher on all lanes in parallel, starting from the second block.
+        streamCipherBatch(lanes, lane_sizes, lane_count);
+
+        // Now, each block contains the intermediate block of the block cipher in reverse CBC mode.
+        // Decipher all blocks on groups of 8 lanes, in increasing order. The chaining value is the
+        // next intermediate block, not yet deciphered (zero after the last block).
+        for (size_t group = 0; group < lane_count; group += 8) {
+            const size_t gcount = std::min<size_t>(8, lane_count - group);
+            size_t max_blocks = 0;
+            for (size_t j = 0; j < gcount; ++j) {
+                max_blocks = std::max(max_blocks, lane_sizes[group + j] / 8);
+            }
+            for (size_t i = 0; i < max_blocks; ++i) {
+                size_t offsets[8];
+                bool active[8];
+                bool chain[8];
+                for (size_t j = 0; j < gcount; ++j) {
+                    const size_t nblocks = lane_sizes[group + j] / 8;
+                    active[j] = i < nblocks;
+                    chain[j] = i + 1 < nblocks;
+                    offsets[j] = 8 * i;
+                }
+                uint64_t R[8];
+                LoadSlicedBlock(R, lanes + group, offsets, active, gcount, false);
+                _block.decipherSliced(R);
+                StoreSlicedBlock(R, lanes + group, offsets, active, chain, gcount);
+            }
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Apply the bitsliced stream cipher on at most BatchSize() data blocks.
+//----------------------------------------------------------------------------
+
+void ts::DVBCSA2::streamCipherBatch(uint8_t* const lanes[], const size_t sizes[], size_t count) const
+{
+    if (AccelSupported()) {
+        streamCipherBatchAccel(lanes, sizes, count);
+    }
+    else {
+        BitslicedStreamCipherBatch<BaseWord>(_key, lanes, sizes, count);
+    }
+}
@@ -26,6 +26,15 @@ namespace ts {
         static constexpr size_t KEY_BITS = 64;             //!< DVB CSA-2 control words size in bits.
         static constexpr size_t KEY_SIZE = KEY_BITS / 8;   //!< DVB CSA-2 control words size in bytes.
         static constexpr size_t BLOCK_SIZE = 8;            //!< DVB CSA-2 block size in bytes (informational only, not relevant to scrambling).
+        static constexpr size_t MAX_BATCH_SIZE = 256;      //!< Maximum value of BatchSize().
+
+        //!
+        //! Get the number of data blocks which are processed in parallel by encryptBatch() and decryptBatch().
+        //! This depends on the SIMD instructions of the CPU: 256 with AVX2, 128 with SSE2 or Arm64
+        //! Advanced SIMD, 64 otherwise.
+        //! @return The number of data blocks in a batch.
+        //!
+        static size_t BatchSize();
 
         //!
         //! Control word entropy reduction.
@@ -68,6 +77,37 @@ namespace ts {
         //!
         static bool IsReducedCW(const uint8_t *cw);
 
+        //!
+        //! Encrypt a batch of data blocks (typically TS packet payloads) using the current key.
+        //!
+        //! The data blocks are encrypted in place. The stream cipher part of the algorithm is
+        //! bitsliced: BatchSize() data blocks are processed in parallel, each one in one bit of
+        //! a SIMD word. The block cipher part is byte-sliced: 8 data blocks are processed in
+        //! parallel, each one in one byte of a 64-bit word. Larger batches are processed by
+        //! groups of BatchSize() data blocks. The result is identical to individual calls to
+        //! encrypt() on each data block and each data block counts as one encryption in
+        //! encryptionCount(). All data blocks are checked before encrypting any of them:
+        //! on error, no data block is modified.
+        //!
+        //! @param [in,out] data Array of @a count addresses of data blocks to encrypt in place.
+        //! @param [in] sizes Array of @a count sizes in bytes of the data blocks.
+        //! Each size shall not exceed the maximum TS packet payload size.
+        //! @param [in] count Number of data blocks.
+        //! @return True on success, false on error.
+        //!
+        bool encryptBatch(uint8_t* const data[], const size_t sizes[], size_t count);
+
+        //!
+        //! Decrypt a batch of data blocks (typically TS packet payloads) using the current key.
+        //! @param [in,out] data Array of @a count addresses of data blocks to decrypt in place.
+        //! @param [in] sizes Array of @a count sizes in bytes of the data blocks.
+        //! Each size shall not exceed the maximum TS packet payload size.
+        //! @param [in] count Number of data blocks.
+        //! @return True on success, false on error.
+        //! @see encryptBatch()
+        //!
+        bool decryptBatch(uint8_t* const data[], const size_t sizes[], size_t count);
+
     protected:
         TS_BLOCK_CIPHER_DECLARE_PROPERTIES(DVBCSA2);
 
@@ -86,6 +126,9 @@ namespace ts {
             void init(const uint8_t *cw);
             void encipher(const uint8_t *bd, uint8_t *ib);
             void decipher(const uint8_t *ib, uint8_t *bd);
+            // Byte-sliced versions on 8 blocks: word i contains byte i of the 8 blocks.
+            void encipherSliced(uint64_t R[8]) const;
+            void decipherSliced(uint64_t R[8]) const;
         };
 
         // Stream cipher data
@@ -108,6 +151,19 @@ namespace ts {
             void cipher(const uint8_t* sb, uint8_t *cb);
         };
 
+        // Encrypt or decrypt any number of data blocks, all of them are validated first.
+        bool processBatches(uint8_t* const data[], const size_t sizes[], size_t count, bool encrypt);
+
+        // Encrypt or decrypt at most BatchSize() validated data blocks.
+        void processBatch(uint8_t* const data[], const size_t sizes[], size_t count, bool encrypt);
+
+        // Apply the bitsliced stream cipher on at most BatchSize() data blocks of 8 bytes or more.
+        void streamCipherBatch(uint8_t* const lanes[], const size_t sizes[], size_t count) const;
+
+        // Accelerated versions, compiled in a separated module.
+        static size_t AccelBatchSize();
+        void streamCipherBatchAccel(uint8_t* const lanes[], const size_t sizes[], size_t count) const;
+
         // DVB-CSA scrambling data
         bool            _init = false;
         EntropyMode     _mode = REDUCE_ENTROPY;
@@ -169,6 +169,29 @@ void ts::ContinuityAnalyzer::logJSON(PID pid, const UChar* type, size_t packet_c
 }
 
 
+//----------------------------------------------------------------------------
+// Process a contiguous array of constant TS packets.
+//----------------------------------------------------------------------------
+
+size_t ts::ContinuityAnalyzer::feedPackets(const TSPacket* packets, const TSPacketHeaders& headers)
+{
+    size_t errors = 0;
+    const PID* pids = headers.pids();
+    for (size_t i = 0; i < headers.size(); ++i) {
+        if (pids[i] != PID_NULL && _pid_filter.test(pids[i])) {
+            if (!feedPacketInternal(const_cast<TSPacket*>(packets + i), false)) {
+                errors++;
+            }
+        }
+        else {
+            // Same as feedPacketInternal() on a PID which is not analyzed.
+            _total_packets++;
+        }
+    }
+    return errors;
+}
+
+
 //----------------------------------------------------------------------------
 // Detect / fix error on packet.
 //----------------------------------------------------------------------------
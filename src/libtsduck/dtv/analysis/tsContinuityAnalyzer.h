@@ -13,7 +13,9 @@
 
 #pragma once
 #include "tsTSPacket.h"
+#include "tsTSPacketHeaders.h"
 #include "tsReport.h"
+#include "tsPIDTable.h"
 
 namespace ts {
     //!
@@ -72,6 +74,16 @@ namespace ts {
         //!
         bool feedPacket(TSPacket& pkt) { return feedPacketInternal(&pkt, true); }
 
+        //!
+        //! Process a contiguous array of constant TS packets, the headers of which are already decoded.
+        //! Can be used only to report discontinuity errors. Packets in PID's which are not
+        //! analyzed are skipped using the decoded headers, without accessing the packets.
+        //! @param [in] packets Address of the first packet.
+        //! @param [in] headers Decoded headers of the packets. The number of packets is @a headers.size().
+        //! @return The number of packets with a discontinuity error.
+        //!
+        size_t feedPackets(const TSPacket* packets, const TSPacketHeaders& headers);
+
         //!
         //! Get the total number of TS packets.
         //! @return The total number of TS packets.
@@ -251,7 +263,7 @@ namespace ts {
         };
 
         // A map of PID state, indexed by PID.
-        using PIDStateMap = std::map<PID,PIDState>;
+        using PIDStateMap = PIDTable<PIDState>;
 
         // Private members.
         Report*       _report;                    // Where to report errors, never null.
@@ -35,6 +35,7 @@ ts::TSAnalyzer::TSAnalyzer(DuckContext& duck, const BitRate& bitrate_hint, BitRa
     _ts_user_bitrate(bitrate_hint),
     _ts_user_br_confidence(bitrate_confidence)
 {
+    _shard_pids.set();
     resetSectionDemux();
 }
 
@@ -100,6 +101,12 @@ void ts::TSAnalyzer::reset()
     _t2mi_demux.reset();
     _lcn.clear();
 
+    // Back to a complete analysis, without shard.
+    _shard_index = 0;
+    _shard_count = 1;
+    _shard_pids.set();
+    _pes_demux.setPIDFilter(_shard_pids);
+
     resetSectionDemux();
 }
 
@@ -1196,12 +1203,15 @@ void ts::TSAnalyzer::handleNewMPEG2AudioAttributes(PESDemux&, const PESPacket& p
 {
     PIDContextPtr pc(getPID(pkt.sourcePID()));
 
+    // In the other shards than the first one, the PMT's are analyzed by the PES demux only.
+    const uint8_t stream_type = _shard_index == 0 ? pc->stream_type : _pes_demux.getStreamType(pc->pid);
+
     // AAC audio streams have the same outer syntax and are sometimes incorrectly reported as MPEG-2 audio.
-    if (pc->stream_type == ST_MPEG1_AUDIO || pc->stream_type == ST_MPEG2_AUDIO) {
+    if (stream_type == ST_MPEG1_AUDIO || stream_type == ST_MPEG2_AUDIO) {
         // We are sure that the stream is MPEG 1/2 Audio.
         AppendUnique(pc->attributes, attr.toString());
     }
-    else if (pc->stream_type == ST_NULL) {
+    else if (stream_type == ST_NULL) {
         // We do not know the stream type yet, the first PES packet came before the PMT.
         pc->audio2 = attr;
     }
@@ -1326,13 +1336,57 @@ void ts::TSAnalyzer::handleTSPacket(T2MIDemux& demux, const T2MIPacket& t2mi, co
 
 
 //----------------------------------------------------------------------------
-// The following method feeds the analyzer with a TS packet.
+// The following methods feed the analyzer with TS packets.
 //----------------------------------------------------------------------------
 
 void ts::TSAnalyzer::feedPacket(const TSPacket& pkt)
 {
-    bool broken_rate(false);
+    uint64_t index = 0;
+    analyzePacket(pkt, pkt.getPID(), pkt.getCC(), TSPacketHeaders::Flags(pkt), index);
+}
+
+void ts::TSAnalyzer::feedPackets(const TSPacket* packets, const TSPacketHeaders& headers)
+{
+    const PID* pids = headers.pids();
+    const uint8_t* ccs = headers.ccs();
+    const uint8_t* flags = headers.flags();
+    uint64_t index = 0;
+    for (size_t i = 0; i < headers.size(); ++i) {
+        analyzePacket(packets[i], pids[i], ccs[i], flags[i], index);
+    }
+}
 
+ts::TSAnalyzer::ShardRoute ts::TSAnalyzer::feedShardRouter(const TSPacket& pkt, uint64_t& index)
+{
+    return analyzePacket(pkt, pkt.getPID(), pkt.getCC(), TSPacketHeaders::Flags(pkt), index);
+}
+
+void ts::TSAnalyzer::feedShardRouter(const TSPacket* packets, const TSPacketHeaders& headers, std::vector<ShardRoute>& routes, std::vector<uint64_t>& indexes)
+{
+    const PID* pids = headers.pids();
+    const uint8_t* ccs = headers.ccs();
+    const uint8_t* flags = headers.flags();
+    routes.resize(headers.size());
+    indexes.resize(headers.size());
+    for (size_t i = 0; i < headers.size(); ++i) {
+        routes[i] = analyzePacket(packets[i], pids[i], ccs[i], flags[i], indexes[i]);
+    }
+}
+
+void ts::TSAnalyzer::feedShardPacket(const TSPacket& pkt, uint64_t index)
+{
+    const PID pid = pkt.getPID();
+    _modified = true;
+
+    // The PAT and PMT are used by the PES demux only, the PSI/SI are analyzed by the first shard.
+    _pes_demux.feedPacket(pkt);
+    if (_shard_pids.test(pid)) {
+        analyzePIDPacket(pkt, *getPID(pid), index, pkt.getCC(), TSPacketHeaders::Flags(pkt));
+    }
+}
+
+ts::TSAnalyzer::ShardRoute ts::TSAnalyzer::analyzePacket(const TSPacket& pkt, PID pid, uint8_t cc, uint8_t flags, uint64_t& packet_index)
+{
     // Store system times of first packet
     if (_first_utc == Time::Epoch) {
         _first_utc = Time::CurrentUTC();
@@ -1344,32 +1398,32 @@ void ts::TSAnalyzer::feedPacket(const TSPacket& pkt)
 
     // Count TS packets
     _ts_pkt_cnt++;
-    uint64_t packet_index(_ts_pkt_cnt);
+    packet_index = _ts_pkt_cnt;
 
     // Detect and ignore invalid packets
     bool invalid_packet = false;
-    if (!pkt.hasValidSync()) {
+    if ((flags & TSPacketHeaders::BAD_SYNC) != 0) {
         _invalid_sync++;
         invalid_packet = true;
     }
-    if (pkt.getTEI()) {
+    if ((flags & TSPacketHeaders::TEI) != 0) {
         _transport_errors++;
         invalid_packet = true;
     }
     if (invalid_packet) {
         _preceding_errors++;
         _preceding_suspects = 0;
-        return;
+        return ShardRoute::NONE;
     }
 
     // Detect and ignore suspect packets
-    if (_min_error_before_suspect > 0 && _max_consecutive_suspects > 0 && !pidExists(pkt.getPID())) {
+    if (_min_error_before_suspect > 0 && _max_consecutive_suspects > 0 && !pidExists(pid)) {
         // Suspect packet detection enabled and potential suspect packet
         if (_preceding_errors >= _min_error_before_suspect || (_preceding_suspects > 0 && _preceding_suspects < _max_consecutive_suspects)) {
             _suspect_ignored++;
             _preceding_suspects++;
             _preceding_errors = 0;
-            return;
+            return ShardRoute::NONE;
         }
     }
 
@@ -1383,78 +1437,103 @@ void ts::TSAnalyzer::feedPacket(const TSPacket& pkt)
     _t2mi_demux.feedPacket(pkt);
 
     // Get PID context
-    PIDContextPtr ps(getPID(pkt.getPID()));
-    ps->ts_pkt_cnt++;
+    PIDContextPtr ps(getPID(pid));
+
+    // In parallel analysis, the packets are analyzed by the shard of their PID only.
+    // The PAT and PMT are also needed in all shards to identify the codecs in the PES demux.
+    ShardRoute route = ShardRoute::NONE;
+    if (_shard_count > 1) {
+        route = pid == PID_PAT || ps->is_pmt_pid ? ShardRoute::ALL : ShardRoute::OWNER;
+    }
+    if (_shard_pids.test(pid)) {
+        analyzePIDPacket(pkt, *ps, packet_index, cc, flags);
+        if (route == ShardRoute::OWNER) {
+            route = ShardRoute::NONE;
+        }
+    }
+    return route;
+}
+
+void ts::TSAnalyzer::analyzePIDPacket(const TSPacket& pkt, PIDContext& ps, uint64_t packet_index, uint8_t cc, uint8_t flags)
+{
+    bool broken_rate(false);
+
+    // Decoded packet header.
+    const bool pusi = (flags & TSPacketHeaders::PUSI) != 0;
+    const bool has_payload = (flags & TSPacketHeaders::HAS_PAYLOAD) != 0;
+    const uint8_t scrambling = uint8_t((flags & TSPacketHeaders::SC_MASK) >> TSPacketHeaders::SC_SHIFT);
+
+    ps.ts_pkt_cnt++;
 
     // Accumulate stat from packet
-    if (pkt.hasAF()) {
-        ps->ts_af_cnt++;
+    if ((flags & TSPacketHeaders::HAS_AF) != 0) {
+        ps.ts_af_cnt++;
     }
-    if (pkt.getPUSI()) {
-        ps->unit_start_cnt++;
+    if (pusi) {
+        ps.unit_start_cnt++;
     }
-    if (pkt.getPUSI() && pkt.hasPayload()) {
-        ps->pl_start_cnt++;
+    if (pusi && has_payload) {
+        ps.pl_start_cnt++;
     }
 
     // Process scrambling information
-    if (pkt.getScrambling() != SC_CLEAR && !ps->scrambled) {
-        ps->scrambled = true;
+    if (scrambling != SC_CLEAR && !ps.scrambled) {
+        ps.scrambled = true;
         _scrambled_pid_cnt++;
     }
-    if (pkt.getScrambling() == SC_DVB_RESERVED) {
-        ps->inv_ts_sc_cnt++;
+    if (scrambling == SC_DVB_RESERVED) {
+        ps.inv_ts_sc_cnt++;
     }
-    else if (pkt.getScrambling() != SC_CLEAR) {
-        ps->ts_sc_cnt++;
+    else if (scrambling != SC_CLEAR) {
+        ps.ts_sc_cnt++;
     }
-    if (pkt.getScrambling() != ps->cur_ts_sc) {
+    if (scrambling != ps.cur_ts_sc) {
         // Change of crypto-period
-        if (ps->cur_ts_sc != SC_CLEAR) {
+        if (ps.cur_ts_sc != SC_CLEAR) {
             // End of a crypto-period, not a clear/scramble transition.
             // Count number of crypto-periods:
-            ps->cryptop_cnt++;
+            ps.cryptop_cnt++;
             // Count number of TS packets in all crypto-periods.
             // Ignore first crypto-period since it is truncated and
             // not significant for evaluation of duration.
-            if (ps->cryptop_cnt > 1) {
-                ps->cryptop_ts_cnt += packet_index - ps->cur_ts_sc_pkt;
+            if (ps.cryptop_cnt > 1) {
+                ps.cryptop_ts_cnt += packet_index - ps.cur_ts_sc_pkt;
             }
         }
-        ps->cur_ts_sc = pkt.getScrambling();
-        ps->cur_ts_sc_pkt = packet_index;
+        ps.cur_ts_sc = scrambling;
+        ps.cur_ts_sc_pkt = packet_index;
     }
 
     // Process discontinuities.
     // The continuity counter of null packets is undefined.
-    if (ps->pid != PID_NULL) {
-        if (ps->ts_pkt_cnt == 1) {
+    if (ps.pid != PID_NULL) {
+        if (ps.ts_pkt_cnt == 1) {
             // First packet, initialize continuity
-            ps->cur_continuity = pkt.getCC();
+            ps.cur_continuity = cc;
         }
         else if (pkt.getDiscontinuityIndicator()) {
             // Expected discontinuity
-            ps->exp_discont++;
+            ps.exp_discont++;
             broken_rate = true;
         }
-        else if (pkt.hasPayload()) {
+        else if (has_payload) {
             // Packet has payload.
-            if (pkt.getCC() == ps->cur_continuity) {
+            if (cc == ps.cur_continuity) {
                 // Same counter means duplicated packet.
-                ps->duplicated++;
+                ps.duplicated++;
             }
-            else if (pkt.getCC() != (ps->cur_continuity + 1) % CC_MAX) {
+            else if (cc != (ps.cur_continuity + 1) % CC_MAX) {
                 // Counter not following previous -> discontinuity
-                ps->unexp_discont++;
+                ps.unexp_discont++;
                 broken_rate = true;
             }
         }
-        else if (pkt.getCC() != ps->cur_continuity) {
+        else if (cc != ps.cur_continuity) {
             // Packet has no payload -> should have same counter
-            ps->unexp_discont++;
+            ps.unexp_discont++;
             broken_rate = true;
         }
-        ps->cur_continuity = pkt.getCC();
+        ps.cur_continuity = cc;
     }
 
     // Process clocks.
@@ -1463,63 +1542,63 @@ void ts::TSAnalyzer::feedPacket(const TSPacket& pkt)
     const uint64_t dts = pkt.getDTS();
     if (broken_rate) {
         // Suspected packet loss, forget the last PCR with use to compute bitrate.
-        ps->br_last_pcr = INVALID_PCR;
+        ps.br_last_pcr = INVALID_PCR;
     }
     if (pcr != INVALID_PCR) {
         // Count PID's with PCR
-        if (ps->pcr_cnt++ == 0) {
+        if (ps.pcr_cnt++ == 0) {
             _pcr_pid_cnt++;
         }
         // If last PCR valid, compute transport rate between the two
-        if (ps->br_last_pcr != INVALID_PCR && ps->br_last_pcr < pcr) {
+        if (ps.br_last_pcr != INVALID_PCR && ps.br_last_pcr < pcr) {
             // Compute transport rate in b/s since last PCR
-            BitRate ts_bitrate = BitRate((packet_index - ps->br_last_pcr_pkt) * SYSTEM_CLOCK_FREQ * PKT_SIZE_BITS) / (pcr - ps->br_last_pcr);
+            BitRate ts_bitrate = BitRate((packet_index - ps.br_last_pcr_pkt) * SYSTEM_CLOCK_FREQ * PKT_SIZE_BITS) / (pcr - ps.br_last_pcr);
             // Per-PID statistics:
-            ps->ts_bitrate_sum += ts_bitrate;
-            ps->ts_bitrate_cnt++;
+            ps.ts_bitrate_sum += ts_bitrate;
+            ps.ts_bitrate_cnt++;
             // Transport stream statistics:
             _ts_bitrate_sum += ts_bitrate;
             _ts_bitrate_cnt++;
         }
         // Detect PCR leaps.
-        if (ps->last_pcr != INVALID_PCR && (ps->last_pcr > pcr || (pcr - ps->last_pcr) > SYSTEM_CLOCK_FREQ)) {
+        if (ps.last_pcr != INVALID_PCR && (ps.last_pcr > pcr || (pcr - ps.last_pcr) > SYSTEM_CLOCK_FREQ)) {
             // PCR wrap-up or more than one second diff.
-            ps->pcr_leap_cnt++;
+            ps.pcr_leap_cnt++;
         }
         // Save PCR for next calculation
-        ps->br_last_pcr = pcr;
-        ps->br_last_pcr_pkt = packet_index;
+        ps.br_last_pcr = pcr;
+        ps.br_last_pcr_pkt = packet_index;
         // Save first and last PCR outside of bitrate computation.
-        if (ps->first_pcr == INVALID_PCR) {
-            ps->first_pcr = pcr;
+        if (ps.first_pcr == INVALID_PCR) {
+            ps.first_pcr = pcr;
         }
-        ps->last_pcr = pcr;
+        ps.last_pcr = pcr;
     }
     if (pts != INVALID_PTS) {
-        ps->pts_cnt++;
-        if (ps->last_pts != INVALID_PTS) {
+        ps.pts_cnt++;
+        if (ps.last_pts != INVALID_PTS) {
             // PTS are allowed to be out-of-order.
-            const uint64_t diff = pts > ps->last_pts ? pts - ps->last_pts : ps->last_pts - pts;
+            const uint64_t diff = pts > ps.last_pts ? pts - ps.last_pts : ps.last_pts - pts;
             if (diff > 3 * SYSTEM_CLOCK_SUBFREQ) {
                 // PTS wrap-up or more than 3 seconds diff.
-                ps->pts_leap_cnt++;
+                ps.pts_leap_cnt++;
             }
         }
-        if (ps->first_pts == INVALID_PTS) {
-            ps->first_pts = pts;
+        if (ps.first_pts == INVALID_PTS) {
+            ps.first_pts = pts;
         }
-        ps->last_pts = pts;
+        ps.last_pts = pts;
     }
     if (dts != INVALID_DTS) {
-        ps->dts_cnt++;
-        if (ps->last_dts != INVALID_DTS && (ps->last_dts > dts || (dts - ps->last_dts) > 3 * SYSTEM_CLOCK_SUBFREQ)) {
+        ps.dts_cnt++;
+        if (ps.last_dts != INVALID_DTS && (ps.last_dts > dts || (dts - ps.last_dts) > 3 * SYSTEM_CLOCK_SUBFREQ)) {
             // DTS wrap-up or more than 3 seconds diff.
-            ps->dts_leap_cnt++;
+            ps.dts_leap_cnt++;
         }
-        if (ps->first_dts == INVALID_DTS) {
-            ps->first_dts = dts;
+        if (ps.first_dts == INVALID_DTS) {
+            ps.first_dts = dts;
         }
-        ps->last_dts = dts;
+        ps.last_dts = dts;
     }
 
     // Check PES start code: PES packet headers start with the constant
@@ -1533,7 +1612,7 @@ void ts::TSAnalyzer::feedPacket(const TSPacket& pkt)
 
     size_t header_size(pkt.getHeaderSize());
 
-    if (pkt.getPUSI() && pkt.getScrambling() == SC_CLEAR && header_size <= PKT_SIZE - 3) {
+    if (pusi && scrambling == SC_CLEAR && header_size <= PKT_SIZE - 3) {
 
         // Got a "unit start indicator" in a clear packet.
         // This may be the start of a section or a PES packet.
@@ -1543,9 +1622,9 @@ void ts::TSAnalyzer::feedPacket(const TSPacket& pkt)
             // PID carries sections (we may not yet know this, so count
             // all these errors now and ignore them later if we know
             // that the PID does not carry PES packets).
-            ps->inv_pes_start++;
+            ps.inv_pes_start++;
         }
-        else if (header_size <= PKT_SIZE - 4 && ps->pid != 0) {
+        else if (header_size <= PKT_SIZE - 4 && ps.pid != 0) {
             // Here, the start of the packet payload is 00 00 01.
             // The only case where this can happen on a section is a PAT
             // (first 00 = "pointer field", second 00 = table_id = PAT).
@@ -1554,17 +1633,115 @@ void ts::TSAnalyzer::feedPacket(const TSPacket& pkt)
             // As a consequence, we are pretty sure to have a PES packet.
             // Remember the stream_id of the PES packets on this PID
             // (the PES stream_id is next byte after PES start code).
-            if (ps->pes_stream_id == 0) {
+            if (ps.pes_stream_id == 0) {
                 // First PES stream_id found on this PID
-                ps->pes_stream_id = pkt.b [header_size + 3];
-                ps->same_stream_id = true;
+                ps.pes_stream_id = pkt.b [header_size + 3];
+                ps.same_stream_id = true;
             }
-            else if (ps->pes_stream_id != pkt.b[header_size + 3]) {
+            else if (ps.pes_stream_id != pkt.b[header_size + 3]) {
                 // Got different values of stream_id in PES packets
-                ps->same_stream_id = false;
+                ps.same_stream_id = false;
+            }
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Parallel analysis: restrict the analysis to a shard of the PID's.
+//----------------------------------------------------------------------------
+
+void ts::TSAnalyzer::setShard(size_t index, size_t count)
+{
+    _shard_index = count <= 1 ? 0 : index;
+    _shard_count = std::max<size_t>(count, 1);
+    _shard_pids.reset();
+    for (PID pid = 0; pid < PID_MAX; ++pid) {
+        _shard_pids.set(pid, ShardIndex(pid, _shard_count) == _shard_index);
+    }
+
+    // PES packets are analyzed in the shard of their PID only.
+    _pes_demux.setPIDFilter(_shard_pids);
+}
+
+
+//----------------------------------------------------------------------------
+// Parallel analysis: merge the analysis of another shard of the same stream.
+//----------------------------------------------------------------------------
+
+void ts::TSAnalyzer::mergeShard(TSAnalyzer& other)
+{
+    // The first shard has the PSI/SI analysis and the complete list of PID's.
+    // The PID contexts of the other shard contain the per-PID analysis of its own PID's.
+    for (const auto& it : other._pids) {
+        if (other._shard_pids.test(it.first) && !_shard_pids.test(it.first)) {
+            const auto cur = _pids.find(it.first);
+            if (cur == _pids.end()) {
+                _pids[it.first] = it.second;
+            }
+            else {
+                MergePIDAnalysis(*cur->second, *it.second);
             }
         }
     }
+    _shard_pids |= other._shard_pids;
+    _pes_demux.setPIDFilter(_shard_pids);
+
+    // Global counters which are accumulated from per-PID packet analysis.
+    _scrambled_pid_cnt += other._scrambled_pid_cnt;
+    _pcr_pid_cnt += other._pcr_pid_cnt;
+    _ts_bitrate_sum += other._ts_bitrate_sum;
+    _ts_bitrate_cnt += other._ts_bitrate_cnt;
+    _modified = true;
+}
+
+void ts::TSAnalyzer::MergePIDAnalysis(PIDContext& ps, const PIDContext& other)
+{
+    // Results of PES analysis, after the PSI/SI attributes.
+    if (other.audio2.isValid() && (ps.stream_type == ST_MPEG1_AUDIO || ps.stream_type == ST_MPEG2_AUDIO)) {
+        AppendUnique(ps.attributes, other.audio2.toString());
+    }
+    for (const auto& attr : other.attributes) {
+        AppendUnique(ps.attributes, attr);
+    }
+    ps.audio2 = other.audio2;
+    ps.inv_pes = other.inv_pes;
+
+    // Results of packet analysis.
+    ps.scrambled = other.scrambled;
+    ps.same_stream_id = other.same_stream_id;
+    ps.pes_stream_id = other.pes_stream_id;
+    ps.ts_pkt_cnt = other.ts_pkt_cnt;
+    ps.ts_af_cnt = other.ts_af_cnt;
+    ps.unit_start_cnt = other.unit_start_cnt;
+    ps.pl_start_cnt = other.pl_start_cnt;
+    ps.unexp_discont = other.unexp_discont;
+    ps.exp_discont = other.exp_discont;
+    ps.duplicated = other.duplicated;
+    ps.ts_sc_cnt = other.ts_sc_cnt;
+    ps.inv_ts_sc_cnt = other.inv_ts_sc_cnt;
+    ps.inv_pes_start = other.inv_pes_start;
+    ps.first_pcr = other.first_pcr;
+    ps.last_pcr = other.last_pcr;
+    ps.first_pts = other.first_pts;
+    ps.last_pts = other.last_pts;
+    ps.first_dts = other.first_dts;
+    ps.last_dts = other.last_dts;
+    ps.pcr_cnt = other.pcr_cnt;
+    ps.pts_cnt = other.pts_cnt;
+    ps.dts_cnt = other.dts_cnt;
+    ps.pcr_leap_cnt = other.pcr_leap_cnt;
+    ps.pts_leap_cnt = other.pts_leap_cnt;
+    ps.dts_leap_cnt = other.dts_leap_cnt;
+    ps.cur_continuity = other.cur_continuity;
+    ps.cur_ts_sc = other.cur_ts_sc;
+    ps.cur_ts_sc_pkt = other.cur_ts_sc_pkt;
+    ps.cryptop_cnt = other.cryptop_cnt;
+    ps.cryptop_ts_cnt = other.cryptop_ts_cnt;
+    ps.br_last_pcr = other.br_last_pcr;
+    ps.br_last_pcr_pkt = other.br_last_pcr_pkt;
+    ps.ts_bitrate_sum = other.ts_bitrate_sum;
+    ps.ts_bitrate_cnt = other.ts_bitrate_cnt;
 }
 
 
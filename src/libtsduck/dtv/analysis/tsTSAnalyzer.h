@@ -13,6 +13,7 @@
 
 #pragma once
 #include "tsTSPacket.h"
+#include "tsTSPacketHeaders.h"
 #include "tsSectionDemux.h"
 #include "tsPESDemux.h"
 #include "tsT2MIDemux.h"
@@ -66,6 +67,14 @@ namespace ts {
         //!
         void feedPacket(const TSPacket& packet);
 
+        //!
+        //! Feed the analyzer with a contiguous array of TS packets, the headers of which are already decoded.
+        //! This is equivalent to calling feedPacket() on each packet but the decoded headers are reused.
+        //! @param [in] packets Address of the first packet.
+        //! @param [in] headers Decoded headers of the packets. The number of packets is @a headers.size().
+        //!
+        void feedPackets(const TSPacket* packets, const TSPacketHeaders& headers);
+
         //!
         //! Reset the analysis context.
         //!
@@ -103,6 +112,84 @@ namespace ts {
             _max_consecutive_suspects = count;
         }
 
+        //!
+        //! Restrict the per-PID analysis to a subset ("shard") of the PID's, for parallel analysis.
+        //!
+        //! A large stream can be analyzed by several TSAnalyzer instances in parallel threads.
+        //! The first shard (index 0) receives all packets using feedShardRouter(). It performs
+        //! the analysis which needs the complete stream (packet counters, invalid and suspect
+        //! packets, PSI/SI and T2-MI) and the per-PID analysis of its own shard of PID's. It tells
+        //! which packets shall be passed to the other shards. The other shards receive the packets
+        //! of their own PID's using feedShardPacket(). They also receive the PAT and PMT packets,
+        //! which are only used to identify the codecs of the PES PID's. At the end of the stream,
+        //! all shards are merged into the first one using mergeShard(). The merged analysis is
+        //! identical to the analysis of the complete stream by one single instance.
+        //!
+        //! Must be called before feeding the first packet. The shard is cleared by reset().
+        //! @param [in] index Index of this shard, from 0 to @a count - 1.
+        //! @param [in] count Total number of shards. Shard @a index contains all PID's for
+        //! which the remainder of the division by @a count is @a index.
+        //! @see ShardIndex()
+        //!
+        void setShard(size_t index, size_t count);
+
+        //!
+        //! Get the index of the shard which analyzes the packets of a PID in a parallel analysis.
+        //! @param [in] pid A PID value.
+        //! @param [in] count Total number of shards.
+        //! @return The index of the shard of @a pid.
+        //! @see setShard()
+        //!
+        static size_t ShardIndex(PID pid, size_t count) { return count <= 1 ? 0 : pid % count; }
+
+        //!
+        //! Where a packet shall be passed after being analyzed by the first shard.
+        //! @see feedShardRouter()
+        //!
+        enum class ShardRoute {
+            NONE,   //!< The packet is analyzed by the first shard only.
+            OWNER,  //!< Pass the packet to the shard of its PID, see ShardIndex().
+            ALL,    //!< Pass the packet to all other shards (PAT or PMT packet).
+        };
+
+        //!
+        //! Feed the first shard of a parallel analysis with a TS packet.
+        //! All packets of the stream shall be passed to the first shard using this method.
+        //! @param [in] packet One TS packet from the stream.
+        //! @param [out] index Index of the packet in the stream, to pass to feedShardPacket().
+        //! @return Where to pass the packet next.
+        //! @see setShard()
+        //!
+        ShardRoute feedShardRouter(const TSPacket& packet, uint64_t& index);
+
+        //!
+        //! Feed the first shard of a parallel analysis with a contiguous array of TS packets, the headers of which are already decoded.
+        //! This is equivalent to calling feedShardRouter() on each packet but the decoded headers are reused.
+        //! @param [in] packets Address of the first packet.
+        //! @param [in] headers Decoded headers of the packets. The number of packets is @a headers.size().
+        //! @param [out] routes Where to pass each packet next.
+        //! @param [out] indexes Index of each packet in the stream, to pass to feedShardPacket().
+        //!
+        void feedShardRouter(const TSPacket* packets, const TSPacketHeaders& headers, std::vector<ShardRoute>& routes, std::vector<uint64_t>& indexes);
+
+        //!
+        //! Feed another shard than the first one of a parallel analysis with a TS packet.
+        //! @param [in] packet One TS packet from the stream, as routed by feedShardRouter() in the first shard.
+        //! @param [in] index Index of the packet in the stream, as returned by feedShardRouter().
+        //! @see setShard()
+        //!
+        void feedShardPacket(const TSPacket& packet, uint64_t index);
+
+        //!
+        //! Merge the analysis of another shard of the same stream into this analyzer.
+        //! This analyzer must be the first shard.
+        //! @param [in,out] other Another analyzer of the same stream, with a distinct shard of PID's.
+        //! The results of the per-PID analysis of its shard are transferred to this object.
+        //! The @a other analyzer must be reset before being reused.
+        //! @see setShard()
+        //!
+        void mergeShard(TSAnalyzer& other);
+
         //!
         //! Get the list of service ids.
         //! @param [out] list The returned list of service ids.
@@ -401,7 +488,7 @@ namespace ts {
         //!
         //! Map of PIDContext, indexed by PID.
         //!
-        using PIDContextMap = std::map<PID, PIDContextPtr>;
+        using PIDContextMap = PIDTable<PIDContextPtr>;
 
         //!
         //! Check if a PID context exists.
@@ -528,6 +615,15 @@ namespace ts {
         virtual void handleT2MIPacket(T2MIDemux& demux, const T2MIPacket& pkt) override;
         virtual void handleTSPacket(T2MIDemux& demux, const T2MIPacket& t2mi, const TSPacket& ts) override;
 
+        // Analyze one packet, with the decoded header fields. Return where to pass it in a parallel analysis.
+        ShardRoute analyzePacket(const TSPacket& pkt, PID pid, uint8_t cc, uint8_t flags, uint64_t& packet_index);
+
+        // Per-PID analysis of one packet, in the shard of its PID.
+        void analyzePIDPacket(const TSPacket& pkt, PIDContext& ps, uint64_t packet_index, uint8_t cc, uint8_t flags);
+
+        // Merge the per-PID analysis from another shard into the context of the same PID.
+        static void MergePIDAnalysis(PIDContext& ps, const PIDContext& other);
+
         // TSAnalyzer private members (state data, used during analysis):
         bool         _modified = false;              // Internal data modified, need recomputeStatistics
         BitRate      _ts_bitrate_sum = 0;            // Sum of all computed TS bitrates
@@ -536,6 +632,9 @@ namespace ts {
         uint64_t     _preceding_suspects = 0;        // Number of contiguous suspects packets before current packet
         uint64_t     _min_error_before_suspect = 1;  // Required number of invalid packets before starting suspect
         uint64_t     _max_consecutive_suspects = 1;  // Max number of consecutive suspect packets before clearing suspect
+        size_t       _shard_index = 0;               // Index of this shard in a parallel analysis
+        size_t       _shard_count = 1;               // Number of shards in a parallel analysis
+        PIDSet       _shard_pids {};                 // PID's for which packets are analyzed in this instance
         SectionDemux _demux {_duck, this, this};     // PSI tables analysis
         PESDemux     _pes_demux {_duck, this};       // Audio/video analysis
         T2MIDemux    _t2mi_demux {_duck, this};      // T2-MI analysis
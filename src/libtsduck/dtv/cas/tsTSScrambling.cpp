@@ -40,7 +40,9 @@ ts::TSScrambling::TSScrambling(const TSScrambling& other) :
     _dvbcissa(),  // required on old gcc 10 and below (gcc bug)
     _idsa(),      // required on old gcc 10 and below (gcc bug)
     _aescbc(),    // required on old gcc 10 and below (gcc bug)
-    _aesctr()     // required on old gcc 10 and below (gcc bug)
+    _aesctr(),    // required on old gcc 10 and below (gcc bug)
+    _no_batch(other._no_batch),
+    _batch_mode(other._batch_mode)
 {
     setScramblingType(_scrambling_type);
     _dvbcsa[0].setEntropyMode(other._dvbcsa[0].entropyMode());
@@ -57,7 +59,9 @@ ts::TSScrambling::TSScrambling(TSScrambling&& other) :
     _dvbcissa(),  // required on old gcc 10 and below (gcc bug)
     _idsa(),      // required on old gcc 10 and below (gcc bug)
     _aescbc(),    // required on old gcc 10 and below (gcc bug)
-    _aesctr()     // required on old gcc 10 and below (gcc bug)
+    _aesctr(),    // required on old gcc 10 and below (gcc bug)
+    _no_batch(other._no_batch),
+    _batch_mode(other._batch_mode)
 {
     setScramblingType(_scrambling_type);
     _dvbcsa[0].setEntropyMode(other._dvbcsa[0].entropyMode());
@@ -73,6 +77,9 @@ bool ts::TSScrambling::setScramblingType(uint8_t scrambling, bool overrideExplic
 {
     if (overrideExplicit || !_explicit_type) {
 
+        // Process queued packets with the previous scramblers.
+        flushBatch();
+
         // Select the right pair of scramblers.
         switch (scrambling) {
             case SCRAMBLING_DVB_CSA1:
@@ -210,6 +217,13 @@ void ts::TSScrambling::defineArgs(Args &args)
     args.option(u"dvb-csa2");
     args.help(u"dvb-csa2", u"Use DVB-CSA2 scrambling. This is the default.");
 
+    args.option(u"no-batch");
+    args.help(u"no-batch",
+              u"With DVB-CSA2, do not process packets in parallel. "
+              u"By default, packets which use the same control word are grouped and processed in parallel "
+              u"using a bitsliced implementation of the stream cipher, which is faster. "
+              u"This option can be used for performance comparisons.");
+
     args.option(u"no-entropy-reduction", 'n');
     args.help(u"no-entropy-reduction",
               u"With DVB-CSA2, do not perform control word entropy reduction to 48 bits. "
@@ -259,6 +273,9 @@ bool ts::TSScrambling::loadArgs(DuckContext& duck, Args& args)
     // Set DVB-CSA2 entropy mode regardless of --atis-idsa or --dvb-cissa in case we switch later to DVB-CSA2.
     setEntropyMode(args.present(u"no-entropy-reduction") ? DVBCSA2::FULL_CW : DVBCSA2::REDUCE_ENTROPY);
 
+    // Batch processing of packets.
+    _no_batch = args.present(u"no-batch");
+
     // Set AES-CBC/CTR initialization vector. The default is all zeroes.
     const ByteBlock iv(args.hexaValue(u"iv", ByteBlock(AES128::BLOCK_SIZE, 0x00)));
     if (!_aescbc[0].setIV(iv.data(), iv.size()) ||
@@ -345,11 +362,14 @@ bool ts::TSScrambling::start()
 
 bool ts::TSScrambling::stop()
 {
+    // Process remaining queued packets.
+    const bool success = flushBatch();
+
     // Close the output file for control words, if one was created.
     if (_out_cw_file.is_open()) {
         _out_cw_file.close();
     }
-    return true;
+    return success;
 }
 
 
@@ -429,6 +449,11 @@ bool ts::TSScrambling::setCW(const ByteBlock& cw, int parity)
     BlockCipher* algo = _scrambler[parity & 1];
     assert(algo != nullptr);
 
+    // Packets which were queued with the previous key must be processed first.
+    if (!flushBatch(parity)) {
+        return false;
+    }
+
     if (algo->setKey(cw.data(), cw.size())) {
         _report.debug(u"using scrambling key: " + UString::Dump(cw, UString::SINGLE_LINE));
         return true;
@@ -490,6 +515,12 @@ bool ts::TSScrambling::encrypt(TSPacket& pkt)
         psize -= psize % algo->blockSize();
     }
 
+    // In batch mode, queue the payload, it will be encrypted later.
+    if (algo == &_dvbcsa[_encrypt_scv & 1] && _batch_mode && psize > 0) {
+        pkt.setScrambling(_encrypt_scv);
+        return queueBatch(pkt.getPayload(), psize, _encrypt_scv, true);
+    }
+
     // Encrypt the packet. Encrypting "in place" is handled by the API.
     const bool ok = psize == 0 || algo->encrypt(pkt.getPayload(), psize, pkt.getPayload(), psize);
     if (ok) {
@@ -535,6 +566,12 @@ bool ts::TSScrambling::decrypt(TSPacket& pkt)
         psize -= psize % algo->blockSize();
     }
 
+    // In batch mode, queue the payload, it will be decrypted later.
+    if (algo == &_dvbcsa[_decrypt_scv & 1] && _batch_mode && psize > 0) {
+        pkt.setScrambling(SC_CLEAR);
+        return queueBatch(pkt.getPayload(), psize, _decrypt_scv, false);
+    }
+
     // Decrypt the packet. Decrypting "in place" is handled by the API.
     const bool ok = psize == 0 || algo->decrypt(pkt.getPayload(), psize, pkt.getPayload(), psize);
     if (ok) {
@@ -545,3 +582,68 @@ bool ts::TSScrambling::decrypt(TSPacket& pkt)
     }
     return ok;
 }
+
+
+//----------------------------------------------------------------------------
+// Batch processing of packets.
+//----------------------------------------------------------------------------
+
+size_t ts::TSScrambling::batchSize() const
+{
+    return !_no_batch && (_scrambling_type == SCRAMBLING_DVB_CSA1 || _scrambling_type == SCRAMBLING_DVB_CSA2) ? DVBCSA2::BatchSize() : 0;
+}
+
+bool ts::TSScrambling::setBatchMode(bool on)
+{
+    const bool ok = on || flushBatch();
+    _batch_mode = on;
+    return ok;
+}
+
+bool ts::TSScrambling::queueBatch(uint8_t* data, size_t size, int parity, bool encrypt)
+{
+    // A TSScrambling instance is normally used in only one direction. Just in case, never mix them in the queues.
+    if (encrypt != _batch_encrypt && !flushBatch()) {
+        return false;
+    }
+    _batch_encrypt = encrypt;
+
+    // Queue the payload. Process the queue when there are enough packets to fill all parallel slots.
+    _batch_data[parity & 1].push_back(data);
+    _batch_sizes[parity & 1].push_back(size);
+    return _batch_data[parity & 1].size() < DVBCSA2::BatchSize() || flushBatch(parity);
+}
+
+bool ts::TSScrambling::flushBatch()
+{
+    const bool ok0 = flushBatch(0);
+    const bool ok1 = flushBatch(1);
+    return ok0 && ok1;
+}
+
+bool ts::TSScrambling::flushBatch(int parity)
+{
+    std::vector<uint8_t*>& data(_batch_data[parity & 1]);
+    std::vector<size_t>& sizes(_batch_sizes[parity & 1]);
+    assert(data.size() == sizes.size());
+
+    bool ok = true;
+    if (!data.empty()) {
+        DVBCSA2& algo(_dvbcsa[parity & 1]);
+        if (_batch_encrypt) {
+            ok = algo.encryptBatch(data.data(), sizes.data(), data.size());
+            if (!ok) {
+                _report.error(u"packet encryption error using %s", algo.name());
+            }
+        }
+        else {
+            ok = algo.decryptBatch(data.data(), sizes.data(), data.size());
+            if (!ok) {
+                _report.error(u"packet decryption error using %s", algo.name());
+            }
+        }
+        data.clear();
+        sizes.clear();
+    }
+    return ok;
+}
@@ -191,6 +191,44 @@ namespace ts {
         //!
         bool decrypt(TSPacket& pkt);
 
+        //!
+        //! Get the preferred number of packets to process at once in batch mode.
+        //! @return The number of packets which are processed in parallel by the current
+        //! scrambling algorithm or zero if the algorithm does not support batch processing
+        //! or if batch processing was disabled on the command line.
+        //!
+        size_t batchSize() const;
+
+        //!
+        //! Set the batch processing mode.
+        //!
+        //! In batch mode, with DVB-CSA2, encrypt() and decrypt() update the scrambling_control
+        //! bits in the packet header but the payload is only queued. All queued packets which
+        //! use the same control word are processed in parallel. The queued packets are processed
+        //! when enough packets are available, when the control word changes and when flushBatch()
+        //! is called. The application must call flushBatch() before using the content of the
+        //! packets and before the packets are moved or destroyed.
+        //!
+        //! With other scrambling algorithms, encrypt() and decrypt() always process the packet immediately.
+        //!
+        //! @param [in] on True to enable batch mode, false to disable it. When disabling the batch mode,
+        //! all queued packets are processed first.
+        //! @return True on success, false on error while processing queued packets.
+        //!
+        bool setBatchMode(bool on);
+
+        //!
+        //! Check if the batch processing mode is enabled.
+        //! @return True if the batch processing mode is enabled.
+        //!
+        bool batchMode() const { return _batch_mode; }
+
+        //!
+        //! Process all packets which were queued by encrypt() or decrypt() in batch mode.
+        //! @return True on success, false on error.
+        //!
+        bool flushBatch();
+
     private:
         // List of control words
         using CWList = std::list<ByteBlock>;
@@ -210,6 +248,17 @@ namespace ts {
         CBC<AES128>      _aescbc[2] {};
         CTR<AES128>      _aesctr[2] {};
         BlockCipher*     _scrambler[2] {nullptr, nullptr};
+        bool             _no_batch = false;        // Batch mode disabled on command line.
+        bool             _batch_mode = false;      // Batch mode is currently enabled.
+        bool             _batch_encrypt = false;   // Queued packets are to be encrypted (decrypted otherwise).
+        std::vector<uint8_t*> _batch_data[2] {};   // Queued payloads, index 0 = even key, 1 = odd key.
+        std::vector<size_t>   _batch_sizes[2] {};  // Sizes of queued payloads.
+
+        // Queue a payload in batch mode. Return false on error.
+        bool queueBatch(uint8_t* data, size_t size, int parity, bool encrypt);
+
+        // Process all queued payloads for one parity.
+        bool flushBatch(int parity);
 
         // Set the next fixed control word as scrambling key.
         bool setNextFixedCW(int parity);
@@ -542,9 +542,25 @@ size_t ts::ARIBCharset::FindEncoderEntry(char32_t code_point, size_t hint)
         // Code point is too far, hint was useless, try standard method.
     }
 
-    // Dichotomic search.
-    size_t begin = 0;
-    size_t end = ENCODING_COUNT;
+    // Index of the first entry in the encoding table for each 256-code-point page of the
+    // basic multilingual plane. The last index is the first entry after the BMP. Built once.
+    static const auto pages = []() {
+        std::array<uint16_t, 257> idx;
+        size_t e = 0;
+        for (size_t p = 0; p < idx.size(); ++p) {
+            while (e < ENCODING_COUNT && ENCODING_TABLE[e].code_point + ENCODING_TABLE[e].count() <= (p << 8)) {
+                ++e;
+            }
+            idx[p] = uint16_t(e);
+        }
+        return idx;
+    }();
+
+    // Dichotomic search, limited to the page of the code point. Add the first entry of next page
+    // because a slice which starts in this page may end in the next one.
+    const size_t page = std::min<size_t>(code_point >> 8, pages.size() - 1);
+    size_t begin = pages[page];
+    size_t end = page + 1 < pages.size() ? std::min(ENCODING_COUNT, pages[page + 1] + size_t(1)) : ENCODING_COUNT;
 
     while (begin < end) {
         const size_t mid = begin + (end - begin) / 2;
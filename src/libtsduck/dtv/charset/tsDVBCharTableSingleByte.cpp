@@ -8,7 +8,17 @@
 
 #include "tsDVBCharTableSingleByte.h"
 #include "tsUString.h"
-#include "tsAlgorithm.h"
+
+// Select the SIMD implementation of the ASCII fast path, same as in UTF-8 conversions.
+#if defined(TS_NO_SIMD_INSTRUCTIONS)
+    // Disabled at compile time.
+#elif defined(TS_X86_64) && (defined(TS_GCC) || defined(TS_LLVM) || defined(TS_MSC))
+    #define TS_SIMD_SSE2 1
+    #include <emmintrin.h>
+#elif defined(TS_ARM64) && defined(TS_LITTLE_ENDIAN) && defined(__ARM_NEON)
+    #define TS_SIMD_NEON 1
+    #include <arm_neon.h>
+#endif
 
 // Static instances of corresponding DVB charsets.
 const ts::DVBCharset ts::DVBCharTableSingleByte::DVB_ISO_6937(u"ISO-6937", &RAW_ISO_6937);
@@ -44,16 +54,16 @@ ts::DVBCharTableSingleByte::DVBCharTableSingleByte(const UChar* name, uint32_t t
 
     // Code point to byte mapping for ASCII range
     for (size_t i = 0x20; i <= 0x7E; i++) {
-        _bytesMap.insert(std::make_pair(UChar(i), uint8_t(i)));
+        addReverseMapping(UChar(i), uint8_t(i));
     }
 
     // Control codes
-    _bytesMap.insert(std::make_pair(LINE_FEED, DVB_SINGLE_BYTE_CRLF));
+    addReverseMapping(LINE_FEED, DVB_SINGLE_BYTE_CRLF);
 
     // Code point to byte mapping for 0xA0-0xFF range
     for (size_t i = 0; i < _upperCodePoints.size(); i++) {
         if (_upperCodePoints[i] != 0) {
-            _bytesMap.insert(std::make_pair(UChar(_upperCodePoints[i]), uint8_t(0xA0 + i)));
+            addReverseMapping(UChar(_upperCodePoints[i]), uint8_t(0xA0 + i));
         }
     }
 
@@ -66,6 +76,89 @@ ts::DVBCharTableSingleByte::DVBCharTableSingleByte(const UChar* name, uint32_t t
 }
 
 
+//----------------------------------------------------------------------------
+// Add a code point in the reverse mapping, if not already present.
+//----------------------------------------------------------------------------
+
+void ts::DVBCharTableSingleByte::addReverseMapping(UChar cp, uint8_t value)
+{
+    uint8_t& page(_bytesPageIndex[cp >> 8]);
+    if (page == 0) {
+        // Allocate a new page, initially empty.
+        _bytesPages.emplace_back();
+        _bytesPages.back().fill(0);
+        page = uint8_t(_bytesPages.size());
+    }
+    uint8_t& b(_bytesPages[page - 1][cp & 0xFF]);
+    if (b == 0) {
+        b = value;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Scan or encode blocks of printable ASCII characters (0x20 to 0x7E), 16
+// characters at a time. Stop before the first block containing another
+// character. Return the number of characters, a multiple of 16. Without
+// SIMD instructions, return zero and let the caller use a plain loop.
+//----------------------------------------------------------------------------
+
+namespace {
+    inline size_t ScanASCIIBlocks([[maybe_unused]] const uint8_t* in, [[maybe_unused]] size_t count)
+    {
+        size_t done = 0;
+#if defined(TS_SIMD_SSE2)
+        const __m128i low = _mm_set1_epi8(0x1F);
+        const __m128i high = _mm_set1_epi8(0x7F);
+        for (; done + 16 <= count; done += 16) {
+            const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + done));
+            if (_mm_movemask_epi8(_mm_and_si128(_mm_cmpgt_epi8(a, low), _mm_cmplt_epi8(a, high))) != 0xFFFF) {
+                break;
+            }
+        }
+#elif defined(TS_SIMD_NEON)
+        for (; done + 16 <= count; done += 16) {
+            const uint8x16_t a = vld1q_u8(in + done);
+            if (vminvq_u8(a) < 0x20 || vmaxvq_u8(a) > 0x7E) {
+                break;
+            }
+        }
+#endif
+        return done;
+    }
+
+    inline size_t EncodeASCIIBlocks([[maybe_unused]] const ts::UChar* in, [[maybe_unused]] uint8_t* out, [[maybe_unused]] size_t count)
+    {
+        size_t done = 0;
+#if defined(TS_SIMD_SSE2)
+        // Signed 16-bit comparisons: characters 0x8000 and above are negative and rejected by the lower bound.
+        const __m128i low = _mm_set1_epi16(0x1F);
+        const __m128i high = _mm_set1_epi16(0x7F);
+        for (; done + 16 <= count; done += 16) {
+            const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + done));
+            const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + done + 8));
+            const __m128i ok_a = _mm_and_si128(_mm_cmpgt_epi16(a, low), _mm_cmplt_epi16(a, high));
+            const __m128i ok_b = _mm_and_si128(_mm_cmpgt_epi16(b, low), _mm_cmplt_epi16(b, high));
+            if (_mm_movemask_epi8(_mm_and_si128(ok_a, ok_b)) != 0xFFFF) {
+                break;
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + done), _mm_packus_epi16(a, b));
+        }
+#elif defined(TS_SIMD_NEON)
+        for (; done + 16 <= count; done += 16) {
+            const uint16x8_t a = vld1q_u16(reinterpret_cast<const uint16_t*>(in + done));
+            const uint16x8_t b = vld1q_u16(reinterpret_cast<const uint16_t*>(in + done + 8));
+            if (vminvq_u16(vminq_u16(a, b)) < 0x20 || vmaxvq_u16(vmaxq_u16(a, b)) > 0x7E) {
+                break;
+            }
+            vst1q_u8(out + done, vcombine_u8(vmovn_u16(a), vmovn_u16(b)));
+        }
+#endif
+        return done;
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Decode a DVB string from the specified byte buffer.
 //----------------------------------------------------------------------------
@@ -79,6 +172,22 @@ bool ts::DVBCharTableSingleByte::decode(UString& str, const uint8_t* dvb, size_t
     bool hasDiacritical = false;
 
     for (; dvb != nullptr && dvbSize > 0; --dvbSize) {
+        // Fast path: decode a run of ASCII characters, identical in all single-byte tables.
+        if (!reverseNext && *dvb >= 0x20 && *dvb <= 0x7E) {
+            const uint8_t* const first = dvb;
+            const size_t blocks = ScanASCIIBlocks(dvb, dvbSize);
+            dvb += blocks;
+            dvbSize -= blocks;
+            while (dvbSize > 0 && *dvb >= 0x20 && *dvb <= 0x7E) {
+                ++dvb;
+                --dvbSize;
+            }
+            str.append(first, dvb);
+            if (dvbSize == 0) {
+                break;
+            }
+        }
+
         // Get next byte
         const uint8_t b = *dvb++;
         // Convert it to a code point
@@ -128,9 +237,10 @@ bool ts::DVBCharTableSingleByte::decode(UString& str, const uint8_t* dvb, size_t
 
 bool ts::DVBCharTableSingleByte::canEncode(const UString& str, size_t start, size_t count) const
 {
-    for (size_t i = 0; i < str.length(); ++i) {
+    const size_t end = start + std::min(count, str.length() - std::min(start, str.length()));
+    for (size_t i = start; i < end; ++i) {
         const UChar cp = str[i];
-        if (!Contains(_bytesMap, cp) && cp != CARRIAGE_RETURN) {
+        if (encodeChar(cp) == 0 && cp != CARRIAGE_RETURN) {
             // Untranslatable character.
             return false;
         }
@@ -146,15 +256,35 @@ bool ts::DVBCharTableSingleByte::canEncode(const UString& str, size_t start, siz
 size_t ts::DVBCharTableSingleByte::encode(uint8_t*& buffer, size_t& size, const UString& str, size_t start, size_t count) const
 {
     uint8_t* const base = buffer;
+    const size_t length = str.length();
     size_t result = 0;
 
     // Serialize characters as long as there is free space.
-    while (buffer != nullptr && size > 0 && start < str.length() && count > 0) {
-        const UChar cp = str[start];
-        const auto it = _bytesMap.find(cp);
-        if (cp != ts::CARRIAGE_RETURN && it != _bytesMap.end()) {
+    while (buffer != nullptr && size > 0 && start < length && count > 0) {
+
+        // Fast path: encode a run of ASCII characters, identical in all single-byte tables.
+        const UChar* const in = str.data() + start;
+        const size_t max = std::min(std::min(size, count), length - start);
+        size_t ascii = EncodeASCIIBlocks(in, buffer, max);
+        while (ascii < max && in[ascii] >= 0x20 && in[ascii] <= 0x7E) {
+            buffer[ascii] = uint8_t(in[ascii]);
+            ascii++;
+        }
+        if (ascii > 0) {
+            buffer += ascii;
+            size -= ascii;
+            result += ascii;
+            start += ascii;
+            count -= ascii;
+            continue;
+        }
+
+        // Other characters.
+        const UChar cp = *in;
+        const uint8_t b = encodeChar(cp);
+        if (b != 0) {
             // Encode character.
-            *buffer = it->second;
+            *buffer = b;
             size--;
             // Reverse letter and diacritical mark when necessary.
             if (buffer > base && *buffer >= 0xA0 && _reversedDiacritical.test(*buffer - 0xA0)) {
@@ -87,8 +87,22 @@ namespace ts {
         // List of code points for byte values 0xA0-0xFF. Always contain 96 values.
         const std::vector<uint16_t> _upperCodePoints {};
 
-        // Reverse mapping for complete character set (key = code point, value = byte rep).
-        std::map<UChar, uint8_t> _bytesMap {};
+        // Reverse mapping for complete character set, using a two-level table, indexed by the most
+        // significant byte of the code point (page), then the least significant byte. The final value
+        // is the byte representation. Zero means "not encodable" since 0x00 is never an encoded value.
+        using BytesPage = std::array<uint8_t, 256>;
+        std::array<uint8_t, 256> _bytesPageIndex {};  // For each page, index + 1 in _bytesPages, zero if unused.
+        std::vector<BytesPage>   _bytesPages {};      // Used pages, a few per character set.
+
+        // Add a code point in the reverse mapping, if not already present.
+        void addReverseMapping(UChar cp, uint8_t value);
+
+        // Get the byte representation of a code point, zero if not encodable.
+        uint8_t encodeChar(UChar cp) const
+        {
+            const uint8_t page = _bytesPageIndex[cp >> 8];
+            return page == 0 ? 0 : _bytesPages[page - 1][cp & 0xFF];
+        }
 
         // Bitmap of combining diacritical marks which precede their base letter (and must be reversed from Unicode).
         // This only applies to byte values 0xA0-0xFF (96 values).
@@ -8,7 +8,6 @@
 
 #include "tsDVBCharTableUTF8.h"
 #include "tsUString.h"
-#include "tsMemory.h"
 
 
 //----------------------------------------------------------------------------
@@ -53,33 +52,33 @@ bool ts::DVBCharTableUTF8::canEncode(const UString& str, size_t start, size_t co
 
 size_t ts::DVBCharTableUTF8::encode(uint8_t*& buffer, size_t& size, const UString& str, size_t start, size_t count) const
 {
-    size_t result = 0;
+    if (buffer == nullptr || start >= str.length()) {
+        return 0;
+    }
+
+    const UChar* const first = str.data() + start;
+    const UChar* const last = first + std::min(count, str.length() - start);
+    const UChar* in = first;
 
     // Serialize characters as long as there is free space.
-    while (buffer != nullptr && size > 0 && start < str.length() && count > 0) {
-        if (str[start] != ts::CARRIAGE_RETURN) {
-
-            // Convert a 1-character string to UTF-8.
-            const std::string utf8(str.substr(start, 1).toUTF8());
-            const size_t len = utf8.length();
-            if (len > size) {
-                // Won't fit in the buffer, stop now.
+    while (in < last && size > 0) {
+        if (*in == ts::CARRIAGE_RETURN) {
+            // CR characters are not physically encoded, but still taken into account.
+            ++in;
+        }
+        else {
+            // Convert a sequence of characters without CR at once.
+            // The conversion stops at the first character which does not fit in the buffer.
+            const UChar* const end = std::find(in, last, ts::CARRIAGE_RETURN);
+            char* out = reinterpret_cast<char*>(buffer);
+            UString::ConvertUTF16ToUTF8(in, end, out, out + size);
+            size -= reinterpret_cast<uint8_t*>(out) - buffer;
+            buffer = reinterpret_cast<uint8_t*>(out);
+            if (in < end) {
+                // Buffer full.
                 break;
             }
-
-            // Small optimization.
-            if (len == 1) {
-                *buffer = uint8_t(utf8[0]);
-            }
-            else {
-                MemCopy(buffer, utf8.data(), len);
-            }
-            buffer += len;
-            size -= len;
         }
-        result++; // include CR characters, not physically encoded, but still taken into account.
-        start++;
-        count--;
     }
-    return result;
+    return in - first;
 }
@@ -87,14 +87,19 @@ void ts::DemuxedData::reload(const void* content, size_t content_size, PID sourc
 {
     _source_pid = source_pid;
     _first_pkt = _last_pkt = 0;
-    _data = std::make_shared<ByteBlock>(content, content_size);
+    const uint8_t* const data = reinterpret_cast<const uint8_t*>(content);
+    if (_data != nullptr && _data.use_count() == 1 && (data + content_size <= _data->data() || data >= _data->data() + _data->size())) {
+        // The previous content is not shared and does not overlap the new one, reuse its memory.
+        _data->copy(content, content_size);
+    }
+    else {
+        _data = std::make_shared<ByteBlock>(content, content_size);
+    }
 }
 
 void ts::DemuxedData::reload(const ByteBlock& content, PID source_pid)
 {
-    _source_pid = source_pid;
-    _first_pkt = _last_pkt = 0;
-    _data = std::make_shared<ByteBlock>(content);
+    reload(content.data(), content.size(), source_pid);
 }
 
 void ts::DemuxedData::reload(const ByteBlockPtr& content_ptr, PID source_pid)
@@ -13,6 +13,7 @@
 #include "tsTSPacket.h"
 #include "tsReportFile.h"
 #include "tsEIT.h"
+#include "tsAlgorithm.h"
 
 
 //----------------------------------------------------------------------------
@@ -478,7 +479,8 @@ void ts::SectionDemux::processPacket(const TSPacket& pkt)
             SectionPtr sect_ptr;
 
             if (section_ok && (_section_handler != nullptr || (tc != nullptr && tc->sects[section_number] == nullptr))) {
-                sect_ptr = std::make_shared<Section>(ts_start, section_length, pid, CRC32::CHECK);
+                sect_ptr = _section_pool.allocate();
+                sect_ptr->reload(ts_start, section_length, pid, CRC32::CHECK);
                 sect_ptr->setFirstTSPacketIndex(pusi_pkt_index);
                 sect_ptr->setLastTSPacketIndex(_packet_count);
                 if (!sect_ptr->isValid()) {
@@ -562,10 +564,16 @@ void ts::SectionDemux::processPacket(const TSPacket& pkt)
 
 void ts::SectionDemux::fixAndFlush(bool pack, bool fill_eit)
 {
-    // Loop on all PID's.
-    for (auto& it1 : _pids) {
-        const PID pid = it1.first;
-        PIDContext& pc(it1.second);
+    // Get the list of PID's first, then search each of them one by one.
+    // Because a handler can reset other PID's, we cannot call handlers while walking through _pids.
+    const std::set<PID> pids(MapKeysSet(_pids));
+    for (auto pid : pids) {
+        const auto it1 = _pids.find(pid);
+        if (it1 == _pids.end()) {
+            // PID context was removed by a handler.
+            continue;
+        }
+        PIDContext& pc(it1->second);
 
         // Mark that we are in the context of a table or section handler.
         // This is used to prevent the destruction of PID contexts during
@@ -18,6 +18,9 @@
 #include "tsSectionHandlerInterface.h"
 #include "tsInvalidSectionHandlerInterface.h"
 #include "tsETID.h"
+#include "tsPIDTable.h"
+#include "tsSharedPool.h"
+#include "tsSection.h"
 
 namespace ts {
     //!
@@ -151,6 +154,28 @@ namespace ts {
             _ts_error_level = level;
         }
 
+        //!
+        //! Set the maximum number of recycled sections.
+        //! The demux keeps a pool of Section objects. When the application releases all
+        //! references to a section which was passed to a handler, the Section object and
+        //! its memory are reused for a subsequent section, avoiding memory allocations.
+        //! @param [in] count Maximum number of sections in the pool. Zero disables recycling.
+        //! The default is SharedPool::DEFAULT_MAX_SIZE.
+        //!
+        void setSectionPoolSize(size_t count)
+        {
+            _section_pool.setMaxSize(count);
+        }
+
+        //!
+        //! Get the pool of sections, typically to get its statistics.
+        //! @return A constant reference to the pool of sections.
+        //!
+        const SharedPool<Section>& sectionPool() const
+        {
+            return _section_pool;
+        }
+
         //!
         //! Demux status information.
         //! It contains error counters.
@@ -278,7 +303,8 @@ namespace ts {
         TableHandlerInterface*          _table_handler = nullptr;
         SectionHandlerInterface*        _section_handler = nullptr;
         InvalidSectionHandlerInterface* _invalid_handler = nullptr;
-        std::map<PID,PIDContext>        _pids {};
+        PIDTable<PIDContext>            _pids {};
+        SharedPool<Section>             _section_pool {};
         Status _status {};
         bool   _get_current = true;
         bool   _get_next = false;
@@ -99,6 +99,18 @@ ts::EITGenerator::Event::Event(const uint8_t*& data, size_t& size)
 }
 
 
+//----------------------------------------------------------------------------
+// EService: Locate the segment with the given start time or the first one after it.
+//----------------------------------------------------------------------------
+
+ts::EITGenerator::ESegmentList::iterator ts::EITGenerator::EService::findSegment(const Time& seg_start_time)
+{
+    // Segments are sorted by start time, use a binary search.
+    return std::lower_bound(segments.begin(), segments.end(), seg_start_time,
+                            [](const ESegmentPtr& seg, const Time& start) { return seg->start_time < start; });
+}
+
+
 //----------------------------------------------------------------------------
 // ESection: Constructor of the structure for a section, ready to inject.
 //----------------------------------------------------------------------------
@@ -253,27 +265,25 @@ bool ts::EITGenerator::loadEvents(const ServiceIdTriplet& service_id, const uint
         }
 
         // Check if the same event id already existed in the service.
-        if (Contains(srv->event_ids, ev->event_id)) {
-            // Look for existing event in this service with same id. Remove it if not an exact duplicate.
-            bool found = false;
+        const auto id_iter = srv->event_ids.find(ev->event_id);
+        if (id_iter != srv->event_ids.end()) {
+            // Look for existing event in this service with same id, directly in its segment. Remove it if not an exact duplicate.
             bool duplicate = false;
-            for (auto iseg = srv->segments.begin(); !found && iseg != srv->segments.end(); ++iseg) {
+            const auto iseg = srv->findSegment(id_iter->second);
+            if (iseg != srv->segments.end() && (*iseg)->start_time == id_iter->second) {
                 auto& events((*iseg)->events);
-                for (auto iev = events.begin(); !found && iev != events.end(); ++iev) {
-                    if ((*iev)->event_id == ev->event_id) {
-                        // Found the event with same id.
-                        found = true;
-                        duplicate = (*iev)->event_data == ev->event_data;
-                        // Remove event if not a duplicate.
-                        if (!duplicate) {
-                            _duck.report().log(2, u"discard modified event id %n, %s, previously starting %s", (*iev)->event_id, service_id, (*iev)->start_time);
-                            // Remove event from segment and service.
-                            events.erase(iev);
-                            srv->event_ids.erase(ev->event_id);
-                            // Mark all EIT schedule in this segment as to be regenerated.
-                            _regenerate = srv->regenerate = (*iseg)->regenerate = true;
-                            break;
-                        }
+                const auto iev = std::find_if(events.begin(), events.end(), [&ev](const EventPtr& e) { return e->event_id == ev->event_id; });
+                if (iev != events.end()) {
+                    // Found the event with same id.
+                    duplicate = (*iev)->event_data == ev->event_data;
+                    // Remove event if not a duplicate.
+                    if (!duplicate) {
+                        _duck.report().log(2, u"discard modified event id %n, %s, previously starting %s", (*iev)->event_id, service_id, (*iev)->start_time);
+                        // Remove event from segment and service.
+                        events.erase(iev);
+                        srv->event_ids.erase(id_iter);
+                        // Mark all EIT schedule in this segment as to be regenerated.
+                        _regenerate = srv->regenerate = (*iseg)->regenerate = true;
                     }
                 }
             }
@@ -288,10 +298,7 @@ bool ts::EITGenerator::loadEvents(const ServiceIdTriplet& service_id, const uint
         // empty intermediate segments. This will be done in regenerateSchedule().
 
         const Time seg_start_time(EIT::SegmentStartTime(ev->start_time));
-        auto seg_iter = srv->segments.begin();
-        while (seg_iter != srv->segments.end() && (*seg_iter)->start_time < seg_start_time) {
-            ++seg_iter;
-        }
+        auto seg_iter = srv->findSegment(seg_start_time);
         if (seg_iter == srv->segments.end() || (*seg_iter)->start_time != seg_start_time) {
             // The segment does not exist, create it.
             _duck.report().debug(u"create EIT segment starting at %s for %s", seg_start_time, service_id);
@@ -301,13 +308,11 @@ bool ts::EITGenerator::loadEvents(const ServiceIdTriplet& service_id, const uint
         ESegment& seg(**seg_iter);
 
         // Insert the binary event in the list of events for that segment.
-        auto ev_iter = seg.events.begin();
-        while (ev_iter != seg.events.end() && (*ev_iter)->start_time < ev->start_time) {
-            ++ev_iter;
-        }
+        const auto ev_iter = std::lower_bound(seg.events.begin(), seg.events.end(), ev->start_time,
+                                              [](const EventPtr& e, const Time& start) { return e->start_time < start; });
         _duck.report().log(2, u"load event id %n, %s, starting %s", ev->event_id, service_id, ev->start_time);
         seg.events.insert(ev_iter, ev);
-        srv->event_ids.insert(ev->event_id);
+        srv->event_ids[ev->event_id] = seg_start_time;
         ev_count++;
 
         // Mark all EIT schedule in this segment as to be regenerated.
@@ -675,11 +680,17 @@ void ts::EITGenerator::markObsoleteSection(ESection& sec)
         // accumulate because the EIT bandwidth is not large enough and low-priority
         // EIT schedule never get a chance to get selected (and discarded when marked
         // as obsolete). Do some garbage collecting to avoid infinite accumulation.
-        if (_obsolete_count > 100) {
+        // The threshold grows with the size of the queues: when a large EPG is entirely
+        // replaced, the queues are not scanned again and again for each batch of sections.
+        size_t queued_count = 0;
+        for (const auto& list : _injects) {
+            queued_count += list.size();
+        }
+        if (_obsolete_count > std::max<size_t>(100, queued_count / 4)) {
             // Loop on all injection queues.
             for (size_t index = 0; index < _injects.size(); ++index) {
                 // Loop on all sections in the queue.
-                ESectionList& list(_injects[index]);
+                ESectionQueue& list(_injects[index]);
                 auto it = list.begin();
                 while (it != list.end()) {
                     if ((*it)->obsolete) {
@@ -706,10 +717,14 @@ void ts::EITGenerator::enqueueInjectSection(const ESectionPtr& sec, const Time&
     sec->next_inject = next_inject;
 
     // Compute which injection queue to use.
-    ESectionList& list(_injects[size_t(_profile.sectionToProfile(*sec->section))]);
+    ESectionQueue& list(_injects[size_t(_profile.sectionToProfile(*sec->section))]);
 
     // Even start at from or back of the queue (possible optimization).
-    if (try_front) {
+    if (list.empty() || list.back()->next_inject <= next_inject) {
+        // Most frequent case when many sections are generated at the same time: no need to walk through the queue.
+        list.push_back(sec);
+    }
+    else if (try_front) {
         auto it = list.begin();
         while (it != list.end() && (*it)->next_inject <= next_inject) {
             ++it;
@@ -1160,7 +1175,7 @@ void ts::EITGenerator::updateForNewTime(const Time& now)
                 // Remove event id from service.
                 srv.event_ids.erase(seg.events.front()->event_id);
                 // Remove event from segment.
-                seg.events.pop_front();
+                seg.events.erase(seg.events.begin());
                 // Regenerate the segment, unless this is the current segment and we use the lazy update mode.
                 if (seg.start_time < now || !(_options & EITOptions::LAZY_SCHED_UPDATE)) {
                     _regenerate = srv.regenerate = seg.regenerate = true;
@@ -1206,7 +1221,7 @@ void ts::EITGenerator::provideSection(SectionCounter counter, SectionPtr& sectio
 
     // Make sure no section for the last injected {tid,tidext} is scheduled for _section_gap milliseconds.
     if (_last_tid != TID_NULL) {
-        ESectionList& list(_injects[_last_index]);
+        ESectionQueue& list(_injects[_last_index]);
         const Time next_inject = now + _section_gap;
         int gap_count = 0;
         auto it = list.begin();
@@ -355,7 +355,7 @@ namespace ts {
         };
 
         using EventPtr = std::shared_ptr<Event>;
-        using EventList = std::list<EventPtr>;
+        using EventList = std::vector<EventPtr>;
 
         // -----------------------------
         // Description of an EIT section
@@ -385,7 +385,8 @@ namespace ts {
         };
 
         using ESectionPtr = std::shared_ptr<ESection>;
-        using ESectionList = std::list<ESectionPtr>;      // a list of EIT schedule sections
+        using ESectionList = std::vector<ESectionPtr>;    // a list of EIT schedule sections (up to 8 in a segment)
+        using ESectionQueue = std::list<ESectionPtr>;     // an injection queue of EIT sections
         using ESectionPair = std::array<ESectionPtr, 2>;  // a pair of EIT p/f sections
 
         // ------------------------------------------------------------------
@@ -407,7 +408,7 @@ namespace ts {
         };
 
         using ESegmentPtr = std::shared_ptr<ESegment>;
-        using ESegmentList = std::list<ESegmentPtr>;
+        using ESegmentList = std::deque<ESegmentPtr>;
 
         // ------------------------
         // Description of a service
@@ -417,10 +418,13 @@ namespace ts {
         {
             TS_NOCOPY(EService);
         public:
-            bool               regenerate = false;  // Some segments must be regenerated in the service.
-            ESectionPair       pf {};               // EIT p/f sections (0: present, 1: following).
-            ESegmentList       segments {};         // List of 3-hour segments (EPG events and EIT schedule sections).
-            std::set<uint16_t> event_ids {};        // Existing event ids in that service, used as fast lookup of event presence.
+            bool                     regenerate = false;  // Some segments must be regenerated in the service.
+            ESectionPair             pf {};               // EIT p/f sections (0: present, 1: following).
+            ESegmentList             segments {};         // List of 3-hour segments (EPG events and EIT schedule sections), sorted by start time.
+            std::map<uint16_t, Time> event_ids {};        // Existing event ids in that service -> start time of their segment.
+
+            // Locate the segment with the given start time or the first one after it.
+            ESegmentList::iterator findSegment(const Time& seg_start_time);
 
             // Constructor.
             EService() = default;
@@ -443,7 +447,7 @@ namespace ts {
         // for the next injection.
 
         using EServiceMap = std::map<ServiceIdTriplet, EService>;
-        using ESectionListArray = std::array<ESectionList, EITRepetitionProfile::PROFILE_COUNT>;
+        using ESectionQueueArray = std::array<ESectionQueue, EITRepetitionProfile::PROFILE_COUNT>;
 
         // ---------------------------
         // EITGenerator private fields
@@ -466,7 +470,7 @@ namespace ts {
         SectionDemux         _demux;                     // Section demux for input stream, get PAT, TDT, TOT, EIT.
         Packetizer           _packetizer;                // Packetizer for generated EIT's.
         EServiceMap          _services {};               // Map of services -> segments -> events and sections.
-        ESectionListArray    _injects {};                // Arrays of sections for injection.
+        ESectionQueueArray   _injects {};                // Arrays of sections for injection.
         cn::milliseconds     _section_gap = cn::milliseconds(30);  // Minimum gap between sections of the same tid/tidext, DVB specifies at least 25 ms.
         TID                  _last_tid = TID_NULL;       // TID of last injected section, or 0.
         uint16_t             _last_tidext = 0;           // TIDEXT of last injected section.
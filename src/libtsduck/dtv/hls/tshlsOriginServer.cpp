@@ -0,0 +1,294 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2024, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+
+#include "tshlsOriginServer.h"
+#include "tsNullReport.h"
+#include "tsVersionString.h"
+
+#define SERVER_BACKLOG 16
+
+
+//----------------------------------------------------------------------------
+// Constructors and destructors.
+//----------------------------------------------------------------------------
+
+ts::hls::OriginServer::OriginServer(Report& report) :
+    Thread(ThreadAttributes().setStackSize(128 * 1024)),
+    _report(report)
+{
+}
+
+ts::hls::OriginServer::~OriginServer()
+{
+    stop();
+}
+
+ts::hls::OriginServer::Client::Client(OriginServer* server) :
+    Thread(ThreadAttributes().setStackSize(128 * 1024)),
+    _server(server)
+{
+}
+
+ts::hls::OriginServer::Client::~Client()
+{
+    waitForTermination();
+}
+
+
+//----------------------------------------------------------------------------
+// Start the HTTP server.
+//----------------------------------------------------------------------------
+
+bool ts::hls::OriginServer::start(const IPv4SocketAddress& address, bool reuse_port)
+{
+    _address = address;
+    _terminate = false;
+    if (!_server.open(_report)) {
+        return false;
+    }
+    if (!_server.reusePort(reuse_port, _report) || !_server.bind(_address, _report) || !_server.listen(SERVER_BACKLOG, _report)) {
+        _server.close(_report);
+        return false;
+    }
+    if (!Thread::start()) {
+        _report.error(u"cannot start HLS server thread");
+        _server.close(_report);
+        return false;
+    }
+    _started = true;
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Stop the HTTP server.
+//----------------------------------------------------------------------------
+
+void ts::hls::OriginServer::stop()
+{
+    // The server socket is closed here only, after the termination of the server thread.
+    if (_started) {
+        _terminate = true;
+
+        // Wake up the server thread, waiting in accept(), using a dummy connection.
+        IPv4SocketAddress addr(_address);
+        if (!addr.hasAddress()) {
+            addr.setAddress(IPv4Address::LocalHost);
+        }
+        TCPConnection dummy;
+        if (dummy.open(_report)) {
+            dummy.connect(addr, NULLREP);
+            dummy.close(NULLREP);
+        }
+        waitForTermination();
+        _server.close(_report);
+        _started = false;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Manage the files in memory.
+//----------------------------------------------------------------------------
+
+void ts::hls::OriginServer::setFile(const UString& name, const std::shared_ptr<const ByteBlock>& data, const UString& mime)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    File& file(_files[name]);
+    file.data = data;
+    file.mime = mime;
+}
+
+void ts::hls::OriginServer::removeFile(const UString& name)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _files.erase(name);
+}
+
+bool ts::hls::OriginServer::hasFile(const UString& name) const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _files.find(name) != _files.end();
+}
+
+
+//----------------------------------------------------------------------------
+// Server thread: accept client connections.
+//----------------------------------------------------------------------------
+
+void ts::hls::OriginServer::main()
+{
+    _report.debug(u"HLS server started on %s", _address);
+    std::list<std::unique_ptr<Client>> clients;
+
+    while (!_terminate) {
+        // Wait for a new client.
+        clients.push_back(std::make_unique<Client>(this));
+        Client& client(*clients.back());
+        if (!_server.accept(client.session, client.address, _report) || _terminate) {
+            break;
+        }
+
+        // Cleanup terminated clients.
+        clients.remove_if([](const std::unique_ptr<Client>& c) { return c->completed; });
+
+        if (clients.size() > _max_clients) {
+            // Too many clients, reject the new one from this thread, without starting a client thread.
+            _report.debug(u"HLS server: too many clients, rejecting %s", client.address);
+            client.sendResponse("503 Service Unavailable", File(), false, false);
+            client.session.disconnect(NULLREP);
+            client.session.close(NULLREP);
+            clients.pop_back();
+        }
+        else {
+            client.session.setReceiveTimeout(IDLE_TIMEOUT, _report);
+            _report.debug(u"HLS server: client connected from %s", client.address);
+            client.start();
+        }
+    }
+
+    // Disconnect all clients. Deallocating them waits for their termination.
+    for (const auto& c : clients) {
+        if (c->session.isConnected()) {
+            c->session.disconnect(NULLREP);
+        }
+    }
+    clients.clear();
+    _report.debug(u"HLS server terminated");
+}
+
+
+//----------------------------------------------------------------------------
+// Client thread: process successive requests on one connection.
+//----------------------------------------------------------------------------
+
+void ts::hls::OriginServer::Client::main()
+{
+    ByteBlock data;
+    bool keep_alive = true;
+
+    while (keep_alive && !_server->_terminate) {
+        // Read request header lines, until an empty line is read.
+        UString request;
+        UString header(1, SPACE); // Need an initial non-empty value
+        size_t header_size = 0;   // Size of the previous header lines of this request.
+        bool too_large = false;
+        while (!header.empty()) {
+            // Look for a header line.
+            const size_t eol = data.find('\n');
+            if (header_size + (eol == NPOS ? data.size() : eol + 1) > MAX_HEADER_SIZE) {
+                // Don't accumulate an unbounded header.
+                too_large = true;
+                break;
+            }
+            else if (eol == NPOS) {
+                // Read a chunk of data.
+                const size_t previous = data.size();
+                size_t ret_size = 0;
+                data.resize(previous + 1024);
+                if (!session.receive(data.data() + previous, data.size() - previous, ret_size, nullptr, NULLREP)) {
+                    // Client disconnection or idle timeout.
+                    keep_alive = false;
+                    break;
+                }
+                data.resize(previous + ret_size);
+            }
+            else {
+                // Extract the header line from the buffer.
+                header.assignFromUTF8(reinterpret_cast<const char*>(data.data()), eol);
+                header.trim();
+                data.erase(0, eol + 1);
+                header_size += eol + 1;
+                // The first header is the request. Other headers are ignored, except Connection.
+                if (request.empty()) {
+                    request = header;
+                }
+                else if (header.similar(u"Connection: close")) {
+                    keep_alive = false;
+                }
+            }
+        }
+
+        // Process the request.
+        if (too_large) {
+            _server->_report.debug(u"HLS server: request header too large from %s", address);
+            sendResponse("431 Request Header Fields Too Large", File(), false, false);
+            break;
+        }
+        else if (!header.empty() || !processRequest(request, keep_alive)) {
+            break;
+        }
+    }
+
+    session.disconnect(NULLREP);
+    session.close(NULLREP);
+    _server->_report.debug(u"HLS server: client %s disconnected", address);
+    completed = true;
+}
+
+
+//----------------------------------------------------------------------------
+// Process one request. Return false when the connection shall be closed.
+//----------------------------------------------------------------------------
+
+bool ts::hls::OriginServer::Client::processRequest(const UString& request, bool& keep_alive)
+{
+    _server->_report.debug(u"HLS server: request from %s: %s", address, request);
+
+    // Expected request: "GET /name HTTP/1.1"
+    UStringVector fields;
+    request.split(fields, u' ', true, true);
+    const bool is_get = fields.size() >= 1 && fields[0] == u"GET";
+    const bool is_head = fields.size() >= 1 && fields[0] == u"HEAD";
+    const bool valid = fields.size() >= 3 && (is_get || is_head) && fields[1].startWith(u"/") && fields[2].startWith(u"HTTP/");
+
+    // HTTP/1.0 clients do not use keep-alive.
+    keep_alive = keep_alive && valid && fields[2] != u"HTTP/1.0";
+
+    // Get the requested file, if available.
+    File file;
+    if (valid) {
+        std::lock_guard<std::mutex> lock(_server->_mutex);
+        const auto it = _server->_files.find(fields[1].substr(1));
+        if (it != _server->_files.end()) {
+            file = it->second;
+        }
+    }
+
+    if (!valid) {
+        return sendResponse("400 Bad Request", file, false, false);
+    }
+    else if (file.data == nullptr) {
+        return sendResponse("404 Not Found", file, keep_alive, is_head);
+    }
+    else {
+        return sendResponse("200 OK", file, keep_alive, is_head);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Send a response to the client. Return false when the connection shall be closed.
+//----------------------------------------------------------------------------
+
+bool ts::hls::OriginServer::Client::sendResponse(const std::string& status, const File& file, bool keep_alive, bool head)
+{
+    const size_t size = file.data == nullptr ? 0 : file.data->size();
+
+    std::string headers("HTTP/1.1 " + status + "\r\n");
+    headers += "Server: TSDuck/" TS_VERSION_STRING "\r\n";
+    if (!file.mime.empty()) {
+        headers += "Content-Type: " + file.mime.toUTF8() + "\r\n";
+    }
+    headers += "Content-Length: " + std::to_string(size) + "\r\n";
+    headers += keep_alive ? "Connection: keep-alive\r\n\r\n" : "Connection: close\r\n\r\n";
+
+    return session.send(headers.data(), headers.size(), NULLREP) &&
+           (head || size == 0 || session.send(file.data->data(), size, NULLREP)) &&
+           keep_alive;
+}
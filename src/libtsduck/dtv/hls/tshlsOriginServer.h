@@ -0,0 +1,150 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2024, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Minimal HTTP server for HLS playlists and media segments in memory.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsThread.h"
+#include "tsTCPServer.h"
+#include "tsTCPConnection.h"
+#include "tsByteBlock.h"
+#include "tsReport.h"
+
+namespace ts {
+    namespace hls {
+        //!
+        //! Minimal HTTP server for HLS playlists and media segments in memory.
+        //! @ingroup hls
+        //!
+        //! The server contains a set of named "files" in memory. The application adds
+        //! and removes these files at any time. Each file is served as "GET /name".
+        //! There is no subdirectory, no SSL/TLS, only the http: protocol is accepted.
+        //!
+        //! The server uses one internal thread to accept connections and one thread per
+        //! client connection. HTTP keep-alive is supported. The number of simultaneous
+        //! client connections and the size of the request headers are bounded.
+        //!
+        class TSDUCKDLL OriginServer: private Thread
+        {
+            TS_NOBUILD_NOCOPY(OriginServer);
+        public:
+            //!
+            //! Constructor.
+            //! @param [in,out] report Where to report errors. Must be thread-safe.
+            //!
+            explicit OriginServer(Report& report);
+
+            //!
+            //! Destructor.
+            //!
+            virtual ~OriginServer() override;
+
+            //!
+            //! Timeout of an idle client connection, without request.
+            //!
+            static constexpr cn::seconds IDLE_TIMEOUT = cn::seconds(30);
+
+            //!
+            //! Maximum size in bytes of the header of a request (request line and header lines).
+            //! Larger requests are rejected with HTTP status 431 and the connection is closed.
+            //!
+            static constexpr size_t MAX_HEADER_SIZE = 8192;
+
+            //!
+            //! Default maximum number of simultaneous client connections.
+            //!
+            static constexpr size_t DEFAULT_MAX_CLIENTS = 64;
+
+            //!
+            //! Set the maximum number of simultaneous client connections.
+            //! Additional connections are rejected with HTTP status 503 and immediately closed.
+            //! Must be called before start().
+            //! @param [in] count Maximum number of simultaneous client connections.
+            //!
+            void setMaxClients(size_t count) { _max_clients = std::max<size_t>(1, count); }
+
+            //!
+            //! Start the HTTP server.
+            //! @param [in] address Local socket address on which the server listens.
+            //! If the IP address is unspecified, listen on all local interfaces.
+            //! @param [in] reuse_port If true, set the reuse port socket option.
+            //! @return True on success, false on error.
+            //!
+            bool start(const IPv4SocketAddress& address, bool reuse_port = true);
+
+            //!
+            //! Stop the HTTP server and disconnect all clients.
+            //!
+            void stop();
+
+            //!
+            //! Add or replace a file in the server.
+            //! @param [in] name File name, served as "/name".
+            //! @param [in] data Shared pointer to the content of the file. The content shall not be modified later.
+            //! @param [in] mime MIME type of the file.
+            //!
+            void setFile(const UString& name, const std::shared_ptr<const ByteBlock>& data, const UString& mime);
+
+            //!
+            //! Remove a file from the server.
+            //! Clients which are currently downloading this file continue to receive it.
+            //! @param [in] name File name.
+            //!
+            void removeFile(const UString& name);
+
+            //!
+            //! Check if a file is present in the server.
+            //! @param [in] name File name.
+            //! @return True if the file is present.
+            //!
+            bool hasFile(const UString& name) const;
+
+        private:
+            // A file in memory.
+            class File
+            {
+            public:
+                std::shared_ptr<const ByteBlock> data {};
+                UString mime {};
+            };
+
+            // One client connection.
+            class Client : public Thread
+            {
+                TS_NOBUILD_NOCOPY(Client);
+            public:
+                Client(OriginServer* server);
+                virtual ~Client() override;
+                TCPConnection session {};
+                IPv4SocketAddress address {};
+                volatile bool completed = false;
+                bool sendResponse(const std::string& status, const File& file, bool keep_alive, bool head);
+            protected:
+                virtual void main() override;
+            private:
+                OriginServer* _server;
+                bool processRequest(const UString& request, bool& keep_alive);
+            };
+
+            Report&                 _report;
+            IPv4SocketAddress       _address {};
+            TCPServer               _server {};
+            size_t                  _max_clients = DEFAULT_MAX_CLIENTS;
+            bool                    _started = false;   // Only used in the application thread.
+            volatile bool           _terminate = false;
+            mutable std::mutex      _mutex {};
+            std::map<UString, File> _files {};
+
+            // Implementation of Thread.
+            virtual void main() override;
+        };
+    }
+}
@@ -0,0 +1,258 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2024, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+
+#include "tshlsSegmentPrefetcher.h"
+#include "tsErrCodeReport.h"
+
+
+//----------------------------------------------------------------------------
+// Constructors and destructors.
+//----------------------------------------------------------------------------
+
+ts::hls::SegmentPrefetcher::SegmentPrefetcher(Report& report) :
+    _report(report)
+{
+}
+
+ts::hls::SegmentPrefetcher::~SegmentPrefetcher()
+{
+    stop();
+}
+
+ts::hls::SegmentPrefetcher::Downloader::Downloader(SegmentPrefetcher* prefetcher) :
+    Thread(ThreadAttributes().setStackSize(128 * 1024)),
+    request(prefetcher->_report),
+    _prefetcher(prefetcher)
+{
+}
+
+ts::hls::SegmentPrefetcher::Downloader::~Downloader()
+{
+    waitForTermination();
+}
+
+
+//----------------------------------------------------------------------------
+// Start the download threads.
+//----------------------------------------------------------------------------
+
+bool ts::hls::SegmentPrefetcher::start(const WebRequestArgs& args, size_t count)
+{
+    // Terminate previous session, if any.
+    stop();
+
+    _args = args;
+    _max_segments = std::max<size_t>(1, count);
+    _terminate = false;
+    _stats = Statistics();
+    _start_time = cn::steady_clock::now();
+
+    for (size_t i = 0; i < _max_segments; ++i) {
+        _downloaders.push_back(std::make_unique<Downloader>(this));
+        Downloader& dl(*_downloaders.back());
+        dl.request.setArgs(_args);
+        dl.request.setAutoRedirect(true);
+        if (_args.useCookies && !_args.cookiesFile.empty()) {
+            // Private temporary cookies file, deleted with the request.
+            dl.request.enableCookies();
+        }
+        if (!dl.start()) {
+            _report.error(u"cannot start HLS segment download thread");
+            stop();
+            return false;
+        }
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Abort and stop the downloads.
+//----------------------------------------------------------------------------
+
+void ts::hls::SegmentPrefetcher::abort()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _terminate = true;
+    }
+    _work_available.notify_all();
+    _segment_completed.notify_all();
+
+    // Interrupt the transfers in progress.
+    for (const auto& dl : _downloaders) {
+        dl->request.abort();
+    }
+}
+
+void ts::hls::SegmentPrefetcher::stop()
+{
+    abort();
+
+    // Deallocating the threads waits for their termination.
+    _downloaders.clear();
+    _segments.clear();
+}
+
+
+//----------------------------------------------------------------------------
+// Accessors on the queue of segments.
+//----------------------------------------------------------------------------
+
+bool ts::hls::SegmentPrefetcher::needMore() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return !_terminate && _segments.size() < _max_segments;
+}
+
+size_t ts::hls::SegmentPrefetcher::pendingSegments() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _segments.size();
+}
+
+size_t ts::hls::SegmentPrefetcher::readySegments() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return std::count_if(_segments.begin(), _segments.end(), [](const Segment& seg) { return seg.state == State::DONE; });
+}
+
+ts::hls::SegmentPrefetcher::Statistics ts::hls::SegmentPrefetcher::getStatistics() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    Statistics stats(_stats);
+    stats.elapsed_time = cn::duration_cast<cn::milliseconds>(cn::steady_clock::now() - _start_time);
+    return stats;
+}
+
+
+//----------------------------------------------------------------------------
+// Submit the URL of the next media segment to download.
+//----------------------------------------------------------------------------
+
+void ts::hls::SegmentPrefetcher::addSegment(const UString& url)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _segments.emplace_back(url);
+    }
+    _work_available.notify_one();
+}
+
+
+//----------------------------------------------------------------------------
+// Get the content of the next media segment.
+//----------------------------------------------------------------------------
+
+bool ts::hls::SegmentPrefetcher::getSegment(ByteBlock& data, UString& url)
+{
+    data.clear();
+    std::unique_lock<std::mutex> lock(_mutex);
+    if (_segments.empty()) {
+        return false;
+    }
+
+    // Wait for the completion of the first segment in the queue.
+    Segment& seg(_segments.front());
+    _segment_completed.wait(lock, [this, &seg]() { return _terminate || seg.state == State::DONE || seg.state == State::FAILED; });
+    if (_terminate) {
+        return false;
+    }
+
+    const bool success = seg.state == State::DONE;
+    data.swap(seg.data);
+    url = seg.url;
+    _segments.pop_front();
+    return success;
+}
+
+
+//----------------------------------------------------------------------------
+// Download thread.
+//----------------------------------------------------------------------------
+
+void ts::hls::SegmentPrefetcher::Downloader::main()
+{
+    SegmentPrefetcher& pf(*_prefetcher);
+    pf._report.debug(u"HLS segment download thread started");
+
+    for (;;) {
+        // Wait for a segment to download. Segments are never moved in the list.
+        Segment* seg = nullptr;
+        UString url;
+        {
+            std::unique_lock<std::mutex> lock(pf._mutex);
+            pf._work_available.wait(lock, [&pf, &seg]() {
+                if (!pf._terminate) {
+                    for (auto& s : pf._segments) {
+                        if (s.state == State::PENDING) {
+                            seg = &s;
+                            break;
+                        }
+                    }
+                }
+                return pf._terminate || seg != nullptr;
+            });
+            if (pf._terminate) {
+                break;
+            }
+            seg->state = State::DOWNLOADING;
+            url = seg->url;
+        }
+
+        // Start from the current cookies of the application, possibly updated by the last playlist reload.
+        if (pf._args.useCookies && !pf._args.cookiesFile.empty() && fs::exists(pf._args.cookiesFile)) {
+            fs::copy_file(pf._args.cookiesFile, request.getCookiesFileName(), fs::copy_options::overwrite_existing,
+                          &ErrCodeReport(pf._report, u"error copying", pf._args.cookiesFile));
+        }
+
+        // Download the segment, reusing the connection of the previous one when possible.
+        pf._report.debug(u"downloading segment %s", url);
+        ByteBlock data;
+        const cn::steady_clock::time_point start(cn::steady_clock::now());
+        const bool success = request.downloadBinaryContent(url, data);
+        const cn::milliseconds duration(cn::duration_cast<cn::milliseconds>(cn::steady_clock::now() - start));
+
+        // Make the segment available to the application.
+        {
+            std::lock_guard<std::mutex> lock(pf._mutex);
+            if (success) {
+                seg->state = State::DONE;
+                seg->url = request.finalURL();
+                seg->data.swap(data);
+                pf._stats.segments++;
+                pf._stats.bytes += seg->data.size();
+                pf._stats.download_time += duration;
+                const size_t ready = std::count_if(pf._segments.begin(), pf._segments.end(), [](const Segment& s) { return s.state == State::DONE; });
+                pf._stats.max_ready = std::max(pf._stats.max_ready, ready);
+            }
+            else {
+                seg->state = State::FAILED;
+                pf._stats.errors++;
+            }
+        }
+        pf._segment_completed.notify_all();
+    }
+
+    pf._report.debug(u"HLS segment download thread completed");
+}
+
+
+//----------------------------------------------------------------------------
+// Download bitrates.
+//----------------------------------------------------------------------------
+
+ts::BitRate ts::hls::SegmentPrefetcher::Statistics::segmentBitRate() const
+{
+    return download_time.count() <= 0 ? 0 : BitRate(bytes * 8 * 1000) / BitRate(download_time.count());
+}
+
+ts::BitRate ts::hls::SegmentPrefetcher::Statistics::globalBitRate() const
+{
+    return elapsed_time.count() <= 0 ? 0 : BitRate(bytes * 8 * 1000) / BitRate(elapsed_time.count());
+}
@@ -0,0 +1,183 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2024, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Concurrent download of HLS media segments in advance.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsThread.h"
+#include "tsWebRequest.h"
+#include "tsWebRequestArgs.h"
+#include "tsBitRate.h"
+#include "tsReport.h"
+
+namespace ts {
+    namespace hls {
+        //!
+        //! Concurrent download of HLS media segments in advance.
+        //! @ingroup hls
+        //!
+        //! The application submits the URL's of the next media segments, in the order of the
+        //! playlist. Several internal threads concurrently download them in memory. The application
+        //! gets the content of the segments in the same order, as soon as they are downloaded.
+        //!
+        //! The number of submitted segments which are not yet retrieved by the application is bounded.
+        //! Each download thread uses its own ts::WebRequest, reusing the same connection to the server
+        //! for successive segments when possible.
+        //!
+        //! When cookies are used with a cookies file, the download threads never write into this file,
+        //! which may be concurrently used by the application to reload the playlist. Each download thread
+        //! uses a private temporary cookies file which is refreshed from the application's cookies file
+        //! before each download. Cookies which are set by the server in segment responses are kept in the
+        //! private cookies file of the download thread.
+        //!
+        class TSDUCKDLL SegmentPrefetcher
+        {
+            TS_NOBUILD_NOCOPY(SegmentPrefetcher);
+        public:
+            //!
+            //! Constructor.
+            //! @param [in,out] report Where to report errors. Must be thread-safe.
+            //!
+            explicit SegmentPrefetcher(Report& report);
+
+            //!
+            //! Destructor.
+            //!
+            ~SegmentPrefetcher();
+
+            //!
+            //! Start the download threads.
+            //! @param [in] args Web request options for all downloads.
+            //! @param [in] count Maximum number of segments which are downloaded in advance.
+            //! This is both the maximum number of concurrent downloads and the maximum number of
+            //! submitted segments which are not yet retrieved by the application.
+            //! @return True on success, false on error.
+            //!
+            bool start(const WebRequestArgs& args, size_t count);
+
+            //!
+            //! Stop all downloads and terminate the download threads.
+            //! All submitted segments are discarded.
+            //!
+            void stop();
+
+            //!
+            //! Abort all downloads in progress.
+            //! Can be called from any thread. The current or next call to getSegment() returns false.
+            //!
+            void abort();
+
+            //!
+            //! Check if new segments can be submitted.
+            //! @return True if the number of submitted segments which are not yet retrieved is lower than the maximum.
+            //!
+            bool needMore() const;
+
+            //!
+            //! Get the number of submitted segments which are not yet retrieved.
+            //! @return The number of submitted segments which are not yet retrieved.
+            //!
+            size_t pendingSegments() const;
+
+            //!
+            //! Get the number of completely downloaded segments which are not yet retrieved (queue depth).
+            //! @return The number of completely downloaded segments which are not yet retrieved.
+            //!
+            size_t readySegments() const;
+
+            //!
+            //! Submit the URL of the next media segment to download.
+            //! @param [in] url URL of the media segment.
+            //!
+            void addSegment(const UString& url);
+
+            //!
+            //! Get the content of the next media segment, in the order of submission.
+            //! Wait for the end of the download when necessary.
+            //! @param [out] data Content of the media segment.
+            //! @param [out] url Final URL of the media segment, after redirections.
+            //! @return True on success, false on download error, abort, or when no segment was submitted.
+            //!
+            bool getSegment(ByteBlock& data, UString& url);
+
+            //!
+            //! Download statistics.
+            //!
+            class TSDUCKDLL Statistics
+            {
+            public:
+                Statistics() = default;                         //!< Constructor.
+                size_t           segments = 0;                  //!< Number of successfully downloaded segments.
+                size_t           errors = 0;                    //!< Number of failed downloads.
+                uint64_t         bytes = 0;                     //!< Total downloaded bytes.
+                size_t           max_ready = 0;                 //!< Maximum number of downloaded segments which were waiting for the application.
+                cn::milliseconds download_time {};              //!< Cumulated download time of all segments.
+                cn::milliseconds elapsed_time {};               //!< Elapsed time since start().
+
+                //!
+                //! Get the average download bitrate of one segment.
+                //! @return The average download bitrate of one segment.
+                //!
+                BitRate segmentBitRate() const;
+
+                //!
+                //! Get the global download bitrate, including concurrent downloads.
+                //! @return The global download bitrate, including concurrent downloads.
+                //!
+                BitRate globalBitRate() const;
+            };
+
+            //!
+            //! Get the download statistics.
+            //! @return The download statistics since start().
+            //!
+            Statistics getStatistics() const;
+
+        private:
+            // Description of one submitted segment.
+            enum class State {PENDING, DOWNLOADING, DONE, FAILED};
+            class Segment
+            {
+            public:
+                Segment(const UString& u) : url(u) {}
+                UString   url;
+                State     state = State::PENDING;
+                ByteBlock data {};
+            };
+
+            // One download thread.
+            class Downloader : public Thread
+            {
+                TS_NOBUILD_NOCOPY(Downloader);
+            public:
+                Downloader(SegmentPrefetcher* prefetcher);
+                virtual ~Downloader() override;
+                WebRequest request;
+            protected:
+                virtual void main() override;
+            private:
+                SegmentPrefetcher* _prefetcher;
+            };
+
+            Report&                  _report;
+            WebRequestArgs           _args {};
+            size_t                   _max_segments = 0;
+            mutable std::mutex       _mutex {};
+            std::condition_variable  _work_available {};      // Signaled when a segment is submitted or on termination.
+            std::condition_variable  _segment_completed {};   // Signaled when a download completes or on termination.
+            bool                     _terminate = false;
+            std::list<Segment>       _segments {};            // In order of submission, elements are not moved.
+            std::list<std::unique_ptr<Downloader>> _downloaders {};
+            Statistics               _stats {};
+            cn::steady_clock::time_point _start_time {};
+        };
+    }
+}
@@ -74,6 +74,12 @@ ts::CodecType ts::PESDemux::getDefaultCodec(PID pid) const
     return it == _pid_types.end() || it->second.default_codec == CodecType::UNDEFINED ? _default_codec : it->second.default_codec;
 }
 
+uint8_t ts::PESDemux::getStreamType(PID pid) const
+{
+    const auto it = _pid_types.find(pid);
+    return it == _pid_types.end() ? uint8_t(ST_NULL) : it->second.stream_type;
+}
+
 
 //----------------------------------------------------------------------------
 // Get current audio/video attributes on the specified PID.
@@ -370,6 +376,10 @@ void ts::PESDemux::processPESPacket(PID pid, PIDContext& pc)
     // Note: We need to process even if _pes_handler is null. Subclasses of the
     // PES demux may override handlePESPacket() and have their own processing.
 
+    // Number of references to the TS buffer before passing it to the handlers.
+    // The buffer may be also referenced by the pool of buffers.
+    const auto ts_refs = pc.ts.use_count();
+
     // Mark that we are in the context of handlers.
     // This is used to prevent the destruction of PID contexts during the execution of a handler.
     beforeCallingHandler(pid);
@@ -419,6 +429,12 @@ void ts::PESDemux::processPESPacket(PID pid, PIDContext& pc)
     }
     afterCallingHandler(true);
 
+    // If the application kept a copy of the PES packet, its content is still shared with the TS buffer.
+    // Do not overwrite it, use another buffer for the next PES packet on this PID.
+    if (pc.ts.use_count() > ts_refs) {
+        pc.ts = _buffer_pool.allocate();
+    }
+
     // Consider that we lose sync in case there are additional TS packets on that PID before next PUSI.
     pc.syncLost();
 }
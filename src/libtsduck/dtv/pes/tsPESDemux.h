@@ -21,6 +21,7 @@
 #include "tsHEVCAttributes.h"
 #include "tsAC3Attributes.h"
 #include "tsSectionDemux.h"
+#include "tsSharedPool.h"
 
 namespace ts {
     //!
@@ -105,6 +106,13 @@ namespace ts {
         //!
         CodecType getDefaultCodec(PID pid) const;
 
+        //!
+        //! Get the stream type of a given PID, as declared in the PMT of its service.
+        //! @param [in] pid The PID to check.
+        //! @return The stream type of @a pid or ST_NULL if no PMT declares it yet.
+        //!
+        uint8_t getStreamType(PID pid) const;
+
         //!
         //! Get the current audio attributes on the specified PID.
         //! @param [in] pid The PID to check.
@@ -157,6 +165,23 @@ namespace ts {
         //!
         bool allAC3(PID pid) const;
 
+        //!
+        //! Set the maximum number of recycled PES buffers.
+        //! The content of a PES packet which is passed to a handler is shared with the internal
+        //! buffer of the demux. When the application keeps a copy of the PES packet, the demux
+        //! uses another buffer from a pool for the next PES packet on the PID. When the application
+        //! releases all references to the PES packet, its buffer is recycled in the pool.
+        //! @param [in] count Maximum number of buffers in the pool. Zero disables recycling.
+        //! The default is SharedPool::DEFAULT_MAX_SIZE.
+        //!
+        void setBufferPoolSize(size_t count) { _buffer_pool.setMaxSize(count); }
+
+        //!
+        //! Get the pool of PES buffers, typically to get its statistics.
+        //! @return A constant reference to the pool of PES buffers.
+        //!
+        const SharedPool<ByteBlock>& bufferPool() const { return _buffer_pool; }
+
     protected:
         //!
         //! This hook is invoked when a complete PES packet is available.
@@ -196,7 +221,7 @@ namespace ts {
 
         // Map of PID contexts, indexed by PID.
         // One context is created per demuxed PES PID.
-        using PIDContextMap = std::map<PID,PIDContext>;
+        using PIDContextMap = PIDTable<PIDContext>;
 
         // This internal structure describes the content of one PID.
         struct PIDType
@@ -228,10 +253,11 @@ namespace ts {
         virtual void handleTable(SectionDemux& demux, const BinaryTable& table) override;
 
         // Private members:
-        PESHandlerInterface* _pes_handler = nullptr;
-        CodecType            _default_codec {CodecType::UNDEFINED};
-        PIDContextMap        _pids {};
-        PIDTypeMap           _pid_types {};
-        SectionDemux         _section_demux;
+        PESHandlerInterface*  _pes_handler = nullptr;
+        CodecType             _default_codec {CodecType::UNDEFINED};
+        PIDContextMap         _pids {};
+        PIDTypeMap            _pid_types {};
+        SharedPool<ByteBlock> _buffer_pool {};
+        SectionDemux          _section_demux;
     };
 }
@@ -0,0 +1,90 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2024, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Read-only view over a binary descriptor.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsPSILoopView.h"
+#include "tsPSI.h"
+
+namespace ts {
+    //!
+    //! Read-only view over a binary descriptor, inside a descriptor loop.
+    //! @ingroup mpeg
+    //!
+    //! Unlike ts::Descriptor, the descriptor data are not copied. They must remain
+    //! valid and unmodified as long as the view is used.
+    //!
+    //! @see ts::DescriptorListView
+    //!
+    class TSDUCKDLL DescriptorView
+    {
+    public:
+        //!
+        //! Constructor.
+        //! @param [in] data Address of the descriptor, starting with the descriptor tag.
+        //! @param [in] size Maximum size in bytes of the descriptor, typically the remaining
+        //! size in the descriptor loop.
+        //!
+        DescriptorView(const uint8_t* data, size_t size) :
+            _data(data),
+            _size(data != nullptr && size >= 2 && size_t(data[1]) + 2 <= size ? size_t(data[1]) + 2 : 0)
+        {
+        }
+
+        //!
+        //! Check if the descriptor is valid (not truncated).
+        //! @return True if the descriptor is valid.
+        //!
+        bool isValid() const { return _size > 0; }
+
+        //!
+        //! Get the descriptor tag.
+        //! @return The descriptor tag or DID_NULL if the descriptor is invalid.
+        //!
+        DID tag() const { return _size > 0 ? _data[0] : DID(DID_NULL); }
+
+        //!
+        //! Get the address of the complete descriptor, starting with the descriptor tag.
+        //! @return The address of the complete descriptor or a null pointer if the descriptor is invalid.
+        //!
+        const uint8_t* content() const { return _size > 0 ? _data : nullptr; }
+
+        //!
+        //! Get the size of the complete descriptor, including the tag and length fields.
+        //! @return The size in bytes of the complete descriptor or zero if the descriptor is invalid.
+        //!
+        size_t size() const { return _size; }
+
+        //!
+        //! Get the address of the descriptor payload, after the tag and length fields.
+        //! @return The address of the descriptor payload or a null pointer if the descriptor is invalid.
+        //!
+        const uint8_t* payload() const { return _size > 0 ? _data + 2 : nullptr; }
+
+        //!
+        //! Get the size of the descriptor payload, after the tag and length fields.
+        //! @return The size in bytes of the descriptor payload.
+        //!
+        size_t payloadSize() const { return _size > 0 ? _size - 2 : 0; }
+
+    private:
+        const uint8_t* _data;
+        size_t         _size;
+    };
+
+    //!
+    //! Read-only view over a binary descriptor loop.
+    //! The descriptors are iterated as instances of ts::DescriptorView, without copying data.
+    //! @ingroup mpeg
+    //!
+    using DescriptorListView = PSILoopView<DescriptorView>;
+}
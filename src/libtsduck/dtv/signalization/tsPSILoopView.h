@@ -0,0 +1,195 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2024, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Read-only view over a loop of binary structures in a PSI/SI section.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsPlatform.h"
+
+namespace ts {
+    //!
+    //! Read-only view over a loop of binary structures in a PSI/SI section.
+    //! @ingroup mpeg
+    //!
+    //! Many PSI/SI tables contain loops of variable-size structures: descriptors, services,
+    //! elementary streams, events, etc. A loop view references the binary data of such
+    //! a loop, typically inside the content of a ts::Section, and iterates over the
+    //! structures without copying data or allocating memory.
+    //!
+    //! The referenced binary data are not copied. They must remain valid and unmodified
+    //! as long as the view and its iterators are used.
+    //!
+    //! The iteration stops at the end of the loop or at the first truncated structure.
+    //!
+    //! @tparam ELEMENT The class of views over one structure of the loop. It must be
+    //! copyable, provide a constructor with parameters (const uint8_t* data, size_t size)
+    //! where @a size is the remaining size of the loop, and provide a method named
+    //! size() which returns the size in bytes of the structure or zero if the
+    //! structure is truncated.
+    //!
+    template <class ELEMENT>
+    class PSILoopView
+    {
+    public:
+        //!
+        //! Constant iterator over the structures of the loop.
+        //!
+        class const_iterator
+        {
+        public:
+            //! @cond nodoxygen
+            using iterator_category = std::input_iterator_tag;
+            using value_type = ELEMENT;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const ELEMENT*;
+            using reference = ELEMENT;
+            //! @endcond
+
+            //!
+            //! Default constructor, equivalent to an end of loop.
+            //!
+            const_iterator() = default;
+
+            //!
+            //! Constructor.
+            //! @param [in] data Address of the first structure to iterate.
+            //! @param [in] size Remaining size in bytes of the loop.
+            //!
+            const_iterator(const uint8_t* data, size_t size) : _data(data), _size(size), _elem(data, size) { check(); }
+
+            //!
+            //! Access the current structure.
+            //! @return A copy of the view over the current structure. Views are small
+            //! objects which remain valid after the iterator is destroyed.
+            //!
+            ELEMENT operator*() const { return _elem; }
+
+            //!
+            //! Access the current structure.
+            //! @return A constant pointer to the view over the current structure.
+            //!
+            const ELEMENT* operator->() const { return &_elem; }
+
+            //!
+            //! Move to next structure (prefix).
+            //! @return A reference to this object.
+            //!
+            const_iterator& operator++()
+            {
+                const size_t size = _elem.size();
+                _data += size;
+                _size -= size;
+                _elem = ELEMENT(_data, _size);
+                check();
+                return *this;
+            }
+
+            //!
+            //! Move to next structure (postfix).
+            //! @return A copy of this object before incrementing.
+            //!
+            const_iterator operator++(int)
+            {
+                const_iterator previous(*this);
+                ++*this;
+                return previous;
+            }
+
+            //!
+            //! Equality operator.
+            //! @param [in] other Another iterator to compare.
+            //! @return True if both iterators point to the same structure.
+            //!
+            bool operator==(const const_iterator& other) const { return _data == other._data; }
+            TS_UNEQUAL_OPERATOR(const_iterator)
+
+        private:
+            const uint8_t* _data = nullptr;
+            size_t         _size = 0;
+            ELEMENT        _elem {nullptr, 0};
+
+            // Switch to end of loop when there is no more complete structure.
+            void check()
+            {
+                if (_data == nullptr || _size == 0 || _elem.size() == 0 || _elem.size() > _size) {
+                    _data = nullptr;
+                    _size = 0;
+                }
+            }
+        };
+
+        //!
+        //! Default constructor, an empty loop.
+        //!
+        PSILoopView() = default;
+
+        //!
+        //! Constructor.
+        //! @param [in] data Address of the binary loop.
+        //! @param [in] size Size in bytes of the binary loop.
+        //!
+        PSILoopView(const uint8_t* data, size_t size) : _data(data), _size(data == nullptr ? 0 : size) {}
+
+        //!
+        //! Get an iterator to the first structure of the loop.
+        //! @return An iterator to the first structure of the loop.
+        //!
+        const_iterator begin() const { return const_iterator(_data, _size); }
+
+        //!
+        //! Get an iterator after the last structure of the loop.
+        //! @return An iterator after the last structure of the loop.
+        //!
+        const_iterator end() const { return const_iterator(); }
+
+        //!
+        //! Check if the loop is empty.
+        //! @return True if the loop contains no complete structure.
+        //!
+        bool empty() const { return begin() == end(); }
+
+        //!
+        //! Count the number of complete structures in the loop.
+        //! This is not a constant-time operation, the loop is scanned.
+        //! @return The number of complete structures in the loop.
+        //!
+        size_t count() const { return size_t(std::distance(begin(), end())); }
+
+        //!
+        //! Check if the loop is made of complete structures only, without truncated or extraneous data.
+        //! @return True if the loop is well-formed.
+        //!
+        bool isValid() const
+        {
+            size_t total = 0;
+            for (const auto& elem : *this) {
+                total += elem.size();
+            }
+            return total == _size;
+        }
+
+        //!
+        //! Get the address of the binary loop.
+        //! @return The address of the binary loop.
+        //!
+        const uint8_t* data() const { return _data; }
+
+        //!
+        //! Get the size of the binary loop.
+        //! @return The size in bytes of the binary loop.
+        //!
+        size_t size() const { return _size; }
+
+    private:
+        const uint8_t* _data = nullptr;
+        size_t         _size = 0;
+    };
+}
@@ -14,6 +14,43 @@
 
 TS_DEFINE_SINGLETON(ts::PSIRepository);
 
+// The registration instances are linked together during the initialization of the application.
+// The counter and list heads are constant-initialized, they are valid before any registration
+// is declared. A std::mutex is not constant-initialized with all compilers (e.g. MSVC before
+// VS 2022 17.10). Therefore, the mutex is a function-local static, constructed on first use,
+// possibly from a static initializer in another module.
+namespace {
+    std::mutex& RegistrationMutex()
+    {
+        static std::mutex mutex;
+        return mutex;
+    }
+    std::atomic<size_t> _registration_count {0};
+    const ts::PSIRepository::RegisterTable* _registered_tables = nullptr;
+    const ts::PSIRepository::RegisterDescriptor* _registered_descriptors = nullptr;
+    const ts::PSIRepository::RegisterXML* _registered_xml = nullptr;
+
+    // Character properties in XML names. XML names are usually ASCII,
+    // avoid the generic IsSpace() and ToLower() which use lookup tables.
+    inline bool SpaceInName(ts::UChar c)
+    {
+        return c < 0x80 ? c == u' ' || (c >= 0x09 && c <= 0x0D) : ts::IsSpace(c);
+    }
+    inline ts::UChar LowerName(ts::UChar c)
+    {
+        return c < 0x80 ? (c >= u'A' && c <= u'Z' ? ts::UChar(c + (u'a' - u'A')) : c) : ts::ToLower(c);
+    }
+
+    // Compare entries of a sorted array and keys, for binary searches.
+    template <typename KEY>
+    struct KeyLess {
+        template <typename ENTRY>
+        bool operator()(const ENTRY& e, const KEY& k) const { return e.first < k; }
+        template <typename ENTRY>
+        bool operator()(const KEY& k, const ENTRY& e) const { return k < e.first; }
+    };
+}
+
 
 //----------------------------------------------------------------------------
 // Constructors.
@@ -74,6 +111,302 @@ void ts::PSIRepository::TableDescription::addPIDs(std::initializer_list<PID> mor
 }
 
 
+//----------------------------------------------------------------------------
+// Constructors to register extension files.
+//----------------------------------------------------------------------------
+
+ts::PSIRepository::RegisterXML::RegisterXML(const UString& filename) :
+    _filename(filename)
+{
+    CERR.debug(u"registering XML file %s", filename);
+    std::lock_guard<std::mutex> lock(RegistrationMutex());
+    _next = _registered_xml;
+    _registered_xml = this;
+    _registration_count++;
+}
+
+
+//----------------------------------------------------------------------------
+// Constructors to register a fully or partially implemented table.
+//----------------------------------------------------------------------------
+
+ts::PSIRepository::RegisterTable::RegisterTable(TableFactory factory,
+                                                std::initializer_list<TID> tids,
+                                                Standards standards,
+                                                const UChar* xmlName,
+                                                DisplaySectionFunction displayFunction,
+                                                LogSectionFunction logFunction,
+                                                std::initializer_list<PID> pids,
+                                                uint16_t minCAS,
+                                                uint16_t maxCAS) :
+    _xmlName(xmlName)
+{
+    _desc.factory = factory;
+    for (auto tid : tids) {
+        _tids.set(tid);
+    }
+    init(standards, displayFunction, logFunction, pids, minCAS, maxCAS);
+}
+
+ts::PSIRepository::RegisterTable::RegisterTable(TableFactory factory,
+                                                const std::vector<TID>& tids,
+                                                Standards standards,
+                                                const UChar* xmlName,
+                                                DisplaySectionFunction displayFunction,
+                                                LogSectionFunction logFunction,
+                                                std::initializer_list<PID> pids,
+                                                uint16_t minCAS,
+                                                uint16_t maxCAS) :
+    _xmlName(xmlName)
+{
+    _desc.factory = factory;
+    for (auto tid : tids) {
+        _tids.set(tid);
+    }
+    init(standards, displayFunction, logFunction, pids, minCAS, maxCAS);
+}
+
+ts::PSIRepository::RegisterTable::RegisterTable(std::initializer_list<TID> tids,
+                                                Standards standards,
+                                                DisplaySectionFunction displayFunction,
+                                                LogSectionFunction logFunction,
+                                                std::initializer_list<PID> pids,
+                                                uint16_t minCAS,
+                                                uint16_t maxCAS)
+{
+    for (auto tid : tids) {
+        _tids.set(tid);
+    }
+    init(standards, displayFunction, logFunction, pids, minCAS, maxCAS);
+}
+
+ts::PSIRepository::RegisterTable::RegisterTable(const std::vector<TID>& tids,
+                                                Standards standards,
+                                                DisplaySectionFunction displayFunction,
+                                                LogSectionFunction logFunction,
+                                                std::initializer_list<PID> pids,
+                                                uint16_t minCAS,
+                                                uint16_t maxCAS)
+{
+    for (auto tid : tids) {
+        _tids.set(tid);
+    }
+    init(standards, displayFunction, logFunction, pids, minCAS, maxCAS);
+}
+
+void ts::PSIRepository::RegisterTable::init(Standards standards,
+                                            DisplaySectionFunction displayFunction,
+                                            LogSectionFunction logFunction,
+                                            std::initializer_list<PID> pids,
+                                            uint16_t minCAS,
+                                            uint16_t maxCAS)
+{
+    // Complete the table description, common to all table ids.
+    _desc.standards = standards;
+    _desc.minCAS = minCAS;
+    _desc.maxCAS = maxCAS;
+    _desc.display = displayFunction;
+    _desc.log = logFunction;
+    _desc.addPIDs(pids);
+
+    // Link the registration, the repository will be built on first use.
+    std::lock_guard<std::mutex> lock(RegistrationMutex());
+    _next = _registered_tables;
+    _registered_tables = this;
+    _registration_count++;
+}
+
+
+//----------------------------------------------------------------------------
+// Constructors to register a fully or partially implemented descriptor.
+//----------------------------------------------------------------------------
+
+ts::PSIRepository::RegisterDescriptor::RegisterDescriptor(DescriptorFactory factory,
+                                                          const EDID& edid,
+                                                          const UChar* xmlName,
+                                                          DisplayDescriptorFunction displayFunction,
+                                                          const UChar* xmlNameLegacy) :
+    _edid(edid),
+    _xmlName(xmlName),
+    _xmlNameLegacy(xmlNameLegacy),
+    _desc(factory, displayFunction)
+{
+    std::lock_guard<std::mutex> lock(RegistrationMutex());
+    _next = _registered_descriptors;
+    _registered_descriptors = this;
+    _registration_count++;
+}
+
+ts::PSIRepository::RegisterDescriptor::RegisterDescriptor(DisplayCADescriptorFunction displayFunction, uint16_t minCAS, uint16_t maxCAS) :
+    _caDisplay(displayFunction),
+    _minCAS(minCAS),
+    _maxCAS(maxCAS)
+{
+    std::lock_guard<std::mutex> lock(RegistrationMutex());
+    _next = _registered_descriptors;
+    _registered_descriptors = this;
+    _registration_count++;
+}
+
+
+//----------------------------------------------------------------------------
+// Build the arrays from all registration objects, if not already done.
+//----------------------------------------------------------------------------
+
+const ts::PSIRepository::Arrays& ts::PSIRepository::arrays() const
+{
+    // Fast path: all registrations are already in the current arrays.
+    const Arrays* current = _arrays.load(std::memory_order_acquire);
+    if (current != nullptr && current->count == _registration_count.load(std::memory_order_acquire)) {
+        return *current;
+    }
+
+    // Check again under protection of the mutex, another thread may have built the arrays.
+    std::lock_guard<std::mutex> lock(RegistrationMutex());
+    const size_t count = _registration_count.load();
+    current = _arrays.load();
+    if (current != nullptr && current->count == count) {
+        return *current;
+    }
+
+    // The registrations are linked in reverse order, collect them in order of registration.
+    std::vector<const RegisterTable*> tables;
+    std::vector<const RegisterDescriptor*> descriptors;
+    std::vector<const RegisterXML*> xml;
+    for (auto reg = _registered_tables; reg != nullptr; reg = reg->_next) {
+        tables.push_back(reg);
+    }
+    for (auto reg = _registered_descriptors; reg != nullptr; reg = reg->_next) {
+        descriptors.push_back(reg);
+    }
+    for (auto reg = _registered_xml; reg != nullptr; reg = reg->_next) {
+        xml.push_back(reg);
+    }
+    std::reverse(tables.begin(), tables.end());
+    std::reverse(descriptors.begin(), descriptors.end());
+    std::reverse(xml.begin(), xml.end());
+
+    // Build new arrays, from scratch. The current ones may be in use in other threads.
+    auto arr = std::make_unique<Arrays>();
+    arr->count = count;
+
+    for (auto reg : tables) {
+        // XML names are recorded independently.
+        if (reg->_xmlName != nullptr && reg->_xmlName[0] != CHAR_NULL) {
+            arr->tableNames.push_back(std::make_pair(reg->_xmlName, reg->_desc.factory));
+        }
+        // Store a copy of the table description for each table id.
+        // Distinct definitions for the same table id accumulate.
+        for (size_t tid = 0; tid < reg->_tids.size(); ++tid) {
+            if (reg->_tids.test(tid)) {
+                arr->tables.push_back(std::make_pair(TID(tid), reg->_desc));
+            }
+        }
+    }
+
+    for (auto reg : descriptors) {
+        if (reg->_caDisplay != nullptr) {
+            uint16_t cas = reg->_minCAS;
+            do {
+                arr->casIdDescriptorDisplays.push_back(std::make_pair(cas, reg->_caDisplay));
+            } while (cas++ < reg->_maxCAS);
+        }
+        else {
+            for (auto name : {reg->_xmlName, reg->_xmlNameLegacy}) {
+                if (name != nullptr && name[0] != CHAR_NULL) {
+                    arr->descriptorNames.push_back(std::make_pair(name, reg->_desc.factory));
+                    if (reg->_edid.isTableSpecific()) {
+                        arr->descriptorTablesIds.push_back(std::make_pair(name, reg->_edid.tableId()));
+                    }
+                }
+            }
+            arr->descriptors.push_back(std::make_pair(reg->_edid, reg->_desc));
+        }
+    }
+
+    for (auto reg : xml) {
+        arr->xmlModelFiles.push_back(reg->_filename);
+    }
+
+    // Sort all arrays. Use stable sorts to keep the order of registration for identical keys.
+    const auto less_key = [](const auto& e1, const auto& e2) { return e1.first < e2.first; };
+    const auto less_name = [](const auto& e1, const auto& e2) { return CompareNames(e1.first, e2.first); };
+    const auto same_key = [](const auto& e1, const auto& e2) { return e1.first == e2.first; };
+
+    std::stable_sort(arr->tables.begin(), arr->tables.end(), less_key);
+    std::stable_sort(arr->descriptors.begin(), arr->descriptors.end(), less_key);
+    std::stable_sort(arr->casIdDescriptorDisplays.begin(), arr->casIdDescriptorDisplays.end(), less_key);
+    std::stable_sort(arr->tableNames.begin(), arr->tableNames.end(), less_name);
+    std::stable_sort(arr->descriptorNames.begin(), arr->descriptorNames.end(), less_name);
+    std::stable_sort(arr->descriptorTablesIds.begin(), arr->descriptorTablesIds.end(), less_name);
+
+    // Only the first registration is used for a descriptor or a CA_system_id.
+    arr->descriptors.erase(std::unique(arr->descriptors.begin(), arr->descriptors.end(), same_key), arr->descriptors.end());
+    arr->casIdDescriptorDisplays.erase(std::unique(arr->casIdDescriptorDisplays.begin(), arr->casIdDescriptorDisplays.end(), same_key), arr->casIdDescriptorDisplays.end());
+
+    // Publish the new arrays. The previous ones are kept, other threads may still use them.
+    current = arr.get();
+    _allArrays.push_back(std::move(arr));
+    _arrays.store(current, std::memory_order_release);
+    return *current;
+}
+
+
+//----------------------------------------------------------------------------
+// Compare two XML names, case-insensitive and ignoring blanks.
+//----------------------------------------------------------------------------
+
+bool ts::PSIRepository::CompareNames(const UChar* name1, const UChar* name2)
+{
+    // Same as UString::SuperCompare() but lower case is also applied to non-letters
+    // (no-op) to make sure that we have a strict weak ordering, as required by sort.
+    for (;;) {
+        while (SpaceInName(*name1)) {
+            ++name1;
+        }
+        while (SpaceInName(*name2)) {
+            ++name2;
+        }
+        const UChar c1 = LowerName(*name1++);
+        const UChar c2 = LowerName(*name2++);
+        if (c1 != c2 || c1 == CHAR_NULL) {
+            return c1 < c2;
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Find the range of entries with a given XML name in a sorted array of names.
+//----------------------------------------------------------------------------
+
+template <typename VALUE>
+std::pair<ts::PSIRepository::NameIterator<VALUE>, ts::PSIRepository::NameIterator<VALUE>>
+    ts::PSIRepository::FindNames(const std::vector<Entry<const UChar*, VALUE>>& entries, const UString& name)
+{
+    const Entry<const UChar*, VALUE> key(name.c_str(), VALUE());
+    return std::equal_range(entries.begin(), entries.end(), key, [](const auto& e1, const auto& e2) { return CompareNames(e1.first, e2.first); });
+}
+
+
+//----------------------------------------------------------------------------
+// Get the list of distinct names in a sorted array of names.
+//----------------------------------------------------------------------------
+
+template <typename VALUE>
+void ts::PSIRepository::GetNames(UStringList& names, const std::vector<Entry<const UChar*, VALUE>>& entries)
+{
+    // Return distinct names in the order of case-sensitive UString's, as in any std::map<UString,...>.
+    std::vector<UString> all;
+    all.reserve(entries.size());
+    for (const auto& it : entries) {
+        all.push_back(it.first);
+    }
+    std::sort(all.begin(), all.end());
+    names.assign(all.begin(), std::unique(all.begin(), all.end()));
+}
+
+
 //----------------------------------------------------------------------------
 // Lookup a table function by table id, using standards and CAS id.
 //----------------------------------------------------------------------------
@@ -81,13 +414,16 @@ void ts::PSIRepository::TableDescription::addPIDs(std::initializer_list<PID> mor
 template <typename FUNCTION, typename std::enable_if<std::is_pointer<FUNCTION>::value>::type*>
 FUNCTION ts::PSIRepository::getTableFunction(TID tid, Standards standards, PID pid, uint16_t cas, FUNCTION TableDescription::* member) const
 {
+    const Arrays& arr(arrays());
+
     // Try to find an exact match with standard and CAS id.
     // Otherwise, will use a fallback once for same tid.
     FUNCTION fallbackFunc = nullptr;
     size_t fallbackCount = 0;
 
     // Look for an exact match.
-    for (auto it = _tables.lower_bound(tid); it != _tables.end() && it->first == tid; ++it) {
+    const auto range = std::equal_range(arr.tables.begin(), arr.tables.end(), tid, KeyLess<TID>());
+    for (auto it = range.first; it != range.second; ++it) {
         // Ignore entries for which the searched function is not present.
         if (it->second.*member != nullptr) {
 
@@ -126,128 +462,27 @@ FUNCTION ts::PSIRepository::getTableFunction(TID tid, Standards standards, PID p
 template <typename FUNCTION, typename std::enable_if<std::is_pointer<FUNCTION>::value>::type*>
 FUNCTION ts::PSIRepository::getDescriptorFunction(const EDID& edid, TID tid, FUNCTION DescriptorDescription::* member) const
 {
-    auto it(_descriptors.end());
+    const Arrays& arr(arrays());
+    const auto find = [&arr](const EDID& id) {
+        const auto it = std::lower_bound(arr.descriptors.begin(), arr.descriptors.end(), id, KeyLess<EDID>());
+        return it != arr.descriptors.end() && it->first == id ? it : arr.descriptors.end();
+    };
+    auto it(arr.descriptors.end());
 
     if (edid.isStandard() && tid != TID_NULL) {
         // For standard descriptors, first search a table-specific descriptor.
-        it = _descriptors.find(EDID::TableSpecific(edid.did(), tid));
+        it = find(EDID::TableSpecific(edid.did(), tid));
         // If not found and there is a table-specific name for the descriptor,
         // do not fallback to non-table-specific function for this descriptor.
-        if (it == _descriptors.end() && (edid.isTableSpecific() || names::HasTableSpecificName(edid.did(), tid))) {
+        if (it == arr.descriptors.end() && (edid.isTableSpecific() || names::HasTableSpecificName(edid.did(), tid))) {
             return nullptr;
         }
     }
-    if (it == _descriptors.end()) {
+    if (it == arr.descriptors.end()) {
         // If non-standard or no table-specific descriptor found, use direct lookup.
-        it = _descriptors.find(edid);
-    }
-    return it != _descriptors.end() ? it->second.*member : nullptr;
-}
-
-
-//----------------------------------------------------------------------------
-// Constructors to register extension files.
-//----------------------------------------------------------------------------
-
-ts::PSIRepository::RegisterXML::RegisterXML(const UString& filename)
-{
-    CERR.debug(u"registering XML file %s", filename);
-    PSIRepository::Instance()._xmlModelFiles.push_back(filename);
-}
-
-
-//----------------------------------------------------------------------------
-// Constructors to register a fully or partially implemented table.
-//----------------------------------------------------------------------------
-
-ts::PSIRepository::RegisterTable::RegisterTable(TableFactory factory,
-                                                const std::vector<TID>& tids,
-                                                Standards standards,
-                                                const UString& xmlName,
-                                                DisplaySectionFunction displayFunction,
-                                                LogSectionFunction logFunction,
-                                                std::initializer_list<PID> pids,
-                                                uint16_t minCAS,
-                                                uint16_t maxCAS)
-{
-    CERR.log(2, u"registering table <%s>", xmlName);
-    PSIRepository& repo(PSIRepository::Instance());
-
-    // XML names are recorded independently.
-    if (!xmlName.empty()) {
-        repo._tableNames.insert(std::make_pair(xmlName, factory));
-    }
-
-    // Build a table description for this table.
-    TableDescription desc;
-    desc.standards = standards;
-    desc.minCAS = minCAS;
-    desc.maxCAS = maxCAS;
-    desc.factory = factory;
-    desc.display = displayFunction;
-    desc.log = logFunction;
-    desc.addPIDs(pids);
-
-    // Store a copy of the table description for each table id.
-    // This is a multimap, distinct definitions for the same table id accumulate.
-    for (auto it : tids) {
-        repo._tables.insert(std::make_pair(it, desc));
-    }
-}
-
-ts::PSIRepository::RegisterTable::RegisterTable(const std::vector<TID>& tids,
-                                                Standards standards,
-                                                DisplaySectionFunction displayFunction,
-                                                LogSectionFunction logFunction,
-                                                std::initializer_list<PID> pids,
-                                                uint16_t minCAS,
-                                                uint16_t maxCAS)
-{
-    // Use the complete constructor for actual registration.
-    RegisterTable reg(nullptr, tids, standards, UString(), displayFunction, logFunction, pids, minCAS, maxCAS);
-}
-
-
-//----------------------------------------------------------------------------
-// Constructors to register a fully or partially implemented descriptor.
-//----------------------------------------------------------------------------
-
-ts::PSIRepository::RegisterDescriptor::RegisterDescriptor(DescriptorFactory factory,
-                                                          const EDID& edid,
-                                                          const UString& xmlName,
-                                                          DisplayDescriptorFunction displayFunction,
-                                                          const UString& xmlNameLegacy)
-{
-    registerXML(factory, edid, xmlName, xmlNameLegacy);
-    PSIRepository::Instance()._descriptors.insert(std::make_pair(edid, DescriptorDescription(factory, displayFunction)));
-}
-
-void ts::PSIRepository::RegisterDescriptor::registerXML(DescriptorFactory factory, const EDID& edid, const UString& xmlName, const UString& xmlNameLegacy)
-{
-    PSIRepository& repo(PSIRepository::Instance());
-
-    if (!xmlName.empty()) {
-        repo._descriptorNames.insert(std::make_pair(xmlName, factory));
-        if (edid.isTableSpecific()) {
-            repo._descriptorTablesIds.insert(std::make_pair(xmlName, edid.tableId()));
-        }
-    }
-    if (!xmlNameLegacy.empty()) {
-        repo._descriptorNames.insert(std::make_pair(xmlNameLegacy, factory));
-        if (edid.isTableSpecific()) {
-            repo._descriptorTablesIds.insert(std::make_pair(xmlNameLegacy, edid.tableId()));
-        }
-    }
-}
-
-ts::PSIRepository::RegisterDescriptor::RegisterDescriptor(DisplayCADescriptorFunction displayFunction, uint16_t minCAS, uint16_t maxCAS)
-{
-    if (displayFunction != nullptr) {
-        PSIRepository& repo(PSIRepository::Instance());
-        do {
-            repo._casIdDescriptorDisplays.insert(std::make_pair(minCAS, displayFunction));
-        } while (minCAS++ < maxCAS);
+        it = find(edid);
     }
+    return it != arr.descriptors.end() ? it->second.*member : nullptr;
 }
 
 
@@ -272,14 +507,16 @@ ts::LogSectionFunction ts::PSIRepository::getSectionLog(TID id, Standards standa
 
 ts::PSIRepository::TableFactory ts::PSIRepository::getTableFactory(const UString& node_name) const
 {
-    const auto it = node_name.findSimilar(_tableNames);
-    return it != _tableNames.end() ? it->second : nullptr;
+    const Arrays& arr(arrays());
+    const auto range = FindNames(arr.tableNames, node_name);
+    return range.first != range.second ? range.first->second : nullptr;
 }
 
 ts::PSIRepository::DescriptorFactory ts::PSIRepository::getDescriptorFactory(const UString& node_name) const
 {
-    const auto it = node_name.findSimilar(_descriptorNames);
-    return it != _descriptorNames.end() ? it->second : nullptr;
+    const Arrays& arr(arrays());
+    const auto range = FindNames(arr.descriptorNames, node_name);
+    return range.first != range.second ? range.first->second : nullptr;
 }
 
 ts::PSIRepository::DescriptorFactory ts::PSIRepository::getDescriptorFactory(const EDID& edid, TID tid) const
@@ -294,8 +531,9 @@ ts::DisplayDescriptorFunction ts::PSIRepository::getDescriptorDisplay(const EDID
 
 ts::DisplayCADescriptorFunction ts::PSIRepository::getCADescriptorDisplay(uint16_t cas_id) const
 {
-    const auto it = _casIdDescriptorDisplays.find(cas_id);
-    return it != _casIdDescriptorDisplays.end() ? it->second : nullptr;
+    const Arrays& arr(arrays());
+    const auto it = std::lower_bound(arr.casIdDescriptorDisplays.begin(), arr.casIdDescriptorDisplays.end(), cas_id, KeyLess<uint16_t>());
+    return it != arr.casIdDescriptorDisplays.end() && it->first == cas_id ? it->second : nullptr;
 }
 
 
@@ -305,9 +543,12 @@ ts::DisplayCADescriptorFunction ts::PSIRepository::getCADescriptorDisplay(uint16
 
 ts::Standards ts::PSIRepository::getTableStandards(TID tid, PID pid) const
 {
+    const Arrays& arr(arrays());
+
     // Accumulate the common subset of all standards for this table id.
     Standards standards = Standards::NONE;
-    for (auto it = _tables.lower_bound(tid); it != _tables.end() && it->first == tid; ++it) {
+    const auto range = std::equal_range(arr.tables.begin(), arr.tables.end(), tid, KeyLess<TID>());
+    for (auto it = range.first; it != range.second; ++it) {
         if (it->second.hasPID(pid)) {
             // We are in a standard PID for this table id, return the corresponding standards only.
             return it->second.standards;
@@ -331,19 +572,20 @@ ts::Standards ts::PSIRepository::getTableStandards(TID tid, PID pid) const
 
 bool ts::PSIRepository::isDescriptorAllowed(const UString& desc_node_name, TID table_id) const
 {
-    auto it = desc_node_name.findSimilar(_descriptorTablesIds);
-    if (it == _descriptorTablesIds.end()) {
+    const Arrays& arr(arrays());
+    const auto range = FindNames(arr.descriptorTablesIds, desc_node_name);
+    if (range.first == range.second) {
         // Not a table-specific descriptor, allowed anywhere
         return true;
     }
     else {
         // Table specific descriptor, the table needs to be listed.
-        do {
+        for (auto it = range.first; it != range.second; ++it) {
             if (table_id == it->second) {
                 // The table is explicitly allowed.
                 return true;
             }
-        } while (++it != _descriptorTablesIds.end() && desc_node_name.similar(it->first));
+        }
         // The requested table if was not found.
         return false;
     }
@@ -356,15 +598,15 @@ bool ts::PSIRepository::isDescriptorAllowed(const UString& desc_node_name, TID t
 
 ts::UString ts::PSIRepository::descriptorTables(const DuckContext& duck, const UString& desc_node_name) const
 {
-    auto it = desc_node_name.findSimilar(_descriptorTablesIds);
+    const Arrays& arr(arrays());
+    const auto range = FindNames(arr.descriptorTablesIds, desc_node_name);
     UString result;
 
-    while (it != _descriptorTablesIds.end() && desc_node_name.similar(it->first)) {
+    for (auto it = range.first; it != range.second; ++it) {
         if (!result.empty()) {
             result.append(u", ");
         }
         result.append(names::TID(duck, it->second, CASID_NULL, NamesFlags::NAME | NamesFlags::HEXA));
-        ++it;
     }
 
     return result;
@@ -377,36 +619,39 @@ ts::UString ts::PSIRepository::descriptorTables(const DuckContext& duck, const U
 
 void ts::PSIRepository::getRegisteredTableIds(std::vector<TID>& ids) const
 {
+    const Arrays& arr(arrays());
     ids.clear();
-    TID previous = TID_NULL;
-    for (const auto& it : _tables) {
-        // This is a multimap, the same key can be reused, use it once only.
-        if (it.first != previous) {
+    for (const auto& it : arr.tables) {
+        // The same table id can be used several times, use it once only.
+        if (ids.empty() || it.first != ids.back()) {
             ids.push_back(it.first);
-            previous = it.first;
         }
     }
 }
 
 void ts::PSIRepository::getRegisteredDescriptorIds(std::vector<EDID>& ids) const
 {
+    const Arrays& arr(arrays());
     ids.clear();
-    for (const auto& it : _descriptors) {
+    for (const auto& it : arr.descriptors) {
         ids.push_back(it.first);
     }
 }
 
 void ts::PSIRepository::getRegisteredTableNames(UStringList& names) const
 {
-    names = MapKeysList(_tableNames);
+    const Arrays& arr(arrays());
+    GetNames(names, arr.tableNames);
 }
 
 void ts::PSIRepository::getRegisteredDescriptorNames(UStringList& names) const
 {
-    names = MapKeysList(_descriptorNames);
+    const Arrays& arr(arrays());
+    GetNames(names, arr.descriptorNames);
 }
 
 void ts::PSIRepository::getRegisteredTablesModels(UStringList& names) const
 {
-    names = _xmlModelFiles;
+    const Arrays& arr(arrays());
+    names = arr.xmlModelFiles;
 }
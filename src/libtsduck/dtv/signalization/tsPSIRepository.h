@@ -30,10 +30,18 @@ namespace ts {
     //!
     //! This class is a singleton. Use static Instance() method to access the single instance.
     //!
-    //! Multi-threading considerations: The singleton is built and modified using static
-    //! registration instances during the initialization of the application (ie. in one
-    //! single thread). Then, the singleton is only read during the execution of the
-    //! application. So, no explicit synchronization is required.
+    //! Tables and descriptors are declared using static registration instances (see the
+    //! macros TS_REGISTER_TABLE and others). Declaring them is cheap: the registration
+    //! instances are only linked together during the initialization of the application.
+    //! The sorted lookup arrays of the repository are built from all registration instances
+    //! when the repository is used for the first time. They are rebuilt when new registration
+    //! instances are declared later, when a shared library (plugin, extension) is loaded.
+    //!
+    //! Multi-threading considerations: The repository can be used from any thread, including
+    //! while a shared library which declares new tables or descriptors is loaded. Each build
+    //! creates a new set of arrays which is atomically published. Previous sets of arrays are
+    //! kept until the end of the application because other threads may still use them.
+    //! Rebuilds are rare, only when shared libraries are loaded.
     //!
     //! @ingroup mpeg
     //!
@@ -195,11 +203,53 @@ namespace ts {
         //!
         void getRegisteredTablesModels(UStringList& names) const;
 
+    private:
+        // Description of a table id. Several descriptions can be used for the same table id,
+        // for instance for distinct DTV standards or disctinct CA systems.
+        // We use a fixed-size array for 'pids' instead of a PIDSet for storage efficiency.
+        class TableDescription
+        {
+        public:
+            Standards              standards = Standards::NONE;  // Standards for this table id.
+            uint16_t               minCAS = CASID_NULL;          // Minimum CAS id for this table id (CASID_NULL if none).
+            uint16_t               maxCAS = CASID_NULL;          // Maximum CAS id for this table id (CASID_NULL if none).
+            TableFactory           factory = nullptr;            // Function to build an instance of the table.
+            DisplaySectionFunction display = nullptr;            // Function to display a section.
+            LogSectionFunction     log = nullptr;                // Function to log a section.
+            std::array<PID,8>      pids {};                      // Standard PID's for the standard, stop at first PID_NULL.
+
+            // Constructor.
+            TableDescription();
+
+            // Add PIDs in the list.
+            void addPIDs(std::initializer_list<PID> morePIDs);
+
+            // Check if a PID is present.
+            bool hasPID(PID pid) const;
+        };
+
+        // Description of a descriptor extended id.
+        // Only one description can be used per extended descriptor id,
+        class DescriptorDescription
+        {
+        public:
+            DescriptorFactory         factory;  // Function to build an instance of the descriptor.
+            DisplayDescriptorFunction display;  // Function to display a descriptor.
+
+            // Constructor.
+            DescriptorDescription(DescriptorFactory fact = nullptr, DisplayDescriptorFunction disp = nullptr);
+        };
+
+    public:
         //!
         //! A class to register fully implemented tables.
         //! The registration is performed using constructors.
         //! Thus, it is possible to perform a registration in the declaration of a static object.
         //!
+        //! The registration object shall remain valid during the life of the application.
+        //! It is only linked in a list and does not allocate memory. The repository is built
+        //! from all registration objects when it is used for the first time.
+        //!
         class TSDUCKDLL RegisterTable
         {
             TS_NOBUILD_NOCOPY(RegisterTable);
@@ -209,7 +259,30 @@ namespace ts {
             //! @param [in] factory Function which creates a table of this type.
             //! @param [in] tids List of table ids for this type. Usually there is only one (notable exception: EIT, SDT, NIT).
             //! @param [in] standards List of standards which define this table.
-            //! @param [in] xmlName XML node name for this table type.
+            //! @param [in] xmlName XML node name for this table type. Must be a static string.
+            //! @param [in] displayFunction Display function for the corresponding sections. Can be null.
+            //! @param [in] logFunction Log function for the corresponding sections. Can be null.
+            //! @param [in] pids List of PID's which are defined by the standards for this table.
+            //! @param [in] minCAS First CA_system_id if the display function applies to one CAS only.
+            //! @param [in] maxCAS Last CA_system_id if the display function applies to one CAS only. Same as @a minCAS when set as CASID_NULL.
+            //! @see TS_REGISTER_TABLE
+            //!
+            RegisterTable(TableFactory factory,
+                          std::initializer_list<TID> tids,
+                          Standards standards,
+                          const UChar* xmlName,
+                          DisplaySectionFunction displayFunction = nullptr,
+                          LogSectionFunction logFunction = nullptr,
+                          std::initializer_list<PID> pids = {},
+                          uint16_t minCAS = CASID_NULL,
+                          uint16_t maxCAS = CASID_NULL);
+
+            //!
+            //! Register a fully implemented table.
+            //! @param [in] factory Function which creates a table of this type.
+            //! @param [in] tids List of table ids for this type, typically built using ts::Range().
+            //! @param [in] standards List of standards which define this table.
+            //! @param [in] xmlName XML node name for this table type. Must be a static string.
             //! @param [in] displayFunction Display function for the corresponding sections. Can be null.
             //! @param [in] logFunction Log function for the corresponding sections. Can be null.
             //! @param [in] pids List of PID's which are defined by the standards for this table.
@@ -220,7 +293,7 @@ namespace ts {
             RegisterTable(TableFactory factory,
                           const std::vector<TID>& tids,
                           Standards standards,
-                          const UString& xmlName,
+                          const UChar* xmlName,
                           DisplaySectionFunction displayFunction = nullptr,
                           LogSectionFunction logFunction = nullptr,
                           std::initializer_list<PID> pids = {},
@@ -238,6 +311,25 @@ namespace ts {
             //! @param [in] maxCAS Last CA_system_id if the display function applies to one CAS only. Same as @a minCAS when set as CASID_NULL.
             //! @see TS_REGISTER_SECTION
             //!
+            RegisterTable(std::initializer_list<TID> tids,
+                          Standards standards,
+                          DisplaySectionFunction displayFunction = nullptr,
+                          LogSectionFunction logFunction = nullptr,
+                          std::initializer_list<PID> pids = {},
+                          uint16_t minCAS = CASID_NULL,
+                          uint16_t maxCAS = CASID_NULL);
+
+            //!
+            //! Register a known table with display functions but no full C++ class.
+            //! @param [in] tids List of table ids for this type, typically built using ts::Range().
+            //! @param [in] standards List of standards which define this table.
+            //! @param [in] displayFunction Display function for the corresponding sections. Can be null.
+            //! @param [in] logFunction Log function for the corresponding sections. Can be null.
+            //! @param [in] pids List of PID's which are defined by the standards for this table.
+            //! @param [in] minCAS First CA_system_id if the display function applies to one CAS only.
+            //! @param [in] maxCAS Last CA_system_id if the display function applies to one CAS only. Same as @a minCAS when set as CASID_NULL.
+            //! @see TS_REGISTER_SECTION
+            //!
             RegisterTable(const std::vector<TID>& tids,
                           Standards standards,
                           DisplaySectionFunction displayFunction = nullptr,
@@ -245,6 +337,17 @@ namespace ts {
                           std::initializer_list<PID> pids = {},
                           uint16_t minCAS = CASID_NULL,
                           uint16_t maxCAS = CASID_NULL);
+
+        private:
+            friend class PSIRepository;
+            const RegisterTable* _next = nullptr;     // Next registration in the list.
+            std::bitset<256>     _tids {};            // Set of table ids.
+            const UChar*         _xmlName = nullptr;  // XML node name, can be null.
+            TableDescription     _desc {};            // Description for all table ids.
+
+            // Common code for constructors.
+            void init(Standards standards, DisplaySectionFunction displayFunction, LogSectionFunction logFunction,
+                      std::initializer_list<PID> pids, uint16_t minCAS, uint16_t maxCAS);
         };
 
         //!
@@ -252,6 +355,10 @@ namespace ts {
         //! The registration is performed using constructors.
         //! Thus, it is possible to perform a registration in the declaration of a static object.
         //!
+        //! The registration object shall remain valid during the life of the application.
+        //! It is only linked in a list and does not allocate memory. The repository is built
+        //! from all registration objects when it is used for the first time.
+        //!
         class TSDUCKDLL RegisterDescriptor
         {
             TS_NOBUILD_NOCOPY(RegisterDescriptor);
@@ -260,16 +367,16 @@ namespace ts {
             //! Register a descriptor factory for a given descriptor tag.
             //! @param [in] factory Function which creates a descriptor of this type.
             //! @param [in] edid Exended descriptor id.
-            //! @param [in] xmlName XML node name for this descriptor type.
+            //! @param [in] xmlName XML node name for this descriptor type. Must be a static string.
             //! @param [in] displayFunction Display function for the corresponding descriptors. Can be null.
-            //! @param [in] xmlNameLegacy Legacy XML node name for this descriptor type (optional).
+            //! @param [in] xmlNameLegacy Legacy XML node name for this descriptor type (optional). Must be a static string.
             //! @see TS_REGISTER_DESCRIPTOR
             //!
             RegisterDescriptor(DescriptorFactory factory,
                                const EDID& edid,
-                               const UString& xmlName,
+                               const UChar* xmlName,
                                DisplayDescriptorFunction displayFunction = nullptr,
-                               const UString& xmlNameLegacy = UString());
+                               const UChar* xmlNameLegacy = nullptr);
 
             //!
             //! Registers a CA_descriptor display function for a given range of CA_system_id.
@@ -282,7 +389,15 @@ namespace ts {
             RegisterDescriptor(DisplayCADescriptorFunction displayFunction, uint16_t minCAS, uint16_t maxCAS = CASID_NULL);
 
         private:
-            void registerXML(DescriptorFactory factory, const EDID& edid, const UString& xmlName, const UString& xmlNameLegacy);
+            friend class PSIRepository;
+            const RegisterDescriptor*   _next = nullptr;           // Next registration in the list.
+            EDID                        _edid {};                  // Extended descriptor id.
+            const UChar*                _xmlName = nullptr;        // XML node name, can be null.
+            const UChar*                _xmlNameLegacy = nullptr;  // Legacy XML node name, can be null.
+            DescriptorDescription       _desc {};                  // Description of the descriptor.
+            DisplayCADescriptorFunction _caDisplay = nullptr;      // Display function of CA_descriptor.
+            uint16_t                    _minCAS = CASID_NULL;      // First CA_system_id for _caDisplay.
+            uint16_t                    _maxCAS = CASID_NULL;      // Last CA_system_id for _caDisplay.
         };
 
         //!
@@ -304,53 +419,54 @@ namespace ts {
             //! @see TS_REGISTER_XML_FILE
             //!
             RegisterXML(const UString& filename);
-        };
 
+        private:
+            friend class PSIRepository;
+            const RegisterXML* _next = nullptr;  // Next registration in the list.
+            const UString      _filename;        // XML model file name.
+        };
     private:
-        // Description of a table id. Several descriptions can be used for the same table id,
-        // for instance for distinct DTV standards or disctinct CA systems.
-        // We use a fixed-size array for 'pids' instead of a PIDSet for storage efficiency.
-        class TableDescription
+        // An entry in a sorted array, indexed by a key.
+        template <typename KEY, typename VALUE>
+        using Entry = std::pair<KEY, VALUE>;
+
+        // The lookup arrays, built from the registration objects on first use and rebuilt when new
+        // registrations occur later (loading a shared library). All arrays are sorted by key.
+        // Entries with the same key are in order of registration. XML names are sorted in the
+        // order of CompareNames(), meaning that all similar names are adjacent.
+        // An instance is never modified after publication.
+        class Arrays
         {
         public:
-            Standards              standards = Standards::NONE;  // Standards for this table id.
-            uint16_t               minCAS = CASID_NULL;          // Minimum CAS id for this table id (CASID_NULL if none).
-            uint16_t               maxCAS = CASID_NULL;          // Maximum CAS id for this table id (CASID_NULL if none).
-            TableFactory           factory = nullptr;            // Function to build an instance of the table.
-            DisplaySectionFunction display = nullptr;            // Function to display a section.
-            LogSectionFunction     log = nullptr;                // Function to log a section.
-            std::array<PID,8>      pids {};                      // Standard PID's for the standard, stop at first PID_NULL.
-
-            // Constructor.
-            TableDescription();
+            size_t                                                     count = 0;                    // Number of registrations in the arrays.
+            std::vector<Entry<TID, TableDescription>>                  tables {};                    // Description of all table ids, potential multiple entries per table idx
+            std::vector<Entry<EDID, DescriptorDescription>>            descriptors {};               // Description of all descriptors, by extended id.
+            std::vector<Entry<const UChar*, TableFactory>>             tableNames {};                // XML table name to table factory
+            std::vector<Entry<const UChar*, DescriptorFactory>>        descriptorNames {};           // XML descriptor name to descriptor factory
+            std::vector<Entry<const UChar*, TID>>                      descriptorTablesIds {};       // XML descriptor name to table id for table-specific descriptors
+            std::vector<Entry<uint16_t, DisplayCADescriptorFunction>> casIdDescriptorDisplays {};   // CA_system_id to display function for CA_descriptor.
+            UStringList                                                xmlModelFiles {};             // Additional XML model files for tables.
+        };
 
-            // Add PIDs in the list.
-            void addPIDs(std::initializer_list<PID> morePIDs);
+        // PSIRepository instance private members.
+        mutable std::atomic<const Arrays*>                _arrays {nullptr};  // Current arrays, atomically published.
+        mutable std::list<std::unique_ptr<const Arrays>>  _allArrays {};      // All built arrays, under protection of the registration mutex.
 
-            // Check if a PID is present.
-            bool hasPID(PID pid) const;
-        };
+        // Get the current arrays, build them from all registration objects if necessary.
+        const Arrays& arrays() const;
 
-        // Description of a descriptor extended id.
-        // Only one description can be used per extended descriptor id,
-        class DescriptorDescription
-        {
-        public:
-            DescriptorFactory         factory;  // Function to build an instance of the descriptor.
-            DisplayDescriptorFunction display;  // Function to display a descriptor.
+        // Compare two XML names, case-insensitive and ignoring blanks, consistently with UString::similar().
+        static bool CompareNames(const UChar* name1, const UChar* name2);
 
-            // Constructor.
-            DescriptorDescription(DescriptorFactory fact = nullptr, DisplayDescriptorFunction disp = nullptr);
-        };
+        // Find the range of entries with a given XML name in a sorted array of names.
+        template <typename VALUE>
+        using NameIterator = typename std::vector<Entry<const UChar*, VALUE>>::const_iterator;
+        template <typename VALUE>
+        static std::pair<NameIterator<VALUE>, NameIterator<VALUE>> FindNames(const std::vector<Entry<const UChar*, VALUE>>& entries, const UString& name);
 
-        // PSIRepository instance private members.
-        std::multimap<TID, TableDescription>            _tables {};                   // Description of all table ids, potential multiple entries per table idx
-        std::map<EDID, DescriptorDescription>           _descriptors {};              // Description of all descriptors, by extended id.
-        std::map<UString, TableFactory>                 _tableNames {};               // XML table name to table factory
-        std::map<UString, DescriptorFactory>            _descriptorNames {};          // XML descriptor name to descriptor factory
-        std::multimap<UString, TID>                     _descriptorTablesIds {};      // XML descriptor name to table id for table-specific descriptors
-        std::map<uint16_t, DisplayCADescriptorFunction> _casIdDescriptorDisplays {};  // CA_system_id to display function for CA_descriptor.
-        UStringList                                     _xmlModelFiles {};            // Additional XML model files for tables.
+        // Get the list of distinct names in a sorted array of names.
+        template <typename VALUE>
+        static void GetNames(UStringList& names, const std::vector<Entry<const UChar*, VALUE>>& entries);
 
         // Common code to lookup a table function.
         template <typename FUNCTION, typename std::enable_if<std::is_pointer<FUNCTION>::value>::type* = nullptr>
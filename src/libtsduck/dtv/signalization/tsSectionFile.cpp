@@ -12,6 +12,8 @@
 #include "tsPSIRepository.h"
 #include "tsDuckContext.h"
 #include "tsxmlElement.h"
+#include "tsxmlPullDocument.h"
+#include "tsxmlRunningDocument.h"
 #include "tsxmlJSONConverter.h"
 #include "tsjsonNull.h"
 #include "tsEIT.h"
@@ -533,16 +535,30 @@ bool ts::SectionFile::LoadModel(xml::Document& doc, bool load_extensions)
 
 bool ts::SectionFile::loadXML(const UString& file_name)
 {
-    xml::Document doc(_report);
+    xml::PullDocument doc(_report);
     doc.setTweaks(_xmlTweaks);
-    return doc.load(file_name, false) && parseDocument(doc);
+    return doc.open(file_name) != nullptr && parsePullDocument(doc);
 }
 
 bool ts::SectionFile::loadXML(std::istream& strm)
 {
-    xml::Document doc(_report);
+    xml::PullDocument doc(_report);
     doc.setTweaks(_xmlTweaks);
-    return doc.load(strm) && parseDocument(doc);
+    return doc.open(strm) != nullptr && parsePullDocument(doc);
+}
+
+bool ts::SectionFile::parsePullDocument(xml::PullDocument& doc)
+{
+    // Validate and analyze the document one table at a time. The document contains
+    // the root element and at most one table. The first call validates the root.
+    bool success = parseDocument(doc);
+    if (success) {
+        while (doc.next() != nullptr) {
+            success = parseDocument(doc) && success;
+        }
+        success = doc.isValid() && success;
+    }
+    return success;
 }
 
 bool ts::SectionFile::parseXML(const UString& xml_content)
@@ -590,9 +606,33 @@ bool ts::SectionFile::parseDocument(const xml::Document& doc)
 
 bool ts::SectionFile::saveXML(const UString& file_name) const
 {
-    xml::Document doc(_report);
+    // Without table, the document is made of an empty root element.
+    if (_tables.empty()) {
+        xml::Document doc(_report);
+        doc.setTweaks(_xmlTweaks);
+        return generateDocument(doc) && doc.save(file_name);
+    }
+
+    // Generate the document one table at a time, do not build the complete document in memory.
+    xml::RunningDocument doc(_report);
     doc.setTweaks(_xmlTweaks);
-    return generateDocument(doc) && doc.save(file_name);
+    xml::Element* root = doc.open(u"tsduck", UString(), file_name);
+    if (root == nullptr) {
+        return false;
+    }
+    for (auto& table : _tables) {
+        if (table != nullptr) {
+            table->toXML(_duck, root);
+            doc.flush();
+        }
+    }
+    doc.flush();
+    reportOrphanSections(doc.report());
+    if (!doc.close()) {
+        _report.error(u"error writing %s", file_name);
+        return false;
+    }
+    return true;
 }
 
 ts::UString ts::SectionFile::toXML() const
@@ -700,12 +740,20 @@ bool ts::SectionFile::generateDocument(xml::Document& doc) const
         }
     }
 
-    // Issue a warning if incomplete tables were not saved.
+    reportOrphanSections(doc.report());
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Issue a warning if incomplete tables are not saved in an XML document.
+//----------------------------------------------------------------------------
+
+void ts::SectionFile::reportOrphanSections(Report& report) const
+{
     if (!_orphanSections.empty()) {
-        doc.report().warning(u"%d orphan sections not saved in XML document (%d tables saved)", _orphanSections.size(), _tables.size());
+        report.warning(u"%d orphan sections not saved in XML document (%d tables saved)", _orphanSections.size(), _tables.size());
     }
-
-    return true;
 }
 
 
@@ -25,6 +25,11 @@
 #include "tsTablesPtr.h"
 
 namespace ts {
+    // Incomplete declarations:
+    namespace xml {
+        class PullDocument;
+    }
+
     //!
     //! A binary or XML file containing PSI/SI sections and tables.
     //! @ingroup mpeg
@@ -181,6 +186,8 @@ namespace ts {
         //! If the file name starts with "<?xml", this is considered as "inline XML content".
         //! If the file name is empty or "-", the standard input is used.
         //! @return True on success, false on error.
+        //! The file is loaded one table at a time, without loading the complete XML document in memory.
+        //! In case of error, the valid tables before the error are still added to this object.
         //!
         bool loadXML(const UString& file_name);
 
@@ -498,9 +505,15 @@ namespace ts {
         // Parse an XML document.
         bool parseDocument(const xml::Document& doc);
 
+        // Parse an XML document, one table at a time.
+        bool parsePullDocument(xml::PullDocument& doc);
+
         // Generate an XML document.
         bool generateDocument(xml::Document& doc) const;
 
+        // Issue a warning if incomplete tables are not saved in an XML document.
+        void reportOrphanSections(Report& report) const;
+
         // Check it a table can be formed using the last sections in _orphanSections.
         void collectLastTable();
 
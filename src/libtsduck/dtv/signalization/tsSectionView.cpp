@@ -0,0 +1,63 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2024, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+
+#include "tsSectionView.h"
+
+
+//----------------------------------------------------------------------------
+// Constructors.
+//----------------------------------------------------------------------------
+
+ts::SectionView::SectionView(const Section& section) :
+    SectionView(section.isValid() ? section.content() : nullptr, section.isValid() ? section.size() : 0)
+{
+}
+
+ts::SectionView::SectionView(const uint8_t* content, size_t size)
+{
+    if (content != nullptr && size >= MIN_SHORT_SECTION_SIZE) {
+        const size_t section_size = SHORT_SECTION_HEADER_SIZE + (GetUInt16(content + 1) & 0x0FFF);
+        const bool is_long = Section::StartLongSection(content, size);
+        if (section_size <= size && (!is_long || section_size >= MIN_LONG_SECTION_SIZE)) {
+            _content = content;
+            _size = section_size;
+            _long = is_long;
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Invalidate the view when the section is not of the expected type.
+//----------------------------------------------------------------------------
+
+void ts::SectionView::validate(bool valid, size_t min_payload_size)
+{
+    if (!valid || payloadSize() < min_payload_size) {
+        _content = nullptr;
+        _size = 0;
+        _long = false;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Get a view over a descriptor loop with a 12-bit length prefix.
+//----------------------------------------------------------------------------
+
+ts::DescriptorListView ts::SectionView::descriptorLoop(size_t offset) const
+{
+    const size_t psize = payloadSize();
+    if (offset + 2 > psize) {
+        return DescriptorListView();
+    }
+    else {
+        const uint8_t* const data = payload() + offset + 2;
+        return DescriptorListView(data, std::min<size_t>(GetUInt16(data - 2) & 0x0FFF, psize - offset - 2));
+    }
+}
@@ -0,0 +1,159 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2024, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Read-only view over a binary PSI/SI section.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsDescriptorView.h"
+#include "tsSection.h"
+
+namespace ts {
+    //!
+    //! Read-only view over a binary PSI/SI section.
+    //! @ingroup mpeg
+    //!
+    //! A section view references the binary content of a section, typically inside
+    //! a ts::Section. It is used to inspect the content of a section without
+    //! deserializing it into a table object (ts::PAT, ts::PMT, etc.): no data
+    //! are copied, no memory is allocated.
+    //!
+    //! The referenced binary data are not copied. They must remain valid and unmodified
+    //! as long as the view is used. When the view is built from a ts::Section, the section
+    //! object must not be modified or destroyed while the view is used.
+    //!
+    //! Subclasses provide specialized views for the most common tables. They check the
+    //! table id and the minimum size of the section, and give access to the loops of
+    //! structures in the section payload.
+    //!
+    //! @see ts::PATView
+    //! @see ts::PMTView
+    //! @see ts::SDTView
+    //! @see ts::EITView
+    //!
+    class TSDUCKDLL SectionView
+    {
+    public:
+        //!
+        //! Default constructor, an invalid section view.
+        //!
+        SectionView() = default;
+
+        //!
+        //! Constructor from a section.
+        //! @param [in] section The section to view.
+        //!
+        SectionView(const Section& section);
+
+        //!
+        //! Constructor from binary data.
+        //! @param [in] content Address of the complete binary section.
+        //! @param [in] size Size in bytes of the binary area. The section is invalid if
+        //! its section_length field exceeds this size. Extra bytes are ignored.
+        //!
+        SectionView(const uint8_t* content, size_t size);
+
+        //!
+        //! Check if the view is valid.
+        //! @return True if the view references a valid section.
+        //!
+        bool isValid() const { return _content != nullptr; }
+
+        //!
+        //! Get the table id.
+        //! @return The table id or TID_NULL if the view is invalid.
+        //!
+        TID tableId() const { return _content != nullptr ? _content[0] : uint8_t(TID_NULL); }
+
+        //!
+        //! Check if the section is a long one.
+        //! @return True if the section is a long one.
+        //!
+        bool isLongSection() const { return _long; }
+
+        //!
+        //! Get the table id extension (long section only).
+        //! @return The table id extension.
+        //!
+        uint16_t tableIdExtension() const { return _long ? GetUInt16(_content + 3) : 0; }
+
+        //!
+        //! Get the section version number (long section only).
+        //! @return The section version number.
+        //!
+        uint8_t version() const { return _long ? ((_content[5] >> 1) & 0x1F) : 0; }
+
+        //!
+        //! Check if the section is "current", not "next" (long section only).
+        //! @return True if the section is "current", false if it is "next".
+        //!
+        bool isCurrent() const { return _long && (_content[5] & 0x01) != 0; }
+
+        //!
+        //! Get the section number in the table (long section only).
+        //! @return The section number.
+        //!
+        uint8_t sectionNumber() const { return _long ? _content[6] : 0; }
+
+        //!
+        //! Get the number of the last section in the table (long section only).
+        //! @return The last section number.
+        //!
+        uint8_t lastSectionNumber() const { return _long ? _content[7] : 0; }
+
+        //!
+        //! Get the address of the complete binary section.
+        //! @return The address of the complete binary section or a null pointer if the view is invalid.
+        //!
+        const uint8_t* content() const { return _content; }
+
+        //!
+        //! Get the size of the complete binary section.
+        //! @return The size in bytes of the complete binary section.
+        //!
+        size_t size() const { return _size; }
+
+        //!
+        //! Get the address of the section payload.
+        //! For long sections, the payload starts after the last_section_number field.
+        //! @return The address of the section payload or a null pointer if the view is invalid.
+        //!
+        const uint8_t* payload() const { return _content == nullptr ? nullptr : _content + (_long ? LONG_SECTION_HEADER_SIZE : SHORT_SECTION_HEADER_SIZE); }
+
+        //!
+        //! Get the size of the section payload.
+        //! For long sections, the payload ends before the CRC32 field.
+        //! @return The size in bytes of the section payload.
+        //!
+        size_t payloadSize() const { return _content == nullptr ? 0 : _size - (_long ? LONG_SECTION_HEADER_SIZE + SECTION_CRC32_SIZE : SHORT_SECTION_HEADER_SIZE); }
+
+    protected:
+        //!
+        //! Invalidate the view when the section is not of the expected type.
+        //! To be used by subclasses in their constructors.
+        //! @param [in] valid When false, the view is invalidated.
+        //! @param [in] min_payload_size Minimum size of the payload. When the payload is
+        //! shorter, the view is invalidated.
+        //!
+        void validate(bool valid, size_t min_payload_size);
+
+        //!
+        //! Get a view over a descriptor loop with a 12-bit length prefix, inside the payload.
+        //! @param [in] offset Offset of the 2-byte length field in the payload.
+        //! @return A view over the descriptor loop. The loop is truncated to the end of the payload.
+        //!
+        DescriptorListView descriptorLoop(size_t offset) const;
+
+    private:
+        const uint8_t* _content = nullptr;
+        size_t         _size = 0;
+        bool           _long = false;
+    };
+}
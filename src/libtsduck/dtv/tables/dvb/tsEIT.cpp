@@ -178,11 +178,14 @@ size_t ts::EIT::TimeToSegment(const Time& last_midnight, const Time& event_start
 
 ts::Time ts::EIT::SegmentStartTime(const Time& event_start_time)
 {
-    // A segment is a range of 3 hours.
-    Time::Fields f(event_start_time);
-    f.hour -= f.hour % 3;
-    f.minute = f.second = f.millisecond = 0;
-    return Time(f);
+    // A segment is a range of 3 hours. Since a day contains an integral number of segments, the segment
+    // boundaries are computed from the Unix epoch, without decomposing the time in fields (slow).
+    const cn::milliseconds elapsed = event_start_time - Time::UnixEpoch;
+    cn::milliseconds offset = elapsed % SEGMENT_DURATION;
+    if (offset < cn::milliseconds::zero()) {
+        offset += SEGMENT_DURATION;
+    }
+    return Time::UnixEpoch + (elapsed - offset);
 }
 
 
@@ -0,0 +1,54 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2024, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+
+#include "tsEITView.h"
+#include "tsMJD.h"
+#include "tsBCD.h"
+
+
+//----------------------------------------------------------------------------
+// Constructors.
+//----------------------------------------------------------------------------
+
+ts::EITView::EITView(const Section& section) :
+    SectionView(section)
+{
+    validate(tableId() >= TID_EIT_MIN && tableId() <= TID_EIT_MAX && isLongSection(), 6);
+}
+
+ts::EITView::EITView(const uint8_t* content, size_t size) :
+    SectionView(content, size)
+{
+    validate(tableId() >= TID_EIT_MIN && tableId() <= TID_EIT_MAX && isLongSection(), 6);
+}
+
+ts::EITView::Event::Event(const uint8_t* data, size_t size) :
+    _data(data),
+    _size(data != nullptr && size >= HEADER_SIZE && HEADER_SIZE + (GetUInt16(data + 10) & 0x0FFF) <= size ? HEADER_SIZE + (GetUInt16(data + 10) & 0x0FFF) : 0)
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Event start time and duration.
+//----------------------------------------------------------------------------
+
+ts::Time ts::EITView::Event::startTime() const
+{
+    // Accept invalid MJD values (returns Unix Epoch), same as ts::EIT.
+    Time result(Time::Epoch);
+    if (_size > 0) {
+        DecodeMJD(_data + 2, MJD_SIZE, result);
+    }
+    return result;
+}
+
+cn::seconds ts::EITView::Event::duration() const
+{
+    return _size == 0 ? cn::seconds(0) : cn::hours(DecodeBCD(_data[7])) + cn::minutes(DecodeBCD(_data[8])) + cn::seconds(DecodeBCD(_data[9]));
+}
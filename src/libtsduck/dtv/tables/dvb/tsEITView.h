@@ -0,0 +1,158 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2024, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Read-only view over a binary section of an Event Information Table (EIT).
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsSectionView.h"
+#include "tsTime.h"
+
+namespace ts {
+    //!
+    //! Read-only view over a binary section of an Event Information Table (EIT).
+    //! @see ETSI EN 300 468, 5.2.4
+    //! @ingroup table
+    //!
+    //! This is a lightweight alternative to ts::EIT to inspect an EIT section without
+    //! deserializing it. An EIT may have several sections. The view applies to one section only.
+    //! @see ts::SectionView
+    //!
+    class TSDUCKDLL EITView : public SectionView
+    {
+    public:
+        //!
+        //! Read-only view over one event in the event loop.
+        //!
+        class TSDUCKDLL Event
+        {
+        public:
+            //!
+            //! Constructor.
+            //! @param [in] data Address of the event description.
+            //! @param [in] size Remaining size in bytes of the event loop.
+            //!
+            Event(const uint8_t* data, size_t size);
+
+            //!
+            //! Get the size of the event description.
+            //! @return The size in bytes of the event description or zero if it is truncated.
+            //!
+            size_t size() const { return _size; }
+
+            //!
+            //! Get the event id.
+            //! @return The event id.
+            //!
+            uint16_t eventId() const { return _size == 0 ? 0 : GetUInt16(_data); }
+
+            //!
+            //! Get the event start time.
+            //! @return The event start time in UTC (or JST in Japan). Invalid dates are returned as Time::Epoch.
+            //!
+            Time startTime() const;
+
+            //!
+            //! Get the event duration.
+            //! @return The event duration in seconds.
+            //!
+            cn::seconds duration() const;
+
+            //!
+            //! Get the running status of the event.
+            //! @return The running status code.
+            //!
+            uint8_t runningStatus() const { return _size == 0 ? 0 : (_data[10] >> 5) & 0x07; }
+
+            //!
+            //! Check if the event is controlled by a CA system.
+            //! @return The value of the free_CA_mode field.
+            //!
+            bool caControlled() const { return _size > 0 && (_data[10] & 0x10) != 0; }
+
+            //!
+            //! Get a view over the descriptor loop of the event.
+            //! @return A view over the descriptor loop of the event.
+            //!
+            DescriptorListView descriptors() const { return _size == 0 ? DescriptorListView() : DescriptorListView(_data + HEADER_SIZE, _size - HEADER_SIZE); }
+
+        private:
+            static constexpr size_t HEADER_SIZE = 12;
+            const uint8_t* _data;
+            size_t         _size;
+        };
+
+        //!
+        //! Read-only view over the event loop of an EIT section.
+        //!
+        using EventLoop = PSILoopView<Event>;
+
+        //!
+        //! Constructor from a section.
+        //! @param [in] section The section to view. The view is invalid if this is not an EIT section.
+        //!
+        EITView(const Section& section);
+
+        //!
+        //! Constructor from binary data.
+        //! @param [in] content Address of the complete binary section.
+        //! @param [in] size Size in bytes of the binary area.
+        //!
+        EITView(const uint8_t* content, size_t size);
+
+        //!
+        //! Check if this is an "actual" EIT.
+        //! @return True for EIT Actual TS, false for EIT Other TS.
+        //!
+        bool isActual() const { const TID tid = tableId(); return tid == TID_EIT_PF_ACT || (tid >= TID_EIT_S_ACT_MIN && tid <= TID_EIT_S_ACT_MAX); }
+
+        //!
+        //! Check if this is an EIT present/following.
+        //! @return True for EIT present/following, false for EIT schedule.
+        //!
+        bool isPresentFollowing() const { return tableId() == TID_EIT_PF_ACT || tableId() == TID_EIT_PF_OTH; }
+
+        //!
+        //! Get the service id.
+        //! @return The service id.
+        //!
+        uint16_t serviceId() const { return tableIdExtension(); }
+
+        //!
+        //! Get the transport stream id.
+        //! @return The transport stream id.
+        //!
+        uint16_t tsId() const { return isValid() ? GetUInt16(payload()) : 0; }
+
+        //!
+        //! Get the original network id.
+        //! @return The original network id.
+        //!
+        uint16_t onetwId() const { return isValid() ? GetUInt16(payload() + 2) : 0; }
+
+        //!
+        //! Get the segment last section number.
+        //! @return The segment last section number.
+        //!
+        uint8_t segmentLastSectionNumber() const { return isValid() ? payload()[4] : 0; }
+
+        //!
+        //! Get the last table id.
+        //! @return The last table id.
+        //!
+        TID lastTableId() const { return isValid() ? payload()[5] : uint8_t(TID_NULL); }
+
+        //!
+        //! Get a view over the event loop.
+        //! @return A view over the event loop.
+        //!
+        EventLoop events() const { return isValid() ? EventLoop(payload() + 6, payloadSize() - 6) : EventLoop(); }
+    };
+}
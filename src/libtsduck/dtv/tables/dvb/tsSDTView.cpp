@@ -0,0 +1,43 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2024, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+
+#include "tsSDTView.h"
+
+
+//----------------------------------------------------------------------------
+// Constructors.
+//----------------------------------------------------------------------------
+
+ts::SDTView::SDTView(const Section& section) :
+    SectionView(section)
+{
+    validate((tableId() == TID_SDT_ACT || tableId() == TID_SDT_OTH) && isLongSection(), 3);
+}
+
+ts::SDTView::SDTView(const uint8_t* content, size_t size) :
+    SectionView(content, size)
+{
+    validate((tableId() == TID_SDT_ACT || tableId() == TID_SDT_OTH) && isLongSection(), 3);
+}
+
+ts::SDTView::Service::Service(const uint8_t* data, size_t size) :
+    _data(data),
+    _size(data != nullptr && size >= HEADER_SIZE && HEADER_SIZE + (GetUInt16(data + 3) & 0x0FFF) <= size ? HEADER_SIZE + (GetUInt16(data + 3) & 0x0FFF) : 0)
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Search a service by id.
+//----------------------------------------------------------------------------
+
+ts::SDTView::ServiceLoop::const_iterator ts::SDTView::findService(uint16_t service_id) const
+{
+    const ServiceLoop loop(services());
+    return std::find_if(loop.begin(), loop.end(), [service_id](const Service& srv) { return srv.serviceId() == service_id; });
+}
@@ -0,0 +1,140 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2024, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Read-only view over a binary section of a Service Description Table (SDT).
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsSectionView.h"
+
+namespace ts {
+    //!
+    //! Read-only view over a binary section of a Service Description Table (SDT).
+    //! @see ETSI EN 300 468, 5.2.3
+    //! @ingroup table
+    //!
+    //! This is a lightweight alternative to ts::SDT to inspect an SDT section without
+    //! deserializing it. An SDT may have several sections. The view applies to one section only.
+    //! @see ts::SectionView
+    //!
+    class TSDUCKDLL SDTView : public SectionView
+    {
+    public:
+        //!
+        //! Read-only view over one service in the service loop.
+        //!
+        class TSDUCKDLL Service
+        {
+        public:
+            //!
+            //! Constructor.
+            //! @param [in] data Address of the service description.
+            //! @param [in] size Remaining size in bytes of the service loop.
+            //!
+            Service(const uint8_t* data, size_t size);
+
+            //!
+            //! Get the size of the service description.
+            //! @return The size in bytes of the service description or zero if it is truncated.
+            //!
+            size_t size() const { return _size; }
+
+            //!
+            //! Get the service id.
+            //! @return The service id.
+            //!
+            uint16_t serviceId() const { return _size == 0 ? 0 : GetUInt16(_data); }
+
+            //!
+            //! Check if there are EIT schedule for this service on the current TS.
+            //! @return True if there are EIT schedule for this service.
+            //!
+            bool eitsPresent() const { return _size > 0 && (_data[2] & 0x02) != 0; }
+
+            //!
+            //! Check if there are EIT present/following for this service on the current TS.
+            //! @return True if there are EIT present/following for this service.
+            //!
+            bool eitpfPresent() const { return _size > 0 && (_data[2] & 0x01) != 0; }
+
+            //!
+            //! Get the running status of the service.
+            //! @return The running status code.
+            //!
+            uint8_t runningStatus() const { return _size == 0 ? 0 : (_data[3] >> 5) & 0x07; }
+
+            //!
+            //! Check if the service is controlled by a CA system.
+            //! @return The value of the free_CA_mode field.
+            //!
+            bool caControlled() const { return _size > 0 && (_data[3] & 0x10) != 0; }
+
+            //!
+            //! Get a view over the descriptor loop of the service.
+            //! @return A view over the descriptor loop of the service.
+            //!
+            DescriptorListView descriptors() const { return _size == 0 ? DescriptorListView() : DescriptorListView(_data + HEADER_SIZE, _size - HEADER_SIZE); }
+
+        private:
+            static constexpr size_t HEADER_SIZE = 5;
+            const uint8_t* _data;
+            size_t         _size;
+        };
+
+        //!
+        //! Read-only view over the service loop of an SDT section.
+        //!
+        using ServiceLoop = PSILoopView<Service>;
+
+        //!
+        //! Constructor from a section.
+        //! @param [in] section The section to view. The view is invalid if this is not an SDT section.
+        //!
+        SDTView(const Section& section);
+
+        //!
+        //! Constructor from binary data.
+        //! @param [in] content Address of the complete binary section.
+        //! @param [in] size Size in bytes of the binary area.
+        //!
+        SDTView(const uint8_t* content, size_t size);
+
+        //!
+        //! Check if this is an "actual" SDT.
+        //! @return True for SDT Actual TS, false for SDT Other TS.
+        //!
+        bool isActual() const { return tableId() == TID_SDT_ACT; }
+
+        //!
+        //! Get the transport stream id.
+        //! @return The transport stream id.
+        //!
+        uint16_t tsId() const { return tableIdExtension(); }
+
+        //!
+        //! Get the original network id.
+        //! @return The original network id.
+        //!
+        uint16_t onetwId() const { return isValid() ? GetUInt16(payload()) : 0; }
+
+        //!
+        //! Get a view over the service loop.
+        //! @return A view over the service loop.
+        //!
+        ServiceLoop services() const { return isValid() ? ServiceLoop(payload() + 3, payloadSize() - 3) : ServiceLoop(); }
+
+        //!
+        //! Search a service by id.
+        //! @param [in] service_id The service id to search.
+        //! @return An iterator to the service with this id or services().end() if not found.
+        //!
+        ServiceLoop::const_iterator findService(uint16_t service_id) const;
+    };
+}
@@ -0,0 +1,41 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2024, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+
+#include "tsPATView.h"
+
+
+//----------------------------------------------------------------------------
+// Constructors.
+//----------------------------------------------------------------------------
+
+ts::PATView::PATView(const Section& section) :
+    SectionView(section)
+{
+    validate(tableId() == TID_PAT && isLongSection(), 0);
+}
+
+ts::PATView::PATView(const uint8_t* content, size_t size) :
+    SectionView(content, size)
+{
+    validate(tableId() == TID_PAT && isLongSection(), 0);
+}
+
+
+//----------------------------------------------------------------------------
+// Get the PMT PID of a service.
+//----------------------------------------------------------------------------
+
+ts::PID ts::PATView::pmtPID(uint16_t service_id) const
+{
+    for (const auto& prog : programs()) {
+        if (prog.programNumber() == service_id) {
+            return prog.pid();
+        }
+    }
+    return PID_NULL;
+}
@@ -0,0 +1,110 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2024, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Read-only view over a binary section of a Program Association Table (PAT).
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsSectionView.h"
+
+namespace ts {
+    //!
+    //! Read-only view over a binary section of a Program Association Table (PAT).
+    //! @see ISO/IEC 13818-1, ITU-T Rec. H.222.0, 2.4.4.3
+    //! @ingroup table
+    //!
+    //! This is a lightweight alternative to ts::PAT to inspect a PAT section without
+    //! deserializing it. A PAT may have several sections. The view applies to one section only.
+    //! @see ts::SectionView
+    //!
+    class TSDUCKDLL PATView : public SectionView
+    {
+    public:
+        //!
+        //! Read-only view over one entry of the program loop.
+        //!
+        class TSDUCKDLL Program
+        {
+        public:
+            //!
+            //! Constructor.
+            //! @param [in] data Address of the entry.
+            //! @param [in] size Remaining size in bytes of the program loop.
+            //!
+            Program(const uint8_t* data, size_t size) : _data(size >= ENTRY_SIZE ? data : nullptr) {}
+
+            //!
+            //! Get the size of the entry.
+            //! @return The size in bytes of the entry or zero if it is truncated.
+            //!
+            size_t size() const { return _data == nullptr ? 0 : ENTRY_SIZE; }
+
+            //!
+            //! Get the program number.
+            //! @return The program number (aka. service id). Zero means the NIT PID.
+            //!
+            uint16_t programNumber() const { return _data == nullptr ? 0 : GetUInt16(_data); }
+
+            //!
+            //! Get the PID of the program.
+            //! @return The PMT PID of the program or the NIT PID when the program number is zero.
+            //!
+            PID pid() const { return _data == nullptr ? PID(PID_NULL) : PID(GetUInt16(_data + 2) & 0x1FFF); }
+
+        private:
+            static constexpr size_t ENTRY_SIZE = 4;
+            const uint8_t* _data;
+        };
+
+        //!
+        //! Read-only view over the program loop of a PAT section.
+        //!
+        using ProgramLoop = PSILoopView<Program>;
+
+        //!
+        //! Constructor from a section.
+        //! @param [in] section The section to view. The view is invalid if this is not a PAT section.
+        //!
+        PATView(const Section& section);
+
+        //!
+        //! Constructor from binary data.
+        //! @param [in] content Address of the complete binary section.
+        //! @param [in] size Size in bytes of the binary area.
+        //!
+        PATView(const uint8_t* content, size_t size);
+
+        //!
+        //! Get the transport stream id.
+        //! @return The transport stream id.
+        //!
+        uint16_t tsId() const { return tableIdExtension(); }
+
+        //!
+        //! Get a view over the program loop.
+        //! All entries are returned, including the NIT PID with program number zero.
+        //! @return A view over the program loop.
+        //!
+        ProgramLoop programs() const { return ProgramLoop(payload(), payloadSize()); }
+
+        //!
+        //! Get the NIT PID.
+        //! @return The NIT PID or PID_NULL if not specified in this section.
+        //!
+        PID nitPID() const { return pmtPID(0); }
+
+        //!
+        //! Get the PMT PID of a service.
+        //! @param [in] service_id The service id (aka. program number).
+        //! @return The PMT PID of the service or PID_NULL if not found in this section.
+        //!
+        PID pmtPID(uint16_t service_id) const;
+    };
+}
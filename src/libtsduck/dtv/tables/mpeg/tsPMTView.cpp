@@ -0,0 +1,61 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2024, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+
+#include "tsPMTView.h"
+
+
+//----------------------------------------------------------------------------
+// Constructors.
+//----------------------------------------------------------------------------
+
+ts::PMTView::PMTView(const Section& section) :
+    SectionView(section)
+{
+    validate(tableId() == TID_PMT && isLongSection(), 4);
+}
+
+ts::PMTView::PMTView(const uint8_t* content, size_t size) :
+    SectionView(content, size)
+{
+    validate(tableId() == TID_PMT && isLongSection(), 4);
+}
+
+ts::PMTView::Stream::Stream(const uint8_t* data, size_t size) :
+    _data(data),
+    _size(data != nullptr && size >= HEADER_SIZE && HEADER_SIZE + (GetUInt16(data + 3) & 0x0FFF) <= size ? HEADER_SIZE + (GetUInt16(data + 3) & 0x0FFF) : 0)
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Get a view over the elementary stream loop.
+//----------------------------------------------------------------------------
+
+ts::PMTView::StreamLoop ts::PMTView::streams() const
+{
+    // The stream loop starts after the program-level descriptor loop.
+    const DescriptorListView descs(descriptors());
+    if (descs.data() == nullptr) {
+        return StreamLoop();
+    }
+    else {
+        const uint8_t* const data = descs.data() + descs.size();
+        return StreamLoop(data, size_t(payload() + payloadSize() - data));
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Search an elementary stream by PID.
+//----------------------------------------------------------------------------
+
+ts::PMTView::StreamLoop::const_iterator ts::PMTView::findStream(PID pid) const
+{
+    const StreamLoop loop(streams());
+    return std::find_if(loop.begin(), loop.end(), [pid](const Stream& stream) { return stream.pid() == pid; });
+}
@@ -0,0 +1,123 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2024, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Read-only view over a binary section of a Program Map Table (PMT).
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsSectionView.h"
+
+namespace ts {
+    //!
+    //! Read-only view over a binary section of a Program Map Table (PMT).
+    //! @see ISO/IEC 13818-1, ITU-T Rec. H.222.0, 2.4.4.8
+    //! @ingroup table
+    //!
+    //! This is a lightweight alternative to ts::PMT to inspect a PMT section without
+    //! deserializing it. The descriptors are not copied, they are iterated as instances
+    //! of ts::DescriptorView.
+    //! @see ts::SectionView
+    //!
+    class TSDUCKDLL PMTView : public SectionView
+    {
+    public:
+        //!
+        //! Read-only view over one elementary stream in the stream loop.
+        //!
+        class TSDUCKDLL Stream
+        {
+        public:
+            //!
+            //! Constructor.
+            //! @param [in] data Address of the stream description.
+            //! @param [in] size Remaining size in bytes of the stream loop.
+            //!
+            Stream(const uint8_t* data, size_t size);
+
+            //!
+            //! Get the size of the stream description.
+            //! @return The size in bytes of the stream description or zero if it is truncated.
+            //!
+            size_t size() const { return _size; }
+
+            //!
+            //! Get the stream type.
+            //! @return The stream type.
+            //!
+            uint8_t streamType() const { return _size == 0 ? 0 : _data[0]; }
+
+            //!
+            //! Get the PID of the elementary stream.
+            //! @return The PID of the elementary stream.
+            //!
+            PID pid() const { return _size == 0 ? PID(PID_NULL) : PID(GetUInt16(_data + 1) & 0x1FFF); }
+
+            //!
+            //! Get a view over the descriptor loop of the elementary stream.
+            //! @return A view over the descriptor loop of the elementary stream.
+            //!
+            DescriptorListView descriptors() const { return _size == 0 ? DescriptorListView() : DescriptorListView(_data + HEADER_SIZE, _size - HEADER_SIZE); }
+
+        private:
+            static constexpr size_t HEADER_SIZE = 5;
+            const uint8_t* _data;
+            size_t         _size;
+        };
+
+        //!
+        //! Read-only view over the stream loop of a PMT section.
+        //!
+        using StreamLoop = PSILoopView<Stream>;
+
+        //!
+        //! Constructor from a section.
+        //! @param [in] section The section to view. The view is invalid if this is not a PMT section.
+        //!
+        PMTView(const Section& section);
+
+        //!
+        //! Constructor from binary data.
+        //! @param [in] content Address of the complete binary section.
+        //! @param [in] size Size in bytes of the binary area.
+        //!
+        PMTView(const uint8_t* content, size_t size);
+
+        //!
+        //! Get the service id.
+        //! @return The service id (aka. program number).
+        //!
+        uint16_t serviceId() const { return tableIdExtension(); }
+
+        //!
+        //! Get the PCR PID.
+        //! @return The PCR PID or PID_NULL if the view is invalid.
+        //!
+        PID pcrPID() const { return isValid() ? PID(GetUInt16(payload()) & 0x1FFF) : PID(PID_NULL); }
+
+        //!
+        //! Get a view over the program-level descriptor loop.
+        //! @return A view over the program-level descriptor loop.
+        //!
+        DescriptorListView descriptors() const { return descriptorLoop(2); }
+
+        //!
+        //! Get a view over the elementary stream loop.
+        //! @return A view over the elementary stream loop.
+        //!
+        StreamLoop streams() const;
+
+        //!
+        //! Search an elementary stream by PID.
+        //! @param [in] pid The PID to search.
+        //! @return An iterator to the stream with this PID or streams().end() if not found.
+        //!
+        StreamLoop::const_iterator findStream(PID pid) const;
+    };
+}
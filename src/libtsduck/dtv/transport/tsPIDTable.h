@@ -0,0 +1,300 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2024, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  A map-like container of objects indexed by PID with constant-time lookup.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsTS.h"
+
+namespace ts {
+    //!
+    //! A map-like container of objects indexed by PID with constant-time lookup.
+    //! @ingroup mpeg
+    //!
+    //! This class is a replacement for std::map<PID,T> in classes which look up
+    //! a per-PID context for each TS packet, such as demuxes and analyzers.
+    //!
+    //! Since PID values are bounded to 8192, the container uses a sparse index
+    //! of all possible PID values which points into a dense array of the active
+    //! PID's. The dense array is sorted by PID value.
+    //!
+    //! Differences with std::map<PID,T>:
+    //! - Lookups are done in constant time. Inserting or removing a PID is done
+    //!   in linear time of the number of active PID's. In the typical usage of
+    //!   a PID context table, lookups are done for each packet while insertions
+    //!   and removals are rare.
+    //! - Iterations are done over the dense array of active PID's, in increasing
+    //!   order of PID values, as with std::map.
+    //! - As with std::map, references and pointers to elements remain valid when
+    //!   other elements are inserted or removed. However, iterators are invalidated
+    //!   by insertions and removals.
+    //! - PID values must be less than PID_MAX.
+    //!
+    //! @tparam T The type of the objects which are associated to PID's.
+    //!
+    template <typename T>
+    class PIDTable
+    {
+    public:
+        using key_type = PID;                           //!< Type of keys, same as std::map.
+        using mapped_type = T;                          //!< Type of associated objects, same as std::map.
+        using value_type = std::pair<const PID, T>;     //!< Type of elements, same as std::map.
+        using size_type = size_t;                       //!< Type of sizes.
+
+    private:
+        // Each active element is individually allocated to keep references stable.
+        using ElementPtr = std::unique_ptr<value_type>;
+        using ElementArray = std::vector<ElementPtr>;
+
+        // Value in the sparse index for inactive PID's.
+        static constexpr uint16_t NO_INDEX = 0xFFFF;
+
+    public:
+        //!
+        //! Bidirectional iterator over the active PID's of a PIDTable.
+        //! @tparam CONST If true, this is a constant iterator.
+        //!
+        template <bool CONST>
+        class Iterator
+        {
+        public:
+            //! @cond nodoxygen
+            using iterator_category = std::bidirectional_iterator_tag;
+            using difference_type = std::ptrdiff_t;
+            using value_type = typename std::conditional<CONST, const typename PIDTable<T>::value_type, typename PIDTable<T>::value_type>::type;
+            using pointer = value_type*;
+            using reference = value_type&;
+            //! @endcond
+
+            //!
+            //! Default constructor.
+            //!
+            Iterator() = default;
+
+            //!
+            //! Conversion from a non-constant iterator to a constant one.
+            //! @param [in] other Other iterator to copy.
+            //!
+            template <bool C = CONST, typename std::enable_if<C>::type* = nullptr>
+            Iterator(const Iterator<false>& other) : _it(other._it) {}
+
+            //! @cond nodoxygen
+            reference operator*() const { return **_it; }
+            pointer operator->() const { return _it->get(); }
+            Iterator& operator++() { ++_it; return *this; }
+            Iterator& operator--() { --_it; return *this; }
+            Iterator operator++(int) { Iterator tmp(*this); ++_it; return tmp; }
+            Iterator operator--(int) { Iterator tmp(*this); --_it; return tmp; }
+            bool operator==(const Iterator& other) const { return _it == other._it; }
+            bool operator!=(const Iterator& other) const { return _it != other._it; }
+            //! @endcond
+
+        private:
+            friend class PIDTable<T>;
+            friend class Iterator<!CONST>;
+            typename ElementArray::const_iterator _it {};
+            explicit Iterator(typename ElementArray::const_iterator it) : _it(it) {}
+        };
+
+        using iterator = Iterator<false>;        //!< Iterator over the active PID's.
+        using const_iterator = Iterator<true>;   //!< Constant iterator over the active PID's.
+
+        //!
+        //! Default constructor.
+        //!
+        PIDTable() = default;
+
+        //!
+        //! Copy constructor.
+        //! @param [in] other Other instance to copy.
+        //!
+        PIDTable(const PIDTable& other) { *this = other; }
+
+        //!
+        //! Move constructor.
+        //! @param [in,out] other Other instance to move.
+        //!
+        PIDTable(PIDTable&& other) noexcept = default;
+
+        //!
+        //! Assignment operator.
+        //! @param [in] other Other instance to copy.
+        //! @return A reference to this object.
+        //!
+        PIDTable& operator=(const PIDTable& other);
+
+        //!
+        //! Move assignment operator.
+        //! @param [in,out] other Other instance to move.
+        //! @return A reference to this object.
+        //!
+        PIDTable& operator=(PIDTable&& other) noexcept = default;
+
+        //!
+        //! Get the number of active PID's.
+        //! @return The number of active PID's.
+        //!
+        size_type size() const { return _elements.size(); }
+
+        //!
+        //! Check if the table is empty.
+        //! @return True if the table is empty.
+        //!
+        bool empty() const { return _elements.empty(); }
+
+        //!
+        //! Remove all PID's.
+        //!
+        void clear();
+
+        //!
+        //! Check if a PID is present in the table.
+        //! @param [in] pid The PID to check.
+        //! @return True if @a pid is present in the table.
+        //!
+        bool contains(PID pid) const { return pid < _index.size() && _index[pid] != NO_INDEX; }
+
+        //!
+        //! Count the number of elements with a given PID.
+        //! @param [in] pid The PID to check.
+        //! @return The number of elements with PID @a pid, 0 or 1.
+        //!
+        size_type count(PID pid) const { return contains(pid) ? 1 : 0; }
+
+        //!
+        //! Find an element by PID.
+        //! @param [in] pid The PID to search.
+        //! @return An iterator to the element or end() if not found.
+        //!
+        iterator find(PID pid) { return iterator(contains(pid) ? _elements.cbegin() + _index[pid] : _elements.cend()); }
+
+        //!
+        //! Find an element by PID.
+        //! @param [in] pid The PID to search.
+        //! @return A constant iterator to the element or end() if not found.
+        //!
+        const_iterator find(PID pid) const { return const_iterator(contains(pid) ? _elements.cbegin() + _index[pid] : _elements.cend()); }
+
+        //!
+        //! Access the object which is associated to a PID.
+        //! The object is created with its default constructor if the PID is not yet present.
+        //! @param [in] pid The PID to access. Must be less than PID_MAX.
+        //! @return A reference to the object which is associated to @a pid.
+        //!
+        T& operator[](PID pid);
+
+        //!
+        //! Remove a PID from the table.
+        //! @param [in] pid The PID to remove.
+        //! @return The number of removed elements, 0 or 1.
+        //!
+        size_type erase(PID pid);
+
+        //!
+        //! Remove an element from the table.
+        //! @param [in] it An iterator to the element to remove.
+        //! @return An iterator to the element after the removed one.
+        //!
+        iterator erase(const_iterator it);
+
+        //! @cond nodoxygen
+        iterator begin() { return iterator(_elements.cbegin()); }
+        iterator end() { return iterator(_elements.cend()); }
+        const_iterator begin() const { return const_iterator(_elements.cbegin()); }
+        const_iterator end() const { return const_iterator(_elements.cend()); }
+        const_iterator cbegin() const { return const_iterator(_elements.cbegin()); }
+        const_iterator cend() const { return const_iterator(_elements.cend()); }
+        //! @endcond
+
+    private:
+        std::vector<uint16_t> _index {};    // Sparse index of all PID's into _elements, allocated on first insertion.
+        ElementArray          _elements {}; // Dense array of active PID's, sorted by PID value.
+
+        // Update the sparse index for all elements, starting at a given position.
+        void reindex(size_t start);
+    };
+}
+
+
+//----------------------------------------------------------------------------
+// Template definitions.
+//----------------------------------------------------------------------------
+
+template <typename T>
+ts::PIDTable<T>& ts::PIDTable<T>::operator=(const PIDTable& other)
+{
+    if (&other != this) {
+        clear();
+        _index = other._index;
+        _elements.reserve(other._elements.size());
+        for (const auto& e : other._elements) {
+            _elements.push_back(std::make_unique<value_type>(*e));
+        }
+    }
+    return *this;
+}
+
+template <typename T>
+void ts::PIDTable<T>::clear()
+{
+    // Keep the sparse index allocated, only reset the active entries.
+    for (const auto& e : _elements) {
+        _index[e->first] = NO_INDEX;
+    }
+    _elements.clear();
+}
+
+template <typename T>
+void ts::PIDTable<T>::reindex(size_t start)
+{
+    for (size_t i = start; i < _elements.size(); ++i) {
+        _index[_elements[i]->first] = uint16_t(i);
+    }
+}
+
+template <typename T>
+T& ts::PIDTable<T>::operator[](PID pid)
+{
+    assert(pid < PID_MAX);
+    if (_index.empty()) {
+        _index.resize(PID_MAX, NO_INDEX);
+    }
+    if (_index[pid] == NO_INDEX) {
+        // Insert a new element, keeping the dense array sorted by PID.
+        const auto pos = std::upper_bound(_elements.begin(), _elements.end(), pid, [](PID p, const ElementPtr& e) { return p < e->first; });
+        const size_t index = pos - _elements.begin();
+        _elements.insert(pos, std::make_unique<value_type>(std::piecewise_construct, std::forward_as_tuple(pid), std::forward_as_tuple()));
+        reindex(index);
+    }
+    return _elements[_index[pid]]->second;
+}
+
+template <typename T>
+typename ts::PIDTable<T>::size_type ts::PIDTable<T>::erase(PID pid)
+{
+    if (contains(pid)) {
+        erase(find(pid));
+        return 1;
+    }
+    else {
+        return 0;
+    }
+}
+
+template <typename T>
+typename ts::PIDTable<T>::iterator ts::PIDTable<T>::erase(const_iterator it)
+{
+    const size_t index = it._it - _elements.cbegin();
+    _index[(*it).first] = NO_INDEX;
+    _elements.erase(_elements.begin() + index);
+    reindex(index);
+    return iterator(_elements.cbegin() + index);
+}
@@ -251,6 +251,7 @@ bool ts::TSDatagramOutput::close(const BitRate& bitrate, Report& report)
             success = sendPackets(_out_buffer.data(), _out_count, bitrate, report);
             _out_count = 0;
         }
+        success = flushDatagrams(report) && success;
         if (_raw_udp) {
             _sock.close(report);
         }
@@ -307,6 +308,11 @@ bool ts::TSDatagramOutput::send(const TSPacket* pkt, size_t packet_count, const
         packet_count -= count;
     }
 
+    // Send all datagrams before reusing the output buffer.
+    if (!flushDatagrams(report)) {
+        return false;
+    }
+
     // If remaining packets are present, save them in output buffer.
     if (packet_count > 0) {
         assert(_enforce_burst);
@@ -338,7 +344,7 @@ bool ts::TSDatagramOutput::sendPackets(const TSPacket* pkt, size_t packet_count,
         // But never jump back in RTP timestamps, only increase "more slowly" when adjusting.
 
         // Build an RTP datagram. Use a simple RTP header without options nor extensions.
-        ByteBlock buffer(RTP_HEADER_SIZE + packet_count * PKT_RS_SIZE);
+        ByteBlock& buffer(datagramBuffer(RTP_HEADER_SIZE + packet_count * PKT_RS_SIZE));
 
         // Build the RTP header, except the timestamp.
         buffer[0] = 0x80;             // Version = 2, P = 0, X = 0, CC = 0
@@ -425,22 +431,22 @@ bool ts::TSDatagramOutput::sendPackets(const TSPacket* pkt, size_t packet_count,
             MemCopy(buf, pkt, packet_count * PKT_SIZE);
             buffer.resize(RTP_HEADER_SIZE + packet_count * PKT_SIZE);
         }
-        status = _output->sendDatagram(buffer.data(), buffer.size(), report);
+        status = outputDatagram(buffer.data(), buffer.size(), report);
     }
     else if (_rs204_format) {
-        // No RTP header, add TS trailer after each packet. Since the default initial value
-        // of the buffer vector is zero, there is no need to explicitly set the trailers.
-        ByteBlock buffer(packet_count * PKT_RS_SIZE);
+        // No RTP header, add TS trailer after each packet. Since the initial value
+        // of the buffer is zero, there is no need to explicitly set the trailers.
+        ByteBlock& buffer(datagramBuffer(packet_count * PKT_RS_SIZE));
         uint8_t* buf = buffer.data();
         for (size_t i = 0; i < packet_count; ++i) {
             MemCopy(buf, pkt++, PKT_SIZE);
             buf += PKT_SIZE + RS_SIZE;
         }
-        status = _output->sendDatagram(buffer.data(), buffer.size(), report);
+        status = outputDatagram(buffer.data(), buffer.size(), report);
     }
     else {
         // No RTP, send TS packets directly as datagram.
-        status = _output->sendDatagram(pkt, packet_count * PKT_SIZE, report);
+        status = outputDatagram(pkt, packet_count * PKT_SIZE, report);
     }
 
     // Count packets datagram per datagram.
@@ -450,6 +456,62 @@ bool ts::TSDatagramOutput::sendPackets(const TSPacket* pkt, size_t packet_count,
 }
 
 
+//----------------------------------------------------------------------------
+// Get a zeroed buffer to build a datagram.
+//----------------------------------------------------------------------------
+
+ts::ByteBlock& ts::TSDatagramOutput::datagramBuffer(size_t size)
+{
+    if (!_raw_udp) {
+        // The datagram is immediately sent by the handler, always use the same buffer.
+        _datagram.assign(size, 0);
+        return _datagram;
+    }
+    else {
+        // The datagram is queued, use a distinct buffer per queued datagram.
+        // The buffers are reused after flushDatagrams(), avoiding reallocations.
+        if (_batch_built >= _batch_buffers.size()) {
+            _batch_buffers.resize(_batch_built + 1);
+        }
+        ByteBlock& buffer(_batch_buffers[_batch_built++]);
+        buffer.assign(size, 0);
+        return buffer;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Send or queue a datagram.
+//----------------------------------------------------------------------------
+
+bool ts::TSDatagramOutput::outputDatagram(const void* address, size_t size, Report& report)
+{
+    if (!_raw_udp) {
+        // Datagrams are sent one by one by the output handler.
+        return _output->sendDatagram(address, size, report);
+    }
+    else {
+        // With raw UDP, send datagrams by groups, using one system call when possible.
+        _batch_data.push_back(address);
+        _batch_sizes.push_back(size);
+        return _batch_data.size() < UDPSocket::MAX_BATCH_MESSAGES || flushDatagrams(report);
+    }
+}
+
+bool ts::TSDatagramOutput::flushDatagrams(Report& report)
+{
+    bool status = true;
+    if (!_batch_data.empty()) {
+        assert(_batch_data.size() == _batch_sizes.size());
+        status = _sock.send(_batch_data.data(), _batch_sizes.data(), _batch_data.size(), report);
+        _batch_data.clear();
+        _batch_sizes.clear();
+    }
+    _batch_built = 0;
+    return status;
+}
+
+
 //----------------------------------------------------------------------------
 // Implementation of TSDatagramOutputHandlerInterface.
 // The object is its own handler in case of raw UDP output.
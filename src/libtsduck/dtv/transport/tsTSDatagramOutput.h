@@ -15,6 +15,7 @@
 #include "tsTSDatagramOutputHandlerInterface.h"
 #include "tsTSPacket.h"
 #include "tsUDPSocket.h"
+#include "tsByteBlock.h"
 #include "tsIPProtocols.h"
 #include "tsEnumUtils.h"
 
@@ -148,6 +149,11 @@ namespace ts {
         size_t            _out_count = 0;              // Number of packets in _out_buffer
         TSPacketVector    _out_buffer {};              // Buffered packets for output with --enforce-burst
         UDPSocket         _sock {};                    // Outgoing socket for raw UDP
+        ByteBlock         _datagram {};                // Datagram to build when not using raw UDP
+        std::vector<ByteBlock>   _batch_buffers {};    // Datagrams which are built for raw UDP
+        size_t                   _batch_built = 0;     // Number of used buffers in _batch_buffers
+        std::vector<const void*> _batch_data {};       // Datagrams to send on raw UDP socket at once
+        std::vector<size_t>      _batch_sizes {};      // Sizes of datagrams to send at once
 
         // Implementation of TSDatagramOutputHandlerInterface.
         // The object is its own handler in case of raw UDP output.
@@ -155,5 +161,15 @@ namespace ts {
 
         // Send contiguous packets in one single datagram.
         bool sendPackets(const TSPacket* packet, size_t count, const BitRate& bitrate, Report& report);
+
+        // Get a zeroed buffer to build a datagram of the specified size.
+        ByteBlock& datagramBuffer(size_t size);
+
+        // Send a datagram. With raw UDP, the datagram is queued and all queued datagrams are sent
+        // at once later. The content of the datagram shall remain valid until flushDatagrams().
+        bool outputDatagram(const void* address, size_t size, Report& report);
+
+        // Send all queued datagrams with raw UDP.
+        bool flushDatagrams(Report& report);
     };
 }
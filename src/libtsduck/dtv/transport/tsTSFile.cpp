@@ -51,6 +51,10 @@ ts::TSFile::TSFile(TSFile&& other) noexcept :
     _rewindable(other._rewindable),
     _regular(other._regular),
     _std_inout(other._std_inout),
+    _use_mmap(other._use_mmap),
+    _map(std::move(other._map)),
+    _map_pos(other._map_pos),
+    _read_buffer(std::move(other._read_buffer)),
 #if defined(TS_WINDOWS)
     _handle(other._handle)
 #else
@@ -59,6 +63,7 @@ ts::TSFile::TSFile(TSFile&& other) noexcept :
 {
     // Mark other object as closed, just in case.
     other._is_open = false;
+    other._map_pos = 0;
 #if defined(TS_WINDOWS)
     other._handle = INVALID_HANDLE_VALUE;
 #else
@@ -308,6 +313,7 @@ bool ts::TSFile::openInternal(bool reopen, Report& report)
 
     // Close first if this is a reopen.
     if (reopen) {
+        _map.close();
         ::close(_fd);
         _fd = -1;
     }
@@ -379,6 +385,9 @@ bool ts::TSFile::openInternal(bool reopen, Report& report)
         return false;
     }
 
+    // Map regular files in memory when requested.
+    mapFile(_start_offset, report);
+
 #endif
 
     // Reset counters only if not a reopen.
@@ -439,6 +448,25 @@ bool ts::TSFile::seekInternal(uint64_t index, Report& report)
 
     report.debug(u"seeking %s at offset %'d", _filename, _start_offset + index);
 
+    // Data which were read in advance during format auto-detection are now obsolete.
+    discardPendingInput();
+
+    // A memory-mapped file is "seeked" by moving the read position. When the end of the mapped
+    // content was previously reached, the file was unmapped: map it again with its current size.
+    if (!_map.isMapped()) {
+        mapFile(_start_offset + index, report);
+    }
+    if (_map.isMapped()) {
+        if (_start_offset + index <= _map.size()) {
+            _map_pos = size_t(_start_offset + index);
+            _at_eof = false;
+            return true;
+        }
+        // Beyond the mapped content (growing file), use I/O system calls.
+        _map.close();
+        _map_pos = 0;
+    }
+
 #if defined(TS_WINDOWS)
     // In Win32, LARGE_INTEGER is a 64-bit structure, not an integer type
     uint64_t where = _start_offset + index;
@@ -493,6 +521,8 @@ bool ts::TSFile::close(Report& report)
         writeStuffing(_close_null, report);
     }
 
+    _map.close();
+
     if (!_std_inout) {
 #if defined(TS_WINDOWS)
         ::CloseHandle(_handle);
@@ -538,6 +568,20 @@ bool ts::TSFile::readStreamPartial(void* buffer, size_t request_size, size_t& re
         return true;
     }
 
+    // Memory-mapped file, copy data from memory. At the end of the mapped content, the file
+    // may have grown since it was mapped: continue with I/O system calls after the mapped content.
+    if (_map.isMapped() && !_aborted) {
+        read_size = std::min(request_size, _map.size() - _map_pos);
+        if (read_size > 0) {
+            MemCopy(buffer, _map.data() + _map_pos, read_size);
+            _map_pos += read_size;
+            return true;
+        }
+        if (!unmapFile(report)) {
+            return false;
+        }
+    }
+
 #if defined(TS_WINDOWS)
 
     // Windows implementation
@@ -648,6 +692,62 @@ size_t ts::TSFile::readPackets(TSPacket* buffer, TSPacketMetadata* metadata, siz
 }
 
 
+//----------------------------------------------------------------------------
+// Read TS packets in place, without copy when possible.
+//----------------------------------------------------------------------------
+
+size_t ts::TSFile::readPacketsInPlace(const TSPacket*& packets, size_t max_packets, Report& report)
+{
+    // Zero-copy when the file is mapped in memory with plain TS packets. Artificial stuffing,
+    // initial format auto-detection and end of file are processed by readPackets().
+    if (_map.isMapped() && _open_null_read == 0 && !_at_eof && !_aborted && packetFormat() == TSPacketFormat::TS && !hasPendingInput()) {
+        const size_t count = std::min(max_packets, (_map.size() - _map_pos) / PKT_SIZE);
+        if (count > 0) {
+            packets = reinterpret_cast<const TSPacket*>(_map.data() + _map_pos);
+            _map_pos += count * PKT_SIZE;
+            _total_read += count;
+            return count;
+        }
+    }
+
+    // Otherwise, read packets in the internal buffer.
+    if (_read_buffer.size() < max_packets) {
+        _read_buffer.resize(max_packets);
+    }
+    packets = _read_buffer.data();
+    return readPackets(_read_buffer.data(), nullptr, max_packets, report);
+}
+
+
+//----------------------------------------------------------------------------
+// Map or unmap the input file in memory.
+//----------------------------------------------------------------------------
+
+void ts::TSFile::mapFile(uint64_t position, Report& report)
+{
+    // Only regular files which are open for read only can be mapped.
+    if (_use_mmap && (_flags & (READ | WRITE)) == READ && _regular && !_std_inout && !_aborted && _map.open(_filename, NULLREP, false)) {
+        _map_pos = size_t(std::min<uint64_t>(position, _map.size()));
+        report.debug(u"mapped %s in memory, %'d bytes", getDisplayFileName(), _map.size());
+    }
+}
+
+bool ts::TSFile::unmapFile(Report& report)
+{
+    // Continue with I/O system calls after the mapped content.
+    const uint64_t position = _map.size();
+    _map.close();
+    _map_pos = 0;
+#if !defined(TS_WINDOWS)
+    if (_fd < 0 || ::lseek(_fd, off_t(position), SEEK_SET) == off_t(-1)) {
+        report.log(_severity, u"error seeking file %s: %s", getDisplayFileName(), SysErrorCodeMessage());
+        return false;
+    }
+#endif
+    return true;
+}
+
+
 //----------------------------------------------------------------------------
 // Implementation of AbstractWriteStreamInterface
 //----------------------------------------------------------------------------
@@ -757,7 +857,8 @@ void ts::TSFile::abort()
         _aborted = true;
         _at_eof = true;
 
-        // Close pipe handle, ignore errors.
+        // Close pipe handle, ignore errors. A memory-mapped file remains mapped
+        // until close() since another thread may be reading from it.
 #if defined(TS_WINDOWS)
         ::CloseHandle(_handle);
         _handle = INVALID_HANDLE_VALUE;
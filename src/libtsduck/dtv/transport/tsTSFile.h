@@ -15,6 +15,7 @@
 #include "tsTSPacketStream.h"
 #include "tsAbstractReadStreamInterface.h"
 #include "tsAbstractWriteStreamInterface.h"
+#include "tsMemoryMappedFile.h"
 #include "tsEnumUtils.h"
 
 namespace ts {
@@ -151,6 +152,27 @@ namespace ts {
         //!
         void setStuffing(size_t initial, size_t final);
 
+        //!
+        //! Use memory mapping to read the file.
+        //! This method shall be called before opening the file.
+        //! When a regular file is opened for read only, it is mapped in memory instead of being
+        //! read using I/O system calls. Packets are copied from the mapped memory by readPackets()
+        //! or accessed in place by readPacketsInPlace(). Memory mapping is currently implemented
+        //! on UNIX systems only. When the file cannot be mapped, it is read using I/O system calls.
+        //! After the end of the mapped content, the file is read using I/O system calls: data which
+        //! were appended to a growing file after opening it are read as usual. The file must not be
+        //! truncated while it is mapped, see MemoryMappedFile.
+        //! @param [in] on True to use memory mapping when possible.
+        //!
+        void setMemoryMapping(bool on) { _use_mmap = on; }
+
+        //!
+        //! Check if the file is currently mapped in memory.
+        //! @return True if the file is currently mapped in memory.
+        //! @see setMemoryMapping()
+        //!
+        bool isMemoryMapped() const { return _map.isMapped(); }
+
         //!
         //! Abort any currenly read/write operation in progress.
         //! The file is left in a broken state and can be only closed.
@@ -180,6 +202,20 @@ namespace ts {
         // Override TSPacketStream implementation
         virtual size_t readPackets(TSPacket* buffer, TSPacketMetadata* metadata, size_t max_packets, Report& report) override;
 
+        //!
+        //! Read TS packets in place, without copy when possible.
+        //! When the file is mapped in memory and contains plain 188-byte TS packets, the returned
+        //! packets are directly located in the mapped memory. Otherwise, the packets are read in
+        //! an internal buffer of the TSFile object.
+        //! @param [out] packets Address of the first returned packet. The packets remain valid
+        //! until the next read, seek or close operation on the file.
+        //! @param [in] max_packets Maximum number of packets to return.
+        //! @param [in,out] report Where to report errors.
+        //! @return The number of returned packets. Zero on end of file or error.
+        //! @see setMemoryMapping()
+        //!
+        size_t readPacketsInPlace(const TSPacket*& packets, size_t max_packets, Report& report);
+
     private:
         fs::path      _filename {};          //!< Input file name.
         size_t        _repeat = 0;           //!< Repeat count (0 means infinite)
@@ -197,6 +233,10 @@ namespace ts {
         bool          _rewindable = false;   //!< Opened in rewindable mode
         bool          _regular = false;      //!< Is a regular file (ie. not a pipe or special device)
         bool          _std_inout = false;    //!< File is standard input or output.
+        bool          _use_mmap = false;     //!< Use memory mapping to read the file, when possible.
+        MemoryMappedFile _map {};            //!< Content of the file in memory, when mapped.
+        size_t        _map_pos = 0;          //!< Current read position in the file, when mapped.
+        TSPacketVector _read_buffer {};      //!< Internal buffer for readPacketsInPlace() when the file is not mapped.
 #if defined(TS_WINDOWS)
         ::HANDLE      _handle = INVALID_HANDLE_VALUE;
 #else
@@ -218,6 +258,8 @@ namespace ts {
         bool openInternal(bool reopen, Report& report);
         bool seekCheck(Report& report);
         bool seekInternal(uint64_t index, Report& report);
+        void mapFile(uint64_t position, Report& report);
+        bool unmapFile(Report& report);
 
         // Inaccessible operations. Same as TS_NOCOPY() except that we keep the move constructor (required for vectors).
         TSFile(const TSFile&) = delete;
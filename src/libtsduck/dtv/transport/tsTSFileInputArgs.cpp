@@ -70,6 +70,13 @@ void ts::TSFileInputArgs::defineArgs(Args& args)
               u"For a given file, if the computed label is above the maximum (" +
               UString::Decimal(TSPacketLabelSet::MAX) + u"), its packets are not labelled.");
 
+    args.option(u"memory-map");
+    args.help(u"memory-map",
+              u"Map regular input files in memory instead of using read operations. "
+              u"This may reduce the system overhead on very large files. "
+              u"Other types of input files, such as pipes, are read as usual. "
+              u"This option is ignored on Windows.");
+
     args.option(u"packet-offset", 'p', Args::UNSIGNED);
     args.help(u"packet-offset",
               u"Start reading each file at the specified TS packet (default: 0). "
@@ -93,6 +100,7 @@ bool ts::TSFileInputArgs::loadArgs(DuckContext& duck, Args& args)
     _start_offset = args.intValue<uint64_t>(u"byte-offset", args.intValue<uint64_t>(u"packet-offset", 0) * PKT_SIZE);
     _interleave = args.present(u"interleave");
     _first_terminate = args.present(u"first-terminate");
+    _memory_map = args.present(u"memory-map");
     args.getIntValue(_interleave_chunk, u"interleave", 1);
     args.getIntValue(_base_label, u"label-base", TSPacketLabelSet::MAX + 1);
     args.getIntValues(_start_stuffing, u"add-start-stuffing");
@@ -146,6 +154,7 @@ bool ts::TSFileInputArgs::openFile(size_t name_index, size_t file_index, Report&
     _files[file_index].setStuffing(_start_stuffing[name_index], _stop_stuffing[name_index]);
 
     // Actually open the file.
+    _files[file_index].setMemoryMapping(_memory_map);
     return _files[file_index].openRead(name, _repeat_count, _start_offset, report, _file_format);
 }
 
@@ -86,6 +86,7 @@ namespace ts {
         bool                _first_terminate = false; // With _interleave, terminate when the first file terminates.
         size_t              _interleave_chunk = 0;    // Number of packets per chunk when _interleave.
         size_t              _interleave_remain = 0;   // Remaining packets to read in current chunk of current file.
+        bool                _memory_map = false;      // Map regular files in memory.
         size_t              _current_filename = 0;    // Current file index in _filenames.
         size_t              _current_file = 0;        // Current file index in _files. Depends on _interleave.
         size_t              _repeat_count = 1;
@@ -21,6 +21,17 @@ ts::TSFileOutputArgs::TSFileOutputArgs(bool allow_stdout) :
 {
 }
 
+ts::TSFileOutputArgs::~TSFileOutputArgs()
+{
+    // Without close(), the report which was passed to open() may no longer exist.
+    // The writer thread completes the pending requests without reporting.
+    if (_async_report != nullptr) {
+        _async_report = &NULLREP;
+    }
+    stopWriter();
+    waitForTermination();
+}
+
 
 //----------------------------------------------------------------------------
 // Add command line option definitions in an Args.
@@ -92,6 +103,16 @@ void ts::TSFileOutputArgs::defineArgs(Args& args)
               u"Then, the integer part is incremented. "
               u"Example: if the specified file name is foo-027.ts, the various files are named foo-027.ts, foo-028.ts, etc.\n\n"
               u"The options --max-duration and --max-size are mutually exclusive.");
+
+    args.option(u"write-behind", 0, Args::INTEGER, 0, 1, 1, Args::UNLIMITED_VALUE, true);
+    args.help(u"write-behind", u"count",
+              u"Write the packets to the file in a separate thread. "
+              u"Packets are queued and written later, asynchronously, so that a temporary slow disk "
+              u"does not block the processing of the stream. "
+              u"The optional value is the maximum number of pending write requests in the queue. "
+              u"When the queue is full, the processing is blocked until the disk catches up. "
+              u"The default queue size is " + UString::Decimal(DEFAULT_WRITE_BEHIND) + u". "
+              u"The number and duration of such blocking situations are reported in verbose mode.");
 }
 
 
@@ -110,6 +131,7 @@ bool ts::TSFileOutputArgs::loadArgs(DuckContext& duck, Args& args)
     args.getIntValue(_max_files, u"max-files", 0);
     args.getIntValue(_max_size, u"max-size", 0);
     args.getChronoValue(_max_duration, u"max-duration", 0);
+    args.getIntValue(_write_behind, u"write-behind", args.present(u"write-behind") ? DEFAULT_WRITE_BEHIND : 0);
     _file_format = LoadTSPacketFormatOutputOption(args);
     _multiple_files = _max_size > 0 || _max_duration > cn::seconds::zero();
 
@@ -153,7 +175,27 @@ bool ts::TSFileOutputArgs::open(Report& report, AbortInterface* abort)
     _current_files.clear();
     _file.setStuffing(_start_stuffing, _stop_stuffing);
     size_t retry_allowed = _retry_max == 0 ? std::numeric_limits<size_t>::max() : _retry_max;
-    return openAndRetry(false, retry_allowed, report, abort);
+    if (!openAndRetry(false, retry_allowed, report, abort)) {
+        return false;
+    }
+
+    // Start the writer thread with --write-behind.
+    if (_write_behind > 0) {
+        _write_queue.clear();
+        _write_queue.setMaxMessages(_write_behind);
+        _async_report = &report;
+        _async_abort = abort;
+        _async_error = false;
+        _async_packets = 0;
+        _stall_count = 0;
+        _stall_duration = _stall_max = cn::microseconds::zero();
+        if (!start()) {
+            report.error(u"cannot start output writer thread");
+            closeAndCleanup(report);
+            return false;
+        }
+    }
+    return true;
 }
 
 
@@ -163,7 +205,28 @@ bool ts::TSFileOutputArgs::open(Report& report, AbortInterface* abort)
 
 bool ts::TSFileOutputArgs::close(Report& report)
 {
-    return closeAndCleanup(report);
+    // With --write-behind, flush all pending packets first.
+    stopWriter();
+    const bool ok = closeAndCleanup(report);
+    return ok && !(_write_behind > 0 && _async_error);
+}
+
+
+//----------------------------------------------------------------------------
+// Terminate the writer thread, if started.
+//----------------------------------------------------------------------------
+
+void ts::TSFileOutputArgs::stopWriter()
+{
+    if (_async_report != nullptr) {
+        // An empty request tells the writer thread to terminate, after all pending requests.
+        _write_queue.forceEnqueue(new WriteRequest);
+        waitForTermination();
+        _async_report.load()->verbose(u"output writer: %'d packets written, %'d stalls, total stall time: %s, longest stall: %s",
+                               _async_packets, _stall_count, UString::Chrono(_stall_duration, true), UString::Chrono(_stall_max, true));
+        _async_report = nullptr;
+        _async_abort = nullptr;
+    }
 }
 
 
@@ -261,6 +324,72 @@ bool ts::TSFileOutputArgs::closeAndCleanup(Report& report)
 //----------------------------------------------------------------------------
 
 bool ts::TSFileOutputArgs::write(const TSPacket* buffer, const TSPacketMetadata* pkt_data, size_t packet_count, Report& report, AbortInterface* abort)
+{
+    // Synchronous write without --write-behind.
+    if (_async_report == nullptr) {
+        return writeSync(buffer, pkt_data, packet_count, report, abort);
+    }
+
+    // Once the writer thread failed, all subsequent write operations fail.
+    if (_async_error) {
+        return false;
+    }
+    if (packet_count == 0) {
+        return true;
+    }
+
+    // Copy the packets in a write request.
+    WriteQueue::MessagePtr req(new WriteRequest);
+    req->packets.assign(buffer, buffer + packet_count);
+    if (pkt_data != nullptr) {
+        req->mdata.assign(pkt_data, pkt_data + packet_count);
+    }
+
+    // Try to enqueue without waiting. If the queue is full, the disk is stalled, wait and measure.
+    if (!_write_queue.enqueue(req, cn::milliseconds::zero())) {
+        const auto start = monotonic_time::clock::now();
+        _write_queue.enqueue(req);
+        const auto duration = cn::duration_cast<cn::microseconds>(monotonic_time::clock::now() - start);
+        _stall_count++;
+        _stall_duration += duration;
+        _stall_max = std::max(_stall_max, duration);
+        report.debug(u"output writer stalled for %s", UString::Chrono(duration, true));
+    }
+    return !_async_error;
+}
+
+
+//----------------------------------------------------------------------------
+// Writer thread, with --write-behind.
+//----------------------------------------------------------------------------
+
+void ts::TSFileOutputArgs::main()
+{
+    WriteQueue::MessagePtr req;
+    for (;;) {
+        _write_queue.dequeue(req);
+        if (req->packets.empty()) {
+            // End of output.
+            break;
+        }
+        // After an error, keep dequeueing requests to never block the producer.
+        if (!_async_error) {
+            if (writeSync(req->packets.data(), req->mdata.empty() ? nullptr : req->mdata.data(), req->packets.size(), *_async_report.load(), _async_abort)) {
+                _async_packets += req->packets.size();
+            }
+            else {
+                _async_error = true;
+            }
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Synchronous write of packets.
+//----------------------------------------------------------------------------
+
+bool ts::TSFileOutputArgs::writeSync(const TSPacket* buffer, const TSPacketMetadata* pkt_data, size_t packet_count, Report& report, AbortInterface* abort)
 {
     // Total number of retries.
     size_t retry_allowed = _retry_max == 0 ? std::numeric_limits<size_t>::max() : _retry_max;
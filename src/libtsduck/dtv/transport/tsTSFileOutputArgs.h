@@ -18,6 +18,8 @@
 #include "tsFileNameGenerator.h"
 #include "tsDuckContext.h"
 #include "tsAbortInterface.h"
+#include "tsMessageQueue.h"
+#include "tsThread.h"
 #include "tsArgs.h"
 
 namespace ts {
@@ -25,7 +27,12 @@ namespace ts {
     //! Transport stream file output with command-line arguments.
     //! @ingroup mpeg
     //!
-    class TSDUCKDLL TSFileOutputArgs
+    //! With option --write-behind, the packets are written to the file in a separate
+    //! thread. The write() method only copies the packets in a bounded queue and returns
+    //! immediately. The caller is blocked only when the queue is full, typically when the
+    //! disk stalls for a longer time than the queue can absorb.
+    //!
+    class TSDUCKDLL TSFileOutputArgs: private Thread
     {
         TS_NOBUILD_NOCOPY(TSFileOutputArgs);
     public:
@@ -35,6 +42,11 @@ namespace ts {
         //!
         TSFileOutputArgs(bool allow_stdout);
 
+        //!
+        //! Destructor.
+        //!
+        virtual ~TSFileOutputArgs() override;
+
         //!
         //! Add command line option definitions in an Args.
         //! @param [in,out] args Command line arguments to update.
@@ -83,6 +95,11 @@ namespace ts {
         //!
         static constexpr cn::milliseconds DEFAULT_RETRY_INTERVAL = cn::milliseconds(2000);
 
+        //!
+        //! Default maximum number of pending write requests with --write-behind.
+        //!
+        static constexpr size_t DEFAULT_WRITE_BEHIND = 64;
+
     private:
         // Command line options:
         const bool        _allow_stdout;
@@ -98,6 +115,7 @@ namespace ts {
         cn::seconds       _max_duration {0};
         size_t            _max_files = 0;
         bool              _multiple_files = false;
+        size_t            _write_behind = 0;      // Max number of queued write requests, zero means synchronous write.
 
         // Working data:
         TSFile            _file {};
@@ -106,6 +124,34 @@ namespace ts {
         Time              _next_open_time {};
         UStringList       _current_files {};
 
+        // Write requests which are passed to the writer thread with --write-behind.
+        // An empty request means end of output.
+        struct WriteRequest
+        {
+            TSPacketVector         packets {};
+            TSPacketMetadataVector mdata {};
+        };
+        using WriteQueue = MessageQueue<WriteRequest>;
+
+        // Working data for the writer thread.
+        WriteQueue           _write_queue {};
+        std::atomic<Report*> _async_report {nullptr};  // Where to report errors in the writer thread.
+        AbortInterface*      _async_abort = nullptr;   // Abort interface for the writer thread.
+        std::atomic_bool     _async_error {false};    // The writer thread encountered an error.
+        PacketCounter        _async_packets = 0;       // Number of packets which were written asynchronously.
+        size_t               _stall_count = 0;         // Number of write() calls which were blocked by a full queue.
+        cn::microseconds     _stall_duration {0};      // Total time during which write() was blocked.
+        cn::microseconds     _stall_max {0};           // Longest time during which write() was blocked.
+
+        // Implementation of Thread, the writer thread.
+        virtual void main() override;
+
+        // Terminate the writer thread, if started.
+        void stopWriter();
+
+        // Synchronous write of packets, with reopen and file rotation.
+        bool writeSync(const TSPacket* buffer, const TSPacketMetadata* pkt_data, size_t packet_count, Report& report, AbortInterface* abort);
+
         // Open the file, retry on error if necessary.
         // Use max number of retries. Updated with remaining number of retries.
         bool openAndRetry(bool initial_wait, size_t& retry_allowed, Report& report, AbortInterface* abort);
@@ -0,0 +1,223 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2024, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+
+#include "tsTSPacketHeaders.h"
+#include "tsSysInfo.h"
+
+// Select the SIMD implementation, if any. On Intel, AVX2 is not part of the
+// base x86_64 instruction set. Only the scanning function is compiled for AVX2
+// and it is called only when the CPU supports it. Advanced SIMD is always
+// available on Arm64.
+#if defined(TS_NO_SIMD_INSTRUCTIONS)
+    // Disabled at compile time.
+#elif defined(TS_X86_64) && (defined(TS_GCC) || defined(TS_LLVM))
+    #define TS_SIMD_AVX2 1
+    #include <immintrin.h>
+#elif defined(TS_ARM64) && defined(TS_LITTLE_ENDIAN) && defined(__ARM_NEON)
+    #define TS_SIMD_NEON 1
+    #include <arm_neon.h>
+#endif
+
+// Runtime check once if SIMD instructions are supported on this CPU.
+volatile bool ts::TSPacketHeaders::_accel_checked = false;
+volatile bool ts::TSPacketHeaders::_accel_supported = false;
+
+
+//----------------------------------------------------------------------------
+// Constructor.
+//----------------------------------------------------------------------------
+
+ts::TSPacketHeaders::TSPacketHeaders(size_t capacity)
+{
+    _pids.reserve(capacity);
+    _ccs.reserve(capacity);
+    _flags.reserve(capacity);
+}
+
+
+//----------------------------------------------------------------------------
+// Check if the SIMD implementation is used on this system.
+//----------------------------------------------------------------------------
+
+bool ts::TSPacketHeaders::IsAccelerated()
+{
+    // This logic does not require explicit synchronization.
+    if (!_accel_checked) {
+#if defined(TS_SIMD_AVX2) || defined(TS_SIMD_NEON)
+        _accel_supported = SysInfo::Instance().simdInstructions();
+#endif
+        _accel_checked = true;
+    }
+    return _accel_supported;
+}
+
+
+//----------------------------------------------------------------------------
+// Clear the content of this object.
+//----------------------------------------------------------------------------
+
+void ts::TSPacketHeaders::clear()
+{
+    _size = 0;
+    _bad_sync = 0;
+    _pids.clear();
+    _ccs.clear();
+    _flags.clear();
+}
+
+
+//----------------------------------------------------------------------------
+// Decode the headers of a contiguous array of TS packets.
+//----------------------------------------------------------------------------
+
+void ts::TSPacketHeaders::scan(const TSPacket* packets, size_t count)
+{
+    _size = count;
+    _pids.resize(count);
+    _ccs.resize(count);
+    _flags.resize(count);
+
+    size_t done = 0;
+    if (IsAccelerated()) {
+        done = ScanAccel(packets, count, _pids.data(), _ccs.data(), _flags.data());
+    }
+    ScanGeneric(packets + done, count - done, _pids.data() + done, _ccs.data() + done, _flags.data() + done);
+
+    // Count invalid packets. Almost always zero, the loop is trivially vectorized by the compiler.
+    size_t bad = 0;
+    for (size_t i = 0; i < count; ++i) {
+        bad += (_flags[i] & BAD_SYNC) >> 4;
+    }
+    _bad_sync = bad;
+}
+
+
+//----------------------------------------------------------------------------
+// Portable implementation, one packet at a time.
+//----------------------------------------------------------------------------
+
+void ts::TSPacketHeaders::ScanGeneric(const TSPacket* packets, size_t count, PID* pids, uint8_t* ccs, uint8_t* flags)
+{
+    for (size_t i = 0; i < count; ++i) {
+        const uint8_t* b = packets[i].b;
+        pids[i] = PID((uint16_t(b[1] & 0x1F) << 8) | b[2]);
+        ccs[i] = b[3] & 0x0F;
+        flags[i] = Flags(packets[i]);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// AVX2 implementation, 8 packets at a time.
+//----------------------------------------------------------------------------
+
+#if defined(TS_SIMD_AVX2)
+
+__attribute__((target("avx2")))
+size_t ts::TSPacketHeaders::ScanAccel(const TSPacket* packets, size_t count, PID* pids, uint8_t* ccs, uint8_t* flags)
+{
+    constexpr int S = int(PKT_SIZE);
+    const __m256i offsets = _mm256_setr_epi32(0, S, 2 * S, 3 * S, 4 * S, 5 * S, 6 * S, 7 * S);
+    const __m256i byte_mask = _mm256_set1_epi32(0xFF);
+    const __m256i sync = _mm256_set1_epi32(SYNC_BYTE);
+    const __m256i bad_sync = _mm256_set1_epi32(BAD_SYNC);
+    const __m256i pid_high = _mm256_set1_epi32(0x1F00);
+    const __m256i flags_high = _mm256_set1_epi32(0xE0);
+    const __m256i cc_mask = _mm256_set1_epi32(0x0F);
+    // Move 32-bit elements #0, #4 (continuity counters) and #1, #5 (flags) in the low 128 bits.
+    const __m256i narrow = _mm256_setr_epi32(0, 4, 1, 5, 2, 3, 6, 7);
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        // Load the 4-byte headers of 8 packets. In each 32-bit element: b0 | b1 << 8 | b2 << 16 | b3 << 24.
+        const __m256i hdr = _mm256_i32gather_epi32(reinterpret_cast<const int*>(packets[i].b), offsets, 1);
+        const __m256i b1 = _mm256_and_si256(_mm256_srli_epi32(hdr, 8), byte_mask);
+        const __m256i b3 = _mm256_srli_epi32(hdr, 24);
+
+        // PID = (b1 & 0x1F) << 8 | b2
+        const __m256i pid = _mm256_or_si256(_mm256_and_si256(_mm256_slli_epi32(b1, 8), pid_high),
+                                            _mm256_and_si256(_mm256_srli_epi32(hdr, 16), byte_mask));
+        // CC = b3 & 0x0F
+        const __m256i cc = _mm256_and_si256(b3, cc_mask);
+        // Flags = (b1 & 0xE0) | (b0 != 0x47 ? BAD_SYNC : 0) | b3 >> 4
+        const __m256i valid = _mm256_cmpeq_epi32(_mm256_and_si256(hdr, byte_mask), sync);
+        const __m256i fl = _mm256_or_si256(_mm256_or_si256(_mm256_and_si256(b1, flags_high), _mm256_srli_epi32(b3, 4)),
+                                           _mm256_andnot_si256(valid, bad_sync));
+
+        // Narrow PID's to 16 bits. Packing operates inside each 128-bit lane.
+        const __m256i pid16 = _mm256_permute4x64_epi64(_mm256_packus_epi32(pid, pid), 0x08);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pids + i), _mm256_castsi256_si128(pid16));
+
+        // Narrow CC and flags to 8 bits.
+        const __m256i ccfl16 = _mm256_packus_epi32(cc, fl);
+        const __m256i ccfl8 = _mm256_permutevar8x32_epi32(_mm256_packus_epi16(ccfl16, ccfl16), narrow);
+        const __m128i low = _mm256_castsi256_si128(ccfl8);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(ccs + i), low);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(flags + i), _mm_unpackhi_epi64(low, low));
+    }
+    return i;
+}
+
+
+//----------------------------------------------------------------------------
+// Arm64 Advanced SIMD implementation, 8 packets at a time.
+//----------------------------------------------------------------------------
+
+#elif defined(TS_SIMD_NEON)
+
+size_t ts::TSPacketHeaders::ScanAccel(const TSPacket* packets, size_t count, PID* pids, uint8_t* ccs, uint8_t* flags)
+{
+    const uint32x4_t byte_mask = vdupq_n_u32(0xFF);
+    const uint32x4_t sync = vdupq_n_u32(SYNC_BYTE);
+    const uint32x4_t bad_sync = vdupq_n_u32(BAD_SYNC);
+    const uint32x4_t pid_high = vdupq_n_u32(0x1F00);
+    const uint32x4_t flags_high = vdupq_n_u32(0xE0);
+    const uint32x4_t cc_mask = vdupq_n_u32(0x0F);
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        // There is no gather load, collect the 4-byte headers of 8 packets.
+        uint32_t words[8];
+        for (size_t k = 0; k < 8; ++k) {
+            std::memcpy(words + k, packets[i + k].b, 4);
+        }
+        uint16x4_t pid16[2];
+        uint16x4_t cc16[2];
+        uint16x4_t fl16[2];
+        for (size_t k = 0; k < 2; ++k) {
+            const uint32x4_t hdr = vld1q_u32(words + 4 * k);
+            const uint32x4_t b1 = vandq_u32(vshrq_n_u32(hdr, 8), byte_mask);
+            const uint32x4_t b3 = vshrq_n_u32(hdr, 24);
+            const uint32x4_t pid = vorrq_u32(vandq_u32(vshlq_n_u32(b1, 8), pid_high), vandq_u32(vshrq_n_u32(hdr, 16), byte_mask));
+            const uint32x4_t valid = vceqq_u32(vandq_u32(hdr, byte_mask), sync);
+            const uint32x4_t fl = vorrq_u32(vorrq_u32(vandq_u32(b1, flags_high), vshrq_n_u32(b3, 4)), vbicq_u32(bad_sync, valid));
+            pid16[k] = vmovn_u32(pid);
+            cc16[k] = vmovn_u32(vandq_u32(b3, cc_mask));
+            fl16[k] = vmovn_u32(fl);
+        }
+        vst1q_u16(pids + i, vcombine_u16(pid16[0], pid16[1]));
+        vst1_u8(ccs + i, vmovn_u16(vcombine_u16(cc16[0], cc16[1])));
+        vst1_u8(flags + i, vmovn_u16(vcombine_u16(fl16[0], fl16[1])));
+    }
+    return i;
+}
+
+
+//----------------------------------------------------------------------------
+// No SIMD implementation on this platform.
+//----------------------------------------------------------------------------
+
+#else
+
+size_t ts::TSPacketHeaders::ScanAccel(const TSPacket*, size_t, PID*, uint8_t*, uint8_t*)
+{
+    // Shall not be called.
+    return 0;
+}
+
+#endif
@@ -0,0 +1,160 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2024, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Decoded headers of a batch of TS packets.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsTSPacket.h"
+
+namespace ts {
+    //!
+    //! Decoded headers of a batch of TS packets, in "structure of arrays" form.
+    //! @ingroup mpeg
+    //!
+    //! The 4-byte headers of all packets in a contiguous array of TS packets are decoded
+    //! in one single pass into separate vectors of PID's, continuity counters and flags.
+    //! Loops which only need to check PID's or flags can then iterate over small dense
+    //! vectors, without touching the 188-byte packets.
+    //!
+    //! When the CPU supports it (AVX2 on Intel x86_64, Advanced SIMD on Arm64), the
+    //! headers of several packets are decoded at once using SIMD instructions. A portable
+    //! implementation is used otherwise. The SIMD implementation can be disabled at runtime
+    //! using the environment variable TS_NO_SIMD_INSTRUCTIONS.
+    //!
+    class TSDUCKDLL TSPacketHeaders
+    {
+    public:
+        //!
+        //! Flags from a packet header, as returned by flags().
+        //! Transport error indicator, PUSI and transport priority are at the same
+        //! bit position as in the second byte of the packet header.
+        //!
+        enum : uint8_t {
+            TEI         = 0x80,  //!< Transport error indicator.
+            PUSI        = 0x40,  //!< Payload unit start indicator.
+            PRIORITY    = 0x20,  //!< Transport priority.
+            BAD_SYNC    = 0x10,  //!< Invalid sync byte, this is not a valid packet.
+            SC_MASK     = 0x0C,  //!< Mask of the transport scrambling control.
+            SC_SHIFT    = 2,     //!< Shift of the transport scrambling control inside the flags.
+            HAS_AF      = 0x02,  //!< The packet has an adaptation field.
+            HAS_PAYLOAD = 0x01,  //!< The packet has a payload.
+        };
+
+        //!
+        //! Constructor.
+        //! @param [in] capacity Initial capacity in packets, to avoid reallocations.
+        //!
+        explicit TSPacketHeaders(size_t capacity = 0);
+
+        //!
+        //! Decode the headers of a contiguous array of TS packets.
+        //! The previous content of this object is replaced.
+        //! @param [in] packets Address of the first packet.
+        //! @param [in] count Number of packets.
+        //!
+        void scan(const TSPacket* packets, size_t count);
+
+        //!
+        //! Clear the content of this object.
+        //!
+        void clear();
+
+        //!
+        //! Get the number of decoded packet headers.
+        //! @return The number of decoded packet headers.
+        //!
+        size_t size() const { return _size; }
+
+        //!
+        //! Get the number of packets with an invalid sync byte in the last scan.
+        //! @return The number of packets with an invalid sync byte.
+        //!
+        size_t badSyncCount() const { return _bad_sync; }
+
+        //!
+        //! Get the PID of a packet.
+        //! @param [in] index Index of the packet in the last scan.
+        //! @return The PID of the packet.
+        //!
+        PID pid(size_t index) const { return _pids[index]; }
+
+        //!
+        //! Get the continuity counter of a packet.
+        //! @param [in] index Index of the packet in the last scan.
+        //! @return The continuity counter of the packet.
+        //!
+        uint8_t cc(size_t index) const { return _ccs[index]; }
+
+        //!
+        //! Get the flags of a packet.
+        //! @param [in] index Index of the packet in the last scan.
+        //! @return The flags of the packet, a combination of TEI, PUSI, etc.
+        //!
+        uint8_t flags(size_t index) const { return _flags[index]; }
+
+        //!
+        //! Get the transport scrambling control of a packet.
+        //! @param [in] index Index of the packet in the last scan.
+        //! @return The transport scrambling control of the packet.
+        //!
+        uint8_t scrambling(size_t index) const { return uint8_t((_flags[index] & SC_MASK) >> SC_SHIFT); }
+
+        //!
+        //! Get the address of the vector of PID's.
+        //! @return The address of the first PID. There are size() elements.
+        //!
+        const PID* pids() const { return _pids.data(); }
+
+        //!
+        //! Get the address of the vector of continuity counters.
+        //! @return The address of the first continuity counter. There are size() elements.
+        //!
+        const uint8_t* ccs() const { return _ccs.data(); }
+
+        //!
+        //! Get the address of the vector of flags.
+        //! @return The address of the first flags. There are size() elements.
+        //!
+        const uint8_t* flags() const { return _flags.data(); }
+
+        //!
+        //! Compute the flags of one packet, as they would be returned by flags().
+        //! @param [in] pkt A TS packet.
+        //! @return The flags of the packet.
+        //!
+        static uint8_t Flags(const TSPacket& pkt)
+        {
+            return uint8_t((pkt.b[1] & 0xE0) | (pkt.b[0] == SYNC_BYTE ? 0 : BAD_SYNC) | (pkt.b[3] >> 4));
+        }
+
+        //!
+        //! Check if the SIMD implementation is used on this system.
+        //! @return True if the SIMD implementation is used.
+        //!
+        static bool IsAccelerated();
+
+    private:
+        size_t               _size = 0;
+        size_t               _bad_sync = 0;
+        std::vector<PID>     _pids {};
+        std::vector<uint8_t> _ccs {};
+        std::vector<uint8_t> _flags {};
+
+        // Runtime check once if SIMD instructions are supported on this CPU.
+        static volatile bool _accel_checked;
+        static volatile bool _accel_supported;
+
+        // Decode headers of packets, return the number of decoded packets.
+        // The accelerated version may decode less than count packets, always a multiple of its vector size.
+        static void ScanGeneric(const TSPacket* packets, size_t count, PID* pids, uint8_t* ccs, uint8_t* flags);
+        static size_t ScanAccel(const TSPacket* packets, size_t count, PID* pids, uint8_t* ccs, uint8_t* flags);
+    };
+}
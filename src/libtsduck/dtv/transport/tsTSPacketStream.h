@@ -129,6 +129,19 @@ namespace ts {
         //!
         void resetPacketStream(TSPacketFormat format, AbstractReadStreamInterface* reader, AbstractWriteStreamInterface* writer);
 
+        //!
+        //! Check if some input data were read in advance from the reader and are not yet returned as packets.
+        //! This can happen after the auto-detection of the packet format.
+        //! @return True if some input data were read in advance.
+        //!
+        bool hasPendingInput() const { return _trail_size > 0; }
+
+        //!
+        //! Discard the input data which were read in advance from the reader.
+        //! Must be called when the reader is repositioned at the start of a packet.
+        //!
+        void discardPendingInput() { _trail_size = 0; }
+
         PacketCounter _total_read = 0;   //!< Total read packets.
         PacketCounter _total_write = 0;  //!< Total written packets.
 
@@ -35,6 +35,15 @@ ts::TSPControlCommand::TSPControlCommand(Report& report) :
 
     arg = command(u"list", u"List all running plugins", u"[options]", flags);
 
+    arg = command(u"profile", u"Display the execution profile of plugins", u"[options] [plugin-index]", flags | Args::NO_VERBOSE);
+    arg->setIntro(u"Display the execution profile of plugins in JSON format. "
+                  u"The tsp process must have been started with option --profile. "
+                  u"All time values are in nanoseconds.");
+    arg->option(u"", 0, Args::UNSIGNED, 0, 1);
+    arg->help(u"", u"Index of the plugin to display. By default, display all plugins.");
+    arg->option(u"reset", 'r');
+    arg->help(u"reset", u"Reset the execution profile of the plugins after displaying it.");
+
     arg = command(u"suspend", u"Suspend a plugin", u"[options] plugin-index", flags);
     arg->setIntro(u"Suspend a plugin. When a packet processing plugin is suspended, "
                   u"the TS packets are directly passed from the previous to the next plugin, "
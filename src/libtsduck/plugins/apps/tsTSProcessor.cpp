@@ -11,7 +11,10 @@
 #include "tstspOutputExecutor.h"
 #include "tstspProcessorExecutor.h"
 #include "tstspControlServer.h"
+#include "tsjsonObject.h"
+#include "tsjsonArray.h"
 #include "tsFatal.h"
+#include "tsSysInfo.h"
 
 
 //----------------------------------------------------------------------------
@@ -109,10 +112,32 @@ bool ts::TSProcessor::start(const TSProcessorArgs& args)
         // plugin has a hight priority to make room in the buffer, but not as
         // high as the input which must remain the top-most priority?
 
-        _input = new tsp::InputExecutor(_args, *this, _args.input, ThreadAttributes().setPriority(ts::ThreadAttributes::GetMaximumPriority()), _global_mutex, &_report);
+        // With --numa-node, all plugin threads run on the CPU's of the node which holds the buffer.
+        std::set<size_t> cpus;
+        if (_args.numa_node >= 0 && !SysInfo::Instance().getNUMANodeCPUs(cpus, size_t(_args.numa_node))) {
+            _report.warning(u"cannot get the list of CPU's in NUMA node %d", _args.numa_node);
+        }
+
+        // With --cpu-map, each plugin thread runs on one CPU. The plugin index is 0 for the input plugin.
+        // The options --plugin-cpu and --plugin-sched override the defaults of individual plugins.
+        const auto plugin_thread = [this, &cpus](size_t index, int priority) {
+            ThreadAttributes attr;
+            attr.setPriority(priority);
+            attr.setAffinity(_args.cpu_map.empty() ? cpus : std::set<size_t>({_args.cpu_map[index % _args.cpu_map.size()]}));
+            const auto it = _args.plugin_threads.find(index);
+            if (it != _args.plugin_threads.end()) {
+                if (!it->second.getAffinity().empty()) {
+                    attr.setAffinity(it->second.getAffinity());
+                }
+                attr.setSchedulingPolicy(it->second.getSchedulingPolicy(), it->second.getRealTimePriority());
+            }
+            return attr;
+        };
+
+        _input = new tsp::InputExecutor(_args, *this, _args.input, plugin_thread(0, ThreadAttributes::GetMaximumPriority()), _global_mutex, &_report);
         CheckNonNull(_input);
 
-        _output = new tsp::OutputExecutor(_args, *this, _args.output, ThreadAttributes().setPriority(ts::ThreadAttributes::GetHighPriority()), _global_mutex, &_report);
+        _output = new tsp::OutputExecutor(_args, *this, _args.output, plugin_thread(_args.plugins.size() + 1, ThreadAttributes::GetHighPriority()), _global_mutex, &_report);
         CheckNonNull(_output);
 
         _output->ringInsertAfter(_input);
@@ -121,7 +146,7 @@ bool ts::TSProcessor::start(const TSProcessorArgs& args)
         bool realtime = _args.realtime == Tristate::True || _input->isRealTime() || _output->isRealTime();
 
         for (size_t i = 0; i < _args.plugins.size(); ++i) {
-            tsp::PluginExecutor* p = new tsp::ProcessorExecutor(_args, *this, i, ThreadAttributes(), _global_mutex, &_report);
+            tsp::PluginExecutor* p = new tsp::ProcessorExecutor(_args, *this, i, plugin_thread(i + 1, ThreadAttributes::GetNormalPriority()), _global_mutex, &_report);
             CheckNonNull(p);
             p->ringInsertBefore(_output);
             realtime = realtime || p->isRealTime();
@@ -157,9 +182,15 @@ bool ts::TSProcessor::start(const TSProcessorArgs& args)
         } while ((proc = proc->ringNext<ts::tsp::PluginExecutor>()) != _input);
 
         // Allocate a memory-resident buffer of TS packets
-        _packet_buffer = new PacketBuffer(_args.ts_buffer_size / ts::PKT_SIZE);
+        _packet_buffer = new PacketBuffer(_args.ts_buffer_size / ts::PKT_SIZE, _args.lock_buffer, _args.huge_pages, _args.numa_node);
         CheckNonNull(_packet_buffer);
-        if (!_packet_buffer->isLocked()) {
+        if (_args.huge_pages && !_packet_buffer->isHugePages()) {
+            _report.verbose(u"tsp: no huge page available for the buffer, using transparent huge pages if enabled");
+        }
+        if (_args.numa_node >= 0 && !_packet_buffer->isNUMABound()) {
+            _report.warning(u"tsp: cannot allocate the buffer on NUMA node %d", _args.numa_node);
+        }
+        if (_args.lock_buffer && !_packet_buffer->isLocked()) {
             _report.debug(u"tsp: buffer failed to lock into physical memory (%d: %s), risk of real-time issue",
                           _packet_buffer->lockErrorCode().value(), _packet_buffer->lockErrorCode().message());
         }
@@ -167,7 +198,7 @@ bool ts::TSProcessor::start(const TSProcessorArgs& args)
 
         // Buffer for the packet metadata.
         // A packet and its metadata have the same index in their respective buffer.
-        _metadata_buffer = new PacketMetadataBuffer(_packet_buffer->count());
+        _metadata_buffer = new PacketMetadataBuffer(_packet_buffer->count(), _args.lock_buffer, _args.huge_pages, _args.numa_node);
         CheckNonNull(_metadata_buffer);
 
         // End of locked section.
@@ -183,6 +214,9 @@ bool ts::TSProcessor::start(const TSProcessorArgs& args)
         }
     }
 
+    // Select plugins to execute in the same thread, now that their processing mode is known.
+    fusePlugins();
+
     // Initialize packet buffer in the ring of executors.
     // Exit application in case of error.
     if (!_input->initAllBuffers(_packet_buffer, _metadata_buffer)) {
@@ -199,10 +233,15 @@ bool ts::TSProcessor::start(const TSProcessorArgs& args)
         return false;
     }
 
-    // Start all plugin executors threads.
+    // Start all plugin executors threads. Fused plugins are executed in the thread of a previous plugin.
+    // Exit application in case of error, typically when a real-time scheduling policy is not allowed.
     tsp::PluginExecutor* proc = _input;
     do {
-        proc->start();
+        if (!proc->isFused() && !proc->start()) {
+            _report.error(u"cannot start the thread of plugin %s, check --cpu-map, --plugin-cpu and --plugin-sched options", proc->pluginName());
+            cleanupInternal();
+            return false;
+        }
     } while ((proc = proc->ringNext<tsp::PluginExecutor>()) != _input);
 
     // Create a control server thread. Display but ignore errors (not a fatal error).
@@ -214,6 +253,97 @@ bool ts::TSProcessor::start(const TSProcessorArgs& args)
 }
 
 
+//----------------------------------------------------------------------------
+// Select plugins to execute in the same thread.
+//----------------------------------------------------------------------------
+
+void ts::TSProcessor::fusePlugins()
+{
+    if (_args.fuse_ranges.empty() && _args.fuse_profile.empty()) {
+        return;
+    }
+
+    // List of packet processors, in order. The ring ends with the output executor.
+    std::vector<tsp::ProcessorExecutor*> procs;
+    for (auto* proc = _input->ringNext<tsp::ProcessorExecutor>(); proc != nullptr; proc = proc->ringNext<tsp::ProcessorExecutor>()) {
+        procs.push_back(proc);
+    }
+
+    // For each packet processor, check if it shall be fused with its predecessor.
+    std::vector<bool> fused(procs.size(), false);
+
+    // Explicit ranges of plugins, from --fuse. The first packet processor has index 1.
+    for (const auto& range : _args.fuse_ranges) {
+        for (size_t i = range.first; i < range.second && i < procs.size(); ++i) {
+            fused[i] = true;
+        }
+    }
+
+    // Consecutive lightweight plugins, from a previous execution profile.
+    std::vector<double> costs;
+    if (!_args.fuse_profile.empty() && loadPluginCosts(costs, procs)) {
+        const double threshold = double(_args.fuse_threshold.count());
+        for (size_t i = 1; i < procs.size(); ++i) {
+            fused[i] = fused[i] || (costs[i - 1] >= 0.0 && costs[i - 1] <= threshold && costs[i] >= 0.0 && costs[i] <= threshold);
+        }
+    }
+
+    // Build the groups, excluding plugins which cannot be fused.
+    tsp::ProcessorExecutor* leader = nullptr;
+    for (size_t i = 1; i < procs.size(); ++i) {
+        if (fused[i] && procs[i - 1]->isFusible() && procs[i]->isFusible()) {
+            if (leader == nullptr) {
+                leader = procs[i - 1];
+            }
+            leader->fuse(procs[i]);
+        }
+        else {
+            if (fused[i]) {
+                _report.verbose(u"plugins %s and %s cannot be fused, packet window processing", procs[i - 1]->pluginName(), procs[i]->pluginName());
+            }
+            leader = nullptr;
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Load the processing time per packet of each packet processor from a profile.
+//----------------------------------------------------------------------------
+
+bool ts::TSProcessor::loadPluginCosts(std::vector<double>& costs, const std::vector<tsp::ProcessorExecutor*>& procs)
+{
+    costs.clear();
+    json::ValuePtr root;
+    if (!json::LoadFile(root, _args.fuse_profile, _report)) {
+        return false;
+    }
+
+    // The profile must describe the same chain of plugins: input, packet processors, output.
+    const json::Value& plugins(root->value(u"plugins"));
+    bool same = plugins.size() == procs.size() + 2;
+    for (size_t i = 0; same && i < procs.size(); ++i) {
+        same = plugins.at(i + 1).value(u"name").toString() == procs[i]->pluginName();
+    }
+    if (!same) {
+        _report.warning(u"execution profile %s does not match the chain of plugins, ignored", _args.fuse_profile);
+        return false;
+    }
+
+    // The cost of a plugin is its total processing time, divided by the number of packets it processed.
+    for (size_t i = 0; i < procs.size(); ++i) {
+        const json::Value& plugin(plugins.at(i + 1));
+        const json::Value& time(plugin.value(u"plugin-time-ns"));
+        const int64_t calls = time.value(u"count").toInteger();
+        const int64_t packets = plugin.value(u"packets").toInteger();
+        const double cost = calls <= 0 ? -1.0 : time.value(u"mean").toFloat() * double(calls) / double(std::max<int64_t>(1, packets));
+        _report.debug(u"plugin %s: %s ns/packet in previous profile", procs[i]->pluginName(), cost < 0.0 ? UString(u"unknown") : UString::Float(cost, 0, 1));
+        costs.push_back(cost);
+    }
+    return true;
+}
+
+
 //----------------------------------------------------------------------------
 // Check if the TS processing is started.
 //----------------------------------------------------------------------------
@@ -263,7 +393,35 @@ void ts::TSProcessor::waitForTermination()
         // Make sure the control server thread is terminated before deleting plugins.
         _control->close();
 
+        // Report the execution profile before deleting plugins.
+        if (_args.profile) {
+            saveProfile();
+        }
+
         // Deallocate all plugins and plugin executor
         cleanupInternal();
     }
 }
+
+
+//----------------------------------------------------------------------------
+// Save or log the execution profile of all plugins.
+//----------------------------------------------------------------------------
+
+void ts::TSProcessor::saveProfile()
+{
+    json::ValuePtr root(new json::Object);
+    json::ValuePtr plugins(new json::Array);
+    tsp::PluginExecutor* proc = _input;
+    do {
+        plugins->set(proc->getProfile());
+    } while ((proc = proc->ringNext<tsp::PluginExecutor>()) != _input);
+    root->add(u"plugins", plugins);
+
+    if (_args.profile_file.empty()) {
+        _report.info(u"execution profile:\n%s", root->printed(2, _report));
+    }
+    else if (root->save(_args.profile_file, 2, false, _report)) {
+        _report.verbose(u"execution profile saved in %s", _args.profile_file);
+    }
+}
@@ -23,6 +23,7 @@ namespace ts {
     namespace tsp {
         class InputExecutor;
         class OutputExecutor;
+        class ProcessorExecutor;
         class ControlServer;
     }
     //! @endcond
@@ -99,5 +100,15 @@ namespace ts {
 
         // Deallocate and cleanup internal resources.
         void cleanupInternal();
+
+        // Save or log the execution profile of all plugins (option --profile).
+        void saveProfile();
+
+        // Select plugins to execute in the same thread (options --fuse and --fuse-profile).
+        void fusePlugins();
+
+        // Load the average processing time per packet of each packet processor from an execution profile.
+        // A negative value means unknown.
+        bool loadPluginCosts(std::vector<double>& costs, const std::vector<tsp::ProcessorExecutor*>& procs);
     };
 }
@@ -89,11 +89,48 @@ void ts::TSProcessorArgs::defineArgs(Args& args)
               u"Specify the reception timeout for control commands. "
               u"The default timeout is " + UString::Chrono(DEFAULT_CONTROL_TIMEOUT, true) + u".");
 
+    args.option(u"cpu-map", 0, Args::INTEGER, 0, Args::UNLIMITED_COUNT, 0, 4095);
+    args.help(u"cpu-map", u"cpu1[-cpu2]",
+              u"Pin each plugin thread on one CPU. The specified CPU's are allocated in order to the input plugin, "
+              u"the packet processor plugins and the output plugin. If there are more plugins than CPU's, "
+              u"the allocation restarts at the first CPU. Typically, use a range of isolated CPU's, such as "
+              u"--cpu-map 4-11. Several --cpu-map options may be specified. "
+              u"The option --plugin-cpu overrides this allocation for one plugin.");
+
     args.option<cn::milliseconds>(u"final-wait");
     args.help(u"final-wait",
               u"Wait the specified duration after the last input packet. "
               u"Zero means wait forever.");
 
+    args.option(u"fuse", 0, Args::STRING, 0, Args::UNLIMITED_COUNT);
+    args.help(u"fuse", u"first-last",
+              u"Execute the packet processor plugins from index <first> to <last> (inclusive) in the same thread. "
+              u"The first packet processor has index 1, as displayed by --log-plugin-index. "
+              u"Each packet is passed through all plugins of the group while it is hot in the CPU cache, "
+              u"saving one thread switch and one buffer handoff per plugin. "
+              u"Use this option on sequences of lightweight plugins. Heavy plugins (scrambling, analysis) "
+              u"should keep their own thread to use several CPU cores. "
+              u"Plugins which process packet windows cannot be fused. "
+              u"Several --fuse options are allowed.");
+
+    args.option(u"fuse-profile", 0, Args::FILENAME);
+    args.help(u"fuse-profile", u"filename",
+              u"Automatically select the packet processor plugins to fuse from an execution profile, "
+              u"as saved by a previous execution with --profile-file and the same chain of plugins, without --fuse. "
+              u"Consecutive plugins with an average processing time per packet below the --fuse-threshold value "
+              u"are executed in the same thread. Can be combined with --fuse.");
+
+    args.option<cn::nanoseconds>(u"fuse-threshold");
+    args.help(u"fuse-threshold",
+              u"With --fuse-profile, maximum average processing time per packet of a plugin to be fused with its neighbours. "
+              u"The default is " + UString::Chrono(DEFAULT_FUSE_THRESHOLD, true) + u".");
+
+    args.option(u"huge-pages");
+    args.help(u"huge-pages",
+              u"Allocate the global buffer using huge pages (Linux only), reducing TLB misses with large buffers. "
+              u"Huge pages shall be reserved by the system administrator in /proc/sys/vm/nr_hugepages. "
+              u"When no huge page is available, transparent huge pages are used, when enabled in the system.");
+
     args.option(u"ignore-joint-termination", 'i');
     args.help(u"ignore-joint-termination",
               u"Ignore all --joint-termination options in plugins. "
@@ -114,12 +151,60 @@ void ts::TSProcessorArgs::defineArgs(Args& args)
               u"a valid bitrate value from the beginning. "
               u"The default initial load is half the size of the global buffer.");
 
+    args.option(u"lock-free-handoff");
+    args.help(u"lock-free-handoff",
+              u"Pass packets from one plugin to the next one using atomic counters instead of a global lock. "
+              u"The global lock is still used for control operations such as abort or restart. "
+              u"This option reduces the synchronization overhead in long chains of plugins with high bitrates.");
+
     args.option(u"log-plugin-index");
     args.help(u"log-plugin-index",
               u"In log messages, add the plugin index to the plugin name. "
               u"This can be useful if the same plugin is used several times "
               u"and all instances log many messages.");
 
+    args.option(u"no-memory-lock");
+    args.help(u"no-memory-lock",
+              u"Do not lock the global buffer in physical memory. "
+              u"By default, the global buffer is locked in memory to avoid page faults during the processing.");
+
+    args.option(u"numa-node", 0, Args::INTEGER, 0, 1, 0, 1023);
+    args.help(u"numa-node",
+              u"Allocate the physical memory of the global buffer on the specified NUMA node and run all plugin "
+              u"threads on the CPU's of this node (Linux only). "
+              u"On multi-socket servers, this avoids memory accesses across sockets.");
+
+    args.option(u"plugin-cpu", 0, Args::STRING, 0, Args::UNLIMITED_COUNT);
+    args.help(u"plugin-cpu", u"index:cpu1[-cpu2][,...]",
+              u"Run the thread of the plugin at the specified index on the specified CPU's only (Linux and Windows). "
+              u"The input plugin has index 0, the packet processor plugins start at 1, as displayed by "
+              u"--log-plugin-index, and the output plugin comes last. Example: --plugin-cpu 2:4-5,8. "
+              u"This overrides the allocation from --cpu-map and --numa-node for this plugin. "
+              u"Several --plugin-cpu options may be specified, for distinct plugins.");
+
+    args.option(u"plugin-sched", 0, Args::STRING, 0, Args::UNLIMITED_COUNT);
+    args.help(u"plugin-sched", u"index:policy[:priority]",
+              u"Scheduling policy of the thread of the plugin at the specified index, same index as in --plugin-cpu. "
+              u"The policy is one of \"fifo\", \"rr\" (round-robin) or \"other\" (default). "
+              u"The real-time policies \"fifo\" and \"rr\" require specific privileges. "
+              u"On Linux, the real-time priority is in the range 1 to 99. The default is 1. "
+              u"Example: --plugin-sched 0:fifo:50. "
+              u"Several --plugin-sched options may be specified, for distinct plugins.");
+
+    args.option(u"profile");
+    args.help(u"profile",
+              u"Collect an execution profile of all plugins: time spent in the plugin, time waiting for packets "
+              u"or free space in the buffer, time waiting for the global lock, number of packets per call and "
+              u"buffer occupancy. Each metric is recorded in a histogram with percentiles. "
+              u"The profile can be queried during the processing using the tspcontrol command \"profile\". "
+              u"At the end of the processing, the profile is logged in JSON format, "
+              u"unless --profile-file is specified.");
+
+    args.option(u"profile-file", 0, Args::FILENAME);
+    args.help(u"profile-file", u"filename",
+              u"Save the execution profile of all plugins in the specified JSON file at the end of the processing. "
+              u"Implies --profile.");
+
     args.option<cn::milliseconds>(u"receive-timeout");
     args.help(u"receive-timeout",
               u"Specify a timeout for all input operations. "
@@ -168,7 +253,16 @@ bool ts::TSProcessorArgs::loadArgs(DuckContext& duck, Args& args)
 {
     app_name = args.appName();
     log_plugin_index = args.present(u"log-plugin-index");
+    lock_free_handoff = args.present(u"lock-free-handoff");
+    args.getPathValue(profile_file, u"profile-file");
+    profile = args.present(u"profile") || !profile_file.empty();
+    args.getPathValue(fuse_profile, u"fuse-profile");
+    args.getChronoValue(fuse_threshold, u"fuse-threshold", DEFAULT_FUSE_THRESHOLD);
     ts_buffer_size = args.intValue<size_t>(u"buffer-size-mb", DEFAULT_BUFFER_SIZE);
+    lock_buffer = !args.present(u"no-memory-lock");
+    huge_pages = args.present(u"huge-pages");
+    args.getIntValue(numa_node, u"numa-node", -1);
+    args.getIntValues(cpu_map, u"cpu-map");
     args.getValue(fixed_bitrate, u"bitrate", 0);
     args.getChronoValue(bitrate_adj, u"bitrate-adjust-interval", DEFAULT_BITRATE_INTERVAL);
     args.getIntValue(max_flush_pkt, u"max-flushed-packets", 0);
@@ -207,6 +301,18 @@ bool ts::TSProcessorArgs::loadArgs(DuckContext& duck, Args& args)
         args.error(u"invalid value for --add-input-stuffing, use \"nullpkt/inpkt\" format");
     }
 
+    // Decode --fuse first-last.
+    fuse_ranges.clear();
+    for (size_t i = 0; i < args.count(u"fuse"); ++i) {
+        size_t first = 0, last = 0;
+        if (!args.value(u"fuse", u"", i).scan(u"%d-%d", &first, &last) || first == 0 || last < first) {
+            args.error(u"invalid value for --fuse, use \"first-last\" format, with 1 <= first <= last");
+        }
+        else {
+            fuse_ranges.push_back(std::make_pair(first, last));
+        }
+    }
+
     // Load all plugin descriptions.
     // The default input and output are the standard input and output files.
     ArgsWithPlugins* pargs = dynamic_cast<ArgsWithPlugins*>(&args);
@@ -221,6 +327,40 @@ bool ts::TSProcessorArgs::loadArgs(DuckContext& duck, Args& args)
         plugins.clear();
     }
 
+    // Check that fused plugins exist.
+    for (const auto& range : fuse_ranges) {
+        if (range.second > plugins.size()) {
+            args.error(u"invalid --fuse %d-%d, there are only %d packet processor plugins", range.first, range.second, plugins.size());
+        }
+    }
+
+    // Decode --plugin-cpu index:cpus and --plugin-sched index:policy[:priority].
+    plugin_threads.clear();
+    const auto plugin_thread = [this, &args](const UChar* name, size_t i, UString& value) -> ThreadAttributes* {
+        const UString opt(args.value(name, u"", i));
+        const size_t colon = opt.find(u':');
+        size_t index = 0;
+        if (colon == NPOS || !opt.substr(0, colon).toInteger(index) || index > plugins.size() + 1) {
+            args.error(u"invalid plugin index in --%s %s, use 0 to %d", name, opt, plugins.size() + 1);
+            return nullptr;
+        }
+        value = opt.substr(colon + 1);
+        return &plugin_threads[index];
+    };
+    UString value;
+    for (size_t i = 0; i < args.count(u"plugin-cpu"); ++i) {
+        ThreadAttributes* attr = plugin_thread(u"plugin-cpu", i, value);
+        if (attr != nullptr && !attr->decodeAffinity(value)) {
+            args.error(u"invalid list of CPU's in --plugin-cpu: %s", value);
+        }
+    }
+    for (size_t i = 0; i < args.count(u"plugin-sched"); ++i) {
+        ThreadAttributes* attr = plugin_thread(u"plugin-sched", i, value);
+        if (attr != nullptr && !attr->decodeSchedulingPolicy(value)) {
+            args.error(u"invalid scheduling policy in --plugin-sched: %s, use fifo, rr or other", value);
+        }
+    }
+
     // Get default options for TSDuck contexts in each plugin.
     duck.saveArgs(duck_args);
 
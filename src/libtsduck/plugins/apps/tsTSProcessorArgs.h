@@ -14,6 +14,7 @@
 #pragma once
 #include "tsPluginOptions.h"
 #include "tsIPv4Address.h"
+#include "tsThreadAttributes.h"
 
 namespace ts {
 
@@ -30,7 +31,18 @@ namespace ts {
         UString           app_name {};              //!< Application name, for help messages.
         bool              ignore_jt = false;        //!< Ignore "joint termination" options in plugins.
         bool              log_plugin_index = false; //!< Log plugin index with plugin name.
+        bool              lock_free_handoff = false; //!< Pass packets between plugins without the global mutex.
+        bool              profile = false;          //!< Collect execution profile of all plugins.
+        fs::path          profile_file {};          //!< JSON file where to save the execution profile at end of processing.
+        std::vector<std::pair<size_t,size_t>> fuse_ranges {}; //!< Ranges of processor plugins (first, last) which are executed in the same thread. Plugin indexes start at 1.
+        fs::path          fuse_profile {};          //!< JSON execution profile from which lightweight consecutive plugins are automatically fused.
+        cn::nanoseconds   fuse_threshold = DEFAULT_FUSE_THRESHOLD; //!< Maximum processing time per packet of automatically fused plugins.
         size_t            ts_buffer_size = DEFAULT_BUFFER_SIZE; //!< Size in bytes of the global TS packet buffer.
+        bool              lock_buffer = true;       //!< Lock the global TS packet buffer in physical memory.
+        bool              huge_pages = false;       //!< Allocate the global TS packet buffer using huge pages.
+        int               numa_node = -1;           //!< NUMA node of the global TS packet buffer and plugin threads, -1 means none.
+        std::vector<size_t> cpu_map {};             //!< CPU's of plugin threads, in order of plugins: input, packet processors, output.
+        std::map<size_t, ThreadAttributes> plugin_threads {}; //!< CPU affinity and scheduling policy of some plugin threads, indexed by plugin index (0 is input).
         size_t            max_flush_pkt = 0;        //!< Max processed packets before flush.
         size_t            max_input_pkt = 0;        //!< Max packets per input operation.
         size_t            max_output_pkt = NPOS;    //!< Max packets per outsput operation. NPOS means unlimited.
@@ -60,6 +72,7 @@ namespace ts {
         static constexpr PacketCounter DEFAULT_INIT_BITRATE_PKT_INTERVAL = 1000;  //!< Default initial bitrate reevaluation interval, in packets.
         static constexpr cn::milliseconds DEFAULT_BITRATE_INTERVAL = cn::milliseconds(5000);  //!< Default bitrate adjustment interval, in milliseconds.
         static constexpr cn::milliseconds DEFAULT_CONTROL_TIMEOUT = cn::milliseconds(5000);   //!< Default control command reception timeout, in milliseconds.
+        static constexpr cn::nanoseconds DEFAULT_FUSE_THRESHOLD = cn::nanoseconds(200);      //!< Default maximum processing time per packet of automatically fused plugins.
 
         //!
         //! Constructor.
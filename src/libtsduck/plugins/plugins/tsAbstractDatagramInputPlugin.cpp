@@ -20,11 +20,16 @@ ts::AbstractDatagramInputPlugin::AbstractDatagramInputPlugin(TSP* tsp_,
                                                              const UString& syntax,
                                                              const UString& system_time_name,
                                                              const UString& system_time_description,
-                                                             bool real_time) :
+                                                             bool real_time,
+                                                             size_t max_datagrams) :
     InputPlugin(tsp_, description, syntax),
     _real_time(real_time),
-    _inbuf(std::max(buffer_size, 7 * PKT_SIZE)),
-    _mdata(_inbuf.size() / PKT_SIZE)
+    _dg_size(std::max(buffer_size, 7 * PKT_SIZE)),
+    _inbuf(_dg_size * std::max<size_t>(1, max_datagrams)),
+    _mdata(_dg_size / PKT_SIZE),
+    _dg_sizes(std::max<size_t>(1, max_datagrams)),
+    _dg_timestamps(_dg_sizes.size()),
+    _dg_timesources(_dg_sizes.size())
 {
     if (_real_time) {
         option<cn::seconds>(u"display-interval", 'd');
@@ -98,7 +103,7 @@ bool ts::AbstractDatagramInputPlugin::getOptions()
 bool ts::AbstractDatagramInputPlugin::start()
 {
     // Initialize working data.
-    _inbuf_count = _inbuf_next = _mdata_next = 0;
+    _inbuf_count = _inbuf_next = _mdata_next = _dg_count = _dg_next = 0;
     _start = _start_0 = _start_1 = _next_display = Time::Epoch;
     _packets = _packets_0 = _packets_1 = 0;
     return true;
@@ -130,132 +135,194 @@ ts::BitRateConfidence ts::AbstractDatagramInputPlugin::getBitrateConfidence()
 
 
 //----------------------------------------------------------------------------
-// Input method
+// Default implementation of multiple datagrams reception.
 //----------------------------------------------------------------------------
 
-size_t ts::AbstractDatagramInputPlugin::receive(TSPacket* buffer, TSPacketMetadata* pkt_data, size_t max_packets)
+bool ts::AbstractDatagramInputPlugin::receiveDatagrams(uint8_t* buffer,
+                                                       size_t buffer_size,
+                                                       size_t max_count,
+                                                       size_t& ret_count,
+                                                       size_t ret_sizes[],
+                                                       cn::microseconds timestamps[],
+                                                       TimeSource timesources[])
 {
-    cn::microseconds timestamp = cn::microseconds(-1);
-    TimeSource timesource = TimeSource::UNDEFINED;
-
-    // Check if we receive new packets or process remain of previous buffer.
-    bool new_packets = false;
+    ret_count = 0;
+    if (max_count == 0) {
+        return true;
+    }
+    timestamps[0] = cn::microseconds(-1);
+    timesources[0] = TimeSource::UNDEFINED;
+    if (!receiveDatagram(buffer, buffer_size, ret_sizes[0], timestamps[0], timesources[0])) {
+        return false;
+    }
+    ret_count = 1;
+    return true;
+}
 
-    // If there is no remaining packet in the input buffer, wait for a datagram message.
-    // Loop until we get some TS packets.
-    while (_inbuf_count == 0) {
 
-        // Wait for a datagram message
-        size_t insize = 0;
-        if (!receiveDatagram(_inbuf.data(), _inbuf.size(), insize, timestamp, timesource)) {
-            return 0;
-        }
+//----------------------------------------------------------------------------
+// Input method
+//----------------------------------------------------------------------------
 
-        // Look for TS packets in the UDP message.
-        new_packets = TSPacket::Locate(_inbuf.data(), insize, _inbuf_next, _inbuf_count);
+size_t ts::AbstractDatagramInputPlugin::receive(TSPacket* buffer, TSPacketMetadata* pkt_data, size_t max_packets)
+{
+    size_t pkt_cnt = 0;
 
-        if (new_packets) {
+    while (pkt_cnt < max_packets) {
 
-            // Look for an RTP header before the first packet. There is no clear proof of the presence of the RTP header.
-            // We check if the header size is large enough for an RTP header and if the "RTP payload type" is MPEG-2 TS.
-            const bool rtp = _inbuf_next >= RTP_HEADER_SIZE && (_inbuf[1] & 0x7F) == RTP_PT_MP2T;
-            const ts::rtp_units rtp_timestamp = ts::rtp_units(rtp ? GetUInt32(_inbuf.data() + 4) : 0);
+        // If there is no remaining packet in the current datagram, move to the next one.
+        if (_inbuf_count == 0) {
 
-            // Use RTP time stamp if there is one and RTP is the preferred choice.
-            bool use_rtp = false;
-            bool use_kernel = false;
-            switch (_time_priority) {
-                case RTP_SYSTEM_TSP:
-                    use_rtp = rtp;
-                    use_kernel = !rtp && timestamp >= cn::microseconds::zero();
+            // If all received datagrams were processed, wait for new datagram messages.
+            // Do not wait if some packets are already returned.
+            if (_dg_next >= _dg_count) {
+                if (pkt_cnt > 0) {
                     break;
-                case SYSTEM_RTP_TSP:
-                    use_kernel = timestamp >= cn::microseconds::zero();
-                    use_rtp = !use_kernel && rtp;
-                    break;
-                case RTP_TSP:
-                    use_rtp = rtp;
-                    use_kernel = false;
-                    break;
-                case SYSTEM_TSP:
-                    use_kernel = timestamp >= cn::microseconds::zero();
-                    use_rtp = false;
-                    break;
-                case TSP_ONLY:
-                default:
-                    use_rtp = false;
-                    use_kernel = false;
-                    break;
-            }
-
-            // Build time stamps in packet metadata.
-            _mdata_next = 0;
-            for (size_t i = 0; i < _inbuf_count; ++i) {
-                if (use_rtp) {
-                    _mdata[i].setInputTimeStamp(rtp_timestamp, TimeSource::RTP);
-                }
-                else if (use_kernel) {
-                    _mdata[i].setInputTimeStamp(timestamp, timesource);
                 }
-                else {
-                    _mdata[i].clearInputTimeStamp();
+                _dg_count = _dg_next = 0;
+                if (!receiveDatagrams(_inbuf.data(), _dg_size, _dg_sizes.size(), _dg_count, _dg_sizes.data(), _dg_timestamps.data(), _dg_timesources.data())) {
+                    return 0;
                 }
             }
 
-            break; // found packets.
+            // Look for TS packets in the next datagram.
+            if (_dg_next >= _dg_count || !loadNextDatagram()) {
+                continue;
+            }
+
+            // We may need to re-evaluate the real-time input bitrate.
+            updateBitrate(_inbuf_count);
         }
 
-        // No TS packet found in UDP message, wait for another one.
-        debug(u"no TS packet in message, %s bytes", insize);
+        // Return packets from the current datagram.
+        const size_t count = std::min(_inbuf_count, max_packets - pkt_cnt);
+        TSPacket::Copy(buffer + pkt_cnt, _inbuf.data() + _inbuf_next, count);
+        TSPacketMetadata::Copy(pkt_data + pkt_cnt, &_mdata[_mdata_next], count);
+        _inbuf_count -= count;
+        _inbuf_next += count * PKT_SIZE;
+        _mdata_next += count;
+        pkt_cnt += count;
     }
 
-    // If new packets were received, we may need to re-evaluate the real-time input bitrate.
-    if (new_packets && _real_time && _eval_time > cn::milliseconds::zero()) {
+    return pkt_cnt;
+}
+
 
-        const Time now(Time::CurrentUTC());
+//----------------------------------------------------------------------------
+// Load the next received datagram from the input buffer.
+//----------------------------------------------------------------------------
 
-        // Detect start time
-        if (_packets == 0) {
-            _start = _start_0 = _start_1 = now;
-            if (_display_time > cn::milliseconds::zero()) {
-                _next_display = now + _display_time;
-            }
+bool ts::AbstractDatagramInputPlugin::loadNextDatagram()
+{
+    assert(_dg_next < _dg_count);
+    const size_t index = _dg_next++;
+    const uint8_t* const data = _inbuf.data() + index * _dg_size;
+    const size_t insize = _dg_sizes[index];
+    const cn::microseconds timestamp = _dg_timestamps[index];
+    const TimeSource timesource = _dg_timesources[index];
+
+    // Look for TS packets in the UDP message.
+    size_t start = 0;
+    if (!TSPacket::Locate(data, insize, start, _inbuf_count)) {
+        // No TS packet found in UDP message, wait for another one.
+        debug(u"no TS packet in message, %s bytes", insize);
+        _inbuf_count = 0;
+        return false;
+    }
+    _inbuf_next = index * _dg_size + start;
+
+    // Look for an RTP header before the first packet. There is no clear proof of the presence of the RTP header.
+    // We check if the header size is large enough for an RTP header and if the "RTP payload type" is MPEG-2 TS.
+    const bool rtp = start >= RTP_HEADER_SIZE && (data[1] & 0x7F) == RTP_PT_MP2T;
+    const ts::rtp_units rtp_timestamp = ts::rtp_units(rtp ? GetUInt32(data + 4) : 0);
+
+    // Use RTP time stamp if there is one and RTP is the preferred choice.
+    bool use_rtp = false;
+    bool use_kernel = false;
+    switch (_time_priority) {
+        case RTP_SYSTEM_TSP:
+            use_rtp = rtp;
+            use_kernel = !rtp && timestamp >= cn::microseconds::zero();
+            break;
+        case SYSTEM_RTP_TSP:
+            use_kernel = timestamp >= cn::microseconds::zero();
+            use_rtp = !use_kernel && rtp;
+            break;
+        case RTP_TSP:
+            use_rtp = rtp;
+            use_kernel = false;
+            break;
+        case SYSTEM_TSP:
+            use_kernel = timestamp >= cn::microseconds::zero();
+            use_rtp = false;
+            break;
+        case TSP_ONLY:
+        default:
+            use_rtp = false;
+            use_kernel = false;
+            break;
+    }
+
+    // Build time stamps in packet metadata.
+    _mdata_next = 0;
+    for (size_t i = 0; i < _inbuf_count; ++i) {
+        if (use_rtp) {
+            _mdata[i].setInputTimeStamp(rtp_timestamp, TimeSource::RTP);
         }
+        else if (use_kernel) {
+            _mdata[i].setInputTimeStamp(timestamp, timesource);
+        }
+        else {
+            _mdata[i].clearInputTimeStamp();
+        }
+    }
+    return true;
+}
 
-        // Count packets
-        _packets += _inbuf_count;
-        _packets_0 += _inbuf_count;
-        _packets_1 += _inbuf_count;
 
-        // Detect new evaluation period
-        if (now >= _start_1 + _eval_time) {
-            _start_0 = _start_1;
-            _packets_0 = _packets_1;
-            _start_1 = now;
-            _packets_1 = 0;
+//----------------------------------------------------------------------------
+// Update the evaluation of the real-time input bitrate.
+//----------------------------------------------------------------------------
 
-        }
+void ts::AbstractDatagramInputPlugin::updateBitrate(size_t packet_count)
+{
+    if (!_real_time || _eval_time <= cn::milliseconds::zero()) {
+        return;
+    }
 
-        // Check if evaluated bitrate should be displayed
-        if (_display_time > cn::milliseconds::zero() && now >= _next_display) {
-            _next_display += _display_time;
-            const cn::milliseconds ms_current = Time::CurrentUTC() - _start_0;
-            const cn::milliseconds ms_total = Time::CurrentUTC() - _start;
-            const BitRate br_current = PacketBitRate(_packets_0, ms_current);
-            const BitRate br_average = PacketBitRate(_packets, ms_total);
-            info(u"input bitrate: %s, average: %s",
-                 br_current == 0 ? u"undefined" : br_current.toString() + u" b/s",
-                 br_average == 0 ? u"undefined" : br_average.toString() + u" b/s");
+    const Time now(Time::CurrentUTC());
+
+    // Detect start time
+    if (_packets == 0) {
+        _start = _start_0 = _start_1 = now;
+        if (_display_time > cn::milliseconds::zero()) {
+            _next_display = now + _display_time;
         }
     }
 
-    // Return packets from the input buffer
-    size_t pkt_cnt = std::min(_inbuf_count, max_packets);
-    TSPacket::Copy(buffer, _inbuf.data() + _inbuf_next, pkt_cnt);
-    TSPacketMetadata::Copy(pkt_data, &_mdata[_mdata_next], pkt_cnt);
-    _inbuf_count -= pkt_cnt;
-    _inbuf_next += pkt_cnt * PKT_SIZE;
-    _mdata_next += pkt_cnt;
+    // Count packets
+    _packets += packet_count;
+    _packets_0 += packet_count;
+    _packets_1 += packet_count;
 
-    return pkt_cnt;
+    // Detect new evaluation period
+    if (now >= _start_1 + _eval_time) {
+        _start_0 = _start_1;
+        _packets_0 = _packets_1;
+        _start_1 = now;
+        _packets_1 = 0;
+
+    }
+
+    // Check if evaluated bitrate should be displayed
+    if (_display_time > cn::milliseconds::zero() && now >= _next_display) {
+        _next_display += _display_time;
+        const cn::milliseconds ms_current = Time::CurrentUTC() - _start_0;
+        const cn::milliseconds ms_total = Time::CurrentUTC() - _start;
+        const BitRate br_current = PacketBitRate(_packets_0, ms_current);
+        const BitRate br_average = PacketBitRate(_packets, ms_total);
+        info(u"input bitrate: %s, average: %s",
+             br_current == 0 ? u"undefined" : br_current.toString() + u" b/s",
+             br_average == 0 ? u"undefined" : br_average.toString() + u" b/s");
+    }
 }
@@ -50,6 +50,8 @@ namespace ts {
         //! @param [in] system_time_description Description of @a system_time_name for help text.
         //! @param [in] real_time If true, the reception occurs in real-time, typically from
         //! the network. When false, the "reception" can be reading a capture file.
+        //! @param [in] max_datagrams Maximum number of datagrams which can be received at once
+        //! by receiveDatagrams(). One input buffer of @a buffer_size bytes is allocated per datagram.
         //!
         AbstractDatagramInputPlugin(TSP* tsp,
                                     size_t buffer_size,
@@ -57,7 +59,8 @@ namespace ts {
                                     const UString& syntax,
                                     const UString& system_time_name,
                                     const UString& system_time_description,
-                                    bool real_time);
+                                    bool real_time,
+                                    size_t max_datagrams = 1);
 
         //!
         //! Receive a datagram message.
@@ -71,6 +74,30 @@ namespace ts {
         //!
         virtual bool receiveDatagram(uint8_t* buffer, size_t buffer_size, size_t& ret_size, cn::microseconds& timestamp, TimeSource& timesource) = 0;
 
+        //!
+        //! Receive one or more datagram messages.
+        //! Subclasses which can receive several datagrams at once should override this method.
+        //! The default implementation calls receiveDatagram() once.
+        //! @param [out] buffer Address of the buffers for the received messages. Message number
+        //! @e i is stored at address <code>buffer + i * buffer_size</code>.
+        //! @param [in] buffer_size Size in bytes of the reception buffer for one message.
+        //! @param [in] max_count Maximum number of messages to receive. Never larger than the
+        //! @a max_datagrams parameter of the constructor.
+        //! @param [out] ret_count Number of received messages.
+        //! @param [out] ret_sizes Array of @a max_count sizes. The first @a ret_count are updated
+        //! with the sizes of the received messages.
+        //! @param [out] timestamps Array of @a max_count receive timestamps in micro-seconds or -1 if not available.
+        //! @param [out] timesources Array of @a max_count types of timestamp.
+        //! @return True on success, false on error.
+        //!
+        virtual bool receiveDatagrams(uint8_t* buffer,
+                                      size_t buffer_size,
+                                      size_t max_count,
+                                      size_t& ret_count,
+                                      size_t ret_sizes[],
+                                      cn::microseconds timestamps[],
+                                      TimeSource timesources[]);
+
     private:
         // Order of priority for input timestamps. SYSTEM means lower layer from subclass (UDP, SRT, etc).
         enum TimePriority {RTP_SYSTEM_TSP, SYSTEM_RTP_TSP, RTP_TSP, SYSTEM_TSP, TSP_ONLY};
@@ -91,10 +118,22 @@ namespace ts {
         PacketCounter _packets_0 = 0;       // Number of received packets since _start_0
         Time          _start_1 {};          // Start of previous bitrate evaluation period
         PacketCounter _packets_1 = 0;       // Number of received packets since _start_1
-        size_t        _inbuf_count = 0;     // Number of remaining TS packets in inbuf
+        size_t        _inbuf_count = 0;     // Number of remaining TS packets in current datagram
         size_t        _inbuf_next = 0;      // Byte index in _inbuf of next TS packet to return
         size_t        _mdata_next = 0;      // Index in _mdata of next TS packet metadata to return
-        ByteBlock     _inbuf {};            // Input buffer
-        TSPacketMetadataVector _mdata {};   // Metadata for packets in _inbuf
+        size_t        _dg_size = 0;         // Size of the input buffer for one datagram
+        size_t        _dg_count = 0;        // Number of received datagrams in _inbuf
+        size_t        _dg_next = 0;         // Index of next datagram to process in _inbuf
+        ByteBlock     _inbuf {};            // Input buffer, for all datagrams
+        TSPacketMetadataVector _mdata {};   // Metadata for packets in current datagram
+        std::vector<size_t> _dg_sizes {};   // Sizes of received datagrams
+        std::vector<cn::microseconds> _dg_timestamps {};  // Timestamps of received datagrams
+        std::vector<TimeSource> _dg_timesources {};       // Sources of timestamps of received datagrams
+
+        // Load the next received datagram from _inbuf. Return false if no TS packet is found.
+        bool loadNextDatagram();
+
+        // Update the evaluation of the real-time input bitrate with new packets.
+        void updateBitrate(size_t packet_count);
     };
 }
@@ -123,8 +123,8 @@ bool ts::AbstractDescrambler::start()
     _scrambled_streams.clear();
     _demux.reset();
 
-    // Initialize the scrambling engine.
-    if (!_scrambling.start()) {
+    // Initialize the scrambling engine. With DVB-CSA2, packets are descrambled by batches.
+    if (!_scrambling.start() || !_scrambling.setBatchMode(_scrambling.batchSize() > 0)) {
         return false;
     }
 
@@ -442,6 +442,30 @@ void ts::AbstractDescrambler::ECMThread::main()
 }
 
 
+//----------------------------------------------------------------------------
+// Packet window processing methods.
+//----------------------------------------------------------------------------
+
+size_t ts::AbstractDescrambler::getPacketWindowSize()
+{
+    // With DVB-CSA2, use packet windows to descramble packets in parallel.
+    return _scrambling.batchSize();
+}
+
+size_t ts::AbstractDescrambler::processPacketWindow(TSPacketWindow& win)
+{
+    // Process packets one by one. In batch mode, the payloads are only queued for descrambling.
+    const size_t count = ProcessorPlugin::processPacketWindow(win);
+
+    // Descramble all queued payloads before passing the packets to the next plugin.
+    bool ok = _scrambling.flushBatch();
+    for (const auto& it : _ecm_streams) {
+        ok = it.second->scrambling.flushBatch() && ok;
+    }
+    return ok ? count : 0;
+}
+
+
 //----------------------------------------------------------------------------
 // Packet processing method
 //----------------------------------------------------------------------------
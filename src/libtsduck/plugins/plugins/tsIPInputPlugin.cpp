@@ -21,8 +21,10 @@ TS_REGISTER_INPUT_PLUGIN(u"ip", ts::IPInputPlugin);
 ts::IPInputPlugin::IPInputPlugin(TSP* tsp_) :
     AbstractDatagramInputPlugin(tsp_, IP_MAX_PACKET_SIZE, u"Receive TS packets from UDP/IP, multicast or unicast", u"[options] [address:]port",
                                 u"kernel", u"A kernel-provided time-stamp for the packet, when available (Linux only)",
-                                true), // real-time network reception
-    _sock(*tsp_)
+                                true, // real-time network reception
+                                MAX_DATAGRAMS),
+    _sock(*tsp_),
+    _messages(MAX_DATAGRAMS)
 {
     // Add UDP receiver common options.
     _sock.defineArgs(*this, true, true, false);
@@ -88,7 +90,7 @@ bool ts::IPInputPlugin::setReceiveTimeout(cn::milliseconds timeout)
 
 
 //----------------------------------------------------------------------------
-// Datagram reception method.
+// Datagram reception methods.
 //----------------------------------------------------------------------------
 
 bool ts::IPInputPlugin::receiveDatagram(uint8_t* buffer, size_t buffer_size, size_t& ret_size, cn::microseconds& timestamp, TimeSource& timesource)
@@ -98,3 +100,30 @@ bool ts::IPInputPlugin::receiveDatagram(uint8_t* buffer, size_t buffer_size, siz
     timesource = TimeSource::KERNEL; // could be HARDWARE if generated by NIC, but no way to know
     return _sock.receive(buffer, buffer_size, ret_size, sender, destination, tsp, *this, &timestamp);
 }
+
+bool ts::IPInputPlugin::receiveDatagrams(uint8_t* buffer, size_t buffer_size, size_t max_count, size_t& ret_count, size_t ret_sizes[], cn::microseconds timestamps[], TimeSource timesources[])
+{
+    // Receive all available datagrams at once.
+    max_count = std::min(max_count, _messages.size());
+    for (size_t i = 0; i < max_count; ++i) {
+        _messages[i].data = buffer + i * buffer_size;
+        _messages[i].max_size = buffer_size;
+    }
+    if (!_sock.receive(_messages.data(), max_count, ret_count, tsp, *this)) {
+        return false;
+    }
+
+    // Rejected messages may have been removed from the array, move the others back in their expected buffer.
+    // The order of the remaining messages is preserved. Therefore, a message is always moved to a lower
+    // address and moving them in increasing order never overwrites a message which is not yet moved.
+    for (size_t i = 0; i < ret_count; ++i) {
+        uint8_t* const expected = buffer + i * buffer_size;
+        if (_messages[i].data != expected) {
+            MemCopy(expected, _messages[i].data, _messages[i].size);
+        }
+        ret_sizes[i] = _messages[i].size;
+        timestamps[i] = _messages[i].timestamp;
+        timesources[i] = TimeSource::KERNEL; // could be HARDWARE if generated by NIC, but no way to know
+    }
+    return true;
+}
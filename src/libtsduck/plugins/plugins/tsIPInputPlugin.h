@@ -34,8 +34,13 @@ namespace ts {
     protected:
         // Implementation of AbstractDatagramInputPlugin.
         virtual bool receiveDatagram(uint8_t* buffer, size_t buffer_size, size_t& ret_size, cn::microseconds& timestamp, TimeSource& timesource) override;
+        virtual bool receiveDatagrams(uint8_t* buffer, size_t buffer_size, size_t max_count, size_t& ret_count, size_t ret_sizes[], cn::microseconds timestamps[], TimeSource timesources[]) override;
 
     private:
-        UDPReceiver _sock; // Incoming socket with associated command line options.
+        // Maximum number of UDP datagrams to receive at once.
+        static constexpr size_t MAX_DATAGRAMS = 32;
+
+        UDPReceiver _sock;   // Incoming socket with associated command line options.
+        std::vector<UDPSocket::ReceivedMessage> _messages {};  // Descriptions of received datagrams.
     };
 }
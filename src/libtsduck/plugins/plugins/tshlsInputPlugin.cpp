@@ -9,6 +9,7 @@
 #include "tshlsInputPlugin.h"
 #include "tsPluginRepository.h"
 #include "tsFileUtils.h"
+#include "tsErrCodeReport.h"
 
 #if !defined(TS_UNIX) || !defined(TS_NO_CURL)
 TS_REGISTER_INPUT_PLUGIN(u"hls", ts::hls::InputPlugin);
@@ -101,6 +102,14 @@ ts::hls::InputPlugin::InputPlugin(TSP* tsp_) :
          u"When the URL is a master playlist, select a content the resolution of which has a "
          u"lower height than the specified maximum.");
 
+    option(u"prefetch", 0, POSITIVE);
+    help(u"prefetch", u"count",
+         u"Download up to the specified number of media segments in advance, using concurrent connections. "
+         u"The downloaded segments are kept in memory and passed to the next plugin in the order of the playlist. "
+         u"This option is useful when the download time of one segment is close to its duration. "
+         u"Each download connection starts from the cookies of the playlists but keeps its own cookies file. "
+         u"By default, the media segments are downloaded one by one, while they are passed to the next plugin.");
+
     option(u"save-files", 0, DIRECTORY);
     help(u"save-files",
          u"Specify a directory where all downloaded files, media segments and playlists, are saved "
@@ -138,6 +147,12 @@ bool ts::hls::InputPlugin::isRealTime()
     return true;
 }
 
+bool ts::hls::InputPlugin::abortInput()
+{
+    _prefetcher.abort();
+    return AbstractHTTPInputPlugin::abortInput();
+}
+
 
 //----------------------------------------------------------------------------
 // Input command line options method
@@ -146,8 +161,9 @@ bool ts::hls::InputPlugin::isRealTime()
 bool ts::hls::InputPlugin::getOptions()
 {
     _url.setURL(value(u""));
-    const UString saveDirectory(value(u"save-files"));
+    getValue(_saveDirectory, u"save-files");
     getIntValue(_maxSegmentCount, u"segment-count");
+    getIntValue(_prefetch, u"prefetch", 0);
     getValue(_minRate, u"min-bitrate");
     getValue(_maxRate, u"max-bitrate");
     getIntValue(_minWidth, u"min-width");
@@ -207,8 +223,8 @@ bool ts::hls::InputPlugin::getOptions()
     }
 
     // Automatically save media segments and playlists.
-    setAutoSaveDirectory(saveDirectory);
-    _playlist.setAutoSaveDirectory(saveDirectory);
+    setAutoSaveDirectory(_saveDirectory);
+    _playlist.setAutoSaveDirectory(_saveDirectory);
 
     return true;
 }
@@ -350,9 +366,22 @@ bool ts::hls::InputPlugin::start()
     }
 
     _segmentCount = 0;
+    _completed = false;
+    _nextReload = Time::Epoch;
 
-    // Invoke superclass.
-    return AbstractHTTPInputPlugin::start();
+    // Without prefetch, invoke superclass to start the first transfer.
+    if (_prefetch == 0) {
+        return AbstractHTTPInputPlugin::start();
+    }
+
+    // In prefetch mode, start the download threads and submit the first segments.
+    _data.clear();
+    _dataIndex = 0;
+    if (!_prefetcher.start(webArgs, _prefetch)) {
+        return false;
+    }
+    feedPrefetcher();
+    return _prefetcher.pendingSegments() > 0;
 }
 
 
@@ -362,22 +391,44 @@ bool ts::hls::InputPlugin::start()
 
 bool ts::hls::InputPlugin::stop()
 {
-    // Invoke superclass first.
-    const bool stopped = AbstractHTTPInputPlugin::stop();
+    bool stopped = true;
+    if (_prefetch == 0) {
+        // Invoke superclass first.
+        stopped = AbstractHTTPInputPlugin::stop();
+    }
+    else {
+        // Terminate all download threads first.
+        const SegmentPrefetcher::Statistics stats(_prefetcher.getStatistics());
+        _prefetcher.stop();
+        _data.clear();
+        verbose(u"downloaded %'d segments, %'d bytes, %'d errors, max queue depth: %d", stats.segments, stats.bytes, stats.errors, stats.max_ready);
+        verbose(u"download bitrate: %'d b/s per segment, %'d b/s total", stats.segmentBitRate(), stats.globalBitRate());
+    }
 
     // Then delete the cookie file. Must be done after complete stop to avoid recreation.
-    return deleteCookiesFile() && stopped;
+    return deleteSharedCookiesFile() && stopped;
 }
 
 
 //----------------------------------------------------------------------------
-// Called by AbstractHTTPInputPlugin to open an URL.
+// Delete the cookies file which is shared by all Web requests.
 //----------------------------------------------------------------------------
 
-bool ts::hls::InputPlugin::openURL(WebRequest& request)
+bool ts::hls::InputPlugin::deleteSharedCookiesFile()
+{
+    return webArgs.cookiesFile.empty() || !fs::exists(webArgs.cookiesFile) ||
+           fs::remove(webArgs.cookiesFile, &ErrCodeReport(*this, u"error deleting", webArgs.cookiesFile));
+}
+
+
+//----------------------------------------------------------------------------
+// Get the next media segment to play.
+//----------------------------------------------------------------------------
+
+bool ts::hls::InputPlugin::nextSegment(MediaSegment& seg, bool wait)
 {
     // Check if the playlist is completed
-    bool completed =
+    _completed = _completed ||
         // the playlist is originally empty
         (_segmentCount == 0 && _playlist.segmentCount() == 0) ||
         // reached maximum number of segments
@@ -386,41 +437,126 @@ bool ts::hls::InputPlugin::openURL(WebRequest& request)
         tsp->aborting();
 
     // If there is only one or zero remaining segment, try to reload the playlist.
-    if (!completed && _playlist.segmentCount() < 2 && _playlist.isUpdatable()) {
-
-        // Reload the playlist, ignore errors, continue to play next segments.
-        _playlist.reload(false, webArgs, *this);
-
-        // If the playlist is still empty, this means that we have read all segments before the server
-        // could produce new segments. For live streams, this is possible because new segments
-        // can be produced as late as the estimated end time of the previous playlist. So, we retry
-        // at regular intervals until we get new segments.
-
-        while (_playlist.segmentCount() == 0 && Time::CurrentUTC() <= _playlist.terminationUTC() && !tsp->aborting()) {
-            // The wait between two retries is half the target duration of a segment, with a minimum of 2 seconds.
-            std::this_thread::sleep_for(std::max(cn::seconds(2), _playlist.targetDuration() / 2));
-            // This time, we stop on reload error.
-            if (!_playlist.reload(false, webArgs, *this)) {
-                break;
+    if (!_completed && _playlist.segmentCount() < 2 && _playlist.isUpdatable()) {
+
+        // The wait between two reloads is half the target duration of a segment, with a minimum of 2 seconds.
+        const cn::milliseconds interval(std::max<cn::milliseconds>(cn::seconds(2), _playlist.targetDuration() / 2));
+
+        if (wait) {
+            // Reload the playlist, ignore errors, continue to play next segments.
+            _playlist.reload(false, webArgs, *this);
+
+            // If the playlist is still empty, this means that we have read all segments before the server
+            // could produce new segments. For live streams, this is possible because new segments
+            // can be produced as late as the estimated end time of the previous playlist. So, we retry
+            // at regular intervals until we get new segments.
+
+            while (_playlist.segmentCount() == 0 && Time::CurrentUTC() <= _playlist.terminationUTC() && !tsp->aborting()) {
+                std::this_thread::sleep_for(interval);
+                // This time, we stop on reload error.
+                if (!_playlist.reload(false, webArgs, *this)) {
+                    break;
+                }
             }
-        }
 
-        // End of playlist if we cannot find new segments.
-        completed = _playlist.segmentCount() == 0;
+            // End of playlist if we cannot find new segments.
+            _completed = _playlist.segmentCount() == 0;
+        }
+        else if (Time::CurrentUTC() >= _nextReload) {
+            // Prefetch mode while segments are pending: reload without waiting, not too often.
+            _playlist.reload(false, webArgs, *this);
+            _nextReload = Time::CurrentUTC() + interval;
+            _completed = _playlist.segmentCount() == 0 && Time::CurrentUTC() > _playlist.terminationUTC();
+        }
     }
 
-    if (completed) {
-        verbose(u"HLS playlist completed");
+    // A static playlist is completed when all segments are played.
+    _completed = _completed || (_playlist.segmentCount() == 0 && !_playlist.isUpdatable());
+
+    if (_completed || _playlist.segmentCount() == 0) {
         return false;
     }
 
     // Remove first segment from the playlist.
-    hls::MediaSegment seg;
     _playlist.popFirstSegment(seg);
     _segmentCount++;
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Called by AbstractHTTPInputPlugin to open an URL.
+//----------------------------------------------------------------------------
+
+bool ts::hls::InputPlugin::openURL(WebRequest& request)
+{
+    hls::MediaSegment seg;
+    if (!nextSegment(seg, true)) {
+        verbose(u"HLS playlist completed");
+        return false;
+    }
 
     // Open the segment.
     debug(u"downloading segment %s", seg.urlString());
     request.enableCookies(webArgs.cookiesFile);
     return request.open(seg.urlString());
 }
+
+
+//----------------------------------------------------------------------------
+// Submit next media segments to the prefetcher.
+//----------------------------------------------------------------------------
+
+void ts::hls::InputPlugin::feedPrefetcher()
+{
+    hls::MediaSegment seg;
+    while (_prefetcher.needMore() && nextSegment(seg, _prefetcher.pendingSegments() == 0)) {
+        _prefetcher.addSegment(seg.urlString());
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Input method
+//----------------------------------------------------------------------------
+
+size_t ts::hls::InputPlugin::receive(TSPacket* buffer, TSPacketMetadata* metadata, size_t maxPackets)
+{
+    // Without prefetch, use the superclass, one segment at a time.
+    if (_prefetch == 0) {
+        return AbstractHTTPInputPlugin::receive(buffer, metadata, maxPackets);
+    }
+
+    for (;;) {
+        // Return packets from the current segment, if there are some.
+        const size_t count = std::min(maxPackets, (_data.size() - _dataIndex) / PKT_SIZE);
+        if (count > 0) {
+            MemCopy(buffer, _data.data() + _dataIndex, count * PKT_SIZE);
+            _dataIndex += count * PKT_SIZE;
+            return count;
+        }
+
+        // Submit more segments when possible.
+        feedPrefetcher();
+        if (_prefetcher.pendingSegments() == 0) {
+            verbose(u"HLS playlist completed");
+            return 0;
+        }
+
+        // Get the next segment, in the order of the playlist. A trailing partial packet is dropped.
+        UString url;
+        _dataIndex = 0;
+        if (!_prefetcher.getSegment(_data, url)) {
+            return 0;
+        }
+        verbose(u"downloaded %s, %'d bytes, %d segments in queue", url, _data.size(), _prefetcher.readySegments());
+
+        // Save the segment when necessary. Display errors but do not fail, this is just auto save.
+        const UString name(BaseName(URL(url).getPath()));
+        if (!_saveDirectory.empty() && !name.empty()) {
+            const UString path(_saveDirectory + fs::path::preferred_separator + name);
+            verbose(u"saving input TS to %s", path);
+            _data.saveToFile(path, this);
+        }
+    }
+}
@@ -14,6 +14,7 @@
 #pragma once
 #include "tsAbstractHTTPInputPlugin.h"
 #include "tshlsPlayList.h"
+#include "tshlsSegmentPrefetcher.h"
 #include "tsURL.h"
 
 namespace ts {
@@ -34,6 +35,8 @@ namespace ts {
             virtual bool start() override;
             virtual bool stop() override;
             virtual bool isRealTime() override;
+            virtual bool abortInput() override;
+            virtual size_t receive(TSPacket*, TSPacketMetadata*, size_t) override;
 
         protected:
             // Implementation of AbstractHTTPInputPlugin
@@ -60,10 +63,29 @@ namespace ts {
             UString  _altName {};
             UString  _altGroupId {};
             UString  _altLanguage {};
+            size_t   _prefetch = 0;
+            UString  _saveDirectory {};
 
             // Working data:
             size_t   _segmentCount = 0;
+            bool     _completed = false;
+            Time     _nextReload {};
             PlayList _playlist {};
+
+            // Working data in prefetch mode:
+            SegmentPrefetcher _prefetcher {*this};
+            ByteBlock _data {};               // Content of current media segment.
+            size_t    _dataIndex = 0;         // Index of next packet in _data.
+
+            // Get the next media segment to play. Return false if none is available.
+            // When wait is false, the playlist is reloaded at most once per retry interval, without waiting.
+            bool nextSegment(MediaSegment& seg, bool wait);
+
+            // Submit next media segments to the prefetcher, wait for the playlist only when nothing is pending.
+            void feedPrefetcher();
+
+            // Delete the cookies file which is shared by all Web requests.
+            bool deleteSharedCookiesFile();
         };
     }
 }
@@ -10,6 +10,8 @@
 #include "tsPluginRepository.h"
 #include "tsOneShotPacketizer.h"
 #include "tsErrCodeReport.h"
+#include "tsFileUtils.h"
+#include "tsTSFile.h"
 #include "tsPESPacket.h"
 #include "tsPAT.h"
 #include "tsPMT.h"
@@ -35,7 +37,9 @@ ts::hls::OutputPlugin::OutputPlugin(TSP* tsp_) :
          u"If the specified template already contains trailing digits, this unmodified "
          u"name is used for the first segment. Then, the integer part is incremented. "
          u"Example: if the specified file name is foo-027.ts, the various segment files "
-         u"are named foo-027.ts, foo-028.ts, etc.");
+         u"are named foo-027.ts, foo-028.ts, etc.\n\n"
+         u"Each media segment is built in memory and written in its file by a background thread "
+         u"when it is complete. Therefore, the memory usage is up to twice the size of a segment.");
 
     option(u"align-first-segment", 'a');
     help(u"align-first-segment",
@@ -69,6 +73,15 @@ ts::hls::OutputPlugin::OutputPlugin(TSP* tsp_) :
          u"When --fixed-segment-size is specified, the --duration parameter is only "
          u"used as a hint in the playlist file.");
 
+    option(u"http-server", 0, IPSOCKADDR_OA);
+    help(u"http-server", u"[address:]port",
+         u"With --live, keep the media segments and the playlist in memory only and serve them using a "
+         u"built-in minimal HTTP server. No file is created. The directory parts of the segment file name "
+         u"template and of the --playlist file name are ignored. Their base names are used as resource names, "
+         u"for instance http://server:port/playlist.m3u8. Option --playlist is required. "
+         u"When present, the optional address shall specify a local IP address or host name. "
+         u"By default, the server listens on all local interfaces.");
+
     option(u"intra-close", 'i');
     help(u"intra-close",
          u"Start new segments on the start of an intra-coded image (I-Frame) of the reference video PID. "
@@ -106,6 +119,10 @@ ts::hls::OutputPlugin::OutputPlugin(TSP* tsp_) :
          u"The default is to wait a maximum of an additional " + UString::Chrono(DEFAULT_EXTRA_DURATION) + u" "
          u"for an intra-coded image.");
 
+    option(u"no-reuse-port");
+    help(u"no-reuse-port",
+         u"With --http-server, disable the reuse port socket option. Do not use unless completely necessary.");
+
     option(u"no-bitrate");
     help(u"no-bitrate",
          u"With --playlist, do not specify EXT-X-BITRATE tags for each segment in the playlist. "
@@ -161,6 +178,8 @@ bool ts::hls::OutputPlugin::getOptions()
     getIntValue(_initialMediaSeq, u"start-media-sequence", 0);
     getIntValues(_closeLabels, u"label-close");
     getValues(_customTags, u"custom-tag");
+    getSocketValue(_serverAddress, u"http-server");
+    _reusePort = !present(u"no-reuse-port");
 
     if (present(u"event")) {
         _playlistType = hls::PlayListType::EVENT;
@@ -186,6 +205,11 @@ bool ts::hls::OutputPlugin::getOptions()
         return false;
     }
 
+    if (_serverAddress.hasPort() && (_liveDepth == 0 || _playlistFile.empty())) {
+        error(u"option --http-server requires --live and --playlist");
+        return false;
+    }
+
     return true;
 }
 
@@ -221,14 +245,29 @@ bool ts::hls::OutputPlugin::start()
     _liveSegmentFiles.clear();
     _segStarted = false;
     _segClosePending = false;
-    if (_segmentFile.isOpen()) {
-        _segmentFile.close(*this);
-    }
+    _segmentName.clear();
+    _segmentData.clear();
     if (!_playlistFile.empty()) {
-        _playlist.reset(_playlistType, _playlistFile);
+        // With the HTTP server, the playlist and the segments are in the same virtual directory.
+        _playlist.reset(_playlistType, _serverAddress.hasPort() ? fs::path(_playlistFile.filename()) : _playlistFile);
         _playlist.setTargetDuration(_targetDuration, *this);
         _playlist.setMediaSequence(_initialMediaSeq, *this);
     }
+
+    // Start the HTTP server when segments are kept in memory.
+    if (_serverAddress.hasPort() && !_server.start(_serverAddress, _reusePort)) {
+        return false;
+    }
+
+    // Start the writer thread.
+    _hasPending = false;
+    _writerTerminate = false;
+    _writerError = false;
+    if (!_writer.start()) {
+        error(u"cannot start segment writer thread");
+        _server.stop();
+        return false;
+    }
     return true;
 }
 
@@ -239,8 +278,72 @@ bool ts::hls::OutputPlugin::start()
 
 bool ts::hls::OutputPlugin::stop()
 {
-    // Simply close the current segment (and generate the corresponding playlist).
-    return closeCurrentSegment(true);
+    // Close the current segment, wait for the corresponding playlist to be generated.
+    const bool ok = closeCurrentSegment(true);
+    stopWriter();
+    _server.stop();
+    return ok && !_writerError;
+}
+
+
+//----------------------------------------------------------------------------
+// Terminate the writer thread, after processing the pending segment.
+//----------------------------------------------------------------------------
+
+void ts::hls::OutputPlugin::stopWriter()
+{
+    {
+        std::lock_guard<std::mutex> lock(_writerMutex);
+        _writerTerminate = true;
+    }
+    _writerCondition.notify_all();
+    _writer.waitForTermination();
+}
+
+
+//----------------------------------------------------------------------------
+// Writer thread.
+//----------------------------------------------------------------------------
+
+ts::hls::OutputPlugin::Writer::Writer(OutputPlugin* plugin) :
+    _plugin(plugin)
+{
+}
+
+ts::hls::OutputPlugin::Writer::~Writer()
+{
+    waitForTermination();
+}
+
+void ts::hls::OutputPlugin::Writer::main()
+{
+    _plugin->debug(u"segment writer thread started");
+
+    for (;;) {
+        // Wait for a completed segment.
+        {
+            std::unique_lock<std::mutex> lock(_plugin->_writerMutex);
+            _plugin->_writerCondition.wait(lock, [this]() { return _plugin->_hasPending || _plugin->_writerTerminate; });
+            if (!_plugin->_hasPending) {
+                break;
+            }
+        }
+
+        // Process the segment outside the lock, the plugin thread does not access it.
+        if (!_plugin->writeSegment(_plugin->_pending)) {
+            _plugin->_writerError = true;
+        }
+
+        // Release the segment buffer.
+        {
+            std::lock_guard<std::mutex> lock(_plugin->_writerMutex);
+            _plugin->_pending.data.clear();
+            _plugin->_hasPending = false;
+        }
+        _plugin->_writerCondition.notify_all();
+    }
+
+    _plugin->debug(u"segment writer thread completed");
 }
 
 
@@ -255,14 +358,9 @@ bool ts::hls::OutputPlugin::createNextSegment()
         return false;
     }
 
-    // Generate a new segment file name.
-    const UString fileName(_nameGenerator.newFileName());
-
-    // Create the segment file.
-    verbose(u"creating media segment %s", fileName);
-    if (!_segmentFile.open(fileName, TSFile::WRITE | TSFile::SHARED, *this)) {
-        return false;
-    }
+    // Generate a new segment file name. The segment is built in memory.
+    _segmentName = _nameGenerator.newFileName();
+    verbose(u"creating media segment %s", _segmentName);
 
     // Reset the PCR analysis in each segment to get to bitrate of this segment.
     _pcrAnalyzer.reset();
@@ -280,24 +378,88 @@ bool ts::hls::OutputPlugin::createNextSegment()
 
 
 //----------------------------------------------------------------------------
-// Close current segment file.
-// Also purge obsolete segment files and regenerate playlist.
+// Close current segment and pass it to the writer thread.
 //----------------------------------------------------------------------------
 
 bool ts::hls::OutputPlugin::closeCurrentSegment(bool endOfStream)
 {
-    // If no segment file is open, there is nothing to do.
-    if (!_segmentFile.isOpen()) {
+    // If no segment is started, there is nothing to do.
+    if (_segmentName.empty()) {
         return true;
     }
 
-    // Get the segment file name and size (to be inserted in the playlist).
-    const UString segName(_segmentFile.getFileName());
-    const PacketCounter segPackets = _segmentFile.writePacketsCount();
+    // Estimate duration and bitrate of the segment. We use PCR's from the
+    // segment to compute the average bitrate. Then we compute the duration
+    // from the bitrate and segment file size. If we cannot get the bitrate
+    // of a segment but got one from previous segment, assume that bitrate
+    // did not change and reuse previous one.
+    const size_t segSize = _segmentData.size();
+    const PacketCounter segPackets = segSize / PKT_SIZE;
+    cn::milliseconds duration {};
+    BitRate bitrate = 0;
+    if (_pcrAnalyzer.bitrateIsValid()) {
+        // We have an estimation of the bitrate of the segment file.
+        _previousBitrate = _pcrAnalyzer.bitrate188();
+    }
+    if (_previousBitrate > 0) {
+        // Compute duration based on segment bitrate (or previous one).
+        bitrate = _useBitrateTag ? _previousBitrate : 0;
+        duration = PacketInterval(_previousBitrate, segPackets);
+    }
+    else {
+        // Completely unknown bitrate, we build a fake one based on the target duration.
+        duration = cn::duration_cast<cn::milliseconds>(_targetDuration);
+        bitrate = _useBitrateTag ? PacketBitRate(segPackets, duration) : 0;
+    }
 
-    // Close the TS file.
-    if (!_segmentFile.close(*this)) {
-        return false;
+    // Wait for the writer thread to complete the previous segment and pass this one.
+    {
+        std::unique_lock<std::mutex> lock(_writerMutex);
+        _writerCondition.wait(lock, [this]() { return !_hasPending || _writerError; });
+        if (_writerError) {
+            return false;
+        }
+        _pending.name = _segmentName;
+        _pending.duration = duration;
+        _pending.bitrate = bitrate;
+        _pending.endOfStream = endOfStream;
+        // Swap buffers: the next segment reuses the buffer of the previous one.
+        _pending.data.swap(_segmentData);
+        _hasPending = true;
+    }
+    _writerCondition.notify_all();
+
+    // Avoid reallocations while filling the next segment.
+    _segmentName.clear();
+    _segmentData.clear();
+    _segmentData.reserve(segSize);
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Executed in the writer thread: write a completed segment.
+// Also purge obsolete segment files and regenerate playlist.
+//----------------------------------------------------------------------------
+
+bool ts::hls::OutputPlugin::writeSegment(Segment& segment)
+{
+    const bool inMemory = _serverAddress.hasPort();
+    const UString segName(inMemory ? UString(fs::path(segment.name).filename()) : segment.name);
+
+    if (inMemory) {
+        // Make the segment available in the HTTP server.
+        _server.setFile(segName, std::make_shared<const ByteBlock>(std::move(segment.data)), u"video/mp2t");
+    }
+    else {
+        // Write the segment file.
+        TSFile file;
+        if (!file.open(segName, TSFile::WRITE | TSFile::SHARED, *this) ||
+            !file.writePackets(reinterpret_cast<const TSPacket*>(segment.data.data()), nullptr, segment.data.size() / PKT_SIZE, *this) ||
+            !file.close(*this))
+        {
+            return false;
+        }
     }
 
     // On live streams, we need to maintain a list of active segments.
@@ -309,31 +471,13 @@ bool ts::hls::OutputPlugin::closeCurrentSegment(bool endOfStream)
     if (!_playlistFile.empty()) {
 
         // Set end of stream indicator in the playlist.
-        _playlist.setEndList(endOfStream, *this);
+        _playlist.setEndList(segment.endOfStream, *this);
 
         // Declare a new segment.
         hls::MediaSegment seg;
         _playlist.buildURL(seg, segName);
-
-        // Estimate duration and bitrate of the segment. We use PCR's from the
-        // segment to compute the average bitrate. Then we compute the duration
-        // from the bitrate and segment file size. If we cannot get the bitrate
-        // of a segment but got one from previous segment, assume that bitrate
-        // did not change and reuse previous one.
-        if (_pcrAnalyzer.bitrateIsValid()) {
-            // We have an estimation of the bitrate of the segment file.
-            _previousBitrate = _pcrAnalyzer.bitrate188();
-        }
-        if (_previousBitrate > 0) {
-            // Compute duration based on segment bitrate (or previous one).
-            seg.bitrate = _useBitrateTag ? _previousBitrate : 0;
-            seg.duration = PacketInterval(_previousBitrate, segPackets);
-        }
-        else {
-            // Completely unknown bitrate, we build a fake one based on the target duration.
-            seg.duration = cn::duration_cast<cn::milliseconds>(_targetDuration);
-            seg.bitrate = _useBitrateTag ? PacketBitRate(segPackets, seg.duration) : 0;
-        }
+        seg.bitrate = segment.bitrate;
+        seg.duration = segment.duration;
         _playlist.addSegment(seg, *this);
 
         // With live playlists, remove obsolete segments from the playlist.
@@ -352,8 +496,14 @@ bool ts::hls::OutputPlugin::closeCurrentSegment(bool endOfStream)
             _playlist.addCustomTag(u"EXT-X-INDEPENDENT-SEGMENTS");
         }
 
-        // Write the playlist file.
-        if (!_playlist.saveFile(UString(), *this)) {
+        if (inMemory) {
+            // Replace the playlist in the HTTP server.
+            auto text = std::make_shared<ByteBlock>();
+            text->appendUTF8(_playlist.textContent(*this));
+            _server.setFile(UString(_playlistFile.filename()), text, u"application/vnd.apple.mpegurl");
+        }
+        else if (!_playlist.saveFile(UString(), *this)) {
+            // Write the playlist file.
             return false;
         }
 
@@ -376,10 +526,16 @@ bool ts::hls::OutputPlugin::closeCurrentSegment(bool endOfStream)
         _liveSegmentFiles.pop_front();
 
         // Delete the segment file.
-        verbose(u"deleting obsolete segment file %s", name);
-        if (!fs::remove(name, &ErrCodeReport(*this, u"error deleting", name)) && fs::exists(name)) {
-            // Failed to delete, keep it to retry later.
-            failedDelete.push_back(name);
+        if (inMemory) {
+            debug(u"deleting obsolete segment %s", name);
+            _server.removeFile(name);
+        }
+        else {
+            verbose(u"deleting obsolete segment file %s", name);
+            if (!fs::remove(name, &ErrCodeReport(*this, u"error deleting", name)) && fs::exists(name)) {
+                // Failed to delete, keep it to retry later.
+                failedDelete.push_back(name);
+            }
         }
     }
 
@@ -448,7 +604,7 @@ void ts::hls::OutputPlugin::handleTable(SectionDemux& demux, const BinaryTable&
 
 
 //----------------------------------------------------------------------------
-// Write packets into the current segment file, adjust CC in PAT and PMT PID.
+// Write packets into the current segment, adjust CC in PAT and PMT PID.
 //----------------------------------------------------------------------------
 
 bool ts::hls::OutputPlugin::writePackets(const TSPacket* pkt, size_t packetCount)
@@ -477,12 +633,10 @@ bool ts::hls::OutputPlugin::writePackets(const TSPacket* pkt, size_t packetCount
             }
         }
 
-        // Write the packet in the segment file.
-        if (!_segmentFile.writePackets(p, nullptr, 1, *this)) {
-            return false;
-        }
+        // Append the packet in the segment.
+        _segmentData.append(p->b, PKT_SIZE);
     }
-    return true;
+    return !_writerError;
 }
 
 
@@ -531,7 +685,7 @@ bool ts::hls::OutputPlugin::send(const TSPacket* pkt, const TSPacketMetadata* pk
             bool renewOnPUSI = false;
             if (_fixedSegmentSize > 0) {
                 // Each segment shall have a fixed size.
-                renewNow = _segmentFile.writePacketsCount() >= _fixedSegmentSize;
+                renewNow = _segmentData.size() / PKT_SIZE >= _fixedSegmentSize;
             }
             else if (!_segClosePending) {
                 if (pktData->hasAnyLabel(_closeLabels)) {
@@ -540,7 +694,7 @@ bool ts::hls::OutputPlugin::send(const TSPacket* pkt, const TSPacketMetadata* pk
                 }
                 else if (_pcrAnalyzer.bitrateIsValid()) {
                     // The segment file shall be closed when the estimated duration exceeds the target duration.
-                    const cn::milliseconds segDuration = PacketInterval(_pcrAnalyzer.bitrate188(), _segmentFile.writePacketsCount());
+                    const cn::milliseconds segDuration = PacketInterval(_pcrAnalyzer.bitrate188(), _segmentData.size() / PKT_SIZE);
                     _segClosePending = segDuration >= _targetDuration;
                     // With --intra-close, force renew on next PES packet if extra duration is exceeded.
                     renewOnPUSI = segDuration >= _targetDuration + _maxExtraDuration;
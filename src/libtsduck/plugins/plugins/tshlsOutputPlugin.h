@@ -18,7 +18,9 @@
 #include "tsPCRAnalyzer.h"
 #include "tsContinuityAnalyzer.h"
 #include "tsFileNameGenerator.h"
+#include "tsIPv4SocketAddress.h"
 #include "tshlsPlayList.h"
+#include "tshlsOriginServer.h"
 
 namespace ts {
     namespace hls {
@@ -26,10 +28,19 @@ namespace ts {
         //! HTTP Live Streaming (HLS) output plugin for tsp.
         //! @ingroup plugin
         //!
-        //! The output plugin generates playlists and media segments on local files
-        //! only. It can also purge obsolete media segments and regenerate live
-        //! playlists. To setup a complete HLS server, it is necessary to setup an
-        //! external HTTP server such as Apache which simply serves these files.
+        //! The output plugin generates playlists and media segments on local files.
+        //! It can also purge obsolete media segments and regenerate live playlists.
+        //! To setup a complete HLS server, it is necessary to setup an external HTTP
+        //! server such as Apache which simply serves these files.
+        //!
+        //! Media segments are built in memory. Completed segments are written, and the
+        //! playlist is regenerated, in a background thread, so that segment rotation
+        //! does not stall the packet processing. This is also true when the segments are
+        //! written in files: up to two complete segments are held in memory, the one which
+        //! is being written and the one which is being filled.
+        //!
+        //! Alternatively, in live streams, the segments and the playlist can be kept in
+        //! memory only and served by a built-in minimal HTTP server.
         //!
         class TSDUCKDLL OutputPlugin: public ts::OutputPlugin, private TableHandlerInterface
         {
@@ -59,6 +70,8 @@ namespace ts {
             size_t             _initialMediaSeq = 0;        // Initial media sequence value.
             UStringVector      _customTags {};              // Additional custom tags.
             TSPacketLabelSet   _closeLabels {};             // Close segment on packets with any of these labels.
+            IPv4SocketAddress  _serverAddress {};           // Built-in HTTP server, segments in memory only.
+            bool               _reusePort = true;           // Reuse port option on HTTP server.
 
             // Working data.
             FileNameGenerator  _nameGenerator {};           // Generate the segment file names.
@@ -70,13 +83,51 @@ namespace ts {
             uint8_t            _videoStreamType = ST_NULL;  // Stream type for video PID in PMT.
             bool               _segStarted = false;         // Generation of output segments has started.
             bool               _segClosePending = false;    // Close the current segment when possible.
-            TSFile             _segmentFile {};             // Output segment file.
-            UStringList        _liveSegmentFiles {};        // List of current segments in a live stream.
-            hls::PlayList      _playlist {};                // Generated playlist.
+            UString            _segmentName {};             // Name of current segment, empty if none is started.
+            ByteBlock          _segmentData {};             // Content of current segment.
             PCRAnalyzer        _pcrAnalyzer {1, 4};         // PCR analyzer to compute bitrates. Minimum required: 1 PID, 4 PCR.
             BitRate            _previousBitrate = 0;        // Bitrate of previous segment.
             ContinuityAnalyzer _ccFixer;                    // To fix continuity counters in PAT and PMT PID's.
 
+            // Working data of the writer thread.
+            UStringList        _liveSegmentFiles {};        // List of current segments in a live stream.
+            hls::PlayList      _playlist {};                // Generated playlist.
+            hls::OriginServer  _server {*this};             // Built-in HTTP server.
+
+            // A completed segment, passed to the writer thread.
+            class Segment
+            {
+            public:
+                Segment() = default;
+                UString          name {};                   // Segment file name.
+                ByteBlock        data {};                   // Segment content.
+                cn::milliseconds duration {};               // Estimated segment duration.
+                BitRate          bitrate = 0;               // Segment bitrate in playlist, zero if none.
+                bool             endOfStream = false;       // Last segment in the stream.
+            };
+
+            // The writer thread. Completed segments are double-buffered: while the writer thread processes
+            // one completed segment, the plugin thread fills the next one.
+            class Writer : public Thread
+            {
+                TS_NOBUILD_NOCOPY(Writer);
+            public:
+                Writer(OutputPlugin* plugin);
+                virtual ~Writer() override;
+            protected:
+                virtual void main() override;
+            private:
+                OutputPlugin* _plugin;
+            };
+
+            std::mutex              _writerMutex {};
+            std::condition_variable _writerCondition {};    // Signaled when _pending or _writerTerminate change.
+            Segment                 _pending {};            // Completed segment, being processed by the writer thread.
+            bool                    _hasPending = false;    // _pending contains a segment.
+            bool                    _writerTerminate = false;
+            volatile bool           _writerError = false;   // Error in the writer thread, stop the stream.
+            Writer                  _writer {this};         // Must be declared last, terminated first.
+
             static constexpr cn::seconds DEFAULT_OUT_DURATION      = cn::seconds(10); // Default segment target duration for output streams.
             static constexpr cn::seconds DEFAULT_OUT_LIVE_DURATION = cn::seconds(5);  // Default segment target duration for output live streams.
             static constexpr cn::seconds DEFAULT_EXTRA_DURATION    = cn::seconds(2);  // Default segment extra duration when intra image is not found.
@@ -85,13 +136,19 @@ namespace ts {
             // Create the next segment file (also close the previous one if necessary).
             bool createNextSegment();
 
-            // Close current segment file (also purge obsolete segment files and regenerate playlist).
+            // Close current segment file and pass it to the writer thread.
             bool closeCurrentSegment(bool endOfStream);
 
+            // Executed in the writer thread: write a completed segment, purge obsolete segment files and regenerate the playlist.
+            bool writeSegment(Segment& seg);
+
+            // Terminate the writer thread, after processing the pending segment.
+            void stopWriter();
+
             // Implementation of TableHandlerInterface.
             virtual void handleTable(SectionDemux&, const BinaryTable&) override;
 
-            // Write packets into the current segment file, adjust CC in PAT and PMT PID.
+            // Write packets into the current segment, adjust CC in PAT and PMT PID.
             bool writePackets(const TSPacket*, size_t);
         };
     }
@@ -12,6 +12,8 @@
 #include "tsReportBuffer.h"
 #include "tsTelnetConnection.h"
 #include "tsSysUtils.h"
+#include "tsjsonObject.h"
+#include "tsjsonArray.h"
 
 
 //----------------------------------------------------------------------------
@@ -49,6 +51,7 @@ ts::tsp::ControlServer::ControlServer(TSProcessorArgs& options, Report& log, std
     _reference.setCommandLineHandler(this, &ControlServer::executeSuspend, u"suspend");
     _reference.setCommandLineHandler(this, &ControlServer::executeResume, u"resume");
     _reference.setCommandLineHandler(this, &ControlServer::executeRestart, u"restart");
+    _reference.setCommandLineHandler(this, &ControlServer::executeProfile, u"profile");
 }
 
 ts::tsp::ControlServer::~ControlServer()
@@ -319,3 +322,52 @@ ts::CommandStatus ts::tsp::ControlServer::executeRestart(const UString& command,
     }
     return CommandStatus::SUCCESS;
 }
+
+
+//----------------------------------------------------------------------------
+// Profile command.
+//----------------------------------------------------------------------------
+
+ts::CommandStatus ts::tsp::ControlServer::executeProfile(const UString& command, Args& args)
+{
+    if (!_options.profile) {
+        args.error(u"tsp was not started with option --profile");
+        return CommandStatus::ERROR;
+    }
+
+    // Select all plugins or just one.
+    std::vector<PluginExecutor*> selected;
+    if (args.present(u"")) {
+        const size_t index = args.intValue<size_t>(u"");
+        if (index == 0) {
+            selected.push_back(_input);
+        }
+        else if (index <= _plugins.size()) {
+            selected.push_back(_plugins[index-1]);
+        }
+        else if (index == _plugins.size() + 1) {
+            selected.push_back(_output);
+        }
+        else {
+            args.error(u"invalid plugin index %d, specify 0 to %d", index, _plugins.size() + 1);
+            return CommandStatus::ERROR;
+        }
+    }
+    else {
+        selected.push_back(_input);
+        selected.insert(selected.end(), _plugins.begin(), _plugins.end());
+        selected.push_back(_output);
+    }
+
+    json::ValuePtr root(new json::Object);
+    json::ValuePtr plugins(new json::Array);
+    for (auto proc : selected) {
+        plugins->set(proc->getProfile());
+        if (args.present(u"reset")) {
+            proc->resetProfile();
+        }
+    }
+    root->add(u"plugins", plugins);
+    args.info(root->printed(2, args));
+    return CommandStatus::SUCCESS;
+}
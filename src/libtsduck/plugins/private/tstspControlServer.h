@@ -80,6 +80,7 @@ namespace ts {
             CommandStatus executeResume(const UString&, Args&);
             CommandStatus executeSuspendResume(bool state, Args&);
             CommandStatus executeRestart(const UString&, Args&);
+            CommandStatus executeProfile(const UString&, Args&);
         };
     }
 }
@@ -8,6 +8,7 @@
 
 #include "tstspPluginExecutor.h"
 #include "tsPluginRepository.h"
+#include "tsjsonObject.h"
 
 
 //----------------------------------------------------------------------------
@@ -59,6 +60,29 @@ void ts::tsp::PluginExecutor::signalPluginEvent(uint32_t event_code, Object* plu
 }
 
 
+//----------------------------------------------------------------------------
+// Next and previous executors in the ring, skipping fused plugins.
+//----------------------------------------------------------------------------
+
+ts::tsp::PluginExecutor* ts::tsp::PluginExecutor::nextExecutor()
+{
+    PluginExecutor* next = ringNext<PluginExecutor>();
+    while (next != nullptr && next->_fusion_leader != nullptr) {
+        next = next->ringNext<PluginExecutor>();
+    }
+    return next;
+}
+
+ts::tsp::PluginExecutor* ts::tsp::PluginExecutor::previousExecutor()
+{
+    PluginExecutor* prev = ringPrevious<PluginExecutor>();
+    while (prev != nullptr && prev->_fusion_leader != nullptr) {
+        prev = prev->ringPrevious<PluginExecutor>();
+    }
+    return prev;
+}
+
+
 //----------------------------------------------------------------------------
 // This method sets the current processor in an abort state.
 //----------------------------------------------------------------------------
@@ -67,7 +91,13 @@ void ts::tsp::PluginExecutor::setAbort()
 {
     std::lock_guard<std::recursive_mutex> lock(_global_mutex);
     _tsp_aborting = true;
-    ringPrevious<PluginExecutor>()->_to_do.notify_one();
+    if (_fusion_leader != nullptr) {
+        // Aborting a fused plugin aborts the thread which executes it.
+        _fusion_leader->setAbort();
+    }
+    else {
+        previousExecutor()->notifyWork(true);
+    }
 }
 
 
@@ -105,6 +135,11 @@ void ts::tsp::PluginExecutor::initBuffer(PacketBuffer*         buffer,
     _tsp_aborting = aborted;
     _bitrate = bitrate;
     _br_confidence = br_confidence;
+    _lf_bitrate_set = false;
+    _lf_bitrate = bitrate;
+    _lf_br_confidence = br_confidence;
+    _lf_next_bitrate = bitrate;
+    _lf_next_br_confidence = br_confidence;
     _tsp_bitrate = bitrate;
     _tsp_bitrate_confidence = br_confidence;
 }
@@ -120,15 +155,28 @@ bool ts::tsp::PluginExecutor::passPackets(size_t count, const BitRate& bitrate,
 
     log(10, u"passPackets(count = %'d, bitrate = %'d, input_end = %s, aborted = %s)", count, bitrate, input_end, aborted);
 
+    // The next processor receives the packets. It always exists in a properly built chain of
+    // plugins. Otherwise, stop the current processor instead of dereferencing a null pointer.
+    PluginExecutor* const next = nextExecutor();
+    if (next == nullptr) {
+        error(u"internal error, no next plugin in the processing chain");
+        _tsp_aborting = true;
+        return false;
+    }
+
+    if (_options.lock_free_handoff) {
+        return passPacketsLockFree(next, count, bitrate, br_confidence, input_end, aborted);
+    }
+
     // We access data under the protection of the global mutex.
-    std::lock_guard<std::recursive_mutex> lock(_global_mutex);
+    std::unique_lock<std::recursive_mutex> lock(_global_mutex, std::defer_lock);
+    lockGlobal(lock);
 
     // Update our buffer: we remove the first 'count' packets from the beginning of our slice of the buffer.
     _pkt_first = (_pkt_first + count) % _buffer->count();
     _pkt_cnt -= count;
 
     // Update next processor's buffer: add 'count' packets at the end of its slice of the buffer.
-    PluginExecutor* next = ringNext<PluginExecutor>();
     next->_pkt_cnt += count;
 
     // Propagate bitrate and end of input flag to next processor.
@@ -138,7 +186,7 @@ bool ts::tsp::PluginExecutor::passPackets(size_t count, const BitRate& bitrate,
 
     // Wake the next processor when there is some new input data or end of input.
     if (count > 0 || input_end) {
-        next->_to_do.notify_one();
+        next->notifyWork(true);
     }
 
     // Force to abort our processor when the next one is aborting. Already done in waitWork() but force immediately.
@@ -150,7 +198,7 @@ bool ts::tsp::PluginExecutor::passPackets(size_t count, const BitRate& bitrate,
     // Wake the previous processor when we abort (propagate abort conditions backward).
     if (aborted) {
         _tsp_aborting = true; // volatile bool in TSP superclass
-        ringPrevious<PluginExecutor>()->_to_do.notify_one();
+        previousExecutor()->notifyWork(true);
     }
 
     // Return false when the current processor shall stop.
@@ -158,6 +206,76 @@ bool ts::tsp::PluginExecutor::passPackets(size_t count, const BitRate& bitrate,
 }
 
 
+//----------------------------------------------------------------------------
+// Signal that the specified number of packets have been processed.
+// Lock-free version: only the current and next plugins are involved.
+//----------------------------------------------------------------------------
+
+bool ts::tsp::PluginExecutor::passPacketsLockFree(PluginExecutor* next, size_t count, const BitRate& bitrate, BitRateConfidence br_confidence, bool input_end, bool aborted)
+{
+    // Remove the first 'count' packets from the beginning of our slice of the buffer.
+    // The previous plugin concurrently adds packets at the end of our slice.
+    _pkt_first = (_pkt_first + count) % _buffer->count();
+    _pkt_cnt -= count;
+
+    // Propagate the bitrate to next processor, only when it changed.
+    if (bitrate != _lf_next_bitrate || br_confidence != _lf_next_br_confidence) {
+        _lf_next_bitrate = bitrate;
+        _lf_next_br_confidence = br_confidence;
+        std::lock_guard<std::mutex> lock(next->_lf_mutex);
+        next->_bitrate = bitrate;
+        next->_br_confidence = br_confidence;
+        next->_lf_bitrate_set = true;
+    }
+
+    // Add 'count' packets at the end of the next processor's slice of the buffer.
+    // The atomic update publishes the content of the packets to the next thread.
+    // The end of input is set after the packets, see waitWork().
+    next->_pkt_cnt += count;
+    if (input_end) {
+        next->_input_end = true;
+    }
+
+    // Wake the next processor when there is some new input data or end of input, only if it waits.
+    if (count > 0 || input_end) {
+        next->notifyWork(false);
+    }
+
+    // Same abort propagation as with the global mutex.
+    if (plugin()->type() != PluginType::OUTPUT) {
+        aborted = aborted || next->_tsp_aborting;
+    }
+    if (aborted) {
+        _tsp_aborting = true;
+        previousExecutor()->notifyWork(true);
+    }
+
+    return !input_end && !aborted;
+}
+
+
+//----------------------------------------------------------------------------
+// Notify the plugin thread that there is something to do.
+//----------------------------------------------------------------------------
+
+void ts::tsp::PluginExecutor::notifyWork(bool always)
+{
+    // A fused plugin has no thread of its own, the thread of its leader executes it.
+    if (_fusion_leader != nullptr) {
+        _fusion_leader->notifyWork(always);
+    }
+    else if (!_options.lock_free_handoff) {
+        _to_do.notify_one();
+    }
+    else if (always || _lf_waiting) {
+        // The plugin thread sets _lf_waiting and checks its condition under _lf_mutex.
+        // Notifying under the same mutex guarantees that the notification is not lost.
+        std::lock_guard<std::mutex> lock(_lf_mutex);
+        _lf_cond.notify_one();
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Wait for packets to process or some error condition.
 //----------------------------------------------------------------------------
@@ -174,28 +292,72 @@ void ts::tsp::PluginExecutor::waitWork(size_t min_pkt_cnt, size_t& pkt_first, si
         min_pkt_cnt = _buffer->count();
     }
 
-    // We access data under the protection of the global mutex.
-    std::unique_lock<std::recursive_mutex> lock(_global_mutex);
-
-    PluginExecutor* next = ringNext<PluginExecutor>();
+    PluginExecutor* next = nextExecutor();
     timeout = false;
 
-    // Loop until enough packets are available (or some error condition).
-    while (_pkt_cnt < min_pkt_cnt && !_input_end && !timeout && !next->_tsp_aborting) {
-        // If packet area for this processor is empty, wait for some packet.
-        // The mutex is implicitely released, we wait for the condition
-        // '_to_do' and, once we get it, implicitely relock the mutex.
-        // We loop on this until packets are actually available.
-        // If there is a timeout in the packet reception, call the plugin handler.
-        if (_tsp_timeout.count() < 0) {
-            // No timeout.
-            _to_do.wait(lock);
+    // With --profile, the time since the end of previous waitWork() was spent in the plugin.
+    monotonic_time prof_start {};
+    if (_options.profile) {
+        prof_start = monotonic_time::clock::now();
+        if (_prof_reset) {
+            _prof_process.reset();
+            _prof_wait.reset();
+            _prof_lock.reset();
+            _prof_packets.reset();
+            _prof_occupancy.reset();
+            _prof_reset = false;
         }
-        else {
-            timeout = _to_do.wait_for(lock, _tsp_timeout) == std::cv_status::timeout && !plugin()->handlePacketTimeout();
+        else if (_prof_exit != monotonic_time()) {
+            _prof_process.add(cn::duration_cast<cn::nanoseconds>(prof_start - _prof_exit).count());
         }
     }
 
+    // Snapshot of our slice of the buffer.
+    size_t avail_cnt = 0;
+    bool avail_end = false;
+
+    if (_options.lock_free_handoff) {
+        waitWorkLockFree(min_pkt_cnt, timeout);
+        // Read the end of input before the packet count: the previous plugin sets the
+        // end of input after adding its last packets, they are included in the count.
+        avail_end = _input_end;
+        avail_cnt = _pkt_cnt;
+        if (_lf_bitrate_set) {
+            std::lock_guard<std::mutex> lock(_lf_mutex);
+            _lf_bitrate = _bitrate;
+            _lf_br_confidence = _br_confidence;
+            _lf_bitrate_set = false;
+        }
+        bitrate = _lf_bitrate;
+        br_confidence = _lf_br_confidence;
+    }
+    else {
+        // We access data under the protection of the global mutex.
+        std::unique_lock<std::recursive_mutex> lock(_global_mutex, std::defer_lock);
+        lockGlobal(lock);
+
+        // Loop until enough packets are available (or some error condition).
+        while (_pkt_cnt < min_pkt_cnt && !_input_end && !timeout && !next->_tsp_aborting) {
+            // If packet area for this processor is empty, wait for some packet.
+            // The mutex is implicitely released, we wait for the condition
+            // '_to_do' and, once we get it, implicitely relock the mutex.
+            // We loop on this until packets are actually available.
+            // If there is a timeout in the packet reception, call the plugin handler.
+            if (_tsp_timeout.count() < 0) {
+                // No timeout.
+                _to_do.wait(lock);
+            }
+            else {
+                timeout = _to_do.wait_for(lock, _tsp_timeout) == std::cv_status::timeout && !plugin()->handlePacketTimeout();
+            }
+        }
+
+        avail_end = _input_end;
+        avail_cnt = _pkt_cnt;
+        bitrate = _bitrate;
+        br_confidence = _br_confidence;
+    }
+
     // The number of returned packets is limited up to the wrap-up point of the circular buffer,
     // if allowed by the requested minimum number of packets.
     if (timeout) {
@@ -204,28 +366,125 @@ void ts::tsp::PluginExecutor::waitWork(size_t min_pkt_cnt, size_t& pkt_first, si
     }
     else if (_pkt_first + min_pkt_cnt <= _buffer->count()) {
         // Return up to the wrap-up point. This will satisfy the requested minimum.
-        pkt_cnt = std::min(_pkt_cnt, _buffer->count() - _pkt_first);
+        pkt_cnt = std::min(avail_cnt, _buffer->count() - _pkt_first);
     }
     else {
         // The requested minimum does not fit into a contiguous area.
-        pkt_cnt = _pkt_cnt;
+        pkt_cnt = avail_cnt;
     }
 
     pkt_first = _pkt_first;
-    bitrate = _bitrate;
-    br_confidence = _br_confidence;
-    input_end = _input_end && pkt_cnt == _pkt_cnt;
+    input_end = avail_end && pkt_cnt == avail_cnt;
 
     // Force to abort our processor when the next one is aborting.
     // Don't do that if current is output and next is input because
     // there is no propagation of packets from output back to input.
     aborted = plugin()->type() != PluginType::OUTPUT && next->_tsp_aborting;
 
+    if (_options.profile) {
+        _prof_exit = monotonic_time::clock::now();
+        _prof_wait.add(cn::duration_cast<cn::nanoseconds>(_prof_exit - prof_start).count());
+        _prof_packets.add(pkt_cnt);
+        _prof_occupancy.add(avail_cnt);
+    }
+
     log(10, u"waitWork(min_pkt_cnt = %'d, pkt_first = %'d, pkt_cnt = %'d, bitrate = %'d, input_end = %s, aborted = %s, timeout = %s)",
         min_pkt_cnt, pkt_first, pkt_cnt, bitrate, input_end, aborted, timeout);
 }
 
 
+//----------------------------------------------------------------------------
+// Wait for packets to process or some error condition, lock-free version.
+//----------------------------------------------------------------------------
+
+void ts::tsp::PluginExecutor::waitWorkLockFree(size_t min_pkt_cnt, bool& timeout)
+{
+    const PluginExecutor* next = nextExecutor();
+    const auto ready = [this, next, min_pkt_cnt]() { return _pkt_cnt >= min_pkt_cnt || _input_end || next->_tsp_aborting; };
+
+    // Most of the time, there is something to do and no lock is needed.
+    while (!timeout && !ready()) {
+        bool expired = false;
+        {
+            // Declare that we are about to wait, then check again: either the previous plugin sees
+            // _lf_waiting and notifies us under _lf_mutex or we see its update of _pkt_cnt.
+            std::unique_lock<std::mutex> lock(_lf_mutex);
+            _lf_waiting = true;
+            if (!ready()) {
+                if (_tsp_timeout.count() < 0) {
+                    _lf_cond.wait(lock);
+                }
+                else {
+                    expired = _lf_cond.wait_for(lock, _tsp_timeout) == std::cv_status::timeout;
+                }
+            }
+            _lf_waiting = false;
+        }
+        // Call the plugin handler outside the mutex.
+        timeout = expired && !plugin()->handlePacketTimeout();
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Lock the global mutex, record the lock wait time with --profile.
+//----------------------------------------------------------------------------
+
+void ts::tsp::PluginExecutor::lockGlobal(std::unique_lock<std::recursive_mutex>& lock)
+{
+    if (!_options.profile) {
+        lock.lock();
+    }
+    else if (lock.try_lock()) {
+        // Not contended.
+        _prof_lock.add(0);
+    }
+    else {
+        const monotonic_time start = monotonic_time::clock::now();
+        lock.lock();
+        _prof_lock.add(cn::duration_cast<cn::nanoseconds>(monotonic_time::clock::now() - start).count());
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Get the execution profile of the plugin.
+//----------------------------------------------------------------------------
+
+ts::json::ValuePtr ts::tsp::PluginExecutor::HistogramToJSON(const LogHistogram& hist)
+{
+    json::ValuePtr jv(new json::Object);
+    jv->add(u"count", hist.count());
+    jv->add(u"min", hist.minimum());
+    jv->add(u"max", hist.maximum());
+    jv->add(u"mean", hist.mean());
+    jv->add(u"p50", hist.percentile(50.0));
+    jv->add(u"p90", hist.percentile(90.0));
+    jv->add(u"p99", hist.percentile(99.0));
+    jv->add(u"p999", hist.percentile(99.9));
+    return jv;
+}
+
+ts::json::ValuePtr ts::tsp::PluginExecutor::getProfile() const
+{
+    json::ValuePtr jv(new json::Object);
+    jv->add(u"index", pluginIndex());
+    jv->add(u"name", pluginName());
+    jv->add(u"type", PluginTypeNames.name(int(plugin()->type())));
+    jv->add(u"packets", pluginPackets());
+    jv->add(u"suspended", json::Bool(_suspended));
+    if (_fusion_leader != nullptr) {
+        jv->add(u"fused-with", _fusion_leader->pluginIndex());
+    }
+    jv->add(u"plugin-time-ns", HistogramToJSON(_prof_process));
+    jv->add(u"wait-time-ns", HistogramToJSON(_prof_wait));
+    jv->add(u"lock-wait-ns", HistogramToJSON(_prof_lock));
+    jv->add(u"packets-per-call", HistogramToJSON(_prof_packets));
+    jv->add(u"buffer-occupancy", HistogramToJSON(_prof_occupancy));
+    return jv;
+}
+
+
 //----------------------------------------------------------------------------
 // Description of a restart operation (constructor).
 //----------------------------------------------------------------------------
@@ -273,7 +532,7 @@ void ts::tsp::PluginExecutor::restart(const RestartDataPtr& rd)
         _restart = true;
 
         // Signal the plugin thread that there is something to do.
-        _to_do.notify_one();
+        notifyWork(true);
     }
 
     // Now wait for the restart operation to complete.
@@ -299,6 +558,13 @@ bool ts::tsp::PluginExecutor::pendingRestart()
 
 bool ts::tsp::PluginExecutor::processPendingRestart(bool& restarted)
 {
+    // Fast path, called once per loop in plugin threads: _restart is atomic and set under
+    // the global mutex. If we miss a restart which is being set, we will see it next time.
+    if (!_restart) {
+        restarted = false;
+        return true;
+    }
+
     // Run under the protection of the global mutex.
     // To avoid deadlocks, always acquire the global mutex first, then a RestartData mutex.
     // Need improvement: the global mutex remains locked during the complete restart operation.
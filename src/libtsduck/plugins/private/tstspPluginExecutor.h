@@ -17,6 +17,8 @@
 #include "tsTSProcessorArgs.h"
 #include "tsPluginEventHandlerRegistry.h"
 #include "tsPlugin.h"
+#include "tsLogHistogram.h"
+#include "tsjson.h"
 
 namespace ts {
     namespace tsp {
@@ -80,6 +82,7 @@ namespace ts {
 
             //!
             //! This method sets the current packet processor in an abort state.
+            //! A fused plugin also aborts the thread of its fusion leader.
             //!
             virtual void setAbort();
 
@@ -120,6 +123,28 @@ namespace ts {
             //!
             void restart(Report& report);
 
+            //!
+            //! Check if the plugin is fused with a previous one (tsp option --fuse).
+            //! A fused plugin has no thread of its own and no slice in the packet buffer.
+            //! It is executed in the thread of the first plugin of its group.
+            //! @return True if the plugin is fused with a previous one.
+            //!
+            bool isFused() const { return _fusion_leader != nullptr; }
+
+            //!
+            //! Get the execution profile of the plugin, when tsp option --profile is used.
+            //! This method can be called from another thread than the plugin thread.
+            //! @return A JSON object describing the execution profile of the plugin.
+            //!
+            json::ValuePtr getProfile() const;
+
+            //!
+            //! Reset the execution profile of the plugin.
+            //! This method can be called from another thread than the plugin thread.
+            //! The reset is actually performed by the plugin thread, the next time it waits for work.
+            //!
+            void resetProfile() { _prof_reset = true; }
+
             // Implementation of TSP virtual methods.
             virtual size_t pluginCount() const override;
             virtual void signalPluginEvent(uint32_t event_code, Object* plugin_data = nullptr) const override;
@@ -128,6 +153,7 @@ namespace ts {
             PacketBuffer*         _buffer = nullptr;    //!< Description of shared packet buffer.
             PacketMetadataBuffer* _metadata = nullptr;  //!< Description of shared packet metadata buffer.
             volatile bool         _suspended = false;   //!< The plugin is suspended / resumed.
+            PluginExecutor*       _fusion_leader = nullptr;  //!< When not null, this plugin is executed in the thread of this one.
 
             //!
             //! Pass processed packets to the next packet processor.
@@ -203,14 +229,60 @@ namespace ts {
             // The following private data must be accessed exclusively under the protection of the global mutex.
             // Implementation details: see the file src/docs/developing-plugins.dox.
             // [*] After initialization, these fields are read/written only in passPackets() and waitWork().
+            // [LF] With --lock-free-handoff, these fields are not protected by the global mutex. The packet area
+            // of a plugin is shared by exactly two threads: the plugin thread removes packets from the beginning
+            // of its area, the previous plugin thread adds packets at the end. Atomic counters are sufficient.
             std::condition_variable_any _to_do {}; // Notify the processor thread to do something.
-            size_t            _pkt_first = 0;      // Starting index of packets area [*]
-            size_t            _pkt_cnt = 0;        // Size of packets area [*]
-            bool              _input_end = false;  // No more packet after current ones [*]
-            BitRate           _bitrate = 0;        // Input bitrate (set by previous plugin) [*]
-            BitRateConfidence _br_confidence = BitRateConfidence::LOW;  // Input bitrate confidence (set by previous plugin) [*]
-            bool              _restart = false;    // Restart the plugin asap using _restart_data
-            RestartDataPtr    _restart_data {};    // How to restart the plugin
+            size_t                 _pkt_first = 0;      // Starting index of packets area [*] [LF: modified by this thread only]
+            std::atomic<size_t>    _pkt_cnt {0};        // Size of packets area [*] [LF]
+            std::atomic<bool>      _input_end {false};  // No more packet after current ones [*] [LF]
+            BitRate                _bitrate = 0;        // Input bitrate (set by previous plugin) [*]
+            BitRateConfidence      _br_confidence = BitRateConfidence::LOW;  // Input bitrate confidence (set by previous plugin) [*]
+            std::atomic<bool>      _restart {false};    // Restart the plugin asap using _restart_data
+            RestartDataPtr         _restart_data {};    // How to restart the plugin
+
+            // Synchronization in --lock-free-handoff mode. The global mutex is used for control events only.
+            // The plugin thread waits on _lf_cond only when there is nothing to do.
+            std::mutex              _lf_mutex {};             // Protect waiting on _lf_cond and the bitrate fields.
+            std::condition_variable _lf_cond {};              // Notify the processor thread to do something.
+            std::atomic<bool>       _lf_waiting {false};      // The plugin thread is waiting (or about to wait) on _lf_cond.
+            std::atomic<bool>       _lf_bitrate_set {false};  // The previous plugin has set a new bitrate in _bitrate, _br_confidence.
+            BitRate                 _lf_bitrate = 0;          // Local copy of _bitrate, used by this thread only.
+            BitRateConfidence       _lf_br_confidence = BitRateConfidence::LOW;  // Local copy of _br_confidence, used by this thread only.
+            BitRate                 _lf_next_bitrate = 0;     // Last bitrate which was passed to next plugin.
+            BitRateConfidence       _lf_next_br_confidence = BitRateConfidence::LOW;  // Last bitrate confidence which was passed to next plugin.
+
+            // Execution profile with --profile. The histograms are recorded by the plugin thread only and
+            // can be read by other threads. Durations are in nanoseconds.
+            monotonic_time          _prof_exit {};            // Exit time of last waitWork().
+            std::atomic<bool>       _prof_reset {false};      // Reset the profile at next waitWork().
+            LogHistogram            _prof_process {};         // Time in the plugin, between two waitWork().
+            LogHistogram            _prof_wait {};            // Time waiting in waitWork().
+            LogHistogram            _prof_lock {};            // Time waiting for the global mutex.
+            LogHistogram            _prof_packets {};         // Number of packets returned by waitWork().
+            LogHistogram            _prof_occupancy {};       // Number of packets in our slice of the buffer in waitWork().
+
+            // Next and previous executors in the ring which have their own thread, skipping fused plugins.
+            // Return null only when the ring is not exclusively made of plugin executors.
+            PluginExecutor* nextExecutor();
+            PluginExecutor* previousExecutor();
+
+            // Lock the global mutex, record the lock wait time with --profile.
+            void lockGlobal(std::unique_lock<std::recursive_mutex>& lock);
+
+            // Convert a profiling histogram into JSON.
+            static json::ValuePtr HistogramToJSON(const LogHistogram& hist);
+
+            // Notify the plugin thread that there is something to do.
+            // In legacy mode, must be called with the global mutex held.
+            // When 'always' is false in lock-free mode, the notification is skipped if the plugin thread is not waiting.
+            // On a fused plugin, the thread of the fusion leader is notified.
+            void notifyWork(bool always);
+
+            // Implementation of passPackets() and waitWork() in --lock-free-handoff mode.
+            // The next executor in the ring is passed by passPackets(), never null.
+            bool passPacketsLockFree(PluginExecutor* next, size_t count, const BitRate& bitrate, BitRateConfidence br_confidence, bool input_end, bool aborted);
+            void waitWorkLockFree(size_t min_pkt_cnt, bool& timeout);
 
             // Description of a restart operation.
             class RestartData
@@ -48,13 +48,11 @@ size_t ts::tsp::ProcessorExecutor::pluginIndex() const
 
 
 //----------------------------------------------------------------------------
-// Packet processor plugin thread
+// Plugin fusion.
 //----------------------------------------------------------------------------
 
-void ts::tsp::ProcessorExecutor::main()
+size_t ts::tsp::ProcessorExecutor::ForcedWindowSize()
 {
-    debug(u"packet processing thread started");
-
     // Debug feature: if the environment variable TSP_FORCED_WINDOW_SIZE is
     // defined to some non-zero integer value, force all plugins to use the
     // packet window processing method. This can be used to check that using
@@ -63,39 +61,98 @@ void ts::tsp::ProcessorExecutor::main()
     if (!GetEnvironment(u"TSP_FORCED_WINDOW_SIZE").toInteger(window_size)) {
         window_size = 0; // invalid value, reset
     }
+    return window_size;
+}
+
+bool ts::tsp::ProcessorExecutor::isFusible() const
+{
+    return ForcedWindowSize() == 0 && _processor->getPacketWindowSize() == 0;
+}
+
+void ts::tsp::ProcessorExecutor::fuse(ProcessorExecutor* exec)
+{
+    verbose(u"executing plugin %s[%d] in the same thread", exec->pluginName(), exec->pluginIndex());
+    exec->_fusion_leader = this;
+    _fused.push_back(exec);
+}
+
+
+//----------------------------------------------------------------------------
+// Packet processor plugin thread
+//----------------------------------------------------------------------------
+
+void ts::tsp::ProcessorExecutor::main()
+{
+    debug(u"packet processing thread started");
 
     // Check if the plugin works in packet-window mode (if not already forced).
+    size_t window_size = ForcedWindowSize();
     if (window_size == 0) {
         window_size = _processor->getPacketWindowSize();
     }
 
     // Perform the complete packet processing in individual-packet or packet-window mode.
+    // Plugins in packet-window mode are never fused.
     if (window_size == 0) {
         processIndividualPackets();
     }
     else {
+        assert(_fused.empty());
         processPacketWindows(window_size);
     }
 
-    // Close the packet processor.
+    // Close the packet processors.
     debug(u"stopping the plugin");
     _processor->stop();
+    for (auto exec : _fused) {
+        exec->debug(u"stopping the plugin");
+        exec->_processor->stop();
+    }
 }
 
 
 //----------------------------------------------------------------------------
-// Process packets one by one.
+// Process packets one by one, through this plugin and all fused plugins.
 //----------------------------------------------------------------------------
 
 void ts::tsp::ProcessorExecutor::processIndividualPackets()
 {
-    TSPacketLabelSet only_labels(_processor->getOnlyLabelOption());
-    PacketCounter passed_packets = 0;
-    PacketCounter dropped_packets = 0;
-    PacketCounter nullified_packets = 0;
-    BitRate output_bitrate = _tsp_bitrate;
-    BitRateConfidence br_confidence = _tsp_bitrate_confidence;
-    bool bitrate_never_modified = true;
+    // Processing state of each plugin in this thread: this plugin first, then the fused ones.
+    struct Stage {
+        ProcessorExecutor* exec = nullptr;
+        TSPacketLabelSet   only_labels {};
+        PacketCounter      passed_packets = 0;
+        PacketCounter      dropped_packets = 0;
+        PacketCounter      nullified_packets = 0;
+        BitRate            output_bitrate = 0;
+        BitRateConfidence  br_confidence = BitRateConfidence::LOW;
+        bool               bitrate_never_modified = true;
+    };
+
+    std::vector<Stage> stages(1 + _fused.size());
+    for (size_t i = 0; i < stages.size(); ++i) {
+        stages[i].exec = i == 0 ? this : _fused[i - 1];
+        stages[i].only_labels = stages[i].exec->_processor->getOnlyLabelOption();
+    }
+    const Stage& last_stage(stages.back());
+
+    // Propagate the input bitrate through the plugins, starting at some stage. If the bitrate was
+    // never modified by a plugin, always copy its input bitrate as output bitrate. Otherwise, keep
+    // the previous output bitrate, as modified by the plugin.
+    const auto propagate_bitrate = [&stages](size_t first) {
+        for (size_t i = first; i < stages.size(); ++i) {
+            Stage& st(stages[i]);
+            if (i > 0) {
+                st.exec->_tsp_bitrate = stages[i - 1].output_bitrate;
+                st.exec->_tsp_bitrate_confidence = stages[i - 1].br_confidence;
+            }
+            if (st.bitrate_never_modified) {
+                st.output_bitrate = st.exec->_tsp_bitrate;
+                st.br_confidence = st.exec->_tsp_bitrate_confidence;
+            }
+        }
+    };
+
     bool input_end = false;
     bool aborted = false;
 
@@ -105,31 +162,25 @@ void ts::tsp::ProcessorExecutor::processIndividualPackets()
         size_t pkt_cnt = 0;
         bool timeout = false;
         waitWork(1, pkt_first, pkt_cnt, _tsp_bitrate, _tsp_bitrate_confidence, input_end, aborted, timeout);
-
-        // If bitrate was never modified by the plugin, always copy the input bitrate as output bitrate.
-        // Otherwise, keep previous output bitrate, as modified by the plugin.
-        if (bitrate_never_modified) {
-            output_bitrate = _tsp_bitrate;
-            br_confidence = _tsp_bitrate_confidence;
-        }
+        propagate_bitrate(0);
 
         // In case of abort on timeout, notify previous and next plugin, then exit.
         if (timeout) {
-            passPackets(0, output_bitrate, br_confidence, true, true);
+            passPackets(0, last_stage.output_bitrate, last_stage.br_confidence, true, true);
             break;
         }
 
         // If next processor has aborted, abort as well.
         // We call passPacket to inform our predecessor that we aborted.
         if (aborted && !input_end) {
-            passPackets(0, output_bitrate, br_confidence, true, true);
+            passPackets(0, last_stage.output_bitrate, last_stage.br_confidence, true, true);
             break;
         }
 
         // Exit thread if no more packet to process.
         // We call passPackets to inform our successor of end of input.
         if (pkt_cnt == 0 && input_end) {
-            passPackets(0, output_bitrate, br_confidence, true, false);
+            passPackets(0, last_stage.output_bitrate, last_stage.br_confidence, true, false);
             break;
         }
 
@@ -142,48 +193,60 @@ void ts::tsp::ProcessorExecutor::processIndividualPackets()
             TSPacket* const pkt = _buffer->base() + pkt_first + pkt_done;
             TSPacketMetadata* const pkt_data = _metadata->base() + pkt_first + pkt_done;
             bool got_new_bitrate = false;
+            bool flush = false;
 
             // Process restart requests.
-            bool restarted = false;
-            if (!processPendingRestart(restarted)) {
-                // Restart error.
-                aborted = true;
-                break;
+            for (auto& st : stages) {
+                bool restarted = false;
+                if (!st.exec->processPendingRestart(restarted)) {
+                    // Restart error.
+                    aborted = true;
+                    break;
+                }
+                else if (restarted) {
+                    // Plugin was restarted, need to recheck --only-label
+                    st.only_labels = st.exec->_processor->getOnlyLabelOption();
+                }
             }
-            else if (restarted) {
-                // Plugin was restarted, need to recheck --only-label
-                only_labels = _processor->getOnlyLabelOption();
+            if (aborted) {
+                break;
             }
 
             pkt_done++;
             pkt_flush++;
 
-            if (pkt->b[0] == 0) {
-                // The packet has already been dropped by a previous packet processor.
-                addNonPluginPackets(1);
-            }
-            else {
+            // Pass the packet through all plugins in this thread.
+            for (size_t stage_index = 0; stage_index < stages.size() && !aborted; ++stage_index) {
+
+                Stage& st(stages[stage_index]);
+
+                if (pkt->b[0] == 0) {
+                    // The packet has already been dropped by a previous packet processor.
+                    st.exec->addNonPluginPackets(1);
+                    continue;
+                }
+
                 // Apply the processing routine to the packet
                 const bool was_null = pkt->getPID() == PID_NULL;
                 pkt_data->setFlush(false);
                 pkt_data->setBitrateChanged(false);
                 ProcessorPlugin::Status status = ProcessorPlugin::TSP_OK;
-                if (!_suspended && (only_labels.none() || pkt_data->hasAnyLabel(only_labels))) {
+                if (!st.exec->_suspended && (st.only_labels.none() || pkt_data->hasAnyLabel(st.only_labels))) {
                     // Either no --only-label option or the packet has a specified label => process it.
-                    status = _processor->processPacket(*pkt, *pkt_data);
-                    addPluginPackets(1);
+                    status = st.exec->_processor->processPacket(*pkt, *pkt_data);
+                    st.exec->addPluginPackets(1);
                 }
                 else {
                     // The plugin is suspended or some --only-label was specified but the packet does
                     // not have any required label. Pass the packet without submitting it to the plugin.
-                    addNonPluginPackets(1);
+                    st.exec->addNonPluginPackets(1);
                 }
 
                 // Use the returned status
                 switch (status) {
                     case ProcessorPlugin::TSP_OK:
                         // Normal case, pass packet
-                        passed_packets++;
+                        st.passed_packets++;
                         break;
                     case ProcessorPlugin::TSP_NULL:
                         // Replace the packet with a complete null packet
@@ -192,11 +255,11 @@ void ts::tsp::ProcessorExecutor::processIndividualPackets()
                     case ProcessorPlugin::TSP_DROP:
                         // Drop this packet.
                         pkt->b[0] = 0;
-                        dropped_packets++;
+                        st.dropped_packets++;
                         break;
                     case ProcessorPlugin::TSP_END:
                         // Signal end of input to successors and abort to predecessors
-                        debug(u"plugin requests termination");
+                        st.exec->debug(u"plugin requests termination");
                         input_end = aborted = true;
                         pkt_done--;
                         pkt_flush--;
@@ -204,24 +267,28 @@ void ts::tsp::ProcessorExecutor::processIndividualPackets()
                         break;
                     default:
                         // Invalid status, report error and accept packet.
-                        error(u"invalid packet processing status %d", status);
+                        st.exec->error(u"invalid packet processing status %d", status);
                         break;
                 }
 
                 // Detect if the packet was nullified by the plugin, either by returning TSP_NULL or by overwriting the packet.
                 if (!was_null && pkt->getPID() == PID_NULL) {
                     pkt_data->setNullified(true);
-                    nullified_packets++;
+                    st.nullified_packets++;
                 }
 
+                // The flush request of any plugin is passed to the next thread.
+                flush = flush || pkt_data->getFlush();
+
                 // If the packet processor has signaled a new bitrate, get it.
                 if (pkt_data->getBitrateChanged()) {
-                    const BitRate new_bitrate = _processor->getBitrate();
+                    const BitRate new_bitrate = st.exec->_processor->getBitrate();
                     if (new_bitrate != 0) {
-                        bitrate_never_modified = false;
-                        got_new_bitrate = new_bitrate != output_bitrate;
-                        output_bitrate = new_bitrate;
-                        br_confidence = _processor->getBitrateConfidence();
+                        st.bitrate_never_modified = false;
+                        got_new_bitrate = got_new_bitrate || new_bitrate != st.output_bitrate;
+                        st.output_bitrate = new_bitrate;
+                        st.br_confidence = st.exec->_processor->getBitrateConfidence();
+                        propagate_bitrate(stage_index + 1);
                     }
                 }
             }
@@ -229,16 +296,18 @@ void ts::tsp::ProcessorExecutor::processIndividualPackets()
             // Do not wait to process pkt_cnt packets before notifying the next processor.
             // Perform periodic flush to avoid waiting too long before two output operations.
             // Also propagate new bitrate values immediately.
-            if (pkt_data->getFlush() || got_new_bitrate || pkt_done == pkt_cnt || (_options.max_flush_pkt > 0 && pkt_flush >= _options.max_flush_pkt)) {
-                aborted = !passPackets(pkt_flush, output_bitrate, br_confidence, pkt_done == pkt_cnt && input_end, aborted);
+            if (flush || got_new_bitrate || pkt_done == pkt_cnt || (_options.max_flush_pkt > 0 && pkt_flush >= _options.max_flush_pkt)) {
+                aborted = !passPackets(pkt_flush, last_stage.output_bitrate, last_stage.br_confidence, pkt_done == pkt_cnt && input_end, aborted);
                 pkt_flush = 0;
             }
         }
 
     } while (!input_end && !aborted);
 
-    debug(u"packet processing thread %s after %'d packets, %'d passed, %'d dropped, %'d nullified",
-          input_end ? u"terminated" : u"aborted", pluginPackets(), passed_packets, dropped_packets, nullified_packets);
+    for (const auto& st : stages) {
+        st.exec->debug(u"packet processing thread %s after %'d packets, %'d passed, %'d dropped, %'d nullified",
+                       input_end ? u"terminated" : u"aborted", st.exec->pluginPackets(), st.passed_packets, st.dropped_packets, st.nullified_packets);
+    }
 }
 
 
@@ -47,19 +47,39 @@ namespace ts {
             //!
             virtual ~ProcessorExecutor() override;
 
+            //!
+            //! Check if the plugin can be fused with other plugins (tsp option --fuse).
+            //! Plugins which process packet windows cannot be fused.
+            //! Must be called after starting the plugin.
+            //! @return True if the plugin can be fused with other plugins.
+            //!
+            bool isFusible() const;
+
+            //!
+            //! Execute another processor plugin in the thread of this one (tsp option --fuse).
+            //! Must be called before starting the executor threads. The fused plugin must be
+            //! the next one in the ring after this plugin or after its last fused plugin.
+            //! @param [in,out] exec The executor of the plugin to fuse. Its thread shall not be started.
+            //!
+            void fuse(ProcessorExecutor* exec);
+
             // Overridden methods.
             virtual size_t pluginIndex() const override;
 
         private:
             ProcessorPlugin* _processor = nullptr;
             const size_t _plugin_index;
+            std::vector<ProcessorExecutor*> _fused {};  // Next plugins which are executed in this thread.
 
             // Inherited from Thread
             virtual void main() override;
 
-            // Process packets one by one or using packet windows.
+            // Process packets one by one (through all fused plugins) or using packet windows.
             void processIndividualPackets();
             void processPacketWindows(size_t window_size);
+
+            // Get the window size which is forced by environment variable TSP_FORCED_WINDOW_SIZE (zero if none).
+            static size_t ForcedWindowSize();
         };
     }
 }
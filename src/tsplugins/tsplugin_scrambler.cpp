@@ -82,6 +82,8 @@ namespace ts {
         virtual bool start() override;
         virtual bool stop() override;
         virtual Status processPacket(TSPacket&, TSPacketMetadata&) override;
+        virtual size_t getPacketWindowSize() override;
+        virtual size_t processPacketWindow(TSPacketWindow&) override;
 
     private:
         // Description of a crypto-period.
@@ -398,8 +400,8 @@ bool ts::ScramblerPlugin::start()
     // As long as the bitrate is unknown, delay changes to infinite.
     _pkt_insert_ecm = _pkt_change_cw = _pkt_change_ecm = std::numeric_limits<PacketCounter>::max();
 
-    // Initialize the scrambling engine.
-    if (!_scrambling.start()) {
+    // Initialize the scrambling engine. With DVB-CSA2, packets are scrambled by batches.
+    if (!_scrambling.start() || !_scrambling.setBatchMode(_scrambling.batchSize() > 0)) {
         return false;
     }
 
@@ -731,6 +733,26 @@ void ts::ScramblerPlugin::changeECM()
 }
 
 
+//----------------------------------------------------------------------------
+// Packet window processing methods.
+//----------------------------------------------------------------------------
+
+size_t ts::ScramblerPlugin::getPacketWindowSize()
+{
+    // With DVB-CSA2, use packet windows to scramble packets in parallel.
+    return _scrambling.batchSize();
+}
+
+size_t ts::ScramblerPlugin::processPacketWindow(TSPacketWindow& win)
+{
+    // Process packets one by one. In batch mode, the payloads are only queued for scrambling.
+    const size_t count = ProcessorPlugin::processPacketWindow(win);
+
+    // Scramble all queued payloads before passing the packets to the next plugin.
+    return _scrambling.flushBatch() ? count : 0;
+}
+
+
 //----------------------------------------------------------------------------
 // Packet processing method
 //----------------------------------------------------------------------------
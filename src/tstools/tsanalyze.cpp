@@ -16,6 +16,9 @@
 #include "tsTSFile.h"
 #include "tsPagerArgs.h"
 #include "tsDuckContext.h"
+#include "tsMessageQueue.h"
+#include "tsThread.h"
+#include "tsNullReport.h"
 TS_MAIN(MainCode);
 
 
@@ -32,6 +35,8 @@ namespace {
 
         ts::DuckContext       duck {this};         // TSDuck execution context.
         ts::BitRate           bitrate = 0;         // Expected bitrate (188-byte packets)
+        size_t                threads = 1;         // Number of analysis threads.
+        bool                  memory_map = false;  // Map the input file in memory.
         fs::path              infile {};           // Input file name
         ts::TSPacketFormat    format = ts::TSPacketFormat::AUTODETECT; // Input file format.
         ts::TSAnalyzerOptions analysis {};         // Analysis options.
@@ -60,6 +65,24 @@ Options::Options(int argc, char *argv[]) :
          u"(based on 188-byte packets). By default, the bitrate is "
          u"evaluated using the PCR in the transport stream.");
 
+    option(u"memory-map");
+    help(u"memory-map",
+         u"Map the input file in memory instead of using read operations. "
+         u"Packets are analyzed directly from the mapped file, without intermediate copy. "
+         u"This option is ignored if the input is not a regular file or on Windows.");
+
+    option(u"threads", 0, INTEGER, 0, 1, 1, 256);
+    help(u"threads", u"count",
+         u"Analyze the transport stream using the specified number of parallel threads. "
+         u"Each thread analyzes the packets of a subset of the PID's. "
+         u"The analysis results are the same, regardless of the number of threads. "
+         u"Using several threads is useful to analyze large capture files with many PID's. "
+         u"The main thread still reads the file, analyzes the PSI/SI and dispatches "
+         u"all packets to the other threads. This part is serial and limits the speedup: "
+         u"the analysis cannot be faster than a single thread reading and dispatching all packets. "
+         u"Using more threads than CPU cores or than PID's in the stream is useless. "
+         u"By default, the analysis uses one single thread.");
+
     analyze(argc, argv);
 
     // Define all standard analysis options.
@@ -69,12 +92,87 @@ Options::Options(int argc, char *argv[]) :
 
     getPathValue(infile, u"");
     getValue(bitrate, u"bitrate");
+    getIntValue(threads, u"threads", 1);
+    memory_map = present(u"memory-map");
     format = ts::LoadTSPacketFormatInputOption(*this);
 
     exitOnError();
 }
 
 
+//----------------------------------------------------------------------------
+//  Analysis thread, for parallel analysis of a subset of the PID's.
+//----------------------------------------------------------------------------
+
+namespace {
+    // Chunk of packets for one analysis thread, with their index in the stream.
+    // An empty chunk means end of stream.
+    class ShardChunk
+    {
+    public:
+        ts::TSPacketVector    packets {};
+        std::vector<uint64_t> indexes {};
+    };
+    using PacketQueue = ts::MessageQueue<ShardChunk>;
+
+    class AnalysisThread: public ts::Thread
+    {
+        TS_NOBUILD_NOCOPY(AnalysisThread);
+    public:
+        // Constructor. Analyze shard index out of count.
+        AnalysisThread(Options& opt, size_t index, size_t count);
+
+        // Destructor.
+        virtual ~AnalysisThread() override;
+
+        // Public fields.
+        ts::DuckContext          duck;
+        ts::TSAnalyzerReport     analyzer {duck};
+        PacketQueue              queue {16};
+        PacketQueue::MessagePtr  chunk {};   // Chunk being filled by the main thread.
+
+    private:
+        // Main code of the thread.
+        virtual void main() override;
+    };
+}
+
+// Constructor.
+AnalysisThread::AnalysisThread(Options& opt, size_t index, size_t count) :
+    // The PSI/SI are analyzed in the main thread only, errors are reported there.
+    duck(&NULLREP)
+{
+    ts::DuckContext::SavedArgs args;
+    opt.duck.saveArgs(args);
+    duck.restoreArgs(args);
+
+    analyzer.setBitrateHint(opt.bitrate, ts::BitRateConfidence::OVERRIDE);
+    analyzer.setAnalysisOptions(opt.analysis);
+    analyzer.setShard(index, count);
+}
+
+// Destructor.
+AnalysisThread::~AnalysisThread()
+{
+    waitForTermination();
+}
+
+// Main code of the thread.
+void AnalysisThread::main()
+{
+    for (;;) {
+        PacketQueue::MessagePtr msg;
+        queue.dequeue(msg);
+        if (msg == nullptr || msg->packets.empty()) {
+            break;
+        }
+        for (size_t i = 0; i < msg->packets.size(); ++i) {
+            analyzer.feedShardPacket(msg->packets[i], msg->indexes[i]);
+        }
+    }
+}
+
+
 //----------------------------------------------------------------------------
 //  Program entry point
 //----------------------------------------------------------------------------
@@ -84,23 +182,101 @@ int MainCode(int argc, char *argv[])
     // Decode command line options.
     Options opt(argc, argv);
 
-    // Configure the TS analyzer.
-    ts::TSAnalyzerReport analyzer(opt.duck, opt.bitrate, ts::BitRateConfidence::OVERRIDE);
-    analyzer.setAnalysisOptions(opt.analysis);
-
     // Open the TS file.
     ts::TSFile file;
+    file.setMemoryMapping(opt.memory_map);
     if (!file.openRead(opt.infile, 1, 0, opt, opt.format)) {
         return EXIT_FAILURE;
     }
 
-    // Analyze all packets in the file.
-    ts::TSPacket pkt;
-    while (file.readPackets(&pkt, nullptr, 1, opt) > 0) {
-        analyzer.feedPacket(pkt);
+    if (opt.threads <= 1) {
+        // Configure the TS analyzer.
+        ts::TSAnalyzerReport analyzer(opt.duck, opt.bitrate, ts::BitRateConfidence::OVERRIDE);
+        analyzer.setAnalysisOptions(opt.analysis);
+
+        // Analyze all packets in the file, directly from the file mapping when possible.
+        constexpr size_t CHUNK_PACKETS = 1024;
+        ts::TSPacketHeaders headers(CHUNK_PACKETS);
+        const ts::TSPacket* pkts = nullptr;
+        size_t count = 0;
+        while ((count = file.readPacketsInPlace(pkts, CHUNK_PACKETS, opt)) > 0) {
+            headers.scan(pkts, count);
+            analyzer.feedPackets(pkts, headers);
+        }
+        file.close(opt);
+
+        // Display analysis results.
+        analyzer.report(opt.pager.output(opt), opt.analysis, opt);
+        return EXIT_SUCCESS;
+    }
+
+    // Parallel analysis: the main thread reads the file and analyzes the first shard of PID's,
+    // including the PSI/SI. Each other shard of PID's is analyzed in its own thread.
+    // Reading, routing and dispatching packets remain serial in the main thread.
+    ts::TSAnalyzerReport analyzer(opt.duck, opt.bitrate, ts::BitRateConfidence::OVERRIDE);
+    analyzer.setAnalysisOptions(opt.analysis);
+    analyzer.setShard(0, opt.threads);
+
+    std::vector<std::unique_ptr<AnalysisThread>> threads;
+    for (size_t i = 1; i < opt.threads; ++i) {
+        threads.push_back(std::make_unique<AnalysisThread>(opt, i, opt.threads));
+        threads.back()->start();
+    }
+
+    // Pass the chunk of packets of an analysis thread when full or at end of stream.
+    constexpr size_t CHUNK_PACKETS = 1024;
+    const auto pass = [](AnalysisThread& thread, uint64_t index, const ts::TSPacket* pkt) {
+        if (thread.chunk == nullptr) {
+            thread.chunk = std::make_shared<ShardChunk>();
+            thread.chunk->packets.reserve(CHUNK_PACKETS);
+            thread.chunk->indexes.reserve(CHUNK_PACKETS);
+        }
+        if (pkt != nullptr) {
+            thread.chunk->packets.push_back(*pkt);
+            thread.chunk->indexes.push_back(index);
+        }
+        if (pkt == nullptr || thread.chunk->packets.size() >= CHUNK_PACKETS) {
+            thread.queue.enqueue(thread.chunk);
+            thread.chunk.reset();
+        }
+    };
+
+    // Analyze all packets in the first shard and pass the others to the thread of their PID.
+    ts::TSPacketHeaders headers(CHUNK_PACKETS);
+    std::vector<ts::TSAnalyzer::ShardRoute> routes;
+    std::vector<uint64_t> indexes;
+    const ts::TSPacket* pkts = nullptr;
+    size_t count = 0;
+    while ((count = file.readPacketsInPlace(pkts, CHUNK_PACKETS, opt)) > 0) {
+        headers.scan(pkts, count);
+        analyzer.feedShardRouter(pkts, headers, routes, indexes);
+        for (size_t i = 0; i < count; ++i) {
+            if (routes[i] == ts::TSAnalyzer::ShardRoute::OWNER) {
+                pass(*threads[ts::TSAnalyzer::ShardIndex(headers.pids()[i], opt.threads) - 1], indexes[i], pkts + i);
+            }
+            else if (routes[i] == ts::TSAnalyzer::ShardRoute::ALL) {
+                for (const auto& thread : threads) {
+                    pass(*thread, indexes[i], pkts + i);
+                }
+            }
+        }
     }
     file.close(opt);
 
+    // Flush the last chunks, then signal the end of stream with an empty chunk.
+    for (const auto& thread : threads) {
+        if (thread->chunk != nullptr && !thread->chunk->packets.empty()) {
+            pass(*thread, 0, nullptr);
+        }
+        pass(*thread, 0, nullptr);
+    }
+
+    // Wait for the end of all analysis and merge them into the first one.
+    for (const auto& thread : threads) {
+        thread->waitForTermination();
+        analyzer.mergeShard(thread->analyzer);
+    }
+
     // Display analysis results.
     analyzer.report(opt.pager.output(opt), opt.analysis, opt);
 
@@ -46,6 +46,7 @@ namespace {
         bool                  dvb_simulcrypt = false;
         bool                  extract_tcp = false;
         bool                  save_tcp = false;
+        bool                  address_filter = false;
         std::set<uint8_t>     protocols {};
         ts::IPv4SocketAddress source_filter {};
         ts::IPv4SocketAddress dest_filter {};
@@ -129,6 +130,7 @@ Options::Options(int argc, char *argv[]) :
     save_tcp = present(u"output-tcp-stream");
     getSocketValue(dest_filter, u"destination");
     getSocketValue(source_filter, u"source");
+    address_filter = present(u"source") || present(u"destination");
     getChronoValue(interval, u"interval");
     list_streams = present(u"list-streams");
     print_intervals = present(u"interval");
@@ -165,24 +167,18 @@ Options::Options(int argc, char *argv[]) :
 //----------------------------------------------------------------------------
 
 namespace {
-    class StatBlock
+    class StatBlock: public ts::PcapIndex::FlowStats
     {
     public:
-        size_t           packet_count = 0;      // number of IP packets in the data set
-        size_t           total_ip_size = 0;     // total size in bytes of IP packets, headers included
-        size_t           total_data_size = 0;   // total data size in bytes (TCP o UDP payload)
-        cn::microseconds first_timestamp = cn::microseconds(-1);  // negative if none found
-        cn::microseconds last_timestamp = cn::microseconds(-1);   // negative if none found
-
         // Constructor.
         StatBlock() = default;
 
-        // Add statistics from one packet.
-        void addPacket(const ts::IPv4Packet&, cn::microseconds);
-
         // Reset content, optionally set timestamps.
         void reset(cn::microseconds = cn::microseconds(-1));
     };
+
+    // Identification of one "data stream": same as in pcap files index.
+    using StreamId = ts::PcapIndex::FlowId;
 }
 
 // Reset content, optionally set timestamps.
@@ -192,61 +188,6 @@ void StatBlock::reset(cn::microseconds timestamps)
     first_timestamp = last_timestamp = timestamps;
 }
 
-// Add statistics from one packet.
-void StatBlock::addPacket(const ts::IPv4Packet& ip, cn::microseconds timestamp)
-{
-    packet_count++;
-    total_ip_size += ip.size();
-    total_data_size += ip.protocolDataSize();
-    if (timestamp >= cn::microseconds::zero()) {
-        if (first_timestamp < cn::microseconds::zero()) {
-            first_timestamp = timestamp;
-        }
-        last_timestamp = timestamp;
-    }
-}
-
-
-//----------------------------------------------------------------------------
-// Identification of one "data stream".
-//----------------------------------------------------------------------------
-
-namespace {
-    class StreamId
-    {
-    public:
-        ts::IPv4SocketAddress source;
-        ts::IPv4SocketAddress destination;
-        uint8_t               protocol;
-
-        // Constructor.
-        StreamId(const ts::IPv4SocketAddress& src = ts::IPv4SocketAddress(), const ts::IPv4SocketAddress& dst = ts::IPv4SocketAddress(), uint8_t proto = 0xFF);
-
-        // Comparison, for use in containers.
-        bool operator<(const StreamId& other) const;
-    };
-}
-
-StreamId::StreamId(const ts::IPv4SocketAddress& src, const ts::IPv4SocketAddress& dst, uint8_t proto) :
-    source(src),
-    destination(dst),
-    protocol(proto)
-{
-}
-
-bool StreamId::operator<(const StreamId& other) const
-{
-    if (source != other.source) {
-        return source < other.source;
-    }
-    else if (destination != other.destination) {
-        return destination < other.destination;
-    }
-    else {
-        return protocol < other.protocol;
-    }
-}
-
 
 //----------------------------------------------------------------------------
 // Display summary of content by intervals of time.
@@ -339,7 +280,7 @@ namespace {
         ts::PcapFilter  _file {};
         DisplayInterval _interval;                      // Display stats by time intervals.
         StatBlock       _global_stats {};               // Global stats
-        std::map<StreamId,StatBlock> _streams_stats {}; // Stats per data stream.
+        std::map<StreamId, ts::PcapIndex::FlowStats> _streams_stats {}; // Stats per data stream.
 
         // Display summary of content.
         void displaySummary(std::ostream& out, const StatBlock& stats);
@@ -362,6 +303,15 @@ bool FileAnalysis::analyze(std::ostream& out)
     _file.setSourceFilter(_opt.source_filter);
     _file.setDestinationFilter(_opt.dest_filter);
 
+    // With a complete index and no filter, list the streams from the index, without reading the file.
+    if (_opt.list_streams && !_opt.print_intervals && _opt.protocols.empty() && !_opt.address_filter && !_file.rangeFilterIsSet() && _file.index().complete) {
+        const ts::PcapIndex::FlowStats& stats(_file.index().ipv4_stats);
+        _streams_stats = _file.index().flows;
+        _file.close();
+        listStreams(out, stats.last_timestamp - stats.first_timestamp);
+        return true;
+    }
+
     // Read all IPv4 packets from the file.
     ts::IPv4Packet ip;
     cn::microseconds timestamp = cn::microseconds::zero();
@@ -431,7 +381,7 @@ void FileAnalysis::listStreams(std::ostream& out, cn::microseconds duration)
         << std::endl;
     for (const auto& it : _streams_stats) {
         const StreamId& id(it.first);
-        const StatBlock& sb(it.second);
+        const ts::PcapIndex::FlowStats& sb(it.second);
         out << ts::UString::Format(u"%-22s %-22s %-8s %11'd %15'd %12'd",
                                    id.source,
                                    id.destination,
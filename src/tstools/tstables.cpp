@@ -93,9 +93,12 @@ int MainCode(int argc, char *argv[])
     }
 
     // Read all packets in the file and pass them to the logger
-    ts::TSPacket pkt;
-    while (!opt.logger.completed() && file.readPackets(&pkt, nullptr, 1, opt) > 0) {
-        opt.logger.feedPacket(pkt);
+    const ts::TSPacket* pkts = nullptr;
+    size_t count = 0;
+    while (!opt.logger.completed() && (count = file.readPacketsInPlace(pkts, 1024, opt)) > 0) {
+        for (size_t i = 0; i < count && !opt.logger.completed(); ++i) {
+            opt.logger.feedPacket(pkts[i]);
+        }
     }
     file.close(opt);
     opt.logger.close();
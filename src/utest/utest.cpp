@@ -20,9 +20,20 @@
 //----------------------------------------------------------------------------
 
 #include "tsunit.h"
+#include "tsEnvironment.h"
+#include "tsFileUtils.h"
+#include "tsErrCodeReport.h"
 
 int main(int argc, char* argv[])
 {
+    // Do not use or pollute the cache of compiled names files of the user.
+    // The tests use a temporary cache directory, which is deleted at the end.
+    const fs::path cache_dir(ts::TempFile(u".cache"));
+    ts::SetEnvironment(u"TSDUCK_CACHE_DIR", cache_dir);
+
     tsunit::Main test(argc, argv);
-    return test.run();
+    const int status = test.run();
+
+    fs::remove_all(cache_dir, &ts::ErrCodeReport());
+    return status;
 }
@@ -23,6 +23,7 @@ class ContinuityTest: public tsunit::Test
 {
     TSUNIT_DECLARE_TEST(Analyze);
     TSUNIT_DECLARE_TEST(Fix);
+    TSUNIT_DECLARE_TEST(Headers);
 };
 
 TSUNIT_REGISTER(ContinuityTest);
@@ -192,3 +193,34 @@ TSUNIT_DEFINE_TEST(Fix)
     TSUNIT_EQUAL(2, fixer.errorCount());
     TSUNIT_EQUAL(5, fixer.fixCount());
 }
+
+TSUNIT_DEFINE_TEST(Headers)
+{
+    ts::ReportBuffer<ts::ThreadSafety::None> log;
+    ts::ContinuityAnalyzer fixer(ts::NoPID, &log);
+    fixer.addPID(101);
+    fixer.setDisplay(true);
+
+    // Same PID/CC scenario as in Analyze, with PID 100 not analyzed and null packets.
+    static const struct { ts::PID pid; uint8_t cc; } scenario[] = {
+        {100, 5}, {101, 13}, {100, 7}, {101, 14}, {ts::PID_NULL, 0}, {101, 14}, {101, 15}, {101, 0},
+        {101, 3}, {101, 4}, {101, 4}, {101, 4}, {ts::PID_NULL, 0}, {101, 5},
+    };
+    ts::TSPacketVector packets(std::size(scenario));
+    for (size_t i = 0; i < packets.size(); ++i) {
+        packets[i] = ts::NullPacket;
+        packets[i].setPID(scenario[i].pid);
+        packets[i].setCC(scenario[i].cc);
+    }
+
+    ts::TSPacketHeaders hdr;
+    hdr.scan(packets.data(), packets.size());
+    TSUNIT_EQUAL(2, fixer.feedPackets(packets.data(), hdr));
+    TSUNIT_EQUAL(u"packet index: 8, PID: 0x0065, missing 2 packets\n"
+                 u"packet index: 11, PID: 0x0065, 3 duplicate packets",
+                 log.messages());
+
+    TSUNIT_EQUAL(14, fixer.totalPackets());
+    TSUNIT_EQUAL(10, fixer.processedPackets());
+    TSUNIT_EQUAL(2, fixer.errorCount());
+}
@@ -66,6 +66,7 @@ class CryptoTest: public tsunit::Test
     TSUNIT_DECLARE_TEST(TDES);
     TSUNIT_DECLARE_TEST(TDES_CBC);
     TSUNIT_DECLARE_TEST(DVBCSA2);
+    TSUNIT_DECLARE_TEST(DVBCSA2Batch);
     TSUNIT_DECLARE_TEST(DVBCISSA);
     TSUNIT_DECLARE_TEST(IDSA);
     TSUNIT_DECLARE_TEST(SCTE52_2003);
@@ -571,6 +572,115 @@ TSUNIT_DEFINE_TEST(DVBCSA2)
     bench.report(u"CryptoTest::testDVBCSA2");
 }
 
+TSUNIT_DEFINE_TEST(DVBCSA2Batch)
+{
+    utest::TSUnitBenchmark bench(u"TSUNIT_DVBCSA2_ITERATIONS");
+
+    // Test vectors, one at a time and all together (several keys, not possible in one batch).
+    ts::DVBCSA2 csa;
+    const size_t tv_count = sizeof(tv_dvb_csa2) / sizeof(tv_dvb_csa2[0]);
+    for (size_t tvi = 0; tvi < tv_count; ++tvi) {
+        const TV_DVB_CSA2* tv = tv_dvb_csa2 + tvi;
+        uint8_t buf[sizeof(tv->plain)];
+        uint8_t* data = buf;
+        TSUNIT_ASSERT(csa.setKey(tv->key, sizeof(tv->key)));
+        ts::MemCopy(buf, tv->plain, tv->size);
+        TSUNIT_ASSERT(csa.encryptBatch(&data, &tv->size, 1));
+        TSUNIT_EQUAL(0, ts::MemCompare(buf, tv->cipher, tv->size));
+        TSUNIT_ASSERT(csa.decryptBatch(&data, &tv->size, 1));
+        TSUNIT_EQUAL(0, ts::MemCompare(buf, tv->plain, tv->size));
+    }
+
+    // Compare batch and individual processing on random data, with all kinds of sizes,
+    // including less than one block and more than the batch size.
+    ts::SystemRandomGenerator prng;
+    uint8_t key[ts::DVBCSA2::KEY_SIZE];
+    TSUNIT_ASSERT(prng.read(key, sizeof(key)));
+    TSUNIT_ASSERT(csa.setKey(key, sizeof(key)));
+
+    const size_t count = 2 * ts::DVBCSA2::BatchSize() + 7;
+    std::vector<ts::ByteBlock> plain(count);
+    std::vector<ts::ByteBlock> cipher(count);
+    std::vector<uint8_t*> data(count);
+    std::vector<size_t> sizes(count);
+    for (size_t i = 0; i < count; ++i) {
+        // Most packets have a full 184-byte payload.
+        plain[i].resize(i % 3 == 0 ? ts::PKT_SIZE - 4 : (i * 7) % (ts::PKT_SIZE - 3) + 1);
+        TSUNIT_ASSERT(prng.read(plain[i].data(), plain[i].size()));
+        cipher[i] = plain[i];
+        TSUNIT_ASSERT(csa.encrypt(plain[i].data(), plain[i].size(), cipher[i].data(), cipher[i].size()));
+    }
+
+    ts::ByteBlock work;
+    for (size_t i = 0; i < count; ++i) {
+        work.append(plain[i]);
+    }
+    auto reset = [&](const std::vector<ts::ByteBlock>& ref) {
+        size_t offset = 0;
+        for (size_t i = 0; i < count; ++i) {
+            ts::MemCopy(work.data() + offset, ref[i].data(), ref[i].size());
+            data[i] = work.data() + offset;
+            sizes[i] = ref[i].size();
+            offset += ref[i].size();
+        }
+    };
+
+    reset(plain);
+    TSUNIT_ASSERT(csa.encryptBatch(data.data(), sizes.data(), count));
+    for (size_t i = 0; i < count; ++i) {
+        TSUNIT_EQUAL(0, ts::MemCompare(data[i], cipher[i].data(), sizes[i]));
+    }
+
+    reset(cipher);
+    TSUNIT_ASSERT(csa.decryptBatch(data.data(), sizes.data(), count));
+    for (size_t i = 0; i < count; ++i) {
+        TSUNIT_EQUAL(0, ts::MemCompare(data[i], plain[i].data(), sizes[i]));
+    }
+
+    // When some data blocks are not allowed, no data block is modified.
+    reset(plain);
+    TSUNIT_ASSERT(csa.setKey(key, sizeof(key)));
+    csa.setEncryptionMax(count - 1);
+    TSUNIT_ASSERT(!csa.encryptBatch(data.data(), sizes.data(), count));
+    for (size_t i = 0; i < count; ++i) {
+        TSUNIT_EQUAL(0, ts::MemCompare(data[i], plain[i].data(), sizes[i]));
+    }
+    csa.setEncryptionMax(ts::BlockCipher::UNLIMITED);
+    const size_t bad_size = ts::PKT_SIZE + 8; // more than 23 blocks of 8 bytes
+    uint8_t* const bad_data[2] = {data[0], data[1]};
+    const size_t bad_sizes[2] = {sizes[0], bad_size};
+    TSUNIT_ASSERT(!csa.encryptBatch(bad_data, bad_sizes, 2));
+    TSUNIT_EQUAL(0, ts::MemCompare(data[0], plain[0].data(), sizes[0]));
+
+    // Benchmark batch decryption of full payloads.
+    ts::ByteBlock payloads(ts::DVBCSA2::BatchSize() * (ts::PKT_SIZE - 4));
+    std::vector<uint8_t*> pdata(ts::DVBCSA2::BatchSize());
+    std::vector<size_t> psizes(ts::DVBCSA2::BatchSize(), ts::PKT_SIZE - 4);
+    for (size_t i = 0; i < pdata.size(); ++i) {
+        pdata[i] = payloads.data() + i * (ts::PKT_SIZE - 4);
+    }
+    bool ok = true;
+    bench.start();
+    for (size_t iter = 0; iter < bench.iterations; ++iter) {
+        ok = csa.decryptBatch(pdata.data(), psizes.data(), pdata.size()) && ok;
+    }
+    bench.stop();
+    TSUNIT_ASSERT(ok);
+    bench.report(u"CryptoTest::testDVBCSA2Batch, batch");
+
+    // Same payloads, one at a time, for comparison.
+    utest::TSUnitBenchmark bench1(u"TSUNIT_DVBCSA2_ITERATIONS");
+    bench1.start();
+    for (size_t iter = 0; iter < bench1.iterations; ++iter) {
+        for (size_t i = 0; i < pdata.size(); ++i) {
+            ok = csa.decrypt(pdata[i], psizes[i], pdata[i], psizes[i]) && ok;
+        }
+    }
+    bench1.stop();
+    TSUNIT_ASSERT(ok);
+    bench1.report(u"CryptoTest::testDVBCSA2Batch, one by one");
+}
+
 TSUNIT_DEFINE_TEST(DVBCISSA)
 {
     utest::TSUnitBenchmark bench(u"TSUNIT_DVBCISSA_ITERATIONS");
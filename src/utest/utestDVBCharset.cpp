@@ -11,6 +11,8 @@
 //----------------------------------------------------------------------------
 
 #include "tsDVBCharset.h"
+#include "tsDVBCharTableSingleByte.h"
+#include "tsDVBCharTableUTF8.h"
 #include "tsByteBlock.h"
 #include "tsunit.h"
 
@@ -22,6 +24,9 @@ class DVBCharsetTest: public tsunit::Test
 {
     TSUNIT_DECLARE_TEST(Repository);
     TSUNIT_DECLARE_TEST(DVB);
+    TSUNIT_DECLARE_TEST(SingleByte);
+    TSUNIT_DECLARE_TEST(UTF8);
+    TSUNIT_DECLARE_TEST(Benchmark);
 };
 
 TSUNIT_REGISTER(DVBCharsetTest);
@@ -57,3 +62,137 @@ TSUNIT_DEFINE_TEST(DVB)
     TSUNIT_EQUAL(str1, ts::DVBCharset::DVB.decoded(dvb1, sizeof(dvb1)));
     TSUNIT_ASSERT(ts::ByteBlock(dvb1, sizeof(dvb1)) == ts::DVBCharset::DVB.encoded(str1.toDecomposedDiacritical()));
 }
+
+TSUNIT_DEFINE_TEST(SingleByte)
+{
+    // All assigned characters are identically encoded after decoding.
+    const ts::DVBCharTableSingleByte* const tables[] = {
+        &ts::DVBCharTableSingleByte::RAW_ISO_8859_1, &ts::DVBCharTableSingleByte::RAW_ISO_8859_2,
+        &ts::DVBCharTableSingleByte::RAW_ISO_8859_5, &ts::DVBCharTableSingleByte::RAW_ISO_8859_7,
+        &ts::DVBCharTableSingleByte::RAW_ISO_8859_11, &ts::DVBCharTableSingleByte::RAW_ISO_8859_15,
+    };
+    for (const auto table : tables) {
+        for (int b = 0x20; b <= 0xFF; ++b) {
+            if (b < 0x7F || b >= 0xA0) {
+                const uint8_t in[3] = {'a', uint8_t(b), 'z'};
+                ts::UString str;
+                if (table->decode(str, in, sizeof(in))) {
+                    uint8_t out[3];
+                    uint8_t* buf = out;
+                    size_t size = sizeof(out);
+                    TSUNIT_EQUAL(3, table->encode(buf, size, str));
+                    TSUNIT_EQUAL(0, size);
+                    TSUNIT_ASSERT(ts::ByteBlock(in, sizeof(in)) == ts::ByteBlock(out, sizeof(out)));
+                }
+            }
+        }
+    }
+
+    // Line feeds are encoded, carriage returns are ignored.
+    const ts::UString str1({u'a', u'\r', u'\n', u'b', ts::CYRILLIC_CAPITAL_LETTER_IO});
+    uint8_t out[10];
+    uint8_t* buf = out;
+    size_t size = sizeof(out);
+    TSUNIT_EQUAL(4, ts::DVBCharTableSingleByte::RAW_ISO_8859_15.encode(buf, size, str1, 0, 4));
+    TSUNIT_EQUAL(3, buf - out);
+    TSUNIT_ASSERT(ts::ByteBlock({'a', 0x8A, 'b'}) == ts::ByteBlock(out, buf - out));
+
+    // Only the specified part of the string is checked.
+    TSUNIT_ASSERT(ts::DVBCharTableSingleByte::RAW_ISO_8859_15.canEncode(str1, 0, 4));
+    TSUNIT_ASSERT(!ts::DVBCharTableSingleByte::RAW_ISO_8859_15.canEncode(str1));
+    TSUNIT_ASSERT(ts::DVBCharTableSingleByte::RAW_ISO_8859_5.canEncode(str1));
+
+    // Runs of ASCII characters of all lengths, around the 16-character blocks, ending with a non-ASCII one.
+    const ts::DVBCharTableSingleByte& latin9(ts::DVBCharTableSingleByte::RAW_ISO_8859_15);
+    for (size_t len = 0; len < 50; ++len) {
+        ts::UString str2;
+        ts::ByteBlock bin2;
+        for (size_t i = 0; i < len; ++i) {
+            str2.push_back(ts::UChar(0x20 + (i * 7) % 0x5F));
+            bin2.push_back(uint8_t(str2.back()));
+        }
+        str2.push_back(ts::LATIN_SMALL_LETTER_E_WITH_ACUTE);
+        bin2.push_back(0xE9);
+        str2.append(u"~ z");
+        bin2.append("~ z", 3);
+
+        ts::UString str3;
+        TSUNIT_ASSERT(latin9.decode(str3, bin2.data(), bin2.size()));
+        TSUNIT_EQUAL(str2, str3);
+
+        uint8_t out2[64];
+        buf = out2;
+        size = sizeof(out2);
+        TSUNIT_EQUAL(str2.length(), latin9.encode(buf, size, str2));
+        TSUNIT_ASSERT(bin2 == ts::ByteBlock(out2, buf - out2));
+
+        // The encoding stops at the end of the buffer, in the middle of the ASCII run.
+        buf = out2;
+        size = len / 2;
+        TSUNIT_EQUAL(len / 2, latin9.encode(buf, size, str2));
+        TSUNIT_EQUAL(0, size);
+        TSUNIT_ASSERT(ts::ByteBlock(bin2.data(), len / 2) == ts::ByteBlock(out2, buf - out2));
+    }
+
+    // A character above the 16-bit signed range is not part of an ASCII run, it is not encodable and skipped.
+    const ts::UString str4(ts::UString(20, u'a') + ts::UString(1, ts::UChar(0xFF41)) + ts::UString(20, u'b'));
+    TSUNIT_ASSERT(!latin9.canEncode(str4));
+    uint8_t out4[64];
+    buf = out4;
+    size = sizeof(out4);
+    TSUNIT_EQUAL(41, latin9.encode(buf, size, str4));
+    ts::ByteBlock bin4(20, 'a');
+    bin4.append(ts::ByteBlock(20, 'b'));
+    TSUNIT_ASSERT(bin4 == ts::ByteBlock(out4, buf - out4));
+}
+
+TSUNIT_DEFINE_TEST(UTF8)
+{
+    const ts::UString str1({u'a', u'\r', ts::LATIN_SMALL_LETTER_E_WITH_ACUTE, ts::EURO_SIGN, 0xD83D, 0xDE00, u'z'});
+    uint8_t out[20];
+    uint8_t* buf = out;
+    size_t size = sizeof(out);
+    TSUNIT_EQUAL(str1.length(), ts::DVBCharTableUTF8::RAW_UTF_8.encode(buf, size, str1));
+    TSUNIT_ASSERT(ts::ByteBlock({'a', 0xC3, 0xA9, 0xE2, 0x82, 0xAC, 0xF0, 0x9F, 0x98, 0x80, 'z'}) == ts::ByteBlock(out, buf - out));
+    TSUNIT_EQUAL(sizeof(out) - 11, size);
+
+    // The encoding stops at the first character which does not fit.
+    buf = out;
+    size = 5;
+    TSUNIT_EQUAL(3, ts::DVBCharTableUTF8::RAW_UTF_8.encode(buf, size, str1));
+    TSUNIT_EQUAL(3, buf - out);
+    TSUNIT_EQUAL(2, size);
+}
+
+TSUNIT_DEFINE_TEST(Benchmark)
+{
+    // Typical event descriptions, in DVB default character table and UTF-8.
+    const ts::UString str1(u"The quick brown fox jumps over the lazy dog, \u00E9t\u00E9 \u00E0 la plage, news & weather at 8:00 pm.");
+    const ts::DVBCharset* const charsets[] = {&ts::DVBCharset::DVB, &ts::DVBCharTableUTF8::DVB_UTF_8};
+    constexpr size_t count = 50000;
+
+    for (const auto charset : charsets) {
+        const ts::ByteBlock bin(charset->encoded(str1));
+        TSUNIT_EQUAL(str1, charset->decoded(bin.data(), bin.size()));
+
+        auto start = cn::steady_clock::now();
+        for (size_t i = 0; i < count; ++i) {
+            uint8_t out[256];
+            uint8_t* buf = out;
+            size_t size = sizeof(out);
+            charset->encode(buf, size, str1);
+        }
+        const auto encode_duration = cn::duration_cast<cn::microseconds>(cn::steady_clock::now() - start);
+
+        start = cn::steady_clock::now();
+        ts::UString str2;
+        for (size_t i = 0; i < count; ++i) {
+            charset->decode(str2, bin.data(), bin.size());
+        }
+        const auto decode_duration = cn::duration_cast<cn::microseconds>(cn::steady_clock::now() - start);
+
+        debug() << "DVBCharsetTest::Benchmark: " << charset->name() << ", " << count << " strings"
+                << ", encode: " << encode_duration.count() << " us"
+                << ", decode: " << decode_duration.count() << " us" << std::endl;
+    }
+}
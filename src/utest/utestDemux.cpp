@@ -12,6 +12,7 @@
 
 #include "tsSectionDemux.h"
 #include "tsStandaloneTableDemux.h"
+#include "tsPESDemux.h"
 #include "tsOneShotPacketizer.h"
 #include "tsDuckContext.h"
 #include "tsTSPacket.h"
@@ -67,6 +68,9 @@ class DemuxTest: public tsunit::Test
     TSUNIT_DECLARE_TEST(TDT);
     TSUNIT_DECLARE_TEST(TOT);
     TSUNIT_DECLARE_TEST(HEVC);
+    TSUNIT_DECLARE_TEST(SectionPool);
+    TSUNIT_DECLARE_TEST(PESPool);
+    TSUNIT_DECLARE_TEST(ResetPIDInFlush);
 
 private:
     // Compare a table with the list of reference sections
@@ -77,6 +81,10 @@ private:
 
     // Unitary test for one table.
     void testTable(const char* name, const uint8_t* ref_packets, size_t ref_packets_size, const uint8_t* ref_sections, size_t ref_sections_size);
+
+    // Demux the same table many times, keeping one section out of keep_interval.
+    // Return the number of allocated sections.
+    uint64_t demuxSections(size_t pool_size, size_t repeat, size_t keep_interval);
 };
 
 TSUNIT_REGISTER(DemuxTest);
@@ -435,3 +443,225 @@ TSUNIT_DEFINE_TEST(HEVC)
 {
     TEST_TABLE("PMT with HEVC descriptor", pmt_hevc);
 }
+
+
+//----------------------------------------------------------------------------
+// Recycling of sections and PES buffers.
+//----------------------------------------------------------------------------
+
+namespace {
+    // A section handler which checks the demuxed sections and keeps some of them.
+    class SectionCollector: public ts::SectionHandlerInterface
+    {
+        TS_NOCOPY(SectionCollector);
+    public:
+        SectionCollector(const uint8_t* ref, size_t ref_size, size_t keep) : _ref(ref), _ref_size(ref_size), _keep(keep) {}
+        size_t count = 0;
+        size_t errors = 0;
+        ts::SectionPtrVector kept {};
+        virtual void handleSection(ts::SectionDemux&, const ts::Section& section) override
+        {
+            if (!section.isValid() || _offset + section.size() > _ref_size || !ts::MemEqual(_ref + _offset, section.content(), section.size())) {
+                errors++;
+            }
+            if (_keep > 0 && count % _keep == 0) {
+                // Keep a copy which shares the section data.
+                kept.push_back(std::make_shared<ts::Section>(section, ts::ShareMode::SHARE));
+            }
+            count++;
+            _offset = (_offset + section.size()) % _ref_size;
+        }
+    private:
+        const uint8_t* _ref;
+        size_t _ref_size;
+        size_t _keep;
+        size_t _offset = 0;
+    };
+}
+
+uint64_t DemuxTest::demuxSections(size_t pool_size, size_t repeat, size_t keep_interval)
+{
+    // Use a multi-section table with continuous CC across repetitions.
+    const ts::TSPacket* ref_pkt = reinterpret_cast<const ts::TSPacket*>(psi_bat_cplus_packets);
+    const size_t ref_count = sizeof(psi_bat_cplus_packets) / ts::PKT_SIZE;
+
+    ts::DuckContext duck;
+    SectionCollector collector(psi_bat_cplus_sections, sizeof(psi_bat_cplus_sections), keep_interval);
+    ts::SectionDemux demux(duck, nullptr, &collector, ts::AllPIDs);
+    demux.setSectionPoolSize(pool_size);
+
+    const auto start = cn::steady_clock::now();
+    uint8_t cc = 0;
+    for (size_t r = 0; r < repeat; ++r) {
+        for (size_t i = 0; i < ref_count; ++i) {
+            ts::TSPacket pkt(ref_pkt[i]);
+            pkt.setCC(cc++ & ts::CC_MASK);
+            demux.feedPacket(pkt);
+        }
+    }
+    const auto duration = cn::duration_cast<cn::microseconds>(cn::steady_clock::now() - start);
+
+    TSUNIT_EQUAL(0, collector.errors);
+    TSUNIT_ASSERT(collector.count >= repeat);
+    TSUNIT_EQUAL(collector.count, demux.sectionPool().allocatedCount() + demux.sectionPool().recycledCount());
+
+    // The kept sections must not have been overwritten by recycling.
+    size_t offset = 0;
+    size_t index = 0;
+    for (size_t n = 0; n < collector.count; ++n) {
+        ts::Section sect(psi_bat_cplus_sections + offset, sizeof(psi_bat_cplus_sections) - offset, ts::PID_NULL, ts::CRC32::IGNORE);
+        if (keep_interval > 0 && n % keep_interval == 0) {
+            TSUNIT_ASSERT(index < collector.kept.size());
+            TSUNIT_ASSERT(*collector.kept[index++] == sect);
+        }
+        offset = (offset + sect.size()) % sizeof(psi_bat_cplus_sections);
+    }
+
+    debug() << "DemuxTest::demuxSections: pool size: " << pool_size << ", sections: " << collector.count
+            << ", allocated: " << demux.sectionPool().allocatedCount()
+            << ", recycled: " << demux.sectionPool().recycledCount()
+            << ", duration: " << duration.count() << " us" << std::endl;
+    return demux.sectionPool().allocatedCount();
+}
+
+TSUNIT_DEFINE_TEST(SectionPool)
+{
+    constexpr size_t REPEAT = 2000;
+
+    // Without pool, one allocation per section.
+    const uint64_t no_pool = demuxSections(0, REPEAT, 0);
+
+    // With a pool and no section kept by the application, only one section is allocated.
+    TSUNIT_EQUAL(1, demuxSections(16, REPEAT, 0));
+
+    // When the application keeps some sections, the pool is still efficient.
+    const uint64_t keep = demuxSections(16, REPEAT, 10);
+    TSUNIT_ASSERT(keep < no_pool / 5);
+}
+
+namespace {
+    // A PES handler which keeps one PES packet out of keep.
+    class PESCollector: public ts::PESHandlerInterface
+    {
+    public:
+        size_t keep = 0;
+        size_t count = 0;
+        std::vector<ts::PESPacket> kept {};
+        virtual void handlePESPacket(ts::PESDemux&, const ts::PESPacket& packet) override
+        {
+            if (keep > 0 && count % keep == 0) {
+                // Keep a copy which shares the PES data with the demux.
+                kept.emplace_back(packet, ts::ShareMode::SHARE);
+            }
+            count++;
+        }
+    };
+
+    // Build a TS packet containing a complete PES packet. The payload is filled with a byte value.
+    ts::TSPacket PESTSPacket(ts::PID pid, size_t index, uint8_t value)
+    {
+        ts::TSPacket pkt;
+        pkt.init(pid, uint8_t(index & ts::CC_MASK), value);
+        pkt.setPUSI();
+        uint8_t* pl = pkt.getPayload();
+        pl[0] = pl[1] = 0x00;
+        pl[2] = 0x01;
+        pl[3] = 0xE0;
+        ts::PutUInt16(pl + 4, uint16_t(pkt.getPayloadSize() - 6));
+        pl[6] = 0x80;
+        pl[7] = pl[8] = 0x00;
+        return pkt;
+    }
+}
+
+TSUNIT_DEFINE_TEST(PESPool)
+{
+    constexpr size_t COUNT = 1000;
+    constexpr size_t KEEP = 7;
+    constexpr ts::PID PID = 100;
+
+    ts::DuckContext duck;
+    PESCollector collector;
+    ts::PESDemux demux(duck, &collector);
+
+    // The application keeps some PES packets. They must not be overwritten by subsequent PES packets.
+    collector.keep = KEEP;
+    size_t index = 0;
+    for (; index < COUNT; ++index) {
+        demux.feedPacket(PESTSPacket(PID, index, uint8_t(index)));
+    }
+    TSUNIT_EQUAL(COUNT, collector.count);
+    TSUNIT_EQUAL((COUNT + KEEP - 1) / KEEP, collector.kept.size());
+    for (size_t i = 0; i < collector.kept.size(); ++i) {
+        const ts::PESPacket& pes(collector.kept[i]);
+        TSUNIT_ASSERT(pes.isValid());
+        TSUNIT_EQUAL(175, pes.payloadSize());
+        TSUNIT_EQUAL(uint8_t(i * KEEP), pes.payload()[0]);
+    }
+
+    // A new buffer is allocated only when a PES packet is kept.
+    const uint64_t allocated = demux.bufferPool().allocatedCount();
+    TSUNIT_ASSERT(allocated <= collector.kept.size());
+
+    // Now keep all PES packets but release them immediately: the buffers are recycled.
+    collector.kept.clear();
+    collector.keep = 1;
+    const uint64_t recycled = demux.bufferPool().recycledCount();
+    for (size_t i = 0; i < 100; ++i, ++index) {
+        demux.feedPacket(PESTSPacket(PID, index, 0xFF));
+        TSUNIT_EQUAL(1, collector.kept.size());
+        TSUNIT_EQUAL(0xFF, collector.kept[0].payload()[0]);
+        collector.kept.clear();
+    }
+    TSUNIT_EQUAL(allocated, demux.bufferPool().allocatedCount());
+    TSUNIT_EQUAL(recycled + 100, demux.bufferPool().recycledCount());
+}
+
+
+//----------------------------------------------------------------------------
+// A table handler resets another PID while incomplete tables are flushed.
+//----------------------------------------------------------------------------
+
+namespace {
+    class ResetOtherPID: public ts::TableHandlerInterface
+    {
+    public:
+        ts::PID reset_pid = ts::PID_NULL;
+        std::vector<ts::PID> pids {};
+        virtual void handleTable(ts::SectionDemux& demux, const ts::BinaryTable& table) override
+        {
+            pids.push_back(table.sourcePID());
+            demux.resetPID(reset_pid);
+        }
+    };
+}
+
+TSUNIT_DEFINE_TEST(ResetPIDInFlush)
+{
+    ts::DuckContext duck;
+    ResetOtherPID handler;
+    ts::SectionDemux demux(duck, &handler, nullptr, ts::AllPIDs);
+
+    // On several PID's, send the first section of a table with two sections.
+    const uint8_t payload[] = {0x01, 0x02, 0x03, 0x04};
+    const ts::Section sect(ts::TID_SDT_ACT, false, 0x1234, 1, true, 0, 1, payload, sizeof(payload));
+    TSUNIT_ASSERT(sect.isValid());
+    const ts::PID pids[] = {100, 200, 300, 400};
+    for (auto pid : pids) {
+        ts::TSPacket pkt;
+        pkt.init(pid, 0, 0xFF);
+        pkt.setPUSI();
+        pkt.b[4] = 0; // pointer field
+        ts::MemCopy(pkt.b + 5, sect.content(), sect.size());
+        demux.feedPacket(pkt);
+    }
+    TSUNIT_ASSERT(handler.pids.empty());
+
+    // When the table on PID 100 is notified, the handler resets PID 200.
+    handler.reset_pid = 200;
+    demux.packAndFlushSections();
+    TSUNIT_EQUAL(3, handler.pids.size());
+    TSUNIT_EQUAL(100, handler.pids[0]);
+    TSUNIT_EQUAL(300, handler.pids[1]);
+    TSUNIT_EQUAL(400, handler.pids[2]);
+}
@@ -0,0 +1,235 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2024, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//
+//  TSUnit test suite for class ts::EITGenerator
+//
+//----------------------------------------------------------------------------
+
+#include "tsEITGenerator.h"
+#include "tsDuckContext.h"
+#include "tsEIT.h"
+#include "tsMJD.h"
+#include "tsBCD.h"
+#include "tsunit.h"
+#include "utestTSUnitBenchmark.h"
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class EITGeneratorTest: public tsunit::Test
+{
+    TSUNIT_DECLARE_TEST(Incremental);
+    TSUNIT_DECLARE_TEST(Benchmark);
+
+private:
+    // Reference time of the tests.
+    static const ts::Time _now;
+
+    // Number of days of EPG and event duration in the tests.
+    static constexpr size_t EPG_DAYS = 8;
+    static constexpr cn::minutes EVENT_DURATION = cn::minutes(30);
+
+    // Build the binary description of one event.
+    static void AddEvent(ts::ByteBlock& data, uint16_t event_id, const ts::Time& start, uint16_t variant);
+
+    // Service id of a service index.
+    static ts::ServiceIdTriplet ServiceId(size_t index);
+
+    // Load a complete EPG for some services in an EIT generator.
+    static void LoadEPG(ts::EITGenerator& gen, size_t srv_count);
+
+    // Get a copy of the binary content of all EIT sections of an EIT generator.
+    static void SaveEITs(ts::EITGenerator& gen, std::vector<ts::ByteBlock>& secs);
+
+    // Count modified sections.
+    static size_t CountModified(const std::vector<ts::ByteBlock>& secs1, const std::vector<ts::ByteBlock>& secs2);
+
+    // Load an EPG, modify it and report the regeneration durations.
+    void regenerate(size_t srv_count);
+};
+
+TSUNIT_REGISTER(EITGeneratorTest);
+
+const ts::Time EITGeneratorTest::_now(2024, 3, 1, 10, 0);
+
+
+//----------------------------------------------------------------------------
+// Test helpers.
+//----------------------------------------------------------------------------
+
+void EITGeneratorTest::AddEvent(ts::ByteBlock& data, uint16_t event_id, const ts::Time& start, uint16_t variant)
+{
+    uint8_t* ev = data.enlarge(ts::EIT::EIT_EVENT_FIXED_SIZE + 4);
+    ts::PutUInt16(ev, event_id);
+    ts::EncodeMJD(start, ev + 2, ts::MJD_SIZE);
+    ev[7] = ts::EncodeBCD(0);
+    ev[8] = ts::EncodeBCD(int(EVENT_DURATION.count()));
+    ev[9] = ts::EncodeBCD(0);
+    ts::PutUInt16(ev + 10, 0x8000 | 4);  // running, 4 bytes of descriptors
+    ev[12] = 0x80;                       // user-defined descriptor tag
+    ev[13] = 2;
+    ts::PutUInt16(ev + 14, variant);
+}
+
+ts::ServiceIdTriplet EITGeneratorTest::ServiceId(size_t index)
+{
+    // Half of the services in the actual TS (id 1), half in another one.
+    return ts::ServiceIdTriplet(uint16_t(100 + index), uint16_t(1 + index % 2), 1000);
+}
+
+void EITGeneratorTest::LoadEPG(ts::EITGenerator& gen, size_t srv_count)
+{
+    const ts::Time midnight(_now.thisDay());
+    for (size_t srv = 0; srv < srv_count; ++srv) {
+        ts::ByteBlock data;
+        uint16_t event_id = 0;
+        for (ts::Time start(midnight); start < midnight + cn::days(EPG_DAYS); start += EVENT_DURATION) {
+            AddEvent(data, event_id++, start, 0);
+        }
+        TSUNIT_ASSERT(gen.loadEvents(ServiceId(srv), data.data(), data.size()));
+    }
+}
+
+void EITGeneratorTest::SaveEITs(ts::EITGenerator& gen, std::vector<ts::ByteBlock>& secs)
+{
+    ts::SectionPtrVector sections;
+    gen.saveEITs(sections);
+    secs.clear();
+    for (const auto& sec : sections) {
+        TSUNIT_ASSERT(sec != nullptr);
+        TSUNIT_ASSERT(sec->isValid());
+        TSUNIT_ASSERT(ts::EIT::IsEIT(sec->tableId()));
+        secs.emplace_back(sec->content(), sec->size());
+    }
+}
+
+size_t EITGeneratorTest::CountModified(const std::vector<ts::ByteBlock>& secs1, const std::vector<ts::ByteBlock>& secs2)
+{
+    TSUNIT_EQUAL(secs1.size(), secs2.size());
+    size_t count = 0;
+    for (size_t i = 0; i < secs1.size() && i < secs2.size(); ++i) {
+        if (secs1[i] != secs2[i]) {
+            count++;
+        }
+    }
+    return count;
+}
+
+void EITGeneratorTest::regenerate(size_t srv_count)
+{
+    ts::DuckContext duck;
+    ts::EITGenerator gen(duck, ts::PID_EIT, ts::EITOptions::GEN_ALL);
+    gen.setTransportStreamId(1);
+    gen.setCurrentTime(_now);
+
+    // Initial load and generation of all sections.
+    ts::SectionPtrVector secs;
+    auto start = cn::steady_clock::now();
+    LoadEPG(gen, srv_count);
+    gen.saveEITs(secs);
+    const auto full_duration = cn::duration_cast<cn::microseconds>(cn::steady_clock::now() - start);
+    std::vector<ts::ByteBlock> secs1;
+    SaveEITs(gen, secs1);
+
+    // Modify one event in the middle of the EPG of one service.
+    ts::ByteBlock data;
+    AddEvent(data, 200, _now.thisDay() + cn::days(4) + cn::hours(4), 1);
+    start = cn::steady_clock::now();
+    TSUNIT_ASSERT(gen.loadEvents(ServiceId(srv_count / 2), data.data(), data.size()));
+    gen.saveEITs(secs);
+    const auto update_duration = cn::duration_cast<cn::microseconds>(cn::steady_clock::now() - start);
+    std::vector<ts::ByteBlock> secs2;
+    SaveEITs(gen, secs2);
+
+    // Only the section which contains the modified event is regenerated.
+    TSUNIT_EQUAL(1, CountModified(secs1, secs2));
+
+    debug() << "EITGeneratorTest::regenerate: services: " << srv_count
+            << ", events: " << (srv_count * EPG_DAYS * cn::days(1) / EVENT_DURATION)
+            << ", sections: " << secs1.size()
+            << ", full: " << full_duration.count() << " us"
+            << ", update: " << update_duration.count() << " us" << std::endl;
+}
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+TSUNIT_DEFINE_TEST(Incremental)
+{
+    constexpr size_t srv_count = 4;
+
+    TSUNIT_ASSERT(ts::EIT::SegmentStartTime(ts::Time(2024, 3, 1, 11, 59, 59, 999)) == ts::Time(2024, 3, 1, 9, 0));
+    TSUNIT_ASSERT(ts::EIT::SegmentStartTime(ts::Time(2024, 3, 1, 12, 0)) == ts::Time(2024, 3, 1, 12, 0));
+
+    ts::DuckContext duck;
+    ts::EITGenerator gen(duck, ts::PID_EIT, ts::EITOptions::GEN_ALL);
+    gen.setTransportStreamId(1);
+    gen.setCurrentTime(_now);
+    LoadEPG(gen, srv_count);
+
+    // One EIT p/f pair and one EIT schedule section per 3-hour segment in each service.
+    std::vector<ts::ByteBlock> secs1;
+    SaveEITs(gen, secs1);
+    const size_t segments = EPG_DAYS * cn::days(1) / ts::EIT::SEGMENT_DURATION;
+    TSUNIT_EQUAL(srv_count * (2 + segments), secs1.size());
+
+    // Reloading the same events does not modify anything.
+    LoadEPG(gen, srv_count);
+    std::vector<ts::ByteBlock> secs2;
+    SaveEITs(gen, secs2);
+    TSUNIT_EQUAL(0, CountModified(secs1, secs2));
+
+    // Modify the current event of a service: only its EIT present and the schedule section of the event are regenerated.
+    ts::ByteBlock data;
+    AddEvent(data, 20, _now, 1);
+    TSUNIT_ASSERT(gen.loadEvents(ServiceId(1), data.data(), data.size()));
+    std::vector<ts::ByteBlock> secs3;
+    SaveEITs(gen, secs3);
+    TSUNIT_EQUAL(secs1.size(), secs3.size());
+    TSUNIT_EQUAL(2, CountModified(secs2, secs3));
+    for (size_t i = 0; i < secs3.size(); ++i) {
+        if (secs2[i] != secs3[i]) {
+            TSUNIT_EQUAL(ServiceId(1).service_id, ts::GetUInt16(secs3[i].data() + 3));
+            TSUNIT_ASSERT(secs3[i][0] == ts::TID_EIT_PF_OTH || secs3[i][0] == ts::TID_EIT_S_OTH_MIN);
+        }
+    }
+
+    // Move an event to another segment of the same service.
+    data.clear();
+    AddEvent(data, 100, _now.thisDay() + cn::days(3) + cn::minutes(15), 2);
+    TSUNIT_ASSERT(gen.loadEvents(ServiceId(3), data.data(), data.size()));
+    std::vector<ts::ByteBlock> secs4;
+    SaveEITs(gen, secs4);
+    TSUNIT_EQUAL(secs1.size(), secs4.size());
+    TSUNIT_EQUAL(2, CountModified(secs3, secs4));
+}
+
+//----------------------------------------------------------------------------
+// Regeneration times of large EPG's. By default, only a small EPG is checked.
+// Define the environment variable TSUNIT_EITGEN_ITERATIONS to run a benchmark
+// on larger EPG's and report the regeneration times (with utest -d).
+//----------------------------------------------------------------------------
+
+TSUNIT_DEFINE_TEST(Benchmark)
+{
+    utest::TSUnitBenchmark bench(u"TSUNIT_EITGEN_ITERATIONS");
+    if (!bench.requested) {
+        regenerate(10);
+    }
+    else {
+        for (size_t iter = 0; iter < bench.iterations; ++iter) {
+            regenerate(10);
+            regenerate(100);
+            regenerate(300);
+        }
+    }
+}
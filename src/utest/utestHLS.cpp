@@ -11,6 +11,18 @@
 //----------------------------------------------------------------------------
 
 #include "tshlsPlayList.h"
+#include "tshlsSegmentPrefetcher.h"
+#include "tshlsOriginServer.h"
+#include "tsTCPServer.h"
+#include "tsTSProcessor.h"
+#include "tsReportBuffer.h"
+#include "tsIPUtils.h"
+#include "tsNullReport.h"
+#include "tsTS.h"
+#include "tsFileUtils.h"
+#include "tsErrCodeReport.h"
+#include "tsCerrReport.h"
+#include "utestTSUnitThread.h"
 #include "tsunit.h"
 
 
@@ -25,6 +37,10 @@ class HLSTest: public tsunit::Test
     TSUNIT_DECLARE_TEST(MediaPlaylist);
     TSUNIT_DECLARE_TEST(BuildMasterPlaylist);
     TSUNIT_DECLARE_TEST(BuildMediaPlaylist);
+    TSUNIT_DECLARE_TEST(Prefetch);
+    TSUNIT_DECLARE_TEST(OriginServer);
+    TSUNIT_DECLARE_TEST(OriginServerLimits);
+    TSUNIT_DECLARE_TEST(OutputWriter);
 
 public:
     virtual void beforeTest() override;
@@ -32,6 +48,13 @@ public:
 
 private:
     int _previousSeverity = 0;
+    fs::path _tempDir {};
+
+    // Send a raw request to a server and return the response, until the server closes the connection.
+    static std::string RawRequest(uint16_t port, const std::string& request);
+
+    // Run a tsp session with null packets and the "hls" output plugin.
+    static void RunOutput(size_t packets, const ts::UStringVector& args, ts::Report& report);
 };
 
 TSUNIT_REGISTER(HLSTest);
@@ -48,12 +71,17 @@ void HLSTest::beforeTest()
     if (tsunit::Test::debugMode()) {
         CERR.setMaxSeverity(ts::Severity::Debug);
     }
+    if (_tempDir.empty()) {
+        _tempDir = ts::TempFile(u".hls");
+    }
+    fs::remove_all(_tempDir, &ts::ErrCodeReport());
 }
 
 // Test suite cleanup method.
 void HLSTest::afterTest()
 {
     CERR.setMaxSeverity(_previousSeverity);
+    fs::remove_all(_tempDir, &ts::ErrCodeReport());
 }
 
 
@@ -361,3 +389,389 @@ TSUNIT_DEFINE_TEST(BuildMediaPlaylist)
 
     TSUNIT_EQUAL(refContent2, pl.textContent());
 }
+
+// A minimal HTTP server thread, serving a canned media playlist and its segments.
+// Each connection is handled in its own thread and supports keep-alive.
+namespace {
+    class HTTPServer: public utest::TSUnitThread
+    {
+        TS_NOBUILD_NOCOPY(HTTPServer);
+    public:
+        static constexpr size_t SEGMENT_COUNT = 8;
+
+        // Number of packets in a segment, all packets in segment 'index' are filled with 'index'.
+        static size_t SegmentPackets(size_t index) { return 10 * (index + 1); }
+
+        explicit HTTPServer(uint16_t port) : utest::TSUnitThread(), _port(port) {}
+        virtual ~HTTPServer() override { waitForTermination(); }
+
+        // Wait until the server is ready to accept connections.
+        void waitReady()
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _ready_cond.wait(lock, [this]() { return _ready; });
+        }
+
+        // Terminate the server.
+        void terminate()
+        {
+            _terminate = true;
+            // Wake up the accept() with a dummy connection.
+            ts::TCPConnection dummy;
+            dummy.open(CERR);
+            dummy.connect(ts::IPv4SocketAddress(ts::IPv4Address::LocalHost, _port), CERR);
+            waitForTermination();
+            dummy.close(CERR);
+        }
+
+        // Number of client connections with at least one request and total number of requests.
+        size_t connections() const { return _connections; }
+        size_t requests() const { return _requests; }
+
+        // Number of segment requests with the cookie which is set by the playlist.
+        size_t cookieRequests() const { return _cookie_requests; }
+
+        virtual void test() override
+        {
+            ts::TCPServer server;
+            TSUNIT_ASSERT(server.open(CERR));
+            TSUNIT_ASSERT(server.reusePort(true, CERR));
+            TSUNIT_ASSERT(server.bind(ts::IPv4SocketAddress(ts::IPv4Address::LocalHost, _port), CERR));
+            TSUNIT_ASSERT(server.listen(10, CERR));
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _ready = true;
+            }
+            _ready_cond.notify_all();
+
+            std::list<std::unique_ptr<Connection>> clients;
+            while (!_terminate) {
+                clients.push_back(std::make_unique<Connection>(this));
+                ts::IPv4SocketAddress addr;
+                TSUNIT_ASSERT(server.accept(clients.back()->session, addr, CERR));
+                if (!_terminate) {
+                    clients.back()->start();
+                }
+            }
+            server.close(CERR);
+            // Deallocating the clients waits for the end of their sessions.
+        }
+
+    private:
+        // One client connection.
+        class Connection: public utest::TSUnitThread
+        {
+            TS_NOBUILD_NOCOPY(Connection);
+        public:
+            ts::TCPConnection session {};
+            explicit Connection(HTTPServer* server) : utest::TSUnitThread(), _server(server) {}
+            virtual ~Connection() override { waitForTermination(); }
+
+            virtual void test() override
+            {
+                std::string input;
+                bool first = true;
+                char buffer[1024];
+                size_t size = 0;
+                while (session.receive(buffer, sizeof(buffer), size, nullptr, NULLREP)) {
+                    input.append(buffer, size);
+                    size_t end = 0;
+                    while ((end = input.find("\r\n\r\n")) != std::string::npos) {
+                        const std::string request(input.substr(0, end));
+                        input.erase(0, end + 4);
+                        if (first) {
+                            first = false;
+                            _server->_connections++;
+                        }
+                        _server->_requests++;
+                        TSUNIT_ASSERT(respond(request));
+                    }
+                }
+                session.close(NULLREP);
+            }
+
+        private:
+            HTTPServer* _server;
+
+            // Send the response to one request.
+            bool respond(const std::string& request)
+            {
+                // Request line: GET /path HTTP/1.1
+                const size_t start = request.find(' ') + 1;
+                const std::string path(request.substr(start, request.find(' ', start) - start));
+                CERR.debug(u"HTTPServer: request for %s", path);
+
+                std::string type;
+                std::string cookie;
+                ts::ByteBlock content;
+                size_t index = 0;
+                if (path == "/hls/playlist.m3u8") {
+                    type = "application/vnd.apple.mpegurl";
+                    cookie = "token=hls";
+                    std::string text("#EXTM3U\n#EXT-X-VERSION:3\n#EXT-X-TARGETDURATION:2\n#EXT-X-PLAYLIST-TYPE:VOD\n");
+                    for (size_t i = 0; i < SEGMENT_COUNT; ++i) {
+                        text += "#EXTINF:2.0,\nseg" + std::to_string(i) + ".ts\n";
+                    }
+                    text += "#EXT-X-ENDLIST\n";
+                    content.append(text.data(), text.size());
+                }
+                else if (std::sscanf(path.c_str(), "/hls/seg%zu.ts", &index) == 1 && index < SEGMENT_COUNT) {
+                    // Make the first segments the slowest ones, to complete downloads out of order.
+                    std::this_thread::sleep_for(cn::milliseconds(20 * (SEGMENT_COUNT - index)));
+                    type = "video/mp2t";
+                    cookie = "seg" + std::to_string(index) + "=done";
+                    if (request.find("token=hls") != std::string::npos) {
+                        _server->_cookie_requests++;
+                    }
+                    content.resize(SegmentPackets(index) * ts::PKT_SIZE, uint8_t(index));
+                    for (size_t i = 0; i < content.size(); i += ts::PKT_SIZE) {
+                        content[i] = ts::SYNC_BYTE;
+                    }
+                }
+                else {
+                    const std::string response("HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n\r\n");
+                    return session.send(response.data(), response.size(), CERR);
+                }
+
+                const std::string header("HTTP/1.1 200 OK\r\nContent-Type: " + type +
+                                         "\r\nContent-Length: " + std::to_string(content.size()) +
+                                         "\r\nSet-Cookie: " + cookie + "; Path=/" +
+                                         "\r\nConnection: keep-alive\r\n\r\n");
+                return session.send(header.data(), header.size(), CERR) && session.send(content.data(), content.size(), CERR);
+            }
+        };
+
+        uint16_t                _port;
+        volatile bool           _terminate = false;
+        std::atomic<size_t>     _connections {0};
+        std::atomic<size_t>     _requests {0};
+        std::atomic<size_t>     _cookie_requests {0};
+        std::mutex              _mutex {};
+        std::condition_variable _ready_cond {};
+        bool                    _ready = false;
+    };
+}
+
+TSUNIT_DEFINE_TEST(Prefetch)
+{
+    TSUNIT_ASSERT(ts::IPInitialize());
+
+    const uint16_t port = 12346;
+    HTTPServer server(port);
+    server.start();
+    server.waitReady();
+
+    // Load the canned playlist, using a cookies file as the hls plugin does.
+    ts::WebRequestArgs args;
+    args.useCookies = true;
+    args.cookiesFile = ts::TempFile(u".cookies");
+    const ts::UString url(ts::UString::Format(u"http://127.0.0.1:%d/hls/playlist.m3u8", port));
+    ts::hls::PlayList pl;
+    TSUNIT_ASSERT(pl.loadURL(url, false, args, ts::hls::PlayListType::UNKNOWN, CERR));
+    TSUNIT_EQUAL(ts::hls::PlayListType::VOD, pl.type());
+    TSUNIT_EQUAL(HTTPServer::SEGMENT_COUNT, pl.segmentCount());
+
+    // Download all segments with 3 concurrent connections.
+    {
+        ts::hls::SegmentPrefetcher prefetcher(CERR);
+        TSUNIT_ASSERT(prefetcher.start(args, 3));
+
+        size_t index = 0;
+        ts::hls::MediaSegment seg;
+        while (index < HTTPServer::SEGMENT_COUNT) {
+            while (prefetcher.needMore() && pl.popFirstSegment(seg)) {
+                prefetcher.addSegment(seg.urlString());
+            }
+            TSUNIT_ASSERT(prefetcher.pendingSegments() <= 3);
+
+            ts::ByteBlock data;
+            ts::UString segURL;
+            TSUNIT_ASSERT(prefetcher.getSegment(data, segURL));
+            TSUNIT_EQUAL(ts::UString::Format(u"http://127.0.0.1:%d/hls/seg%d.ts", port, index), segURL);
+            TSUNIT_EQUAL(HTTPServer::SegmentPackets(index) * ts::PKT_SIZE, data.size());
+            TSUNIT_EQUAL(ts::SYNC_BYTE, data[0]);
+            TSUNIT_EQUAL(index, data[1]);
+            index++;
+        }
+        TSUNIT_EQUAL(0, prefetcher.pendingSegments());
+
+        ts::ByteBlock data;
+        ts::UString segURL;
+        TSUNIT_ASSERT(!prefetcher.getSegment(data, segURL));
+
+        const ts::hls::SegmentPrefetcher::Statistics stats(prefetcher.getStatistics());
+        TSUNIT_EQUAL(HTTPServer::SEGMENT_COUNT, stats.segments);
+        TSUNIT_EQUAL(0, stats.errors);
+        TSUNIT_ASSERT(stats.max_ready >= 1);
+        TSUNIT_ASSERT(stats.max_ready <= 3);
+        TSUNIT_ASSERT(stats.globalBitRate() > 0);
+        prefetcher.stop();
+    }
+
+    server.terminate();
+
+    // One request for the playlist and one per segment.
+    // Connections are reused: one for the playlist and at most one per download thread.
+    TSUNIT_EQUAL(HTTPServer::SEGMENT_COUNT + 1, server.requests());
+    TSUNIT_ASSERT(server.connections() <= 4);
+
+#if !defined(TS_WINDOWS)
+    // All segment requests use the cookie from the playlist. The cookies of the segments are
+    // kept in the private cookies files of the download threads, not in the shared one.
+    TSUNIT_EQUAL(HTTPServer::SEGMENT_COUNT, server.cookieRequests());
+    ts::UStringList cookies;
+    TSUNIT_ASSERT(ts::UString::Load(cookies, args.cookiesFile));
+    debug() << "HLSTest::Prefetch: cookies file:" << std::endl << ts::UString::Join(cookies, u"\n") << std::endl;
+    TSUNIT_ASSERT(std::any_of(cookies.begin(), cookies.end(), [](const ts::UString& line) { return line.contain(u"token"); }));
+    TSUNIT_ASSERT(std::none_of(cookies.begin(), cookies.end(), [](const ts::UString& line) { return line.contain(u"done"); }));
+#endif
+    fs::remove(args.cookiesFile, &ts::ErrCodeReport());
+}
+
+TSUNIT_DEFINE_TEST(OriginServer)
+{
+    TSUNIT_ASSERT(ts::IPInitialize());
+
+    const uint16_t port = 12347;
+    ts::hls::OriginServer server(CERR);
+    TSUNIT_ASSERT(server.start(ts::IPv4SocketAddress(ts::IPv4Address::LocalHost, port)));
+
+    auto seg = std::make_shared<ts::ByteBlock>(10 * ts::PKT_SIZE, 0x47);
+    auto text = std::make_shared<ts::ByteBlock>();
+    text->appendUTF8(u"#EXTM3U\n#EXT-X-TARGETDURATION:2\n#EXTINF:2.0,\nseg-000000.ts\n");
+    server.setFile(u"seg-000000.ts", seg, u"video/mp2t");
+    server.setFile(u"playlist.m3u8", text, u"application/vnd.apple.mpegurl");
+    TSUNIT_ASSERT(server.hasFile(u"seg-000000.ts"));
+
+    // Successive requests using the same connection.
+    const ts::UString base(ts::UString::Format(u"http://127.0.0.1:%d/", port));
+    ts::WebRequest request(CERR);
+    ts::ByteBlock data;
+    TSUNIT_ASSERT(request.downloadBinaryContent(base + u"playlist.m3u8", data));
+    TSUNIT_EQUAL(u"application/vnd.apple.mpegurl", request.mimeType());
+    TSUNIT_ASSERT(data == *text);
+    TSUNIT_ASSERT(request.downloadBinaryContent(base + u"seg-000000.ts", data));
+    TSUNIT_EQUAL(u"video/mp2t", request.mimeType());
+    TSUNIT_ASSERT(data == *seg);
+
+    // Removed files are no longer served.
+    server.removeFile(u"seg-000000.ts");
+    TSUNIT_ASSERT(!server.hasFile(u"seg-000000.ts"));
+    TSUNIT_ASSERT(request.downloadBinaryContent(base + u"seg-000000.ts", data));
+    TSUNIT_EQUAL(404, request.httpStatus());
+    TSUNIT_ASSERT(data.empty());
+
+    server.stop();
+}
+
+std::string HLSTest::RawRequest(uint16_t port, const std::string& request)
+{
+    ts::TCPConnection session;
+    TSUNIT_ASSERT(session.open(CERR));
+    TSUNIT_ASSERT(session.connect(ts::IPv4SocketAddress(ts::IPv4Address::LocalHost, port), CERR));
+    TSUNIT_ASSERT(request.empty() || session.send(request.data(), request.size(), CERR));
+    std::string response;
+    char buffer[1024];
+    size_t size = 0;
+    while (session.receive(buffer, sizeof(buffer), size, nullptr, NULLREP)) {
+        response.append(buffer, size);
+    }
+    session.close(NULLREP);
+    return response;
+}
+
+TSUNIT_DEFINE_TEST(OriginServerLimits)
+{
+    TSUNIT_ASSERT(ts::IPInitialize());
+
+    const uint16_t port = 12347;
+    ts::hls::OriginServer server(CERR);
+    server.setMaxClients(1);
+    TSUNIT_ASSERT(server.start(ts::IPv4SocketAddress(ts::IPv4Address::LocalHost, port)));
+
+    // Request headers are bounded, the connection is closed after the error.
+    const std::string large("GET /playlist.m3u8 HTTP/1.1\r\nX-Large: " + std::string(ts::hls::OriginServer::MAX_HEADER_SIZE, 'x') + "\r\n\r\n");
+    std::string response(RawRequest(port, large));
+    debug() << "HLSTest::OriginServerLimits: " << response << std::endl;
+    TSUNIT_ASSERT(response.find("HTTP/1.1 431 ") == 0);
+
+    // A normal request on a closing connection. The thread of the previous client may
+    // still be terminating after the disconnection, retry while the server is full.
+    for (int retry = 0; retry < 50; ++retry) {
+        response = RawRequest(port, "GET /playlist.m3u8 HTTP/1.1\r\nConnection: close\r\n\r\n");
+        if (response.find("HTTP/1.1 503 ") != 0) {
+            break;
+        }
+        std::this_thread::sleep_for(cn::milliseconds(20));
+    }
+    TSUNIT_ASSERT(response.find("HTTP/1.1 404 ") == 0);
+
+    // While a first client is connected, a second one is rejected.
+    {
+        ts::TCPConnection first;
+        TSUNIT_ASSERT(first.open(CERR));
+        TSUNIT_ASSERT(first.connect(ts::IPv4SocketAddress(ts::IPv4Address::LocalHost, port), CERR));
+        response = RawRequest(port, std::string());
+        TSUNIT_ASSERT(response.find("HTTP/1.1 503 ") == 0);
+        first.close(NULLREP);
+    }
+
+    server.stop();
+    // Stopping twice is harmless.
+    server.stop();
+}
+
+void HLSTest::RunOutput(size_t packets, const ts::UStringVector& args, ts::Report& report)
+{
+    ts::TSProcessorArgs opt;
+    opt.app_name = u"HLSTest";
+    opt.input = {u"null", {ts::UString::Decimal(packets, 0, true, u"")}};
+    opt.output = {u"hls", args};
+    ts::TSProcessor tsproc(report);
+    TSUNIT_ASSERT(tsproc.start(opt));
+    tsproc.waitForTermination();
+}
+
+TSUNIT_DEFINE_TEST(OutputWriter)
+{
+    // Segments of 100 packets, completed segments are written in the background.
+    static constexpr size_t SEG_PACKETS = 100;
+    const ts::UString segSize(ts::UString::Decimal(SEG_PACKETS * ts::PKT_SIZE, 0, true, u""));
+    TSUNIT_ASSERT(fs::create_directory(_tempDir));
+    const ts::UString segTemplate(_tempDir / u"seg.ts");
+    const ts::UString playlist(_tempDir / u"playlist.m3u8");
+    const auto segFile = [this](size_t index) { return _tempDir / ts::UString::Format(u"seg-%06d.ts", index); };
+
+    // VoD: all segments are kept, the last one is incomplete.
+    RunOutput(10 * SEG_PACKETS + 50, {u"--fixed-segment-size", segSize, u"--playlist", playlist, segTemplate}, CERR);
+    for (size_t i = 0; i < 10; ++i) {
+        TSUNIT_EQUAL(SEG_PACKETS * ts::PKT_SIZE, fs::file_size(segFile(i)));
+    }
+    TSUNIT_EQUAL(50 * ts::PKT_SIZE, fs::file_size(segFile(10)));
+    TSUNIT_ASSERT(!fs::exists(segFile(11)));
+
+    ts::hls::PlayList pl;
+    TSUNIT_ASSERT(pl.loadFile(playlist, true, ts::hls::PlayListType::UNKNOWN, CERR));
+    TSUNIT_EQUAL(ts::hls::PlayListType::VOD, pl.type());
+    TSUNIT_EQUAL(11, pl.segmentCount());
+    TSUNIT_ASSERT(pl.endList());
+    TSUNIT_EQUAL(u"seg-000010.ts", pl.segment(10).relativeURI);
+
+    // Live: obsolete segment files are deleted by the writer thread.
+    fs::remove_all(_tempDir, &ts::ErrCodeReport());
+    TSUNIT_ASSERT(fs::create_directory(_tempDir));
+    RunOutput(10 * SEG_PACKETS, {u"--fixed-segment-size", segSize, u"--live", u"3", u"--live-extra-segments", u"1", u"--playlist", playlist, segTemplate}, CERR);
+    for (size_t i = 0; i < 10; ++i) {
+        TSUNIT_EQUAL(i >= 6, fs::exists(segFile(i)));
+    }
+    TSUNIT_ASSERT(pl.loadFile(playlist, true, ts::hls::PlayListType::UNKNOWN, CERR));
+    TSUNIT_EQUAL(ts::hls::PlayListType::LIVE, pl.type());
+    TSUNIT_EQUAL(3, pl.segmentCount());
+    TSUNIT_EQUAL(u"seg-000007.ts", pl.segment(0).relativeURI);
+
+    // Errors in the writer thread stop the stream.
+    ts::ReportBuffer<ts::ThreadSafety::Full> log;
+    RunOutput(10 * SEG_PACKETS, {u"--fixed-segment-size", segSize, ts::UString(_tempDir / u"nodir" / u"seg.ts")}, log);
+    debug() << "HLSTest::OutputWriter: " << log.messages() << std::endl;
+    TSUNIT_ASSERT(log.gotErrors());
+}
@@ -23,6 +23,7 @@
 #include "tsCerrReport.h"
 #include "tsNullReport.h"
 #include "tsunit.h"
+#include "utestTSUnitBenchmark.h"
 
 
 //----------------------------------------------------------------------------
@@ -39,6 +40,8 @@ class JsonTest: public tsunit::Test
     TSUNIT_DECLARE_TEST(RunningDocumentEmpty);
     TSUNIT_DECLARE_TEST(RunningDocument);
     TSUNIT_DECLARE_TEST(Issue1353);
+    TSUNIT_DECLARE_TEST(Escape);
+    TSUNIT_DECLARE_TEST(Benchmark);
 
 public:
     virtual void beforeTest() override;
@@ -886,3 +889,66 @@ TSUNIT_DEFINE_TEST(Issue1353)
                  "\"f5\": 1.2e-5, \"f6\": 1.2e-6, \"f7\": 1.2e-7, \"f8\": 1.2e-8, \"f9\": 1.2e-9 }",
                  root.oneLiner(CERR));
 }
+
+TSUNIT_DEFINE_TEST(Escape)
+{
+    const ts::UString str({u'a', u'"', u'\\', u'/', u'\b', u'\f', u'\n', u'\r', u'\t', u'\x01', u'~', u'\x7F', ts::LATIN_SMALL_LETTER_E_WITH_ACUTE, u'z'});
+    const ts::UString expected(u"\"a\\\"\\\\/\\b\\f\\n\\r\\t\\u0001~\\u007F\\u00E9z\"");
+
+    TSUNIT_EQUAL(expected, u'"' + str.toJSON() + u'"');
+    TSUNIT_EQUAL(expected, ts::json::String(str).oneLiner(CERR));
+
+    ts::json::Object obj;
+    obj.add(str, -12345678901);
+    TSUNIT_EQUAL(u"{ " + expected + u": -12345678901 }", obj.oneLiner(CERR));
+}
+
+TSUNIT_DEFINE_TEST(Benchmark)
+{
+    // Build and print a running document, similar to "tstables --json-output".
+    // By default, use a small document. With TSUNIT_JSON_ITERATIONS, use that number of tables
+    // (e.g. 20000 tables for a 34 MB document).
+    utest::TSUnitBenchmark bench(u"TSUNIT_JSON_ITERATIONS");
+    const size_t count = bench.requested ? bench.iterations : 100;
+    ts::json::RunningDocument doc(CERR);
+    TSUNIT_ASSERT(doc.open(nullptr, _tempFileName));
+
+    auto start = cn::steady_clock::now();
+    cn::microseconds build_duration(0);
+    for (size_t i = 0; i < count; ++i) {
+        const auto build_start = cn::steady_clock::now();
+        ts::json::Object table;
+        table.add(u"#name", u"SDT");
+        table.add(u"version", int64_t(i % 32));
+        table.add(u"current", ts::json::Bool(true));
+        table.add(u"actual", ts::json::Bool(true));
+        table.add(u"transport_stream_id", int64_t(i));
+        table.add(u"original_network_id", int64_t(0x20FA));
+        ts::json::Value& services(table.value(u"#nodes", true, ts::json::Type::Array));
+        for (size_t srv = 0; srv < 8; ++srv) {
+            ts::json::ValuePtr service(new ts::json::Object);
+            service->add(u"#name", u"service");
+            service->add(u"service_id", int64_t(srv + 1));
+            service->add(u"EIT_schedule", ts::json::Bool(false));
+            service->add(u"running_status", u"running");
+            service->add(u"service_name", ts::UString::Format(u"Service \"%d\" \u00E9t\u00E9", srv));
+            services.set(service);
+        }
+        build_duration += cn::duration_cast<cn::microseconds>(cn::steady_clock::now() - build_start);
+        doc.add(table);
+    }
+    doc.close();
+    const auto total_duration = cn::duration_cast<cn::microseconds>(cn::steady_clock::now() - start);
+    const auto file_size = fs::file_size(_tempFileName);
+
+    // Check that the output is valid JSON.
+    ts::json::ValuePtr root;
+    TSUNIT_ASSERT(ts::json::LoadFile(root, _tempFileName, CERR));
+    TSUNIT_ASSERT(root != nullptr);
+    TSUNIT_EQUAL(count, root->size());
+    TSUNIT_EQUAL(u"Service \"7\" \u00E9t\u00E9", root->at(count - 1).value(u"#nodes").at(7).value(u"service_name").toString());
+
+    debug() << "JsonTest::Benchmark: " << count << " objects, " << file_size << " bytes"
+            << ", build: " << build_duration.count() << " us"
+            << ", print: " << (total_duration - build_duration).count() << " us" << std::endl;
+}
@@ -0,0 +1,138 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2024, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//
+//  TSUnit test suite for class ts::LockFreeQueue
+//
+//----------------------------------------------------------------------------
+
+#include "tsLockFreeQueue.h"
+#include "tsunit.h"
+#include "utestTSUnitThread.h"
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class LockFreeQueueTest: public tsunit::Test
+{
+    TSUNIT_DECLARE_TEST(Capacity);
+    TSUNIT_DECLARE_TEST(PushPop);
+    TSUNIT_DECLARE_TEST(Threads);
+};
+
+TSUNIT_REGISTER(LockFreeQueueTest);
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+TSUNIT_DEFINE_TEST(Capacity)
+{
+    TSUNIT_EQUAL(2, ts::LockFreeQueue<int>(0).capacity());
+    TSUNIT_EQUAL(2, ts::LockFreeQueue<int>(2).capacity());
+    TSUNIT_EQUAL(4, ts::LockFreeQueue<int>(3).capacity());
+    TSUNIT_EQUAL(512, ts::LockFreeQueue<int>(512).capacity());
+    TSUNIT_EQUAL(1024, ts::LockFreeQueue<int>(1000).capacity());
+}
+
+TSUNIT_DEFINE_TEST(PushPop)
+{
+    ts::LockFreeQueue<ts::UString> queue(4);
+    ts::UString str;
+    TSUNIT_ASSERT(queue.empty());
+    TSUNIT_ASSERT(!queue.pop(str));
+
+    // Several laps in the ring.
+    for (int lap = 0; lap < 3; ++lap) {
+        for (int i = 0; i < 4; ++i) {
+            str = ts::UString::Format(u"str-%d-%d", lap, i);
+            TSUNIT_ASSERT(queue.push(str));
+            TSUNIT_ASSERT(!queue.empty());
+        }
+        // Full queue, the value is not moved.
+        str = u"extra";
+        TSUNIT_ASSERT(!queue.push(str));
+        TSUNIT_EQUAL(u"extra", str);
+
+        for (int i = 0; i < 4; ++i) {
+            TSUNIT_ASSERT(queue.pop(str));
+            TSUNIT_EQUAL(ts::UString::Format(u"str-%d-%d", lap, i), str);
+        }
+        TSUNIT_ASSERT(queue.empty());
+        TSUNIT_ASSERT(!queue.pop(str));
+    }
+}
+
+// Producer threads for testThreads()
+namespace {
+    class LockFreeQueueProducer: public utest::TSUnitThread
+    {
+        TS_NOBUILD_NOCOPY(LockFreeQueueProducer);
+    private:
+        ts::LockFreeQueue<uint64_t>& _queue;
+        uint64_t _id;
+        uint64_t _count;
+    public:
+        LockFreeQueueProducer(ts::LockFreeQueue<uint64_t>& queue, uint64_t id, uint64_t count) :
+            utest::TSUnitThread(),
+            _queue(queue),
+            _id(id),
+            _count(count)
+        {
+        }
+
+        virtual ~LockFreeQueueProducer() override
+        {
+            waitForTermination();
+        }
+
+        virtual void test() override
+        {
+            // Each value contains the producer id and a sequence number.
+            for (uint64_t i = 0; i < _count; ++i) {
+                uint64_t value = (_id << 32) | i;
+                while (!_queue.push(value)) {
+                    ts::Thread::Yield();
+                }
+            }
+        }
+    };
+}
+
+TSUNIT_DEFINE_TEST(Threads)
+{
+    constexpr size_t producers = 4;
+    constexpr uint64_t count = 50000;
+    ts::LockFreeQueue<uint64_t> queue(64);
+
+    std::vector<std::unique_ptr<LockFreeQueueProducer>> threads;
+    for (size_t id = 0; id < producers; ++id) {
+        threads.push_back(std::make_unique<LockFreeQueueProducer>(queue, id, count));
+        TSUNIT_ASSERT(threads.back()->start());
+    }
+
+    // The values from each producer must be received in order.
+    std::vector<uint64_t> next(producers, 0);
+    for (uint64_t received = 0; received < producers * count; ) {
+        uint64_t value = 0;
+        if (queue.pop(value)) {
+            const size_t id = size_t(value >> 32);
+            TSUNIT_ASSERT(id < producers);
+            TSUNIT_EQUAL(next[id], value & 0xFFFFFFFF);
+            next[id]++;
+            received++;
+        }
+        else {
+            ts::Thread::Yield();
+        }
+    }
+    TSUNIT_ASSERT(queue.empty());
+    threads.clear();
+}
@@ -0,0 +1,98 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2024, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//
+//  TSUnit test suite for class ts::LogHistogram
+//
+//----------------------------------------------------------------------------
+
+#include "tsLogHistogram.h"
+#include "tsunit.h"
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class LogHistogramTest: public tsunit::Test
+{
+    TSUNIT_DECLARE_TEST(Empty);
+    TSUNIT_DECLARE_TEST(Small);
+    TSUNIT_DECLARE_TEST(Large);
+};
+
+TSUNIT_REGISTER(LogHistogramTest);
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+TSUNIT_DEFINE_TEST(Empty)
+{
+    ts::LogHistogram hist;
+    TSUNIT_EQUAL(0, hist.count());
+    TSUNIT_EQUAL(0, hist.minimum());
+    TSUNIT_EQUAL(0, hist.maximum());
+    TSUNIT_EQUAL(0.0, hist.mean());
+    TSUNIT_EQUAL(0, hist.percentile(50.0));
+}
+
+TSUNIT_DEFINE_TEST(Small)
+{
+    // Values below SUB_BUCKETS are exact.
+    ts::LogHistogram hist;
+    for (uint64_t i = 1; i <= 10; ++i) {
+        hist.add(i);
+    }
+    TSUNIT_EQUAL(10, hist.count());
+    TSUNIT_EQUAL(1, hist.minimum());
+    TSUNIT_EQUAL(10, hist.maximum());
+    TSUNIT_EQUAL(5.5, hist.mean());
+    TSUNIT_EQUAL(1, hist.percentile(0.0));
+    TSUNIT_EQUAL(5, hist.percentile(50.0));
+    TSUNIT_EQUAL(9, hist.percentile(90.0));
+    TSUNIT_EQUAL(10, hist.percentile(100.0));
+
+    hist.reset();
+    TSUNIT_EQUAL(0, hist.count());
+    TSUNIT_EQUAL(0, hist.percentile(50.0));
+    hist.add(7);
+    TSUNIT_EQUAL(7, hist.minimum());
+    TSUNIT_EQUAL(7, hist.percentile(99.0));
+}
+
+TSUNIT_DEFINE_TEST(Large)
+{
+    // One value per microsecond, up to one second, in nanoseconds.
+    ts::LogHistogram hist;
+    for (uint64_t i = 1; i <= 1'000'000; ++i) {
+        hist.add(i * 1000);
+    }
+    TSUNIT_EQUAL(1'000'000, hist.count());
+    TSUNIT_EQUAL(1000, hist.minimum());
+    TSUNIT_EQUAL(1'000'000'000, hist.maximum());
+
+    // Relative error is bounded by 1/SUB_BUCKETS, rounded up.
+    const auto check = [&hist](double percent, uint64_t expected) {
+        const uint64_t value = hist.percentile(percent);
+        TSUNIT_ASSERT(value >= expected);
+        TSUNIT_ASSERT(value <= expected + expected / ts::LogHistogram::SUB_BUCKETS);
+    };
+    check(50.0, 500'000'000);
+    check(90.0, 900'000'000);
+    check(99.0, 990'000'000);
+    check(99.9, 999'000'000);
+    TSUNIT_EQUAL(1'000'000'000, hist.percentile(100.0));
+
+    // Extreme values.
+    hist.add(0);
+    hist.add(std::numeric_limits<uint64_t>::max());
+    TSUNIT_EQUAL(0, hist.minimum());
+    TSUNIT_EQUAL(std::numeric_limits<uint64_t>::max(), hist.maximum());
+    TSUNIT_EQUAL(std::numeric_limits<uint64_t>::max(), hist.percentile(100.0));
+}
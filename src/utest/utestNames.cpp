@@ -13,6 +13,7 @@
 #include "tsNamesFile.h"
 #include "tsNames.h"
 #include "tsFileUtils.h"
+#include "tsEnvironment.h"
 #include "tsErrCodeReport.h"
 #include "tsDuckContext.h"
 #include "tsCASFamily.h"
@@ -72,6 +73,7 @@ class NamesTest: public tsunit::Test
     TSUNIT_DECLARE_TEST(IP);
     TSUNIT_DECLARE_TEST(Extension);
     TSUNIT_DECLARE_TEST(Inheritance);
+    TSUNIT_DECLARE_TEST(Cache);
 
 public:
     virtual void beforeTest() override;
@@ -477,3 +479,95 @@ TSUNIT_DEFINE_TEST(Inheritance)
     TSUNIT_EQUAL(u"value1", file.nameFromSection(u"level1", 1));
     TSUNIT_EQUAL(u"unknown (0x00)", file.nameFromSection(u"level1", 0));
 }
+
+TSUNIT_DEFINE_TEST(Cache)
+{
+    if (!ts::GetEnvironment(u"TSDUCK_NO_NAMES_CACHE").empty()) {
+        debug() << "NamesTest::testCache: names cache disabled, test skipped" << std::endl;
+        return;
+    }
+
+    // Use a private cache directory.
+    const fs::path cacheDir(ts::TempFile(u""));
+    const ts::UString previousDir(ts::GetEnvironment(u"TSDUCK_CACHE_DIR"));
+    const bool previousExists = ts::EnvironmentExists(u"TSDUCK_CACHE_DIR");
+    TSUNIT_ASSERT(ts::SetEnvironment(u"TSDUCK_CACHE_DIR", cacheDir));
+    TSUNIT_EQUAL(cacheDir, ts::NamesFile::CacheDirectory());
+
+    const fs::path cacheFile(cacheDir / (ts::BaseName(_tempFileName) + u".cache"));
+    debug() << "NamesTest::testCache: cache file: " << cacheFile << std::endl;
+
+    TSUNIT_ASSERT(ts::UString::Save(ts::UStringVector({
+        u"[Section1]",
+        u"Bits = 16",
+        u"0x0001 = one",
+        u"0x0010-0x001F = range",
+        u"[Section2]",
+        u"Bits = 8",
+        u"Inherit = section1",
+        u"0x02 = two",
+    }), _tempFileName));
+
+    // First load: parse the text file and create the cache file.
+    {
+        ts::NamesFile file(_tempFileName, false, true);
+        TSUNIT_ASSERT(!file.isCached());
+        TSUNIT_ASSERT(fs::exists(cacheFile));
+        TSUNIT_EQUAL(u"one", file.nameFromSection(u"section1", 1));
+        TSUNIT_EQUAL(u"range", file.nameFromSection(u"Section1", 0x15));
+        TSUNIT_EQUAL(u"unknown (0x0020)", file.nameFromSection(u"section1", 0x20));
+    }
+
+    // Second load: use the cache file.
+    {
+        ts::NamesFile file(_tempFileName, false, true);
+        TSUNIT_ASSERT(file.isCached());
+        TSUNIT_EQUAL(0, file.errorCount());
+        TSUNIT_EQUAL(u"one", file.nameFromSection(u"section1", 1));
+        TSUNIT_EQUAL(u"range", file.nameFromSection(u"SECTION1", 0x10));
+        TSUNIT_EQUAL(u"range", file.nameFromSection(u"section1", 0x1F));
+        TSUNIT_EQUAL(u"unknown (0x0000)", file.nameFromSection(u"section1", 0));
+        TSUNIT_EQUAL(u"unknown (0x0020)", file.nameFromSection(u"section1", 0x20));
+        TSUNIT_EQUAL(u"two", file.nameFromSection(u"section2", 2));
+        TSUNIT_EQUAL(u"range (0x0012)", file.nameFromSection(u"section2", 0x12, ts::NamesFlags::VALUE));
+        TSUNIT_EQUAL(u"unknown (0x0003)", file.nameFromSection(u"section3", 3, ts::NamesFlags::NAME, 16));
+        TSUNIT_ASSERT(!file.nameExists(u"section3", 3));
+    }
+
+    // Modify the text file: the cache file is outdated and rebuilt.
+    TSUNIT_ASSERT(ts::UString::Save(ts::UStringVector({u"[Section1]", u"Bits = 16", u"0x0001 = new-one"}), _tempFileName));
+    {
+        ts::NamesFile file(_tempFileName, false, true);
+        TSUNIT_ASSERT(!file.isCached());
+        TSUNIT_EQUAL(u"new-one", file.nameFromSection(u"section1", 1));
+    }
+    {
+        ts::NamesFile file(_tempFileName, false, true);
+        TSUNIT_ASSERT(file.isCached());
+        TSUNIT_EQUAL(u"new-one", file.nameFromSection(u"section1", 1));
+        TSUNIT_ASSERT(!file.nameExists(u"section2", 2));
+    }
+
+    // A corrupted cache file is ignored.
+    TSUNIT_ASSERT(ts::UString::Save(ts::UStringVector({u"garbage"}), cacheFile));
+    {
+        ts::NamesFile file(_tempFileName, false, true);
+        TSUNIT_ASSERT(!file.isCached());
+        TSUNIT_EQUAL(u"new-one", file.nameFromSection(u"section1", 1));
+    }
+
+    // Without cache.
+    {
+        ts::NamesFile file(_tempFileName);
+        TSUNIT_ASSERT(!file.isCached());
+        TSUNIT_EQUAL(u"new-one", file.nameFromSection(u"section1", 1));
+    }
+
+    if (previousExists) {
+        ts::SetEnvironment(u"TSDUCK_CACHE_DIR", previousDir);
+    }
+    else {
+        ts::DeleteEnvironment(u"TSDUCK_CACHE_DIR");
+    }
+    fs::remove_all(cacheDir, &ts::ErrCodeReport());
+}
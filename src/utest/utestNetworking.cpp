@@ -42,6 +42,7 @@ class NetworkingTest: public tsunit::Test
     TSUNIT_DECLARE_TEST(IPv6SocketAddress);
     TSUNIT_DECLARE_TEST(TCPSocket);
     TSUNIT_DECLARE_TEST(UDPSocket);
+    TSUNIT_DECLARE_TEST(UDPSocketBatch);
     TSUNIT_DECLARE_TEST(IPHeader);
     TSUNIT_DECLARE_TEST(IPProtocol);
     TSUNIT_DECLARE_TEST(TCPPacket);
@@ -715,6 +716,58 @@ TSUNIT_DEFINE_TEST(UDPSocket)
     CERR.debug(u"UDPSocketTest: main thread: reply sent");
 }
 
+TSUNIT_DEFINE_TEST(UDPSocketBatch)
+{
+    TSUNIT_ASSERT(ts::IPInitialize());
+
+    const uint16_t portNumber = 12346;
+    const ts::IPv4SocketAddress serverAddress(ts::IPv4Address::LocalHost, portNumber);
+    constexpr size_t count = 10;
+
+    // Create receiving socket.
+    ts::UDPSocket server;
+    TSUNIT_ASSERT(server.open(CERR));
+    TSUNIT_ASSERT(server.reusePort(true, CERR));
+    TSUNIT_ASSERT(server.bind(serverAddress, CERR));
+
+    // Send all messages at once.
+    ts::UDPSocket client(true);
+    TSUNIT_ASSERT(client.isOpen());
+    TSUNIT_ASSERT(client.setDefaultDestination(serverAddress, CERR));
+    uint8_t messages[count][100];
+    const void* data[count];
+    size_t sizes[count];
+    for (size_t i = 0; i < count; ++i) {
+        ts::MemSet(messages[i], uint8_t(i), sizeof(messages[i]));
+        data[i] = messages[i];
+        sizes[i] = 10 + i;
+    }
+    TSUNIT_ASSERT(client.send(data, sizes, count, CERR));
+
+    // Receive all messages. They can come in several batches, depending on the system.
+    uint8_t buffers[count][1024];
+    ts::UDPSocket::ReceivedMessage received[count];
+    size_t total = 0;
+    while (total < count) {
+        for (size_t i = total; i < count; ++i) {
+            received[i].data = buffers[i];
+            received[i].max_size = sizeof(buffers[i]);
+        }
+        size_t ret_count = 0;
+        TSUNIT_ASSERT(server.receive(received + total, count - total, ret_count, nullptr, CERR));
+        TSUNIT_ASSERT(ret_count > 0);
+        total += ret_count;
+    }
+    TSUNIT_EQUAL(count, total);
+
+    for (size_t i = 0; i < count; ++i) {
+        debug() << "NetworkingTest::testUDPSocketBatch: message " << i << ", " << received[i].size << " bytes, sender: " << received[i].sender << std::endl;
+        TSUNIT_EQUAL(sizes[i], received[i].size);
+        TSUNIT_EQUAL(i, *static_cast<const uint8_t*>(received[i].data));
+        TSUNIT_ASSERT(ts::IPv4Address(received[i].sender) == ts::IPv4Address::LocalHost);
+    }
+}
+
 TSUNIT_DEFINE_TEST(IPHeader)
 {
     static const uint8_t reference_header[] = {
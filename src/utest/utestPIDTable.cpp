@@ -0,0 +1,221 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2024, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//
+//  TSUnit test suite for class ts::PIDTable
+//
+//----------------------------------------------------------------------------
+
+#include "tsPIDTable.h"
+#include "tsAlgorithm.h"
+#include "tsUString.h"
+#include "utestTSUnitBenchmark.h"
+#include "tsunit.h"
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class PIDTableTest: public tsunit::Test
+{
+    TSUNIT_DECLARE_TEST(Basic);
+    TSUNIT_DECLARE_TEST(Order);
+    TSUNIT_DECLARE_TEST(Stability);
+    TSUNIT_DECLARE_TEST(Erase);
+    TSUNIT_DECLARE_TEST(Copy);
+    TSUNIT_DECLARE_TEST(Lookup);
+};
+
+TSUNIT_REGISTER(PIDTableTest);
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+TSUNIT_DEFINE_TEST(Basic)
+{
+    ts::PIDTable<int> table;
+    TSUNIT_ASSERT(table.empty());
+    TSUNIT_EQUAL(0, table.size());
+    TSUNIT_ASSERT(!table.contains(100));
+    TSUNIT_ASSERT(table.find(100) == table.end());
+    TSUNIT_ASSERT(table.begin() == table.end());
+
+    table[100] = 12;
+    table[ts::PID_NULL] = 34;
+    TSUNIT_ASSERT(!table.empty());
+    TSUNIT_EQUAL(2, table.size());
+    TSUNIT_ASSERT(table.contains(100));
+    TSUNIT_ASSERT(table.contains(ts::PID_NULL));
+    TSUNIT_ASSERT(!table.contains(101));
+    TSUNIT_EQUAL(1, table.count(100));
+    TSUNIT_EQUAL(0, table.count(101));
+    TSUNIT_ASSERT(ts::Contains(table, ts::PID(100)));
+
+    auto it = table.find(100);
+    TSUNIT_ASSERT(it != table.end());
+    TSUNIT_EQUAL(100, it->first);
+    TSUNIT_EQUAL(12, it->second);
+    it->second = 56;
+    TSUNIT_EQUAL(56, table[100]);
+
+    // Default-constructed value on access.
+    TSUNIT_EQUAL(0, table[200]);
+    TSUNIT_EQUAL(3, table.size());
+
+    table.clear();
+    TSUNIT_ASSERT(table.empty());
+    TSUNIT_ASSERT(!table.contains(100));
+    TSUNIT_ASSERT(table.find(ts::PID_NULL) == table.end());
+}
+
+TSUNIT_DEFINE_TEST(Order)
+{
+    ts::PIDTable<ts::PID> table;
+    for (ts::PID pid : {500, 20, 8000, 0, 1000, 21}) {
+        table[pid] = pid;
+    }
+
+    std::vector<ts::PID> pids;
+    for (const auto& [pid, value] : table) {
+        TSUNIT_EQUAL(pid, value);
+        pids.push_back(pid);
+    }
+    TSUNIT_ASSERT(pids == std::vector<ts::PID>({0, 20, 21, 500, 1000, 8000}));
+    TSUNIT_ASSERT(ts::MapKeysSet(table) == std::set<ts::PID>({0, 20, 21, 500, 1000, 8000}));
+
+    // Backward iteration.
+    auto it = table.end();
+    --it;
+    TSUNIT_EQUAL(8000, it->first);
+    --it;
+    TSUNIT_EQUAL(1000, it->first);
+}
+
+TSUNIT_DEFINE_TEST(Stability)
+{
+    ts::PIDTable<int> table;
+    int& ref(table[1000]);
+    ref = 1;
+
+    // Insert and remove other PID's, the reference must remain valid.
+    for (ts::PID pid = 0; pid < ts::PID_MAX; pid += 3) {
+        table[pid] = int(pid);
+    }
+    for (ts::PID pid = 0; pid < 999; pid += 3) {
+        table.erase(pid);
+    }
+    TSUNIT_EQUAL(1, ref);
+    TSUNIT_EQUAL(&ref, &table[1000]);
+    TSUNIT_EQUAL(&ref, &table.find(1000)->second);
+}
+
+TSUNIT_DEFINE_TEST(Erase)
+{
+    ts::PIDTable<int> table;
+    for (ts::PID pid = 10; pid < 20; ++pid) {
+        table[pid] = int(pid);
+    }
+    TSUNIT_EQUAL(10, table.size());
+
+    TSUNIT_EQUAL(1, table.erase(15));
+    TSUNIT_EQUAL(0, table.erase(15));
+    TSUNIT_EQUAL(0, table.erase(100));
+    TSUNIT_EQUAL(9, table.size());
+    TSUNIT_ASSERT(!table.contains(15));
+    TSUNIT_EQUAL(16, table.find(16)->second);
+    TSUNIT_EQUAL(14, table.find(14)->second);
+
+    // Remove even PID's while iterating.
+    for (auto it = table.begin(); it != table.end(); ) {
+        if (it->first % 2 == 0) {
+            it = table.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+    TSUNIT_ASSERT(ts::MapKeysSet(table) == std::set<ts::PID>({11, 13, 17, 19}));
+    TSUNIT_EQUAL(17, table[17]);
+
+    // Reinsert a removed PID.
+    TSUNIT_EQUAL(0, table[16]);
+    TSUNIT_ASSERT(ts::MapKeysSet(table) == std::set<ts::PID>({11, 13, 16, 17, 19}));
+}
+
+TSUNIT_DEFINE_TEST(Copy)
+{
+    ts::PIDTable<ts::UString> table1;
+    table1[300] = u"foo";
+    table1[200] = u"bar";
+
+    ts::PIDTable<ts::UString> table2(table1);
+    TSUNIT_EQUAL(2, table2.size());
+    TSUNIT_EQUAL(u"foo", table2[300]);
+    TSUNIT_EQUAL(u"bar", table2[200]);
+    TSUNIT_ASSERT(&table1[300] != &table2[300]);
+
+    table2[300] = u"baz";
+    TSUNIT_EQUAL(u"foo", table1[300]);
+
+    ts::PIDTable<ts::UString> table3(std::move(table2));
+    TSUNIT_EQUAL(2, table3.size());
+    TSUNIT_EQUAL(u"baz", table3[300]);
+
+    table3 = table1;
+    TSUNIT_EQUAL(2, table3.size());
+    TSUNIT_EQUAL(u"foo", table3[300]);
+}
+
+// Compare lookups in std::map and PIDTable, with 400 active PID's.
+// Use environment variable TSUNIT_PIDTABLE_ITERATIONS to repeat and compare the CPU time.
+TSUNIT_DEFINE_TEST(Lookup)
+{
+    constexpr size_t PID_COUNT = 400;
+    constexpr size_t LOOKUP_COUNT = 100000;
+
+    std::map<ts::PID, uint64_t> map;
+    ts::PIDTable<uint64_t> table;
+    for (size_t i = 0; i < PID_COUNT; ++i) {
+        const ts::PID pid = ts::PID(32 + 16 * i);
+        map[pid] = table[pid] = pid;
+    }
+
+    // Sequence of PID's to look up, in no particular order.
+    std::vector<ts::PID> pids(LOOKUP_COUNT);
+    for (size_t i = 0; i < pids.size(); ++i) {
+        pids[i] = ts::PID(32 + 16 * ((i * 7919) % PID_COUNT));
+    }
+
+    utest::TSUnitBenchmark bench_map(u"TSUNIT_PIDTABLE_ITERATIONS");
+    uint64_t sum_map = 0;
+    bench_map.start();
+    for (size_t iter = 0; iter < bench_map.iterations; ++iter) {
+        for (auto pid : pids) {
+            const auto it = map.find(pid);
+            sum_map += it == map.end() ? 0 : it->second;
+        }
+    }
+    bench_map.stop();
+    bench_map.report(u"PIDTableTest::testLookup, std::map");
+
+    utest::TSUnitBenchmark bench_table(u"TSUNIT_PIDTABLE_ITERATIONS");
+    uint64_t sum_table = 0;
+    bench_table.start();
+    for (size_t iter = 0; iter < bench_table.iterations; ++iter) {
+        for (auto pid : pids) {
+            const auto it = table.find(pid);
+            sum_table += it == table.end() ? 0 : it->second;
+        }
+    }
+    bench_table.stop();
+    bench_table.report(u"PIDTableTest::testLookup, PIDTable");
+
+    TSUNIT_EQUAL(sum_map, sum_table);
+}
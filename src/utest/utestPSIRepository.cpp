@@ -14,6 +14,8 @@
 #include "tsMGT.h"
 #include "tsLDT.h"
 #include "tsunit.h"
+#include "utestTSUnitThread.h"
+#include "utestTSUnitBenchmark.h"
 
 
 //----------------------------------------------------------------------------
@@ -24,6 +26,10 @@ class PSIRepositoryTest: public tsunit::Test
 {
     TSUNIT_DECLARE_TEST(Registrations);
     TSUNIT_DECLARE_TEST(SharedTID);
+    TSUNIT_DECLARE_TEST(NameLookup);
+    TSUNIT_DECLARE_TEST(LateRegistration);
+    TSUNIT_DECLARE_TEST(ConcurrentRegistration);
+    TSUNIT_DECLARE_TEST(BuildTime);
 };
 
 TSUNIT_REGISTER(PSIRepositoryTest);
@@ -93,3 +99,132 @@ TSUNIT_DEFINE_TEST(SharedTID)
     TSUNIT_ASSERT(ts::MGT::DisplaySection == ts::PSIRepository::Instance().getSectionDisplay(ts::TID_LDT, ts::Standards::NONE, ts::PID_PSIP));
     TSUNIT_ASSERT(ts::LDT::DisplaySection == ts::PSIRepository::Instance().getSectionDisplay(ts::TID_LDT, ts::Standards::NONE, ts::PID_LDT));
 }
+
+TSUNIT_DEFINE_TEST(NameLookup)
+{
+    // XML names are case-insensitive and blanks are ignored.
+    const ts::PSIRepository& repo(ts::PSIRepository::Instance());
+    TSUNIT_ASSERT(repo.getTableFactory(u"MGT") != nullptr);
+    TSUNIT_ASSERT(repo.getTableFactory(u" mgt ") == repo.getTableFactory(u"MGT"));
+    TSUNIT_ASSERT(repo.getTableFactory(u"foo_bar_table") == nullptr);
+    TSUNIT_ASSERT(repo.getDescriptorFactory(u"CA_Descriptor") != nullptr);
+    TSUNIT_ASSERT(repo.getDescriptorFactory(u"CA_Descriptor") == repo.getDescriptorFactory(u"ca_descriptor"));
+    TSUNIT_ASSERT(repo.getDescriptorFactory(u"foo_bar_descriptor") == nullptr);
+}
+
+namespace {
+    ts::AbstractDescriptorPtr LateDescriptorFactory() { return nullptr; }
+    void LateCADescriptorDisplay(ts::TablesDisplay&, ts::PSIBuffer&, const ts::UString&, ts::TID) {}
+}
+
+TSUNIT_DEFINE_TEST(LateRegistration)
+{
+    // Make sure that the repository is already built.
+    const ts::PSIRepository& repo(ts::PSIRepository::Instance());
+    TSUNIT_ASSERT(repo.getTableFactory(ts::TID_PAT, ts::Standards::MPEG) != nullptr);
+    TSUNIT_ASSERT(repo.getDescriptorFactory(u"utest_late_descriptor") == nullptr);
+
+    // Registrations which occur after the first use, as when loading a shared library.
+    // The registration objects must remain valid until the end of the application.
+    static const ts::EDID edid(ts::EDID::Private(0xFE, 0xFEDCBA98));
+    static ts::PSIRepository::RegisterDescriptor reg1(LateDescriptorFactory, edid, u"utest_late_descriptor");
+    static ts::PSIRepository::RegisterDescriptor reg2(LateCADescriptorDisplay, 0xFEDC, 0xFEDD);
+
+    TSUNIT_ASSERT(repo.getDescriptorFactory(u"UTest_Late_Descriptor") == LateDescriptorFactory);
+    TSUNIT_ASSERT(repo.getDescriptorFactory(edid) == LateDescriptorFactory);
+    TSUNIT_ASSERT(repo.getCADescriptorDisplay(0xFEDB) == nullptr);
+    TSUNIT_ASSERT(repo.getCADescriptorDisplay(0xFEDC) == LateCADescriptorDisplay);
+    TSUNIT_ASSERT(repo.getCADescriptorDisplay(0xFEDD) == LateCADescriptorDisplay);
+    TSUNIT_ASSERT(repo.getCADescriptorDisplay(0xFEDE) == nullptr);
+
+    // Previous registrations are still there.
+    TSUNIT_ASSERT(repo.getTableFactory(ts::TID_PAT, ts::Standards::MPEG) != nullptr);
+    TSUNIT_ASSERT(repo.getDescriptorFactory(u"ca_descriptor") != nullptr);
+}
+
+namespace {
+    // Registrations at run time, as when loading shared libraries. They must remain valid until the end of the application.
+    std::list<std::unique_ptr<ts::PSIRepository::RegisterDescriptor>> _late_registrations;
+
+    // A thread which continuously uses the repository.
+    class LookupThread: public utest::TSUnitThread
+    {
+        TS_NOCOPY(LookupThread);
+    public:
+        LookupThread() = default;
+        virtual ~LookupThread() override { waitForTermination(); }
+        volatile bool terminate = false;
+        size_t lookups = 0;
+
+        virtual void test() override
+        {
+            const ts::PSIRepository& repo(ts::PSIRepository::Instance());
+            while (!terminate) {
+                TSUNIT_ASSERT(repo.getTableFactory(ts::TID_PAT, ts::Standards::MPEG) != nullptr);
+                TSUNIT_ASSERT(repo.getDescriptorFactory(u"ca_descriptor") != nullptr);
+                TSUNIT_ASSERT(repo.getCADescriptorDisplay(0xFD00) == LateCADescriptorDisplay);
+                lookups++;
+            }
+        }
+    };
+}
+
+TSUNIT_DEFINE_TEST(ConcurrentRegistration)
+{
+    // Rebuilds of the repository while other threads use it.
+    const ts::PSIRepository& repo(ts::PSIRepository::Instance());
+    _late_registrations.push_back(std::make_unique<ts::PSIRepository::RegisterDescriptor>(LateCADescriptorDisplay, 0xFD00));
+    TSUNIT_ASSERT(repo.getCADescriptorDisplay(0xFD00) == LateCADescriptorDisplay);
+
+    std::array<LookupThread, 3> threads;
+    for (auto& th : threads) {
+        TSUNIT_ASSERT(th.start());
+    }
+    for (uint16_t cas = 0xFD01; cas < 0xFD40; ++cas) {
+        _late_registrations.push_back(std::make_unique<ts::PSIRepository::RegisterDescriptor>(LateCADescriptorDisplay, cas));
+        TSUNIT_ASSERT(repo.getCADescriptorDisplay(cas) == LateCADescriptorDisplay);
+        std::this_thread::yield();
+    }
+    for (auto& th : threads) {
+        th.terminate = true;
+        th.waitForTermination();
+        TSUNIT_ASSERT(th.lookups > 0);
+    }
+}
+
+//----------------------------------------------------------------------------
+// Build time of the repository, as on first use at startup of an application.
+// Each late registration triggers a complete build. Define the environment
+// variable TSUNIT_PSIREPO_ITERATIONS to run more builds (report with utest -d).
+//----------------------------------------------------------------------------
+
+TSUNIT_DEFINE_TEST(BuildTime)
+{
+    utest::TSUnitBenchmark bench(u"TSUNIT_PSIREPO_ITERATIONS");
+    const ts::PSIRepository& repo(ts::PSIRepository::Instance());
+    cn::nanoseconds build_time {0};
+    cn::nanoseconds lookup_time {0};
+
+    for (size_t iter = 0; iter < bench.iterations; ++iter) {
+        const uint16_t cas = uint16_t(0xFC00 + iter % 0x100);
+        _late_registrations.push_back(std::make_unique<ts::PSIRepository::RegisterDescriptor>(LateCADescriptorDisplay, cas));
+
+        // First lookup after a registration: complete build.
+        auto start = cn::steady_clock::now();
+        TSUNIT_ASSERT(repo.getTableFactory(ts::TID_PAT, ts::Standards::MPEG) != nullptr);
+        build_time += cn::steady_clock::now() - start;
+
+        // Next lookup: no build.
+        start = cn::steady_clock::now();
+        TSUNIT_ASSERT(repo.getTableFactory(ts::TID_PMT, ts::Standards::MPEG) != nullptr);
+        lookup_time += cn::steady_clock::now() - start;
+    }
+
+    std::vector<ts::TID> tids;
+    std::vector<ts::EDID> edids;
+    repo.getRegisteredTableIds(tids);
+    repo.getRegisteredDescriptorIds(edids);
+    debug() << "PSIRepositoryTest::BuildTime: " << tids.size() << " table ids, " << edids.size() << " descriptors, "
+            << bench.iterations << " builds, build: " << (cn::duration_cast<cn::microseconds>(build_time).count() / bench.iterations) << " us"
+            << ", lookup after build: " << (lookup_time.count() / bench.iterations) << " ns" << std::endl;
+}
@@ -0,0 +1,282 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2024, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//
+//  TSUnit test suite for pcap files.
+//
+//----------------------------------------------------------------------------
+
+#include "tsPcapFilter.h"
+#include "tsPcapIndex.h"
+#include "tsByteBlock.h"
+#include "tsCerrReport.h"
+#include "tsErrCodeReport.h"
+#include "tsFileUtils.h"
+#include "tsunit.h"
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class PcapFileTest: public tsunit::Test
+{
+    TSUNIT_DECLARE_TEST(Read);
+    TSUNIT_DECLARE_TEST(Index);
+    TSUNIT_DECLARE_TEST(Seek);
+    TSUNIT_DECLARE_TEST(MemoryMap);
+
+public:
+    virtual void beforeTest() override;
+    virtual void afterTest() override;
+
+private:
+    static constexpr uint32_t PACKET_COUNT = 10000;
+    static constexpr uint32_t BASE_SECONDS = 1700000000;
+    fs::path _tempFileName {};
+
+    // Create a big-endian pcap file with raw IPv4/UDP packets, one every millisecond, in two streams.
+    void createFile();
+};
+
+TSUNIT_REGISTER(PcapFileTest);
+
+
+//----------------------------------------------------------------------------
+// Initialization.
+//----------------------------------------------------------------------------
+
+// Test suite initialization method.
+void PcapFileTest::beforeTest()
+{
+    if (_tempFileName.empty()) {
+        _tempFileName = ts::TempFile(u".pcap");
+    }
+    fs::remove(_tempFileName, &ts::ErrCodeReport());
+    fs::remove(ts::PcapIndex::IndexFileName(_tempFileName), &ts::ErrCodeReport());
+}
+
+// Test suite cleanup method.
+void PcapFileTest::afterTest()
+{
+    fs::remove(_tempFileName, &ts::ErrCodeReport());
+    fs::remove(ts::PcapIndex::IndexFileName(_tempFileName), &ts::ErrCodeReport());
+}
+
+// Create the test capture file.
+void PcapFileTest::createFile()
+{
+    ts::ByteBlock data;
+    data.appendUInt32(ts::PCAP_MAGIC_BE);
+    data.appendUInt16(2);   // major version
+    data.appendUInt16(4);   // minor version
+    data.appendUInt32(0);   // reserved
+    data.appendUInt32(0);   // reserved
+    data.appendUInt32(65535);
+    data.appendUInt32(ts::LINKTYPE_RAW);
+
+    for (uint32_t i = 0; i < PACKET_COUNT; ++i) {
+        // Packet header: timestamp, captured and original sizes.
+        data.appendUInt32(BASE_SECONDS + i / 1000);
+        data.appendUInt32((i % 1000) * 1000);
+        data.appendUInt32(32);
+        data.appendUInt32(32);
+
+        // IPv4 header, from 10.0.0.1 to 10.0.0.2, UDP.
+        const size_t ip = data.size();
+        data.appendUInt8(0x45);
+        data.appendUInt8(0);
+        data.appendUInt16(32);  // total length
+        data.appendUInt16(uint16_t(i));
+        data.appendUInt16(0);
+        data.appendUInt8(64);   // TTL
+        data.appendUInt8(ts::IPv4_PROTO_UDP);
+        data.appendUInt16(0);   // checksum
+        data.appendUInt32(0x0A000001);
+        data.appendUInt32(0x0A000002);
+        ts::IPv4Packet::UpdateIPHeaderChecksum(data.data() + ip, 20);
+
+        // UDP header and 4-byte payload. Two streams by destination port.
+        data.appendUInt16(1000);
+        data.appendUInt16(i % 2 == 0 ? 2000 : 2001);
+        data.appendUInt16(12);
+        data.appendUInt16(0);
+        data.appendUInt32(i);
+    }
+    TSUNIT_ASSERT(data.saveToFile(_tempFileName));
+}
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+TSUNIT_DEFINE_TEST(Read)
+{
+    createFile();
+
+    ts::PcapFile file;
+    TSUNIT_ASSERT(file.open(_tempFileName, CERR));
+
+    ts::IPv4Packet ip;
+    cn::microseconds timestamp;
+    uint32_t count = 0;
+    while (file.readIPv4(ip, timestamp, CERR)) {
+        TSUNIT_EQUAL(32, ip.size());
+        TSUNIT_EQUAL(4, ip.protocolDataSize());
+        TSUNIT_EQUAL(count, ts::GetUInt32(ip.protocolData()));
+        TSUNIT_EQUAL(cn::seconds(BASE_SECONDS).count() * 1000000 + count * 1000, timestamp.count());
+        count++;
+    }
+    TSUNIT_ASSERT(file.endOfFile());
+    TSUNIT_EQUAL(PACKET_COUNT, count);
+    TSUNIT_EQUAL(PACKET_COUNT, file.packetCount());
+    TSUNIT_EQUAL(PACKET_COUNT, file.ipv4PacketCount());
+    TSUNIT_EQUAL(24 + PACKET_COUNT * 48, file.fileSize());
+    file.close();
+
+    // Without index, no index file is created.
+    TSUNIT_ASSERT(!fs::exists(ts::PcapIndex::IndexFileName(_tempFileName)));
+}
+
+TSUNIT_DEFINE_TEST(Index)
+{
+    createFile();
+
+    // First pass: build the index.
+    ts::PcapFile file;
+    TSUNIT_ASSERT(file.open(_tempFileName, CERR));
+    TSUNIT_ASSERT(!file.useIndex(CERR));
+    TSUNIT_ASSERT(!file.index().complete);
+
+    ts::IPv4Packet ip;
+    cn::microseconds timestamp;
+    while (file.readIPv4(ip, timestamp, CERR)) {
+    }
+    file.close();
+    TSUNIT_ASSERT(file.index().complete);
+    TSUNIT_ASSERT(fs::exists(ts::PcapIndex::IndexFileName(_tempFileName)));
+
+    // Second pass: load the index.
+    TSUNIT_ASSERT(file.open(_tempFileName, CERR));
+    TSUNIT_ASSERT(file.useIndex(CERR));
+    file.close();
+
+    const ts::PcapIndex& index(file.index());
+    TSUNIT_ASSERT(index.complete);
+    TSUNIT_EQUAL(PACKET_COUNT, index.packet_count);
+    TSUNIT_EQUAL(cn::seconds(BASE_SECONDS).count() * 1000000, index.first_timestamp.count());
+    TSUNIT_EQUAL(1, index.interfaces.size());
+    TSUNIT_EQUAL(ts::LINKTYPE_RAW, index.interfaces[0].link_type);
+
+    // One checkpoint every 4096 packets.
+    TSUNIT_EQUAL(3, index.checkpoints.size());
+    TSUNIT_EQUAL(0, index.checkpoints[0].packet_count);
+    TSUNIT_EQUAL(24, index.checkpoints[0].offset);
+    TSUNIT_EQUAL(-1, index.checkpoints[0].max_timestamp.count());
+    TSUNIT_EQUAL(4096, index.checkpoints[1].packet_count);
+    TSUNIT_EQUAL(24 + 4096 * 48, index.checkpoints[1].offset);
+    TSUNIT_EQUAL(index.first_timestamp.count() + 4095 * 1000, index.checkpoints[1].max_timestamp.count());
+    TSUNIT_EQUAL(8192, index.checkpoints[2].packet_count);
+
+    // Two data flows.
+    TSUNIT_EQUAL(2, index.flows.size());
+    const ts::PcapIndex::FlowId id(ts::IPv4SocketAddress(0x0A000001, 1000), ts::IPv4SocketAddress(0x0A000002, 2001), ts::IPv4_PROTO_UDP);
+    TSUNIT_ASSERT(index.flows.find(id) != index.flows.end());
+    const ts::PcapIndex::FlowStats& stats(index.flows.at(id));
+    TSUNIT_EQUAL(PACKET_COUNT / 2, stats.packet_count);
+    TSUNIT_EQUAL(PACKET_COUNT / 2 * 32, stats.total_ip_size);
+    TSUNIT_EQUAL(PACKET_COUNT / 2 * 4, stats.total_data_size);
+    TSUNIT_EQUAL(index.first_timestamp.count() + 1000, stats.first_timestamp.count());
+    TSUNIT_EQUAL(PACKET_COUNT, index.ipv4_stats.packet_count);
+
+    TSUNIT_EQUAL(&index.checkpoints[1], index.findCheckpoint(5000, cn::microseconds::min()));
+    TSUNIT_EQUAL(&index.checkpoints[0], index.findCheckpoint(4096, cn::microseconds::min()));
+    TSUNIT_EQUAL(&index.checkpoints[2], index.findCheckpoint(0, index.first_timestamp + cn::seconds(9)));
+    TSUNIT_ASSERT(index.findCheckpoint(0, cn::microseconds::min()) == nullptr);
+
+    // Modifying the capture file invalidates the index.
+    ts::ByteBlock data;
+    TSUNIT_ASSERT(data.loadFromFile(_tempFileName));
+    data.resize(data.size() - 48);
+    TSUNIT_ASSERT(data.saveToFile(_tempFileName));
+    TSUNIT_ASSERT(file.open(_tempFileName, CERR));
+    TSUNIT_ASSERT(!file.useIndex(CERR));
+    file.close();
+}
+
+TSUNIT_DEFINE_TEST(Seek)
+{
+    createFile();
+
+    ts::PcapFilter file;
+    ts::IPv4Packet ip;
+    cn::microseconds timestamp;
+
+    // First pass: build the index.
+    file.setUseIndex(true);
+    TSUNIT_ASSERT(file.open(_tempFileName, CERR));
+    while (file.readIPv4(ip, timestamp, CERR)) {
+    }
+    file.close();
+
+    // Start at a packet number.
+    TSUNIT_ASSERT(file.open(_tempFileName, CERR));
+    file.setFirstPacketFilter(5000);
+    TSUNIT_ASSERT(file.readIPv4(ip, timestamp, CERR));
+    TSUNIT_EQUAL(5000, file.packetCount());
+    TSUNIT_EQUAL(4999, ts::GetUInt32(ip.protocolData()));
+    // Only the packets after the checkpoint were read.
+    TSUNIT_EQUAL(5000 - 4096, file.ipv4PacketCount());
+    file.close();
+
+    // Start at a time offset.
+    TSUNIT_ASSERT(file.open(_tempFileName, CERR));
+    file.setFirstTimeOffset(cn::seconds(9));
+    TSUNIT_ASSERT(file.readIPv4(ip, timestamp, CERR));
+    TSUNIT_EQUAL(9001, file.packetCount());
+    TSUNIT_EQUAL(9000, ts::GetUInt32(ip.protocolData()));
+    TSUNIT_EQUAL(9000, file.timeOffset(timestamp).count() / 1000);
+    TSUNIT_EQUAL(9001 - 8192, file.ipv4PacketCount());
+    file.close();
+}
+
+TSUNIT_DEFINE_TEST(MemoryMap)
+{
+    createFile();
+    ts::ByteBlock data;
+    TSUNIT_ASSERT(data.loadFromFile(_tempFileName));
+
+    // Read half of the capture file, mapped in memory.
+    ts::PcapFile file;
+    file.setMemoryMapping(true);
+    TSUNIT_ASSERT(file.open(_tempFileName, CERR));
+
+    ts::IPv4Packet ip;
+    cn::microseconds timestamp;
+    uint32_t count = 0;
+    while (count < PACKET_COUNT / 2 && file.readIPv4(ip, timestamp, CERR)) {
+        TSUNIT_EQUAL(count, ts::GetUInt32(ip.protocolData()));
+        count++;
+    }
+    TSUNIT_EQUAL(PACKET_COUNT / 2, count);
+
+    // The capture file grows while being read: the new packets are read after the mapped content.
+    constexpr uint32_t extra = 100;
+    std::ofstream strm(_tempFileName, std::ios::out | std::ios::binary | std::ios::app);
+    strm.write(reinterpret_cast<const char*>(data.data() + 24), extra * 48);
+    strm.close();
+
+    while (file.readIPv4(ip, timestamp, CERR)) {
+        TSUNIT_EQUAL(count % PACKET_COUNT, ts::GetUInt32(ip.protocolData()));
+        count++;
+    }
+    TSUNIT_ASSERT(file.endOfFile());
+    TSUNIT_EQUAL(PACKET_COUNT + extra, count);
+    TSUNIT_EQUAL(24 + (PACKET_COUNT + extra) * 48, file.fileSize());
+    file.close();
+}
@@ -12,6 +12,7 @@
 
 #include "tsReportBuffer.h"
 #include "tsReportFile.h"
+#include "tsAsyncReport.h"
 #include "tsFileUtils.h"
 #include "tsErrCodeReport.h"
 #include "tsunit.h"
@@ -30,6 +31,8 @@ class ReportTest: public tsunit::Test
     TSUNIT_DECLARE_TEST(ByStream);
     TSUNIT_DECLARE_TEST(ErrCodeReport);
     TSUNIT_DECLARE_TEST(Delegation);
+    TSUNIT_DECLARE_TEST(AsyncSynchronous);
+    TSUNIT_DECLARE_TEST(AsyncDrop);
 
 public:
     virtual void beforeTest() override;
@@ -380,3 +383,64 @@ TSUNIT_DEFINE_TEST(Delegation)
     rep.info(u"text 6");
     TSUNIT_EQUAL(u"", log.messages());
 }
+
+// An asynchronous report which counts the messages.
+namespace {
+    class CountingAsyncReport : public ts::AsyncReport
+    {
+        TS_NOBUILD_NOCOPY(CountingAsyncReport);
+    public:
+        explicit CountingAsyncReport(const ts::AsyncReportArgs& args) : ts::AsyncReport(ts::Severity::Info, args) {}
+        size_t messages = 0;  // Accessed by the logging thread until terminate().
+        size_t warnings = 0;
+    protected:
+        virtual void asyncThreadLog(int severity, const ts::UString&) override
+        {
+            if (severity == ts::Severity::Warning) {
+                warnings++;
+            }
+            else {
+                messages++;
+            }
+        }
+    };
+}
+
+TSUNIT_DEFINE_TEST(AsyncSynchronous)
+{
+    ts::AsyncReportArgs args;
+    args.log_msg_count = 4;
+    args.sync_log = true;
+    CountingAsyncReport rep(args);
+
+    constexpr size_t count = 20000;
+    for (size_t i = 0; i < count; ++i) {
+        rep.info(u"message %d", i);
+    }
+    rep.terminate();
+    TSUNIT_EQUAL(count, rep.messages);
+    TSUNIT_EQUAL(0, rep.warnings);
+    TSUNIT_EQUAL(0, rep.droppedMessages());
+}
+
+TSUNIT_DEFINE_TEST(AsyncDrop)
+{
+    for (bool drop_oldest : {false, true}) {
+        ts::AsyncReportArgs args;
+        args.log_msg_count = 4;
+        args.drop_oldest = drop_oldest;
+        CountingAsyncReport rep(args);
+        TSUNIT_EQUAL(drop_oldest, rep.getDropOldest());
+
+        constexpr size_t count = 20000;
+        for (size_t i = 0; i < count; ++i) {
+            rep.info(u"message %d", i);
+        }
+        rep.terminate();
+        debug() << "ReportTest::AsyncDrop: drop oldest: " << drop_oldest << ", dropped: " << rep.droppedMessages() << std::endl;
+
+        // All messages are either logged or dropped, dropped messages are reported.
+        TSUNIT_EQUAL(count, rep.messages + rep.droppedMessages());
+        TSUNIT_EQUAL(rep.droppedMessages() > 0, rep.warnings > 0);
+    }
+}
@@ -21,6 +21,7 @@
 class ResidentBufferTest: public tsunit::Test
 {
     TSUNIT_DECLARE_TEST(ResidentBuffer);
+    TSUNIT_DECLARE_TEST(HugePages);
 };
 
 TSUNIT_REGISTER(ResidentBufferTest);
@@ -54,3 +55,22 @@ TSUNIT_DEFINE_TEST(ResidentBuffer)
 
     TSUNIT_ASSERT(buf.count() >= buf_size);
 }
+
+TSUNIT_DEFINE_TEST(HugePages)
+{
+    // Not a multiple of the huge page size, not locked, on the first NUMA node.
+    const size_t buf_size = 3 * 1024 * 1024 + 5;
+    ts::ResidentBuffer<uint8_t> buf(buf_size, false, true, 0);
+
+    debug() << "ResidentBufferTest: isHugePages() = " << buf.isHugePages()
+            << ", isNUMABound() = " << buf.isNUMABound() << std::endl;
+
+    TSUNIT_ASSERT(!buf.isLocked());
+    TSUNIT_EQUAL(buf_size, buf.count());
+    TSUNIT_EQUAL(0, size_t(buf.base()) % ts::SysInfo::Instance().memoryPageSize());
+
+    // The whole buffer is usable.
+    std::memset(buf.base(), 0xA5, buf.count());
+    TSUNIT_EQUAL(0xA5, buf.base()[0]);
+    TSUNIT_EQUAL(0xA5, buf.base()[buf_size - 1]);
+}
@@ -11,6 +11,7 @@
 //----------------------------------------------------------------------------
 
 #include "tsDVBCSA2.h"
+#include "tsTSScrambling.h"
 #include "tsTSPacket.h"
 #include "tsNames.h"
 #include "tsunit.h"
@@ -23,6 +24,7 @@
 class ScramblingTest: public tsunit::Test
 {
     TSUNIT_DECLARE_TEST(Scrambling);
+    TSUNIT_DECLARE_TEST(BatchMode);
 };
 
 TSUNIT_REGISTER(ScramblingTest);
@@ -166,3 +168,47 @@ TSUNIT_DEFINE_TEST(Scrambling)
         TSUNIT_EQUAL(0, ts::MemCompare(pkt.b + header_size, vec->cipher.b + header_size, payload_size));
     }
 }
+
+TSUNIT_DEFINE_TEST(BatchMode)
+{
+    // More packets than the batch size to test intermediate flushes.
+    const size_t pkt_count = ts::DVBCSA2::BatchSize() + 10;
+    ts::TSPacketVector packets(pkt_count);
+
+    for (const auto& vec : scrambling_test_vectors) {
+
+        const uint8_t scv = vec.cipher.getScrambling();
+        const size_t header_size = vec.plain.getHeaderSize();
+        const size_t payload_size = vec.plain.getPayloadSize();
+
+        ts::TSScrambling scrambling(CERR, ts::SCRAMBLING_DVB_CSA2);
+        TSUNIT_ASSERT(scrambling.batchSize() > 0);
+        TSUNIT_ASSERT(scrambling.setBatchMode(true));
+        TSUNIT_ASSERT(scrambling.batchMode());
+        TSUNIT_ASSERT(scrambling.setCW(ts::ByteBlock(vec.cw_even, sizeof(vec.cw_even)), ts::SC_EVEN_KEY));
+        TSUNIT_ASSERT(scrambling.setCW(ts::ByteBlock(vec.cw_odd, sizeof(vec.cw_odd)), ts::SC_ODD_KEY));
+
+        // Descrambling test.
+        for (auto& pkt : packets) {
+            pkt = vec.cipher;
+            TSUNIT_ASSERT(scrambling.decrypt(pkt));
+        }
+        TSUNIT_ASSERT(scrambling.flushBatch());
+        for (const auto& pkt : packets) {
+            TSUNIT_EQUAL(ts::SC_CLEAR, pkt.getScrambling());
+            TSUNIT_EQUAL(0, ts::MemCompare(pkt.b + header_size, vec.plain.b + header_size, payload_size));
+        }
+
+        // Scrambling test.
+        TSUNIT_ASSERT(scrambling.setEncryptParity(scv));
+        for (auto& pkt : packets) {
+            pkt = vec.plain;
+            TSUNIT_ASSERT(scrambling.encrypt(pkt));
+        }
+        TSUNIT_ASSERT(scrambling.setBatchMode(false));
+        for (const auto& pkt : packets) {
+            TSUNIT_EQUAL(scv, pkt.getScrambling());
+            TSUNIT_EQUAL(0, ts::MemCompare(pkt.b + header_size, vec.cipher.b + header_size, payload_size));
+        }
+    }
+}
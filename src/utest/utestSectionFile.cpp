@@ -21,6 +21,7 @@
 #include "tsxmlElement.h"
 #include "tsDuckContext.h"
 #include "tsCerrReport.h"
+#include "tsReportBuffer.h"
 #include "tsunit.h"
 
 #include "tables/psi_pat1_xml.h"
@@ -42,6 +43,7 @@ class SectionFileTest: public tsunit::Test
     TSUNIT_DECLARE_TEST(PAT1);
     TSUNIT_DECLARE_TEST(SCTE35);
     TSUNIT_DECLARE_TEST(Memory);
+    TSUNIT_DECLARE_TEST(SaveXML);
     TSUNIT_DECLARE_TEST(BuildSections);
     TSUNIT_DECLARE_TEST(MultiSectionsCAT);
     TSUNIT_DECLARE_TEST(MultiSectionsAtProgramLevelPMT);
@@ -725,3 +727,36 @@ TSUNIT_DEFINE_TEST(Memory)
     TSUNIT_EQUAL(0, ts::MemCompare(out2, psi_pat1_sections, sizeof(psi_pat1_sections)));
     TSUNIT_EQUAL(0, ts::MemCompare(out2 + 32, psi_pmt_scte35_sections, sizeof(psi_pmt_scte35_sections)));
 }
+
+TSUNIT_DEFINE_TEST(SaveXML)
+{
+    // One complete PAT and one orphan section (second section of a two-section table).
+    static const uint8_t payload[] = {0x01, 0x02, 0x03, 0x04};
+    ts::ReportBuffer<ts::ThreadSafety::None> log;
+    ts::DuckContext duck(&log);
+    ts::SectionFile file(duck);
+    TSUNIT_ASSERT(file.loadBuffer(psi_pat1_sections, sizeof(psi_pat1_sections)));
+    file.add(std::make_shared<ts::Section>(0x80, true, 0x1234, 0, true, 1, 1, payload, sizeof(payload)));
+    TSUNIT_EQUAL(1, file.tablesCount());
+    TSUNIT_EQUAL(1, file.orphanSections().size());
+
+    // The orphan section is reported once.
+    TSUNIT_ASSERT(file.saveXML(_tempFileNameXML));
+    const ts::UString messages(log.messages());
+    debug() << "SectionFileTest::SaveXML: " << messages << std::endl;
+    const size_t first = messages.find(u"orphan");
+    TSUNIT_ASSERT(first != ts::NPOS);
+    TSUNIT_EQUAL(ts::NPOS, messages.find(u"orphan", first + 1));
+
+    ts::SectionFile reload(duck);
+    TSUNIT_ASSERT(reload.loadXML(_tempFileNameXML));
+    TSUNIT_EQUAL(1, reload.tablesCount());
+    TSUNIT_EQUAL(ts::TID_PAT, reload.tables()[0]->tableId());
+
+#if defined(TS_LINUX)
+    // Write errors are detected when the output file is closed.
+    log.clear();
+    TSUNIT_ASSERT(!file.saveXML(u"/dev/full"));
+    TSUNIT_ASSERT(log.messages().contain(u"error writing"));
+#endif
+}
@@ -0,0 +1,276 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2024, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//
+//  TSUnit test suite for ts::SectionView and subclasses.
+//
+//----------------------------------------------------------------------------
+
+#include "tsPATView.h"
+#include "tsPMTView.h"
+#include "tsSDTView.h"
+#include "tsEITView.h"
+#include "tsPAT.h"
+#include "tsPMT.h"
+#include "tsSDT.h"
+#include "tsEIT.h"
+#include "tsBinaryTable.h"
+#include "tsCADescriptor.h"
+#include "tsAVCVideoDescriptor.h"
+#include "tsDuckContext.h"
+#include "tsunit.h"
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class SectionViewTest: public tsunit::Test
+{
+    TSUNIT_DECLARE_TEST(Descriptors);
+    TSUNIT_DECLARE_TEST(PAT);
+    TSUNIT_DECLARE_TEST(PMT);
+    TSUNIT_DECLARE_TEST(SDT);
+    TSUNIT_DECLARE_TEST(EIT);
+    TSUNIT_DECLARE_TEST(Invalid);
+};
+
+TSUNIT_REGISTER(SectionViewTest);
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+TSUNIT_DEFINE_TEST(Descriptors)
+{
+    static const uint8_t data[] = {
+        0x09, 0x04, 0x12, 0x34, 0xE1, 0x00,  // CA_descriptor
+        0x28, 0x00,                          // AVC_video_descriptor, empty
+        0x48, 0x05, 0x01, 0x02,              // service_descriptor, truncated
+    };
+
+    ts::DescriptorListView loop(data, 8);
+    TSUNIT_ASSERT(loop.isValid());
+    TSUNIT_ASSERT(!loop.empty());
+    TSUNIT_EQUAL(2, loop.count());
+
+    auto it = loop.begin();
+    TSUNIT_ASSERT(it != loop.end());
+    TSUNIT_ASSERT(it->isValid());
+    TSUNIT_EQUAL(ts::DID_CA, it->tag());
+    TSUNIT_EQUAL(6, it->size());
+    TSUNIT_EQUAL(4, it->payloadSize());
+    TSUNIT_ASSERT(it->content() == data);
+    TSUNIT_ASSERT(it->payload() == data + 2);
+    ++it;
+    TSUNIT_ASSERT(it != loop.end());
+    TSUNIT_EQUAL(ts::DID_AVC_VIDEO, it->tag());
+    TSUNIT_EQUAL(2, it->size());
+    TSUNIT_EQUAL(0, it->payloadSize());
+    ++it;
+    TSUNIT_ASSERT(it == loop.end());
+
+    // Last descriptor is truncated.
+    loop = ts::DescriptorListView(data, sizeof(data));
+    TSUNIT_ASSERT(!loop.isValid());
+    TSUNIT_EQUAL(2, loop.count());
+
+    // Empty loops.
+    TSUNIT_ASSERT(ts::DescriptorListView().empty());
+    TSUNIT_ASSERT(ts::DescriptorListView(data, 0).empty());
+    TSUNIT_ASSERT(ts::DescriptorListView(data, 0).isValid());
+    TSUNIT_ASSERT(ts::DescriptorListView(data, 1).empty());
+    TSUNIT_ASSERT(!ts::DescriptorListView(data, 1).isValid());
+}
+
+TSUNIT_DEFINE_TEST(PAT)
+{
+    ts::DuckContext duck;
+    ts::PAT pat(7, true, 0x1234, 0x0010);
+    pat.pmts[0x0101] = 0x0200;
+    pat.pmts[0x0102] = 0x0300;
+
+    ts::BinaryTable bin;
+    TSUNIT_ASSERT(pat.serialize(duck, bin));
+    TSUNIT_EQUAL(1, bin.sectionCount());
+
+    const ts::PATView view(*bin.sectionAt(0));
+    TSUNIT_ASSERT(view.isValid());
+    TSUNIT_EQUAL(ts::TID_PAT, view.tableId());
+    TSUNIT_EQUAL(0x1234, view.tsId());
+    TSUNIT_EQUAL(7, view.version());
+    TSUNIT_ASSERT(view.isCurrent());
+    TSUNIT_EQUAL(3, view.programs().count());
+    TSUNIT_ASSERT(view.programs().isValid());
+    TSUNIT_EQUAL(0x0010, view.nitPID());
+    TSUNIT_EQUAL(0x0200, view.pmtPID(0x0101));
+    TSUNIT_EQUAL(0x0300, view.pmtPID(0x0102));
+    TSUNIT_EQUAL(ts::PID_NULL, view.pmtPID(0x0103));
+
+    // A PAT view on a non-PAT section is invalid.
+    ts::PMT pmt;
+    TSUNIT_ASSERT(pmt.serialize(duck, bin));
+    const ts::PATView view2(*bin.sectionAt(0));
+    TSUNIT_ASSERT(!view2.isValid());
+    TSUNIT_ASSERT(view2.programs().empty());
+    TSUNIT_EQUAL(ts::PID_NULL, view2.nitPID());
+}
+
+TSUNIT_DEFINE_TEST(PMT)
+{
+    ts::DuckContext duck;
+    ts::PMT pmt(3, true, 0x0101, 0x0201);
+    pmt.descs.add(duck, ts::CADescriptor(0x1234, 0x0500));
+    pmt.streams[0x0201].stream_type = ts::ST_AVC_VIDEO;
+    pmt.streams[0x0201].descs.add(duck, ts::AVCVideoDescriptor());
+    pmt.streams[0x0202].stream_type = ts::ST_MPEG2_AUDIO;
+
+    ts::BinaryTable bin;
+    TSUNIT_ASSERT(pmt.serialize(duck, bin));
+    const ts::PMTView view(*bin.sectionAt(0));
+    TSUNIT_ASSERT(view.isValid());
+    TSUNIT_EQUAL(0x0101, view.serviceId());
+    TSUNIT_EQUAL(3, view.version());
+    TSUNIT_EQUAL(0x0201, view.pcrPID());
+
+    TSUNIT_EQUAL(1, view.descriptors().count());
+    TSUNIT_EQUAL(ts::DID_CA, view.descriptors().begin()->tag());
+    const ts::CADescriptor ca(duck, ts::Descriptor(view.descriptors().begin()->content(), view.descriptors().begin()->size()));
+    TSUNIT_ASSERT(ca.isValid());
+    TSUNIT_EQUAL(0x1234, ca.cas_id);
+    TSUNIT_EQUAL(0x0500, ca.ca_pid);
+
+    const ts::PMTView::StreamLoop streams(view.streams());
+    TSUNIT_ASSERT(streams.isValid());
+    TSUNIT_EQUAL(2, streams.count());
+    auto it = streams.begin();
+    TSUNIT_EQUAL(0x0201, it->pid());
+    TSUNIT_EQUAL(ts::ST_AVC_VIDEO, it->streamType());
+    TSUNIT_EQUAL(1, it->descriptors().count());
+    TSUNIT_EQUAL(ts::DID_AVC_VIDEO, it->descriptors().begin()->tag());
+    ++it;
+    TSUNIT_EQUAL(0x0202, it->pid());
+    TSUNIT_EQUAL(ts::ST_MPEG2_AUDIO, it->streamType());
+    TSUNIT_ASSERT(it->descriptors().empty());
+    ++it;
+    TSUNIT_ASSERT(it == streams.end());
+
+    TSUNIT_ASSERT(view.findStream(0x0202) != streams.end());
+    TSUNIT_EQUAL(ts::ST_MPEG2_AUDIO, view.findStream(0x0202)->streamType());
+    TSUNIT_ASSERT(view.findStream(0x0203) == streams.end());
+}
+
+TSUNIT_DEFINE_TEST(SDT)
+{
+    ts::DuckContext duck;
+    ts::SDT sdt(false, 5, true, 0x1234, 0x5678);
+    sdt.services[0x0101].EITpf_present = true;
+    sdt.services[0x0101].running_status = 4;
+    sdt.services[0x0101].descs.add(duck, ts::CADescriptor(0x0100, 0x0500));
+    sdt.services[0x0102].EITs_present = true;
+    sdt.services[0x0102].CA_controlled = true;
+    sdt.services[0x0102].running_status = 1;
+
+    ts::BinaryTable bin;
+    TSUNIT_ASSERT(sdt.serialize(duck, bin));
+    const ts::SDTView view(*bin.sectionAt(0));
+    TSUNIT_ASSERT(view.isValid());
+    TSUNIT_ASSERT(!view.isActual());
+    TSUNIT_EQUAL(ts::TID_SDT_OTH, view.tableId());
+    TSUNIT_EQUAL(0x1234, view.tsId());
+    TSUNIT_EQUAL(0x5678, view.onetwId());
+    TSUNIT_EQUAL(2, view.services().count());
+
+    auto it = view.findService(0x0101);
+    TSUNIT_ASSERT(it != view.services().end());
+    TSUNIT_ASSERT(it->eitpfPresent());
+    TSUNIT_ASSERT(!it->eitsPresent());
+    TSUNIT_ASSERT(!it->caControlled());
+    TSUNIT_EQUAL(4, it->runningStatus());
+    TSUNIT_EQUAL(1, it->descriptors().count());
+
+    it = view.findService(0x0102);
+    TSUNIT_ASSERT(it != view.services().end());
+    TSUNIT_ASSERT(!it->eitpfPresent());
+    TSUNIT_ASSERT(it->eitsPresent());
+    TSUNIT_ASSERT(it->caControlled());
+    TSUNIT_EQUAL(1, it->runningStatus());
+    TSUNIT_ASSERT(it->descriptors().empty());
+
+    TSUNIT_ASSERT(view.findService(0x0103) == view.services().end());
+}
+
+TSUNIT_DEFINE_TEST(EIT)
+{
+    ts::DuckContext duck;
+    ts::EIT eit(true, false, 2, 9, true, 0x0101, 0x1234, 0x5678);
+    eit.events[0].event_id = 0x4321;
+    eit.events[0].start_time = ts::Time(2024, 5, 17, 20, 45, 30);
+    eit.events[0].duration = cn::seconds(5432);
+    eit.events[0].running_status = 2;
+    eit.events[0].descs.add(duck, ts::CADescriptor(0x0100, 0x0500));
+
+    ts::BinaryTable bin;
+    TSUNIT_ASSERT(eit.serialize(duck, bin));
+    const ts::EITView view(*bin.sectionAt(0));
+    TSUNIT_ASSERT(view.isValid());
+    TSUNIT_ASSERT(view.isActual());
+    TSUNIT_ASSERT(!view.isPresentFollowing());
+    TSUNIT_EQUAL(0x52, view.tableId());
+    TSUNIT_EQUAL(9, view.version());
+    TSUNIT_EQUAL(0x0101, view.serviceId());
+    TSUNIT_EQUAL(0x1234, view.tsId());
+    TSUNIT_EQUAL(0x5678, view.onetwId());
+    TSUNIT_EQUAL(1, view.events().count());
+
+    const ts::EITView::Event ev(*view.events().begin());
+    TSUNIT_EQUAL(0x4321, ev.eventId());
+    TSUNIT_ASSERT(ev.startTime() == ts::Time(2024, 5, 17, 20, 45, 30));
+    TSUNIT_EQUAL(5432, ev.duration().count());
+    TSUNIT_EQUAL(2, ev.runningStatus());
+    TSUNIT_ASSERT(!ev.caControlled());
+    TSUNIT_EQUAL(1, ev.descriptors().count());
+    TSUNIT_EQUAL(ts::DID_CA, ev.descriptors().begin()->tag());
+}
+
+TSUNIT_DEFINE_TEST(Invalid)
+{
+    // Truncated section: section_length exceeds the available data.
+    static const uint8_t pat[] = {
+        0x00, 0xB0, 0x11, 0x12, 0x34, 0xC1, 0x00, 0x00,
+        0x00, 0x00, 0xE0, 0x10,
+        0x01, 0x01, 0xE2, 0x00,
+        0x00, 0x00, 0x00, 0x00,
+    };
+    TSUNIT_ASSERT(ts::PATView(pat, sizeof(pat)).isValid());
+    TSUNIT_ASSERT(!ts::PATView(pat, sizeof(pat) - 1).isValid());
+    TSUNIT_ASSERT(!ts::PATView(nullptr, 0).isValid());
+    TSUNIT_ASSERT(!ts::PMTView(pat, sizeof(pat)).isValid());
+    TSUNIT_ASSERT(!ts::SectionView().isValid());
+
+    const ts::PATView view(pat, sizeof(pat));
+    TSUNIT_EQUAL(0x1234, view.tsId());
+    TSUNIT_EQUAL(2, view.programs().count());
+    TSUNIT_EQUAL(0x0010, view.nitPID());
+    TSUNIT_EQUAL(0x0200, view.pmtPID(0x0101));
+
+    // PMT with a stream loop which is truncated in the middle of the ES_info.
+    static const uint8_t pmt[] = {
+        0x02, 0xB0, 0x19, 0x01, 0x01, 0xC1, 0x00, 0x00,
+        0xE2, 0x01, 0xF0, 0x00,
+        0x1B, 0xE2, 0x01, 0xF0, 0x00,
+        0x03, 0xE2, 0x02, 0xF0, 0x08, 0x0A, 0x04,
+        0x00, 0x00, 0x00, 0x00,
+    };
+    const ts::PMTView pview(pmt, sizeof(pmt));
+    TSUNIT_ASSERT(pview.isValid());
+    TSUNIT_ASSERT(pview.descriptors().empty());
+    TSUNIT_ASSERT(!pview.streams().isValid());
+    TSUNIT_EQUAL(1, pview.streams().count());
+    TSUNIT_EQUAL(0x0201, pview.streams().begin()->pid());
+}
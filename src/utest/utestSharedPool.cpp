@@ -0,0 +1,112 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2024, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//
+//  TSUnit test suite for class ts::SharedPool
+//
+//----------------------------------------------------------------------------
+
+#include "tsSharedPool.h"
+#include "tsByteBlock.h"
+#include "tsunit.h"
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class SharedPoolTest: public tsunit::Test
+{
+    TSUNIT_DECLARE_TEST(Recycle);
+    TSUNIT_DECLARE_TEST(Bounded);
+    TSUNIT_DECLARE_TEST(Disabled);
+};
+
+TSUNIT_REGISTER(SharedPoolTest);
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+TSUNIT_DEFINE_TEST(Recycle)
+{
+    ts::SharedPool<ts::ByteBlock> pool;
+    TSUNIT_EQUAL(ts::SharedPool<ts::ByteBlock>::DEFAULT_MAX_SIZE, pool.maxSize());
+    TSUNIT_EQUAL(0, pool.size());
+
+    ts::ByteBlockPtr b1(pool.allocate());
+    b1->resize(1000);
+    const uint8_t* data = b1->data();
+    const ts::ByteBlock* addr = b1.get();
+    TSUNIT_EQUAL(1, pool.size());
+    TSUNIT_EQUAL(1, pool.allocatedCount());
+    TSUNIT_EQUAL(0, pool.recycledCount());
+
+    // b1 is still used, another object is allocated.
+    ts::ByteBlockPtr b2(pool.allocate());
+    TSUNIT_ASSERT(b2 != b1);
+    TSUNIT_EQUAL(2, pool.size());
+    TSUNIT_EQUAL(2, pool.allocatedCount());
+
+    // Release b1, it is recycled with its memory.
+    b1.reset();
+    ts::ByteBlockPtr b3(pool.allocate());
+    TSUNIT_EQUAL(addr, b3.get());
+    TSUNIT_EQUAL(1000, b3->size());
+    b3->copy("abc", 3);
+    TSUNIT_EQUAL(data, b3->data());
+    TSUNIT_EQUAL(2, pool.size());
+    TSUNIT_EQUAL(2, pool.allocatedCount());
+    TSUNIT_EQUAL(1, pool.recycledCount());
+
+    // Objects remain valid after clearing the pool.
+    pool.clear();
+    TSUNIT_EQUAL(0, pool.size());
+    TSUNIT_EQUAL(3, b3->size());
+    TSUNIT_EQUAL(1, b3.use_count());
+}
+
+TSUNIT_DEFINE_TEST(Bounded)
+{
+    ts::SharedPool<ts::ByteBlock> pool(3);
+    std::vector<ts::ByteBlockPtr> blocks;
+    for (size_t i = 0; i < 5; ++i) {
+        blocks.push_back(pool.allocate());
+    }
+    TSUNIT_EQUAL(3, pool.size());
+    TSUNIT_EQUAL(5, pool.allocatedCount());
+
+    // Release all, only the pooled ones are recycled.
+    blocks.clear();
+    for (size_t i = 0; i < 5; ++i) {
+        blocks.push_back(pool.allocate());
+    }
+    TSUNIT_EQUAL(3, pool.size());
+    TSUNIT_EQUAL(7, pool.allocatedCount());
+    TSUNIT_EQUAL(3, pool.recycledCount());
+
+    pool.setMaxSize(1);
+    TSUNIT_EQUAL(1, pool.size());
+    blocks.clear();
+    ts::ByteBlockPtr b1(pool.allocate());
+    ts::ByteBlockPtr b2(pool.allocate());
+    TSUNIT_EQUAL(4, pool.recycledCount());
+    TSUNIT_EQUAL(8, pool.allocatedCount());
+}
+
+TSUNIT_DEFINE_TEST(Disabled)
+{
+    ts::SharedPool<ts::ByteBlock> pool(0);
+    for (size_t i = 0; i < 5; ++i) {
+        ts::ByteBlockPtr b(pool.allocate());
+        TSUNIT_EQUAL(1, b.use_count());
+    }
+    TSUNIT_EQUAL(0, pool.size());
+    TSUNIT_EQUAL(5, pool.allocatedCount());
+    TSUNIT_EQUAL(0, pool.recycledCount());
+}
@@ -0,0 +1,215 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2024, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//
+//  TSUnit test suite for class ts::TSAnalyzer
+//
+//----------------------------------------------------------------------------
+
+#include "tsTSAnalyzerReport.h"
+#include "tsTSAnalyzerOptions.h"
+#include "tsCyclingPacketizer.h"
+#include "tsDuckContext.h"
+#include "tsPAT.h"
+#include "tsPMT.h"
+#include "tsSDT.h"
+#include "tsunit.h"
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class TSAnalyzerTest: public tsunit::Test
+{
+    TSUNIT_DECLARE_TEST(Shards);
+    TSUNIT_DECLARE_TEST(Headers);
+
+private:
+    static void buildStream(ts::TSPacketVector& packets);
+    static ts::UString analyze(const ts::TSPacketVector& packets, size_t shards, bool headers = false);
+};
+
+TSUNIT_REGISTER(TSAnalyzerTest);
+
+
+//----------------------------------------------------------------------------
+// Build a synthetic transport stream.
+//----------------------------------------------------------------------------
+
+void TSAnalyzerTest::buildStream(ts::TSPacketVector& packets)
+{
+    ts::DuckContext duck;
+
+    ts::PAT pat(1, 0, 1);
+    pat.pmts[1] = 100;
+
+    ts::PMT pmt(1, true, 1, 200);
+    pmt.streams[200].stream_type = ts::ST_MPEG2_VIDEO;
+    pmt.streams[201].stream_type = ts::ST_MPEG2_AUDIO;
+    pmt.streams[202].stream_type = ts::ST_PES_PRIV;
+
+    ts::SDT sdt(true, 0, true, 1, 1);
+    sdt.services[1].setName(duck, u"Test Service");
+
+    ts::CyclingPacketizer pzpat(duck, ts::PID_PAT);
+    ts::CyclingPacketizer pzpmt(duck, 100);
+    ts::CyclingPacketizer pzsdt(duck, ts::PID_SDT);
+    pzpat.addTable(duck, pat);
+    pzpmt.addTable(duck, pmt);
+    pzsdt.addTable(duck, sdt);
+
+    // A few PID's with continuity errors, PCR's, PES headers and scrambled packets.
+    static const ts::PID es_pids[] = {200, 201, 202, 203, 300, 301, 302, 303, 304};
+    std::map<ts::PID, uint8_t> cc;
+    uint64_t pcr = 0;
+
+    packets.clear();
+    for (size_t index = 0; index < 30000; ++index) {
+        ts::TSPacket pkt;
+        if (index % 100 == 0) {
+            pzpat.getNextPacket(pkt);
+        }
+        else if (index % 100 == 30) {
+            pzpmt.getNextPacket(pkt);
+        }
+        else if (index % 500 == 60) {
+            pzsdt.getNextPacket(pkt);
+        }
+        else if (index % 97 == 0) {
+            pkt = ts::NullPacket;
+        }
+        else {
+            const ts::PID pid = es_pids[index % std::size(es_pids)];
+            pkt.init(pid, cc[pid]++ & ts::CC_MASK, uint8_t(index));
+            if (index % 1000 == 1 + size_t(pid % 7)) {
+                // Continuity error.
+                cc[pid]++;
+            }
+            if (pid >= 300 && index % 3 == 0) {
+                pkt.setScrambling(index % 2 == 0 ? ts::SC_EVEN_KEY : ts::SC_ODD_KEY);
+            }
+            else if (index % 50 < std::size(es_pids)) {
+                // Start of PES packet.
+                pkt.setPUSI();
+                uint8_t* pl = pkt.getPayload();
+                pl[0] = pl[1] = 0x00;
+                pl[2] = 0x01;
+                pl[3] = uint8_t(0xE0 + pid % 16);
+            }
+            if (pid == 200 && index % 40 < std::size(es_pids)) {
+                pkt.setPCR(pcr, true);
+                pcr += 40 * ts::PKT_SIZE_BITS * 27'000'000 / 8'000'000;
+            }
+        }
+        packets.push_back(pkt);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Analyze a stream using a given number of shards.
+//----------------------------------------------------------------------------
+
+ts::UString TSAnalyzerTest::analyze(const ts::TSPacketVector& packets, size_t shards, bool headers)
+{
+    ts::DuckContext duck;
+    std::vector<std::unique_ptr<ts::TSAnalyzerReport>> analyzers;
+    for (size_t i = 0; i < shards; ++i) {
+        analyzers.push_back(std::make_unique<ts::TSAnalyzerReport>(duck));
+        analyzers.back()->setShard(i, shards);
+    }
+    // The first shard receives all packets and tells where to pass them next.
+    const auto route = [&analyzers, shards](const ts::TSPacket& pkt, ts::TSAnalyzer::ShardRoute where, uint64_t index) {
+        if (where == ts::TSAnalyzer::ShardRoute::ALL) {
+            for (size_t i = 1; i < shards; ++i) {
+                analyzers[i]->feedShardPacket(pkt, index);
+            }
+        }
+        else if (where == ts::TSAnalyzer::ShardRoute::OWNER) {
+            const size_t i = ts::TSAnalyzer::ShardIndex(pkt.getPID(), shards);
+            TSUNIT_ASSERT(i > 0);
+            analyzers[i]->feedShardPacket(pkt, index);
+        }
+    };
+    if (headers) {
+        // Feed the analyzers with decoded headers, by chunks of packets.
+        constexpr size_t CHUNK_PACKETS = 1000;
+        ts::TSPacketHeaders hdr;
+        std::vector<ts::TSAnalyzer::ShardRoute> routes;
+        std::vector<uint64_t> indexes;
+        for (size_t index = 0; index < packets.size(); index += CHUNK_PACKETS) {
+            hdr.scan(packets.data() + index, std::min(CHUNK_PACKETS, packets.size() - index));
+            analyzers[0]->feedShardRouter(packets.data() + index, hdr, routes, indexes);
+            for (size_t i = 0; i < hdr.size(); ++i) {
+                route(packets[index + i], routes[i], indexes[i]);
+            }
+        }
+    }
+    else {
+        for (const auto& pkt : packets) {
+            uint64_t index = 0;
+            const ts::TSAnalyzer::ShardRoute where = analyzers[0]->feedShardRouter(pkt, index);
+            route(pkt, where, index);
+        }
+    }
+    for (size_t i = 1; i < shards; ++i) {
+        analyzers[0]->mergeShard(*analyzers[i]);
+    }
+
+    ts::TSAnalyzerOptions opt;
+    opt.normalized = true;
+    opt.deterministic = true;
+    return analyzers[0]->reportToString(opt);
+}
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+TSUNIT_DEFINE_TEST(Shards)
+{
+    ts::TSPacketVector packets;
+    buildStream(packets);
+
+    const ts::UString ref(analyze(packets, 1));
+    debug() << "TSAnalyzerTest::Shards: reference analysis:" << std::endl << ref << std::endl;
+    TSUNIT_ASSERT(ref.contain(u"pid:pid=200:"));
+    TSUNIT_ASSERT(ref.contain(u"Test Service"));
+
+    TSUNIT_EQUAL(ref, analyze(packets, 2));
+    TSUNIT_EQUAL(ref, analyze(packets, 3));
+    TSUNIT_EQUAL(ref, analyze(packets, 7));
+
+    // After reset(), an analyzer is no longer restricted to a shard.
+    ts::DuckContext duck;
+    ts::TSAnalyzerReport analyzer(duck);
+    analyzer.setShard(1, 3);
+    analyzer.reset();
+    for (const auto& pkt : packets) {
+        analyzer.feedPacket(pkt);
+    }
+    ts::TSAnalyzerOptions opt;
+    opt.normalized = true;
+    opt.deterministic = true;
+    TSUNIT_EQUAL(ref, analyzer.reportToString(opt));
+}
+
+TSUNIT_DEFINE_TEST(Headers)
+{
+    ts::TSPacketVector packets;
+    buildStream(packets);
+
+    // Add a few invalid packets.
+    packets[1234].b[0] = 0x48;
+    packets[2345].setTEI(true);
+
+    const ts::UString ref(analyze(packets, 1));
+    TSUNIT_EQUAL(ref, analyze(packets, 1, true));
+    TSUNIT_EQUAL(ref, analyze(packets, 3, true));
+}
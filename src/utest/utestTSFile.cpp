@@ -11,11 +11,13 @@
 //----------------------------------------------------------------------------
 
 #include "tsTSFile.h"
+#include "tsTSFileOutputArgs.h"
 #include "tsTSPacket.h"
 #include "tsTSPacketMetadata.h"
 #include "tsCerrReport.h"
 #include "tsFileUtils.h"
 #include "tsErrCodeReport.h"
+#include "tsReportBuffer.h"
 #include "tsunit.h"
 
 
@@ -30,6 +32,9 @@ class TSFileTest: public tsunit::Test
     TSUNIT_DECLARE_TEST(Duck);
     TSUNIT_DECLARE_TEST(StuffingRead);
     TSUNIT_DECLARE_TEST(StuffingWrite);
+    TSUNIT_DECLARE_TEST(MemoryMap);
+    TSUNIT_DECLARE_TEST(WriteBehind);
+    TSUNIT_DECLARE_TEST(WriteBehindNoClose);
 
 public:
     virtual void beforeTest() override;
@@ -358,3 +363,141 @@ TSUNIT_DEFINE_TEST(StuffingWrite)
     TSUNIT_EQUAL(184, packets[5].getPayloadSize());
     TSUNIT_EQUAL(0xFF, packets[5].getPayload()[0]);
 }
+
+TSUNIT_DEFINE_TEST(MemoryMap)
+{
+    ts::TSFile file;
+    ts::TSPacketVector packets(1000);
+    for (size_t i = 0; i < packets.size(); ++i) {
+        packets[i] = ts::NullPacket;
+        packets[i].setPID(ts::PID(i));
+    }
+    TSUNIT_ASSERT(file.open(_tempFileName, ts::TSFile::WRITE, CERR));
+    TSUNIT_ASSERT(file.writePackets(packets.data(), nullptr, packets.size(), CERR));
+    TSUNIT_ASSERT(file.close(CERR));
+
+    // Read twice the file, from packet 10, in chunks of 64 packets.
+    file.setMemoryMapping(true);
+    TSUNIT_ASSERT(file.openRead(_tempFileName, 2, 10 * ts::PKT_SIZE, CERR));
+#if !defined(TS_WINDOWS)
+    TSUNIT_ASSERT(file.isMemoryMapped());
+#endif
+
+    const ts::TSPacket* pkts = nullptr;
+    size_t count = 0;
+    size_t index = 10;
+    while ((count = file.readPacketsInPlace(pkts, 64, CERR)) > 0) {
+        TSUNIT_ASSERT(pkts != nullptr);
+        TSUNIT_ASSERT(count <= 64);
+        for (size_t i = 0; i < count; ++i) {
+            TSUNIT_EQUAL(index, pkts[i].getPID());
+            if (++index >= packets.size()) {
+                index = 10;
+            }
+        }
+    }
+    TSUNIT_EQUAL(10, index);
+    TSUNIT_EQUAL(2 * (packets.size() - 10), file.readPacketsCount());
+
+    TSUNIT_ASSERT(file.close(CERR));
+    TSUNIT_ASSERT(!file.isMemoryMapped());
+
+    // Seek in a mapped file.
+    TSUNIT_ASSERT(file.openRead(_tempFileName, 10 * ts::PKT_SIZE, CERR));
+    TSUNIT_EQUAL(1, file.readPacketsInPlace(pkts, 1, CERR));
+    TSUNIT_EQUAL(10, pkts[0].getPID());
+    TSUNIT_ASSERT(file.seek(500, CERR));
+    TSUNIT_EQUAL(1, file.readPacketsInPlace(pkts, 1, CERR));
+    TSUNIT_EQUAL(510, pkts[0].getPID());
+    TSUNIT_ASSERT(file.close(CERR));
+    TSUNIT_ASSERT(!file.isMemoryMapped());
+
+    // Seek after format auto-detection, without memory mapping.
+    file.setMemoryMapping(false);
+    TSUNIT_ASSERT(file.openRead(_tempFileName, 10 * ts::PKT_SIZE, CERR, ts::TSPacketFormat::AUTODETECT));
+    TSUNIT_ASSERT(!file.isMemoryMapped());
+    TSUNIT_EQUAL(1, file.readPacketsInPlace(pkts, 1, CERR));
+    TSUNIT_EQUAL(10, pkts[0].getPID());
+    TSUNIT_ASSERT(file.seek(500, CERR));
+    TSUNIT_EQUAL(1, file.readPacketsInPlace(pkts, 1, CERR));
+    TSUNIT_EQUAL(510, pkts[0].getPID());
+    TSUNIT_ASSERT(file.close(CERR));
+
+    // A file which grows after being mapped is read up to its new end.
+    file.setMemoryMapping(true);
+    TSUNIT_ASSERT(file.openRead(_tempFileName, 1, 0, CERR));
+    TSUNIT_EQUAL(500, file.readPackets(packets.data(), nullptr, 500, CERR));
+    ts::TSFile writer;
+    TSUNIT_ASSERT(writer.open(_tempFileName, ts::TSFile::WRITE | ts::TSFile::APPEND, CERR));
+    TSUNIT_ASSERT(writer.writePackets(packets.data(), nullptr, 100, CERR));
+    TSUNIT_ASSERT(writer.close(CERR));
+    index = 500;
+    while ((count = file.readPacketsInPlace(pkts, 64, CERR)) > 0) {
+        for (size_t i = 0; i < count; ++i) {
+            TSUNIT_EQUAL(index % 1000, pkts[i].getPID());
+            index++;
+        }
+    }
+    TSUNIT_EQUAL(1100, index);
+    TSUNIT_ASSERT(!file.isMemoryMapped());
+    TSUNIT_ASSERT(file.close(CERR));
+}
+
+TSUNIT_DEFINE_TEST(WriteBehind)
+{
+    ts::Args args;
+    ts::TSFileOutputArgs output(false);
+    output.defineArgs(args);
+    TSUNIT_ASSERT(args.analyze(u"", {u"--write-behind=2", _tempFileName}));
+
+    ts::DuckContext duck;
+    TSUNIT_ASSERT(output.loadArgs(duck, args));
+    TSUNIT_ASSERT(output.open(CERR));
+
+    // Write many small chunks, more than the queue size.
+    ts::TSPacketVector packets(10);
+    ts::PID pid = 0;
+    for (size_t chunk = 0; chunk < 100; ++chunk) {
+        for (auto& pkt : packets) {
+            pkt = ts::NullPacket;
+            pkt.setPID(pid++);
+        }
+        TSUNIT_ASSERT(output.write(packets.data(), nullptr, packets.size(), CERR));
+    }
+    TSUNIT_ASSERT(output.close(CERR));
+    TSUNIT_EQUAL(1000 * ts::PKT_SIZE, fs::file_size(_tempFileName, &ts::ErrCodeReport(CERR)));
+
+    // All packets must have been written in order.
+    ts::TSFile file;
+    ts::TSPacketVector inpackets(1000);
+    TSUNIT_ASSERT(file.openRead(_tempFileName, 0, CERR));
+    TSUNIT_EQUAL(1000, file.readPackets(inpackets.data(), nullptr, inpackets.size(), CERR));
+    for (size_t i = 0; i < inpackets.size(); ++i) {
+        TSUNIT_EQUAL(i, inpackets[i].getPID());
+    }
+    TSUNIT_ASSERT(file.close(CERR));
+}
+
+TSUNIT_DEFINE_TEST(WriteBehindNoClose)
+{
+    // Without close(), the destructor shall not use the report which was passed to open().
+    ts::Args args;
+    auto output = std::make_unique<ts::TSFileOutputArgs>(false);
+    output->defineArgs(args);
+    TSUNIT_ASSERT(args.analyze(u"", {u"--write-behind=2", _tempFileName}));
+
+    ts::DuckContext duck;
+    TSUNIT_ASSERT(output->loadArgs(duck, args));
+    {
+        ts::ReportBuffer<ts::ThreadSafety::Full> report(ts::Severity::Verbose);
+        TSUNIT_ASSERT(output->open(report));
+        ts::TSPacketVector packets(10, ts::NullPacket);
+        for (size_t chunk = 0; chunk < 10; ++chunk) {
+            TSUNIT_ASSERT(output->write(packets.data(), nullptr, packets.size(), report));
+        }
+    }
+
+    // The pending packets are still written.
+    output.reset();
+    TSUNIT_EQUAL(100 * ts::PKT_SIZE, fs::file_size(_tempFileName, &ts::ErrCodeReport(CERR)));
+}
@@ -0,0 +1,111 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2024, Thierry Lelegard
+// BSD-2-Clause license, see LICENSE.txt file or https://tsduck.io/license
+//
+//----------------------------------------------------------------------------
+//
+//  TSUnit test suite for class ts::TSPacketHeaders
+//
+//----------------------------------------------------------------------------
+
+#include "tsTSPacketHeaders.h"
+#include "tsunit.h"
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class TSPacketHeadersTest: public tsunit::Test
+{
+    TSUNIT_DECLARE_TEST(Scan);
+    TSUNIT_DECLARE_TEST(Empty);
+};
+
+TSUNIT_REGISTER(TSPacketHeadersTest);
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+TSUNIT_DEFINE_TEST(Scan)
+{
+    debug() << "TSPacketHeadersTest::Scan: accelerated: " << ts::UString::YesNo(ts::TSPacketHeaders::IsAccelerated()) << std::endl;
+
+    // Use an odd number of packets to exercise the SIMD and portable paths.
+    ts::TSPacketVector packets(1003);
+    for (size_t i = 0; i < packets.size(); ++i) {
+        ts::TSPacket& pkt(packets[i]);
+        pkt.init(ts::PID((i * 37) % ts::PID_MAX), uint8_t(i), uint8_t(i));
+        if (i % 3 == 0) {
+            pkt.setPUSI();
+        }
+        if (i % 5 == 0) {
+            pkt.setTEI(true);
+        }
+        if (i % 7 == 0) {
+            pkt.setPriority(true);
+        }
+        pkt.setScrambling(uint8_t(i % 4));
+        if (i % 11 == 0) {
+            pkt.b[3] &= ~0x10;  // no payload
+            pkt.b[3] |= 0x20;   // adaptation field
+        }
+        if (i % 101 == 0) {
+            pkt.b[0] = 0x48;    // corrupted sync byte
+        }
+    }
+
+    ts::TSPacketHeaders hdr;
+    hdr.scan(packets.data(), packets.size());
+    TSUNIT_EQUAL(packets.size(), hdr.size());
+
+    size_t bad_sync = 0;
+    for (size_t i = 0; i < packets.size(); ++i) {
+        const ts::TSPacket& pkt(packets[i]);
+        const uint8_t flags = hdr.flags(i);
+        TSUNIT_EQUAL(pkt.getPID(), hdr.pid(i));
+        TSUNIT_EQUAL(pkt.getCC(), hdr.cc(i));
+        TSUNIT_EQUAL(pkt.getScrambling(), hdr.scrambling(i));
+        TSUNIT_EQUAL(pkt.getTEI(), (flags & ts::TSPacketHeaders::TEI) != 0);
+        TSUNIT_EQUAL(pkt.getPUSI(), (flags & ts::TSPacketHeaders::PUSI) != 0);
+        TSUNIT_EQUAL(pkt.getPriority(), (flags & ts::TSPacketHeaders::PRIORITY) != 0);
+        TSUNIT_EQUAL(pkt.hasAF(), (flags & ts::TSPacketHeaders::HAS_AF) != 0);
+        TSUNIT_EQUAL(pkt.hasPayload(), (flags & ts::TSPacketHeaders::HAS_PAYLOAD) != 0);
+        TSUNIT_EQUAL(!pkt.hasValidSync(), (flags & ts::TSPacketHeaders::BAD_SYNC) != 0);
+        TSUNIT_EQUAL(ts::TSPacketHeaders::Flags(pkt), flags);
+        if (!pkt.hasValidSync()) {
+            bad_sync++;
+        }
+    }
+    TSUNIT_EQUAL(10, bad_sync);
+    TSUNIT_EQUAL(bad_sync, hdr.badSyncCount());
+    TSUNIT_EQUAL(hdr.pid(5), hdr.pids()[5]);
+    TSUNIT_EQUAL(hdr.cc(5), hdr.ccs()[5]);
+    TSUNIT_EQUAL(hdr.flags(5), hdr.flags()[5]);
+
+    // Rescan a smaller number of packets.
+    hdr.scan(packets.data() + 1, 5);
+    TSUNIT_EQUAL(5, hdr.size());
+    TSUNIT_EQUAL(0, hdr.badSyncCount());
+    TSUNIT_EQUAL(packets[1].getPID(), hdr.pid(0));
+    TSUNIT_EQUAL(packets[5].getPID(), hdr.pid(4));
+}
+
+TSUNIT_DEFINE_TEST(Empty)
+{
+    ts::TSPacketHeaders hdr(100);
+    TSUNIT_EQUAL(0, hdr.size());
+    TSUNIT_EQUAL(0, hdr.badSyncCount());
+    hdr.scan(nullptr, 0);
+    TSUNIT_EQUAL(0, hdr.size());
+    hdr.scan(&ts::NullPacket, 1);
+    TSUNIT_EQUAL(1, hdr.size());
+    TSUNIT_EQUAL(ts::PID_NULL, hdr.pid(0));
+    TSUNIT_EQUAL(ts::TSPacketHeaders::HAS_PAYLOAD, hdr.flags(0));
+    hdr.clear();
+    TSUNIT_EQUAL(0, hdr.size());
+}
@@ -13,7 +13,15 @@
 #include "tsTSProcessor.h"
 #include "tsPluginRepository.h"
 #include "tsCerrReport.h"
+#include "tsNullReport.h"
+#include "tsTelnetConnection.h"
+#include "tsFileUtils.h"
+#include "tsErrCodeReport.h"
+#include "tsjson.h"
+#include "tsjsonObject.h"
+#include "tsjsonArray.h"
 #include "tsunit.h"
+#include "utestTSUnitBenchmark.h"
 
 
 //----------------------------------------------------------------------------
@@ -23,11 +31,58 @@
 class TSProcessorTest: public tsunit::Test
 {
     TSUNIT_DECLARE_TEST(Processing);
+    TSUNIT_DECLARE_TEST(LockFreeHandoff);
+    TSUNIT_DECLARE_TEST(Fusion);
+    TSUNIT_DECLARE_TEST(FusionProfile);
+    TSUNIT_DECLARE_TEST(FusedEnd);
+    TSUNIT_DECLARE_TEST(FusedRestart);
+
+public:
+    virtual void beforeTest() override;
+    virtual void afterTest() override;
+
+private:
+    fs::path _profileFile {};
+    fs::path _costsFile {};
+
+    void runChain(utest::TSUnitBenchmark& bench, bool lock_free, size_t plugin_count, ts::PacketCounter packet_count);
+    void restartFused(bool lock_free);
+
+    // Get the "fused-with" index of each plugin in a saved execution profile, -1 if not fused.
+    std::vector<int64_t> loadFusedWith();
+
+    // Save an execution profile of "test1" plugins with the specified processing time per packet (negative: unknown).
+    void saveCosts(const std::vector<double>& costs, const ts::UString& name = u"test1");
 };
 
 TSUNIT_REGISTER(TSProcessorTest);
 
 
+//----------------------------------------------------------------------------
+// Initialization.
+//----------------------------------------------------------------------------
+
+// Test suite initialization method.
+void TSProcessorTest::beforeTest()
+{
+    if (_profileFile.empty()) {
+        _profileFile = ts::TempFile(u".profile.json");
+    }
+    if (_costsFile.empty()) {
+        _costsFile = ts::TempFile(u".costs.json");
+    }
+    fs::remove(_profileFile, &ts::ErrCodeReport());
+    fs::remove(_costsFile, &ts::ErrCodeReport());
+}
+
+// Test suite cleanup method.
+void TSProcessorTest::afterTest()
+{
+    fs::remove(_profileFile, &ts::ErrCodeReport());
+    fs::remove(_costsFile, &ts::ErrCodeReport());
+}
+
+
 //----------------------------------------------------------------------------
 // Testing the use of plugin specific data type during event signalling.
 // Probably not useful in many applications, but must be tested.
@@ -79,6 +134,7 @@ namespace {
     private:
         // Command line options:
         ts::PacketCounter _count;
+        ts::PacketCounter _end;
     };
 }
 
@@ -91,15 +147,20 @@ ts::ProcessorPlugin* TestPlugin::CreateInstance(ts::TSP* t)
 // Constructor.
 TestPlugin::TestPlugin(ts::TSP* t) :
     ts::ProcessorPlugin(t, u"Test plugin", u"[options]"),
-    _count(0)
+    _count(0),
+    _end(0)
 {
     option(u"count", 'c', POSITIVE);
     help(u"count", u"Send an event every that number of packets.");
+
+    option(u"end", 'e', POSITIVE);
+    help(u"end", u"Terminate the processing after that number of packets.");
 }
 
 bool TestPlugin::getOptions()
 {
     _count = intValue<ts::PacketCounter>(u"count", 100);
+    _end = intValue<ts::PacketCounter>(u"end", 0);
     return true;
 }
 
@@ -119,6 +180,9 @@ bool TestPlugin::stop()
 
 TestPlugin::Status TestPlugin::processPacket(ts::TSPacket& pkt, ts::TSPacketMetadata& metadata)
 {
+    if (_end > 0 && tsp->pluginPackets() >= _end) {
+        return TSP_END;
+    }
     if (tsp->pluginPackets() % _count == 0) {
         TestPluginData data(int(tsp->pluginPackets() / _count));
         tsp->signalPluginEvent(EVENT_PACKET, &data);
@@ -274,3 +338,291 @@ TSUNIT_DEFINE_TEST(Processing)
     TSUNIT_EQUAL(3,          handler2.logs[0].count);
     TSUNIT_EQUAL(26,         handler2.logs[0].packets);
 }
+
+
+//----------------------------------------------------------------------------
+// Chains of plugins, with and without the global mutex on packet handoff.
+// By default, a short chain is used to check both modes. Define the environment
+// variable TSUNIT_TSP_ITERATIONS to run a benchmark on long chains of plugins
+// and compare the CPU time of the two modes.
+//----------------------------------------------------------------------------
+
+void TSProcessorTest::runChain(utest::TSUnitBenchmark& bench, bool lock_free, size_t plugin_count, ts::PacketCounter packet_count)
+{
+    for (size_t iter = 0; iter < bench.iterations; ++iter) {
+
+        ts::TSProcessorArgs opt;
+        opt.app_name = u"TSProcessorTest::testLockFreeHandoff";
+        opt.lock_free_handoff = lock_free;
+        opt.max_flush_pkt = 100;
+        opt.input = {u"null", {ts::UString::Decimal(packet_count, 0, true, u"")}};
+        opt.plugins.resize(plugin_count, ts::PluginOptions(u"test1", {u"--count", ts::UString::Decimal(packet_count, 0, true, u"")}));
+        opt.output = {u"drop"};
+
+        // Only log stop events.
+        ts::TSProcessor tsproc(CERR);
+        TestEventHandler handler;
+        ts::TSProcessor::Criteria crit;
+        crit.event_code = TestPlugin::EVENT_STOP;
+        tsproc.registerEventHandler(&handler, crit);
+
+        bench.start();
+        TSUNIT_ASSERT(tsproc.start(opt));
+        tsproc.waitForTermination();
+        bench.stop();
+
+        // All packets went through all plugins.
+        TSUNIT_EQUAL(plugin_count, handler.logs.size());
+        for (const auto& log : handler.logs) {
+            TSUNIT_EQUAL(packet_count, log.packets);
+        }
+    }
+}
+
+TSUNIT_DEFINE_TEST(LockFreeHandoff)
+{
+    ts::PluginRepository::Instance().registerProcessor(u"test1", TestPlugin::CreateInstance);
+
+    utest::TSUnitBenchmark bench_mutex(u"TSUNIT_TSP_ITERATIONS");
+    const size_t plugin_count = bench_mutex.requested ? 15 : 3;
+    const ts::PacketCounter packet_count = bench_mutex.requested ? 100000 : 2000;
+
+    runChain(bench_mutex, false, plugin_count, packet_count);
+    bench_mutex.report(u"TSProcessorTest::testLockFreeHandoff, global mutex");
+
+    utest::TSUnitBenchmark bench_lock_free(u"TSUNIT_TSP_ITERATIONS");
+    runChain(bench_lock_free, true, plugin_count, packet_count);
+    bench_lock_free.report(u"TSProcessorTest::testLockFreeHandoff, lock-free");
+}
+
+
+//----------------------------------------------------------------------------
+// Plugin fusion: several packet processors executed in one thread.
+// Fused plugins are skipped in the ring of threads, all packets must still
+// go through all plugins, in the same order.
+//----------------------------------------------------------------------------
+
+std::vector<int64_t> TSProcessorTest::loadFusedWith()
+{
+    std::vector<int64_t> fused;
+    ts::json::ValuePtr root;
+    TSUNIT_ASSERT(ts::json::LoadFile(root, _profileFile, CERR));
+    const ts::json::Value& plugins(root->value(u"plugins"));
+    for (size_t i = 0; i < plugins.size(); ++i) {
+        fused.push_back(plugins.at(i).value(u"fused-with").toInteger(-1));
+    }
+    return fused;
+}
+
+void TSProcessorTest::saveCosts(const std::vector<double>& costs, const ts::UString& name)
+{
+    // The profile of a chain "null", test1..., "drop", 1000 packets each.
+    ts::json::ValuePtr plugins(new ts::json::Array);
+    for (size_t i = 0; i < costs.size() + 2; ++i) {
+        const bool proc = i > 0 && i <= costs.size();
+        const double cost = proc ? costs[i - 1] : 10.0;
+        ts::json::ValuePtr time(new ts::json::Object);
+        time->add(u"count", cost < 0.0 ? 0 : 10);
+        time->add(u"mean", cost < 0.0 ? 0.0 : cost * 100.0);
+        ts::json::ValuePtr plugin(new ts::json::Object);
+        plugin->add(u"index", int64_t(i));
+        plugin->add(u"name", proc ? name : (i == 0 ? u"null" : u"drop"));
+        plugin->add(u"packets", 1000);
+        plugin->add(u"plugin-time-ns", time);
+        plugins->set(plugin);
+    }
+    ts::json::ValuePtr root(new ts::json::Object);
+    root->add(u"plugins", plugins);
+    TSUNIT_ASSERT(root->save(_costsFile, 2, false, CERR));
+}
+
+TSUNIT_DEFINE_TEST(Fusion)
+{
+    ts::PluginRepository::Instance().registerProcessor(u"test1", TestPlugin::CreateInstance);
+
+    for (bool lock_free : {false, true}) {
+        ts::TSProcessorArgs opt;
+        opt.app_name = u"TSProcessorTest::testFusion";
+        opt.lock_free_handoff = lock_free;
+        opt.profile = true;
+        opt.profile_file = _profileFile;
+        opt.fuse_ranges = {{1, 3}, {4, 5}};
+        opt.input = {u"null", {u"5000"}};
+        opt.plugins.resize(6, ts::PluginOptions(u"test1", {u"--count", u"5000"}));
+        opt.output = {u"drop"};
+
+        ts::TSProcessor tsproc(CERR);
+        TestEventHandler handler;
+        ts::TSProcessor::Criteria crit;
+        crit.event_code = TestPlugin::EVENT_STOP;
+        tsproc.registerEventHandler(&handler, crit);
+
+        TSUNIT_ASSERT(tsproc.start(opt));
+        tsproc.waitForTermination();
+
+        // All packets went through all plugins.
+        TSUNIT_EQUAL(6, handler.logs.size());
+        for (const auto& log : handler.logs) {
+            TSUNIT_EQUAL(5000, log.packets);
+        }
+
+        // Plugins 2 and 3 are executed by plugin 1, plugin 5 by plugin 4.
+        const std::vector<int64_t> fused(loadFusedWith());
+        TSUNIT_EQUAL(8, fused.size());
+        TSUNIT_ASSERT(fused == std::vector<int64_t>({-1, -1, 1, 1, -1, 4, -1, -1}));
+    }
+}
+
+TSUNIT_DEFINE_TEST(FusionProfile)
+{
+    ts::PluginRepository::Instance().registerProcessor(u"test1", TestPlugin::CreateInstance);
+
+    // Consecutive plugins below the threshold (200 ns per packet by default) are fused.
+    // A plugin with unknown cost is never fused.
+    struct TestCase {
+        std::vector<double>  costs;
+        std::vector<int64_t> fused;
+    };
+    const std::vector<TestCase> cases {
+        {{100.0, 150.0, 1000.0, 50.0, 50.0, 50.0}, {-1, -1, 1, -1, -1, 4, 4, -1}},
+        {{100.0, -1.0, 100.0, 100.0, 1000.0, 100.0}, {-1, -1, -1, -1, 3, -1, -1, -1}},
+        {{1000.0, 1000.0, 1000.0, 1000.0, 1000.0, 1000.0}, {-1, -1, -1, -1, -1, -1, -1, -1}},
+    };
+
+    for (const auto& tc : cases) {
+        saveCosts(tc.costs);
+
+        ts::TSProcessorArgs opt;
+        opt.app_name = u"TSProcessorTest::testFusionProfile";
+        opt.profile = true;
+        opt.profile_file = _profileFile;
+        opt.fuse_profile = _costsFile;
+        opt.input = {u"null", {u"1000"}};
+        opt.plugins.resize(tc.costs.size(), ts::PluginOptions(u"test1"));
+        opt.output = {u"drop"};
+
+        ts::TSProcessor tsproc(CERR);
+        TSUNIT_ASSERT(tsproc.start(opt));
+        tsproc.waitForTermination();
+        TSUNIT_ASSERT(loadFusedWith() == tc.fused);
+    }
+
+    // A profile of another chain of plugins is ignored.
+    saveCosts({100.0, 100.0, 100.0}, u"test2");
+    ts::TSProcessorArgs opt;
+    opt.app_name = u"TSProcessorTest::testFusionProfile";
+    opt.profile = true;
+    opt.profile_file = _profileFile;
+    opt.fuse_profile = _costsFile;
+    opt.input = {u"null", {u"1000"}};
+    opt.plugins.resize(3, ts::PluginOptions(u"test1"));
+    opt.output = {u"drop"};
+
+    ts::TSProcessor tsproc(NULLREP);
+    TSUNIT_ASSERT(tsproc.start(opt));
+    tsproc.waitForTermination();
+    TSUNIT_ASSERT(loadFusedWith() == std::vector<int64_t>({-1, -1, -1, -1, -1}));
+}
+
+TSUNIT_DEFINE_TEST(FusedEnd)
+{
+    ts::PluginRepository::Instance().registerProcessor(u"test1", TestPlugin::CreateInstance);
+
+    for (bool lock_free : {false, true}) {
+        // The second plugin of a fused group terminates the endless processing.
+        ts::TSProcessorArgs opt;
+        opt.app_name = u"TSProcessorTest::testFusedEnd";
+        opt.lock_free_handoff = lock_free;
+        opt.fuse_ranges = {{1, 3}};
+        opt.input = {u"null"};
+        opt.plugins = {
+            {u"test1", {}},
+            {u"test1", {u"--end", u"500"}},
+            {u"test1", {}},
+        };
+        opt.output = {u"drop"};
+
+        ts::TSProcessor tsproc(CERR);
+        TestEventHandler handler;
+        ts::TSProcessor::Criteria crit;
+        crit.event_code = TestPlugin::EVENT_STOP;
+        tsproc.registerEventHandler(&handler, crit);
+
+        TSUNIT_ASSERT(tsproc.start(opt));
+        tsproc.waitForTermination();
+
+        // The packet which triggered the termination went through the previous plugins only.
+        TSUNIT_EQUAL(3, handler.logs.size());
+        for (const auto& log : handler.logs) {
+            TSUNIT_EQUAL(log.index == 3 ? 500 : 501, log.packets);
+        }
+    }
+}
+
+void TSProcessorTest::restartFused(bool lock_free)
+{
+    const uint16_t port = 12347;
+
+    // Endless processing, stopped by a control command.
+    ts::TSProcessorArgs opt;
+    opt.app_name = u"TSProcessorTest::testFusedRestart";
+    opt.lock_free_handoff = lock_free;
+    opt.control_port = port;
+    opt.control_local = ts::IPv4Address::LocalHost;
+    opt.control_reuse = true;
+    opt.control_sources = {ts::IPv4Address::LocalHost};
+    opt.fuse_ranges = {{1, 3}};
+    opt.input = {u"null"};
+    opt.plugins.resize(3, ts::PluginOptions(u"test1", {u"--count", u"1000000"}));
+    opt.output = {u"drop"};
+
+    // Only log events from the second plugin of the fused group.
+    ts::TSProcessor tsproc(CERR);
+    TestEventHandler handler;
+    ts::TSProcessor::Criteria crit;
+    crit.plugin_index = 2;
+    tsproc.registerEventHandler(&handler, crit);
+    TSUNIT_ASSERT(tsproc.start(opt));
+
+    // Send control commands, return all response lines.
+    const auto command = [port](const ts::UString& cmd) {
+        ts::UStringVector resp;
+        ts::TelnetConnection conn;
+        ts::UString line;
+        TSUNIT_ASSERT(conn.open(CERR));
+        TSUNIT_ASSERT(conn.connect(ts::IPv4SocketAddress(ts::IPv4Address::LocalHost, port), CERR));
+        TSUNIT_ASSERT(conn.sendLine(cmd, CERR));
+        TSUNIT_ASSERT(conn.closeWriter(CERR));
+        while (conn.receiveLine(line, nullptr, NULLREP)) {
+            resp.push_back(line);
+        }
+        conn.close(NULLREP);
+        return resp;
+    };
+
+    // The restart is executed in the thread of the fusion leader, the command returns when it is completed.
+    TSUNIT_ASSERT(command(u"restart --same 2").empty());
+    TSUNIT_ASSERT(command(u"restart 2 --count 2000000").empty());
+
+    // Abort all plugins, including the fused ones, the leader thread shall terminate.
+    tsproc.abort();
+    tsproc.waitForTermination();
+
+    // Plugin 2: start, restarted twice, stop.
+    size_t starts = 0;
+    size_t stops = 0;
+    for (const auto& log : handler.logs) {
+        TSUNIT_EQUAL(2, log.index);
+        starts += log.code == TestPlugin::EVENT_START;
+        stops += log.code == TestPlugin::EVENT_STOP;
+    }
+    TSUNIT_EQUAL(3, starts);
+    TSUNIT_EQUAL(3, stops);
+}
+
+TSUNIT_DEFINE_TEST(FusedRestart)
+{
+    ts::PluginRepository::Instance().registerProcessor(u"test1", TestPlugin::CreateInstance);
+    restartFused(false);
+    restartFused(true);
+}
@@ -23,7 +23,8 @@ size_t utest::TSUnitBenchmark::GetIterations(const ts::UString& env_name)
 }
 
 utest::TSUnitBenchmark::TSUnitBenchmark::TSUnitBenchmark(const ts::UString& env_name) :
-    iterations(GetIterations(env_name))
+    iterations(GetIterations(env_name)),
+    requested(!env_name.empty() && ts::EnvironmentExists(env_name))
 {
 }
 
@@ -34,6 +34,12 @@ namespace utest {
         //!
         const size_t iterations;
 
+        //!
+        //! True when the environment variable is defined, meaning that the benchmark was explicitly requested.
+        //! Tests which are too long for the default test suite use this to run a full benchmark only on request.
+        //!
+        const bool requested;
+
         //!
         //! Start accumulating CPU time.
         //!
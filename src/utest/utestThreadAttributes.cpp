@@ -35,6 +35,8 @@ class ThreadAttributesTest: public tsunit::Test
     TSUNIT_DECLARE_TEST(StackSize);
     TSUNIT_DECLARE_TEST(DeleteWhenTerminated);
     TSUNIT_DECLARE_TEST(Priority);
+    TSUNIT_DECLARE_TEST(Affinity);
+    TSUNIT_DECLARE_TEST(SchedulingPolicy);
 };
 
 TSUNIT_REGISTER(ThreadAttributesTest);
@@ -87,3 +89,62 @@ TSUNIT_DEFINE_TEST(Priority)
     attr.setPriority (ts::ThreadAttributes::GetNormalPriority());
     TSUNIT_ASSERT(attr.getPriority() == ts::ThreadAttributes::GetNormalPriority());
 }
+
+TSUNIT_DEFINE_TEST(Affinity)
+{
+    ts::ThreadAttributes attr;
+    TSUNIT_ASSERT(attr.getAffinity().empty()); // default value
+
+    TSUNIT_ASSERT(attr.decodeAffinity(u"3"));
+    TSUNIT_ASSERT(attr.getAffinity() == std::set<size_t>({3}));
+
+    TSUNIT_ASSERT(attr.decodeAffinity(u"2-5,8"));
+    TSUNIT_ASSERT(attr.getAffinity() == std::set<size_t>({2, 3, 4, 5, 8}));
+
+    TSUNIT_ASSERT(attr.decodeAffinity(u" 7 , 0-1 ,7"));
+    TSUNIT_ASSERT(attr.getAffinity() == std::set<size_t>({0, 1, 7}));
+
+    TSUNIT_ASSERT(attr.decodeAffinity(u"4095"));
+    TSUNIT_ASSERT(attr.getAffinity() == std::set<size_t>({4095}));
+
+    // Invalid lists do not modify the affinity.
+    TSUNIT_ASSERT(attr.decodeAffinity(u"1,2"));
+    TSUNIT_ASSERT(!attr.decodeAffinity(u""));
+    TSUNIT_ASSERT(!attr.decodeAffinity(u","));
+    TSUNIT_ASSERT(!attr.decodeAffinity(u"5-2"));
+    TSUNIT_ASSERT(!attr.decodeAffinity(u"1,x"));
+    TSUNIT_ASSERT(!attr.decodeAffinity(u"-3"));
+    TSUNIT_ASSERT(!attr.decodeAffinity(u"0-4096"));
+    TSUNIT_ASSERT(!attr.decodeAffinity(u"1-2-3"));
+    TSUNIT_ASSERT(attr.getAffinity() == std::set<size_t>({1, 2}));
+
+    TSUNIT_ASSERT(attr.setAffinity(std::set<size_t>()).getAffinity().empty());
+}
+
+TSUNIT_DEFINE_TEST(SchedulingPolicy)
+{
+    ts::ThreadAttributes attr;
+    TSUNIT_ASSERT(attr.getSchedulingPolicy() == ts::ThreadAttributes::SchedulingPolicy::DEFAULT); // default value
+
+    TSUNIT_ASSERT(attr.decodeSchedulingPolicy(u"fifo"));
+    TSUNIT_ASSERT(attr.getSchedulingPolicy() == ts::ThreadAttributes::SchedulingPolicy::FIFO);
+    TSUNIT_EQUAL(1, attr.getRealTimePriority());
+
+    TSUNIT_ASSERT(attr.decodeSchedulingPolicy(u"RR:50"));
+    TSUNIT_ASSERT(attr.getSchedulingPolicy() == ts::ThreadAttributes::SchedulingPolicy::ROUND_ROBIN);
+    TSUNIT_EQUAL(50, attr.getRealTimePriority());
+
+    TSUNIT_ASSERT(attr.decodeSchedulingPolicy(u"other"));
+    TSUNIT_ASSERT(attr.getSchedulingPolicy() == ts::ThreadAttributes::SchedulingPolicy::DEFAULT);
+
+    // Invalid policies do not modify the current one.
+    TSUNIT_ASSERT(attr.decodeSchedulingPolicy(u"fifo:20"));
+    TSUNIT_ASSERT(!attr.decodeSchedulingPolicy(u""));
+    TSUNIT_ASSERT(!attr.decodeSchedulingPolicy(u"batch"));
+    TSUNIT_ASSERT(!attr.decodeSchedulingPolicy(u"fifo:"));
+    TSUNIT_ASSERT(!attr.decodeSchedulingPolicy(u"fifo:x"));
+    TSUNIT_ASSERT(!attr.decodeSchedulingPolicy(u"rr:0"));
+    TSUNIT_ASSERT(!attr.decodeSchedulingPolicy(u"other:10"));
+    TSUNIT_ASSERT(attr.getSchedulingPolicy() == ts::ThreadAttributes::SchedulingPolicy::FIFO);
+    TSUNIT_EQUAL(20, attr.getRealTimePriority());
+}
@@ -84,6 +84,10 @@ class UStringTest: public tsunit::Test
     TSUNIT_DECLARE_TEST(ChronoUnit);
     TSUNIT_DECLARE_TEST(Chrono);
     TSUNIT_DECLARE_TEST(Percentage);
+    TSUNIT_DECLARE_TEST(UTFBlocks);
+    TSUNIT_DECLARE_TEST(AppendUTF8);
+    TSUNIT_DECLARE_TEST(Output);
+    TSUNIT_DECLARE_TEST(Benchmark);
 
 public:
     virtual void beforeTest() override;
@@ -2351,3 +2355,121 @@ TSUNIT_DEFINE_TEST(Percentage)
     TSUNIT_EQUAL(u"50.00%", ts::UString::Percentage(200, 400));
     TSUNIT_EQUAL(u"50.00%", ts::UString::Percentage(cn::milliseconds(500), cn::seconds(1)));
 }
+
+TSUNIT_DEFINE_TEST(UTFBlocks)
+{
+    // Non-ASCII characters at all positions around blocks of ASCII characters.
+    for (size_t size = 0; size < 70; ++size) {
+        for (size_t pos = 0; pos < size; ++pos) {
+            for (ts::UChar c : {ts::UChar(0x00E9), ts::UChar(0x20AC), ts::UChar(0x0080), ts::UChar(0x007F)}) {
+                ts::UString str(size, u'a');
+                str[pos] = c;
+                std::string ref(size, 'a');
+                if (c < 0x80) {
+                    ref[pos] = char(c);
+                }
+                else if (c < 0x800) {
+                    ref.replace(pos, 1, {char(0xC0 | (c >> 6)), char(0x80 | (c & 0x3F))});
+                }
+                else {
+                    ref.replace(pos, 1, {char(0xE0 | (c >> 12)), char(0x80 | ((c >> 6) & 0x3F)), char(0x80 | (c & 0x3F))});
+                }
+                TSUNIT_EQUAL(ref, str.toUTF8());
+                TSUNIT_EQUAL(str, ts::UString::FromUTF8(ref));
+            }
+        }
+    }
+
+    // Surrogate pair after a block of ASCII characters.
+    ts::UString str(32, u'x');
+    str.append(u"\U0001D538");
+    str.append(20, u'y');
+    const std::string utf8(str.toUTF8());
+    TSUNIT_EQUAL(32 + 4 + 20, utf8.size());
+    TSUNIT_EQUAL(std::string(32, 'x') + "\xF0\x9D\x94\xB8" + std::string(20, 'y'), utf8);
+    TSUNIT_EQUAL(str, ts::UString::FromUTF8(utf8));
+
+    // Output buffer too short in the middle of a block.
+    const ts::UString in(40, u'z');
+    const ts::UChar* in_start = in.data();
+    char out[20];
+    char* out_start = out;
+    ts::UString::ConvertUTF16ToUTF8(in_start, in.data() + in.size(), out_start, out + sizeof(out));
+    TSUNIT_EQUAL(20, in_start - in.data());
+    TSUNIT_EQUAL(20, out_start - out);
+    TSUNIT_EQUAL(std::string(20, 'z'), std::string(out, sizeof(out)));
+}
+
+TSUNIT_DEFINE_TEST(AppendUTF8)
+{
+    ts::UString str(u"ab");
+    TSUNIT_EQUAL(u"abc\u00E9d", str.appendUTF8("c\xC3\xA9" "d"));
+    TSUNIT_EQUAL(u"abc\u00E9d", str.appendUTF8(nullptr));
+    TSUNIT_EQUAL(u"abc\u00E9d\u20AC", str.appendUTF8(std::string("\xE2\x82\xAC")));
+    TSUNIT_EQUAL(u"abc\u00E9d\u20ACxy", str.appendUTF8("xyz", 2));
+    TSUNIT_EQUAL(u"abc\u00E9d\u20ACxy", str.appendUTF8("", 0));
+
+    // Format with strings and integers, using the direct paths.
+    TSUNIT_EQUAL(u"a=\u00E9t\u00E9, b=foo, c=-12, d=345, e=18446744073709551615, f=-9223372036854775808",
+                 ts::UString::Format(u"a=%s, b=%s, c=%d, d=%d, e=%d, f=%d", "\xC3\xA9t\xC3\xA9", u"foo", -12, 345u,
+                                     std::numeric_limits<uint64_t>::max(), std::numeric_limits<int64_t>::min()));
+    TSUNIT_EQUAL(u"[  abc] [00012] [1,234]", ts::UString::Format(u"[%5s] [%05d] [%'d]", "abc", 12, 1234));
+}
+
+TSUNIT_DEFINE_TEST(Output)
+{
+    std::ostringstream out1;
+    out1 << ts::UString(u"a\u00E9\u20AC") << ts::UChar(0x00E9) << ts::UChar(0x20AC) << ts::UChar(u'z') << ts::UChar(MATH_A1) << u"b\u00E8";
+    TSUNIT_EQUAL("a\xC3\xA9\xE2\x82\xAC\xC3\xA9\xE2\x82\xACzb\xC3\xA8", out1.str());
+
+    // Longer than the internal conversion buffer.
+    const ts::UString large(ts::UString(2000, u'x') + u"\u00E9" + ts::UString(2000, u'y'));
+    std::ostringstream out2;
+    out2 << large;
+    TSUNIT_EQUAL(large.toUTF8(), out2.str());
+
+    // Field width still applies, in bytes.
+    std::ostringstream out3;
+    out3 << std::setw(6) << ts::UString(u"\u00E9t\u00E9") << '|' << std::left << std::setw(6) << ts::UString(u"ab") << '|';
+    TSUNIT_EQUAL(" \xC3\xA9t\xC3\xA9|ab    |", out3.str());
+}
+
+TSUNIT_DEFINE_TEST(Benchmark)
+{
+    // Large mostly-ASCII text, typical of log messages and XML or JSON output.
+    ts::UString text;
+    for (size_t i = 0; i < 20000; ++i) {
+        text.format(u"line %d: service \"Cha\u00EEne %d\", PID 0x%X, %'d bytes\n", i, i % 100, i, 188 * i);
+    }
+    const std::string utf8(text.toUTF8());
+
+    constexpr size_t loops = 20;
+    auto start = cn::steady_clock::now();
+    for (size_t i = 0; i < loops; ++i) {
+        TSUNIT_EQUAL(utf8.size(), text.toUTF8().size());
+    }
+    const auto to_duration = cn::duration_cast<cn::microseconds>(cn::steady_clock::now() - start);
+
+    start = cn::steady_clock::now();
+    for (size_t i = 0; i < loops; ++i) {
+        TSUNIT_EQUAL(text.size(), ts::UString::FromUTF8(utf8).size());
+    }
+    const auto from_duration = cn::duration_cast<cn::microseconds>(cn::steady_clock::now() - start);
+
+    // Typical log messages, formatted and written on a text stream.
+    constexpr size_t messages = 100000;
+    const ts::UString name(u"tsp");
+    const std::string file("/data/capture.ts");
+    std::ostringstream out;
+    start = cn::steady_clock::now();
+    for (size_t i = 0; i < messages; ++i) {
+        out << ts::UString::Format(u"%s: packet %d, PID %d, file %s, skipped", name, i, i % 8192, file) << std::endl;
+    }
+    const auto format_duration = cn::duration_cast<cn::microseconds>(cn::steady_clock::now() - start);
+    TSUNIT_ASSERT(out.str().size() > messages * 40);
+
+    debug() << "UStringTest::Benchmark: " << utf8.size() << " bytes"
+            << ", to UTF-8: " << to_duration.count() / loops << " us"
+            << ", from UTF-8: " << from_duration.count() / loops << " us"
+            << ", " << messages << " log messages: " << format_duration.count() << " us" << std::endl;
+}
@@ -13,6 +13,7 @@
 #include "tsxmlModelDocument.h"
 #include "tsxmlElement.h"
 #include "tsxmlDeclaration.h"
+#include "tsxmlPullDocument.h"
 #include "tsSectionFile.h"
 #include "tsTextFormatter.h"
 #include "tsCerrReport.h"
@@ -42,6 +43,8 @@ class XMLTest: public tsunit::Test
     TSUNIT_DECLARE_TEST(GetFloat);
     TSUNIT_DECLARE_TEST(SetFloat);
     TSUNIT_DECLARE_TEST(PreserveSpace);
+    TSUNIT_DECLARE_TEST(Pull);
+    TSUNIT_DECLARE_TEST(PullInvalid);
 
 public:
     virtual void beforeTest() override;
@@ -770,3 +773,109 @@ TSUNIT_DEFINE_TEST(PreserveSpace)
         u"</w:document>\n",
         doc.toString());
 }
+
+TSUNIT_DEFINE_TEST(Pull)
+{
+    static const char document[] =
+        "\xEF\xBB\xBF<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+        "<!-- header comment -->\n"
+        "<root attr1=\"val1\">\n"
+        "  <node1>  Text in node1  </node1>\n"
+        "  <!-- <node0/> in comment -->\n"
+        "  <node2 a=\"x>y\" b='</node2>'>\n"
+        "    <node21>\n"
+        "      <node211/>\n"
+        "    </node21>\n"
+        "    <node22><![CDATA[<node23>]]></node22>\n"
+        "  </node2>\n"
+        "  <node3 foo=\"bar\"/>\n"
+        "</root>\n"
+        "<!-- trailer comment -->\n";
+
+    TSUNIT_ASSERT(ts::ByteBlock(document, sizeof(document) - 1).saveToFile(_tempFileName, &report()));
+
+    ts::xml::PullDocument doc(report());
+    ts::xml::Element* root = doc.open(ts::UString(_tempFileName));
+    TSUNIT_ASSERT(root != nullptr);
+    TSUNIT_ASSERT(doc.isValid());
+    TSUNIT_EQUAL(u"root", root->name());
+    TSUNIT_EQUAL(u"val1", root->attribute(u"attr1").value());
+    TSUNIT_EQUAL(3, root->lineNumber());
+    TSUNIT_EQUAL(0, root->childrenCount());
+
+    ts::xml::Element* elem = doc.next();
+    TSUNIT_ASSERT(elem != nullptr);
+    TSUNIT_ASSERT(elem->parent() == root);
+    TSUNIT_EQUAL(1, root->childrenCount());
+    TSUNIT_EQUAL(u"node1", elem->name());
+    TSUNIT_EQUAL(4, elem->lineNumber());
+    TSUNIT_EQUAL(u"Text in node1", elem->text(true));
+
+    elem = doc.next();
+    TSUNIT_ASSERT(elem != nullptr);
+    TSUNIT_EQUAL(1, root->childrenCount());
+    TSUNIT_EQUAL(u"node2", elem->name());
+    TSUNIT_EQUAL(6, elem->lineNumber());
+    TSUNIT_EQUAL(u"x>y", elem->attribute(u"a").value());
+    TSUNIT_EQUAL(u"</node2>", elem->attribute(u"b").value());
+    TSUNIT_EQUAL(2, elem->childrenCount());
+    ts::xml::Element* child = elem->findFirstChild(u"node22");
+    TSUNIT_ASSERT(child != nullptr);
+    TSUNIT_EQUAL(10, child->lineNumber());
+    TSUNIT_EQUAL(u"<node23>", child->text());
+
+    elem = doc.next();
+    TSUNIT_ASSERT(elem != nullptr);
+    TSUNIT_EQUAL(u"node3", elem->name());
+    TSUNIT_EQUAL(12, elem->lineNumber());
+    TSUNIT_EQUAL(u"bar", elem->attribute(u"foo").value());
+
+    TSUNIT_ASSERT(doc.next() == nullptr);
+    TSUNIT_ASSERT(doc.isValid());
+    TSUNIT_EQUAL(0, root->childrenCount());
+    TSUNIT_ASSERT(doc.next() == nullptr);
+
+    // Same document, from inline XML content.
+    root = doc.open(ts::UString::FromUTF8(document + 3));
+    TSUNIT_ASSERT(root != nullptr);
+    TSUNIT_ASSERT(!doc.isMemoryMapped());
+    size_t count = 0;
+    while (doc.next() != nullptr) {
+        count++;
+    }
+    TSUNIT_EQUAL(3, count);
+    TSUNIT_ASSERT(doc.isValid());
+
+    // Empty root element.
+    root = doc.open(u"<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<root/>\n");
+    TSUNIT_ASSERT(root != nullptr);
+    TSUNIT_EQUAL(u"root", root->name());
+    TSUNIT_ASSERT(doc.next() == nullptr);
+    TSUNIT_ASSERT(doc.isValid());
+}
+
+TSUNIT_DEFINE_TEST(PullInvalid)
+{
+    ts::ReportBuffer<ts::ThreadSafety::None> rep;
+    ts::xml::PullDocument doc(rep);
+
+    TSUNIT_ASSERT(doc.open(u"<?xml version='1.0' encoding='UTF-8'?>\n<foo>\n  <a/>\n</bar>") != nullptr);
+    TSUNIT_ASSERT(doc.next() != nullptr);
+    TSUNIT_ASSERT(doc.next() == nullptr);
+    TSUNIT_ASSERT(!doc.isValid());
+    TSUNIT_EQUAL(u"Error: line 4: parsing error, expected </foo> to match <foo> at line 2", rep.messages());
+
+    rep.clear();
+    TSUNIT_ASSERT(doc.open(u"<?xml version='1.0' encoding='UTF-8'?>\n<foo>\n  <a/>\n  <b>\n    <c>\n</foo>") != nullptr);
+    TSUNIT_ASSERT(doc.next() != nullptr);
+    TSUNIT_ASSERT(doc.next() == nullptr);
+    TSUNIT_ASSERT(!doc.isValid());
+    TSUNIT_EQUAL(u"Error: line 4: unterminated element, invalid XML document", rep.messages());
+
+    rep.clear();
+    TSUNIT_ASSERT(doc.open(u"<?xml version='1.0' encoding='UTF-8'?>\n<foo>\n  <a/>\n</foo>\n<bar/>") != nullptr);
+    TSUNIT_ASSERT(doc.next() != nullptr);
+    TSUNIT_ASSERT(doc.next() == nullptr);
+    TSUNIT_ASSERT(!doc.isValid());
+    TSUNIT_EQUAL(u"Error: line 5: trailing character sequence, invalid XML document", rep.messages());
+}